@@ -10,3 +10,4 @@ ADD_SCENE(wendigo, hex_input, HexInput)
 ADD_SCENE(wendigo, help, Help)
 ADD_SCENE(wendigo, setup_mac, SetupMAC)
 ADD_SCENE(wendigo, setup_channel, SetupChannel)
+ADD_SCENE(wendigo, locate, Locate)
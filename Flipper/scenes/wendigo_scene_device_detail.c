@@ -9,6 +9,11 @@ void wendigo_scene_device_detail_set_device(wendigo_device *d) {
     FURI_LOG_T(WENDIGO_TAG, "End wendigo_scene_device_detail_set_device()");
 }
 
+wendigo_device *wendigo_scene_device_detail_get_device() {
+    FURI_LOG_T(WENDIGO_TAG, "Start+End wendigo_scene_device_detail_get_device()");
+    return device;
+}
+
 static void wendigo_scene_device_detail_var_list_enter_callback(void *context, uint32_t index) {
     FURI_LOG_T(WENDIGO_TAG, "Start wendigo_scene_device_detail_var_list_enter_callback()");
     furi_assert(context);
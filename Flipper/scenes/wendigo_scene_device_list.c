@@ -1,11 +1,10 @@
 #include "../wendigo_scan.h"
+#include "../wendigo_spill.h"
 
 /** Public method from wendigo_scene_device_detail.c */
 extern void wendigo_scene_device_detail_set_device(wendigo_device *d);
 /** Public method from wendigo_scene_pnl_list.c */
 extern void wendigo_scene_pnl_list_set_device(wendigo_device *d, WendigoApp *app);
-/** Internal method - I don't wan't to move all calling functions below it */
-static void wendigo_scene_device_list_var_list_change_callback(VariableItem *item);
 
 /** TODO: For some obscene reason the ifndef barrier isn't stopping these
  *  from showing up in every single object file. No longer shared.
@@ -16,6 +15,9 @@ char *wifi_auth_mode_strings[] = {"Open", "WEP", "WPA", "WPA2",
     "WPA3 Enterprise", "WPA3 Enterprise Transition", "Unknown"};
 
 
+/* Minimum interval between device list refreshes (ms) */
+#define DEVICE_LIST_REFRESH_MS (250)
+
 /** Enum to index the options menu for devices */
 enum wendigo_device_list_bt_options {
   WendigoOptionBTRSSI = 0,
@@ -23,6 +25,7 @@ enum wendigo_device_list_bt_options {
   WendigoOptionBTScanType,
   WendigoOptionBTCod,
   WendigoOptionBTLastSeen,
+  WendigoOptionBTSort,
   WendigoOptionsBTCount
 };
 
@@ -34,6 +37,7 @@ enum wendigo_device_list_ap_options {
   WendigoOptionAPAuthMode,
   WendigoOptionAPChannel,
   WendigoOptionAPLastSeen,
+  WendigoOptionAPSort,
   WendigoOptionsAPCount
 };
 
@@ -45,9 +49,24 @@ enum wendigo_device_list_sta_options {
   WendigoOptionSTAAP,
   WendigoOptionSTAChannel,
   WendigoOptionSTALastSeen,
+  WendigoOptionSTASort,
   WendigoOptionsSTACount
 };
 
+/** Sort orders available for the device list. Selecting a device's "Sort"
+ * option and pressing OK cycles through these. */
+typedef enum WendigoSortKey {
+  WendigoSortNone = 0,
+  WendigoSortName,
+  WendigoSortLastSeen,
+  WendigoSortRSSI,
+  WendigoSortType,
+  WendigoSortCount
+} WendigoSortKey;
+
+static const char *sort_key_strings[WendigoSortCount] = {"Unsorted", "By Name",
+  "By Seen", "By RSSI", "By Type"};
+
 /* Enacting nested copies of these scenes, without the luxury of treating them
  * as instances of a class, is achieved by managing an array of
  * DeviceListInstances as a stack - pushing a new set of devices to the stack
@@ -64,6 +83,31 @@ enum wendigo_device_list_sta_options {
 uint8_t stack_counter = 0;
 DeviceListInstance *stack = NULL;
 DeviceListInstance current_devices;
+/* furi_get_tick() when the device list was last refreshed */
+uint32_t device_list_last_refresh = 0;
+/* Order of current_devices.devices[]. Unsorted lists are in the order devices
+ * were discovered. */
+WendigoSortKey device_list_sort = WendigoSortNone;
+
+/** Find `dev` in current_devices.devices[], returning
+ * current_devices.devices_count if it isn't there. dev->view_index is checked
+ * first so this is O(1) for devices whose position hasn't changed since it
+ * was last set.
+ */
+uint16_t wendigo_scene_device_list_index_of(wendigo_device *dev) {
+  if (dev == NULL || current_devices.devices == NULL) {
+    return current_devices.devices_count;
+  }
+  if (dev->view_index < current_devices.devices_count &&
+      current_devices.devices[dev->view_index] == dev) {
+    return dev->view_index;
+  }
+  uint16_t idx = custom_device_index(dev, current_devices.devices, current_devices.devices_count);
+  if (idx < current_devices.devices_count) {
+    dev->view_index = idx;
+  }
+  return idx;
+}
 
 /** Prepare current_devices for use. Provides initial values for the
  * current_devices struct.
@@ -161,13 +205,7 @@ bool wendigo_device_is_displayed_custom(wendigo_device *dev) {
   if (dev == NULL || current_devices.devices == NULL) {
     return false;
   }
-  /* Loop through current_devices.devices[] searching for dev */
-  uint16_t idx;
-  for (idx = 0; idx < current_devices.devices_count &&
-    (current_devices.devices[idx] == NULL ||
-      memcmp(dev->mac, current_devices.devices[idx]->mac, MAC_BYTES));
-    ++idx) { }
-  return (idx < current_devices.devices_count);
+  return (wendigo_scene_device_list_index_of(dev) < current_devices.devices_count);
 }
 
 /** Determine whether the specified device should be displayed, based on the
@@ -277,6 +315,8 @@ void wendigo_scene_device_list_set_current_devices(DeviceListInstance *deviceLis
  * If DEVICE_CUSTOM is included as part of the device mask this function WILL
  * NOT modify the contents of current_devices[], but will simply return the
  * number of devices currently displayed.
+ * If the device list is displayed this must be called between
+ * wendigo_device_list_view_begin_update() and wendigo_device_list_view_end_update().
  */
 uint16_t wendigo_scene_device_list_set_current_devices_mask(uint8_t deviceMask) {
   FURI_LOG_T(WENDIGO_TAG, "Start wendigo_scene_device_list_set_current_devices_mask()");
@@ -411,345 +451,503 @@ double elapsedTime(wendigo_device *dev, char *elapsedStr, uint8_t strlen) {
   return _elapsedTime(&(dev->lastSeen), &nowTime, elapsedStr, strlen);
 }
 
-/** Identify the device represented by the currently-selected menu item. NULL if
- * it cannot be identified.
+/** Return the device displayed at `index` in the device list, or NULL if there
+ * is no such device.
  */
-wendigo_device *wendigo_scene_device_list_selected_device(VariableItem *item) {
-  FURI_LOG_T(WENDIGO_TAG, "Start wendigo_scene_device_list_selected_device()");
-  WendigoApp *app = variable_item_get_context(item);
-
-  if (app->device_list_selected_menu_index < current_devices.devices_count) {
-    FURI_LOG_T(WENDIGO_TAG, "End wendigo_scene_device_list_selected_device()");
-    return current_devices.devices[app->device_list_selected_menu_index];
-  }
-  // TODO: Compare these methods - I'm tempted to remove the first approach
-  // (which is why it now gets its own function)
-  /* Instead of indexing into the array, see if we can find the device with a
-   * reverse lookup from `item` */
-  uint16_t idx = 0;
-  for (; idx < current_devices.devices_count && current_devices.devices[idx]->view != item;
-    ++idx) {
-  }
-  if (idx < current_devices.devices_count) {
-    FURI_LOG_T(WENDIGO_TAG, "End wendigo_scene_device_list_selected_device()");
-    return current_devices.devices[idx];
+wendigo_device *wendigo_scene_device_list_device_at(uint16_t index) {
+  if (current_devices.devices == NULL || index >= current_devices.devices_count) {
+    return NULL;
   }
-  /* Device not found */
-  FURI_LOG_T(WENDIGO_TAG, "End wendigo_scene_device_list_selected_device()");
-  return NULL;
+  return current_devices.devices[index];
 }
 
-/** Update the current display to reflect a new discovery result for `dev`.
- * This function is called by the functions wendigo_add_device() and
- * wendigo_update_device() in wendigo_scan.c. When this scene and scanning are
- * active at the same time all devices identified, whether newly-identified
- * devices or subsequent packets describing a known device, are passed as an
- * argument to this function to allow the UI to be dynamically updated and to
- * display either information about a new device or updated information about an
- * existing device.
+/** Is a row for the devices on the SD card displayed after the last device?
+ * Selecting it brings some of them back so they can be browsed. It's only
+ * displayed in lists of all devices - Lists of an AP's stations or a
+ * station's AP restore the devices they need themselves, and tagged devices
+ * are never moved to the SD card.
  */
-void wendigo_scene_device_list_update(WendigoApp *app, wendigo_device *dev) {
-  FURI_LOG_D(WENDIGO_TAG, "Start wendigo_scene_device_list_update()");
-  /* This will also cater for a NULL dev */
-  if (!wendigo_device_is_displayed(dev)) {
-    return;
+static bool wendigo_scene_device_list_has_spill_row() {
+  return (current_devices.devices_mask & (DEVICE_CUSTOM | DEVICE_SELECTED_ONLY)) == 0 &&
+    wendigo_spill_count() > 0;
+}
+
+/** Number of rows in the device list - One for each device, plus the SD card row */
+static uint16_t wendigo_scene_device_list_row_count() {
+  return current_devices.devices_count + (wendigo_scene_device_list_has_spill_row() ? 1 : 0);
+}
+
+/** Number of options available in the options menu for `dev` */
+static uint8_t wendigo_scene_device_list_options_count(wendigo_device *dev) {
+  if (dev->scanType == SCAN_HCI || dev->scanType == SCAN_BLE) {
+    return WendigoOptionsBTCount;
+  } else if (dev->scanType == SCAN_WIFI_AP) {
+    return WendigoOptionsAPCount;
+  } else if (dev->scanType == SCAN_WIFI_STA) {
+    return WendigoOptionsSTACount;
   }
-  char *name;
-  bool free_name = false;
-  uint8_t optionsCount;
-  uint8_t optionIndex;
-  char optionValue[MAX_SSID_LEN + 1];
-  bzero(optionValue, MAX_SSID_LEN + 1); /* Null out optionValue[] */
-  /* Set name and options menus based on dev->scanType */
+  return 0;
+}
+
+/** The option displayed when a device is first added to the device list */
+static uint8_t wendigo_scene_device_list_default_option(wendigo_device *dev) {
   if (dev->scanType == SCAN_HCI || dev->scanType == SCAN_BLE) {
-    /* Use bdname as name if it's a bluetooth device and we have a name */
-    if (dev->radio.bluetooth.bdname_len > 0 &&
-        dev->radio.bluetooth.bdname != NULL) {
-      name = dev->radio.bluetooth.bdname;
-    } else {
-      /* Otherwise use MAC */
-      name = malloc(sizeof(char) * (MAC_STRLEN + 1));
-      free_name = true;
-      if (name != NULL) {
-        bytes_to_string(dev->mac, MAC_BYTES, name);
-      }
-    }
-    optionsCount = WendigoOptionsBTCount;
-    if (dev->view == NULL) {
-      optionIndex = WendigoOptionBTScanType;
-    } else {
-      optionIndex = variable_item_get_current_value_index(dev->view);
-    }
-    switch (optionIndex) {
-      case WendigoOptionBTRSSI:
-        snprintf(optionValue, sizeof(optionValue), "%d dB", dev->rssi);
-        break;
-      case WendigoOptionBTLastSeen:
-        elapsedTime(dev, optionValue, sizeof(optionValue));
-        break;
-      case WendigoOptionBTScanType:
-        snprintf(optionValue, sizeof(optionValue), "%s",
-          (dev->scanType == SCAN_HCI)        ? "BT Classic"
-            : (dev->scanType == SCAN_BLE)    ? "BLE"
-                                              : "Unknown");
-        break;
-      default:
-        /* I'm pretty sure I don't need to worry about static variables */
-        break;
-    }
+    return WendigoOptionBTScanType;
   } else if (dev->scanType == SCAN_WIFI_AP) {
-    if (dev->radio.ap.ssid[0] == '\0') {
-      /* No SSID - Use MAC */
-      name = malloc(sizeof(char) * (MAC_STRLEN + 1));
-      free_name = true;
-      if (name != NULL) {
-        bytes_to_string(dev->mac, MAC_BYTES, name);
-      }
-    } else {
-      /* Use access point SSID as name */
-      name = dev->radio.ap.ssid;
-    }
-    optionsCount = WendigoOptionsAPCount;
-    if (dev->view == NULL) {
-      optionIndex = WendigoOptionAPScanType;
-    } else {
-      optionIndex = variable_item_get_current_value_index(dev->view);
-    }
-    switch (optionIndex) {
-      case WendigoOptionAPRSSI:
-        snprintf(optionValue, sizeof(optionValue), "%d dB", dev->rssi);
-        break;
-      case WendigoOptionAPLastSeen:
-        elapsedTime(dev, optionValue, sizeof(optionValue));
-        break;
-      case WendigoOptionAPChannel:
-        snprintf(optionValue, sizeof(optionValue), "Ch. %d",
-                dev->radio.ap.channel);
-        break;
-      case WendigoOptionAPAuthMode:
-        uint8_t mode = dev->radio.ap.authmode;
-        if (mode > WIFI_AUTH_MAX) {
-          mode = WIFI_AUTH_MAX;
-        }
-        snprintf(optionValue, sizeof(optionValue), "%s",
-                wifi_auth_mode_strings[mode]);
-        break;
-      case WendigoOptionAPScanType:
-        snprintf(optionValue, sizeof(optionValue), "%s",
-          (dev->scanType == SCAN_WIFI_AP)  ? "WiFi AP"
-                                            : "Unknown");
-        break;
-      case WendigoOptionAPStaCount:
-        snprintf(optionValue, sizeof(optionValue), "%d Stations",
-          dev->radio.ap.stations_count);
-        break;
-      default:
-        // Nothing
-        break;
-    }
+    return WendigoOptionAPScanType;
   } else if (dev->scanType == SCAN_WIFI_STA) {
-    /* Use MAC to label the device */
-    name = malloc(sizeof(char) * (MAC_STRLEN + 1));
-    free_name = true;
-    if (name != NULL) {
-      bytes_to_string(dev->mac, MAC_BYTES, name);
+    return WendigoOptionSTAScanType;
+  }
+  return 0;
+}
+
+/** Place the label for `dev` in `label`. Bluetooth devices are labelled with
+ * their bdname and APs with their SSID if they're known, otherwise the MAC/BDA
+ * is used. `label` must be at least MAC_STRLEN + 1 bytes.
+ */
+static void wendigo_scene_device_list_label(wendigo_device *dev, char *label, uint8_t len) {
+  if ((dev->scanType == SCAN_HCI || dev->scanType == SCAN_BLE) &&
+      dev->radio.bluetooth.bdname_len > 0 && dev->radio.bluetooth.bdname != NULL) {
+    snprintf(label, len, "%s", dev->radio.bluetooth.bdname);
+  } else if (dev->scanType == SCAN_WIFI_AP && dev->radio.ap.ssid[0] != '\0') {
+    snprintf(label, len, "%s", dev->radio.ap.ssid);
+  } else {
+    bytes_to_string(dev->mac, MAC_BYTES, label);
+  }
+}
+
+/** Place a text representation of option `option_index` of `dev` in `value`.
+ * `value` is set to the empty string if the option is not valid for `dev`.
+ */
+static void wendigo_scene_device_list_option_value(wendigo_device *dev, uint8_t option_index,
+                                                   char *value, uint8_t len) {
+  value[0] = '\0';
+  if (((dev->scanType == SCAN_HCI || dev->scanType == SCAN_BLE) &&
+        option_index == WendigoOptionBTRSSI) ||
+      (dev->scanType == SCAN_WIFI_AP && option_index == WendigoOptionAPRSSI) ||
+      (dev->scanType == SCAN_WIFI_STA && option_index == WendigoOptionSTARSSI)) {
+    snprintf(value, len, "%d dB", dev->rssi);
+  } else if (((dev->scanType == SCAN_HCI || dev->scanType == SCAN_BLE) &&
+                option_index == WendigoOptionBTTagUntag) ||
+              (dev->scanType == SCAN_WIFI_AP && option_index == WendigoOptionAPTagUntag) ||
+              (dev->scanType == SCAN_WIFI_STA && option_index == WendigoOptionSTATagUntag)) {
+    snprintf(value, len, "%s", (dev->tagged) ? "Untag" : "Tag");
+  } else if (((dev->scanType == SCAN_HCI || dev->scanType == SCAN_BLE) &&
+                option_index == WendigoOptionBTScanType) ||
+              (dev->scanType == SCAN_WIFI_AP && option_index == WendigoOptionAPScanType) ||
+              (dev->scanType == SCAN_WIFI_STA && option_index == WendigoOptionSTAScanType)) {
+    snprintf(value, len, "%s",
+      (dev->scanType == SCAN_HCI)           ? "BT Classic"
+        : (dev->scanType == SCAN_BLE)       ? "BLE"
+        : (dev->scanType == SCAN_WIFI_AP)   ? "WiFi AP"
+        : (dev->scanType == SCAN_WIFI_STA)  ? "WiFi STA"
+                                            : "Unknown Device");
+  } else if (((dev->scanType == SCAN_HCI || dev->scanType == SCAN_BLE) &&
+                option_index == WendigoOptionBTLastSeen) ||
+              (dev->scanType == SCAN_WIFI_AP && option_index == WendigoOptionAPLastSeen) ||
+              (dev->scanType == SCAN_WIFI_STA && option_index == WendigoOptionSTALastSeen)) {
+    elapsedTime(dev, value, len);
+  } else if ((dev->scanType == SCAN_HCI || dev->scanType == SCAN_BLE) &&
+              option_index == WendigoOptionBTCod) {
+    wendigo_cod_to_str(dev->radio.bluetooth.cod_major, dev->radio.bluetooth.cod_minor, true,
+      value, len);
+  } else if (dev->scanType == SCAN_WIFI_AP && option_index == WendigoOptionAPChannel) {
+    snprintf(value, len, "Ch. %d", dev->radio.ap.channel);
+  } else if (dev->scanType == SCAN_WIFI_STA && option_index == WendigoOptionSTAChannel) {
+    snprintf(value, len, "Ch. %d", dev->radio.sta.channel);
+  } else if (dev->scanType == SCAN_WIFI_AP && option_index == WendigoOptionAPAuthMode) {
+    uint8_t mode = dev->radio.ap.authmode;
+    if (mode > WIFI_AUTH_MAX) {
+      mode = WIFI_AUTH_MAX;
     }
-    optionsCount = WendigoOptionsSTACount;
-    if (dev->view == NULL) {
-      optionIndex = WendigoOptionSTAScanType;
+    snprintf(value, len, "%s", wifi_auth_mode_strings[mode]);
+  } else if (dev->scanType == SCAN_WIFI_AP && option_index == WendigoOptionAPStaCount) {
+    snprintf(value, len, "%d Stations", dev->radio.ap.stations_count);
+  } else if (dev->scanType == SCAN_WIFI_STA && option_index == WendigoOptionSTASavedNetworks) {
+    snprintf(value, len, "%d Networks", dev->radio.sta.saved_networks_count);
+  } else if (((dev->scanType == SCAN_HCI || dev->scanType == SCAN_BLE) &&
+                option_index == WendigoOptionBTSort) ||
+              (dev->scanType == SCAN_WIFI_AP && option_index == WendigoOptionAPSort) ||
+              (dev->scanType == SCAN_WIFI_STA && option_index == WendigoOptionSTASort)) {
+    snprintf(value, len, "%s", sort_key_strings[device_list_sort]);
+  } else if (dev->scanType == SCAN_WIFI_STA && option_index == WendigoOptionSTAAP) {
+    if (memcmp(dev->radio.sta.apMac, nullMac, MAC_BYTES)) {
+      /* AP has a MAC - Do we have the AP in our cache? */
+      uint16_t apIdx = device_index_from_mac(dev->radio.sta.apMac);
+      if (apIdx == devices_count || devices == NULL || devices[apIdx] == NULL ||
+          devices[apIdx]->scanType != SCAN_WIFI_AP || devices[apIdx]->radio.ap.ssid[0] == '\0') {
+        /* Either we don't have the AP in our cache or
+         * the AP's SSID is unknown - Use MAC instead */
+        bytes_to_string(dev->radio.sta.apMac, MAC_BYTES, value);
+      } else {
+        /* We have an SSID for the AP */
+        snprintf(value, len, "%s", devices[apIdx]->radio.ap.ssid);
+      }
     } else {
-      optionIndex = variable_item_get_current_value_index(dev->view);
+      /* We don't know the AP */
+      snprintf(value, len, "AP Unknown");
     }
-    switch (optionIndex) {
-      case WendigoOptionSTARSSI:
-        snprintf(optionValue, sizeof(optionValue), "%d dB", dev->rssi);
-        break;
-      case WendigoOptionSTALastSeen:
-        elapsedTime(dev, optionValue, sizeof(optionValue));
-        break;
-      case WendigoOptionSTAChannel:
-        snprintf(optionValue, sizeof(optionValue), "Ch. %d",
-                dev->radio.sta.channel);
-        break;
-      case WendigoOptionSTAAP:
-        if (memcmp(dev->radio.sta.apMac, nullMac, MAC_BYTES)) {
-          /* AP has a MAC - Do we have the AP in our cache? */
-          uint16_t apIdx = device_index_from_mac(dev->radio.sta.apMac);
-          if (apIdx == devices_count || devices == NULL ||
-              devices[apIdx] == NULL || devices[apIdx]->scanType !=
-              SCAN_WIFI_AP || devices[apIdx]->radio.ap.ssid[0] == '\0') {
-            /* Either we don't have the AP in our cache or
-             * the AP's SSID is unknown - Use MAC instead */
-            bytes_to_string(dev->radio.sta.apMac, MAC_BYTES, optionValue);
-          } else {
-            /* We have an SSID for the AP */
-            snprintf(optionValue, sizeof(optionValue), "%s",
-                    devices[apIdx]->radio.ap.ssid);
-          }
-        } else {
-          /* We don't know the AP */
-          snprintf(optionValue, sizeof(optionValue), "AP Unknown");
-        }
-        break;
-      case WendigoOptionSTAScanType:
-        snprintf(optionValue, sizeof(optionValue), "%s",
-          (dev->scanType == SCAN_WIFI_STA) ? "WiFi STA"
-                                            : "Unknown");
-        break;
-      case WendigoOptionSTASavedNetworks:
-        snprintf(optionValue, sizeof(optionValue), "%d Networks",
-          dev->radio.sta.saved_networks_count);
-        break;
-      default:
-        /* Nothing to do, I think */
+  }
+}
+
+/** Compare two devices using device_list_sort. Returns a negative value if `a`
+ * should be displayed before `b`, positive if after, and zero if the order
+ * doesn't matter.
+ */
+static int wendigo_scene_device_list_compare(wendigo_device *a, wendigo_device *b) {
+  int result = 0;
+  char label_a[MAX_SSID_LEN + 1];
+  char label_b[MAX_SSID_LEN + 1];
+  switch (device_list_sort) {
+    case WendigoSortLastSeen:
+      /* Most recently seen first */
+      result = (a->lastSeen > b->lastSeen) ? -1 : (a->lastSeen < b->lastSeen) ? 1 : 0;
+      break;
+    case WendigoSortRSSI:
+      /* Strongest signal first */
+      result = b->rssi - a->rssi;
+      break;
+    case WendigoSortType:
+      result = a->scanType - b->scanType;
+      if (result != 0) {
         break;
+      }
+      /* Order devices of the same type by name */
+      // fall through
+    case WendigoSortName:
+      wendigo_scene_device_list_label(a, label_a, sizeof(label_a));
+      wendigo_scene_device_list_label(b, label_b, sizeof(label_b));
+      result = strcasecmp(label_a, label_b);
+      break;
+    default:
+      break;
+  }
+  /* Use MAC as a tie-breaker so the order is stable */
+  if (result == 0 && device_list_sort != WendigoSortNone) {
+    result = memcmp(a->mac, b->mac, MAC_BYTES);
+  }
+  return result;
+}
+
+static int wendigo_scene_device_list_qsort_compare(const void *a, const void *b) {
+  return wendigo_scene_device_list_compare(*(wendigo_device **)a, *(wendigo_device **)b);
+}
+
+/** Set view_index for current_devices.devices[from] to [to - 1] */
+static void wendigo_scene_device_list_reindex(uint16_t from, uint16_t to) {
+  for (uint16_t i = from; i < to && i < current_devices.devices_count; ++i) {
+    if (current_devices.devices[i] != NULL) {
+      current_devices.devices[i]->view_index = i;
     }
-  } else {
-    /* Invalid device type */
+  }
+}
+
+/** Sort all of current_devices.devices[]. Only needed when the sort key
+ * changes or the list is re-populated - otherwise the order is maintained by
+ * wendigo_scene_device_list_end_refresh() as devices change.
+ */
+static void wendigo_scene_device_list_sort() {
+  if (device_list_sort != WendigoSortNone && current_devices.devices != NULL &&
+      current_devices.devices_count > 1) {
+    qsort(current_devices.devices, current_devices.devices_count, sizeof(wendigo_device *),
+      wendigo_scene_device_list_qsort_compare);
+  }
+  wendigo_scene_device_list_reindex(0, current_devices.devices_count);
+}
+
+/** Format callback for the device list view. Called at draw time for each row
+ * that is on screen, so the text displayed is always current and nothing is
+ * stored for rows that aren't visible.
+ */
+static void wendigo_scene_device_list_format_callback(uint16_t index,
+                                                      Wendigo_DeviceListRow *row,
+                                                      void *context) {
+  UNUSED(context);
+  wendigo_device *dev = wendigo_scene_device_list_device_at(index);
+  if (dev == NULL && index == current_devices.devices_count &&
+      wendigo_scene_device_list_has_spill_row()) {
+    snprintf(row->label, sizeof(row->label), "%u more on SD card", wendigo_spill_count());
+    return;
+  }
+  if (dev == NULL) {
+    snprintf(row->label, sizeof(row->label), "(Unknown)");
+    return;
+  }
+  row->options_count = wendigo_scene_device_list_options_count(dev);
+  if (dev->view_option >= row->options_count) {
+    dev->view_option = wendigo_scene_device_list_default_option(dev);
+  }
+  row->option = dev->view_option;
+  wendigo_scene_device_list_label(dev, row->label, sizeof(row->label));
+  wendigo_scene_device_list_option_value(dev, row->option, row->value, sizeof(row->value));
+}
+
+/* If more than 1 / DEVICE_LIST_RESORT_FRACTION of the list has changed
+ * since the last refresh, re-sort the whole list rather than inserting the
+ * changed devices one at a time */
+#define DEVICE_LIST_RESORT_FRACTION (8)
+
+/* While the device list is being refreshed, current_devices.devices[] holds
+ * the devices that haven't changed, still in order, followed by those that
+ * have. refresh_sorted_count is the number of devices in the first part. */
+static uint16_t refresh_sorted_count = 0;
+/* Device selected in the device list when wendigo_scene_device_list_begin_refresh()
+   was called, so the selection can follow it if it moves */
+static wendigo_device *refresh_selected_device = NULL;
+static uint16_t refresh_selected_index = 0;
+
+/** Start refreshing the device list with the devices added to or updated in
+ * the device cache since the last refresh. Called by
+ * wendigo_flush_dirty_devices() in wendigo_scan.c, from this scene's tick
+ * event, with app->devicesMutex held. The draw callback reads current_devices
+ * on the GUI thread, so the list can't be drawn until
+ * wendigo_scene_device_list_end_refresh() is called.
+ */
+void wendigo_scene_device_list_begin_refresh(WendigoApp *app) {
+  refresh_selected_index = wendigo_device_list_view_get_selected(app->devices_list_view);
+  refresh_selected_device = wendigo_scene_device_list_device_at(refresh_selected_index);
+  wendigo_device_list_view_begin_update(app->devices_list_view);
+  refresh_sorted_count = current_devices.devices_count;
+}
+
+/** Update the current display to reflect a new discovery result for `dev`.
+ * Must be called between wendigo_scene_device_list_begin_refresh() and
+ * wendigo_scene_device_list_end_refresh().
+ * Rows are formatted when they're drawn, so the only things to do here are
+ * adding newly-displayed devices to current_devices and, if the list is
+ * sorted, detaching the device from its current position so
+ * wendigo_scene_device_list_end_refresh() can find its new one - updated
+ * values are picked up by the next redraw.
+ */
+void wendigo_scene_device_list_update(WendigoApp *app, wendigo_device *dev) {
+  FURI_LOG_D(WENDIGO_TAG, "Start wendigo_scene_device_list_update()");
+  UNUSED(app);
+  /* This will also cater for a NULL dev */
+  if (!wendigo_device_is_displayed(dev)) {
     return;
   }
-  uint16_t dev_idx = custom_device_index(dev, current_devices.devices, current_devices.devices_count);
+  uint16_t dev_idx = wendigo_scene_device_list_index_of(dev);
   if (dev_idx == current_devices.devices_count) {
-    /* Add a new item */
-    dev->view = variable_item_list_add(
-        app->devices_var_item_list, (name == NULL) ? "(Unknown)" : name,
-        optionsCount, wendigo_scene_device_list_var_list_change_callback, app);
-    /* And set selected option */
-    variable_item_set_current_value_index(dev->view, optionIndex);
-    variable_item_set_current_value_text(dev->view, optionValue);
     /* Update current_devices.devices[] to include the new device */
     if (!current_devices.free_devices) {
       char *msg = malloc(sizeof(char) * (123 + MAX_SSID_LEN)); /* Length assumes that a bdname won't be longer than MAX_SSID_LEN */
-      if (msg == NULL || name == NULL) {
+      if (msg == NULL) {
         wendigo_log(MSG_ERROR, "Adding new device to current_devices.devices[] but it is configured to be immutable. Ignoring this and adding anyway...");
       } else {
+        char name[MAX_SSID_LEN + 1];
+        wendigo_scene_device_list_label(dev, name, sizeof(name));
         snprintf(msg, 123 + MAX_SSID_LEN,
           "Adding a new device %s to current_devices.devices[] but it is configured to be immutable. Ignoring this and adding anyway...",
           name);
         wendigo_log(MSG_ERROR, msg);
-      }
-      if (msg != NULL) {
         free(msg);
       }
     }
     wendigo_device **new_devices = realloc(current_devices.devices, sizeof(wendigo_device *) * (current_devices.devices_count + 1));
     if (new_devices != NULL) {
       current_devices.devices = new_devices;
+      dev->view_option = wendigo_scene_device_list_default_option(dev);
+      dev->view_index = current_devices.devices_count;
       current_devices.devices[current_devices.devices_count++] = dev;
     }
+    return;
+  }
+  if (device_list_sort == WendigoSortNone || dev_idx >= refresh_sorted_count) {
+    /* The order doesn't depend on what's changed, or it's already detached */
+    return;
+  }
+  /* Move the device to the start of the changed devices, keeping the
+     unchanged devices in order */
+  wendigo_device **list = current_devices.devices;
+  memmove(&(list[dev_idx]), &(list[dev_idx + 1]),
+    sizeof(wendigo_device *) * (refresh_sorted_count - dev_idx - 1));
+  list[--refresh_sorted_count] = dev;
+  wendigo_scene_device_list_reindex(dev_idx, refresh_sorted_count + 1);
+  FURI_LOG_D(WENDIGO_TAG, "End wendigo_scene_device_list_update()");
+}
+
+/** Finish refreshing the device list - Put the devices passed to
+ * wendigo_scene_device_list_update() in their correct positions and allow the
+ * list to be drawn again with its new length, keeping the same device
+ * selected. Each changed device is binary-inserted into the unchanged
+ * devices, which are all still in order, unless so many have changed that
+ * re-sorting the whole list is cheaper.
+ */
+void wendigo_scene_device_list_end_refresh(WendigoApp *app) {
+  wendigo_device **list = current_devices.devices;
+  uint16_t count = current_devices.devices_count;
+  uint16_t changed = count - refresh_sorted_count;
+  if (device_list_sort != WendigoSortNone && changed > 0) {
+    if (changed > count / DEVICE_LIST_RESORT_FRACTION) {
+      wendigo_scene_device_list_sort();
+    } else {
+      uint16_t first_moved = count;
+      for (uint16_t i = refresh_sorted_count; i < count; ++i) {
+        wendigo_device *dev = list[i];
+        /* Find the first of list[0] to list[i - 1] that dev sorts before */
+        uint16_t low = 0;
+        uint16_t high = i;
+        while (low < high) {
+          uint16_t mid = low + (high - low) / 2;
+          if (wendigo_scene_device_list_compare(dev, list[mid]) < 0) {
+            high = mid;
+          } else {
+            low = mid + 1;
+          }
+        }
+        memmove(&(list[low + 1]), &(list[low]), sizeof(wendigo_device *) * (i - low));
+        list[low] = dev;
+        if (low < first_moved) {
+          first_moved = low;
+        }
+      }
+      wendigo_scene_device_list_reindex(first_moved, count);
+    }
+  }
+  refresh_sorted_count = count;
+  wendigo_device_list_view_end_update(app->devices_list_view, false);
+  /* Devices restored from the SD card change the number of rows, even if
+     they aren't displayed */
+  uint16_t rows = wendigo_scene_device_list_row_count();
+  if (rows != wendigo_device_list_view_get_count(app->devices_list_view)) {
+    wendigo_device_list_view_set_count(app->devices_list_view, rows);
+  }
+  uint16_t selected = refresh_selected_index;
+  if (refresh_selected_device != NULL) {
+    selected = wendigo_scene_device_list_index_of(refresh_selected_device);
+  }
+  if (selected != refresh_selected_index && selected < count) {
+    wendigo_device_list_view_set_selected(app->devices_list_view, selected);
+  }
+  refresh_selected_device = NULL;
+}
+
+/* Device selected in the device list when wendigo_scene_device_list_begin_removal()
+   was called, so the selection can follow it as devices before it are removed */
+static wendigo_device *removal_selected_device = NULL;
+static uint16_t removal_selected_index = 0;
+
+/** Start removing devices from the device list, ahead of them being removed
+ * from the device cache. Called from wendigo_prune.c on the UART thread with
+ * app->devicesMutex held; the device list can't be drawn until
+ * wendigo_scene_device_list_end_removal() is called.
+ */
+void wendigo_scene_device_list_begin_removal(WendigoApp *app) {
+  FURI_LOG_T(WENDIGO_TAG, "Start wendigo_scene_device_list_begin_removal()");
+  removal_selected_index = wendigo_device_list_view_get_selected(app->devices_list_view);
+  removal_selected_device = wendigo_scene_device_list_device_at(removal_selected_index);
+  wendigo_device_list_view_begin_update(app->devices_list_view);
+  FURI_LOG_T(WENDIGO_TAG, "End wendigo_scene_device_list_begin_removal()");
+}
+
+/** Remove `dev` from `list->devices[]`. Returns true if it was there. */
+static bool wendigo_scene_device_list_remove_from(DeviceListInstance *list, wendigo_device *dev) {
+  if (list->devices == NULL || list->devices_count == 0) {
+    return false;
+  }
+  uint16_t idx;
+  if (list == &current_devices) {
+    idx = wendigo_scene_device_list_index_of(dev);
   } else {
-    /* Update dev->view */
-    // YAGNI: Seems to be an occasional bug with the API - This results in occasional NULL pointer dereference
-    //variable_item_set_item_label(dev->view, (name == NULL) ? "(Unknown)" : name);
+    for (idx = 0; idx < list->devices_count && list->devices[idx] != dev; ++idx) { }
+  }
+  if (idx >= list->devices_count) {
+    return false;
   }
-  if (dev->view != NULL) {
-    variable_item_set_current_value_index(dev->view, optionIndex);
-    if (optionValue[0] != '\0') {
-      /* New value for the option */
-      // YAGNI: Seems to be an occasional bug with the PI - This results in an occasional NULL pointer dereference
-      //variable_item_set_current_value_text(dev->view, optionValue);
+  if (!list->free_devices) {
+    /* devices[] belongs to someone else - Take a copy before modifying it */
+    wendigo_device **copy = malloc(sizeof(wendigo_device *) * list->devices_count);
+    if (copy == NULL) {
+      wendigo_log(MSG_ERROR, "Unable to copy a device list to remove a device from it, emptying it instead.");
+      list->devices = NULL;
+      list->devices_count = 0;
+      list->free_devices = true;
+      return true;
     }
+    memcpy(copy, list->devices, sizeof(wendigo_device *) * list->devices_count);
+    list->devices = copy;
+    list->free_devices = true;
   }
-  /* Free `name` if we malloc'd it */
-  if (free_name && name != NULL) {
-    free(name);
+  memmove(&(list->devices[idx]), &(list->devices[idx + 1]),
+    sizeof(wendigo_device *) * (list->devices_count - idx - 1));
+  --list->devices_count;
+  if (list == &current_devices) {
+    wendigo_scene_device_list_reindex(idx, current_devices.devices_count);
   }
-  FURI_LOG_D(WENDIGO_TAG, "End wendigo_scene_device_list_update()");
+  return true;
+}
+
+/** Remove `dev` from the displayed device list and every device list on the
+ * stack. Must be called between wendigo_scene_device_list_begin_removal() and
+ * wendigo_scene_device_list_end_removal().
+ */
+void wendigo_scene_device_list_remove_device(wendigo_device *dev) {
+  if (dev == NULL) {
+    return;
+  }
+  if (wendigo_scene_device_list_remove_from(&current_devices, dev) &&
+      dev == removal_selected_device) {
+    removal_selected_device = NULL;
+  }
+  for (uint8_t i = 0; i < stack_counter && stack != NULL; ++i) {
+    wendigo_scene_device_list_remove_from(&(stack[i]), dev);
+  }
+}
+
+/** Finish removing devices - Allow the device list to be drawn again with
+ * its new length, keeping the same device selected if it's still there.
+ */
+void wendigo_scene_device_list_end_removal(WendigoApp *app) {
+  FURI_LOG_T(WENDIGO_TAG, "Start wendigo_scene_device_list_end_removal()");
+  wendigo_device_list_view_end_update(app->devices_list_view, false);
+  uint16_t selected = removal_selected_index;
+  if (removal_selected_device != NULL) {
+    selected = wendigo_scene_device_list_index_of(removal_selected_device);
+  }
+  if (current_devices.devices_count == 0) {
+    selected = 0;
+  } else if (selected >= current_devices.devices_count) {
+    selected = current_devices.devices_count - 1;
+  }
+  wendigo_device_list_view_set_count(app->devices_list_view,
+    wendigo_scene_device_list_row_count());
+  wendigo_device_list_view_set_selected(app->devices_list_view, selected);
+  app->device_list_selected_menu_index = selected;
+  removal_selected_device = NULL;
+  FURI_LOG_T(WENDIGO_TAG, "End wendigo_scene_device_list_end_removal()");
 }
 
-/** Re-render the variable item list. This function exists because there is no
- * method to remove items from a variable_item_list, but that is sometimes
- * necessary (e.g. when viewing selected devices and de-selecting a device).
+/** Re-populate the device list from current_devices. Used when the devices
+ * displayed may have changed in ways other than new devices being added (e.g.
+ * when viewing selected devices and de-selecting a device).
  */
 void wendigo_scene_device_list_redraw(WendigoApp *app) {
   FURI_LOG_T(WENDIGO_TAG, "Start wendigo_scene_device_list_redraw()");
-  variable_item_list_reset(app->devices_var_item_list);
-  char *item_str = NULL;
-  uint8_t options_count = 0;
-  uint8_t options_index;
-  bool free_item_str = false;
+  wendigo_device_list_view_begin_update(app->devices_list_view);
   wendigo_scene_device_list_set_current_devices_mask(current_devices.devices_mask);
-  /* Set header text for the list if specified. NULL first to prevent text-over-text */
-  variable_item_list_set_header(app->devices_var_item_list, NULL);
-  if (current_devices.devices_msg[0] != '\0') {
-    variable_item_list_set_header(app->devices_var_item_list, current_devices.devices_msg);
-  }
+  /* Default to displaying scanType in options menu */
   for (uint16_t i = 0; i < current_devices.devices_count; ++i) {
-    /* Label with bdname if it's bluetooth & we have a name */
-    if (current_devices.devices[i] != NULL && (current_devices.devices[i]->scanType == SCAN_HCI ||
-          current_devices.devices[i]->scanType == SCAN_BLE)) {
-      if (current_devices.devices[i]->radio.bluetooth.bdname_len > 0 &&
-          current_devices.devices[i]->radio.bluetooth.bdname != NULL) {
-        item_str = current_devices.devices[i]->radio.bluetooth.bdname;
-      } else {
-        /* Use MAC */
-        item_str = malloc(sizeof(char) * (MAC_STRLEN + 1));
-        if (item_str != NULL) {
-          bytes_to_string(current_devices.devices[i]->mac, MAC_BYTES, item_str);
-        }
-        free_item_str = true;
-      }
-      options_count = WendigoOptionsBTCount;
-      options_index = WendigoOptionBTScanType;
-      /* Label with SSID if it's an AP and we have an SSID */
-    } else if (current_devices.devices[i] != NULL &&
-              current_devices.devices[i]->scanType == SCAN_WIFI_AP) {
-      if (current_devices.devices[i]->radio.ap.ssid[0] != '\0') {
-        item_str = current_devices.devices[i]->radio.ap.ssid;
-      } else {
-        /* Use MAC */
-        item_str = malloc(sizeof(char) * (MAC_STRLEN + 1));
-        if (item_str != NULL) {
-          bytes_to_string(current_devices.devices[i]->mac, MAC_BYTES, item_str);
-        }
-        free_item_str = true;
-      }
-      options_count = WendigoOptionsAPCount;
-      options_index = WendigoOptionAPScanType;
-      /* Otherwise use the MAC/BDA */
-    } else if (current_devices.devices[i] != NULL) {
-      item_str = malloc(sizeof(char) * (MAC_STRLEN + 1));
-      if (item_str != NULL) {
-        bytes_to_string(current_devices.devices[i]->mac, MAC_BYTES, item_str);
-      }
-      free_item_str = true;
-      options_count = WendigoOptionsSTACount;
-      options_index = WendigoOptionSTAScanType;
-    }
-    if (current_devices.devices[i] != NULL && item_str != NULL && options_count > 0) {
-      current_devices.devices[i]->view = variable_item_list_add(
-          app->devices_var_item_list, item_str, options_count,
-          wendigo_scene_device_list_var_list_change_callback, app);
-    }
-    /* free item_str if we malloc'd it */
-    if (free_item_str && item_str != NULL) {
-      free(item_str);
-    }
-    /* Default to displaying scanType in options menu */
-    if (current_devices.devices[i] != NULL && current_devices.devices[i]->view != NULL) {
-      variable_item_set_current_value_index(current_devices.devices[i]->view,
-                                            options_index);
-      variable_item_set_current_value_text(current_devices.devices[i]->view,
-          (current_devices.devices[i]->scanType == SCAN_HCI)        ? "BT Classic"
-          : (current_devices.devices[i]->scanType == SCAN_BLE)      ? "BLE"
-          : (current_devices.devices[i]->scanType == SCAN_WIFI_AP)  ? "WiFi AP"
-          : (current_devices.devices[i]->scanType == SCAN_WIFI_STA) ? "WiFi STA"
-                                                                    : "Unknown");
+    if (current_devices.devices[i] != NULL) {
+      current_devices.devices[i]->view_option =
+        wendigo_scene_device_list_default_option(current_devices.devices[i]);
     }
   }
-  variable_item_list_set_selected_item(app->devices_var_item_list, 0);
+  wendigo_scene_device_list_sort();
+  wendigo_device_list_view_end_update(app->devices_list_view, false);
+  /* Set header text for the list if specified */
+  wendigo_device_list_view_set_header(app->devices_list_view,
+    (current_devices.devices_msg[0] == '\0') ? NULL : current_devices.devices_msg);
+  wendigo_device_list_view_set_count(app->devices_list_view,
+    wendigo_scene_device_list_row_count());
+  wendigo_device_list_view_set_selected(app->devices_list_view, 0);
   FURI_LOG_T(WENDIGO_TAG, "End wendigo_scene_device_list_redraw()");
 }
 
-static void wendigo_scene_device_list_var_list_enter_callback(void *context,
-                                                              uint32_t index) {
-  FURI_LOG_T(WENDIGO_TAG, "Start wendigo_scene_device_list_var_list_enter_callback()");
-  furi_assert(context);
-  WendigoApp *app = context;
-
-  furi_assert(index < current_devices.devices_count);
-
-  wendigo_device *item = current_devices.devices[index];
+/** Act on the option displayed for the device at `index`. Called by
+ * wendigo_scene_device_list_enter_callback() with app->devicesMutex held.
+ */
+static void wendigo_scene_device_list_enter(WendigoApp *app, uint16_t index) {
+  wendigo_device *item = wendigo_scene_device_list_device_at(index);
   if (item == NULL) {
     return;
   }
@@ -758,44 +956,56 @@ static void wendigo_scene_device_list_var_list_enter_callback(void *context,
 
   /* If the tag/untag menu item is selected perform that action, otherwise
    * display details for `item` */
-  if (item->view != NULL &&
-      (((item->scanType == SCAN_HCI || item->scanType == SCAN_BLE) &&
-        variable_item_get_current_value_index(item->view) ==
-            WendigoOptionBTTagUntag) ||
-        (item->scanType == SCAN_WIFI_AP &&
-        variable_item_get_current_value_index(item->view) ==
-            WendigoOptionAPTagUntag) ||
-        (item->scanType == SCAN_WIFI_STA &&
-        variable_item_get_current_value_index(item->view) ==
-            WendigoOptionSTATagUntag))) {
+  if (((item->scanType == SCAN_HCI || item->scanType == SCAN_BLE) &&
+        item->view_option == WendigoOptionBTTagUntag) ||
+      (item->scanType == SCAN_WIFI_AP && item->view_option == WendigoOptionAPTagUntag) ||
+      (item->scanType == SCAN_WIFI_STA && item->view_option == WendigoOptionSTATagUntag)) {
     item->tagged = !(item->tagged);
-    variable_item_set_current_value_text(item->view,
-                                        (item->tagged) ? "Untag" : "Tag");
+    wendigo_tag_device(app, item);
     /* If the device is now untagged and we're viewing tagged devices only,
      * remove the device from view unless custom device view is enabled. */
     if (((current_devices.devices_mask & DEVICE_SELECTED_ONLY) == DEVICE_SELECTED_ONLY) &&
         !item->tagged && ((current_devices.devices_mask & DEVICE_CUSTOM) != DEVICE_CUSTOM)) {
-      /* Bugger - There's no method to remove an item from a variable_item_list */
-      item->view = NULL; // TODO: Is this leaking memory? Can I free a VariableItem?
       wendigo_scene_device_list_redraw(app);
+    } else {
+      wendigo_device_list_view_refresh(app->devices_list_view);
     }
-  } else if (item->view != NULL && ((item->scanType == SCAN_WIFI_AP &&
-      variable_item_get_current_value_index(item->view) ==
-      WendigoOptionAPStaCount) || (item->scanType == SCAN_WIFI_STA &&
-      variable_item_get_current_value_index(item->view) ==
-      WendigoOptionSTAAP))) {
+  } else if (((item->scanType == SCAN_HCI || item->scanType == SCAN_BLE) &&
+        item->view_option == WendigoOptionBTSort) ||
+      (item->scanType == SCAN_WIFI_AP && item->view_option == WendigoOptionAPSort) ||
+      (item->scanType == SCAN_WIFI_STA && item->view_option == WendigoOptionSTASort)) {
+    /* Cycle through sort orders and re-sort the list, keeping `item` selected */
+    device_list_sort = (device_list_sort + 1) % WendigoSortCount;
+    wendigo_device_list_view_begin_update(app->devices_list_view);
+    if (device_list_sort == WendigoSortNone) {
+      /* Restore discovery order. This does nothing for custom device lists,
+       * which keep their most recent order. */
+      wendigo_scene_device_list_set_current_devices_mask(current_devices.devices_mask);
+    }
+    wendigo_scene_device_list_sort();
+    wendigo_device_list_view_end_update(app->devices_list_view, false);
+    wendigo_device_list_view_set_count(app->devices_list_view,
+      wendigo_scene_device_list_row_count());
+    app->device_list_selected_menu_index = wendigo_scene_device_list_index_of(item);
+    wendigo_device_list_view_set_selected(app->devices_list_view,
+      app->device_list_selected_menu_index);
+  } else if ((item->scanType == SCAN_WIFI_AP && item->view_option == WendigoOptionAPStaCount) ||
+      (item->scanType == SCAN_WIFI_STA && item->view_option == WendigoOptionSTAAP)) {
     /* Push current_devices onto the device list stack */
     DeviceListInstance *new_stack = realloc(stack, sizeof(DeviceListInstance) * (stack_counter + 1));
     if (new_stack == NULL) {
       wendigo_display_popup(app, "Insufficient Memory", "Unable to allocate an additional DeviceListInstance.");
-      wendigo_log(MSG_ERROR, "wendigo_scene_device_list_var_list_enter_callback() terminated early. Unable to malloc() additional DeviceListInstance.");
+      wendigo_log(MSG_ERROR, "wendigo_scene_device_list_enter_callback() terminated early. Unable to malloc() additional DeviceListInstance.");
       return;
     } else {
       memcpy(&(new_stack[stack_counter]), &current_devices, sizeof(DeviceListInstance));
       stack = new_stack;
       ++stack_counter;
     }
-    /* Re-initialise current_devices */
+    /* Re-initialise current_devices. The list is still displayed until the
+     * scene changes, so hold the view while we do */
+    bool stations_failed = false;
+    wendigo_device_list_view_begin_update(app->devices_list_view);
     current_devices.devices_mask = DEVICE_CUSTOM;
     current_devices.view = WendigoAppViewDeviceList;
     current_devices.free_devices = true;
@@ -806,7 +1016,7 @@ static void wendigo_scene_device_list_var_list_enter_callback(void *context,
     if (deviceName == NULL) {
       /* Not using wendigo_log() so I can include %d */
       // TODO: Extend wendigo_log() to support variable arguments
-      FURI_LOG_E("wendigo_scene_device_list_var_list_enter_callback()",
+      FURI_LOG_E("wendigo_scene_device_list_enter_callback()",
         "Failed to allocate deviceName[%d], proceeding without it.", MAX_SSID_LEN + 1);
     } else {
       bzero(deviceName, sizeof(char) * (MAX_SSID_LEN + 1));
@@ -828,7 +1038,7 @@ static void wendigo_scene_device_list_var_list_enter_callback(void *context,
           wendigo_log(MSG_ERROR, msg);
           free(msg);
         }
-        wendigo_display_popup(app, "Out of memory", "Unable to allocate memory for AP's stations.");
+        stations_failed = true;
         current_devices.devices_count = 0;
       } else { /* There are no stations to display or malloc() succeeded */
         current_devices.free_devices = true; /* Don't forget to only free if stations_count > 0 as well */
@@ -839,9 +1049,14 @@ static void wendigo_scene_device_list_var_list_enter_callback(void *context,
         uint16_t idx_sta;
         for (idx_src = 0, idx_dest = 0;
             idx_src < item->radio.ap.stations_count; ++idx_src) {
+          /* Stations that were on the SD card have been restored by
+           * wendigo_scene_device_list_restore_related() */
           idx_sta = device_index_from_mac(item->radio.ap.stations[idx_src]);
-          if (idx_sta < devices_count) {
-            /* The station exists in the cache - add it to current_devices */
+          if (idx_sta < devices_count && (devices[idx_sta]->scanType != SCAN_WIFI_STA ||
+              !memcmp(devices[idx_sta]->radio.sta.apMac, nullMac, MAC_BYTES) ||
+              !memcmp(devices[idx_sta]->radio.sta.apMac, item->mac, MAC_BYTES))) {
+            /* The station exists in the cache and hasn't since been seen with
+             * another AP - add it to current_devices */
             current_devices.devices[idx_dest++] = devices[idx_sta];
           }
         }
@@ -890,23 +1105,31 @@ static void wendigo_scene_device_list_var_list_enter_callback(void *context,
         /* We have a MAC. Find the wendigo_device* */
         uint16_t apIdx = device_index_from_mac(item->radio.sta.apMac);
         if (apIdx < devices_count) {
-          /* Found the AP in the device cache - Display just it */
-          current_devices.devices_count = 1;
-          current_devices.devices = &(devices[apIdx]);
+          /* Found the AP in the device cache - Display just it. This gets
+           * its own array, rather than pointing into devices[], because
+           * devices[] is rearranged when devices are pruned. */
+          current_devices.devices = malloc(sizeof(wendigo_device *));
+          if (current_devices.devices != NULL) {
+            current_devices.devices[0] = devices[apIdx];
+            current_devices.devices_count = 1;
+          }
         }
       }
     } else {
       wendigo_log(MSG_WARN,
         "Logic error: Fell through conditional nest in wendigo_scene_device_list.c");
     }
+    wendigo_device_list_view_end_update(app->devices_list_view, false);
+    if (stations_failed) {
+      wendigo_display_popup(app, "Out of memory", "Unable to allocate memory for AP's stations.");
+    }
     if (deviceName != NULL) {
       free(deviceName);
     }
     view_dispatcher_send_custom_event(app->view_dispatcher,
       Wendigo_EventListDevices);
-  } else if (item->view != NULL && item->scanType == SCAN_WIFI_STA &&
-      variable_item_get_current_value_index(item->view) ==
-        WendigoOptionSTASavedNetworks) {
+  } else if (item->scanType == SCAN_WIFI_STA &&
+      item->view_option == WendigoOptionSTASavedNetworks) {
     /* Tell the scene which device we're interested in */
     wendigo_scene_pnl_list_set_device(item, app);
     view_dispatcher_send_custom_event(app->view_dispatcher,
@@ -918,129 +1141,101 @@ static void wendigo_scene_device_list_var_list_enter_callback(void *context,
     // view_dispatcher_send_custom_event(app->view_dispatcher,
     // Wendigo_EventListDeviceDetails);
   }
-  FURI_LOG_T(WENDIGO_TAG, "End wendigo_scene_device_list_var_list_enter_callback()");
 }
 
-static void wendigo_scene_device_list_var_list_change_callback(VariableItem *item) {
-  FURI_LOG_T(WENDIGO_TAG, "Start wendigo_scene_device_list_var_list_change_callback()");
-  furi_assert(item);
-
-  /* app->device_list_selected_menu_index should reliably point to the selected
-     menu item. Use that to obtain the wendigo_device* */
-  WendigoApp *app = variable_item_get_context(item);
-  app->device_list_selected_menu_index =
-      variable_item_list_get_selected_item_index(app->devices_var_item_list);
-  wendigo_device *menu_item = wendigo_scene_device_list_selected_device(item);
-
-  if (menu_item != NULL) {
-    uint8_t option_index = variable_item_get_current_value_index(item);
-    furi_assert(option_index < MAX_OPTIONS);
-    /* Update the current option label */
-    char tempStr[MAX_SSID_LEN + 1];
-    bzero(tempStr, MAX_SSID_LEN + 1);
-    if (((menu_item->scanType == SCAN_HCI || menu_item->scanType == SCAN_BLE) &&
-          option_index == WendigoOptionBTRSSI) ||
-        (menu_item->scanType == SCAN_WIFI_AP &&
-          option_index == WendigoOptionAPRSSI) ||
-        (menu_item->scanType == SCAN_WIFI_STA &&
-          option_index == WendigoOptionSTARSSI)) {
-      snprintf(tempStr, sizeof(tempStr), "%d dB", menu_item->rssi);
-    } else if (((menu_item->scanType == SCAN_HCI ||
-                  menu_item->scanType == SCAN_BLE) &&
-                  option_index == WendigoOptionBTTagUntag) ||
-                (menu_item->scanType == SCAN_WIFI_AP &&
-                  option_index == WendigoOptionAPTagUntag) ||
-                (menu_item->scanType == SCAN_WIFI_STA &&
-                  option_index == WendigoOptionSTATagUntag)) {
-      snprintf(tempStr, sizeof(tempStr), "%s", (menu_item->tagged) ? "Untag"
-                                                                    : "Tag");
-    } else if (((menu_item->scanType == SCAN_HCI ||
-                  menu_item->scanType == SCAN_BLE) &&
-                  option_index == WendigoOptionBTScanType) ||
-                (menu_item->scanType == SCAN_WIFI_AP &&
-                  option_index == WendigoOptionAPScanType) ||
-                (menu_item->scanType == SCAN_WIFI_STA &&
-                  option_index == WendigoOptionSTAScanType)) {
-      snprintf(tempStr, sizeof(tempStr), "%s",
-        (menu_item->scanType == SCAN_HCI)           ? "BT Classic"
-          : (menu_item->scanType == SCAN_BLE)       ? "BLE"
-          : (menu_item->scanType == SCAN_WIFI_AP)   ? "WiFi AP"
-          : (menu_item->scanType == SCAN_WIFI_STA)  ? "WiFi STA"
-                                                    : "Unknown Device");
-    } else if (((menu_item->scanType == SCAN_HCI ||
-                  menu_item->scanType == SCAN_BLE) &&
-                  option_index == WendigoOptionBTLastSeen) ||
-                (menu_item->scanType == SCAN_WIFI_AP &&
-                  option_index == WendigoOptionAPLastSeen) ||
-                (menu_item->scanType == SCAN_WIFI_STA &&
-                  option_index == WendigoOptionSTALastSeen)) {
-      elapsedTime(menu_item, tempStr, sizeof(tempStr));
-    } else if ((menu_item->scanType == SCAN_HCI ||
-                  menu_item->scanType == SCAN_BLE) &&
-                  option_index == WendigoOptionBTCod) {
-      snprintf(tempStr, sizeof(tempStr), "%s", menu_item->radio.bluetooth.cod_str);
-    } else if (menu_item->scanType == SCAN_WIFI_AP &&
-                option_index == WendigoOptionAPChannel) {
-      snprintf(tempStr, sizeof(tempStr), "Ch. %d", menu_item->radio.ap.channel);
-    } else if (menu_item->scanType == SCAN_WIFI_STA &&
-                option_index == WendigoOptionSTAChannel) {
-      snprintf(tempStr, sizeof(tempStr), "Ch. %d", menu_item->radio.sta.channel);
-    } else if (menu_item->scanType == SCAN_WIFI_AP &&
-                option_index == WendigoOptionAPAuthMode) {
-      uint8_t mode = menu_item->radio.ap.authmode;
-      if (mode > WIFI_AUTH_MAX) {
-        mode = WIFI_AUTH_MAX;
-      }
-      snprintf(tempStr, sizeof(tempStr), "%s", wifi_auth_mode_strings[mode]);
-    } else if (menu_item->scanType == SCAN_WIFI_AP &&
-              option_index == WendigoOptionAPStaCount) {
-      snprintf(tempStr, sizeof(tempStr), "%d Stations",
-              menu_item->radio.ap.stations_count);
-    } else if (menu_item->scanType == SCAN_WIFI_STA &&
-              option_index == WendigoOptionSTASavedNetworks) {
-      snprintf(tempStr, sizeof(tempStr), "%d Networks",
-              menu_item->radio.sta.saved_networks_count);
-    } else if (menu_item->scanType == SCAN_WIFI_STA &&
-                option_index == WendigoOptionSTAAP) {
-      /* Use SSID if available, otherwise MAC */
-      uint16_t apIdx = device_index_from_mac(menu_item->radio.sta.apMac);
-      if (apIdx == devices_count || devices == NULL ||
-          devices[apIdx] == NULL || devices[apIdx]->radio.ap.ssid[0] == '\0') {
-        /* Couldn't find the AP, or found the AP with no SSID */
-        if (memcmp(menu_item->radio.sta.apMac, nullMac, MAC_BYTES)) {
-          /* We have a MAC */
-          bytes_to_string(menu_item->radio.sta.apMac, MAC_BYTES, tempStr);
-        } else {
-          /* No MAC */
-          snprintf(tempStr, sizeof(tempStr), "AP Unknown");
-        }
-      } else {
-        /* We have an SSID */
-        snprintf(tempStr, sizeof(tempStr), "%s", devices[apIdx]->radio.ap.ssid);
-      }
-    } else {
-      char *msg = malloc(sizeof(char) * (68 + MAC_STRLEN));
-      char *macStr = malloc(sizeof(char) * (1 + MAC_STRLEN));
-      if (msg != NULL && macStr != NULL) {
-        bytes_to_string(menu_item->mac, MAC_BYTES, macStr);
-        snprintf(msg, 68 + MAC_STRLEN,
-                "Invalid scanType (%d) / optionIndex (%d) combination for device %s.",
-                menu_item->scanType, option_index, macStr);
-        wendigo_log(MSG_ERROR, msg);
-      }
-      if (msg != NULL) {
-        free(msg);
-      }
-      if (macStr != NULL) {
-        free(macStr);
+/** If the device at `index` is about to display an AP's stations or a
+ * station's AP, bring any of them that were moved to the SD card back into
+ * the device cache. This is done before wendigo_scene_device_list_enter() so
+ * the SD card isn't read with app->devicesMutex held.
+ */
+static void wendigo_scene_device_list_restore_related(WendigoApp *app, uint16_t index) {
+  if (wendigo_spill_count() == 0) {
+    return;
+  }
+  /* Collect the MACs to restore - The device may be removed as soon as
+   * devicesMutex is released */
+  uint8_t (*macs)[MAC_BYTES] = NULL;
+  uint8_t macs_count = 0;
+  furi_mutex_acquire(app->devicesMutex, FuriWaitForever);
+  wendigo_device *item = wendigo_scene_device_list_device_at(index);
+  if (item != NULL && item->scanType == SCAN_WIFI_AP &&
+      item->view_option == WendigoOptionAPStaCount && item->radio.ap.stations_count > 0) {
+    macs = malloc(MAC_BYTES * item->radio.ap.stations_count);
+    for (uint8_t i = 0; macs != NULL && i < item->radio.ap.stations_count; ++i) {
+      if (device_index_from_mac(item->radio.ap.stations[i]) == devices_count) {
+        memcpy(macs[macs_count++], item->radio.ap.stations[i], MAC_BYTES);
       }
     }
-    /* Update the current option's text if we set tempStr */
-    if (tempStr[0] != '\0') {
-      variable_item_set_current_value_text(item, tempStr);
+  } else if (item != NULL && item->scanType == SCAN_WIFI_STA &&
+      item->view_option == WendigoOptionSTAAP &&
+      memcmp(item->radio.sta.apMac, nullMac, MAC_BYTES) &&
+      device_index_from_mac(item->radio.sta.apMac) == devices_count) {
+    macs = malloc(MAC_BYTES);
+    if (macs != NULL) {
+      memcpy(macs[macs_count++], item->radio.sta.apMac, MAC_BYTES);
     }
   }
-  FURI_LOG_T(WENDIGO_TAG, "End wendigo_scene_device_list_var_list_change_callback()");
+  furi_mutex_release(app->devicesMutex);
+  for (uint8_t i = 0; i < macs_count; ++i) {
+    wendigo_spill_restore(app, macs[i]);
+  }
+  if (macs != NULL) {
+    free(macs);
+  }
+}
+
+/** The user has selected the SD card row - Bring back the next batch of
+ * devices from the SD card and add them to the list straight away.
+ */
+static void wendigo_scene_device_list_browse_spill(WendigoApp *app) {
+  if (wendigo_spill_browse(app) == 0) {
+    wendigo_display_popup(app, "SD card", "Unable to read devices from SD card.");
+    return;
+  }
+  wendigo_flush_dirty_devices(app);
+}
+
+static void wendigo_scene_device_list_enter_callback(uint16_t index, void *context) {
+  FURI_LOG_T(WENDIGO_TAG, "Start wendigo_scene_device_list_enter_callback()");
+  furi_assert(context);
+  WendigoApp *app = context;
+  furi_mutex_acquire(app->devicesMutex, FuriWaitForever);
+  bool spill_row = index == current_devices.devices_count &&
+    wendigo_scene_device_list_has_spill_row();
+  furi_mutex_release(app->devicesMutex);
+  if (spill_row) {
+    wendigo_scene_device_list_browse_spill(app);
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_scene_device_list_enter_callback()");
+    return;
+  }
+  wendigo_scene_device_list_restore_related(app, index);
+  /* Devices may be pruned from the cache by the UART thread - Hold
+   * devicesMutex so the device can't be removed while we're using it */
+  furi_mutex_acquire(app->devicesMutex, FuriWaitForever);
+  wendigo_scene_device_list_enter(app, index);
+  furi_mutex_release(app->devicesMutex);
+  FURI_LOG_T(WENDIGO_TAG, "End wendigo_scene_device_list_enter_callback()");
+}
+
+/** The user has scrolled through the options of the device at `index`. The
+ * view redraws the row once this returns, so all that's needed is to remember
+ * the selected option.
+ */
+static void wendigo_scene_device_list_change_callback(uint16_t index, uint8_t option,
+                                                      void *context) {
+  FURI_LOG_T(WENDIGO_TAG, "Start wendigo_scene_device_list_change_callback()");
+  furi_assert(context);
+  WendigoApp *app = context;
+  furi_assert(option < MAX_OPTIONS);
+
+  app->device_list_selected_menu_index = index;
+  furi_mutex_acquire(app->devicesMutex, FuriWaitForever);
+  wendigo_device *menu_item = wendigo_scene_device_list_device_at(index);
+  if (menu_item != NULL) {
+    menu_item->view_option = option;
+  }
+  furi_mutex_release(app->devicesMutex);
+  FURI_LOG_T(WENDIGO_TAG, "End wendigo_scene_device_list_change_callback()");
 }
 
 /** Initialise the device list
@@ -1054,21 +1249,24 @@ void wendigo_scene_device_list_on_enter(void *context) {
   WendigoApp *app = context;
   app->current_view = current_devices.view;
 
+  wendigo_device_list_view_set_callbacks(app->devices_list_view,
+    wendigo_scene_device_list_format_callback, wendigo_scene_device_list_change_callback,
+    wendigo_scene_device_list_enter_callback, app);
+
   /* Reset and re-populate the list */
+  furi_mutex_acquire(app->devicesMutex, FuriWaitForever);
   wendigo_scene_device_list_redraw(app);
-
-  variable_item_list_set_enter_callback(app->devices_var_item_list,
-    wendigo_scene_device_list_var_list_enter_callback, app);
+  furi_mutex_release(app->devicesMutex);
 
   /* Restore the selected device index if it's there to restore (e.g. if we're
    * returning from the device detail scene). But first test that it's in
    * bounds, unless we've moved from all devices to a subset. */
-  uint8_t selected_item = scene_manager_get_scene_state(app->scene_manager,
-                                                        WendigoSceneDeviceList);
-  if (selected_item >= current_devices.devices_count) {
+  uint16_t selected_item = scene_manager_get_scene_state(app->scene_manager,
+                                                         WendigoSceneDeviceList);
+  if (selected_item >= wendigo_scene_device_list_row_count()) {
     selected_item = 0;
   }
-  variable_item_list_set_selected_item(app->devices_var_item_list, selected_item);
+  wendigo_device_list_view_set_selected(app->devices_list_view, selected_item);
   view_dispatcher_switch_to_view(app->view_dispatcher, WendigoAppViewDeviceList);
   FURI_LOG_T(WENDIGO_TAG, "End wendigo_scene_device_list_on_enter()");
 }
@@ -1098,6 +1296,18 @@ bool wendigo_scene_device_list_on_event(void *context,
                                       app->device_list_selected_menu_index);
         scene_manager_next_scene(app->scene_manager, WendigoScenePNLList);
         break;
+    case Wendigo_EventRefreshDeviceList:
+      /* The UART thread couldn't record which devices changed - Check them all */
+      if (app->current_view == WendigoAppViewDeviceList) {
+        furi_mutex_acquire(app->devicesMutex, FuriWaitForever);
+        wendigo_scene_device_list_begin_refresh(app);
+        for (uint16_t i = 0; i < devices_count; ++i) {
+          wendigo_scene_device_list_update(app, devices[i]);
+        }
+        wendigo_scene_device_list_end_refresh(app);
+        furi_mutex_release(app->devicesMutex);
+      }
+      break;
     default:
       char *msg = malloc(sizeof(char) * 54);
       if (msg != NULL) {
@@ -1112,98 +1322,20 @@ bool wendigo_scene_device_list_on_event(void *context,
     consumed = true;
   } else if (event.type == SceneManagerEventTypeTick) {
     app->device_list_selected_menu_index =
-        variable_item_list_get_selected_item_index(app->devices_var_item_list);
+        wendigo_device_list_view_get_selected(app->devices_list_view);
     consumed = true;
 
-    /* Update displayed value for any device where the currently-selected
-     * option is subject to change - lastSeen, RSSI, saved_networks_count,
-     * stations_count, STA's AP, or authMode.
-     * All attributes except lastSeen are only updated if scanning is active.
+    /* At most every DEVICE_LIST_REFRESH_MS, add devices discovered since the
+     * last refresh and redraw so that values subject to change - lastSeen,
+     * RSSI, saved_networks_count, stations_count, STA's AP, authMode - are
+     * current. Only the rows on screen are formatted so this costs the same
+     * however many devices are in the list, and however many packets arrived.
      */
-    char optionValue[MAX_SSID_LEN + 1];
-    uint32_t now = furi_hal_rtc_get_timestamp();
-    for (uint16_t i = 0; i < current_devices.devices_count; ++i) {
-      if (current_devices.devices != NULL && current_devices.devices[i] != NULL &&
-          current_devices.devices[i]->view != NULL) {
-        bzero(optionValue, MAX_SSID_LEN + 1);
-        if (((current_devices.devices[i]->scanType == SCAN_HCI ||
-            current_devices.devices[i]->scanType == SCAN_BLE) &&
-            variable_item_get_current_value_index(current_devices.devices[i]->view) ==
-                WendigoOptionBTLastSeen) ||
-            (current_devices.devices[i]->scanType == SCAN_WIFI_AP &&
-            variable_item_get_current_value_index(current_devices.devices[i]->view) ==
-                WendigoOptionAPLastSeen) ||
-            (current_devices.devices[i]->scanType == SCAN_WIFI_STA &&
-            variable_item_get_current_value_index(current_devices.devices[i]->view) ==
-                WendigoOptionSTALastSeen)) {
-          /* Update lastSeen for this device */
-          _elapsedTime(&(current_devices.devices[i]->lastSeen), &now, optionValue,
-                      sizeof(optionValue));
-        } else if (app->is_scanning && (((current_devices.devices[i]->scanType ==
-            SCAN_HCI || current_devices.devices[i]->scanType == SCAN_BLE) &&
-            variable_item_get_current_value_index(current_devices.devices[i]->view) ==
-            WendigoOptionBTRSSI) || (current_devices.devices[i]->scanType ==
-            SCAN_WIFI_AP && variable_item_get_current_value_index(
-              current_devices.devices[i]->view) == WendigoOptionAPRSSI) ||
-            (current_devices.devices[i]->scanType == SCAN_WIFI_STA &&
-            variable_item_get_current_value_index(current_devices.devices[i]->view) ==
-            WendigoOptionSTARSSI))) {
-          /* Update RSSI for the current device */
-          snprintf(optionValue, sizeof(optionValue), "%d dB",
-            current_devices.devices[i]->rssi);
-        } else if (app->is_scanning && current_devices.devices[i]->scanType ==
-            SCAN_WIFI_AP && variable_item_get_current_value_index(
-              current_devices.devices[i]->view) == WendigoOptionAPStaCount) {
-          /* Update stations_count for the current device */
-          snprintf(optionValue, sizeof(optionValue), "%d Stations",
-              current_devices.devices[i]->radio.ap.stations_count);
-        } else if (app->is_scanning && current_devices.devices[i]->scanType ==
-            SCAN_WIFI_AP && variable_item_get_current_value_index(
-              current_devices.devices[i]->view) == WendigoOptionAPAuthMode) {
-          /* Update authMode for the current device */
-          uint8_t mode = current_devices.devices[i]->radio.ap.authmode;
-          if (mode > WIFI_AUTH_MAX) {
-            mode = WIFI_AUTH_MAX;
-          }
-          snprintf(optionValue, sizeof(optionValue), "%s",
-            wifi_auth_mode_strings[mode]);
-        } else if (app->is_scanning && current_devices.devices[i]->scanType ==
-            SCAN_WIFI_STA && variable_item_get_current_value_index(
-              current_devices.devices[i]->view) == WendigoOptionSTASavedNetworks) {
-          /* Update saved_networks_count for the current device */
-          snprintf(optionValue, sizeof(optionValue), "%d Networks",
-            current_devices.devices[i]->radio.sta.saved_networks_count);
-        } else if (app->is_scanning && current_devices.devices[i]->scanType ==
-            SCAN_WIFI_STA && variable_item_get_current_value_index(
-              current_devices.devices[i]->view) == WendigoOptionSTAAP) {
-          /* Update displayed AP for the current device */
-          if (memcmp(current_devices.devices[i]->radio.sta.apMac, nullMac, MAC_BYTES)) {
-            /* AP has a MAC - Do we have the AP in the cache? */
-            uint16_t apIdx = device_index_from_mac(
-              current_devices.devices[i]->radio.sta.apMac);
-            if (apIdx == devices_count || devices == NULL ||
-                devices[apIdx] == NULL || devices[apIdx]->scanType !=
-                SCAN_WIFI_AP || devices[apIdx]->radio.ap.ssid[0] == '\0') {
-              /* Either we don't have the AP in the cache or we don't have an
-               * SSID for the AP - Display the MAC */
-              bytes_to_string(current_devices.devices[i]->radio.sta.apMac, MAC_BYTES,
-                optionValue);
-            } else {
-              /* We have an SSID for the AP */
-              snprintf(optionValue, sizeof(optionValue), "%s",
-                devices[apIdx]->radio.ap.ssid);
-            }
-          } else {
-            /* We don't know the AP */
-            snprintf(optionValue, sizeof(optionValue), "AP Unknown");
-          }
-        }
-        if (optionValue[0] != '\0') {
-          /* We've updated the current device's selected option */
-          variable_item_set_current_value_text(current_devices.devices[i]->view,
-                                              optionValue);
-        }
-      }
+    uint32_t now = furi_get_tick();
+    if (now - device_list_last_refresh >= furi_ms_to_ticks(DEVICE_LIST_REFRESH_MS)) {
+      device_list_last_refresh = now;
+      wendigo_flush_dirty_devices(app);
+      wendigo_device_list_view_refresh(app->devices_list_view);
     }
   }
 //  FURI_LOG_T(WENDIGO_TAG, "End wendigo_scene_device_list_on_event()");
@@ -1213,16 +1345,16 @@ bool wendigo_scene_device_list_on_event(void *context,
 void wendigo_scene_device_list_on_exit(void *context) {
   FURI_LOG_T(WENDIGO_TAG, "Start wendigo_scene_device_list_on_exit()");
   WendigoApp *app = context;
-  variable_item_list_reset(app->devices_var_item_list);
-  for (uint16_t i = 0; i < devices_count; ++i) {
-    devices[i]->view = NULL;
-  }
+  wendigo_device_list_view_reset(app->devices_list_view);
   if (app->leaving_scene) {
     /* This condition is met when we are genuinely exiting this scene - when
      * the back button has been pressed. When displaying a device list from
      * another device list, such as displaying an AP's STAs, this function is
      * called but we do not want to replace the current_devices we've just
      * constructed with the stack element we've just pushed. */
+    /* The previous device list scene uses the same view - Hold it while
+     * current_devices is replaced */
+    wendigo_device_list_view_begin_update(app->devices_list_view);
     /* Free current_devices.devices[] if necessary */
     if (current_devices.devices != NULL && current_devices.devices_count > 0) {
       if (current_devices.free_devices) {
@@ -1246,6 +1378,7 @@ void wendigo_scene_device_list_on_exit(void *context) {
       }
       --stack_counter;
     }
+    wendigo_device_list_view_end_update(app->devices_list_view, false);
     app->leaving_scene = false;
   }
   FURI_LOG_T(WENDIGO_TAG, "End wendigo_scene_device_list_on_exit()");
@@ -0,0 +1,49 @@
+#include "../wendigo_app_i.h"
+#include "../wendigo_scan.h"
+
+/** Called by wendigo_scan.c for each RSSI packet received while the Locate
+ * scene is displayed. The reading goes straight to the gauge.
+ */
+void wendigo_scene_locate_update(WendigoApp *app, wendigo_pkt_rssi *pkt) {
+    wendigo_rssi_gauge_view_update(app->rssi_gauge_view, pkt->mac, pkt->filtered, pkt->raw,
+        pkt->samples);
+}
+
+/** Scene initialisation - Tell ESP32-Wendigo which devices are tagged, in
+ * case it has restarted since they were tagged, then enable Focus Mode so it
+ * starts streaming their signal strength.
+ */
+void wendigo_scene_locate_on_enter(void *context) {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_scene_locate_on_enter()");
+    WendigoApp *app = context;
+    app->current_view = WendigoAppViewLocate;
+    wendigo_rssi_gauge_view_reset(app->rssi_gauge_view);
+
+    wendigo_uart_set_binary_cb(app->uart);
+    furi_mutex_acquire(app->devicesMutex, FuriWaitForever);
+    for (uint16_t i = 0; i < devices_count; ++i) {
+        if (devices[i] != NULL && devices[i]->tagged) {
+            wendigo_tag_device(app, devices[i]);
+        }
+    }
+    furi_mutex_release(app->devicesMutex);
+    wendigo_set_focus(app, true);
+
+    view_dispatcher_switch_to_view(app->view_dispatcher, WendigoAppViewLocate);
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_scene_locate_on_enter()");
+}
+
+/** The gauge handles its own input, so there are no events to respond to */
+bool wendigo_scene_locate_on_event(void *context, SceneManagerEvent event) {
+    FURI_LOG_T(WENDIGO_TAG, "Start+End wendigo_scene_locate_on_event()");
+    UNUSED(context);
+    UNUSED(event);
+    return false;
+}
+
+void wendigo_scene_locate_on_exit(void *context) {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_scene_locate_on_exit()");
+    WendigoApp *app = context;
+    wendigo_set_focus(app, false);
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_scene_locate_on_exit()");
+}
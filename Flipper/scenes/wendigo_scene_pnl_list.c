@@ -183,21 +183,7 @@ void wendigo_scene_pnl_list_on_exit(void *context) {
 
 void wendigo_scene_pnl_list_free() {
     FURI_LOG_T(WENDIGO_TAG, "Start wendigo_scene_pnl_list_free()");
-    if (networks_count > 0 && networks != NULL) {
-        for (uint16_t i = 0; i < networks_count; ++i) {
-            if (networks[i].device_count > 0 && networks[i].devices != NULL) {
-                /* Free networks[i].devices - a wendigo_device** - but don't
-                 * free the individual wendigo_device elements. networks[i].devices
-                 * should contain pointers to the master device cache devices[].
-                 */
-                free(networks[i].devices);
-                networks[i].devices = NULL;
-                networks[i].device_count = 0;
-            }
-        }
-        free(networks);
-    }
-    networks_count = 0;
-    networks = NULL;
+    /* Release networks[] - Its devices are owned by the device cache */
+    pnl_free_networks();
     FURI_LOG_T(WENDIGO_TAG, "End wendigo_scene_pnl_list_free()");
 }
\ No newline at end of file
@@ -1,16 +1,28 @@
 #include "../wendigo_app_i.h"
 #include "../wendigo_scan.h"
+#include "../wendigo_record.h"
 
 static const WendigoItem items[SETUP_MENU_ITEMS] = {
     {"BLE", {"On", "Off", "MAC"}, 3, LIST_DEVICES, OFF},
     {"BT Classic", {"On", "Off", "MAC"}, 3, LIST_DEVICES, OFF},
     {"WiFi", {"On", "Off", "MAC"}, 3, LIST_DEVICES, OFF},
     {"Channel", {"All", "Selected"}, 2, OPEN_SETUP, OFF},
+    /* How to choose devices to discard when memory runs low - Options are
+       indexed by PrunePolicy */
+    {"Prune BT", {"Oldest", "Weakest", "Never"}, 3, PRUNE_POLICY, OFF},
+    {"Prune AP", {"Oldest", "Weakest", "Never"}, 3, PRUNE_POLICY, OFF},
+    {"Prune STA", {"Oldest", "Weakest", "Never"}, 3, PRUNE_POLICY, OFF},
+    /* Record the UART stream to SD, and replay it at the selected speed when
+       OK is pressed - Options are indexed by ReplaySpeed */
+    {"Record UART", {"Off", "On"}, 2, RECORD_UART, OFF},
+    {"Replay UART", {"1x", "10x", "Max"}, 3, REPLAY_UART, OFF},
     // YAGNI: Remove mode_mask from the data model
 };
 
 #define CH_ALL      (0)
 #define CH_SELECTED (1)
+#define RECORD_OFF  (0)
+#define RECORD_ON   (1)
 
 static void wendigo_scene_setup_var_list_enter_callback(void *context, uint32_t index) {
     FURI_LOG_T(WENDIGO_TAG, "Start wendigo_scene_setup_var_list_enter_callback()");
@@ -31,6 +43,21 @@ static void wendigo_scene_setup_var_list_enter_callback(void *context, uint32_t
                 view_dispatcher_send_custom_event(app->view_dispatcher, Wendigo_EventSetup);
             }
             break;
+        case PRUNE_POLICY:
+        case RECORD_UART:
+            /* Nothing to open */
+            break;
+        case REPLAY_UART:
+            /* Start a replay, or stop the one that's running. The results are
+               displayed when Wendigo_EventReplayFinished arrives */
+            if (wendigo_replay_is_running()) {
+                wendigo_replay_stop(app);
+            } else if (wendigo_record_is_recording()) {
+                wendigo_display_popup(app, "Replay UART", "Stop recording before replaying.");
+            } else if (!wendigo_replay_start(app, selected_option_index)) {
+                wendigo_display_popup(app, "Replay UART", "Unable to start replay.");
+            }
+            break;
         default:
             /* Note: Additional check required here if additional menu items are added with 3 or more options.
              *  At the moment we can assume that if selected option is RADIO_MAC we're displaying a MAC,
@@ -99,6 +126,24 @@ static void wendigo_scene_setup_var_list_change_callback(VariableItem *item) {
                     break;
             }
             break;
+        case PRUNE_POLICY:
+            app->prune_policy[app->setup_selected_menu_index - SETUP_PRUNE_BT_IDX] = item_index;
+            break;
+        case RECORD_UART:
+            if (item_index == RECORD_OFF) {
+                wendigo_record_stop(app);
+            } else if (!wendigo_record_start(app)) {
+                /* Display the real state of the recorder */
+                app->setup_selected_option_index[app->setup_selected_menu_index] = RECORD_OFF;
+                variable_item_set_current_value_index(item, RECORD_OFF);
+                variable_item_set_current_value_text(item, menu_item->options_menu[RECORD_OFF]);
+                wendigo_display_popup(app, "Record UART", (wendigo_replay_is_running()) ?
+                    "Stop the replay before recording." : "Unable to start recording.");
+            }
+            break;
+        case REPLAY_UART:
+            /* The speed is used when OK is pressed */
+            break;
         case LIST_DEVICES:
             /* An interface is selected. Determine which one */
             if (!strncmp(menu_item->item_string, "BLE", 3)) {
@@ -142,13 +187,17 @@ void wendigo_scene_setup_on_enter(void *context) {
 
     variable_item_list_reset(app->var_item_list);
     variable_item_list_set_header(app->var_item_list, NULL);
+    /* Recording stops by itself if writing to the SD card fails */
+    app->setup_selected_option_index[SETUP_RECORD_IDX] =
+        (wendigo_record_is_recording()) ? RECORD_ON : RECORD_OFF;
     VariableItem *item;
     for (uint8_t i = 0; i < SETUP_MENU_ITEMS; ++i) {
         item = variable_item_list_add(app->var_item_list, items[i].item_string,
             items[i].num_options_menu,
             wendigo_scene_setup_var_list_change_callback, app);
         /* We don't want "MAC" to be displayed on launching the view, the interface should be "on" or "off" */
-        if (app->setup_selected_option_index[i] == RADIO_MAC) {
+        if (items[i].action == LIST_DEVICES &&
+                app->setup_selected_option_index[i] == RADIO_MAC) {
             InterfaceType if_type = IF_COUNT;
             if (!strncmp(items[i].item_string, "BLE", 3)) {
                 if_type = IF_BLE;
@@ -197,6 +246,10 @@ bool wendigo_scene_setup_on_event(void *context, SceneManagerEvent event) {
             scene_manager_set_scene_state(app->scene_manager, WendigoSceneSetup,
                                             app->setup_selected_menu_index);
             scene_manager_next_scene(app->scene_manager, WendigoSceneSetupMAC);
+        } else if (event.event == Wendigo_EventReplayFinished) {
+            char result[80];
+            wendigo_replay_describe_result(result, sizeof(result));
+            wendigo_display_popup(app, "Replay Finished", result);
         }
         consumed = true;
     } else if (event.type == SceneManagerEventTypeTick) {
@@ -15,6 +15,7 @@ static const WendigoItem items[START_MENU_ITEMS] = {
         "WiFi STA"}, 7, LIST_DEVICES, BOTH_MODES},
     {"Selected Devices", {"All", "Bluetooth", "WiFi", "BT Classic", "BLE",
         "WiFi AP", "WiFi STA"}, 7, LIST_SELECTED_DEVICES, BOTH_MODES},
+    {"Locate", {""}, 1, LOCATE_DEVICES, TEXT_MODE},
     {"Probed SSIDs", {""}, 1, PNL_LIST, TEXT_MODE},
     {"UART Terminal", {""}, 1, UART_TERMINAL, TEXT_MODE},
     {"Help", {"About", "Version"}, 2, OPEN_HELP, TEXT_MODE},
@@ -22,7 +23,7 @@ static const WendigoItem items[START_MENU_ITEMS] = {
 
 #define SETUP_IDX       (0)
 #define SCAN_IDX        (1)
-#define PNL_IDX         (4)
+#define PNL_IDX         (5)
 #define SCAN_WIFI_IDX   (0)
 #define SCAN_BT_IDX     (1)
 #define SCAN_STATUS_IDX (2)
@@ -168,6 +169,11 @@ static void wendigo_scene_start_var_list_enter_callback(void *context, uint32_t
             FURI_LOG_T(WENDIGO_TAG,
                 "End wendigo_scene_start_var_list_enter_callback(): Displaying selected device lists.");
             return;
+        case LOCATE_DEVICES:
+            view_dispatcher_send_custom_event(app->view_dispatcher, Wendigo_EventLocate);
+            FURI_LOG_T(WENDIGO_TAG,
+                "End wendigo_scene_start_var_list_enter_callback(): Displaying RSSI gauge.");
+            return;
         case UART_TERMINAL:
             view_dispatcher_send_custom_event(app->view_dispatcher, Wendigo_EventStartConsole);
             FURI_LOG_T(WENDIGO_TAG,
@@ -392,6 +398,12 @@ bool wendigo_scene_start_on_event(void *context, SceneManagerEvent event) {
                 scene_manager_next_scene(app->scene_manager,
                                         WendigoScenePNLList);
                 break;
+            case Wendigo_EventLocate:
+                scene_manager_set_scene_state(app->scene_manager,
+                    WendigoSceneStart, app->selected_menu_index);
+                scene_manager_next_scene(app->scene_manager,
+                                        WendigoSceneLocate);
+                break;
             case Wendigo_EventRefreshPNLCount:
                 if (app->current_view == WendigoAppViewVarItemList) {
                     wendigo_display_pnl_count(app);
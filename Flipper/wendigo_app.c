@@ -1,5 +1,6 @@
 #include "wendigo_app_i.h"
 #include "wendigo_scan.h"
+#include "wendigo_record.h"
 
 #include <furi.h>
 #include <furi_hal.h>
@@ -210,6 +211,10 @@ WendigoApp *wendigo_app_alloc() {
     for (uint8_t i = 0; i < SETUP_MENU_ITEMS; ++i) {
         app->setup_selected_option_index[i] = 0;
     }
+    for (uint8_t i = 0; i < PRUNE_TYPE_COUNT; ++i) {
+        app->prune_policy[i] = PRUNE_OLDEST;
+    }
+    app->devices_pruned = 0;
 
     /* Initialise the channel bitmasks - pow() is slow so hardcode 0 & 1 and use multiplication for the rest */
     app->CH_MASK[0] = 0;
@@ -265,9 +270,14 @@ WendigoApp *wendigo_app_alloc() {
         app->view_dispatcher, WendigoAppViewPopup, popup_get_view(app->popup));
     
     /* Device list (all and tagged) */
-    app->devices_var_item_list = variable_item_list_alloc();
+    app->devices_list_view = wendigo_device_list_view_alloc();
     view_dispatcher_add_view(app->view_dispatcher, WendigoAppViewDeviceList,
-        variable_item_list_get_view(app->devices_var_item_list));
+        wendigo_device_list_view_get_view(app->devices_list_view));
+
+    /* Focus Mode RSSI gauge */
+    app->rssi_gauge_view = wendigo_rssi_gauge_view_alloc();
+    view_dispatcher_add_view(app->view_dispatcher, WendigoAppViewLocate,
+        wendigo_rssi_gauge_view_get_view(app->rssi_gauge_view));
     
     /* Initialise the DeviceListInstance struct used in device list */
     wendigo_scene_device_list_init(NULL);
@@ -275,6 +285,7 @@ WendigoApp *wendigo_app_alloc() {
     
     /* Initialise the last packet received time */
     app->last_packet = furi_hal_rtc_get_timestamp();
+    app->packets_parsed = 0;
 
     scene_manager_next_scene(app->scene_manager, WendigoSceneStart);
 
@@ -288,6 +299,8 @@ void wendigo_app_free(WendigoApp *app) {
 
     furi_timer_stop(app->scan_timer);
     furi_timer_free(app->scan_timer);
+    /* Stop recording or replaying the UART - The replay thread uses the view dispatcher */
+    wendigo_record_free(app);
 
     // Views
     view_dispatcher_remove_view(app->view_dispatcher, WendigoAppViewVarItemList);
@@ -298,6 +311,7 @@ void wendigo_app_free(WendigoApp *app) {
     view_dispatcher_remove_view(app->view_dispatcher, WendigoAppViewSetupMAC);
     view_dispatcher_remove_view(app->view_dispatcher, WendigoAppViewPopup);
     view_dispatcher_remove_view(app->view_dispatcher, WendigoAppViewDeviceList);
+    view_dispatcher_remove_view(app->view_dispatcher, WendigoAppViewLocate);
 
     variable_item_list_free(app->var_item_list);
     widget_free(app->widget);
@@ -307,7 +321,8 @@ void wendigo_app_free(WendigoApp *app) {
     wendigo_hex_input_free(app->hex_input);
     byte_input_free(app->setup_mac);
     popup_free(app->popup);
-    variable_item_list_free(app->devices_var_item_list);
+    wendigo_device_list_view_free(app->devices_list_view);
+    wendigo_rssi_gauge_view_free(app->rssi_gauge_view);
 
     // View dispatcher
     view_dispatcher_free(app->view_dispatcher);
@@ -361,7 +376,9 @@ int32_t wendigo_app(void *p) {
 
 void wendigo_uart_set_binary_cb(Wendigo_Uart *uart) {
     FURI_LOG_T(WENDIGO_TAG, "Start wendigo_uart_set_binary_cb()");
-    wendigo_uart_set_handle_rx_data_cb(uart, wendigo_scan_handle_rx_data_cb);
+    /* The recorder sits between the UART and the parser while recording or replaying */
+    wendigo_uart_set_handle_rx_data_cb(uart, wendigo_record_is_active() ?
+        wendigo_record_rx_data_cb : wendigo_scan_handle_rx_data_cb);
     FURI_LOG_T(WENDIGO_TAG, "End wendigo_uart_set_binary_cb()");
 }
 
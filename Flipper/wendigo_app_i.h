@@ -18,6 +18,8 @@
 #include <sys/time.h>
 
 #include "wendigo_hex_input.h"
+#include "wendigo_device_list_view.h"
+#include "wendigo_rssi_gauge_view.h"
 
 #define IS_FLIPPER_APP           (1)
 /* TODO: Find a way to extract fap_version from application.fam */
@@ -29,8 +31,8 @@
 /* How frequently should Flipper poll ESP32 when scanning to restart
    scanning in the event the device restarts (seconds)? */
 #define ESP32_POLL_INTERVAL      (3)
-#define START_MENU_ITEMS         (7)
-#define SETUP_MENU_ITEMS         (4)
+#define START_MENU_ITEMS         (8)
+#define SETUP_MENU_ITEMS         (9)
 #define SETUP_CHANNEL_MENU_ITEMS (14)
 
 #define SETUP_RADIO_WIFI_IDX (2)
@@ -39,10 +41,13 @@
 #define RADIO_ON             (0)
 #define RADIO_OFF            (1)
 #define RADIO_MAC            (2)
+#define SETUP_PRUNE_BT_IDX   (4)
+#define SETUP_RECORD_IDX     (7)
+#define SETUP_REPLAY_IDX     (8)
 
 #define CH_MASK_ALL (16384)
 
-#define MAX_OPTIONS (7)
+#define MAX_OPTIONS (8)
 
 #define WENDIGO_TEXT_BOX_STORE_SIZE   (4096)
 #define WENDIGO_TEXT_INPUT_STORE_SIZE (512)
@@ -57,7 +62,11 @@ typedef enum {
     PNL_LIST,
     UART_TERMINAL,
     OPEN_MAC,
-    OPEN_HELP
+    OPEN_HELP,
+    PRUNE_POLICY,
+    RECORD_UART,
+    REPLAY_UART,
+    LOCATE_DEVICES
 } ActionType;
 
 // Command availability in different modes
@@ -76,6 +85,23 @@ typedef enum {
     IF_COUNT = 3
 } InterfaceType;
 
+/* Device types that can be pruned from the device cache under memory pressure,
+   in the same order as the "Prune" items in the setup menu */
+typedef enum {
+    PRUNE_BT = 0,
+    PRUNE_AP = 1,
+    PRUNE_STA = 2,
+    PRUNE_TYPE_COUNT = 3
+} PruneType;
+
+/* How devices of each PruneType are chosen for pruning. Values match the
+   options of the "Prune" setup menu items */
+typedef enum {
+    PRUNE_OLDEST = 0,   /* Least recently seen first */
+    PRUNE_WEAKEST = 1,  /* Lowest RSSI first */
+    PRUNE_NEVER = 2
+} PrunePolicy;
+
 /* Interface struct to encapsulate MAC and radio state */
 typedef struct {
     uint8_t mac_bytes[MAC_BYTES];
@@ -120,6 +146,7 @@ typedef enum {
     WendigoAppViewSetupChannel,
     WendigoAppViewLoading,
     WendigoAppViewPopup,
+    WendigoAppViewLocate,
 } WendigoAppView;
 
 /* The Device List scene can be nested any number of times (well, until the
@@ -148,7 +175,8 @@ struct WendigoApp {
                          */
     Widget *widget;
     VariableItemList *var_item_list;
-    VariableItemList *devices_var_item_list;
+    Wendigo_DeviceListView *devices_list_view;
+    Wendigo_RssiGaugeView *rssi_gauge_view;
     VariableItemList *detail_var_item_list;
     Wendigo_Uart *uart;
     ByteInput *setup_mac;
@@ -156,10 +184,13 @@ struct WendigoApp {
     WendigoRadio interfaces[IF_COUNT];
     InterfaceType active_interface;
     uint32_t last_packet;
+    uint32_t packets_parsed; /* Used to measure parser throughput */
 
     uint8_t setup_selected_menu_index;
     uint16_t device_list_selected_menu_index;
     uint8_t setup_selected_option_index[SETUP_MENU_ITEMS];
+    PrunePolicy prune_policy[PRUNE_TYPE_COUNT];
+    uint16_t devices_pruned;
     uint8_t selected_menu_index;
     uint8_t selected_option_index[START_MENU_ITEMS];
     uint16_t channel_mask;
@@ -1,5 +1,7 @@
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 #include <sys/time.h>
 
 /* We can determine whether it's the ESP32 app by checking for an ESP-IDF target device */
@@ -13,16 +15,18 @@
 
 #include "wendigo_common_defs.h"
 
-/* Packet identifiers */
-uint8_t PREAMBLE_LEN	    = 4;
-uint8_t PREAMBLE_BT_BLE[]   = {0xFF, 0xFE, 0xFD, 0xFC};
-uint8_t PREAMBLE_WIFI_AP[]  = {0x99, 0x98, 0x97, 0x96};
-uint8_t PREAMBLE_WIFI_STA[] = {0x88, 0x87, 0x86, 0x85};
-uint8_t PREAMBLE_CHANNELS[] = {0x77, 0x76, 0x75, 0x74};
-uint8_t PREAMBLE_STATUS[]   = {0x66, 0x65, 0x64, 0x63};
-uint8_t PREAMBLE_VER[]      = {'W', 'e', 'n', 'd'};
-uint8_t PREAMBLE_MAC[]      = {0x55, 0x54, 0x53, 0x52};
-uint8_t PACKET_TERM[]       = {0xAA, 0xBB, 0xCC, 0xDD};
+/* Packet identifiers - Defined in protocol/wendigo_packets.schema */
+uint8_t PREAMBLE_LEN	    = WENDIGO_PKT_PREAMBLE_LEN;
+uint8_t PREAMBLE_BT_BLE[]   = WENDIGO_PREAMBLE_BT_BLE_INIT;
+uint8_t PREAMBLE_WIFI_AP[]  = WENDIGO_PREAMBLE_WIFI_AP_INIT;
+uint8_t PREAMBLE_WIFI_STA[] = WENDIGO_PREAMBLE_WIFI_STA_INIT;
+uint8_t PREAMBLE_CHANNELS[] = WENDIGO_PREAMBLE_CHANNELS_INIT;
+uint8_t PREAMBLE_STATUS[]   = WENDIGO_PREAMBLE_STATUS_INIT;
+uint8_t PREAMBLE_VER[]      = WENDIGO_PREAMBLE_VER_INIT;
+uint8_t PREAMBLE_MAC[]      = WENDIGO_PREAMBLE_MAC_INIT;
+uint8_t PREAMBLE_BT_SVC[]   = WENDIGO_PREAMBLE_BT_SVC_INIT;
+uint8_t PREAMBLE_RSSI[]     = WENDIGO_PREAMBLE_RSSI_INIT;
+uint8_t PACKET_TERM[]       = WENDIGO_PKT_TERMINATOR_INIT;
 
 uint8_t nullMac[]           = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
 uint8_t broadcastMac[]	    = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
@@ -35,4 +39,230 @@ const uint8_t SCAN_WIFI_STA     = 3;
 const uint8_t SCAN_INTERACTIVE  = 4;
 const uint8_t SCAN_TAG          = 5;
 const uint8_t SCAN_FOCUS        = 6;
-const uint8_t SCAN_COUNT        = 7;
\ No newline at end of file
+const uint8_t SCAN_COUNT        = 7;
+/* Class of Device tables, from the Bluetooth Assigned Numbers (section 2.8).
+   Brief names fit in WENDIGO_COD_SHORT_MAX_LEN for Flipper-Wendigo's device
+   list; the long major class names are displayed by Interactive Mode */
+#define COD_MINOR_MASK          (0x3F)
+#define COD_MINOR_SHIFT         (2)
+#define COD_MAJOR_MASK          (0x1F)
+#define COD_MAJOR_SHIFT         (8)
+#define COD_MAJOR_UNCATEGORISED (0x1F)
+
+static const char *const cod_major_names[WENDIGO_COD_MAJOR_COUNT] = {
+    "Miscellaneous",
+    "Computer",
+    "Phone (cellular, cordless, pay phone, modem)",
+    "LAN, Network Access Point",
+    "Audio/Video (headset, speaker, stereo, video display, VCR)",
+    "Peripheral (mouse, joystick, keyboard)",
+    "Imaging (printer, scanner, camera, display)",
+    "Wearable",
+    "Toy",
+    "Health",
+    "Uncategorised: Device not specified",
+    "ERROR: Invalid Major Device Type",
+};
+
+static const char *const cod_major_brief_names[WENDIGO_COD_MAJOR_COUNT] = {
+    "Misc.", "PC", "Phone", "LAN", "A/V", "Peripheral", "Imaging", "Wearable", "Toy",
+    "Health", "Uncat.", "Invalid",
+};
+
+/* Minor classes that are an enumeration, indexed by the minor class bits.
+   NULL where the minor class is uncategorised or reserved */
+static const char *const cod_minor_computer[] = {
+    NULL, "Desktop", "Server", "Laptop", "Handheld PC", "Palm PC", "Wearable PC", "Tablet",
+};
+static const char *const cod_minor_phone[] = {
+    NULL, "Cellular", "Cordless", "Smartphone", "Modem", "ISDN",
+};
+static const char *const cod_minor_av[] = {
+    NULL, "Headset", "Hands-free", NULL, "Microphone", "Loudspeaker", "Headphones",
+    "Portable A/V", "Car audio", "Set-top box", "HiFi audio", "VCR", "Video camera",
+    "Camcorder", "Monitor", "Display", "Video conf.", NULL, "Gaming toy",
+};
+static const char *const cod_minor_wearable[] = {
+    NULL, "Wristwatch", "Pager", "Jacket", "Helmet", "Glasses", "Pin",
+};
+static const char *const cod_minor_toy[] = {
+    NULL, "Robot", "Vehicle", "Doll", "Controller", "Game",
+};
+static const char *const cod_minor_health[] = {
+    NULL, "BP monitor", "Thermometer", "Scale", "Glucose", "Pulse oxim.", "Heart rate",
+    "Health disp.", "Step counter", "Body comp.", "Peak flow", "Medication", "Knee prosth.",
+    "Ankle prosth", "Health mgr.", "Mobility",
+};
+/* Peripheral minor classes are a keyboard/pointer field (bits 4-5) and a type (bits 0-3) */
+static const char *const cod_minor_peripheral_kind[] = {
+    NULL, "Keyboard", "Pointer", "Kbd+Pointer",
+};
+static const char *const cod_minor_peripheral_type[] = {
+    NULL, "Joystick", "Gamepad", "Remote", "Sensor", "Digitiser", "Card reader", "Digital pen",
+    "Scanner", "Gesture",
+};
+/* Imaging minor classes are a bitmask (bits 2-5) - The highest bit set is displayed */
+static const char *const cod_minor_imaging[] = {
+    "Display", "Camera", "Scanner", "Printer",
+};
+
+typedef struct {
+    const char *const *names;
+    uint8_t count;
+} cod_minor_table;
+
+#define COD_MINOR_TABLE(names) {names, sizeof(names) / sizeof(names[0])}
+
+static const cod_minor_table cod_minor_tables[WENDIGO_COD_MAJOR_COUNT] = {
+    [WENDIGO_COD_MAJOR_COMPUTER] = COD_MINOR_TABLE(cod_minor_computer),
+    [WENDIGO_COD_MAJOR_PHONE]    = COD_MINOR_TABLE(cod_minor_phone),
+    [WENDIGO_COD_MAJOR_AV]       = COD_MINOR_TABLE(cod_minor_av),
+    [WENDIGO_COD_MAJOR_WEARABLE] = COD_MINOR_TABLE(cod_minor_wearable),
+    [WENDIGO_COD_MAJOR_TOY]      = COD_MINOR_TABLE(cod_minor_toy),
+    [WENDIGO_COD_MAJOR_HEALTH]   = COD_MINOR_TABLE(cod_minor_health),
+};
+
+/** Decode the major device class of `cod` into a WendigoCodMajor */
+uint8_t wendigo_cod_major(uint32_t cod) {
+    uint8_t major = (cod >> COD_MAJOR_SHIFT) & COD_MAJOR_MASK;
+    if (major == COD_MAJOR_UNCATEGORISED) {
+        return WENDIGO_COD_MAJOR_UNCATEGORISED;
+    }
+    return (major < WENDIGO_COD_MAJOR_UNCATEGORISED) ? major : WENDIGO_COD_MAJOR_INVALID;
+}
+
+/** Decode the minor device class bits of `cod`. Their meaning depends on the major class */
+uint8_t wendigo_cod_minor(uint32_t cod) {
+    return (cod >> COD_MINOR_SHIFT) & COD_MINOR_MASK;
+}
+
+/** Name of major device class `major` (a WendigoCodMajor). `brief` selects a
+ * name no longer than WENDIGO_COD_SHORT_MAX_LEN.
+ */
+const char *wendigo_cod_major_str(uint8_t major, bool brief) {
+    if (major >= WENDIGO_COD_MAJOR_COUNT) {
+        major = WENDIGO_COD_MAJOR_INVALID;
+    }
+    return (brief) ? cod_major_brief_names[major] : cod_major_names[major];
+}
+
+/** Name of minor device class `minor` within major class `major`, or NULL if
+ * it's uncategorised, reserved or the major class has no minor classes.
+ */
+const char *wendigo_cod_minor_str(uint8_t major, uint8_t minor) {
+    minor &= COD_MINOR_MASK;
+    if (major == WENDIGO_COD_MAJOR_PERIPHERAL) {
+        const char *kind = cod_minor_peripheral_kind[minor >> 4];
+        uint8_t type = minor & 0x0F;
+        if (kind != NULL) {
+            return kind;
+        }
+        return (type < sizeof(cod_minor_peripheral_type) / sizeof(cod_minor_peripheral_type[0])) ?
+            cod_minor_peripheral_type[type] : NULL;
+    }
+    if (major == WENDIGO_COD_MAJOR_IMAGING) {
+        for (int8_t bit = 3; bit >= 0; --bit) {
+            if (minor & (1 << (bit + 2))) {
+                return cod_minor_imaging[bit];
+            }
+        }
+        return NULL;
+    }
+    if (major >= WENDIGO_COD_MAJOR_COUNT || cod_minor_tables[major].names == NULL ||
+            minor >= cod_minor_tables[major].count) {
+        return NULL;
+    }
+    return cod_minor_tables[major].names[minor];
+}
+
+/** Build the description of a device class in `str`, which can hold `len` bytes.
+ * Brief descriptions are the minor class if it's known, otherwise the major
+ * class, and fit in WENDIGO_COD_SHORT_MAX_LEN. Otherwise the major class is
+ * described in full, followed by the minor class if there's room, and fits in
+ * WENDIGO_COD_MAX_LEN. Returns `str`.
+ */
+char *wendigo_cod_to_str(uint8_t major, uint8_t minor, bool brief, char *str, uint8_t len) {
+    if (str == NULL || len == 0) {
+        return str;
+    }
+    const char *minor_str = wendigo_cod_minor_str(major, minor);
+    if (brief) {
+        snprintf(str, len, "%s", (minor_str != NULL) ? minor_str : wendigo_cod_major_str(major, true));
+    } else if (minor_str == NULL) {
+        snprintf(str, len, "%s", wendigo_cod_major_str(major, false));
+    } else {
+        const char *major_str = wendigo_cod_major_str(major, false);
+        /* Fall back to the brief major class if the full one leaves no room */
+        if (strlen(major_str) + 2 + strlen(minor_str) >= len) {
+            major_str = wendigo_cod_major_str(major, true);
+        }
+        snprintf(str, len, "%s: %s", major_str, minor_str);
+    }
+    return str;
+}
+
+static const char *gatt_results[WENDIGO_GATT_RESULT_COUNT] = {
+    "Complete", "Timed out", "Failed", "Not connectable"
+};
+
+/** Describe a WendigoGattResult */
+const char *wendigo_gatt_result_str(uint8_t result) {
+    return (result < WENDIGO_GATT_RESULT_COUNT) ? gatt_results[result] : "Unknown";
+}
+
+/** Write `count` service UUIDs into `buf`, which can hold `buf_len` bytes, as
+ * the bt_services packet carries them: Each UUID's length (2, 4 or 16) and
+ * then its bytes, little-endian. UUIDs that don't fit are left out.
+ * Returns the number of bytes written.
+ */
+uint16_t wendigo_svc_uuids_pack(const esp_bt_uuid_t *uuids, uint8_t count, uint8_t *buf, uint16_t buf_len) {
+    uint16_t offset = 0;
+    for (uint8_t i = 0; i < count; ++i) {
+        uint8_t len = (uint8_t)uuids[i].len;
+        if ((len != ESP_UUID_LEN_16 && len != ESP_UUID_LEN_32 && len != ESP_UUID_LEN_128) ||
+                offset + 1 + len > buf_len) {
+            continue;
+        }
+        buf[offset++] = len;
+        if (len == ESP_UUID_LEN_16) {
+            buf[offset] = (uint8_t)(uuids[i].uuid.uuid16 & 0xFF);
+            buf[offset + 1] = (uint8_t)(uuids[i].uuid.uuid16 >> 8);
+        } else if (len == ESP_UUID_LEN_32) {
+            for (uint8_t b = 0; b < ESP_UUID_LEN_32; ++b) {
+                buf[offset + b] = (uint8_t)(uuids[i].uuid.uuid32 >> (8 * b));
+            }
+        } else {
+            memcpy(buf + offset, uuids[i].uuid.uuid128, ESP_UUID_LEN_128);
+        }
+        offset += len;
+    }
+    return offset;
+}
+
+/** Read the UUIDs written by wendigo_svc_uuids_pack() from `buf` into `uuids`,
+ * which can hold `max`. Stops at anything malformed. Returns the number read.
+ */
+uint8_t wendigo_svc_uuids_unpack(const uint8_t *buf, uint16_t len, esp_bt_uuid_t *uuids, uint8_t max) {
+    uint8_t count = 0;
+    uint16_t offset = 0;
+    while (count < max && offset < len) {
+        uint8_t uuid_len = buf[offset++];
+        if ((uuid_len != ESP_UUID_LEN_16 && uuid_len != ESP_UUID_LEN_32 && uuid_len != ESP_UUID_LEN_128) ||
+                offset + uuid_len > len) {
+            break;
+        }
+        memset(&(uuids[count]), 0, sizeof(esp_bt_uuid_t));
+        uuids[count].len = uuid_len;
+        if (uuid_len == ESP_UUID_LEN_16) {
+            uuids[count].uuid.uuid16 = (uint16_t)(buf[offset] | (buf[offset + 1] << 8));
+        } else if (uuid_len == ESP_UUID_LEN_32) {
+            uuids[count].uuid.uuid32 = (uint32_t)buf[offset] | ((uint32_t)buf[offset + 1] << 8) |
+                ((uint32_t)buf[offset + 2] << 16) | ((uint32_t)buf[offset + 3] << 24);
+        } else {
+            memcpy(uuids[count].uuid.uuid128, buf + offset, ESP_UUID_LEN_128);
+        }
+        offset += uuid_len;
+        ++count;
+    }
+    return count;
+}
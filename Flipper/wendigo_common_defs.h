@@ -8,55 +8,13 @@
  * their members.
  * This means that a wendigo_bt_device can't be reliably sent and reconstructed
  * as a whole. So instead we'll pull the individual attributes out of the buffer
- * based on their offsets. This file defines their offsets into a packet, with
- * offset 0 representing the first byte of the packet preamble.
- * 
+ * based on their offsets. Packet layouts are defined in
+ * protocol/wendigo_packets.schema, which generates wendigo_packets.h - the
+ * offsets (WENDIGO_OFFSET_*, with offset 0 representing the first byte of the
+ * packet preamble) and the encoders and decoders used by both ESP32-Wendigo
+ * and Flipper-Wendigo.
  */
- #define WENDIGO_OFFSET_BT_BDNAME_LEN           (4)
- #define WENDIGO_OFFSET_BT_EIR_LEN              (5)
- #define WENDIGO_OFFSET_BT_RSSI                 (6)
- #define WENDIGO_OFFSET_BT_COD                  (8)
- #define WENDIGO_OFFSET_BT_BDA                  (12)
- #define WENDIGO_OFFSET_BT_SCANTYPE             (18)
- #define WENDIGO_OFFSET_BT_TAGGED               (19)
- #define WENDIGO_OFFSET_BT_LASTSEEN             (20)
- #define WENDIGO_OFFSET_BT_NUM_SERVICES         (39)
- #define WENDIGO_OFFSET_BT_KNOWN_SERVICES_LEN   (40)
- #define WENDIGO_OFFSET_BT_COD_LEN              (41)
- #define WENDIGO_OFFSET_BT_BDNAME               (42)
- /* bdname is bdname_len bytes, followed by eir_len bytes of EIR and cod_len bytes of CoD */
-
- /* Initial elements of AP and STA packets are common so are just defined once */
- #define WENDIGO_OFFSET_WIFI_SCANTYPE           (4)
- #define WENDIGO_OFFSET_WIFI_MAC                (5)
- #define WENDIGO_OFFSET_WIFI_CHANNEL            (11)
- #define WENDIGO_OFFSET_WIFI_RSSI               (12)
- #define WENDIGO_OFFSET_WIFI_LASTSEEN           (14)
- #define WENDIGO_OFFSET_WIFI_TAGGED             (33)
- /* Unique elements */
- #define WENDIGO_OFFSET_STA_PNL_COUNT           (34)
- #define WENDIGO_OFFSET_STA_AP_MAC              (35)
- #define WENDIGO_OFFSET_STA_AP_SSID_LEN         (41)
- #define WENDIGO_OFFSET_STA_AP_SSID             (42)
- /* SSID is SSID_Len bytes, followed by WENDIGO_OFFSET_STA_PNL_COUNT sets of SSIDs,
-    where each SSID is 1 byte for SSID length followed by that number of bytes for
-    the SSID. Finally, this is followed by the packet terminator which is
-    PREAMBLE_LEN == 4 bytes */
- #define WENDIGO_OFFSET_AP_AUTH_MODE            (34)
- #define WENDIGO_OFFSET_AP_SSID_LEN             (35)
- #define WENDIGO_OFFSET_AP_STA_COUNT            (36)
- #define WENDIGO_OFFSET_AP_SSID                 (37)
- /* SSID is SSID_Len bytes. Each station is a 6-byte MAC. There are STA_COUNT stations. */
-
- #define WENDIGO_OFFSET_CHANNEL_COUNT           (4)
- #define WENDIGO_OFFSET_CHANNELS                (5)
-
- #define WENDIGO_OFFSET_MAC_IF_COUNT            (4)
- #define WENDIGO_OFFSET_MAC_BT_TYPE             (5)
- #define WENDIGO_OFFSET_MAC_BT_MAC              (6)
- #define WENDIGO_OFFSET_MAC_WIFI_TYPE           (12)
- #define WENDIGO_OFFSET_MAC_WIFI_MAC            (13)
- #define WENDIGO_OFFSET_MAC_TERMINATOR          (19)
+#include "wendigo_packets.h"
 
  #ifdef IS_FLIPPER_APP
     typedef enum {
@@ -85,6 +43,19 @@
     } wifi_auth_mode_t;
 
     #define WENDIGO_TAG     "WENDIGO"
+
+    /* ESP-IDF's Bluetooth UUID, for services received from ESP32-Wendigo */
+    #define ESP_UUID_LEN_16     (2)
+    #define ESP_UUID_LEN_32     (4)
+    #define ESP_UUID_LEN_128    (16)
+    typedef struct {
+        uint16_t len;
+        union {
+            uint16_t uuid16;
+            uint32_t uuid32;
+            uint8_t uuid128[ESP_UUID_LEN_128];
+        } uuid;
+    } __attribute__((packed)) esp_bt_uuid_t;
 #endif
 
 /* A warning about this being defined in ESP-IDF appeared out of nowhere */
@@ -136,27 +107,58 @@ typedef enum {
     WENDIGO_MACS_COUNT
 } WendigoMAC;
 
+/** Major device classes from a Bluetooth Class of Device (bits 8-12). Values
+ * are indices into the CoD tables in wendigo_common_defs.c, not the CoD's own
+ * major class bits - Uncategorised is 0x1F in a CoD.
+ */
+typedef enum {
+    WENDIGO_COD_MAJOR_MISC = 0,
+    WENDIGO_COD_MAJOR_COMPUTER,
+    WENDIGO_COD_MAJOR_PHONE,
+    WENDIGO_COD_MAJOR_LAN_NAP,
+    WENDIGO_COD_MAJOR_AV,
+    WENDIGO_COD_MAJOR_PERIPHERAL,
+    WENDIGO_COD_MAJOR_IMAGING,
+    WENDIGO_COD_MAJOR_WEARABLE,
+    WENDIGO_COD_MAJOR_TOY,
+    WENDIGO_COD_MAJOR_HEALTH,
+    WENDIGO_COD_MAJOR_UNCATEGORISED,
+    WENDIGO_COD_MAJOR_INVALID,
+    WENDIGO_COD_MAJOR_COUNT
+} WendigoCodMajor;
+
+/* Longest string wendigo_cod_to_str() builds, including the NULL terminator */
+#define WENDIGO_COD_MAX_LEN         (59)
+#define WENDIGO_COD_SHORT_MAX_LEN   (13)
+
+/* ESP32-Wendigo's tables of these are generated into flash by esp32/generate_uuids.py */
 typedef struct {
     uint16_t uuid16;
-    char name[40];
+    const char *name;
 } bt_uuid;
 
+/** Outcome of GATT service discovery on a BLE device, sent in the bt_services packet */
+typedef enum {
+    WENDIGO_GATT_COMPLETE = 0,
+    WENDIGO_GATT_TIMEOUT,
+    WENDIGO_GATT_FAILED,            /* Couldn't connect, or the connection dropped */
+    WENDIGO_GATT_NOT_CONNECTABLE,   /* The device only sends non-connectable advertisements */
+    WENDIGO_GATT_RESULT_COUNT
+} WendigoGattResult;
+
 typedef struct {
     uint8_t num_services;
-    #ifdef IS_FLIPPER_APP
-        void *service_uuids;        // Was esp_bt_uuid_t
-    #else
-        esp_bt_uuid_t *service_uuids;
-    #endif
-    bt_uuid **known_services;
+    esp_bt_uuid_t *service_uuids;
+    const bt_uuid **known_services;
     uint8_t known_services_len;
 } wendigo_bt_svc;
 
 typedef struct {
     uint8_t bdname_len;
     uint8_t eir_len;
+    uint8_t cod_major;  // WendigoCodMajor, decoded from cod by wendigo_cod_major()
+    uint8_t cod_minor;  // Minor class bits, decoded from cod by wendigo_cod_minor()
     uint32_t cod;
-    char *cod_str;
     uint8_t *eir;   // Consider inline - [ESP_BT_GAP_EIR_DATA_LEN]
     char *bdname;   // Consider inline - [ESP_BT_GAP_MAX_BDNAME_LEN + 1]
     wendigo_bt_svc bt_services;
@@ -195,7 +197,8 @@ typedef struct wendigo_device {
     bool tagged;
     #ifdef IS_FLIPPER_APP
         uint32_t lastSeen;
-        VariableItem *view;
+        uint8_t view_option;    /* Option displayed in the device list */
+        uint16_t view_index;    /* Position in the device list - A hint, verify before use */
     #else
         struct timeval lastSeen;
     #endif
@@ -214,8 +217,19 @@ extern uint8_t PREAMBLE_CHANNELS[];
 extern uint8_t PREAMBLE_STATUS[];
 extern uint8_t PREAMBLE_VER[];
 extern uint8_t PREAMBLE_MAC[];
+extern uint8_t PREAMBLE_BT_SVC[];
+extern uint8_t PREAMBLE_RSSI[];
 extern uint8_t PACKET_TERM[];
 extern uint8_t nullMac[];
 extern uint8_t broadcastMac[];
 
+uint8_t wendigo_cod_major(uint32_t cod);
+uint8_t wendigo_cod_minor(uint32_t cod);
+const char *wendigo_cod_major_str(uint8_t major, bool brief);
+const char *wendigo_cod_minor_str(uint8_t major, uint8_t minor);
+char *wendigo_cod_to_str(uint8_t major, uint8_t minor, bool brief, char *str, uint8_t len);
+const char *wendigo_gatt_result_str(uint8_t result);
+uint16_t wendigo_svc_uuids_pack(const esp_bt_uuid_t *uuids, uint8_t count, uint8_t *buf, uint16_t buf_len);
+uint8_t wendigo_svc_uuids_unpack(const uint8_t *buf, uint16_t len, esp_bt_uuid_t *uuids, uint8_t max);
+
 #endif
\ No newline at end of file
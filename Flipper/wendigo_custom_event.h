@@ -13,4 +13,7 @@ typedef enum {
     Wendigo_EventListNetworks,
     Wendigo_EventListDeviceDetails,
     Wendigo_EventRefreshPNLCount,
+    Wendigo_EventReplayFinished,
+    Wendigo_EventLocate,
+    Wendigo_EventRefreshDeviceList,
 } Wendigo_CustomEvent;
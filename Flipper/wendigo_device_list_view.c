@@ -0,0 +1,349 @@
+#include "wendigo_device_list_view.h"
+#include "wendigo_app_i.h"
+#include <gui/elements.h>
+#include <furi.h>
+
+/* Geometry matches VariableItemList so the device list looks like the rest of the app */
+#define ROW_HEIGHT     (16)
+#define ROWS_ON_SCREEN (4)
+#define LABEL_X        (6)
+#define LABEL_WIDTH    (66)
+#define VALUE_LEFT_X   (73)
+#define VALUE_RIGHT_X  (115)
+#define VALUE_WIDTH    (VALUE_RIGHT_X - VALUE_LEFT_X - 6)
+#define HEADER_LEN     (52)
+
+struct Wendigo_DeviceListView {
+    View *view;
+};
+
+typedef struct {
+    char header[HEADER_LEN];
+    uint16_t count;
+    uint16_t position;          /* Index of the selected item */
+    uint16_t window_position;   /* Index of the first visible item */
+    FuriString *scratch;        /* Used to fit text to the available width */
+
+    Wendigo_DeviceListFormatCallback format_callback;
+    Wendigo_DeviceListChangeCallback change_callback;
+    Wendigo_DeviceListEnterCallback enter_callback;
+    void *callback_context;
+} Wendigo_DeviceListViewModel;
+
+/** Number of item rows that fit on screen, allowing for the header if there is one */
+static uint8_t wendigo_device_list_view_rows(Wendigo_DeviceListViewModel *model) {
+    return (model->header[0] == '\0') ? ROWS_ON_SCREEN : ROWS_ON_SCREEN - 1;
+}
+
+/** Move window_position so that position is visible and the window isn't
+ * scrolled past the end of the list.
+ */
+static void wendigo_device_list_view_update_window(Wendigo_DeviceListViewModel *model) {
+    uint8_t rows = wendigo_device_list_view_rows(model);
+    if (model->position < model->window_position) {
+        model->window_position = model->position;
+    } else if (model->position >= model->window_position + rows) {
+        model->window_position = model->position - rows + 1;
+    }
+    if (model->count <= rows) {
+        model->window_position = 0;
+    } else if (model->window_position > model->count - rows) {
+        model->window_position = model->count - rows;
+    }
+}
+
+static void wendigo_device_list_view_draw_callback(Canvas *canvas, void *_model) {
+    Wendigo_DeviceListViewModel *model = _model;
+    canvas_clear(canvas);
+    canvas_set_font(canvas, FontSecondary);
+    canvas_set_color(canvas, ColorBlack);
+
+    uint8_t first_row_y = 0;
+    if (model->header[0] != '\0') {
+        canvas_draw_str_aligned(canvas, 64, 4, AlignCenter, AlignTop, model->header);
+        first_row_y = ROW_HEIGHT;
+    }
+    if (model->count == 0) {
+        canvas_draw_str_aligned(canvas, 64, first_row_y + 12, AlignCenter, AlignBottom,
+            "No devices");
+        return;
+    }
+    uint8_t rows = wendigo_device_list_view_rows(model);
+    uint8_t item_width = canvas_width(canvas) - 5;
+    Wendigo_DeviceListRow row;
+    /* Only the rows on screen are formatted */
+    for (uint8_t i = 0; i < rows && model->window_position + i < model->count; ++i) {
+        uint16_t index = model->window_position + i;
+        uint8_t y = first_row_y + (i * ROW_HEIGHT);
+        bzero(&row, sizeof(Wendigo_DeviceListRow));
+        if (model->format_callback != NULL) {
+            model->format_callback(index, &row, model->callback_context);
+        }
+        if (index == model->position) {
+            canvas_set_color(canvas, ColorBlack);
+            elements_slightly_rounded_box(canvas, 0, y + 1, item_width, ROW_HEIGHT - 2);
+            canvas_set_color(canvas, ColorWhite);
+        } else {
+            canvas_set_color(canvas, ColorBlack);
+        }
+        furi_string_set_str(model->scratch, row.label);
+        elements_string_fit_width(canvas, model->scratch,
+            (row.value[0] == '\0') ? item_width - LABEL_X : LABEL_WIDTH);
+        canvas_draw_str(canvas, LABEL_X, y + 12, furi_string_get_cstr(model->scratch));
+        if (row.value[0] != '\0') {
+            if (row.option > 0) {
+                canvas_draw_str(canvas, VALUE_LEFT_X, y + 12, "<");
+            }
+            furi_string_set_str(model->scratch, row.value);
+            elements_string_fit_width(canvas, model->scratch, VALUE_WIDTH);
+            canvas_draw_str_aligned(canvas, (VALUE_RIGHT_X + VALUE_LEFT_X) / 2 + 1, y + 12,
+                AlignCenter, AlignBottom, furi_string_get_cstr(model->scratch));
+            if (row.option + 1 < row.options_count) {
+                canvas_draw_str(canvas, VALUE_RIGHT_X, y + 12, ">");
+            }
+        }
+    }
+    canvas_set_color(canvas, ColorBlack);
+    elements_scrollbar(canvas, model->position, model->count);
+}
+
+static bool wendigo_device_list_view_input_callback(InputEvent *event, void *context) {
+    furi_assert(context);
+    Wendigo_DeviceListView *list = context;
+    bool consumed = false;
+    /* Callbacks are called after the model is released so they're free to
+       call back into the view */
+    Wendigo_DeviceListChangeCallback change_callback = NULL;
+    Wendigo_DeviceListEnterCallback enter_callback = NULL;
+    void *callback_context = NULL;
+    uint16_t index = 0;
+    uint8_t option = 0;
+
+    if (event->type != InputTypeShort && event->type != InputTypeRepeat &&
+            event->type != InputTypeLong) {
+        return false;
+    }
+    with_view_model(
+        list->view,
+        Wendigo_DeviceListViewModel * model,
+        {
+            if (model->count > 0) {
+                /* A long press moves a page at a time */
+                uint16_t step = (event->type == InputTypeLong) ?
+                    wendigo_device_list_view_rows(model) : 1;
+                Wendigo_DeviceListRow row;
+                switch (event->key) {
+                    case InputKeyUp:
+                        if (model->position == 0 && event->type == InputTypeShort) {
+                            model->position = model->count - 1;
+                        } else {
+                            model->position = (model->position > step) ? model->position - step : 0;
+                        }
+                        wendigo_device_list_view_update_window(model);
+                        consumed = true;
+                        break;
+                    case InputKeyDown:
+                        if (model->position == model->count - 1 && event->type == InputTypeShort) {
+                            model->position = 0;
+                        } else if (model->position + step >= model->count) {
+                            model->position = model->count - 1;
+                        } else {
+                            model->position += step;
+                        }
+                        wendigo_device_list_view_update_window(model);
+                        consumed = true;
+                        break;
+                    case InputKeyLeft:
+                    case InputKeyRight:
+                        if (model->format_callback == NULL || event->type == InputTypeLong) {
+                            break;
+                        }
+                        bzero(&row, sizeof(Wendigo_DeviceListRow));
+                        model->format_callback(model->position, &row, model->callback_context);
+                        if (event->key == InputKeyLeft && row.option > 0) {
+                            option = row.option - 1;
+                            change_callback = model->change_callback;
+                        } else if (event->key == InputKeyRight && row.option + 1 < row.options_count) {
+                            option = row.option + 1;
+                            change_callback = model->change_callback;
+                        }
+                        index = model->position;
+                        callback_context = model->callback_context;
+                        consumed = true;
+                        break;
+                    case InputKeyOk:
+                        if (event->type == InputTypeShort) {
+                            enter_callback = model->enter_callback;
+                            index = model->position;
+                            callback_context = model->callback_context;
+                            consumed = true;
+                        }
+                        break;
+                    default:
+                        break;
+                }
+            }
+        },
+        consumed);
+    if (change_callback != NULL) {
+        change_callback(index, option, callback_context);
+        wendigo_device_list_view_refresh(list);
+    }
+    if (enter_callback != NULL) {
+        enter_callback(index, callback_context);
+    }
+    return consumed;
+}
+
+Wendigo_DeviceListView *wendigo_device_list_view_alloc() {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_device_list_view_alloc()");
+    Wendigo_DeviceListView *list = malloc(sizeof(Wendigo_DeviceListView));
+    list->view = view_alloc();
+    view_set_context(list->view, list);
+    view_allocate_model(list->view, ViewModelTypeLocking, sizeof(Wendigo_DeviceListViewModel));
+    view_set_draw_callback(list->view, wendigo_device_list_view_draw_callback);
+    view_set_input_callback(list->view, wendigo_device_list_view_input_callback);
+
+    with_view_model(
+        list->view,
+        Wendigo_DeviceListViewModel * model,
+        { model->scratch = furi_string_alloc(); },
+        false);
+
+    wendigo_device_list_view_reset(list);
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_device_list_view_alloc()");
+    return list;
+}
+
+void wendigo_device_list_view_free(Wendigo_DeviceListView *list) {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_device_list_view_free()");
+    furi_assert(list);
+    with_view_model(
+        list->view,
+        Wendigo_DeviceListViewModel * model,
+        { furi_string_free(model->scratch); },
+        false);
+    view_free(list->view);
+    free(list);
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_device_list_view_free()");
+}
+
+void wendigo_device_list_view_reset(Wendigo_DeviceListView *list) {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_device_list_view_reset()");
+    furi_assert(list);
+    with_view_model(
+        list->view,
+        Wendigo_DeviceListViewModel * model,
+        {
+            model->header[0] = '\0';
+            model->count = 0;
+            model->position = 0;
+            model->window_position = 0;
+            model->format_callback = NULL;
+            model->change_callback = NULL;
+            model->enter_callback = NULL;
+            model->callback_context = NULL;
+        },
+        true);
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_device_list_view_reset()");
+}
+
+View *wendigo_device_list_view_get_view(Wendigo_DeviceListView *list) {
+    furi_assert(list);
+    return list->view;
+}
+
+void wendigo_device_list_view_set_callbacks(
+        Wendigo_DeviceListView *list,
+        Wendigo_DeviceListFormatCallback format,
+        Wendigo_DeviceListChangeCallback change,
+        Wendigo_DeviceListEnterCallback enter,
+        void *context) {
+    furi_assert(list);
+    with_view_model(
+        list->view,
+        Wendigo_DeviceListViewModel * model,
+        {
+            model->format_callback = format;
+            model->change_callback = change;
+            model->enter_callback = enter;
+            model->callback_context = context;
+        },
+        true);
+}
+
+void wendigo_device_list_view_set_header(Wendigo_DeviceListView *list, const char *text) {
+    furi_assert(list);
+    with_view_model(
+        list->view,
+        Wendigo_DeviceListViewModel * model,
+        {
+            if (text == NULL) {
+                model->header[0] = '\0';
+            } else {
+                strncpy(model->header, text, HEADER_LEN - 1);
+                model->header[HEADER_LEN - 1] = '\0';
+            }
+            wendigo_device_list_view_update_window(model);
+        },
+        true);
+}
+
+void wendigo_device_list_view_set_count(Wendigo_DeviceListView *list, uint16_t count) {
+    furi_assert(list);
+    with_view_model(
+        list->view,
+        Wendigo_DeviceListViewModel * model,
+        {
+            model->count = count;
+            if (model->position >= count) {
+                model->position = (count == 0) ? 0 : count - 1;
+            }
+            wendigo_device_list_view_update_window(model);
+        },
+        true);
+}
+
+uint16_t wendigo_device_list_view_get_count(Wendigo_DeviceListView *list) {
+    furi_assert(list);
+    uint16_t count = 0;
+    with_view_model(
+        list->view, Wendigo_DeviceListViewModel * model, { count = model->count; }, false);
+    return count;
+}
+
+void wendigo_device_list_view_set_selected(Wendigo_DeviceListView *list, uint16_t index) {
+    furi_assert(list);
+    with_view_model(
+        list->view,
+        Wendigo_DeviceListViewModel * model,
+        {
+            model->position = (index < model->count) ? index : 0;
+            wendigo_device_list_view_update_window(model);
+        },
+        true);
+}
+
+uint16_t wendigo_device_list_view_get_selected(Wendigo_DeviceListView *list) {
+    furi_assert(list);
+    uint16_t position = 0;
+    with_view_model(
+        list->view, Wendigo_DeviceListViewModel * model, { position = model->position; }, false);
+    return position;
+}
+
+void wendigo_device_list_view_refresh(Wendigo_DeviceListView *list) {
+    furi_assert(list);
+    with_view_model(list->view, Wendigo_DeviceListViewModel * model, { UNUSED(model); }, true);
+}
+
+void wendigo_device_list_view_begin_update(Wendigo_DeviceListView *list) {
+    furi_assert(list);
+    /* Holding the model's lock blocks the draw and input callbacks */
+    view_get_model(list->view);
+}
+
+void wendigo_device_list_view_end_update(Wendigo_DeviceListView *list, bool update) {
+    furi_assert(list);
+    view_commit_model(list->view, update);
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <gui/view.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Maximum length of a row's label and value, including the terminating '\0' */
+#define WENDIGO_DEVICE_LIST_ROW_LEN (33)
+
+/** Device list view anonymous structure */
+typedef struct Wendigo_DeviceListView Wendigo_DeviceListView;
+
+/** A single row of the device list, populated on demand by the format callback.
+ * Rows only exist while they are being drawn - the view itself holds no
+ * per-row state.
+ */
+typedef struct Wendigo_DeviceListRow {
+    char label[WENDIGO_DEVICE_LIST_ROW_LEN];
+    char value[WENDIGO_DEVICE_LIST_ROW_LEN];
+    uint8_t option;         /* Index of the currently-displayed option */
+    uint8_t options_count;  /* Number of options available for this row */
+} Wendigo_DeviceListRow;
+
+/** Populate `row` to describe the item at `index` */
+typedef void (*Wendigo_DeviceListFormatCallback)(uint16_t index, Wendigo_DeviceListRow *row,
+                                                 void *context);
+/** The user has changed the option displayed for the item at `index` */
+typedef void (*Wendigo_DeviceListChangeCallback)(uint16_t index, uint8_t option, void *context);
+/** The user has pressed OK on the item at `index` */
+typedef void (*Wendigo_DeviceListEnterCallback)(uint16_t index, void *context);
+
+/** Allocate and initialise the device list view
+ *
+ * The device list is a scrolling list, similar in appearance to
+ * VariableItemList, that holds no items of its own. It is told how many items
+ * there are and calls the format callback for each row that is on screen when
+ * it is drawn, so the cost of drawing and scrolling is independent of the
+ * number of items and its memory use doesn't grow with them.
+ *
+ * @return     Wendigo_DeviceListView instance
+ */
+Wendigo_DeviceListView *wendigo_device_list_view_alloc();
+
+/** Deinitialise and free the device list view
+ *
+ * @param      list  Wendigo_DeviceListView instance
+ */
+void wendigo_device_list_view_free(Wendigo_DeviceListView *list);
+
+/** Remove all items, the header and callbacks from the view
+ *
+ * @param      list  Wendigo_DeviceListView instance
+ */
+void wendigo_device_list_view_reset(Wendigo_DeviceListView *list);
+
+/** Get the device list's view
+ *
+ * @param      list  Wendigo_DeviceListView instance
+ *
+ * @return     View instance that can be used for embedding
+ */
+View *wendigo_device_list_view_get_view(Wendigo_DeviceListView *list);
+
+/** Set the callbacks used to format rows and respond to input
+ *
+ * @param      list      Wendigo_DeviceListView instance
+ * @param      format    called for each visible row at draw time
+ * @param      change    called when Left/Right changes a row's option
+ * @param      enter     called when OK is pressed
+ * @param      context   passed to all callbacks
+ */
+void wendigo_device_list_view_set_callbacks(
+    Wendigo_DeviceListView *list,
+    Wendigo_DeviceListFormatCallback format,
+    Wendigo_DeviceListChangeCallback change,
+    Wendigo_DeviceListEnterCallback enter,
+    void *context);
+
+/** Set header text, or NULL to remove the header
+ *
+ * @param      list  Wendigo_DeviceListView instance
+ * @param      text  header text - copied by the view
+ */
+void wendigo_device_list_view_set_header(Wendigo_DeviceListView *list, const char *text);
+
+/** Set the number of items in the list, keeping the selection in bounds
+ *
+ * @param      list   Wendigo_DeviceListView instance
+ * @param      count  number of items
+ */
+void wendigo_device_list_view_set_count(Wendigo_DeviceListView *list, uint16_t count);
+
+uint16_t wendigo_device_list_view_get_count(Wendigo_DeviceListView *list);
+
+/** Select the item at `index` and scroll it into view */
+void wendigo_device_list_view_set_selected(Wendigo_DeviceListView *list, uint16_t index);
+
+uint16_t wendigo_device_list_view_get_selected(Wendigo_DeviceListView *list);
+
+/** Redraw the visible rows. This is cheap - only the rows on screen are
+ * formatted - so it can be called whenever the underlying data changes.
+ *
+ * @param      list  Wendigo_DeviceListView instance
+ */
+void wendigo_device_list_view_refresh(Wendigo_DeviceListView *list);
+
+/** Prevent the view from drawing until wendigo_device_list_view_end_update()
+ * is called. Use this when the data behind the list is changed from another
+ * thread, so the format callback never sees it half-updated. No other
+ * wendigo_device_list_view_* function may be called in between.
+ *
+ * @param      list  Wendigo_DeviceListView instance
+ */
+void wendigo_device_list_view_begin_update(Wendigo_DeviceListView *list);
+
+/** Allow the view to draw again, redrawing it if `update` is true
+ *
+ * @param      list    Wendigo_DeviceListView instance
+ * @param      update  whether the view should be redrawn
+ */
+void wendigo_device_list_view_end_update(Wendigo_DeviceListView *list, bool update);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,63 @@
+#include "wendigo_hash.h"
+
+#define FNV1A_OFFSET_BASIS (2166136261u)
+#define FNV1A_PRIME        (16777619u)
+
+/** FNV-1a hash of the specified MAC */
+uint32_t wendigo_hash_mac(const uint8_t mac[MAC_BYTES]) {
+    uint32_t hash = FNV1A_OFFSET_BASIS;
+    for (uint8_t i = 0; i < MAC_BYTES; ++i) {
+        hash ^= mac[i];
+        hash *= FNV1A_PRIME;
+    }
+    return hash;
+}
+
+/** FNV-1a hash of the specified SSID, considering at most MAX_SSID_LEN characters */
+uint32_t wendigo_hash_ssid(const char *ssid) {
+    uint32_t hash = FNV1A_OFFSET_BASIS;
+    for (uint8_t i = 0; i < MAX_SSID_LEN && ssid[i] != '\0'; ++i) {
+        hash ^= (uint8_t)ssid[i];
+        hash *= FNV1A_PRIME;
+    }
+    return hash;
+}
+
+/** The capacity an index of `capacity` slots should be grown to before it
+ * holds `count` entries, or 0 if it should be left as it is - because it
+ * would be at most half full, growing it last failed with fewer than
+ * `retry_at` entries, or it can't grow any further. An empty index grows to
+ * at least `min_capacity`, which must be a power of 2.
+ */
+uint16_t wendigo_index_grow_capacity(uint16_t count, uint16_t capacity, uint16_t min_capacity,
+                                     uint16_t retry_at) {
+    if (count <= capacity / 2 || count < retry_at) {
+        return 0;
+    }
+    uint32_t new_capacity = (capacity == 0) ? min_capacity : capacity;
+    while (new_capacity / 2 < count && new_capacity < WENDIGO_INDEX_MAX_CAPACITY) {
+        new_capacity *= 2;
+    }
+    /* A lookup needs an empty slot to stop at */
+    if (new_capacity <= capacity || count >= new_capacity) {
+        return 0;
+    }
+    return (uint16_t)new_capacity;
+}
+
+/** The `retry_at` to use after an index holding `count` entries couldn't be
+ * grown - Don't try again until it holds twice as many.
+ */
+uint16_t wendigo_index_retry_at(uint16_t count) {
+    return (count > UINT16_MAX / 2) ? UINT16_MAX : count * 2;
+}
+
+/** When removing an entry leaves `gap` empty, can the entry in `slot`, a
+ * later slot in the same probe sequence whose home slot is `home`, be moved
+ * back into it? Only if `gap` lies between `home` and `slot`, allowing for
+ * wrapping - Otherwise it would end up before its home slot, where a lookup
+ * never looks.
+ */
+bool wendigo_index_can_fill(uint16_t home, uint16_t gap, uint16_t slot, uint16_t mask) {
+    return ((gap - home) & mask) < ((slot - home) & mask);
+}
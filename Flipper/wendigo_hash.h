@@ -0,0 +1,24 @@
+#pragma once
+
+#include "wendigo_app_i.h"
+
+/** Hashing and sizing for Flipper-Wendigo's hash indexes - mac_index[] over
+ * devices[], pnl_index[] over networks[] and spill_index[] over the spill
+ * file. Each is open-addressed with linear probing, and its capacity is a
+ * power of 2 that's kept at least twice the number of entries, memory
+ * permitting, so that probe sequences stay short. A lookup stops at an empty
+ * slot, so a table must always keep at least one.
+ * If a table can't be grown it's used as it is - fuller, so slower - and
+ * growing it isn't tried again until it holds twice as many entries, rather
+ * than failing an allocation for every entry added.
+ */
+
+/* Largest power of 2 that a uint16_t capacity can hold */
+#define WENDIGO_INDEX_MAX_CAPACITY (0x8000)
+
+uint32_t wendigo_hash_mac(const uint8_t mac[MAC_BYTES]);
+uint32_t wendigo_hash_ssid(const char *ssid);
+uint16_t wendigo_index_grow_capacity(uint16_t count, uint16_t capacity, uint16_t min_capacity,
+                                     uint16_t retry_at);
+uint16_t wendigo_index_retry_at(uint16_t count);
+bool wendigo_index_can_fill(uint16_t home, uint16_t gap, uint16_t slot, uint16_t mask);
@@ -0,0 +1,747 @@
+/* Generated from protocol/wendigo_packets.schema by protocol/generate_packets.py.
+ * DO NOT EDIT - Change the schema and regenerate. */
+
+#include "wendigo_packets.h"
+
+#include <string.h>
+
+static const uint8_t wendigo_pkt_terminator[WENDIGO_PKT_PREAMBLE_LEN] = WENDIGO_PKT_TERMINATOR_INIT;
+static const uint8_t wendigo_pkt_preambles[WENDIGO_PKT_TYPE_COUNT][WENDIGO_PKT_PREAMBLE_LEN] = {
+    WENDIGO_PREAMBLE_BT_BLE_INIT,
+    WENDIGO_PREAMBLE_WIFI_AP_INIT,
+    WENDIGO_PREAMBLE_WIFI_STA_INIT,
+    WENDIGO_PREAMBLE_CHANNELS_INIT,
+    WENDIGO_PREAMBLE_STATUS_INIT,
+    WENDIGO_PREAMBLE_VER_INIT,
+    WENDIGO_PREAMBLE_MAC_INIT,
+    WENDIGO_PREAMBLE_BT_SVC_INIT,
+    WENDIGO_PREAMBLE_RSSI_INIT,
+};
+static const char *const wendigo_pkt_names[WENDIGO_PKT_TYPE_COUNT] = {
+    "bt",
+    "wifi_ap",
+    "wifi_sta",
+    "channels",
+    "status",
+    "version",
+    "mac",
+    "bt_services",
+    "rssi",
+};
+
+static void wendigo_pkt_put_le(uint8_t *dst, uint32_t value, uint8_t size) {
+    for (uint8_t i = 0; i < size; ++i) {
+        dst[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static uint32_t wendigo_pkt_get_le(const uint8_t *src, uint8_t size) {
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < size; ++i) {
+        value |= (uint32_t)src[i] << (8 * i);
+    }
+    return value;
+}
+
+/** Length of a string when encoded, excluding its length byte */
+static uint8_t wendigo_pkt_strlen(const char *const *strings, uint32_t index) {
+    if (strings == NULL || strings[index] == NULL) {
+        return 0;
+    }
+    const char *str = strings[index];
+    uint16_t len = 0;
+    while (len < WENDIGO_PKT_STRING_MAX && str[len] != '\0') {
+        ++len;
+    }
+    return (uint8_t)len;
+}
+
+/** Begin encoding a packet - Check it fits in `buf_len` and write its preamble */
+static bool wendigo_pkt_begin(wendigo_pkt_type type, uint32_t size, uint8_t *buf, uint16_t buf_len) {
+    if (size == 0 || size > buf_len || buf == NULL) {
+        return false;
+    }
+    memcpy(buf, wendigo_pkt_preambles[type], WENDIGO_PKT_PREAMBLE_LEN);
+    return true;
+}
+
+/** Finish encoding a packet - Write the terminator at `offset` */
+static uint16_t wendigo_pkt_end(uint8_t *buf, uint16_t offset) {
+    memcpy(buf + offset, wendigo_pkt_terminator, WENDIGO_PKT_PREAMBLE_LEN);
+    return offset + WENDIGO_PKT_PREAMBLE_LEN;
+}
+
+/** Validate the string list starting at `offset` and return its length, or
+ * -1 if it runs into the terminator's space */
+static int32_t wendigo_pkt_strings_len(const uint8_t *buf, uint16_t len, uint32_t offset, uint32_t count) {
+    uint32_t idx = offset;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (idx + 1 + WENDIGO_PKT_PREAMBLE_LEN > len) {
+            return -1;
+        }
+        idx += 1 + buf[idx];
+        if (idx + WENDIGO_PKT_PREAMBLE_LEN > len) {
+            return -1;
+        }
+    }
+    return (int32_t)(idx - offset);
+}
+
+wendigo_pkt_type wendigo_pkt_identify(const uint8_t *buf, uint16_t len) {
+    if (buf == NULL || len < WENDIGO_PKT_PREAMBLE_LEN) {
+        return WENDIGO_PKT_UNKNOWN;
+    }
+    for (uint8_t type = 0; type < WENDIGO_PKT_TYPE_COUNT; ++type) {
+        if (!memcmp(buf, wendigo_pkt_preambles[type], WENDIGO_PKT_PREAMBLE_LEN)) {
+            return (wendigo_pkt_type)type;
+        }
+    }
+    return WENDIGO_PKT_UNKNOWN;
+}
+
+const char *wendigo_pkt_type_name(wendigo_pkt_type type) {
+    return (type < WENDIGO_PKT_TYPE_COUNT) ? wendigo_pkt_names[type] : "unknown";
+}
+
+bool wendigo_pkt_is_terminator(const uint8_t *buf, uint16_t len, uint32_t offset) {
+    return offset + WENDIGO_PKT_PREAMBLE_LEN <= len &&
+        !memcmp(buf + offset, wendigo_pkt_terminator, WENDIGO_PKT_PREAMBLE_LEN);
+}
+
+bool wendigo_pkt_next_string(const uint8_t **cursor, const uint8_t *end,
+        const uint8_t **str, uint8_t *str_len) {
+    if (*cursor >= end || *cursor + 1 + **cursor > end) {
+        return false;
+    }
+    *str_len = **cursor;
+    *str = *cursor + 1;
+    *cursor += 1 + *str_len;
+    return true;
+}
+
+const uint8_t *wendigo_pkt_typed_mac_at(const uint8_t *raw, uint16_t index, uint8_t *type) {
+    const uint8_t *entry = raw + (index * (WENDIGO_PKT_MAC_BYTES + 1));
+    if (type != NULL) {
+        *type = entry[0];
+    }
+    return entry + 1;
+}
+
+uint16_t wendigo_pkt_bt_size(const wendigo_pkt_bt *pkt) {
+    uint32_t size = WENDIGO_PKT_BT_FIXED_LEN + WENDIGO_PKT_PREAMBLE_LEN;
+    size += pkt->bdname_len;
+    size += pkt->eir_len;
+    return (size > UINT16_MAX) ? 0 : (uint16_t)size;
+}
+
+uint16_t wendigo_pkt_bt_encode(const wendigo_pkt_bt *pkt, uint8_t *buf, uint16_t buf_len) {
+    if ((pkt->bdname_len > 0 && pkt->bdname == NULL) ||
+            (pkt->eir_len > 0 && pkt->eir == NULL)) {
+        return 0;
+    }
+    if (!wendigo_pkt_begin(WENDIGO_PKT_BT, wendigo_pkt_bt_size(pkt), buf, buf_len)) {
+        return 0;
+    }
+    buf[WENDIGO_OFFSET_BT_BDNAME_LEN] = (uint8_t)pkt->bdname_len;
+    buf[WENDIGO_OFFSET_BT_EIR_LEN] = (uint8_t)pkt->eir_len;
+    wendigo_pkt_put_le(buf + WENDIGO_OFFSET_BT_RSSI, (uint32_t)pkt->rssi, 2);
+    wendigo_pkt_put_le(buf + WENDIGO_OFFSET_BT_COD, (uint32_t)pkt->cod, 4);
+    memcpy(buf + WENDIGO_OFFSET_BT_BDA, pkt->bda, WENDIGO_PKT_MAC_BYTES);
+    buf[WENDIGO_OFFSET_BT_SCANTYPE] = (uint8_t)pkt->scantype;
+    buf[WENDIGO_OFFSET_BT_TAGGED] = (uint8_t)pkt->tagged;
+    memset(buf + WENDIGO_OFFSET_BT_LASTSEEN, 0, 19);
+    buf[WENDIGO_OFFSET_BT_NUM_SERVICES] = (uint8_t)pkt->num_services;
+    buf[WENDIGO_OFFSET_BT_KNOWN_SERVICES_LEN] = (uint8_t)pkt->known_services_len;
+    uint16_t offset = WENDIGO_PKT_BT_FIXED_LEN;
+    if (pkt->bdname_len > 0) {
+        memcpy(buf + offset, pkt->bdname, pkt->bdname_len);
+        offset += pkt->bdname_len;
+    }
+    if (pkt->eir_len > 0) {
+        memcpy(buf + offset, pkt->eir, pkt->eir_len);
+        offset += pkt->eir_len;
+    }
+    return wendigo_pkt_end(buf, offset);
+}
+
+uint16_t wendigo_pkt_bt_decode(wendigo_pkt_bt *pkt, const uint8_t *buf, uint16_t len) {
+    if (buf == NULL || len < WENDIGO_PKT_BT_MIN_LEN ||
+            memcmp(buf, wendigo_pkt_preambles[WENDIGO_PKT_BT], WENDIGO_PKT_PREAMBLE_LEN)) {
+        return 0;
+    }
+    memset(pkt, 0, sizeof(wendigo_pkt_bt));
+    pkt->bdname_len = (uint8_t)buf[WENDIGO_OFFSET_BT_BDNAME_LEN];
+    pkt->eir_len = (uint8_t)buf[WENDIGO_OFFSET_BT_EIR_LEN];
+    pkt->rssi = (int16_t)wendigo_pkt_get_le(buf + WENDIGO_OFFSET_BT_RSSI, 2);
+    pkt->cod = (uint32_t)wendigo_pkt_get_le(buf + WENDIGO_OFFSET_BT_COD, 4);
+    memcpy(pkt->bda, buf + WENDIGO_OFFSET_BT_BDA, WENDIGO_PKT_MAC_BYTES);
+    pkt->scantype = (uint8_t)buf[WENDIGO_OFFSET_BT_SCANTYPE];
+    pkt->tagged = (uint8_t)buf[WENDIGO_OFFSET_BT_TAGGED];
+    pkt->num_services = (uint8_t)buf[WENDIGO_OFFSET_BT_NUM_SERVICES];
+    pkt->known_services_len = (uint8_t)buf[WENDIGO_OFFSET_BT_KNOWN_SERVICES_LEN];
+    uint32_t offset = WENDIGO_PKT_BT_FIXED_LEN;
+    uint32_t field_len;
+    field_len = pkt->bdname_len;
+    if (offset + field_len + WENDIGO_PKT_PREAMBLE_LEN > len) {
+        return 0;
+    }
+    pkt->bdname = (field_len > 0) ? buf + offset : NULL;
+    offset += field_len;
+    field_len = pkt->eir_len;
+    if (offset + field_len + WENDIGO_PKT_PREAMBLE_LEN > len) {
+        return 0;
+    }
+    pkt->eir = (field_len > 0) ? buf + offset : NULL;
+    offset += field_len;
+    if (!wendigo_pkt_is_terminator(buf, len, offset)) {
+        return 0;
+    }
+    return (uint16_t)(offset + WENDIGO_PKT_PREAMBLE_LEN);
+}
+
+static uint32_t wendigo_pkt_bt_frame_len(const uint8_t *buf, uint16_t len) {
+    if (len < WENDIGO_PKT_BT_FIXED_LEN) {
+        return 0;
+    }
+    uint32_t offset = WENDIGO_PKT_BT_FIXED_LEN;
+    offset += (uint32_t)buf[WENDIGO_OFFSET_BT_BDNAME_LEN];
+    offset += (uint32_t)buf[WENDIGO_OFFSET_BT_EIR_LEN];
+    return offset + WENDIGO_PKT_PREAMBLE_LEN;
+}
+
+uint16_t wendigo_pkt_wifi_ap_size(const wendigo_pkt_wifi_ap *pkt) {
+    uint32_t size = WENDIGO_PKT_WIFI_AP_FIXED_LEN + WENDIGO_PKT_PREAMBLE_LEN;
+    size += pkt->ssid_len;
+    size += (uint32_t)pkt->sta_count * WENDIGO_PKT_MAC_BYTES;
+    return (size > UINT16_MAX) ? 0 : (uint16_t)size;
+}
+
+uint16_t wendigo_pkt_wifi_ap_encode(const wendigo_pkt_wifi_ap *pkt, uint8_t *buf, uint16_t buf_len) {
+    if ((pkt->ssid_len > 0 && pkt->ssid == NULL)) {
+        return 0;
+    }
+    if (!wendigo_pkt_begin(WENDIGO_PKT_WIFI_AP, wendigo_pkt_wifi_ap_size(pkt), buf, buf_len)) {
+        return 0;
+    }
+    buf[WENDIGO_OFFSET_WIFI_SCANTYPE] = (uint8_t)pkt->scantype;
+    memcpy(buf + WENDIGO_OFFSET_WIFI_MAC, pkt->mac, WENDIGO_PKT_MAC_BYTES);
+    buf[WENDIGO_OFFSET_WIFI_CHANNEL] = (uint8_t)pkt->channel;
+    wendigo_pkt_put_le(buf + WENDIGO_OFFSET_WIFI_RSSI, (uint32_t)pkt->rssi, 2);
+    memset(buf + WENDIGO_OFFSET_WIFI_LASTSEEN, 0, 19);
+    buf[WENDIGO_OFFSET_WIFI_TAGGED] = (uint8_t)pkt->tagged;
+    buf[WENDIGO_OFFSET_AP_AUTH_MODE] = (uint8_t)pkt->auth_mode;
+    buf[WENDIGO_OFFSET_AP_SSID_LEN] = (uint8_t)pkt->ssid_len;
+    buf[WENDIGO_OFFSET_AP_STA_COUNT] = (uint8_t)pkt->sta_count;
+    uint16_t offset = WENDIGO_PKT_WIFI_AP_FIXED_LEN;
+    if (pkt->ssid_len > 0) {
+        memcpy(buf + offset, pkt->ssid, pkt->ssid_len);
+        offset += pkt->ssid_len;
+    }
+    for (uint16_t i = 0; i < pkt->sta_count; ++i) {
+        if (pkt->stations == NULL || pkt->stations[i] == NULL) {
+            memset(buf + offset, 0, WENDIGO_PKT_MAC_BYTES);
+        } else {
+            memcpy(buf + offset, pkt->stations[i], WENDIGO_PKT_MAC_BYTES);
+        }
+        offset += WENDIGO_PKT_MAC_BYTES;
+    }
+    return wendigo_pkt_end(buf, offset);
+}
+
+uint16_t wendigo_pkt_wifi_ap_decode(wendigo_pkt_wifi_ap *pkt, const uint8_t *buf, uint16_t len) {
+    if (buf == NULL || len < WENDIGO_PKT_WIFI_AP_MIN_LEN ||
+            memcmp(buf, wendigo_pkt_preambles[WENDIGO_PKT_WIFI_AP], WENDIGO_PKT_PREAMBLE_LEN)) {
+        return 0;
+    }
+    memset(pkt, 0, sizeof(wendigo_pkt_wifi_ap));
+    pkt->scantype = (uint8_t)buf[WENDIGO_OFFSET_WIFI_SCANTYPE];
+    memcpy(pkt->mac, buf + WENDIGO_OFFSET_WIFI_MAC, WENDIGO_PKT_MAC_BYTES);
+    pkt->channel = (uint8_t)buf[WENDIGO_OFFSET_WIFI_CHANNEL];
+    pkt->rssi = (int16_t)wendigo_pkt_get_le(buf + WENDIGO_OFFSET_WIFI_RSSI, 2);
+    pkt->tagged = (uint8_t)buf[WENDIGO_OFFSET_WIFI_TAGGED];
+    pkt->auth_mode = (uint8_t)buf[WENDIGO_OFFSET_AP_AUTH_MODE];
+    pkt->ssid_len = (uint8_t)buf[WENDIGO_OFFSET_AP_SSID_LEN];
+    pkt->sta_count = (uint8_t)buf[WENDIGO_OFFSET_AP_STA_COUNT];
+    uint32_t offset = WENDIGO_PKT_WIFI_AP_FIXED_LEN;
+    uint32_t field_len;
+    field_len = pkt->ssid_len;
+    if (offset + field_len + WENDIGO_PKT_PREAMBLE_LEN > len) {
+        return 0;
+    }
+    pkt->ssid = (field_len > 0) ? buf + offset : NULL;
+    offset += field_len;
+    field_len = (uint32_t)pkt->sta_count * WENDIGO_PKT_MAC_BYTES;
+    if (offset + field_len + WENDIGO_PKT_PREAMBLE_LEN > len) {
+        return 0;
+    }
+    pkt->stations_raw = buf + offset;
+    offset += field_len;
+    if (!wendigo_pkt_is_terminator(buf, len, offset)) {
+        return 0;
+    }
+    return (uint16_t)(offset + WENDIGO_PKT_PREAMBLE_LEN);
+}
+
+static uint32_t wendigo_pkt_wifi_ap_frame_len(const uint8_t *buf, uint16_t len) {
+    if (len < WENDIGO_PKT_WIFI_AP_FIXED_LEN) {
+        return 0;
+    }
+    uint32_t offset = WENDIGO_PKT_WIFI_AP_FIXED_LEN;
+    offset += (uint32_t)buf[WENDIGO_OFFSET_AP_SSID_LEN];
+    offset += (uint32_t)buf[WENDIGO_OFFSET_AP_STA_COUNT] * WENDIGO_PKT_MAC_BYTES;
+    return offset + WENDIGO_PKT_PREAMBLE_LEN;
+}
+
+uint16_t wendigo_pkt_wifi_sta_size(const wendigo_pkt_wifi_sta *pkt) {
+    uint32_t size = WENDIGO_PKT_WIFI_STA_FIXED_LEN + WENDIGO_PKT_PREAMBLE_LEN;
+    size += pkt->ap_ssid_len;
+    for (uint32_t i = 0; i < (uint32_t)pkt->pnl_count; ++i) {
+        size += 1 + wendigo_pkt_strlen((const char *const *)pkt->pnl, i);
+    }
+    return (size > UINT16_MAX) ? 0 : (uint16_t)size;
+}
+
+uint16_t wendigo_pkt_wifi_sta_encode(const wendigo_pkt_wifi_sta *pkt, uint8_t *buf, uint16_t buf_len) {
+    if ((pkt->ap_ssid_len > 0 && pkt->ap_ssid == NULL)) {
+        return 0;
+    }
+    if (!wendigo_pkt_begin(WENDIGO_PKT_WIFI_STA, wendigo_pkt_wifi_sta_size(pkt), buf, buf_len)) {
+        return 0;
+    }
+    buf[WENDIGO_OFFSET_WIFI_SCANTYPE] = (uint8_t)pkt->scantype;
+    memcpy(buf + WENDIGO_OFFSET_WIFI_MAC, pkt->mac, WENDIGO_PKT_MAC_BYTES);
+    buf[WENDIGO_OFFSET_WIFI_CHANNEL] = (uint8_t)pkt->channel;
+    wendigo_pkt_put_le(buf + WENDIGO_OFFSET_WIFI_RSSI, (uint32_t)pkt->rssi, 2);
+    memset(buf + WENDIGO_OFFSET_WIFI_LASTSEEN, 0, 19);
+    buf[WENDIGO_OFFSET_WIFI_TAGGED] = (uint8_t)pkt->tagged;
+    buf[WENDIGO_OFFSET_STA_PNL_COUNT] = (uint8_t)pkt->pnl_count;
+    memcpy(buf + WENDIGO_OFFSET_STA_AP_MAC, pkt->ap_mac, WENDIGO_PKT_MAC_BYTES);
+    buf[WENDIGO_OFFSET_STA_AP_SSID_LEN] = (uint8_t)pkt->ap_ssid_len;
+    uint16_t offset = WENDIGO_PKT_WIFI_STA_FIXED_LEN;
+    if (pkt->ap_ssid_len > 0) {
+        memcpy(buf + offset, pkt->ap_ssid, pkt->ap_ssid_len);
+        offset += pkt->ap_ssid_len;
+    }
+    for (uint32_t i = 0; i < (uint32_t)pkt->pnl_count; ++i) {
+        uint8_t str_len = wendigo_pkt_strlen((const char *const *)pkt->pnl, i);
+        buf[offset++] = str_len;
+        if (str_len > 0) {
+            memcpy(buf + offset, pkt->pnl[i], str_len);
+            offset += str_len;
+        }
+    }
+    return wendigo_pkt_end(buf, offset);
+}
+
+uint16_t wendigo_pkt_wifi_sta_decode(wendigo_pkt_wifi_sta *pkt, const uint8_t *buf, uint16_t len) {
+    if (buf == NULL || len < WENDIGO_PKT_WIFI_STA_MIN_LEN ||
+            memcmp(buf, wendigo_pkt_preambles[WENDIGO_PKT_WIFI_STA], WENDIGO_PKT_PREAMBLE_LEN)) {
+        return 0;
+    }
+    memset(pkt, 0, sizeof(wendigo_pkt_wifi_sta));
+    pkt->scantype = (uint8_t)buf[WENDIGO_OFFSET_WIFI_SCANTYPE];
+    memcpy(pkt->mac, buf + WENDIGO_OFFSET_WIFI_MAC, WENDIGO_PKT_MAC_BYTES);
+    pkt->channel = (uint8_t)buf[WENDIGO_OFFSET_WIFI_CHANNEL];
+    pkt->rssi = (int16_t)wendigo_pkt_get_le(buf + WENDIGO_OFFSET_WIFI_RSSI, 2);
+    pkt->tagged = (uint8_t)buf[WENDIGO_OFFSET_WIFI_TAGGED];
+    pkt->pnl_count = (uint8_t)buf[WENDIGO_OFFSET_STA_PNL_COUNT];
+    memcpy(pkt->ap_mac, buf + WENDIGO_OFFSET_STA_AP_MAC, WENDIGO_PKT_MAC_BYTES);
+    pkt->ap_ssid_len = (uint8_t)buf[WENDIGO_OFFSET_STA_AP_SSID_LEN];
+    uint32_t offset = WENDIGO_PKT_WIFI_STA_FIXED_LEN;
+    uint32_t field_len;
+    field_len = pkt->ap_ssid_len;
+    if (offset + field_len + WENDIGO_PKT_PREAMBLE_LEN > len) {
+        return 0;
+    }
+    pkt->ap_ssid = (field_len > 0) ? buf + offset : NULL;
+    offset += field_len;
+    int32_t pnl_len = wendigo_pkt_strings_len(buf, len, offset, (uint32_t)pkt->pnl_count);
+    if (pnl_len < 0) {
+        return 0;
+    }
+    pkt->pnl_raw = buf + offset;
+    pkt->pnl_raw_len = (uint16_t)pnl_len;
+    offset += (uint32_t)pnl_len;
+    if (!wendigo_pkt_is_terminator(buf, len, offset)) {
+        return 0;
+    }
+    return (uint16_t)(offset + WENDIGO_PKT_PREAMBLE_LEN);
+}
+
+static uint32_t wendigo_pkt_wifi_sta_frame_len(const uint8_t *buf, uint16_t len) {
+    if (len < WENDIGO_PKT_WIFI_STA_FIXED_LEN) {
+        return 0;
+    }
+    uint32_t offset = WENDIGO_PKT_WIFI_STA_FIXED_LEN;
+    offset += (uint32_t)buf[WENDIGO_OFFSET_STA_AP_SSID_LEN];
+    for (uint32_t i = (uint32_t)buf[WENDIGO_OFFSET_STA_PNL_COUNT]; i > 0; --i) {
+        if (offset >= len) {
+            return 0;
+        }
+        offset += 1 + (uint32_t)buf[offset];
+    }
+    return offset + WENDIGO_PKT_PREAMBLE_LEN;
+}
+
+uint16_t wendigo_pkt_channels_size(const wendigo_pkt_channels *pkt) {
+    uint32_t size = WENDIGO_PKT_CHANNELS_FIXED_LEN + WENDIGO_PKT_PREAMBLE_LEN;
+    size += pkt->count;
+    return (size > UINT16_MAX) ? 0 : (uint16_t)size;
+}
+
+uint16_t wendigo_pkt_channels_encode(const wendigo_pkt_channels *pkt, uint8_t *buf, uint16_t buf_len) {
+    if ((pkt->count > 0 && pkt->channels == NULL)) {
+        return 0;
+    }
+    if (!wendigo_pkt_begin(WENDIGO_PKT_CHANNELS, wendigo_pkt_channels_size(pkt), buf, buf_len)) {
+        return 0;
+    }
+    buf[WENDIGO_OFFSET_CHANNEL_COUNT] = (uint8_t)pkt->count;
+    uint16_t offset = WENDIGO_PKT_CHANNELS_FIXED_LEN;
+    if (pkt->count > 0) {
+        memcpy(buf + offset, pkt->channels, pkt->count);
+        offset += pkt->count;
+    }
+    return wendigo_pkt_end(buf, offset);
+}
+
+uint16_t wendigo_pkt_channels_decode(wendigo_pkt_channels *pkt, const uint8_t *buf, uint16_t len) {
+    if (buf == NULL || len < WENDIGO_PKT_CHANNELS_MIN_LEN ||
+            memcmp(buf, wendigo_pkt_preambles[WENDIGO_PKT_CHANNELS], WENDIGO_PKT_PREAMBLE_LEN)) {
+        return 0;
+    }
+    memset(pkt, 0, sizeof(wendigo_pkt_channels));
+    pkt->count = (uint8_t)buf[WENDIGO_OFFSET_CHANNEL_COUNT];
+    uint32_t offset = WENDIGO_PKT_CHANNELS_FIXED_LEN;
+    uint32_t field_len;
+    field_len = pkt->count;
+    if (offset + field_len + WENDIGO_PKT_PREAMBLE_LEN > len) {
+        return 0;
+    }
+    pkt->channels = (field_len > 0) ? buf + offset : NULL;
+    offset += field_len;
+    if (!wendigo_pkt_is_terminator(buf, len, offset)) {
+        return 0;
+    }
+    return (uint16_t)(offset + WENDIGO_PKT_PREAMBLE_LEN);
+}
+
+static uint32_t wendigo_pkt_channels_frame_len(const uint8_t *buf, uint16_t len) {
+    if (len < WENDIGO_PKT_CHANNELS_FIXED_LEN) {
+        return 0;
+    }
+    uint32_t offset = WENDIGO_PKT_CHANNELS_FIXED_LEN;
+    offset += (uint32_t)buf[WENDIGO_OFFSET_CHANNEL_COUNT];
+    return offset + WENDIGO_PKT_PREAMBLE_LEN;
+}
+
+uint16_t wendigo_pkt_status_size(const wendigo_pkt_status *pkt) {
+    uint32_t size = WENDIGO_PKT_STATUS_FIXED_LEN + WENDIGO_PKT_PREAMBLE_LEN;
+    for (uint32_t i = 0; i < (uint32_t)pkt->attr_count * 2; ++i) {
+        size += 1 + wendigo_pkt_strlen((const char *const *)pkt->attributes, i);
+    }
+    return (size > UINT16_MAX) ? 0 : (uint16_t)size;
+}
+
+uint16_t wendigo_pkt_status_encode(const wendigo_pkt_status *pkt, uint8_t *buf, uint16_t buf_len) {
+    if (!wendigo_pkt_begin(WENDIGO_PKT_STATUS, wendigo_pkt_status_size(pkt), buf, buf_len)) {
+        return 0;
+    }
+    buf[WENDIGO_OFFSET_STATUS_ATTR_COUNT] = (uint8_t)pkt->attr_count;
+    uint16_t offset = WENDIGO_PKT_STATUS_FIXED_LEN;
+    for (uint32_t i = 0; i < (uint32_t)pkt->attr_count * 2; ++i) {
+        uint8_t str_len = wendigo_pkt_strlen((const char *const *)pkt->attributes, i);
+        buf[offset++] = str_len;
+        if (str_len > 0) {
+            memcpy(buf + offset, pkt->attributes[i], str_len);
+            offset += str_len;
+        }
+    }
+    return wendigo_pkt_end(buf, offset);
+}
+
+uint16_t wendigo_pkt_status_decode(wendigo_pkt_status *pkt, const uint8_t *buf, uint16_t len) {
+    if (buf == NULL || len < WENDIGO_PKT_STATUS_MIN_LEN ||
+            memcmp(buf, wendigo_pkt_preambles[WENDIGO_PKT_STATUS], WENDIGO_PKT_PREAMBLE_LEN)) {
+        return 0;
+    }
+    memset(pkt, 0, sizeof(wendigo_pkt_status));
+    pkt->attr_count = (uint8_t)buf[WENDIGO_OFFSET_STATUS_ATTR_COUNT];
+    uint32_t offset = WENDIGO_PKT_STATUS_FIXED_LEN;
+    int32_t attributes_len = wendigo_pkt_strings_len(buf, len, offset, (uint32_t)pkt->attr_count * 2);
+    if (attributes_len < 0) {
+        return 0;
+    }
+    pkt->attributes_raw = buf + offset;
+    pkt->attributes_raw_len = (uint16_t)attributes_len;
+    offset += (uint32_t)attributes_len;
+    if (!wendigo_pkt_is_terminator(buf, len, offset)) {
+        return 0;
+    }
+    return (uint16_t)(offset + WENDIGO_PKT_PREAMBLE_LEN);
+}
+
+static uint32_t wendigo_pkt_status_frame_len(const uint8_t *buf, uint16_t len) {
+    if (len < WENDIGO_PKT_STATUS_FIXED_LEN) {
+        return 0;
+    }
+    uint32_t offset = WENDIGO_PKT_STATUS_FIXED_LEN;
+    for (uint32_t i = (uint32_t)buf[WENDIGO_OFFSET_STATUS_ATTR_COUNT] * 2; i > 0; --i) {
+        if (offset >= len) {
+            return 0;
+        }
+        offset += 1 + (uint32_t)buf[offset];
+    }
+    return offset + WENDIGO_PKT_PREAMBLE_LEN;
+}
+
+uint16_t wendigo_pkt_version_size(const wendigo_pkt_version *pkt) {
+    uint32_t size = WENDIGO_PKT_VERSION_FIXED_LEN + WENDIGO_PKT_PREAMBLE_LEN;
+    size += pkt->version_len;
+    return (size > UINT16_MAX) ? 0 : (uint16_t)size;
+}
+
+uint16_t wendigo_pkt_version_encode(const wendigo_pkt_version *pkt, uint8_t *buf, uint16_t buf_len) {
+    if ((pkt->version_len > 0 && pkt->version == NULL)) {
+        return 0;
+    }
+    if (!wendigo_pkt_begin(WENDIGO_PKT_VERSION, wendigo_pkt_version_size(pkt), buf, buf_len)) {
+        return 0;
+    }
+    uint16_t offset = WENDIGO_PKT_VERSION_FIXED_LEN;
+    if (pkt->version_len > 0) {
+        memcpy(buf + offset, pkt->version, pkt->version_len);
+        offset += pkt->version_len;
+    }
+    return wendigo_pkt_end(buf, offset);
+}
+
+uint16_t wendigo_pkt_version_decode(wendigo_pkt_version *pkt, const uint8_t *buf, uint16_t len) {
+    if (buf == NULL || len < WENDIGO_PKT_VERSION_MIN_LEN ||
+            memcmp(buf, wendigo_pkt_preambles[WENDIGO_PKT_VERSION], WENDIGO_PKT_PREAMBLE_LEN)) {
+        return 0;
+    }
+    memset(pkt, 0, sizeof(wendigo_pkt_version));
+    uint32_t offset = WENDIGO_PKT_VERSION_FIXED_LEN;
+    /* The tail runs to the first terminator - If it reaches another
+     * packet's preamble first, this packet's terminator was lost */
+    uint32_t tail_end = offset;
+    while (tail_end + WENDIGO_PKT_PREAMBLE_LEN <= len &&
+            !wendigo_pkt_is_terminator(buf, len, tail_end) &&
+            wendigo_pkt_identify(buf + tail_end, WENDIGO_PKT_PREAMBLE_LEN) == WENDIGO_PKT_UNKNOWN) {
+        ++tail_end;
+    }
+    pkt->version = buf + offset;
+    pkt->version_len = (uint16_t)(tail_end - offset);
+    offset = tail_end;
+    if (!wendigo_pkt_is_terminator(buf, len, offset)) {
+        return 0;
+    }
+    return (uint16_t)(offset + WENDIGO_PKT_PREAMBLE_LEN);
+}
+
+static uint32_t wendigo_pkt_version_frame_len(const uint8_t *buf, uint16_t len) {
+    if (len < WENDIGO_PKT_VERSION_FIXED_LEN) {
+        return 0;
+    }
+    uint32_t offset = WENDIGO_PKT_VERSION_FIXED_LEN;
+    /* Stopping at a preamble makes the packet fail to decode */
+    while (offset + WENDIGO_PKT_PREAMBLE_LEN <= len &&
+            !wendigo_pkt_is_terminator(buf, len, offset) &&
+            wendigo_pkt_identify(buf + offset, WENDIGO_PKT_PREAMBLE_LEN) == WENDIGO_PKT_UNKNOWN) {
+        ++offset;
+    }
+    if (offset + WENDIGO_PKT_PREAMBLE_LEN > len) {
+        return 0;
+    }
+    return offset + WENDIGO_PKT_PREAMBLE_LEN;
+}
+
+uint16_t wendigo_pkt_mac_size(const wendigo_pkt_mac *pkt) {
+    uint32_t size = WENDIGO_PKT_MAC_FIXED_LEN + WENDIGO_PKT_PREAMBLE_LEN;
+    size += (uint32_t)pkt->if_count * (WENDIGO_PKT_MAC_BYTES + 1);
+    return (size > UINT16_MAX) ? 0 : (uint16_t)size;
+}
+
+uint16_t wendigo_pkt_mac_encode(const wendigo_pkt_mac *pkt, uint8_t *buf, uint16_t buf_len) {
+    if ((pkt->if_count > 0 && pkt->interfaces_types == NULL)) {
+        return 0;
+    }
+    if (!wendigo_pkt_begin(WENDIGO_PKT_MAC, wendigo_pkt_mac_size(pkt), buf, buf_len)) {
+        return 0;
+    }
+    buf[WENDIGO_OFFSET_MAC_IF_COUNT] = (uint8_t)pkt->if_count;
+    uint16_t offset = WENDIGO_PKT_MAC_FIXED_LEN;
+    for (uint16_t i = 0; i < pkt->if_count; ++i) {
+        buf[offset++] = pkt->interfaces_types[i];
+        if (pkt->interfaces == NULL || pkt->interfaces[i] == NULL) {
+            memset(buf + offset, 0, WENDIGO_PKT_MAC_BYTES);
+        } else {
+            memcpy(buf + offset, pkt->interfaces[i], WENDIGO_PKT_MAC_BYTES);
+        }
+        offset += WENDIGO_PKT_MAC_BYTES;
+    }
+    return wendigo_pkt_end(buf, offset);
+}
+
+uint16_t wendigo_pkt_mac_decode(wendigo_pkt_mac *pkt, const uint8_t *buf, uint16_t len) {
+    if (buf == NULL || len < WENDIGO_PKT_MAC_MIN_LEN ||
+            memcmp(buf, wendigo_pkt_preambles[WENDIGO_PKT_MAC], WENDIGO_PKT_PREAMBLE_LEN)) {
+        return 0;
+    }
+    memset(pkt, 0, sizeof(wendigo_pkt_mac));
+    pkt->if_count = (uint8_t)buf[WENDIGO_OFFSET_MAC_IF_COUNT];
+    uint32_t offset = WENDIGO_PKT_MAC_FIXED_LEN;
+    uint32_t field_len;
+    field_len = (uint32_t)pkt->if_count * (WENDIGO_PKT_MAC_BYTES + 1);
+    if (offset + field_len + WENDIGO_PKT_PREAMBLE_LEN > len) {
+        return 0;
+    }
+    pkt->interfaces_raw = buf + offset;
+    offset += field_len;
+    if (!wendigo_pkt_is_terminator(buf, len, offset)) {
+        return 0;
+    }
+    return (uint16_t)(offset + WENDIGO_PKT_PREAMBLE_LEN);
+}
+
+static uint32_t wendigo_pkt_mac_frame_len(const uint8_t *buf, uint16_t len) {
+    if (len < WENDIGO_PKT_MAC_FIXED_LEN) {
+        return 0;
+    }
+    uint32_t offset = WENDIGO_PKT_MAC_FIXED_LEN;
+    offset += (uint32_t)buf[WENDIGO_OFFSET_MAC_IF_COUNT] * (WENDIGO_PKT_MAC_BYTES + 1);
+    return offset + WENDIGO_PKT_PREAMBLE_LEN;
+}
+
+uint16_t wendigo_pkt_bt_services_size(const wendigo_pkt_bt_services *pkt) {
+    uint32_t size = WENDIGO_PKT_BT_SERVICES_FIXED_LEN + WENDIGO_PKT_PREAMBLE_LEN;
+    size += pkt->uuids_len;
+    return (size > UINT16_MAX) ? 0 : (uint16_t)size;
+}
+
+uint16_t wendigo_pkt_bt_services_encode(const wendigo_pkt_bt_services *pkt, uint8_t *buf, uint16_t buf_len) {
+    if ((pkt->uuids_len > 0 && pkt->uuids == NULL)) {
+        return 0;
+    }
+    if (!wendigo_pkt_begin(WENDIGO_PKT_BT_SERVICES, wendigo_pkt_bt_services_size(pkt), buf, buf_len)) {
+        return 0;
+    }
+    memcpy(buf + WENDIGO_OFFSET_BT_SVC_BDA, pkt->bda, WENDIGO_PKT_MAC_BYTES);
+    buf[WENDIGO_OFFSET_BT_SVC_RESULT] = (uint8_t)pkt->result;
+    buf[WENDIGO_OFFSET_BT_SVC_SVC_COUNT] = (uint8_t)pkt->svc_count;
+    wendigo_pkt_put_le(buf + WENDIGO_OFFSET_BT_SVC_UUIDS_LEN, (uint32_t)pkt->uuids_len, 2);
+    uint16_t offset = WENDIGO_PKT_BT_SERVICES_FIXED_LEN;
+    if (pkt->uuids_len > 0) {
+        memcpy(buf + offset, pkt->uuids, pkt->uuids_len);
+        offset += pkt->uuids_len;
+    }
+    return wendigo_pkt_end(buf, offset);
+}
+
+uint16_t wendigo_pkt_bt_services_decode(wendigo_pkt_bt_services *pkt, const uint8_t *buf, uint16_t len) {
+    if (buf == NULL || len < WENDIGO_PKT_BT_SERVICES_MIN_LEN ||
+            memcmp(buf, wendigo_pkt_preambles[WENDIGO_PKT_BT_SERVICES], WENDIGO_PKT_PREAMBLE_LEN)) {
+        return 0;
+    }
+    memset(pkt, 0, sizeof(wendigo_pkt_bt_services));
+    memcpy(pkt->bda, buf + WENDIGO_OFFSET_BT_SVC_BDA, WENDIGO_PKT_MAC_BYTES);
+    pkt->result = (uint8_t)buf[WENDIGO_OFFSET_BT_SVC_RESULT];
+    pkt->svc_count = (uint8_t)buf[WENDIGO_OFFSET_BT_SVC_SVC_COUNT];
+    pkt->uuids_len = (uint16_t)wendigo_pkt_get_le(buf + WENDIGO_OFFSET_BT_SVC_UUIDS_LEN, 2);
+    uint32_t offset = WENDIGO_PKT_BT_SERVICES_FIXED_LEN;
+    uint32_t field_len;
+    field_len = pkt->uuids_len;
+    if (offset + field_len + WENDIGO_PKT_PREAMBLE_LEN > len) {
+        return 0;
+    }
+    pkt->uuids = (field_len > 0) ? buf + offset : NULL;
+    offset += field_len;
+    if (!wendigo_pkt_is_terminator(buf, len, offset)) {
+        return 0;
+    }
+    return (uint16_t)(offset + WENDIGO_PKT_PREAMBLE_LEN);
+}
+
+static uint32_t wendigo_pkt_bt_services_frame_len(const uint8_t *buf, uint16_t len) {
+    if (len < WENDIGO_PKT_BT_SERVICES_FIXED_LEN) {
+        return 0;
+    }
+    uint32_t offset = WENDIGO_PKT_BT_SERVICES_FIXED_LEN;
+    offset += wendigo_pkt_get_le(buf + WENDIGO_OFFSET_BT_SVC_UUIDS_LEN, 2);
+    return offset + WENDIGO_PKT_PREAMBLE_LEN;
+}
+
+uint16_t wendigo_pkt_rssi_size(const wendigo_pkt_rssi *pkt) {
+    (void)pkt; /* Every field is fixed-size */
+    uint32_t size = WENDIGO_PKT_RSSI_FIXED_LEN + WENDIGO_PKT_PREAMBLE_LEN;
+    return (size > UINT16_MAX) ? 0 : (uint16_t)size;
+}
+
+uint16_t wendigo_pkt_rssi_encode(const wendigo_pkt_rssi *pkt, uint8_t *buf, uint16_t buf_len) {
+    if (!wendigo_pkt_begin(WENDIGO_PKT_RSSI, wendigo_pkt_rssi_size(pkt), buf, buf_len)) {
+        return 0;
+    }
+    buf[WENDIGO_OFFSET_RSSI_SLOT] = (uint8_t)pkt->slot;
+    memcpy(buf + WENDIGO_OFFSET_RSSI_MAC, pkt->mac, WENDIGO_PKT_MAC_BYTES);
+    wendigo_pkt_put_le(buf + WENDIGO_OFFSET_RSSI_FILTERED, (uint32_t)pkt->filtered, 2);
+    wendigo_pkt_put_le(buf + WENDIGO_OFFSET_RSSI_RAW, (uint32_t)pkt->raw, 2);
+    wendigo_pkt_put_le(buf + WENDIGO_OFFSET_RSSI_SAMPLES, (uint32_t)pkt->samples, 2);
+    uint16_t offset = WENDIGO_PKT_RSSI_FIXED_LEN;
+    return wendigo_pkt_end(buf, offset);
+}
+
+uint16_t wendigo_pkt_rssi_decode(wendigo_pkt_rssi *pkt, const uint8_t *buf, uint16_t len) {
+    if (buf == NULL || len < WENDIGO_PKT_RSSI_MIN_LEN ||
+            memcmp(buf, wendigo_pkt_preambles[WENDIGO_PKT_RSSI], WENDIGO_PKT_PREAMBLE_LEN)) {
+        return 0;
+    }
+    memset(pkt, 0, sizeof(wendigo_pkt_rssi));
+    pkt->slot = (uint8_t)buf[WENDIGO_OFFSET_RSSI_SLOT];
+    memcpy(pkt->mac, buf + WENDIGO_OFFSET_RSSI_MAC, WENDIGO_PKT_MAC_BYTES);
+    pkt->filtered = (int16_t)wendigo_pkt_get_le(buf + WENDIGO_OFFSET_RSSI_FILTERED, 2);
+    pkt->raw = (int16_t)wendigo_pkt_get_le(buf + WENDIGO_OFFSET_RSSI_RAW, 2);
+    pkt->samples = (uint16_t)wendigo_pkt_get_le(buf + WENDIGO_OFFSET_RSSI_SAMPLES, 2);
+    uint32_t offset = WENDIGO_PKT_RSSI_FIXED_LEN;
+    if (!wendigo_pkt_is_terminator(buf, len, offset)) {
+        return 0;
+    }
+    return (uint16_t)(offset + WENDIGO_PKT_PREAMBLE_LEN);
+}
+
+static uint32_t wendigo_pkt_rssi_frame_len(const uint8_t *buf, uint16_t len) {
+    (void)buf; /* Every field is fixed-size */
+    if (len < WENDIGO_PKT_RSSI_FIXED_LEN) {
+        return 0;
+    }
+    uint32_t offset = WENDIGO_PKT_RSSI_FIXED_LEN;
+    return offset + WENDIGO_PKT_PREAMBLE_LEN;
+}
+
+uint32_t wendigo_pkt_frame_len(wendigo_pkt_type type, const uint8_t *buf, uint16_t len) {
+    if (buf == NULL) {
+        return 0;
+    }
+    switch (type) {
+        case WENDIGO_PKT_BT:
+            return wendigo_pkt_bt_frame_len(buf, len);
+        case WENDIGO_PKT_WIFI_AP:
+            return wendigo_pkt_wifi_ap_frame_len(buf, len);
+        case WENDIGO_PKT_WIFI_STA:
+            return wendigo_pkt_wifi_sta_frame_len(buf, len);
+        case WENDIGO_PKT_CHANNELS:
+            return wendigo_pkt_channels_frame_len(buf, len);
+        case WENDIGO_PKT_STATUS:
+            return wendigo_pkt_status_frame_len(buf, len);
+        case WENDIGO_PKT_VERSION:
+            return wendigo_pkt_version_frame_len(buf, len);
+        case WENDIGO_PKT_MAC:
+            return wendigo_pkt_mac_frame_len(buf, len);
+        case WENDIGO_PKT_BT_SERVICES:
+            return wendigo_pkt_bt_services_frame_len(buf, len);
+        case WENDIGO_PKT_RSSI:
+            return wendigo_pkt_rssi_frame_len(buf, len);
+        default:
+            return 0;
+    }
+}
@@ -0,0 +1,372 @@
+/* Generated from protocol/wendigo_packets.schema by protocol/generate_packets.py.
+ * DO NOT EDIT - Change the schema and regenerate. */
+
+#ifndef WENDIGO_PACKETS_H
+#define WENDIGO_PACKETS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Each packet is a preamble identifying its type, a number of fixed-size
+ * fields at the offsets defined below (offset 0 is the first byte of the
+ * preamble), then any variable-length fields and the packet terminator.
+ * Multi-byte integers are little-endian.
+ *
+ * wendigo_pkt_<name>_encode() writes a packet into a caller-supplied buffer
+ * and wendigo_pkt_<name>_decode() validates a packet and fills a
+ * wendigo_pkt_<name> that points into it. Neither allocates memory, and
+ * decode never reads outside the buffer it's given.
+ *
+ * Variable-length fields are represented in wendigo_pkt_<name> as:
+ * * bytes - a pointer to <len field> bytes;
+ * * macs - encode from an array of MAC pointers (NULL entries, or a NULL
+ *   array, are sent as 00:00:00:00:00:00); decode to <name>_raw, which points
+ *   to <count field> contiguous MACs;
+ * * typed_macs - encode from <name>_types and <name>; decode to <name>_raw,
+ *   read with wendigo_pkt_typed_mac_at();
+ * * strings - encode from an array of NULL-terminated strings (NULL entries
+ *   are sent as empty strings, longer strings are truncated to
+ *   WENDIGO_PKT_STRING_MAX bytes); decode to <name>_raw and <name>_raw_len,
+ *   read with wendigo_pkt_next_string();
+ * * tail - a pointer and length, for both encode and decode.
+ */
+
+#define WENDIGO_PKT_PREAMBLE_LEN    (4)
+#define WENDIGO_PKT_MAC_BYTES       (6)
+#define WENDIGO_PKT_STRING_MAX      (255)
+#define WENDIGO_PKT_TERMINATOR_INIT {0xAA, 0xBB, 0xCC, 0xDD}
+
+/* Preambles - Use these to initialise byte arrays */
+#define WENDIGO_PREAMBLE_BT_BLE_INIT   {0xFF, 0xFE, 0xFD, 0xFC}
+#define WENDIGO_PREAMBLE_WIFI_AP_INIT  {0x99, 0x98, 0x97, 0x96}
+#define WENDIGO_PREAMBLE_WIFI_STA_INIT {0x88, 0x87, 0x86, 0x85}
+#define WENDIGO_PREAMBLE_CHANNELS_INIT {0x77, 0x76, 0x75, 0x74}
+#define WENDIGO_PREAMBLE_STATUS_INIT   {0x66, 0x65, 0x64, 0x63}
+#define WENDIGO_PREAMBLE_VER_INIT      {0x57, 0x65, 0x6E, 0x64}
+#define WENDIGO_PREAMBLE_MAC_INIT      {0x55, 0x54, 0x53, 0x52}
+#define WENDIGO_PREAMBLE_BT_SVC_INIT   {0x44, 0x43, 0x42, 0x41}
+#define WENDIGO_PREAMBLE_RSSI_INIT     {0x33, 0x32, 0x31, 0x30}
+
+/* bt packet offsets */
+#define WENDIGO_OFFSET_BT_BDNAME_LEN             (4)
+#define WENDIGO_OFFSET_BT_EIR_LEN                (5)
+#define WENDIGO_OFFSET_BT_RSSI                   (6)
+#define WENDIGO_OFFSET_BT_COD                    (8)
+#define WENDIGO_OFFSET_BT_BDA                    (12)
+#define WENDIGO_OFFSET_BT_SCANTYPE               (18)
+#define WENDIGO_OFFSET_BT_TAGGED                 (19)
+#define WENDIGO_OFFSET_BT_LASTSEEN               (20)
+#define WENDIGO_OFFSET_BT_NUM_SERVICES           (39)
+#define WENDIGO_OFFSET_BT_KNOWN_SERVICES_LEN     (40)
+#define WENDIGO_OFFSET_BT_BDNAME                 (41)
+#define WENDIGO_PKT_BT_FIXED_LEN                 (41)
+/* Shortest possible bt packet, including the terminator */
+#define WENDIGO_PKT_BT_MIN_LEN                   (45)
+
+/* wifi_ap packet offsets */
+#define WENDIGO_OFFSET_WIFI_SCANTYPE             (4)
+#define WENDIGO_OFFSET_WIFI_MAC                  (5)
+#define WENDIGO_OFFSET_WIFI_CHANNEL              (11)
+#define WENDIGO_OFFSET_WIFI_RSSI                 (12)
+#define WENDIGO_OFFSET_WIFI_LASTSEEN             (14)
+#define WENDIGO_OFFSET_WIFI_TAGGED               (33)
+#define WENDIGO_OFFSET_AP_AUTH_MODE              (34)
+#define WENDIGO_OFFSET_AP_SSID_LEN               (35)
+#define WENDIGO_OFFSET_AP_STA_COUNT              (36)
+#define WENDIGO_OFFSET_AP_SSID                   (37)
+#define WENDIGO_PKT_WIFI_AP_FIXED_LEN            (37)
+/* Shortest possible wifi_ap packet, including the terminator */
+#define WENDIGO_PKT_WIFI_AP_MIN_LEN              (41)
+
+/* wifi_sta packet offsets */
+#define WENDIGO_OFFSET_STA_PNL_COUNT             (34)
+#define WENDIGO_OFFSET_STA_AP_MAC                (35)
+#define WENDIGO_OFFSET_STA_AP_SSID_LEN           (41)
+#define WENDIGO_OFFSET_STA_AP_SSID               (42)
+#define WENDIGO_PKT_WIFI_STA_FIXED_LEN           (42)
+/* Shortest possible wifi_sta packet, including the terminator */
+#define WENDIGO_PKT_WIFI_STA_MIN_LEN             (46)
+
+/* channels packet offsets */
+#define WENDIGO_OFFSET_CHANNEL_COUNT             (4)
+#define WENDIGO_OFFSET_CHANNELS                  (5)
+#define WENDIGO_PKT_CHANNELS_FIXED_LEN           (5)
+/* Shortest possible channels packet, including the terminator */
+#define WENDIGO_PKT_CHANNELS_MIN_LEN             (9)
+
+/* status packet offsets */
+#define WENDIGO_OFFSET_STATUS_ATTR_COUNT         (4)
+#define WENDIGO_OFFSET_STATUS_ATTRIBUTES         (5)
+#define WENDIGO_PKT_STATUS_FIXED_LEN             (5)
+/* Shortest possible status packet, including the terminator */
+#define WENDIGO_PKT_STATUS_MIN_LEN               (9)
+
+/* version packet offsets */
+#define WENDIGO_OFFSET_VER_VERSION               (4)
+#define WENDIGO_PKT_VERSION_FIXED_LEN            (4)
+/* Shortest possible version packet, including the terminator */
+#define WENDIGO_PKT_VERSION_MIN_LEN              (8)
+
+/* mac packet offsets */
+#define WENDIGO_OFFSET_MAC_IF_COUNT              (4)
+#define WENDIGO_OFFSET_MAC_INTERFACES            (5)
+#define WENDIGO_PKT_MAC_FIXED_LEN                (5)
+/* Shortest possible mac packet, including the terminator */
+#define WENDIGO_PKT_MAC_MIN_LEN                  (9)
+
+/* bt_services packet offsets */
+#define WENDIGO_OFFSET_BT_SVC_BDA                (4)
+#define WENDIGO_OFFSET_BT_SVC_RESULT             (10)
+#define WENDIGO_OFFSET_BT_SVC_SVC_COUNT          (11)
+#define WENDIGO_OFFSET_BT_SVC_UUIDS_LEN          (12)
+#define WENDIGO_OFFSET_BT_SVC_UUIDS              (14)
+#define WENDIGO_PKT_BT_SERVICES_FIXED_LEN        (14)
+/* Shortest possible bt_services packet, including the terminator */
+#define WENDIGO_PKT_BT_SERVICES_MIN_LEN          (18)
+
+/* rssi packet offsets */
+#define WENDIGO_OFFSET_RSSI_SLOT                 (4)
+#define WENDIGO_OFFSET_RSSI_MAC                  (5)
+#define WENDIGO_OFFSET_RSSI_FILTERED             (11)
+#define WENDIGO_OFFSET_RSSI_RAW                  (13)
+#define WENDIGO_OFFSET_RSSI_SAMPLES              (15)
+#define WENDIGO_PKT_RSSI_FIXED_LEN               (17)
+/* Shortest possible rssi packet, including the terminator */
+#define WENDIGO_PKT_RSSI_MIN_LEN                 (21)
+
+typedef enum {
+    WENDIGO_PKT_BT,
+    WENDIGO_PKT_WIFI_AP,
+    WENDIGO_PKT_WIFI_STA,
+    WENDIGO_PKT_CHANNELS,
+    WENDIGO_PKT_STATUS,
+    WENDIGO_PKT_VERSION,
+    WENDIGO_PKT_MAC,
+    WENDIGO_PKT_BT_SERVICES,
+    WENDIGO_PKT_RSSI,
+    WENDIGO_PKT_TYPE_COUNT,
+    WENDIGO_PKT_UNKNOWN = WENDIGO_PKT_TYPE_COUNT
+} wendigo_pkt_type;
+
+typedef struct wendigo_pkt_bt {
+    uint8_t bdname_len;
+    uint8_t eir_len;
+    int16_t rssi;
+    uint32_t cod; /* Class of Device, decoded by wendigo_cod_*() */
+    uint8_t bda[WENDIGO_PKT_MAC_BYTES];
+    uint8_t scantype; /* SCAN_HCI or SCAN_BLE */
+    uint8_t tagged; /* 1 if tagged, 0 otherwise */
+    uint8_t num_services;
+    uint8_t known_services_len;
+    const uint8_t *bdname; /* bdname_len bytes - Not NULL-terminated */
+    const uint8_t *eir; /* eir_len bytes */
+} wendigo_pkt_bt;
+
+typedef struct wendigo_pkt_wifi_ap {
+    uint8_t scantype; /* SCAN_WIFI_AP */
+    uint8_t mac[WENDIGO_PKT_MAC_BYTES];
+    uint8_t channel;
+    int16_t rssi;
+    uint8_t tagged; /* 1 if tagged, 0 otherwise */
+    uint8_t auth_mode; /* wifi_auth_mode_t */
+    uint8_t ssid_len;
+    uint8_t sta_count;
+    const uint8_t *ssid; /* ssid_len bytes - Not NULL-terminated */
+    uint8_t *const *stations; /* Encode: sta_count MACs */
+    const uint8_t *stations_raw; /* Decode: sta_count contiguous MACs */
+} wendigo_pkt_wifi_ap;
+
+typedef struct wendigo_pkt_wifi_sta {
+    uint8_t scantype; /* SCAN_WIFI_STA */
+    uint8_t mac[WENDIGO_PKT_MAC_BYTES];
+    uint8_t channel;
+    int16_t rssi;
+    uint8_t tagged; /* 1 if tagged, 0 otherwise */
+    uint8_t pnl_count; /* Preferred Network List (saved networks) count */
+    uint8_t ap_mac[WENDIGO_PKT_MAC_BYTES];
+    uint8_t ap_ssid_len;
+    const uint8_t *ap_ssid; /* ap_ssid_len bytes - Not NULL-terminated */
+    char *const *pnl; /* Encode: pnl_count strings - Preferred Network List SSIDs */
+    const uint8_t *pnl_raw; /* Decode: pnl_count length-prefixed strings */
+    uint16_t pnl_raw_len;
+} wendigo_pkt_wifi_sta;
+
+typedef struct wendigo_pkt_channels {
+    uint8_t count;
+    const uint8_t *channels; /* count bytes - One byte per enabled channel */
+} wendigo_pkt_channels;
+
+typedef struct wendigo_pkt_status {
+    uint8_t attr_count;
+    char *const *attributes; /* Encode: attr_count * 2 strings - Alternating attribute name and value */
+    const uint8_t *attributes_raw; /* Decode: attr_count * 2 length-prefixed strings */
+    uint16_t attributes_raw_len;
+} wendigo_pkt_status;
+
+typedef struct wendigo_pkt_version {
+    const uint8_t *version; /* For example "igo v0.5.0" */
+    uint16_t version_len;
+} wendigo_pkt_version;
+
+typedef struct wendigo_pkt_mac {
+    uint8_t if_count;
+    const uint8_t *interfaces_types; /* Encode: if_count types - Type is a WendigoMAC */
+    uint8_t *const *interfaces; /* Encode: if_count MACs */
+    const uint8_t *interfaces_raw; /* Decode: if_count type and MAC pairs */
+} wendigo_pkt_mac;
+
+typedef struct wendigo_pkt_bt_services {
+    uint8_t bda[WENDIGO_PKT_MAC_BYTES];
+    uint8_t result; /* WendigoGattResult */
+    uint8_t svc_count; /* Number of services in uuids */
+    uint16_t uuids_len;
+    const uint8_t *uuids; /* uuids_len bytes - Each a 1-byte UUID length (2, 4 or 16) then the UUID, little-endian */
+} wendigo_pkt_bt_services;
+
+typedef struct wendigo_pkt_rssi {
+    uint8_t slot; /* Index of the device in ESP32-Wendigo's tracking table */
+    uint8_t mac[WENDIGO_PKT_MAC_BYTES];
+    int16_t filtered; /* Smoothed RSSI in tenths of a dBm */
+    int16_t raw; /* Latest RSSI in dBm */
+    uint16_t samples; /* Samples since the previous frame */
+} wendigo_pkt_rssi;
+
+/** Identify the packet at the start of `buf` from its preamble.
+ * Returns WENDIGO_PKT_UNKNOWN if there is no valid preamble. */
+wendigo_pkt_type wendigo_pkt_identify(const uint8_t *buf, uint16_t len);
+
+/** Get the name of a packet type, for logging */
+const char *wendigo_pkt_type_name(wendigo_pkt_type type);
+
+/** Does `buf` contain the packet terminator at `offset`? */
+bool wendigo_pkt_is_terminator(const uint8_t *buf, uint16_t len, uint32_t offset);
+
+/** Read the next string from a decoded strings field. `cursor` starts at
+ * <name>_raw and is advanced past the string; `end` is <name>_raw +
+ * <name>_raw_len. Returns false when there are no more strings. The string
+ * is not NULL-terminated. */
+bool wendigo_pkt_next_string(const uint8_t **cursor, const uint8_t *end,
+    const uint8_t **str, uint8_t *str_len);
+
+/** Get the MAC at `index` of a decoded typed_macs field, and its type */
+const uint8_t *wendigo_pkt_typed_mac_at(const uint8_t *raw, uint16_t index, uint8_t *type);
+
+/** Get the MAC at `index` of a decoded macs field */
+#define WENDIGO_PKT_MAC_AT(raw, index) ((raw) + ((index) * WENDIGO_PKT_MAC_BYTES))
+
+/** Length of the `type` packet at the start of `buf`, including its
+ * terminator, worked out from its length and count fields. Returns 0 if the
+ * first `len` bytes aren't enough to tell. This is for finding packet
+ * boundaries in a stream - it doesn't validate the packet. */
+uint32_t wendigo_pkt_frame_len(wendigo_pkt_type type, const uint8_t *buf, uint16_t len);
+
+/** Encoded size of `pkt`, including preamble and terminator - 0 if it's
+ * too large to send */
+uint16_t wendigo_pkt_bt_size(const wendigo_pkt_bt *pkt);
+/** Encode `pkt` into `buf`. Returns the number of bytes written, or 0 if
+ * `buf_len` is too small or a variable-length field is missing */
+uint16_t wendigo_pkt_bt_encode(const wendigo_pkt_bt *pkt, uint8_t *buf, uint16_t buf_len);
+/** Validate the bt packet at the start of `buf` and fill `pkt`, which
+ * points into `buf`. Returns the length of the packet, including its
+ * terminator, or 0 if the packet is malformed */
+uint16_t wendigo_pkt_bt_decode(wendigo_pkt_bt *pkt, const uint8_t *buf, uint16_t len);
+
+/** Encoded size of `pkt`, including preamble and terminator - 0 if it's
+ * too large to send */
+uint16_t wendigo_pkt_wifi_ap_size(const wendigo_pkt_wifi_ap *pkt);
+/** Encode `pkt` into `buf`. Returns the number of bytes written, or 0 if
+ * `buf_len` is too small or a variable-length field is missing */
+uint16_t wendigo_pkt_wifi_ap_encode(const wendigo_pkt_wifi_ap *pkt, uint8_t *buf, uint16_t buf_len);
+/** Validate the wifi_ap packet at the start of `buf` and fill `pkt`, which
+ * points into `buf`. Returns the length of the packet, including its
+ * terminator, or 0 if the packet is malformed */
+uint16_t wendigo_pkt_wifi_ap_decode(wendigo_pkt_wifi_ap *pkt, const uint8_t *buf, uint16_t len);
+
+/** Encoded size of `pkt`, including preamble and terminator - 0 if it's
+ * too large to send */
+uint16_t wendigo_pkt_wifi_sta_size(const wendigo_pkt_wifi_sta *pkt);
+/** Encode `pkt` into `buf`. Returns the number of bytes written, or 0 if
+ * `buf_len` is too small or a variable-length field is missing */
+uint16_t wendigo_pkt_wifi_sta_encode(const wendigo_pkt_wifi_sta *pkt, uint8_t *buf, uint16_t buf_len);
+/** Validate the wifi_sta packet at the start of `buf` and fill `pkt`, which
+ * points into `buf`. Returns the length of the packet, including its
+ * terminator, or 0 if the packet is malformed */
+uint16_t wendigo_pkt_wifi_sta_decode(wendigo_pkt_wifi_sta *pkt, const uint8_t *buf, uint16_t len);
+
+/** Encoded size of `pkt`, including preamble and terminator - 0 if it's
+ * too large to send */
+uint16_t wendigo_pkt_channels_size(const wendigo_pkt_channels *pkt);
+/** Encode `pkt` into `buf`. Returns the number of bytes written, or 0 if
+ * `buf_len` is too small or a variable-length field is missing */
+uint16_t wendigo_pkt_channels_encode(const wendigo_pkt_channels *pkt, uint8_t *buf, uint16_t buf_len);
+/** Validate the channels packet at the start of `buf` and fill `pkt`, which
+ * points into `buf`. Returns the length of the packet, including its
+ * terminator, or 0 if the packet is malformed */
+uint16_t wendigo_pkt_channels_decode(wendigo_pkt_channels *pkt, const uint8_t *buf, uint16_t len);
+
+/** Encoded size of `pkt`, including preamble and terminator - 0 if it's
+ * too large to send */
+uint16_t wendigo_pkt_status_size(const wendigo_pkt_status *pkt);
+/** Encode `pkt` into `buf`. Returns the number of bytes written, or 0 if
+ * `buf_len` is too small or a variable-length field is missing */
+uint16_t wendigo_pkt_status_encode(const wendigo_pkt_status *pkt, uint8_t *buf, uint16_t buf_len);
+/** Validate the status packet at the start of `buf` and fill `pkt`, which
+ * points into `buf`. Returns the length of the packet, including its
+ * terminator, or 0 if the packet is malformed */
+uint16_t wendigo_pkt_status_decode(wendigo_pkt_status *pkt, const uint8_t *buf, uint16_t len);
+
+/** Encoded size of `pkt`, including preamble and terminator - 0 if it's
+ * too large to send */
+uint16_t wendigo_pkt_version_size(const wendigo_pkt_version *pkt);
+/** Encode `pkt` into `buf`. Returns the number of bytes written, or 0 if
+ * `buf_len` is too small or a variable-length field is missing */
+uint16_t wendigo_pkt_version_encode(const wendigo_pkt_version *pkt, uint8_t *buf, uint16_t buf_len);
+/** Validate the version packet at the start of `buf` and fill `pkt`, which
+ * points into `buf`. Returns the length of the packet, including its
+ * terminator, or 0 if the packet is malformed */
+uint16_t wendigo_pkt_version_decode(wendigo_pkt_version *pkt, const uint8_t *buf, uint16_t len);
+
+/** Encoded size of `pkt`, including preamble and terminator - 0 if it's
+ * too large to send */
+uint16_t wendigo_pkt_mac_size(const wendigo_pkt_mac *pkt);
+/** Encode `pkt` into `buf`. Returns the number of bytes written, or 0 if
+ * `buf_len` is too small or a variable-length field is missing */
+uint16_t wendigo_pkt_mac_encode(const wendigo_pkt_mac *pkt, uint8_t *buf, uint16_t buf_len);
+/** Validate the mac packet at the start of `buf` and fill `pkt`, which
+ * points into `buf`. Returns the length of the packet, including its
+ * terminator, or 0 if the packet is malformed */
+uint16_t wendigo_pkt_mac_decode(wendigo_pkt_mac *pkt, const uint8_t *buf, uint16_t len);
+
+/** Encoded size of `pkt`, including preamble and terminator - 0 if it's
+ * too large to send */
+uint16_t wendigo_pkt_bt_services_size(const wendigo_pkt_bt_services *pkt);
+/** Encode `pkt` into `buf`. Returns the number of bytes written, or 0 if
+ * `buf_len` is too small or a variable-length field is missing */
+uint16_t wendigo_pkt_bt_services_encode(const wendigo_pkt_bt_services *pkt, uint8_t *buf, uint16_t buf_len);
+/** Validate the bt_services packet at the start of `buf` and fill `pkt`, which
+ * points into `buf`. Returns the length of the packet, including its
+ * terminator, or 0 if the packet is malformed */
+uint16_t wendigo_pkt_bt_services_decode(wendigo_pkt_bt_services *pkt, const uint8_t *buf, uint16_t len);
+
+/** Encoded size of `pkt`, including preamble and terminator - 0 if it's
+ * too large to send */
+uint16_t wendigo_pkt_rssi_size(const wendigo_pkt_rssi *pkt);
+/** Encode `pkt` into `buf`. Returns the number of bytes written, or 0 if
+ * `buf_len` is too small or a variable-length field is missing */
+uint16_t wendigo_pkt_rssi_encode(const wendigo_pkt_rssi *pkt, uint8_t *buf, uint16_t buf_len);
+/** Validate the rssi packet at the start of `buf` and fill `pkt`, which
+ * points into `buf`. Returns the length of the packet, including its
+ * terminator, or 0 if the packet is malformed */
+uint16_t wendigo_pkt_rssi_decode(wendigo_pkt_rssi *pkt, const uint8_t *buf, uint16_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
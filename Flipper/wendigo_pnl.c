@@ -1,5 +1,6 @@
 #include "wendigo_app_i.h"
 #include "wendigo_scan.h"
+#include "wendigo_hash.h"
 #include "wendigo_pnl.h"
 
 /* PNL cache */
@@ -7,6 +8,77 @@ PreferredNetwork *networks = NULL;
 uint16_t networks_count = 0;
 uint16_t networks_capacity = 0;
 
+/* SSID hash index (see wendigo_hash.h) - Table of (index into networks[] + 1),
+   with 0 marking an empty slot */
+static uint16_t *pnl_index = NULL;
+static uint16_t pnl_index_capacity = 0;
+/* After pnl_index[] couldn't be grown, don't try again until networks_count
+   reaches this */
+static uint16_t pnl_index_retry_at = 0;
+
+/* Minimum capacity of networks[] and pnl_index[] */
+#define PNL_MIN_NETWORKS_CAPACITY 16
+/* PreferredNetwork.devices[] grows by this many elements at a time */
+#define PNL_DEVICES_CHUNK 8
+
+/** Add networks[idx] to pnl_index[]. pnl_index[] must have a free slot. */
+static void pnl_index_insert(uint16_t idx) {
+    uint16_t mask = pnl_index_capacity - 1;
+    uint16_t slot = wendigo_hash_ssid(networks[idx].ssid) & mask;
+    while (pnl_index[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    pnl_index[slot] = idx + 1;
+}
+
+/** Replace pnl_index[] with one of `capacity` slots and index networks[] into
+ * it. Returns false, leaving pnl_index[] as it was, if memory could not be
+ * allocated.
+ */
+static bool pnl_index_grow(uint16_t capacity) {
+    uint16_t *new_index = calloc(capacity, sizeof(uint16_t));
+    if (new_index == NULL) {
+        return false;
+    }
+    if (pnl_index != NULL) {
+        free(pnl_index);
+    }
+    pnl_index = new_index;
+    pnl_index_capacity = capacity;
+    for (uint16_t i = 0; i < networks_count; ++i) {
+        pnl_index_insert(i);
+    }
+    return true;
+}
+
+/** Index networks[idx], which has just been added to the end of networks[],
+ * growing pnl_index[] first if it needs to be. Without an index at all
+ * index_of_pnl() falls back to a linear search.
+ */
+static void pnl_index_add(uint16_t idx) {
+    uint16_t new_capacity = wendigo_index_grow_capacity(networks_count, pnl_index_capacity,
+        PNL_MIN_NETWORKS_CAPACITY * 2, pnl_index_retry_at);
+    if (new_capacity != 0) {
+        if (pnl_index_grow(new_capacity)) {
+            /* Growing the index re-indexes everything, including networks[idx] */
+            return;
+        }
+        pnl_index_retry_at = wendigo_index_retry_at(networks_count);
+        wendigo_log(MSG_WARN, "Unable to grow PNL index, SSID lookups will be slower.");
+    }
+    if (pnl_index == NULL) {
+        return;
+    }
+    if (networks_count < pnl_index_capacity) {
+        pnl_index_insert(idx);
+    } else {
+        /* Full, and can't be grown - Fall back to a linear search */
+        free(pnl_index);
+        pnl_index = NULL;
+        pnl_index_capacity = 0;
+    }
+}
+
 /** Search networks[] for a PreferredNetwork with the specified SSID.
  * Returns the index of the PreferredNetwork, or networks_count if not
  * found.
@@ -19,11 +91,16 @@ uint16_t index_of_pnl(char *ssid) {
         return networks_count;
     }
     uint16_t idx;
-    uint8_t compareLen = MAX_SSID_LEN;
-    if (strlen(ssid) < compareLen) {
-        compareLen = strlen(ssid);
+    if (pnl_index != NULL) {
+        uint16_t mask = pnl_index_capacity - 1;
+        uint16_t slot = wendigo_hash_ssid(ssid) & mask;
+        for (; pnl_index[slot] != 0 &&
+                strncmp(ssid, networks[pnl_index[slot] - 1].ssid, MAX_SSID_LEN);
+                slot = (slot + 1) & mask) { }
+        idx = (pnl_index[slot] == 0) ? networks_count : pnl_index[slot] - 1;
+    } else {
+        for (idx = 0; idx < networks_count && strncmp(ssid, networks[idx].ssid, MAX_SSID_LEN); ++idx) { }
     }
-    for (idx = 0; idx < networks_count && strncmp(ssid, networks[idx].ssid, compareLen); ++idx) { }
     FURI_LOG_T(WENDIGO_TAG, "End index_of_pnl()");
     return idx;
 }
@@ -64,6 +141,9 @@ uint8_t count_networks_for_device(wendigo_device *dev) {
 /** Process the device cache (devices[]) and generate PreferredNetwork instances
  * that map all identified networks to the wendigo_device instances that have
  * probed for them.
+ * networks[] is maintained incrementally by wendigo_add_device() and
+ * wendigo_update_device(), so this function only needs to do any work if
+ * networks[] has been discarded while devices[] still holds STAs.
  * networks[] and networks_count are updated by this function.
  * Returns the number of associated networks.
  */
@@ -78,98 +158,18 @@ uint16_t map_ssids_to_devices(WendigoApp *app) {
         FURI_LOG_T(WENDIGO_TAG, "End map_ssids_to_devices() - Invalid arguments.");
         return 0;
     }
-
-    uint8_t this_count;
-    PreferredNetwork *new_networks;
-    furi_mutex_acquire(app->pnlMutex, FuriWaitForever);
-    /* Loop over each device */
+    PNL_Result res;
     for (uint16_t i = 0; i < devices_count; ++i) {
-        if (devices == NULL || devices[i] == NULL || devices[i]->scanType != SCAN_WIFI_STA ||
+        if (devices[i] == NULL || devices[i]->scanType != SCAN_WIFI_STA ||
                 devices[i]->radio.sta.saved_networks == NULL) {
-            this_count = 0;
-        } else {
-            this_count = devices[i]->radio.sta.saved_networks_count;
+            continue;
         }
-        /* Make sure networks[] is large enough to include this_count additional nets */
-        if (networks_count + this_count > networks_capacity) {
-            new_networks = realloc(networks, sizeof(PreferredNetwork) * (networks_count + this_count));
-            if (new_networks == NULL) {
-                /* Too annoying to continue on - log and alert error, then clean up and exit */
-                furi_mutex_release(app->pnlMutex);
-                wendigo_log(MSG_ERROR, "Unable to allocate PreferredNetwork elements.");
-                wendigo_display_popup(app, "Insufficient memory", "Unable to allocate PreferredNetwork elements.");
-                FURI_LOG_T(WENDIGO_TAG, "End map_ssids_to_devices() - Unable to resize networks[].");
-                return 0;
-            }
-            /* Zero out newly-allocated space to initialise new PreferredNetwork elements
-             * (NULL ssid[] and devices[], 0 device_count). */
-            bzero(new_networks + (networks_count * sizeof(PreferredNetwork)), this_count * sizeof(PreferredNetwork));
-            networks_capacity = networks_count + this_count;
-            networks = new_networks;
-        }
-        /* Check each saved network for devices[i] */
-        for (uint8_t j = 0; j < this_count; ++j) {
-            new_networks = pnl_for_ssid(devices[i]->radio.sta.saved_networks[j]);
-            if (new_networks == NULL) {
-                strncpy(networks[networks_count].ssid, devices[i]->radio.sta.saved_networks[j],
-                    strlen(devices[i]->radio.sta.saved_networks[j]));
-                networks[networks_count].device_count = 0;
-                networks[networks_count].devices = NULL;
-                new_networks = &(networks[networks_count++]);
-            }
-            /* Is devices[i] in new_networks->devices[]? */
-            uint8_t devIdx;
-            for (devIdx = 0; devIdx < new_networks->device_count &&
-                new_networks->devices[devIdx] != devices[i];
-                ++devIdx) { }
-            if (devIdx == new_networks->device_count) {
-                /* Append devices[i] to new_networks->devices[] */
-                wendigo_device **new_devices = realloc(new_networks->devices,
-                    sizeof(wendigo_device *) * (new_networks->device_count + 1));
-                if (new_devices == NULL) {
-                    char *msg = malloc(sizeof(char) * (85 + MAX_SSID_LEN + MAC_STRLEN));
-                    if (msg == NULL) {
-                        wendigo_log(MSG_ERROR, "Unable to allocate memory to store an additional device in a PreferredNetwork.");
-                    } else {
-                        char *staMac = malloc(sizeof(char) * (MAC_STRLEN + 1));
-                        if (staMac == NULL) {
-                            snprintf(msg, 85 + MAX_SSID_LEN + MAC_STRLEN,
-                                "Unable to allocate an additional %d bytes to %s's PreferredNetwork element.",
-                                sizeof(wendigo_device *), new_networks->ssid);
-                        } else {
-                            bytes_to_string(devices[i]->mac, MAC_BYTES, staMac);
-                            snprintf(msg, 85 + MAX_SSID_LEN + MAC_STRLEN,
-                                "Unable to allocate an additional %d bytes to %s's PreferredNetwork element for STA %s.",
-                                sizeof(wendigo_device *), new_networks->ssid, staMac);
-                            free(staMac);
-                        }
-                        wendigo_log(MSG_ERROR, msg);
-                        free(msg);
-                    }
-                } else {
-                    /* Append devices[i] */
-                    new_devices[new_networks->device_count++] = devices[i];
-                    new_networks->devices = new_devices;
-                }
-            }
+        for (uint8_t j = 0; j < devices[i]->radio.sta.saved_networks_count; ++j) {
+            res = pnl_find_or_create_device(app, devices[i]->radio.sta.saved_networks[j], devices[i]);
+            pnl_log_result("map_ssids_to_devices()", res,
+                devices[i]->radio.sta.saved_networks[j], devices[i]);
         }
     }
-    if (networks_capacity > networks_count) {
-        new_networks = realloc(networks, sizeof(PreferredNetwork) * networks_count);
-        if (new_networks == NULL) {
-            /* This condition will (should) never be true */
-            wendigo_log(MSG_ERROR, "Unable to shrink networks[] to remove spare capacity.");
-            /* Don't fret too much */
-        } else {
-            networks_capacity = networks_count;
-            networks = new_networks;
-        }
-    }
-    furi_mutex_release(app->pnlMutex);
-    if (app->current_view == WendigoAppViewVarItemList) {
-        /* Set/Refresh the SSID count on the main menu */
-        view_dispatcher_send_custom_event(app->view_dispatcher, Wendigo_EventRefreshPNLCount);
-    }
     FURI_LOG_T(WENDIGO_TAG, "End map_ssids_to_devices()");
     return networks_count;
 }
@@ -258,8 +258,15 @@ PreferredNetwork *fetch_or_create_pnl(char *ssid, PNL_Result *result) {
     if (idx == networks_count) {
         /* Not found - Create a new PreferredNetwork */
         if (networks_count == networks_capacity) {
-            /* No spare capacity - Extend networks[] */
-            pnl = realloc(networks, sizeof(PreferredNetwork) * (networks_count + 1));
+            /* No spare capacity - Double the capacity of networks[] */
+            uint16_t new_capacity = (networks_capacity < PNL_MIN_NETWORKS_CAPACITY) ?
+                PNL_MIN_NETWORKS_CAPACITY : networks_capacity * 2;
+            if (new_capacity < networks_capacity) {
+                /* uint16_t overflow - Fall back to the largest capacity possible */
+                new_capacity = UINT16_MAX;
+            }
+            pnl = (new_capacity == networks_capacity) ? NULL :
+                realloc(networks, sizeof(PreferredNetwork) * new_capacity);
             if (pnl == NULL) {
                 if (result != NULL) {
                     *result = PNL_FAILED;
@@ -271,24 +278,24 @@ PreferredNetwork *fetch_or_create_pnl(char *ssid, PNL_Result *result) {
                 } else {
                     snprintf(msg, 82 + MAX_SSID_LEN,
                         "wendigo_add_device(): Failed to increase networks[] to %d bytes, skipping PNL %s.",
-                        sizeof(PreferredNetwork) * (networks_count + 1), ssid);
+                        sizeof(PreferredNetwork) * new_capacity, ssid);
                     wendigo_log(MSG_ERROR, msg);
                     free(msg);
                 }
             } else {
-                /* Allocated successfully */
-                if (result != NULL) {
-                    *result = PNL_CREATED;
-                }
                 networks = pnl;
-                ++networks_capacity;
+                networks_capacity = new_capacity;
             }
         }
         if (networks_count < networks_capacity) {
             /* Allocated successfully or had spare capacity - Initialise */
-            bzero(networks + (sizeof(PreferredNetwork) * networks_count), sizeof(PreferredNetwork));
+            if (result != NULL) {
+                *result = PNL_CREATED;
+            }
+            bzero(&(networks[networks_count]), sizeof(PreferredNetwork));
             idx = networks_count++;
-            strncpy(networks[idx].ssid, ssid, strlen(ssid));
+            strncpy(networks[idx].ssid, ssid, MAX_SSID_LEN);
+            pnl_index_add(idx);
         }
     } else {
         if (result != NULL) {
@@ -306,13 +313,17 @@ PreferredNetwork *fetch_or_create_pnl(char *ssid, PNL_Result *result) {
 /** Search the specified PreferredNetwork for a device containing the
  * specified MAC. Returns pnl->device_count if not found.
  */
-uint8_t pnl_index_of_mac(PreferredNetwork *pnl, uint8_t mac[MAC_BYTES]) {
+uint16_t pnl_index_of_mac(PreferredNetwork *pnl, uint8_t mac[MAC_BYTES]) {
     FURI_LOG_T(WENDIGO_TAG, "Start pnl_index_of_mac()");
-    if (pnl == NULL || pnl->devices == NULL) {
+    if (pnl == NULL) {
         wendigo_log(MSG_ERROR, "pnl_index_of_mac() called with NULL arguments.");
         return 0;
     }
-    uint8_t idx;
+    if (pnl->devices == NULL) {
+        /* A new PreferredNetwork with no devices yet */
+        return pnl->device_count;
+    }
+    uint16_t idx;
     for (idx = 0; idx < pnl->device_count &&
         (pnl->devices[idx] == NULL ||
             memcmp(pnl->devices[idx]->mac, mac, MAC_BYTES)); ++idx) { }
@@ -323,9 +334,9 @@ uint8_t pnl_index_of_mac(PreferredNetwork *pnl, uint8_t mac[MAC_BYTES]) {
 /** Search the specified PreferredNetwork for a device with the same MAC as
  * the specified device. Returns pnl->device_count if not found.
  */
-uint8_t pnl_index_of_device(PreferredNetwork *pnl, wendigo_device *dev) {
+uint16_t pnl_index_of_device(PreferredNetwork *pnl, wendigo_device *dev) {
     FURI_LOG_T(WENDIGO_TAG, "Start+End pnl_index_of_device()");
-    if (dev == NULL || pnl == NULL || pnl->devices == NULL) {
+    if (dev == NULL || pnl == NULL) {
         wendigo_log(MSG_ERROR, "pnl_index_of_device() called with NULL arguments.");
         return 0;
     }
@@ -359,11 +370,18 @@ PNL_Result pnl_find_or_create_device(WendigoApp *app, char *ssid, wendigo_device
         FURI_LOG_T(WENDIGO_TAG, "End pnl_find_or_create_device() - Failed to obtain PreferredNetwork.");
         return PNL_FAILED;
     }
-    uint8_t devIdx = pnl_index_of_mac(pnl, dev->mac);
+    uint16_t devIdx = pnl_index_of_mac(pnl, dev->mac);
     if (devIdx == pnl->device_count) {
-        /* Device is not registered in PNL - Append it */
-        wendigo_device **new_dev = realloc(pnl->devices,
-            sizeof(wendigo_device *) * (pnl->device_count + 1));
+        /* Device is not registered in PNL - Append it, growing pnl->devices[]
+           by PNL_DEVICES_CHUNK elements if it's full */
+        wendigo_device **new_dev = pnl->devices;
+        if (pnl->devices == NULL || pnl->device_count == pnl->device_capacity) {
+            new_dev = realloc(pnl->devices,
+                sizeof(wendigo_device *) * (pnl->device_capacity + PNL_DEVICES_CHUNK));
+            if (new_dev != NULL) {
+                pnl->device_capacity += PNL_DEVICES_CHUNK;
+            }
+        }
         if (new_dev == NULL) {
             /* Failed to extend pnl->devices[] */
             char *msg = malloc(sizeof(char) * (51 + MAX_SSID_LEN));
@@ -372,7 +390,7 @@ PNL_Result pnl_find_or_create_device(WendigoApp *app, char *ssid, wendigo_device
             } else {
                 snprintf(msg, 51 + MAX_SSID_LEN,
                     "Failed to extend devices array for %s to %d bytes.",
-                    ssid, sizeof(wendigo_device *) * (pnl->device_count + 1));
+                    ssid, sizeof(wendigo_device *) * (pnl->device_capacity + PNL_DEVICES_CHUNK));
                 wendigo_log(MSG_ERROR, msg);
                 free(msg);
             }
@@ -388,8 +406,8 @@ PNL_Result pnl_find_or_create_device(WendigoApp *app, char *ssid, wendigo_device
         result = PNL_EXISTS;
     }
     furi_mutex_release(app->pnlMutex);
-    if (app->current_view == WendigoAppViewVarItemList) {
-        /* Add/Refresh SSID count on main menu */
+    if (result == PNL_CREATED && app->current_view == WendigoAppViewVarItemList) {
+        /* Refresh SSID count on main menu */
         // TODO: This couples wendigo_pnl.c to the UI - Change this to a generic inversion of control pattern later on
         view_dispatcher_send_custom_event(app->view_dispatcher, Wendigo_EventRefreshPNLCount);
     }
@@ -397,6 +415,70 @@ PNL_Result pnl_find_or_create_device(WendigoApp *app, char *ssid, wendigo_device
     return result;
 }
 
+/** Remove the specified device from every PreferredNetwork that references it,
+ * before it is removed from the device cache. PreferredNetworks left with no
+ * devices are kept - the SSID was still seen, and removing it would mean
+ * rebuilding the SSID index.
+ * Returns the number of PreferredNetworks the device was removed from.
+ */
+uint8_t pnl_remove_device(WendigoApp *app, wendigo_device *dev) {
+    FURI_LOG_T(WENDIGO_TAG, "Start pnl_remove_device()");
+    if (app == NULL || dev == NULL || dev->scanType != SCAN_WIFI_STA ||
+            dev->radio.sta.saved_networks == NULL || networks == NULL) {
+        FURI_LOG_T(WENDIGO_TAG, "End pnl_remove_device() - Nothing to do.");
+        return 0;
+    }
+    uint8_t result = 0;
+    furi_mutex_acquire(app->pnlMutex, FuriWaitForever);
+    for (uint8_t i = 0; i < dev->radio.sta.saved_networks_count; ++i) {
+        PreferredNetwork *pnl = pnl_for_ssid(dev->radio.sta.saved_networks[i]);
+        if (pnl == NULL || pnl->devices == NULL) {
+            continue;
+        }
+        /* Compare pointers rather than MACs - This is the instance being removed */
+        uint16_t idx;
+        for (idx = 0; idx < pnl->device_count && pnl->devices[idx] != dev; ++idx) { }
+        if (idx < pnl->device_count) {
+            memmove(&(pnl->devices[idx]), &(pnl->devices[idx + 1]),
+                sizeof(wendigo_device *) * (pnl->device_count - idx - 1));
+            --pnl->device_count;
+            ++result;
+        }
+    }
+    furi_mutex_release(app->pnlMutex);
+    FURI_LOG_T(WENDIGO_TAG, "End pnl_remove_device()");
+    return result;
+}
+
+/** Free networks[], each PreferredNetwork's devices[] and the SSID index.
+ * The wendigo_device elements referenced by the PNL belong to the device cache
+ * and are not freed.
+ */
+void pnl_free_networks() {
+    FURI_LOG_T(WENDIGO_TAG, "Start pnl_free_networks()");
+    if (networks != NULL) {
+        for (uint16_t i = 0; i < networks_count; ++i) {
+            if (networks[i].devices != NULL) {
+                free(networks[i].devices);
+                networks[i].devices = NULL;
+            }
+            networks[i].device_count = 0;
+            networks[i].device_capacity = 0;
+        }
+        free(networks);
+    }
+    networks = NULL;
+    networks_count = 0;
+    networks_capacity = 0;
+    if (pnl_index != NULL) {
+        free(pnl_index);
+        pnl_index = NULL;
+    }
+    pnl_index_capacity = 0;
+    pnl_index_retry_at = 0;
+    FURI_LOG_T(WENDIGO_TAG, "End pnl_free_networks()");
+}
+
 /* Create a trace log entry describing the specified PNL_Result */
 void pnl_log_result(char *tag, PNL_Result res, char *ssid, wendigo_device *dev) {
     FURI_LOG_T(WENDIGO_TAG, "Start pnl_log_result()");
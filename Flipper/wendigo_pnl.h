@@ -6,7 +6,8 @@
  */
 typedef struct PreferredNetwork {
     char ssid[MAX_SSID_LEN + 1];
-    uint8_t device_count;
+    uint16_t device_count;
+    uint16_t device_capacity;  /* devices[] grows in chunks rather than per device */
     wendigo_device **devices;
 } PreferredNetwork;
 
@@ -25,10 +26,12 @@ uint16_t map_ssids_to_devices(WendigoApp *app);
 uint8_t get_networks_for_device(WendigoApp *app, wendigo_device *dev, char ***result);
 uint16_t get_all_networks(WendigoApp *app);
 PreferredNetwork *fetch_or_create_pnl(char *ssid, PNL_Result *result);
-uint8_t pnl_index_of_device(PreferredNetwork *pnl, wendigo_device *dev);
-uint8_t pnl_index_of_mac(PreferredNetwork *pnl, uint8_t mac[MAC_BYTES]);
+uint16_t pnl_index_of_device(PreferredNetwork *pnl, wendigo_device *dev);
+uint16_t pnl_index_of_mac(PreferredNetwork *pnl, uint8_t mac[MAC_BYTES]);
 PNL_Result pnl_find_or_create_device(WendigoApp *app, char *ssid, wendigo_device *dev);
+uint8_t pnl_remove_device(WendigoApp *app, wendigo_device *dev);
 void pnl_log_result(char *tag, PNL_Result res, char *ssid, wendigo_device *dev);
+void pnl_free_networks();
 
 /* Preferred Network List caches */
 extern PreferredNetwork *networks;
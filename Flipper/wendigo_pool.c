@@ -0,0 +1,408 @@
+#include "wendigo_pool.h"
+#include "wendigo_scan.h"
+
+/** The device cache used to malloc() every wendigo_device, and then malloc()
+ * every bdname, EIR, CoD string, station MAC and SSID belonging to it. On a
+ * device with 256KB of RAM the heap's per-allocation overhead and the resulting
+ * fragmentation ended up deciding how many devices we could hold, so device
+ * memory is now managed in two places:
+ * * Device records are handed out from chunks of WENDIGO_POOL_RECORDS_PER_CHUNK
+ *   records. Released records go onto their chunk's free list and are reused
+ *   before a new chunk is allocated, and a chunk is returned to the heap once
+ *   all of its records have been released.
+ * * Variable-length attributes (strings, EIR, station and SSID arrays) are
+ *   bump-allocated from an arena of WENDIGO_ARENA_BLOCK_SIZE blocks. The most
+ *   recent allocation can be grown, shrunk or released in place, which covers
+ *   the common case of a device appending a station or SSID. Anything else
+ *   that's released - a name, EIR or station list being replaced, or a pruned
+ *   device's attributes - goes onto a free list for its size, and is handed
+ *   out again before the arena grows. Released memory is counted as waste
+ *   until it's reused so we can see how much it's costing us.
+ * Everything is released in one go by wendigo_pool_free_all(). Releases too
+ * large for a free list, and free lists that are never drawn on, stay waste
+ * until wendigo_arena_compact() reclaims them by copying what's still live
+ * into a new arena.
+ */
+
+/* Round allocations up to pointer alignment so arena blocks can hold pointer arrays */
+#define ARENA_ALIGN(x) (((x) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+/* Released allocations of up to ARENA_FREE_MAX bytes are kept on a free list
+   for their aligned size, linked through their first bytes. That covers
+   names, EIR, service lists and most station and SSID arrays */
+#define ARENA_FREE_MAX          (256)
+#define ARENA_FREE_CLASSES      (ARENA_FREE_MAX / sizeof(void *))
+#define ARENA_FREE_CLASS(size)  (((size) / sizeof(void *)) - 1)
+
+typedef struct WendigoPoolChunk {
+    struct WendigoPoolChunk *next;
+    wendigo_device *free_list;  /* Released records - The next pointer is stored in their radio union */
+    uint16_t used;    /* Number of records handed out from this chunk (excluding the free list) */
+    uint16_t in_use;  /* Number of records currently handed out */
+    wendigo_device records[WENDIGO_POOL_RECORDS_PER_CHUNK];
+} WendigoPoolChunk;
+
+typedef struct WendigoArenaBlock {
+    struct WendigoArenaBlock *next;
+    uint16_t size;  /* Capacity of data[] */
+    uint16_t used;  /* Bytes of data[] that have been handed out */
+    uint16_t last;  /* Offset of the most recent allocation, to allow in-place resizing */
+    uint16_t reserved;
+    uint8_t data[];
+} WendigoArenaBlock;
+
+static WendigoPoolChunk *pool_chunks = NULL;
+/* The chunk most likely to have a free record - The last one a record was
+   released to or allocated from */
+static WendigoPoolChunk *pool_hint = NULL;
+static uint16_t pool_chunk_count = 0;
+static uint16_t pool_records_in_use = 0;
+/* Number of record and arena allocations that have failed */
+static uint32_t pool_alloc_failures = 0;
+
+static WendigoArenaBlock *arena_head = NULL;
+static uint16_t arena_block_count = 0;
+static uint32_t arena_bytes = 0;
+static uint32_t arena_wasted = 0;
+static void *arena_free[ARENA_FREE_CLASSES];
+
+/** Returns a zeroed wendigo_device from the device pool, allocating a new
+ * chunk of records if every chunk is full.
+ * Returns NULL if memory could not be allocated.
+ */
+wendigo_device *wendigo_pool_alloc_device() {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_pool_alloc_device()");
+    WendigoPoolChunk *chunk = pool_hint;
+    if (chunk == NULL || chunk->in_use == WENDIGO_POOL_RECORDS_PER_CHUNK) {
+        for (chunk = pool_chunks; chunk != NULL &&
+                chunk->in_use == WENDIGO_POOL_RECORDS_PER_CHUNK; chunk = chunk->next) {
+        }
+    }
+    if (chunk == NULL) {
+        chunk = malloc(sizeof(WendigoPoolChunk));
+        if (chunk == NULL) {
+            ++pool_alloc_failures;
+            wendigo_log(MSG_ERROR, "Unable to allocate a chunk of device records.");
+            FURI_LOG_T(WENDIGO_TAG, "End wendigo_pool_alloc_device() - Out of memory");
+            return NULL;
+        }
+        chunk->free_list = NULL;
+        chunk->used = 0;
+        chunk->in_use = 0;
+        chunk->next = pool_chunks;
+        pool_chunks = chunk;
+        ++pool_chunk_count;
+    }
+    wendigo_device *result;
+    if (chunk->free_list != NULL) {
+        /* Reuse a released record */
+        result = chunk->free_list;
+        chunk->free_list = *(wendigo_device **)&(result->radio);
+    } else {
+        result = &(chunk->records[chunk->used++]);
+    }
+    bzero(result, sizeof(wendigo_device));
+    ++chunk->in_use;
+    ++pool_records_in_use;
+    pool_hint = chunk;
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_pool_alloc_device()");
+    return result;
+}
+
+/** Return a device record to the pool, freeing its chunk if that was the last
+ * record in use. The caller is responsible for releasing any arena memory
+ * referenced by the device before calling this function.
+ */
+void wendigo_pool_release_device(wendigo_device *dev) {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_pool_release_device()");
+    if (dev == NULL) {
+        return;
+    }
+    WendigoPoolChunk **link = &pool_chunks;
+    while (*link != NULL && (dev < (*link)->records ||
+            dev >= (*link)->records + WENDIGO_POOL_RECORDS_PER_CHUNK)) {
+        link = &((*link)->next);
+    }
+    WendigoPoolChunk *chunk = *link;
+    if (chunk == NULL) {
+        wendigo_log(MSG_ERROR, "Released a device record that isn't from the device pool.");
+        return;
+    }
+    if (pool_records_in_use > 0) {
+        --pool_records_in_use;
+    }
+    if (--chunk->in_use == 0) {
+        /* Nothing left in this chunk - Give it back to the heap */
+        *link = chunk->next;
+        if (pool_hint == chunk) {
+            pool_hint = NULL;
+        }
+        free(chunk);
+        --pool_chunk_count;
+    } else {
+        *(wendigo_device **)&(dev->radio) = chunk->free_list;
+        chunk->free_list = dev;
+        pool_hint = chunk;
+    }
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_pool_release_device()");
+}
+
+/** Allocate `size` bytes from the arena, reusing a released allocation of the
+ * same size if there is one. A new block is started if the current block
+ * can't hold the allocation - allocations larger than a block are given a
+ * block of their own. Returns NULL if memory could not be allocated.
+ */
+void *wendigo_arena_alloc(uint16_t size) {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_arena_alloc()");
+    if (size == 0) {
+        return NULL;
+    }
+    uint16_t aligned = ARENA_ALIGN(size);
+    if (aligned <= ARENA_FREE_MAX && arena_free[ARENA_FREE_CLASS(aligned)] != NULL) {
+        /* Reuse a released allocation of the same size */
+        void *result = arena_free[ARENA_FREE_CLASS(aligned)];
+        arena_free[ARENA_FREE_CLASS(aligned)] = *(void **)result;
+        arena_wasted -= aligned;
+        FURI_LOG_T(WENDIGO_TAG, "End wendigo_arena_alloc() - Reused");
+        return result;
+    }
+    if (arena_head == NULL || arena_head->size - arena_head->used < aligned) {
+        uint16_t block_size = (aligned > WENDIGO_ARENA_BLOCK_SIZE) ? aligned : WENDIGO_ARENA_BLOCK_SIZE;
+        WendigoArenaBlock *block = malloc(sizeof(WendigoArenaBlock) + block_size);
+        if (block == NULL) {
+            ++pool_alloc_failures;
+            char *msg = malloc(46);
+            if (msg == NULL) {
+                wendigo_log(MSG_ERROR, "Unable to allocate an arena block.");
+            } else {
+                snprintf(msg, 46, "Unable to allocate %d-byte arena block.", block_size);
+                wendigo_log(MSG_ERROR, msg);
+                free(msg);
+            }
+            FURI_LOG_T(WENDIGO_TAG, "End wendigo_arena_alloc() - Out of memory");
+            return NULL;
+        }
+        /* Whatever was left in the previous block will never be used */
+        if (arena_head != NULL) {
+            arena_wasted += arena_head->size - arena_head->used;
+        }
+        block->size = block_size;
+        block->used = 0;
+        block->last = 0;
+        block->next = arena_head;
+        arena_head = block;
+        ++arena_block_count;
+        arena_bytes += sizeof(WendigoArenaBlock) + block_size;
+    }
+    void *result = arena_head->data + arena_head->used;
+    arena_head->last = arena_head->used;
+    arena_head->used += aligned;
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_arena_alloc()");
+    return result;
+}
+
+/** Count the `aligned` bytes at `ptr` as waste, and put them on their free
+ * list if they're small enough to be reused.
+ */
+static void arena_discard(void *ptr, uint16_t aligned) {
+    arena_wasted += aligned;
+    if (aligned > 0 && aligned <= ARENA_FREE_MAX) {
+        *(void **)ptr = arena_free[ARENA_FREE_CLASS(aligned)];
+        arena_free[ARENA_FREE_CLASS(aligned)] = ptr;
+    }
+}
+
+/** Is `ptr`, of size `size`, the most recent allocation made from the arena? */
+static bool arena_is_last(void *ptr, uint16_t size) {
+    return arena_head != NULL && ptr == arena_head->data + arena_head->last &&
+        arena_head->used == arena_head->last + ARENA_ALIGN(size);
+}
+
+/** Resize an arena allocation. If `ptr` was the most recent allocation and the
+ * current block has room it is resized in place, otherwise a new allocation is
+ * made, the first MIN(old_size, new_size) bytes copied to it, and the original
+ * allocation released. Returns NULL (leaving `ptr` untouched) if memory could not
+ * be allocated.
+ */
+void *wendigo_arena_realloc(void *ptr, uint16_t old_size, uint16_t new_size) {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_arena_realloc()");
+    if (ptr == NULL || old_size == 0) {
+        FURI_LOG_T(WENDIGO_TAG, "End wendigo_arena_realloc() - New allocation");
+        return wendigo_arena_alloc(new_size);
+    }
+    if (arena_is_last(ptr, old_size) &&
+            arena_head->last + ARENA_ALIGN(new_size) <= arena_head->size) {
+        arena_head->used = arena_head->last + ARENA_ALIGN(new_size);
+        FURI_LOG_T(WENDIGO_TAG, "End wendigo_arena_realloc() - Resized in place");
+        return ptr;
+    }
+    if (new_size <= old_size) {
+        /* Shrinking something in the middle of a block - Release the tail */
+        arena_discard((uint8_t *)ptr + ARENA_ALIGN(new_size), ARENA_ALIGN(old_size) - ARENA_ALIGN(new_size));
+        FURI_LOG_T(WENDIGO_TAG, "End wendigo_arena_realloc() - Shrunk");
+        return ptr;
+    }
+    void *result = wendigo_arena_alloc(new_size);
+    if (result != NULL) {
+        memcpy(result, ptr, old_size);
+        wendigo_arena_release(ptr, old_size);
+    }
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_arena_realloc()");
+    return result;
+}
+
+/** Copy `len` bytes of `str` into the arena, adding a terminating '\0' */
+char *wendigo_arena_strndup(const char *str, uint16_t len) {
+    if (str == NULL) {
+        return NULL;
+    }
+    char *result = wendigo_arena_alloc(len + 1);
+    if (result != NULL) {
+        memcpy(result, str, len);
+        result[len] = '\0';
+    }
+    return result;
+}
+
+/** Release an arena allocation. The most recent allocation is reclaimed in
+ * place; anything else is kept for reuse by an allocation of the same size if
+ * it's no larger than ARENA_FREE_MAX. `size` may be less than the size that
+ * was allocated, but never more.
+ */
+void wendigo_arena_release(void *ptr, uint16_t size) {
+    if (ptr == NULL || size == 0) {
+        return;
+    }
+    if (arena_is_last(ptr, size)) {
+        arena_head->used = arena_head->last;
+    } else {
+        arena_discard(ptr, ARENA_ALIGN(size));
+    }
+}
+
+/** Rebuild the arena so that it holds only live allocations, returning the
+ * waste to the heap. The current blocks are set aside and `relocate` is called
+ * to copy every live allocation into a fresh arena (with wendigo_arena_alloc()
+ * and friends) and repoint whatever references it. If `relocate` succeeds the
+ * old blocks are freed.
+ * If it fails part-way some pointers may already refer to the new arena while
+ * others still refer to the old one, so the old blocks are kept on the end of
+ * the new chain - nothing is lost, we just don't get any memory back.
+ * Compaction needs enough free heap to hold a second copy of the live
+ * allocations, so check that before calling it.
+ * Returns the number of bytes returned to the heap.
+ */
+uint32_t wendigo_arena_compact(bool (*relocate)(void *context), void *context) {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_arena_compact()");
+    if (relocate == NULL || arena_head == NULL) {
+        FURI_LOG_T(WENDIGO_TAG, "End wendigo_arena_compact() - Nothing to do");
+        return 0;
+    }
+    WendigoArenaBlock *old_head = arena_head;
+    uint16_t old_block_count = arena_block_count;
+    uint32_t old_bytes = arena_bytes;
+    uint32_t old_wasted = arena_wasted;
+    void *old_free[ARENA_FREE_CLASSES];
+    memcpy(old_free, arena_free, sizeof(arena_free));
+    memset(arena_free, 0, sizeof(arena_free));
+    arena_head = NULL;
+    arena_block_count = 0;
+    arena_bytes = 0;
+    arena_wasted = 0;
+
+    if (relocate(context)) {
+        while (old_head != NULL) {
+            WendigoArenaBlock *next = old_head->next;
+            free(old_head);
+            old_head = next;
+        }
+        uint32_t released = (old_bytes > arena_bytes) ? old_bytes - arena_bytes : 0;
+        FURI_LOG_T(WENDIGO_TAG, "End wendigo_arena_compact()");
+        return released;
+    }
+
+    wendigo_log(MSG_WARN, "Arena compaction failed, keeping the existing arena.");
+    if (arena_head == NULL) {
+        /* Nothing was relocated - Put everything back the way it was */
+        arena_head = old_head;
+        arena_block_count = old_block_count;
+        arena_bytes = old_bytes;
+        arena_wasted = old_wasted;
+        memcpy(arena_free, old_free, sizeof(arena_free));
+        FURI_LOG_T(WENDIGO_TAG, "End wendigo_arena_compact() - Failed");
+        return 0;
+    }
+    /* Everything that made it into the new blocks now has a stale copy in the
+       old blocks, and the space left in the old head block will never be used.
+       The old free lists are dropped - Their memory stays counted as waste */
+    uint32_t relocated = 0;
+    WendigoArenaBlock *tail = arena_head;
+    while (true) {
+        relocated += tail->used;
+        if (tail->next == NULL) {
+            break;
+        }
+        tail = tail->next;
+    }
+    tail->next = old_head;
+    arena_block_count += old_block_count;
+    arena_bytes += old_bytes;
+    arena_wasted += old_wasted + relocated + (old_head->size - old_head->used);
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_arena_compact() - Failed");
+    return 0;
+}
+
+/** Release all device records and arena blocks */
+void wendigo_pool_free_all() {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_pool_free_all()");
+    while (pool_chunks != NULL) {
+        WendigoPoolChunk *next = pool_chunks->next;
+        free(pool_chunks);
+        pool_chunks = next;
+    }
+    pool_hint = NULL;
+    pool_chunk_count = 0;
+    pool_records_in_use = 0;
+    while (arena_head != NULL) {
+        WendigoArenaBlock *next = arena_head->next;
+        free(arena_head);
+        arena_head = next;
+    }
+    arena_block_count = 0;
+    arena_bytes = 0;
+    arena_wasted = 0;
+    memset(arena_free, 0, sizeof(arena_free));
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_pool_free_all()");
+}
+
+void wendigo_pool_get_stats(WendigoPoolStats *stats) {
+    if (stats == NULL) {
+        return;
+    }
+    stats->record_bytes = pool_chunk_count * sizeof(WendigoPoolChunk);
+    stats->arena_bytes = arena_bytes;
+    stats->arena_wasted = arena_wasted;
+    /* Unused space in the current block is neither used nor wasted (yet) */
+    uint32_t unused = (arena_head == NULL) ? 0 : arena_head->size - arena_head->used;
+    uint32_t overhead = arena_block_count * sizeof(WendigoArenaBlock);
+    stats->arena_used = arena_bytes - arena_wasted - unused - overhead;
+    stats->records_in_use = pool_records_in_use;
+    stats->chunk_count = pool_chunk_count;
+    stats->block_count = arena_block_count;
+    stats->alloc_failures = pool_alloc_failures;
+}
+
+/** Measure the average number of bytes of heap used by each cached device. This
+ * is the real cost, including devices[], partially-filled chunks and blocks and
+ * arena waste, not just sizeof(wendigo_device).
+ * Returns 0 if there are no devices.
+ */
+uint32_t wendigo_pool_bytes_per_device(uint16_t device_count, uint16_t device_capacity) {
+    if (device_count == 0) {
+        return 0;
+    }
+    WendigoPoolStats stats;
+    wendigo_pool_get_stats(&stats);
+    uint32_t total = stats.record_bytes + stats.arena_bytes +
+        (sizeof(wendigo_device *) * device_capacity);
+    return total / device_count;
+}
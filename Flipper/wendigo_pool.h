@@ -0,0 +1,31 @@
+#pragma once
+
+#include "wendigo_app_i.h"
+
+/* Device records are allocated from chunks containing this many records */
+#define WENDIGO_POOL_RECORDS_PER_CHUNK (32)
+/* Size of each block allocated to the string & blob arena */
+#define WENDIGO_ARENA_BLOCK_SIZE       (2048)
+
+/** Memory statistics for the device cache, used by the status scene */
+typedef struct WendigoPoolStats {
+    uint32_t record_bytes;  /* Bytes allocated to device record chunks */
+    uint32_t arena_bytes;   /* Bytes allocated to arena blocks */
+    uint32_t arena_used;    /* Bytes of the arena that are currently referenced */
+    uint32_t arena_wasted;  /* Bytes of the arena that have been released or skipped */
+    uint16_t records_in_use;
+    uint16_t chunk_count;
+    uint16_t block_count;
+    uint32_t alloc_failures;  /* Record and arena allocations that have failed */
+} WendigoPoolStats;
+
+wendigo_device *wendigo_pool_alloc_device();
+void wendigo_pool_release_device(wendigo_device *dev);
+void *wendigo_arena_alloc(uint16_t size);
+void *wendigo_arena_realloc(void *ptr, uint16_t old_size, uint16_t new_size);
+char *wendigo_arena_strndup(const char *str, uint16_t len);
+void wendigo_arena_release(void *ptr, uint16_t size);
+uint32_t wendigo_arena_compact(bool (*relocate)(void *context), void *context);
+void wendigo_pool_free_all();
+void wendigo_pool_get_stats(WendigoPoolStats *stats);
+uint32_t wendigo_pool_bytes_per_device(uint16_t device_count, uint16_t device_capacity);
@@ -0,0 +1,200 @@
+#include "wendigo_prune.h"
+#include "wendigo_scan.h"
+#include "wendigo_spill.h"
+
+/** When devices keep arriving faster than the user can look at them Flipper
+ * eventually runs out of heap, and once that happens every allocation - ours
+ * and the firmware's - starts failing. Rather than waiting for that, the free
+ * heap is measured as devices are added and, when it drops below
+ * WENDIGO_PRUNE_LOW_WATERMARK, devices are removed from the cache until it is
+ * back above WENDIGO_PRUNE_HIGH_WATERMARK.
+ * Which devices are removed is configured per device type in the setup menu:
+ * the least recently seen, the weakest, or none at all. Untagged devices are
+ * always removed before tagged devices, and the device being displayed by the
+ * device detail or PNL scenes is never removed.
+ * Removed devices are written to the SD card first if possible
+ * (wendigo_spill.c), so they come back if they're seen again.
+ * Removing devices returns their records to the device pool for reuse, but
+ * their attributes are left behind as arena waste until the arena is
+ * compacted - so that's done here as well, when it's worth doing and there's
+ * enough memory to do it.
+ */
+
+/* Public methods from scenes */
+extern wendigo_device *wendigo_scene_device_detail_get_device();
+extern wendigo_device *wendigo_scene_pnl_list_get_device();
+
+/* furi_get_tick() when the heap was last measured */
+static uint32_t prune_last_check = 0;
+
+/** The PruneType `dev` belongs to, or PRUNE_TYPE_COUNT if none */
+static PruneType wendigo_prune_type(wendigo_device *dev) {
+    if (dev->scanType == SCAN_HCI || dev->scanType == SCAN_BLE) {
+        return PRUNE_BT;
+    } else if (dev->scanType == SCAN_WIFI_AP) {
+        return PRUNE_AP;
+    } else if (dev->scanType == SCAN_WIFI_STA) {
+        return PRUNE_STA;
+    }
+    return PRUNE_TYPE_COUNT;
+}
+
+/** Is `dev` being displayed by a scene that holds a pointer to it? Such
+ * devices must stay where they are.
+ */
+bool wendigo_device_is_pinned(wendigo_device *dev) {
+    return dev == wendigo_scene_device_detail_get_device() ||
+        dev == wendigo_scene_pnl_list_get_device();
+}
+
+/** Should `a` be pruned before `b` under `policy`? */
+static bool wendigo_prune_before(PrunePolicy policy, wendigo_device *a, wendigo_device *b) {
+    if (policy == PRUNE_WEAKEST && a->rssi != b->rssi) {
+        return a->rssi < b->rssi;
+    }
+    /* Ties between equally-weak devices go to the oldest */
+    return a->lastSeen < b->lastSeen;
+}
+
+/** Find the device of type `type` that should be pruned next. Tagged devices
+ * are only considered if `include_tagged` is true.
+ * Returns devices_count if there's no device that can be pruned.
+ */
+static uint16_t wendigo_prune_select(WendigoApp *app, PruneType type, bool include_tagged) {
+    PrunePolicy policy = app->prune_policy[type];
+    uint16_t result = devices_count;
+    for (uint16_t i = 0; i < devices_count; ++i) {
+        wendigo_device *dev = devices[i];
+        if (wendigo_prune_type(dev) != type || (dev->tagged && !include_tagged) ||
+                wendigo_device_is_pinned(dev)) {
+            continue;
+        }
+        if (result == devices_count || wendigo_prune_before(policy, dev, devices[result])) {
+            result = i;
+        }
+    }
+    return result;
+}
+
+/** Remove up to WENDIGO_PRUNE_BATCH devices, taking one of each device type in
+ * turn so that one type doesn't bear the whole cost. Tagged devices are only
+ * removed once there are no untagged devices left to remove.
+ * Returns the number of devices removed.
+ */
+static uint16_t wendigo_prune_batch(WendigoApp *app) {
+    uint16_t result = 0;
+    bool include_tagged = false;
+    while (result < WENDIGO_PRUNE_BATCH) {
+        bool removed = false;
+        for (uint8_t type = 0; type < PRUNE_TYPE_COUNT && result < WENDIGO_PRUNE_BATCH; ++type) {
+            if (app->prune_policy[type] == PRUNE_NEVER) {
+                continue;
+            }
+            uint16_t idx = wendigo_prune_select(app, type, include_tagged);
+            if (idx < devices_count) {
+                /* Keep a copy on the SD card if we can, so it isn't lost for good */
+                wendigo_spill_device(app, devices[idx]);
+                wendigo_remove_device(app, idx);
+                removed = true;
+                ++result;
+            }
+        }
+        if (!removed) {
+            if (include_tagged) {
+                break;
+            }
+            include_tagged = true;
+        }
+    }
+    return result;
+}
+
+/** Compact the arena if at least half of it is waste and there's room for a
+ * second copy of what's still in use. Scenes other than the device list read
+ * device attributes without holding devicesMutex, so it's left alone while
+ * they're displayed.
+ */
+static void wendigo_prune_compact(WendigoApp *app, size_t free_heap) {
+    if (app->current_view == WendigoAppViewPNLList ||
+            app->current_view == WendigoAppViewPNLDeviceList ||
+            app->current_view == WendigoAppViewDeviceDetail) {
+        return;
+    }
+    WendigoPoolStats stats;
+    wendigo_pool_get_stats(&stats);
+    if (stats.arena_wasted * 2 < stats.arena_bytes ||
+            free_heap < stats.arena_used + WENDIGO_PRUNE_COMPACT_RESERVE) {
+        return;
+    }
+    uint32_t released = wendigo_compact_devices();
+    FURI_LOG_D(WENDIGO_TAG, "Compacted device arena, released %lu bytes.", released);
+}
+
+/** Free heap. Released device records aren't counted - They can only hold
+ * device records, and most of what a device needs comes from the arena, which
+ * can't use them. The pool returns a chunk to the heap once all of its records
+ * are released, which is what pruning the oldest devices tends to do.
+ */
+static size_t wendigo_prune_free_heap() {
+    return memmgr_get_free_heap();
+}
+
+/** Measure the heap and, if it's running low, remove devices from the device
+ * cache according to app->prune_policy[] until it isn't.
+ * The largest free block is measured at most every WENDIGO_PRUNE_INTERVAL_MS.
+ * If `force` is true at least one batch of devices is removed regardless
+ * - use this when an allocation has already failed. The arena is compacted
+ * after each batch when it's worth doing.
+ * Called from the UART thread when adding devices; must not be called with
+ * app->devicesMutex or app->pnlMutex held.
+ * Returns true if any devices were removed.
+ */
+bool wendigo_prune_check(WendigoApp *app, bool force) {
+    size_t free_heap = wendigo_prune_free_heap();
+    if (!force && free_heap >= WENDIGO_PRUNE_LOW_WATERMARK) {
+        /* Free heap is a counter, but finding the largest free block means
+           walking the heap, so only do that occasionally */
+        uint32_t now = furi_get_tick();
+        if (now - prune_last_check < furi_ms_to_ticks(WENDIGO_PRUNE_INTERVAL_MS)) {
+            return false;
+        }
+        prune_last_check = now;
+        if (memmgr_heap_get_max_free_block() >= WENDIGO_PRUNE_MIN_FREE_BLOCK) {
+            return false;
+        }
+    }
+    size_t max_block;
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_prune_check()");
+    uint16_t pruned = 0;
+    furi_mutex_acquire(app->devicesMutex, FuriWaitForever);
+    wendigo_scene_device_list_begin_removal(app);
+    for (uint8_t batch = 0; batch < WENDIGO_PRUNE_MAX_BATCHES; ++batch) {
+        uint16_t removed = wendigo_prune_batch(app);
+        if (removed == 0) {
+            break;
+        }
+        pruned += removed;
+        wendigo_prune_compact(app, memmgr_get_free_heap());
+        free_heap = wendigo_prune_free_heap();
+        max_block = memmgr_heap_get_max_free_block();
+        if (free_heap >= WENDIGO_PRUNE_HIGH_WATERMARK &&
+                max_block >= WENDIGO_PRUNE_MIN_FREE_BLOCK) {
+            break;
+        }
+    }
+    wendigo_scene_device_list_end_removal(app);
+    furi_mutex_release(app->devicesMutex);
+    app->devices_pruned += pruned;
+
+    char *msg = malloc(sizeof(char) * 70);
+    if (msg == NULL) {
+        wendigo_log(MSG_WARN, "Memory is low, devices have been removed from the cache.");
+    } else {
+        snprintf(msg, 70, "Memory is low, removed %u devices from the cache (%u bytes free).",
+            pruned, free_heap);
+        wendigo_log((pruned > 0) ? MSG_WARN : MSG_ERROR, msg);
+        free(msg);
+    }
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_prune_check()");
+    return pruned > 0;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "wendigo_pool.h"
+
+/* How often the free heap is measured while devices are being added (ms) */
+#define WENDIGO_PRUNE_INTERVAL_MS    (1000)
+/* Pruning starts when free heap drops below the low watermark, and continues
+   until it is back above the high watermark */
+#define WENDIGO_PRUNE_LOW_WATERMARK  (12 * 1024)
+#define WENDIGO_PRUNE_HIGH_WATERMARK (20 * 1024)
+/* Pruning also starts if the largest free block can't hold a new arena block */
+#define WENDIGO_PRUNE_MIN_FREE_BLOCK (WENDIGO_ARENA_BLOCK_SIZE + 256)
+/* Maximum number of devices to remove before measuring the heap again */
+#define WENDIGO_PRUNE_BATCH          (16)
+/* Maximum number of batches to remove in a single call to wendigo_prune_check() */
+#define WENDIGO_PRUNE_MAX_BATCHES    (8)
+/* Free heap to leave untouched when deciding whether the arena can be compacted */
+#define WENDIGO_PRUNE_COMPACT_RESERVE (4 * 1024)
+
+bool wendigo_prune_check(WendigoApp *app, bool force);
+bool wendigo_device_is_pinned(wendigo_device *dev);
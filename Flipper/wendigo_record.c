@@ -0,0 +1,345 @@
+#include "wendigo_record.h"
+#include "wendigo_scan.h"
+#include <storage/storage.h>
+
+/** Recording captures the exact byte stream received from ESP32, chunked as
+ * the UART worker delivered it, so that it can later be fed back through
+ * wendigo_scan_handle_rx_data_cb() with no ESP32 attached. This gives a
+ * repeatable workload for measuring and debugging the parser and device
+ * cache: a replay at maximum speed reports how many packets per second
+ * Flipper can parse.
+ * The file is a WendigoRecordHeader followed by chunks, each of which is the
+ * milliseconds since the previous chunk (uint32_t), the chunk's length
+ * (uint16_t) and then the bytes received. Writes are collected in
+ * record_buffer[] so the UART thread only touches the SD card once every
+ * WENDIGO_RECORD_BUFFER_SIZE bytes.
+ * While recording or replaying, wendigo_uart_set_binary_cb() installs
+ * wendigo_record_rx_data_cb() in place of wendigo_scan_handle_rx_data_cb().
+ * It records and then parses data received while recording, and discards
+ * data received during a replay so that it isn't interleaved with the
+ * replayed stream.
+ */
+
+#define WENDIGO_RECORD_MAGIC   "WDGREC"
+#define WENDIGO_RECORD_VERSION (1)
+
+typedef struct WendigoRecordHeader {
+    char magic[6];
+    uint16_t version;
+} WendigoRecordHeader;
+
+typedef enum {
+    ReplayEvtStop = (1 << 0),
+} ReplayEvtFlags;
+
+/* Delay between chunks is divided by this, indexed by ReplaySpeed. Zero means
+   don't wait at all */
+static const uint8_t replay_divisor[REPLAY_SPEED_COUNT] = {1, 10, 0};
+
+/* Serialises the UART thread's writes with starting and stopping recording */
+static FuriMutex *record_mutex = NULL;
+static Storage *record_storage = NULL;
+static File *record_file = NULL;
+static uint8_t *record_buffer = NULL;
+static uint16_t record_buffer_len = 0;
+static bool record_write_failed = false;
+static uint32_t record_last_tick = 0;   /* furi_get_tick() of the last chunk recorded */
+static uint32_t record_bytes = 0;
+
+static FuriThread *replay_thread = NULL;
+static ReplaySpeed replay_speed = REPLAY_1X;
+static volatile bool replay_running = false;
+/* Results of the most recent replay */
+static uint32_t replay_bytes = 0;
+static uint32_t replay_packets = 0;
+static uint32_t replay_elapsed = 0;     /* ms */
+static bool replay_failed = false;
+
+/** Write the contents of record_buffer[] to the recording */
+static void record_flush() {
+    if (record_buffer_len > 0 && !record_write_failed &&
+            storage_file_write(record_file, record_buffer, record_buffer_len) != record_buffer_len) {
+        record_write_failed = true;
+        wendigo_log(MSG_ERROR, "Unable to write UART recording to SD card, recording stopped.");
+    }
+    record_buffer_len = 0;
+}
+
+/** Append `len` bytes to the recording */
+static void record_write(const void *data, uint16_t len) {
+    const uint8_t *bytes = data;
+    while (len > 0) {
+        if (record_buffer_len == WENDIGO_RECORD_BUFFER_SIZE) {
+            record_flush();
+        }
+        uint16_t chunk = WENDIGO_RECORD_BUFFER_SIZE - record_buffer_len;
+        if (chunk > len) {
+            chunk = len;
+        }
+        memcpy(record_buffer + record_buffer_len, bytes, chunk);
+        record_buffer_len += chunk;
+        bytes += chunk;
+        len -= chunk;
+    }
+}
+
+void wendigo_record_rx_data_cb(uint8_t *buf, size_t len, void *context) {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_record_rx_data_cb()");
+    if (replay_running) {
+        /* Drop anything ESP32 sends while the recording is being replayed */
+        FURI_LOG_T(WENDIGO_TAG, "End wendigo_record_rx_data_cb()");
+        return;
+    }
+    if (record_mutex != NULL && furi_mutex_acquire(record_mutex, FuriWaitForever) == FuriStatusOk) {
+        if (record_file != NULL && !record_write_failed) {
+            uint32_t now = furi_get_tick();
+            uint32_t delta = now - record_last_tick;
+            uint16_t chunk_len = len;
+            record_last_tick = now;
+            record_write(&delta, sizeof(delta));
+            record_write(&chunk_len, sizeof(chunk_len));
+            record_write(buf, chunk_len);
+            record_bytes += chunk_len;
+        }
+        furi_mutex_release(record_mutex);
+    }
+    wendigo_scan_handle_rx_data_cb(buf, len, context);
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_record_rx_data_cb()");
+}
+
+/** Returns false once a write to the SD card has failed, although the file
+ * remains open until wendigo_record_stop() is called */
+bool wendigo_record_is_recording() {
+    return record_file != NULL && !record_write_failed;
+}
+
+bool wendigo_replay_is_running() {
+    return replay_running;
+}
+
+bool wendigo_record_is_active() {
+    return wendigo_record_is_recording() || wendigo_replay_is_running();
+}
+
+/** Start recording the UART stream to WENDIGO_RECORD_PATH, replacing any
+ * previous recording. Returns false if recording couldn't be started.
+ */
+bool wendigo_record_start(WendigoApp *app) {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_record_start()");
+    if (wendigo_record_is_active()) {
+        FURI_LOG_T(WENDIGO_TAG, "End wendigo_record_start()");
+        return false;
+    }
+    if (record_mutex == NULL) {
+        record_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    }
+    /* Close a recording that stopped because of a write error */
+    wendigo_record_stop(app);
+    record_buffer = malloc(WENDIGO_RECORD_BUFFER_SIZE);
+    if (record_buffer == NULL) {
+        wendigo_log(MSG_ERROR, "Unable to allocate UART recording buffer.");
+        FURI_LOG_T(WENDIGO_TAG, "End wendigo_record_start()");
+        return false;
+    }
+    record_storage = furi_record_open(RECORD_STORAGE);
+    File *file = storage_file_alloc(record_storage);
+    if (!storage_file_open(file, WENDIGO_RECORD_PATH, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        char *msg = malloc(sizeof(char) * 93);
+        if (msg == NULL) {
+            wendigo_log(MSG_ERROR, "Unable to open UART recording on SD card.");
+        } else {
+            snprintf(msg, 93, "Unable to open UART recording on SD card: %s",
+                storage_file_get_error_desc(file));
+            wendigo_log(MSG_ERROR, msg);
+            free(msg);
+        }
+        storage_file_free(file);
+        furi_record_close(RECORD_STORAGE);
+        record_storage = NULL;
+        free(record_buffer);
+        record_buffer = NULL;
+        FURI_LOG_T(WENDIGO_TAG, "End wendigo_record_start()");
+        return false;
+    }
+    furi_mutex_acquire(record_mutex, FuriWaitForever);
+    record_file = file;
+    record_buffer_len = 0;
+    record_write_failed = false;
+    record_bytes = 0;
+    record_last_tick = furi_get_tick();
+    WendigoRecordHeader header;
+    memcpy(header.magic, WENDIGO_RECORD_MAGIC, sizeof(header.magic));
+    header.version = WENDIGO_RECORD_VERSION;
+    record_write(&header, sizeof(header));
+    furi_mutex_release(record_mutex);
+
+    /* Put the recorder between the UART and the parser */
+    wendigo_uart_set_binary_cb(app->uart);
+    wendigo_log(MSG_INFO, "Recording UART to " WENDIGO_RECORD_PATH);
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_record_start()");
+    return true;
+}
+
+void wendigo_record_stop(WendigoApp *app) {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_record_stop()");
+    if (record_file == NULL) {
+        FURI_LOG_T(WENDIGO_TAG, "End wendigo_record_stop()");
+        return;
+    }
+    furi_mutex_acquire(record_mutex, FuriWaitForever);
+    record_flush();
+    storage_file_close(record_file);
+    storage_file_free(record_file);
+    record_file = NULL;
+    furi_record_close(RECORD_STORAGE);
+    record_storage = NULL;
+    free(record_buffer);
+    record_buffer = NULL;
+    furi_mutex_release(record_mutex);
+
+    wendigo_uart_set_binary_cb(app->uart);
+    char *msg = malloc(sizeof(char) * 44);
+    if (msg != NULL) {
+        snprintf(msg, 44, "Recorded %lu bytes from UART.", record_bytes);
+        wendigo_log(MSG_INFO, msg);
+        free(msg);
+    }
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_record_stop()");
+}
+
+/** Replay thread - Feeds the recording to the parser, waiting between chunks
+ * according to replay_speed, until the recording ends or ReplayEvtStop is
+ * set. Sends Wendigo_EventReplayFinished when done.
+ */
+static int32_t wendigo_replay_worker(void *context) {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_replay_worker()");
+    WendigoApp *app = context;
+    replay_bytes = 0;
+    replay_packets = 0;
+    replay_elapsed = 0;
+    replay_failed = false;
+
+    uint8_t *buf = malloc(RX_BUF_SIZE);
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    File *file = storage_file_alloc(storage);
+    WendigoRecordHeader header;
+    if (buf == NULL || !storage_file_open(file, WENDIGO_RECORD_PATH, FSAM_READ, FSOM_OPEN_EXISTING) ||
+            storage_file_read(file, &header, sizeof(header)) != sizeof(header) ||
+            memcmp(header.magic, WENDIGO_RECORD_MAGIC, sizeof(header.magic)) ||
+            header.version != WENDIGO_RECORD_VERSION) {
+        wendigo_log(MSG_ERROR, "Unable to read UART recording " WENDIGO_RECORD_PATH);
+        replay_failed = true;
+    } else {
+        uint32_t packets_start = app->packets_parsed;
+        uint32_t start = furi_get_tick();
+        uint8_t divisor = replay_divisor[replay_speed];
+        uint32_t delta;
+        uint16_t len;
+        while ((furi_thread_flags_get() & ReplayEvtStop) == 0 &&
+                storage_file_read(file, &delta, sizeof(delta)) == sizeof(delta) &&
+                storage_file_read(file, &len, sizeof(len)) == sizeof(len)) {
+            if (len > RX_BUF_SIZE || storage_file_read(file, buf, len) != len) {
+                wendigo_log(MSG_WARN, "UART recording is truncated or corrupt, replay stopped.");
+                break;
+            }
+            if (divisor > 0 && delta / divisor > 0 &&
+                    furi_thread_flags_wait(ReplayEvtStop, FuriFlagWaitAny, delta / divisor) == ReplayEvtStop) {
+                break;
+            }
+            wendigo_scan_handle_rx_data_cb(buf, len, app);
+            replay_bytes += len;
+        }
+        replay_elapsed = furi_get_tick() - start;
+        replay_packets = app->packets_parsed - packets_start;
+    }
+    storage_file_close(file);
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    free(buf);
+
+    char *msg = malloc(sizeof(char) * 80);
+    if (msg != NULL) {
+        wendigo_replay_describe_result(msg, 80);
+        wendigo_log(MSG_INFO, msg);
+        free(msg);
+    }
+    replay_running = false;
+    view_dispatcher_send_custom_event(app->view_dispatcher, Wendigo_EventReplayFinished);
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_replay_worker()");
+    return 0;
+}
+
+/** Join and free a replay thread that has finished or been told to stop */
+static void replay_join() {
+    if (replay_thread != NULL) {
+        furi_thread_join(replay_thread);
+        furi_thread_free(replay_thread);
+        replay_thread = NULL;
+    }
+}
+
+/** Start replaying the recording at the specified speed. Returns false if a
+ * replay is already running or the UART is being recorded.
+ */
+bool wendigo_replay_start(WendigoApp *app, ReplaySpeed speed) {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_replay_start()");
+    if (wendigo_record_is_active() || speed >= REPLAY_SPEED_COUNT) {
+        FURI_LOG_T(WENDIGO_TAG, "End wendigo_replay_start()");
+        return false;
+    }
+    /* Clean up after the previous replay */
+    replay_join();
+    replay_speed = speed;
+    replay_running = true;
+    /* Discard data from ESP32 while replaying */
+    wendigo_uart_set_binary_cb(app->uart);
+
+    replay_thread = furi_thread_alloc();
+    furi_thread_set_name(replay_thread, "Wendigo_ReplayThread");
+    furi_thread_set_stack_size(replay_thread, WENDIGO_REPLAY_STACK_SIZE);
+    furi_thread_set_context(replay_thread, app);
+    furi_thread_set_callback(replay_thread, wendigo_replay_worker);
+    furi_thread_start(replay_thread);
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_replay_start()");
+    return true;
+}
+
+/** Stop the replay, if one is running, and wait for its thread to exit */
+void wendigo_replay_stop(WendigoApp *app) {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_replay_stop()");
+    if (replay_thread != NULL) {
+        if (furi_thread_get_state(replay_thread) != FuriThreadStateStopped) {
+            furi_thread_flags_set(furi_thread_get_id(replay_thread), ReplayEvtStop);
+        }
+        replay_join();
+        replay_running = false;
+        wendigo_uart_set_binary_cb(app->uart);
+    }
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_replay_stop()");
+}
+
+/** Describe the results of the most recent replay, for example
+ * "1234 packets in 5.678s (217 packets/s)"
+ */
+void wendigo_replay_describe_result(char *result, uint16_t resultLen) {
+    if (replay_failed) {
+        snprintf(result, resultLen, "Unable to read recording");
+        return;
+    }
+    /* Guard against a replay shorter than a tick */
+    uint32_t elapsed = (replay_elapsed == 0) ? 1 : replay_elapsed;
+    snprintf(result, resultLen, "%lu packets in %lu.%03lus\n(%lu packets/s, %lu bytes)",
+        replay_packets, replay_elapsed / 1000, replay_elapsed % 1000,
+        (uint32_t)((uint64_t)replay_packets * 1000 / elapsed), replay_bytes);
+}
+
+void wendigo_record_free(WendigoApp *app) {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_record_free()");
+    wendigo_replay_stop(app);
+    wendigo_record_stop(app);
+    if (record_mutex != NULL) {
+        furi_mutex_free(record_mutex);
+        record_mutex = NULL;
+    }
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_record_free()");
+}
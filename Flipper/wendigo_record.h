@@ -0,0 +1,31 @@
+#pragma once
+
+#include "wendigo_app_i.h"
+
+/* Raw UART stream recorded from ESP32 - Overwritten each time recording starts */
+#define WENDIGO_RECORD_PATH        APP_DATA_PATH("uart.rec")
+/* Size of the buffer used to batch up writes to the SD card */
+#define WENDIGO_RECORD_BUFFER_SIZE (1024)
+/* Stack size of the replay thread */
+#define WENDIGO_REPLAY_STACK_SIZE  (2048)
+
+/* Replay speeds, indexed by the "Replay" setup menu option */
+typedef enum {
+    REPLAY_1X = 0,
+    REPLAY_10X,
+    REPLAY_MAX,
+    REPLAY_SPEED_COUNT
+} ReplaySpeed;
+
+/* UART callback used while recording or replaying */
+void wendigo_record_rx_data_cb(uint8_t *buf, size_t len, void *context);
+bool wendigo_record_start(WendigoApp *app);
+void wendigo_record_stop(WendigoApp *app);
+bool wendigo_record_is_recording();
+bool wendigo_replay_start(WendigoApp *app, ReplaySpeed speed);
+void wendigo_replay_stop(WendigoApp *app);
+bool wendigo_replay_is_running();
+/* Is either recording or replay active? */
+bool wendigo_record_is_active();
+void wendigo_replay_describe_result(char *result, uint16_t resultLen);
+void wendigo_record_free(WendigoApp *app);
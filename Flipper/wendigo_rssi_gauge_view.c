@@ -0,0 +1,199 @@
+#include "wendigo_rssi_gauge_view.h"
+#include "wendigo_app_i.h"
+#include <gui/elements.h>
+#include <furi.h>
+
+/* The bar covers this range of RSSI, in dBm */
+#define GAUGE_MIN_DBM  (-100)
+#define GAUGE_MAX_DBM  (-30)
+#define GAUGE_X        (4)
+#define GAUGE_Y        (36)
+#define GAUGE_WIDTH    (120)
+#define GAUGE_HEIGHT   (10)
+/* A device with no readings for this long is shown as lost */
+#define GAUGE_LOST_MS  (3000)
+
+struct Wendigo_RssiGaugeView {
+    View *view;
+};
+
+typedef struct {
+    uint8_t mac[MAC_BYTES];
+    int16_t filtered;       /* Tenths of a dBm */
+    int16_t peak;           /* Strongest `filtered` seen */
+    int16_t raw;
+    uint16_t samples;       /* In the latest update */
+    uint32_t heard;         /* Tick of the latest update with samples */
+} Wendigo_RssiGaugeReading;
+
+typedef struct {
+    Wendigo_RssiGaugeReading readings[WENDIGO_RSSI_GAUGE_DEVICES];
+    uint8_t count;
+    uint8_t position;       /* Index of the displayed reading */
+} Wendigo_RssiGaugeViewModel;
+
+/** Horizontal position on the bar of `tenths` of a dBm */
+static uint8_t wendigo_rssi_gauge_view_offset(int16_t tenths) {
+    int32_t dbm10 = tenths;
+    if (dbm10 <= GAUGE_MIN_DBM * 10) {
+        return 0;
+    }
+    if (dbm10 >= GAUGE_MAX_DBM * 10) {
+        return GAUGE_WIDTH - 2;
+    }
+    return (uint8_t)(((dbm10 - GAUGE_MIN_DBM * 10) * (GAUGE_WIDTH - 2)) /
+        ((GAUGE_MAX_DBM - GAUGE_MIN_DBM) * 10));
+}
+
+static void wendigo_rssi_gauge_view_draw_callback(Canvas *canvas, void *_model) {
+    Wendigo_RssiGaugeViewModel *model = _model;
+    canvas_clear(canvas);
+    canvas_set_color(canvas, ColorBlack);
+    canvas_set_font(canvas, FontSecondary);
+    if (model->count == 0) {
+        canvas_draw_str_aligned(canvas, 64, 24, AlignCenter, AlignBottom,
+            "Waiting for tagged");
+        canvas_draw_str_aligned(canvas, 64, 36, AlignCenter, AlignBottom,
+            "devices...");
+        return;
+    }
+    Wendigo_RssiGaugeReading *reading = &(model->readings[model->position]);
+    char str[MAC_STRLEN + 1];
+    bytes_to_string(reading->mac, MAC_BYTES, str);
+    canvas_draw_str_aligned(canvas, 64, 2, AlignCenter, AlignTop, str);
+    if (model->count > 1) {
+        canvas_draw_str(canvas, 0, 10, "<");
+        canvas_draw_str(canvas, 123, 10, ">");
+    }
+
+    /* Smoothed RSSI */
+    int16_t tenths = (reading->filtered < 0) ? -reading->filtered : reading->filtered;
+    char value[16];
+    snprintf(value, sizeof(value), "%s%d.%d dBm", (reading->filtered < 0) ? "-" : "",
+        tenths / 10, tenths % 10);
+    canvas_set_font(canvas, FontPrimary);
+    canvas_draw_str_aligned(canvas, 64, 14, AlignCenter, AlignTop, value);
+
+    /* The bar, with a mark at the peak */
+    canvas_draw_frame(canvas, GAUGE_X, GAUGE_Y, GAUGE_WIDTH, GAUGE_HEIGHT);
+    uint8_t fill = wendigo_rssi_gauge_view_offset(reading->filtered);
+    if (fill > 0) {
+        canvas_draw_box(canvas, GAUGE_X + 1, GAUGE_Y + 1, fill, GAUGE_HEIGHT - 2);
+    }
+    uint8_t peak = GAUGE_X + 1 + wendigo_rssi_gauge_view_offset(reading->peak);
+    canvas_draw_line(canvas, peak, GAUGE_Y - 2, peak, GAUGE_Y + GAUGE_HEIGHT + 1);
+
+    canvas_set_font(canvas, FontSecondary);
+    if (furi_get_tick() - reading->heard > furi_ms_to_ticks(GAUGE_LOST_MS)) {
+        snprintf(value, sizeof(value), "No signal");
+    } else {
+        snprintf(value, sizeof(value), "Raw %d", reading->raw);
+    }
+    canvas_draw_str(canvas, 0, 60, value);
+    snprintf(value, sizeof(value), "%d/%d", model->position + 1, model->count);
+    canvas_draw_str_aligned(canvas, 128, 60, AlignRight, AlignBottom, value);
+}
+
+static bool wendigo_rssi_gauge_view_input_callback(InputEvent *event, void *context) {
+    furi_assert(context);
+    Wendigo_RssiGaugeView *gauge = context;
+    bool consumed = false;
+    if (event->type != InputTypeShort && event->type != InputTypeRepeat) {
+        return false;
+    }
+    with_view_model(
+        gauge->view,
+        Wendigo_RssiGaugeViewModel * model,
+        {
+            if (model->count > 0 && event->key == InputKeyLeft) {
+                model->position = (model->position == 0) ? model->count - 1 : model->position - 1;
+                consumed = true;
+            } else if (model->count > 0 && event->key == InputKeyRight) {
+                model->position = (model->position + 1) % model->count;
+                consumed = true;
+            }
+        },
+        consumed);
+    return consumed;
+}
+
+Wendigo_RssiGaugeView *wendigo_rssi_gauge_view_alloc() {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_rssi_gauge_view_alloc()");
+    Wendigo_RssiGaugeView *gauge = malloc(sizeof(Wendigo_RssiGaugeView));
+    gauge->view = view_alloc();
+    view_set_context(gauge->view, gauge);
+    view_allocate_model(gauge->view, ViewModelTypeLocking, sizeof(Wendigo_RssiGaugeViewModel));
+    view_set_draw_callback(gauge->view, wendigo_rssi_gauge_view_draw_callback);
+    view_set_input_callback(gauge->view, wendigo_rssi_gauge_view_input_callback);
+    wendigo_rssi_gauge_view_reset(gauge);
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_rssi_gauge_view_alloc()");
+    return gauge;
+}
+
+void wendigo_rssi_gauge_view_free(Wendigo_RssiGaugeView *gauge) {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_rssi_gauge_view_free()");
+    furi_assert(gauge);
+    view_free(gauge->view);
+    free(gauge);
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_rssi_gauge_view_free()");
+}
+
+void wendigo_rssi_gauge_view_reset(Wendigo_RssiGaugeView *gauge) {
+    furi_assert(gauge);
+    with_view_model(
+        gauge->view,
+        Wendigo_RssiGaugeViewModel * model,
+        {
+            bzero(model->readings, sizeof(model->readings));
+            model->count = 0;
+            model->position = 0;
+        },
+        true);
+}
+
+View *wendigo_rssi_gauge_view_get_view(Wendigo_RssiGaugeView *gauge) {
+    furi_assert(gauge);
+    return gauge->view;
+}
+
+void wendigo_rssi_gauge_view_update(Wendigo_RssiGaugeView *gauge, const uint8_t *mac,
+        int16_t filtered, int16_t raw, uint16_t samples) {
+    furi_assert(gauge);
+    uint32_t now = furi_get_tick();
+    with_view_model(
+        gauge->view,
+        Wendigo_RssiGaugeViewModel * model,
+        {
+            uint8_t idx;
+            for (idx = 0; idx < model->count && memcmp(model->readings[idx].mac, mac, MAC_BYTES);
+                ++idx) { }
+            if (idx == model->count) {
+                if (model->count < WENDIGO_RSSI_GAUGE_DEVICES) {
+                    ++model->count;
+                } else {
+                    /* Replace the device heard least recently, unless it's on screen */
+                    idx = (model->position == 0) ? 1 : 0;
+                    for (uint8_t i = 0; i < model->count; ++i) {
+                        if (i != model->position &&
+                                (int32_t)(model->readings[i].heard - model->readings[idx].heard) < 0) {
+                            idx = i;
+                        }
+                    }
+                }
+                memcpy(model->readings[idx].mac, mac, MAC_BYTES);
+                model->readings[idx].peak = filtered;
+                model->readings[idx].heard = now;
+            }
+            Wendigo_RssiGaugeReading *reading = &(model->readings[idx]);
+            reading->filtered = filtered;
+            reading->raw = raw;
+            reading->samples = samples;
+            if (samples > 0) {
+                reading->heard = now;
+            }
+            if (filtered > reading->peak) {
+                reading->peak = filtered;
+            }
+        },
+        true);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <gui/view.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Most devices the gauge holds readings for. ESP32-Wendigo tracks up to
+ * CONFIG_FOCUS_RSSI_MAX_DEVICES; if it sends more the stalest is replaced. */
+#define WENDIGO_RSSI_GAUGE_DEVICES (8)
+
+/** RSSI gauge view anonymous structure */
+typedef struct Wendigo_RssiGaugeView Wendigo_RssiGaugeView;
+
+/** Allocate and initialise the RSSI gauge view
+ *
+ * The gauge shows the smoothed signal strength of one tagged device at a
+ * time as a number and a bar, with a mark at the strongest signal seen so
+ * far. Left and Right move between devices. Readings are kept in the view's
+ * model, not in the device cache, so they can arrive many times a second.
+ *
+ * @return     Wendigo_RssiGaugeView instance
+ */
+Wendigo_RssiGaugeView *wendigo_rssi_gauge_view_alloc();
+
+/** Deinitialise and free the RSSI gauge view
+ *
+ * @param      gauge  Wendigo_RssiGaugeView instance
+ */
+void wendigo_rssi_gauge_view_free(Wendigo_RssiGaugeView *gauge);
+
+/** Forget all readings
+ *
+ * @param      gauge  Wendigo_RssiGaugeView instance
+ */
+void wendigo_rssi_gauge_view_reset(Wendigo_RssiGaugeView *gauge);
+
+/** Get the RSSI gauge's view
+ *
+ * @param      gauge  Wendigo_RssiGaugeView instance
+ *
+ * @return     View instance that can be used for embedding
+ */
+View *wendigo_rssi_gauge_view_get_view(Wendigo_RssiGaugeView *gauge);
+
+/** Record a reading for the device with MAC `mac` and redraw the gauge
+ *
+ * @param      gauge     Wendigo_RssiGaugeView instance
+ * @param      mac       the device's MAC or BDA (6 bytes)
+ * @param      filtered  smoothed RSSI in tenths of a dBm
+ * @param      raw       latest RSSI in dBm
+ * @param      samples   readings taken since the last update
+ */
+void wendigo_rssi_gauge_view_update(Wendigo_RssiGaugeView *gauge, const uint8_t *mac,
+    int16_t filtered, int16_t raw, uint16_t samples);
+
+#ifdef __cplusplus
+}
+#endif
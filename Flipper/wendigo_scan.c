@@ -1,6 +1,10 @@
 #include "wendigo_scan.h"
 #include "wendigo_app_i.h"
 #include "wendigo_common_defs.h"
+#include "wendigo_hash.h"
+#include "wendigo_pool.h"
+#include "wendigo_prune.h"
+#include "wendigo_spill.h"
 
 uint8_t *buffer = NULL;
 uint16_t bufferLen = 0; // 65535 should be plenty of length
@@ -14,8 +18,29 @@ wendigo_device **devices = NULL;
 uint16_t devices_count = 0;
 uint16_t devices_capacity = 0;
 
-/* How much will we increase bt_devices[] by when additional space is needed? */
-#define INC_DEVICE_CAPACITY_BY 10
+/* Devices added or updated while the device list is displayed, indexed by
+   their position in devices[]. The UART thread marks devices here rather than
+   updating the device list itself, and the device list scene flushes the set from its tick
+   event - so the cost of updating the UI is bounded by the refresh rate rather
+   than the packet rate. Protected by app->devicesMutex. */
+uint32_t *dirty_devices = NULL;
+uint16_t dirty_devices_capacity = 0; /* Number of bits in dirty_devices[] */
+
+/* MAC hash index (see wendigo_hash.h) - Table of (index into devices[] + 1),
+   with 0 marking an empty slot, so that finding a device by MAC - for every
+   packet received, and for every station when listing an AP's stations -
+   doesn't search devices[]. Removing a device moves those after it in
+   devices[], so the index is renumbered when that happens. */
+static uint16_t *mac_index = NULL;
+static uint16_t mac_index_capacity = 0;
+/* After mac_index[] couldn't be grown, don't try again until devices_count
+   reaches this */
+static uint16_t mac_index_retry_at = 0;
+
+/* Initial capacity of devices[] - Capacity doubles when additional space is needed */
+#define MIN_DEVICE_CAPACITY 32
+/* Number of devices represented by each element of dirty_devices[] */
+#define DIRTY_BITS_PER_WORD (sizeof(uint32_t) * 8)
 /* Maximum size of UART buffer - If a packet terminator isn't found within this
    region older data will be removed */
 #define BUFFER_MAX_SIZE 4096
@@ -41,7 +66,9 @@ uint16_t start_of_packet(uint8_t *bytes, uint16_t size) {
             memcmp(bytes + result, PREAMBLE_STATUS, PREAMBLE_LEN) &&
             memcmp(bytes + result, PREAMBLE_CHANNELS, PREAMBLE_LEN) &&
             memcmp(bytes + result, PREAMBLE_VER, PREAMBLE_LEN) &&
-            memcmp(bytes + result, PREAMBLE_MAC, PREAMBLE_LEN);
+            memcmp(bytes + result, PREAMBLE_MAC, PREAMBLE_LEN) &&
+            memcmp(bytes + result, PREAMBLE_BT_SVC, PREAMBLE_LEN) &&
+            memcmp(bytes + result, PREAMBLE_RSSI, PREAMBLE_LEN);
         ++result) {
     }
     /* If not found, set result to size */
@@ -85,6 +112,40 @@ void wendigo_version(WendigoApp *app) {
     FURI_LOG_T(WENDIGO_TAG, "End wendigo_version()");
 }
 
+/** Tag or untag `dev` on ESP32-Wendigo to match dev->tagged. ESP32-Wendigo
+ *  only tracks the signal strength of tagged devices in Focus Mode, and
+ *  starts GATT service discovery of BLE devices when they're tagged.
+ */
+void wendigo_tag_device(WendigoApp *app, wendigo_device *dev) {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_tag_device()");
+    if (app == NULL || dev == NULL) {
+        wendigo_log(MSG_ERROR, "wendigo_tag_device() called with invalid arguments");
+        return;
+    }
+    const uint8_t CMD_LEN = 26; // e.g. "t b 00:11:22:33:44:55 1\n\0"
+    char cmdString[CMD_LEN];
+    char macStr[MAC_STRLEN + 1];
+    bytes_to_string(dev->mac, MAC_BYTES, macStr);
+    snprintf(cmdString, CMD_LEN, "t %c %s %d\n",
+        (dev->scanType == SCAN_HCI || dev->scanType == SCAN_BLE) ? 'b' : 'w', macStr,
+        (dev->tagged) ? 1 : 0);
+    wendigo_uart_tx(app->uart, (uint8_t *)cmdString, strlen(cmdString) + 1);
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_tag_device()");
+}
+
+/** Enable or disable Focus Mode. While it's enabled ESP32-Wendigo reports
+ *  tagged devices only, and streams RSSI packets for them.
+ */
+void wendigo_set_focus(WendigoApp *app, bool enable) {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_set_focus()");
+    char cmd[] = "f 0\n";
+    if (enable) {
+        cmd[2] = '1';
+    }
+    wendigo_uart_tx(app->uart, (uint8_t *)cmd, strlen(cmd) + 1);
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_set_focus()");
+}
+
 /** This callback is called by app->scan_timer. If a Wendigo packet
  * hasn't been received in the last 3 seconds it sends commands to
  * restart scanning, on the assumption that the ESP32 has reset.
@@ -190,13 +251,117 @@ uint16_t custom_device_index(wendigo_device *dev, wendigo_device **array,
     return result;
 }
 
+/** Add devices[idx] to mac_index[]. mac_index[] must have a free slot. */
+static void mac_index_insert(uint16_t idx) {
+    uint16_t mask = mac_index_capacity - 1;
+    uint16_t slot = wendigo_hash_mac(devices[idx]->mac) & mask;
+    while (mac_index[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    mac_index[slot] = idx + 1;
+}
+
+/** Replace mac_index[] with one of `capacity` slots and index devices[] into
+ * it. Returns false, leaving mac_index[] as it was, if memory could not be
+ * allocated.
+ */
+static bool mac_index_grow(uint16_t capacity) {
+    uint16_t *new_index = malloc(sizeof(uint16_t) * capacity);
+    if (new_index == NULL) {
+        return false;
+    }
+    if (mac_index != NULL) {
+        free(mac_index);
+    }
+    mac_index = new_index;
+    mac_index_capacity = capacity;
+    memset(mac_index, 0, sizeof(uint16_t) * mac_index_capacity);
+    for (uint16_t i = 0; i < devices_count; ++i) {
+        mac_index_insert(i);
+    }
+    return true;
+}
+
+/** Index devices[idx], which has just been added to the end of devices[],
+ * growing mac_index[] first if it needs to be. Without an index at all
+ * device_index() falls back to a linear search.
+ */
+static void mac_index_add(uint16_t idx) {
+    uint16_t new_capacity = wendigo_index_grow_capacity(devices_count, mac_index_capacity,
+        MIN_DEVICE_CAPACITY * 2, mac_index_retry_at);
+    if (new_capacity != 0) {
+        if (mac_index_grow(new_capacity)) {
+            /* Growing the index re-indexes everything, including devices[idx] */
+            return;
+        }
+        mac_index_retry_at = wendigo_index_retry_at(devices_count);
+        wendigo_log(MSG_WARN, "Unable to grow MAC index, device lookups will be slower.");
+    }
+    if (mac_index == NULL) {
+        return;
+    }
+    if (devices_count < mac_index_capacity) {
+        mac_index_insert(idx);
+    } else {
+        /* Full, and can't be grown - Fall back to a linear search */
+        free(mac_index);
+        mac_index = NULL;
+        mac_index_capacity = 0;
+    }
+}
+
+/** Remove devices[idx] from mac_index[], which must be done before it's
+ * removed from devices[], and renumber the devices after it to match their
+ * new indexes. Entries after the removed one in its probe sequence are
+ * shifted back into the gap, so that nothing needs to be re-hashed.
+ */
+static void mac_index_remove(uint16_t idx) {
+    if (mac_index == NULL) {
+        return;
+    }
+    uint16_t mask = mac_index_capacity - 1;
+    uint16_t gap = wendigo_hash_mac(devices[idx]->mac) & mask;
+    while (mac_index[gap] != 0 && mac_index[gap] != idx + 1) {
+        gap = (gap + 1) & mask;
+    }
+    if (mac_index[gap] != 0) {
+        for (uint16_t slot = (gap + 1) & mask; mac_index[slot] != 0; slot = (slot + 1) & mask) {
+            uint16_t home = wendigo_hash_mac(devices[mac_index[slot] - 1]->mac) & mask;
+            if (wendigo_index_can_fill(home, gap, slot, mask)) {
+                mac_index[gap] = mac_index[slot];
+                gap = slot;
+            }
+        }
+        mac_index[gap] = 0;
+    }
+    for (uint16_t slot = 0; slot < mac_index_capacity; ++slot) {
+        if (mac_index[slot] > idx + 1) {
+            --mac_index[slot];
+        }
+    }
+}
+
 /** Returns the index into devices[] of the device with MAC/BDA matching
- *  dev->mac. Returns devices_count if the device was not found. A NULL value for
- *  `dev` is handled correctly by custom_device_index()
+ *  dev->mac. Returns devices_count if the device was not found.
  */
 uint16_t device_index(wendigo_device *dev) {
-    FURI_LOG_T(WENDIGO_TAG, "Start+End device_index()");
-    return custom_device_index(dev, devices, devices_count);
+    FURI_LOG_T(WENDIGO_TAG, "Start device_index()");
+    if (dev == NULL || devices == NULL || devices_count == 0) {
+        FURI_LOG_T(WENDIGO_TAG, "End device_index() - No devices.");
+        return devices_count;
+    }
+    uint16_t idx;
+    if (mac_index != NULL) {
+        uint16_t mask = mac_index_capacity - 1;
+        uint16_t slot = wendigo_hash_mac(dev->mac) & mask;
+        for (; mac_index[slot] != 0 && memcmp(dev->mac, devices[mac_index[slot] - 1]->mac, MAC_BYTES);
+                slot = (slot + 1) & mask) { }
+        idx = (mac_index[slot] == 0) ? devices_count : mac_index[slot] - 1;
+    } else {
+        idx = custom_device_index(dev, devices, devices_count);
+    }
+    FURI_LOG_T(WENDIGO_TAG, "End device_index()");
+    return idx;
 }
 
 /** Returns the index into devices[] of the device with MAC/BDA matching mac.
@@ -239,238 +404,293 @@ uint8_t wendigo_index_of_string(char *str, char **array, uint8_t array_len) {
     return idx;
 }
 
-/** Called from parseBufferBluetooth(), this function updates the existing device
- *  `dev` with new attributes from `new_device`.
+/** Copy the string `src`, of length `len`, into the arena allocation `*dest`.
+ *  If `*dest` already contains the same string it is left untouched, otherwise
+ *  it is resized (in place where possible) and overwritten. Returns false if
+ *  memory could not be allocated, in which case `*dest` is unmodified.
+ */
+static bool wendigo_arena_copy_str(char **dest, const char *src, uint16_t len) {
+    uint16_t dest_len = (*dest == NULL) ? 0 : strlen(*dest);
+    if (*dest != NULL && dest_len == len && !strncmp(*dest, src, len)) {
+        return true;
+    }
+    char *result = wendigo_arena_realloc(*dest, (*dest == NULL) ? 0 : dest_len + 1, len + 1);
+    if (result == NULL) {
+        return false;
+    }
+    memcpy(result, src, len);
+    result[len] = '\0';
+    *dest = result;
+    return true;
+}
+
+/** As wendigo_arena_copy_str() for arbitrary data. `dest_len` is the size of
+ *  the existing allocation `*dest` and `len` the number of bytes in `src`.
+ */
+static bool wendigo_arena_copy_bytes(void **dest, uint16_t dest_len, const void *src, uint16_t len) {
+    if (*dest != NULL && dest_len == len && !memcmp(*dest, src, len)) {
+        return true;
+    }
+    void *result = wendigo_arena_realloc(*dest, (*dest == NULL) ? 0 : dest_len, len);
+    if (result == NULL) {
+        return false;
+    }
+    memcpy(result, src, len);
+    *dest = result;
+    return true;
+}
+
+/** Called from wendigo_add_device(), this function copies the Bluetooth
+ *  attributes of `dev` into the newly-allocated cache entry `new_device`.
+ *  Attributes are allocated from the device arena; allocation failures are not
+ *  fatal - we simply don't copy that attribute and hope we have memory for it
+ *  next time the device is seen.
  *  Returns a boolean representing the success or failure of the function.
  */
 bool wendigo_add_bt_device(wendigo_device *dev, wendigo_device *new_device) {
     FURI_LOG_T(WENDIGO_TAG, "Start wendigo_add_bt_device()");
     new_device->radio.bluetooth.cod = dev->radio.bluetooth.cod;
-    if (dev->radio.bluetooth.cod_str != NULL) {
-        new_device->radio.bluetooth.cod_str =
-            malloc(strlen(dev->radio.bluetooth.cod_str) + 1);
-        if (new_device->radio.bluetooth.cod_str != NULL) {
-            /* No need to handle allocation failure - we simply don't copy cod_str */
-            strncpy(new_device->radio.bluetooth.cod_str, dev->radio.bluetooth.cod_str,
-                strlen(dev->radio.bluetooth.cod_str));
-            new_device->radio.bluetooth.cod_str[strlen(dev->radio.bluetooth.cod_str)] = '\0';
-        }
-    } else {
-        new_device->radio.bluetooth.cod_str = NULL;
-    }
+    new_device->radio.bluetooth.cod_major = dev->radio.bluetooth.cod_major;
+    new_device->radio.bluetooth.cod_minor = dev->radio.bluetooth.cod_minor;
     /* Device name */
-    new_device->radio.bluetooth.bdname_len = dev->radio.bluetooth.bdname_len;
     if (dev->radio.bluetooth.bdname_len > 0 && dev->radio.bluetooth.bdname != NULL) {
-        new_device->radio.bluetooth.bdname = malloc(dev->radio.bluetooth.bdname_len + 1);
-        if (new_device->radio.bluetooth.bdname == NULL) {
-            /* Skip the device's bdname and hope we have memory for it next time it's seen */
-            new_device->radio.bluetooth.bdname_len = 0;
-        } else {
-            strncpy(new_device->radio.bluetooth.bdname, dev->radio.bluetooth.bdname,
-                    dev->radio.bluetooth.bdname_len);
-            new_device->radio.bluetooth.bdname[dev->radio.bluetooth.bdname_len] = '\0';
+        new_device->radio.bluetooth.bdname = wendigo_arena_strndup(
+            dev->radio.bluetooth.bdname, dev->radio.bluetooth.bdname_len);
+        if (new_device->radio.bluetooth.bdname != NULL) {
+            new_device->radio.bluetooth.bdname_len = dev->radio.bluetooth.bdname_len;
         }
-    } else {
-        new_device->radio.bluetooth.bdname = NULL;
-        new_device->radio.bluetooth.bdname_len = 0;
     }
     /* EIR */
-    new_device->radio.bluetooth.eir_len = dev->radio.bluetooth.eir_len;
-    if (dev->radio.bluetooth.eir_len > 0 && dev->radio.bluetooth.eir != NULL) {
-        new_device->radio.bluetooth.eir = malloc(dev->radio.bluetooth.eir_len);
-        if (new_device->radio.bluetooth.eir == NULL) {
-            /* Skip EIR from this packet */
-            new_device->radio.bluetooth.eir_len = 0;
-        } else {
-            memcpy(new_device->radio.bluetooth.eir, dev->radio.bluetooth.eir,
-                dev->radio.bluetooth.eir_len);
-        }
-    } else {
-        new_device->radio.bluetooth.eir = NULL;
-        new_device->radio.bluetooth.eir_len = 0;
+    if (dev->radio.bluetooth.eir_len > 0 && dev->radio.bluetooth.eir != NULL &&
+            wendigo_arena_copy_bytes((void **)&(new_device->radio.bluetooth.eir), 0,
+                dev->radio.bluetooth.eir, dev->radio.bluetooth.eir_len)) {
+        new_device->radio.bluetooth.eir_len = dev->radio.bluetooth.eir_len;
     }
     /* BT services */
-    new_device->radio.bluetooth.bt_services.num_services = dev->radio.bluetooth.bt_services.num_services;
     if (dev->radio.bluetooth.bt_services.num_services > 0 &&
-            dev->radio.bluetooth.bt_services.service_uuids != NULL) {
-        new_device->radio.bluetooth.bt_services.service_uuids =
-            malloc(sizeof(void *) * dev->radio.bluetooth.bt_services.num_services);
-        if (new_device->radio.bluetooth.bt_services.service_uuids == NULL) {
-            new_device->radio.bluetooth.bt_services.num_services = 0;
-        } else {
-            memcpy(new_device->radio.bluetooth.bt_services.service_uuids,
+            dev->radio.bluetooth.bt_services.service_uuids != NULL &&
+            wendigo_arena_copy_bytes((void **)&(new_device->radio.bluetooth.bt_services.service_uuids), 0,
                 dev->radio.bluetooth.bt_services.service_uuids,
-                sizeof(void *) * dev->radio.bluetooth.bt_services.num_services);
-        }
-    } else {
-        new_device->radio.bluetooth.bt_services.service_uuids = NULL;
-        new_device->radio.bluetooth.bt_services.num_services = 0;
-    }
-    /* Known services */
-    new_device->radio.bluetooth.bt_services.known_services_len =
-            dev->radio.bluetooth.bt_services.known_services_len;
+                sizeof(esp_bt_uuid_t) * dev->radio.bluetooth.bt_services.num_services)) {
+        new_device->radio.bluetooth.bt_services.num_services =
+            dev->radio.bluetooth.bt_services.num_services;
+    }
+    /* Known services - known_services is an array of pointers; this is where we
+       stop controlling memory allocation so that bt_uuid's can be allocated a
+       single time and reused. This function will copy the *pointers* in
+       known_services[], but not the bt_uuid structs that they point to. */
     if (dev->radio.bluetooth.bt_services.known_services_len > 0 &&
-            dev->radio.bluetooth.bt_services.known_services != NULL) {
-        /* known_services is an array of pointers - this is where we stop
-            controlling memory allocation so that bt_uuid's can be allocated a single
-            time and reused. This function will copy the *pointers* in
-            known_services[], but not the bt_uuid structs that they point to. */
-        new_device->radio.bluetooth.bt_services.known_services = malloc(sizeof(bt_uuid *) *
-                dev->radio.bluetooth.bt_services.known_services_len);
-        if (new_device->radio.bluetooth.bt_services.known_services == NULL) {
-            new_device->radio.bluetooth.bt_services.known_services_len = 0;
-        } else {
-            memcpy(new_device->radio.bluetooth.bt_services.known_services,
+            dev->radio.bluetooth.bt_services.known_services != NULL &&
+            wendigo_arena_copy_bytes((void **)&(new_device->radio.bluetooth.bt_services.known_services), 0,
                 dev->radio.bluetooth.bt_services.known_services,
-                sizeof(bt_uuid *) * dev->radio.bluetooth.bt_services.known_services_len);
-            // TODO: Despite the caveat above, it might be nice to validate that the
-            // bt_uuid's we're pointing to actually exist.
-        }
-    } else {
-        new_device->radio.bluetooth.bt_services.known_services = NULL;
-        new_device->radio.bluetooth.bt_services.known_services_len = 0;
+                sizeof(bt_uuid *) * dev->radio.bluetooth.bt_services.known_services_len)) {
+        // TODO: Despite the caveat above, it might be nice to validate that the
+        // bt_uuid's we're pointing to actually exist.
+        new_device->radio.bluetooth.bt_services.known_services_len =
+            dev->radio.bluetooth.bt_services.known_services_len;
     }
     FURI_LOG_T(WENDIGO_TAG, "End wendigo_add_bt_device()");
     return true;
 }
 
-/** Updates the existing device `dev` based on the newly-received device `new_device`.
- *  This function is called from parseBufferBluetooth() when a bluetooth packet
- *  referring to an existing device is received.
+/** Updates the existing device `new_device` based on the newly-received device `dev`.
+ *  This function is called from wendigo_update_device() when a bluetooth packet
+ *  referring to an existing device is received. Attributes whose content hasn't
+ *  changed are left where they are in the arena; if an allocation fails the
+ *  target's existing attribute is left unmodified.
  *  Returns a boolean indicating the success/failure of the function.
  */
 bool wendigo_update_bt_device(wendigo_device *dev, wendigo_device *new_device) {
     FURI_LOG_T(WENDIGO_TAG, "Start wendigo_update_bt_device()");
     new_device->radio.bluetooth.cod = dev->radio.bluetooth.cod;
-    /* cod_str present in update? */
-    if (dev->radio.bluetooth.cod_str != NULL && strlen(dev->radio.bluetooth.cod_str) > 0) {
-        char *new_cod = realloc(new_device->radio.bluetooth.cod_str,
-                strlen(dev->radio.bluetooth.cod_str) + 1);
-        if (new_cod != NULL) {
-            strncpy(new_cod, dev->radio.bluetooth.cod_str, strlen(dev->radio.bluetooth.cod_str));
-            new_cod[strlen(dev->radio.bluetooth.cod_str)] = '\0';
-            new_device->radio.bluetooth.cod_str = new_cod;
-        }
-    }
+    new_device->radio.bluetooth.cod_major = dev->radio.bluetooth.cod_major;
+    new_device->radio.bluetooth.cod_minor = dev->radio.bluetooth.cod_minor;
     /* Is bdname in update? */
-    if (dev->radio.bluetooth.bdname_len > 0 && dev->radio.bluetooth.bdname != NULL) {
-        char *new_name = realloc(new_device->radio.bluetooth.bdname,
-                dev->radio.bluetooth.bdname_len + 1);
-        if (new_name != NULL) { /* If allocation fails target's existing bdname and
-                                    bdname_len are unmodified */
-            strncpy(new_name, dev->radio.bluetooth.bdname, dev->radio.bluetooth.bdname_len);
-            new_name[dev->radio.bluetooth.bdname_len] = '\0';
-            new_device->radio.bluetooth.bdname = new_name;
-            new_device->radio.bluetooth.bdname_len = dev->radio.bluetooth.bdname_len;
-        }
+    if (dev->radio.bluetooth.bdname_len > 0 && dev->radio.bluetooth.bdname != NULL &&
+            wendigo_arena_copy_str(&(new_device->radio.bluetooth.bdname),
+                dev->radio.bluetooth.bdname, dev->radio.bluetooth.bdname_len)) {
+        new_device->radio.bluetooth.bdname_len = dev->radio.bluetooth.bdname_len;
     }
     /* How about EIR? */
-    if (dev->radio.bluetooth.eir_len > 0 && dev->radio.bluetooth.eir != NULL) {
-        uint8_t *new_eir = realloc(new_device->radio.bluetooth.eir,
-            dev->radio.bluetooth.eir_len);
-        if (new_eir != NULL) {
-            memcpy(new_eir, dev->radio.bluetooth.eir, sizeof(uint8_t) * dev->radio.bluetooth.eir_len);
-            new_device->radio.bluetooth.eir = new_eir;
-            new_device->radio.bluetooth.eir_len = dev->radio.bluetooth.eir_len;
-        }
+    if (dev->radio.bluetooth.eir_len > 0 && dev->radio.bluetooth.eir != NULL &&
+            wendigo_arena_copy_bytes((void **)&(new_device->radio.bluetooth.eir),
+                new_device->radio.bluetooth.eir_len, dev->radio.bluetooth.eir,
+                dev->radio.bluetooth.eir_len)) {
+        new_device->radio.bluetooth.eir_len = dev->radio.bluetooth.eir_len;
     }
     /* Number of services */
     if (dev->radio.bluetooth.bt_services.num_services > 0 &&
-            dev->radio.bluetooth.bt_services.service_uuids != NULL) {
-        void *new_svcs = realloc(new_device->radio.bluetooth.bt_services.service_uuids,
-                sizeof(void *) * dev->radio.bluetooth.bt_services.num_services);
-        if (new_svcs != NULL) {
-            memcpy(new_svcs, dev->radio.bluetooth.bt_services.service_uuids,
-                sizeof(void *) * dev->radio.bluetooth.bt_services.num_services);
-            new_device->radio.bluetooth.bt_services.service_uuids = new_svcs;
-            new_device->radio.bluetooth.bt_services.num_services =
-                dev->radio.bluetooth.bt_services.num_services;
-        }
+            dev->radio.bluetooth.bt_services.service_uuids != NULL &&
+            wendigo_arena_copy_bytes((void **)&(new_device->radio.bluetooth.bt_services.service_uuids),
+                sizeof(esp_bt_uuid_t) * new_device->radio.bluetooth.bt_services.num_services,
+                dev->radio.bluetooth.bt_services.service_uuids,
+                sizeof(esp_bt_uuid_t) * dev->radio.bluetooth.bt_services.num_services)) {
+        new_device->radio.bluetooth.bt_services.num_services =
+            dev->radio.bluetooth.bt_services.num_services;
     }
     /* Known services */
     if (dev->radio.bluetooth.bt_services.known_services_len > 0 &&
-            dev->radio.bluetooth.bt_services.known_services != NULL) {
-        bt_uuid **new_known_svcs = realloc(new_device->radio.bluetooth.bt_services.known_services,
-                sizeof(bt_uuid *) * dev->radio.bluetooth.bt_services.known_services_len);
-        if (new_known_svcs != NULL) {
-            memcpy(new_known_svcs, dev->radio.bluetooth.bt_services.known_services, sizeof(bt_uuid *) *
-                    dev->radio.bluetooth.bt_services.known_services_len);
-            new_device->radio.bluetooth.bt_services.known_services = new_known_svcs;
-            new_device->radio.bluetooth.bt_services.known_services_len =
-                    dev->radio.bluetooth.bt_services.known_services_len;
-        }
+            dev->radio.bluetooth.bt_services.known_services != NULL &&
+            wendigo_arena_copy_bytes((void **)&(new_device->radio.bluetooth.bt_services.known_services),
+                sizeof(bt_uuid *) * new_device->radio.bluetooth.bt_services.known_services_len,
+                dev->radio.bluetooth.bt_services.known_services,
+                sizeof(bt_uuid *) * dev->radio.bluetooth.bt_services.known_services_len)) {
+        new_device->radio.bluetooth.bt_services.known_services_len =
+            dev->radio.bluetooth.bt_services.known_services_len;
     }
     FURI_LOG_T(WENDIGO_TAG, "End wendigo_update_bt_device()");
     return true;
 }
 
-/** Add the specified device to devices[], extending the length of devices[] if
- * necessary. If the specified device has a MAC/BDA which is already present in
- * devices[] a new entry will not be made, instead the element with the same
- * MAC/BDA will be updated based on the specified device. Returns true if the
- * device was successfully added to (or updated in) devices[]. NOTE: The calling
- * function may free the specified wendigo_device or any of its attributes when
- * this function returns. To minimise the likelihood of memory leaks this
- * function will allocate its own memory to hold the specified device and its
- * attributes.
+/** Mark devices[idx] as needing to be added to, or repositioned in, the
+ * device list. If the dirty set can't be grown to include `idx` the device
+ * list scene is asked to check every device instead - this is slower, but the
+ * device won't go missing from the UI. This is called from the UART thread,
+ * so the device list itself is only ever changed by the GUI thread.
+ * The caller must hold app->devicesMutex.
  */
-bool wendigo_add_device(WendigoApp *app, wendigo_device *dev) {
-    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_add_device()");
-    uint16_t idx = device_index(dev);
-    if (idx < devices_count) {
-        /* A device with the provided BDA already exists - Update that instead */
-        return wendigo_update_device(app, dev);
+void wendigo_mark_device_dirty_locked(WendigoApp *app, uint16_t idx) {
+    if (idx >= dirty_devices_capacity) {
+        /* Grow dirty_devices[] to cover all of devices[] */
+        uint16_t words = (devices_capacity + DIRTY_BITS_PER_WORD - 1) / DIRTY_BITS_PER_WORD;
+        uint16_t old_words = dirty_devices_capacity / DIRTY_BITS_PER_WORD;
+        uint32_t *new_dirty = realloc(dirty_devices, sizeof(uint32_t) * words);
+        if (new_dirty == NULL || idx >= words * DIRTY_BITS_PER_WORD) {
+            if (new_dirty != NULL) {
+                dirty_devices = new_dirty;
+            }
+            wendigo_log(MSG_WARN,
+                "Unable to grow dirty_devices[], refreshing the whole device list.");
+            view_dispatcher_send_custom_event(app->view_dispatcher,
+                Wendigo_EventRefreshDeviceList);
+            return;
+        }
+        bzero(new_dirty + old_words, sizeof(uint32_t) * (words - old_words));
+        dirty_devices = new_dirty;
+        dirty_devices_capacity = words * DIRTY_BITS_PER_WORD;
     }
-    /* Adding to devices - Increase capacity by an additional INC_DEVICE_CAPACITY_BY if necessary */
+    dirty_devices[idx / DIRTY_BITS_PER_WORD] |= (1UL << (idx % DIRTY_BITS_PER_WORD));
+}
+
+/** Pass all devices marked by wendigo_mark_device_dirty_locked() to the device list
+ * and clear the dirty set. A device that was added and then updated many
+ * times since the last flush is only passed once. Devices are discarded
+ * without updating the UI if the device list is no longer displayed.
+ * Called from the device list scene's tick event.
+ * Returns the number of devices flushed.
+ */
+uint16_t wendigo_flush_dirty_devices(WendigoApp *app) {
+    uint16_t result = 0;
+    furi_mutex_acquire(app->devicesMutex, FuriWaitForever);
+    if (dirty_devices == NULL) {
+        furi_mutex_release(app->devicesMutex);
+        return 0;
+    }
+    uint16_t words = dirty_devices_capacity / DIRTY_BITS_PER_WORD;
+    bool displayed = app->current_view == WendigoAppViewDeviceList;
+    if (displayed) {
+        wendigo_scene_device_list_begin_refresh(app);
+    }
+    for (uint16_t w = 0; w < words; ++w) {
+        uint32_t bits = dirty_devices[w];
+        if (bits == 0) {
+            continue;
+        }
+        dirty_devices[w] = 0;
+        for (uint8_t b = 0; bits != 0; ++b, bits >>= 1) {
+            uint16_t idx = (w * DIRTY_BITS_PER_WORD) + b;
+            if ((bits & 1) == 1 && idx < devices_count && displayed) {
+                wendigo_scene_device_list_update(app, devices[idx]);
+                ++result;
+            }
+        }
+    }
+    if (displayed) {
+        wendigo_scene_device_list_end_refresh(app);
+    }
+    furi_mutex_release(app->devicesMutex);
+    return result;
+}
+
+/** Copy `dev` into a new record at the end of devices[], extending the length
+ * of devices[] if necessary. The new device's tagged status and lastSeen are
+ * reset unless `restoring` is true, in which case `dev` is a device that was
+ * previously cached and they're kept.
+ * The caller must hold app->devicesMutex and have checked that the device
+ * isn't already cached.
+ * Returns the new device, or NULL if memory could not be allocated.
+ */
+wendigo_device *wendigo_cache_device(WendigoApp *app, wendigo_device *dev, bool restoring) {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_cache_device()");
+    /* Adding to devices - Double its capacity (to a minimum of
+       MIN_DEVICE_CAPACITY) if necessary, so that reallocs become rare as the
+       cache grows rather than happening every few devices */
     if (devices == NULL || devices_capacity == devices_count) {
-        wendigo_device **new_devices = realloc(devices, sizeof(wendigo_device *) *
-                                        (devices_capacity + INC_DEVICE_CAPACITY_BY));
+        uint16_t new_capacity = (devices_capacity < MIN_DEVICE_CAPACITY) ?
+            MIN_DEVICE_CAPACITY : devices_capacity * 2;
+        if (new_capacity < devices_capacity) {
+            /* uint16_t overflow - Fall back to the largest capacity possible */
+            new_capacity = UINT16_MAX;
+        }
+        if (new_capacity == devices_capacity) {
+            return NULL;
+        }
+        wendigo_device **new_devices = realloc(devices, sizeof(wendigo_device *) * new_capacity);
         if (new_devices == NULL) {
             /* Can't store the device */
-            return false;
+            return NULL;
         }
         devices = new_devices;
-        devices_capacity += INC_DEVICE_CAPACITY_BY;
+        devices_capacity = new_capacity;
     }
-    devices[devices_count] = malloc(sizeof(wendigo_device));
+    devices[devices_count] = wendigo_pool_alloc_device();
     if (devices[devices_count] == NULL) {
         /* That's unfortunate */
-        return false;
+        return NULL;
     }
     wendigo_device *new_device = devices[devices_count++];
     /* Copy common attributes */
     new_device->rssi = dev->rssi;
     new_device->scanType = dev->scanType;
-    /* Don't copy tagged status - A new device is not tagged. */
-    new_device->tagged = false;
-    new_device->view = dev->view; /* Copy the view pointer if we have one, NULL if we don't */
+    /* Don't copy tagged status - A new device is not tagged - unless it's a
+       device we've seen before coming back from the SD card */
+    new_device->tagged = restoring && dev->tagged;
+    new_device->view_option = dev->view_option;
     /* ESP32 doesn't know the real time/date so overwrite the lastSeen value.
        time_t is just another way of saying long long int, so casting is OK */
-    new_device->lastSeen = furi_hal_rtc_get_timestamp();
+    new_device->lastSeen = (restoring) ? dev->lastSeen : furi_hal_rtc_get_timestamp();
     /* Copy MAC/BDA */
     memcpy(new_device->mac, dev->mac, MAC_BYTES);
+    mac_index_add(devices_count - 1);
     /* Copy protocol-specific attributes */
     if (dev->scanType == SCAN_HCI || dev->scanType == SCAN_BLE) {
         wendigo_add_bt_device(dev, new_device);
     } else if (dev->scanType == SCAN_WIFI_AP) {
         new_device->radio.ap.channel = dev->radio.ap.channel;
         new_device->radio.ap.authmode = dev->radio.ap.authmode;
-        new_device->radio.ap.stations_count = dev->radio.ap.stations_count;
         if (dev->radio.ap.stations_count > 0 && dev->radio.ap.stations != NULL) {
-            /* Copy stations[] */
-            new_device->radio.ap.stations = malloc(sizeof(uint8_t *) * dev->radio.ap.stations_count);
-            if (new_device->radio.ap.stations == NULL) {
-                new_device->radio.ap.stations_count = 0;
-            } else {
+            /* Copy stations[] - The MACs are packed into a single arena allocation
+               and stations[] points into it */
+            uint8_t *macs = wendigo_arena_alloc(MAC_BYTES * dev->radio.ap.stations_count);
+            new_device->radio.ap.stations = wendigo_arena_alloc(sizeof(uint8_t *) *
+                dev->radio.ap.stations_count);
+            if (macs != NULL && new_device->radio.ap.stations != NULL) {
+                /* Stations that couldn't be parsed are NULL - Skip them */
+                uint8_t stationIdx = 0;
                 for (uint8_t i = 0; i < dev->radio.ap.stations_count; ++i) {
-                    new_device->radio.ap.stations[i] = malloc(MAC_BYTES);
-                    if (new_device->radio.ap.stations[i] != NULL) {
-                        memcpy(new_device->radio.ap.stations[i], dev->radio.ap.stations[i], MAC_BYTES);
+                    if (dev->radio.ap.stations[i] != NULL) {
+                        new_device->radio.ap.stations[stationIdx] = macs + (MAC_BYTES * stationIdx);
+                        memcpy(new_device->radio.ap.stations[stationIdx++], dev->radio.ap.stations[i], MAC_BYTES);
                     }
                 }
+                new_device->radio.ap.stations_count = stationIdx;
+            } else {
+                /* Release in the reverse of the order they were allocated */
+                wendigo_arena_release(new_device->radio.ap.stations,
+                    sizeof(uint8_t *) * dev->radio.ap.stations_count);
+                wendigo_arena_release(macs, MAC_BYTES * dev->radio.ap.stations_count);
+                new_device->radio.ap.stations = NULL;
             }
-        } else {
-            new_device->radio.ap.stations = NULL;
         }
         memcpy(new_device->radio.ap.ssid, dev->radio.ap.ssid, MAX_SSID_LEN);
         new_device->radio.ap.ssid[MAX_SSID_LEN] = '\0';
@@ -481,7 +701,7 @@ bool wendigo_add_device(WendigoApp *app, wendigo_device *dev) {
         if (dev->radio.sta.saved_networks_count > 0 &&
                 dev->radio.sta.saved_networks != NULL) {
             new_device->radio.sta.saved_networks_count = dev->radio.sta.saved_networks_count;
-            new_device->radio.sta.saved_networks = malloc(sizeof(char *) *
+            new_device->radio.sta.saved_networks = wendigo_arena_alloc(sizeof(char *) *
                 dev->radio.sta.saved_networks_count);
             if (new_device->radio.sta.saved_networks == NULL) {
                 new_device->radio.sta.saved_networks_count = 0;
@@ -492,19 +712,17 @@ bool wendigo_add_device(WendigoApp *app, wendigo_device *dev) {
                         new_device->radio.sta.saved_networks[i] = NULL;
                     } else {
                         this_ssid_len = strlen(dev->radio.sta.saved_networks[i]);
-                        new_device->radio.sta.saved_networks[i] = malloc(this_ssid_len + 1);
+                        new_device->radio.sta.saved_networks[i] = wendigo_arena_strndup(
+                            dev->radio.sta.saved_networks[i], this_ssid_len);
+                        /* Keep the PNL data model up to date - It references the
+                         * cached device, not `dev`, which the caller will free.
+                         * Only SSIDs the device holds are registered, otherwise
+                         * pnl_remove_device() couldn't find them again. */
                         if (new_device->radio.sta.saved_networks[i] != NULL) {
-                            strncpy(new_device->radio.sta.saved_networks[i],
-                                dev->radio.sta.saved_networks[i], this_ssid_len);
-                            new_device->radio.sta.saved_networks[i][this_ssid_len] = '\0';
-                        }
-                        if (networks_count > 0 && networks != NULL) {
-                            /* PNL data model has been initialised - ensure the
-                             * current SSID and device are in it. */
                             PNL_Result res = pnl_find_or_create_device(app,
-                                dev->radio.sta.saved_networks[i], dev);
+                                dev->radio.sta.saved_networks[i], new_device);
                             pnl_log_result("wendigo_add_device()", res,
-                                dev->radio.sta.saved_networks[i], dev);
+                                dev->radio.sta.saved_networks[i], new_device);
                         }
                     }
                 }
@@ -515,14 +733,89 @@ bool wendigo_add_device(WendigoApp *app, wendigo_device *dev) {
         }
     }
 
-    /* If the device list scene is currently displayed, add the device to the UI */
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_cache_device()");
+    return new_device;
+}
+
+static bool wendigo_update_device_once(WendigoApp *app, wendigo_device *dev);
+
+/** As wendigo_add_device(), without retrying if memory runs out */
+static bool wendigo_add_device_once(WendigoApp *app, wendigo_device *dev) {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_add_device_once()");
+    furi_mutex_acquire(app->devicesMutex, FuriWaitForever);
+    bool cached = device_index(dev) < devices_count;
+    furi_mutex_release(app->devicesMutex);
+    if (cached) {
+        /* A device with the provided BDA already exists - Update that instead */
+        return wendigo_update_device_once(app, dev);
+    }
+    /* A device we've moved to the SD card has come back - Restore it so it
+       keeps its history, then update it */
+    if (wendigo_spill_restore(app, dev->mac)) {
+        return wendigo_update_device_once(app, dev);
+    }
+    /* Make room for the new device if memory is running low, and move devices
+       we haven't seen for a while to the SD card. These only do any work
+       occasionally, so they're cheap to call for every device */
+    wendigo_prune_check(app, false);
+    wendigo_spill_check(app);
+
+    furi_mutex_acquire(app->devicesMutex, FuriWaitForever);
+    if (device_index(dev) < devices_count) {
+        /* The GUI thread restored it from the SD card in the meantime */
+        furi_mutex_release(app->devicesMutex);
+        return wendigo_update_device_once(app, dev);
+    }
+    wendigo_device *new_device = wendigo_cache_device(app, dev, false);
+    if (new_device == NULL) {
+        furi_mutex_release(app->devicesMutex);
+        FURI_LOG_T(WENDIGO_TAG, "End wendigo_add_device_once() - Out of memory");
+        return false;
+    }
+    /* If the device list scene is currently displayed, queue the device to be
+       added to the UI next time the device list refreshes */
     if (app->current_view == WendigoAppViewDeviceList) {
-        wendigo_scene_device_list_update(app, new_device);
+        wendigo_mark_device_dirty_locked(app, devices_count - 1);
     }
-    FURI_LOG_T(WENDIGO_TAG, "End wendigo_add_device()");
+    furi_mutex_release(app->devicesMutex);
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_add_device_once()");
     return true;
 }
 
+/** Call `store` to add or update `dev` in the device cache. If any allocation
+ * failed along the way - whether that's the device record or one of its
+ * attributes - devices are pruned from the cache (compacting the arena as
+ * they are) and `dev` is stored again. Storing a device is idempotent, so the
+ * second attempt fills in whatever the first one dropped.
+ */
+static bool wendigo_store_device(WendigoApp *app, wendigo_device *dev,
+        bool (*store)(WendigoApp *app, wendigo_device *dev)) {
+    WendigoPoolStats stats;
+    wendigo_pool_get_stats(&stats);
+    uint32_t failures = stats.alloc_failures;
+    bool result = store(app, dev);
+    wendigo_pool_get_stats(&stats);
+    if (stats.alloc_failures != failures && wendigo_prune_check(app, true)) {
+        result = store(app, dev);
+    }
+    return result;
+}
+
+/** Add the specified device to devices[], extending the length of devices[] if
+ * necessary. If the specified device has a MAC/BDA which is already present in
+ * devices[] a new entry will not be made, instead the element with the same
+ * MAC/BDA will be updated based on the specified device. If the device was
+ * spilled to the SD card it is restored and then updated. Returns true if the
+ * device was successfully added to (or updated in) devices[]. NOTE: The calling
+ * function may free the specified wendigo_device or any of its attributes when
+ * this function returns. To minimise the likelihood of memory leaks this
+ * function will allocate its own memory to hold the specified device and its
+ * attributes.
+ */
+bool wendigo_add_device(WendigoApp *app, wendigo_device *dev) {
+    return wendigo_store_device(app, dev, wendigo_add_device_once);
+}
+
 /** Locate the device in devices[] with the same MAC/BDA as `dev` and update the
  * object based on the contents of `dev`. If a device with the specified MAC/BDA
  * does not exist a new device will be added to devices[]. Returns true if the
@@ -534,11 +827,21 @@ bool wendigo_add_device(WendigoApp *app, wendigo_device *dev) {
  * service descriptors.
  */
 bool wendigo_update_device(WendigoApp *app, wendigo_device *dev) {
-    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_update_device()");
+    return wendigo_store_device(app, dev, wendigo_update_device_once);
+}
+
+/** As wendigo_update_device(), without retrying if memory runs out.
+ * app->devicesMutex is held from finding the device until it's been updated,
+ * so it can't be pruned or moved in devices[] in the meantime.
+ */
+static bool wendigo_update_device_once(WendigoApp *app, wendigo_device *dev) {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_update_device_once()");
+    furi_mutex_acquire(app->devicesMutex, FuriWaitForever);
     uint16_t idx = device_index(dev);
     if (idx == devices_count) {
         /* Device doesn't exist in bt_devices[] - Add it instead */
-        return wendigo_add_device(app, dev);
+        furi_mutex_release(app->devicesMutex);
+        return wendigo_add_device_once(app, dev);
     }
     wendigo_device *target = devices[idx];
     /* Copy common attributes */
@@ -560,38 +863,49 @@ bool wendigo_update_device(WendigoApp *app, wendigo_device *dev) {
             memcpy(target->radio.ap.ssid, dev->radio.ap.ssid, ssid_len + 1);
             target->radio.ap.ssid[ssid_len] = '\0';
         }
-        /* Merge dev->radio.ap.stations with target->radio.ap.stations */
+        /* ESP32-Wendigo sends every station currently associated with the AP -
+           and no longer sends those that have moved to another AP - so replace
+           target's stations rather than merging them, leaving no stale entries */
         uint8_t new_stations = 0;
-        if (target->radio.ap.stations_count == 0) {
-            new_stations = dev->radio.ap.stations_count;
-        } else {
-            /* Loop through dev->radio.ap.stations and count the MACs not present in target->radio.ap.stations */
+        for (uint8_t i = 0; i < dev->radio.ap.stations_count; ++i) {
+            if (dev->radio.ap.stations[i] != NULL) {
+                ++new_stations;
+            }
+        }
+        if (new_stations <= target->radio.ap.stations_count) {
+            /* Overwrite target's stations in place. Any space left over is
+               reclaimed when the arena is compacted */
+            uint8_t stationIdx = 0;
             for (uint8_t i = 0; i < dev->radio.ap.stations_count; ++i) {
-                if (wendigo_index_of(dev->radio.ap.stations[i], target->radio.ap.stations,
-                        target->radio.ap.stations_count) == target->radio.ap.stations_count) {
-                    ++new_stations;
+                if (dev->radio.ap.stations[i] != NULL) {
+                    memcpy(target->radio.ap.stations[stationIdx++], dev->radio.ap.stations[i], MAC_BYTES);
                 }
             }
-        }
-        if (new_stations > 0) {
-            /* Append new_stations elements to target->radio.ap.stations */
-            uint8_t **updated_stations = realloc(target->radio.ap.stations,
-                sizeof(uint8_t *) * (target->radio.ap.stations_count + new_stations));
-            if (updated_stations != NULL) {
-                uint8_t stationIdx = target->radio.ap.stations_count;
+            target->radio.ap.stations_count = new_stations;
+        } else {
+            /* Pack the new stations into a single allocation, as wendigo_cache_device() does */
+            uint8_t *macs = wendigo_arena_alloc(MAC_BYTES * new_stations);
+            uint8_t **updated_stations = wendigo_arena_alloc(sizeof(uint8_t *) * new_stations);
+            if (macs != NULL && updated_stations != NULL) {
+                uint8_t stationIdx = 0;
                 for (uint8_t i = 0; i < dev->radio.ap.stations_count; ++i) {
-                    if (wendigo_index_of(dev->radio.ap.stations[i], updated_stations,
-                            target->radio.ap.stations_count) == target->radio.ap.stations_count) {
-                        /* Add dev->radio.ap.stations[i] */
-                        updated_stations[stationIdx] = malloc(MAC_BYTES);
-                        if (updated_stations[stationIdx] != NULL) {
-                            memcpy(updated_stations[stationIdx], dev->radio.ap.stations[i], MAC_BYTES);
-                        }
-                        ++stationIdx;
+                    if (dev->radio.ap.stations[i] != NULL) {
+                        updated_stations[stationIdx] = macs + (MAC_BYTES * stationIdx);
+                        memcpy(updated_stations[stationIdx++], dev->radio.ap.stations[i], MAC_BYTES);
                     }
                 }
+                if (target->radio.ap.stations != NULL) {
+                    /* Released memory is reused, so read stations[0] before releasing stations[] */
+                    uint8_t *old_macs = target->radio.ap.stations[0];
+                    wendigo_arena_release(target->radio.ap.stations, sizeof(uint8_t *) * target->radio.ap.stations_count);
+                    wendigo_arena_release(old_macs, MAC_BYTES * target->radio.ap.stations_count);
+                }
                 target->radio.ap.stations = updated_stations;
-                target->radio.ap.stations_count += new_stations;
+                target->radio.ap.stations_count = new_stations;
+            } else {
+                /* Keep target's stations - Release in the reverse of the order they were allocated */
+                wendigo_arena_release(updated_stations, sizeof(uint8_t *) * new_stations);
+                wendigo_arena_release(macs, MAC_BYTES * new_stations);
             }
         }
     } else if (dev->scanType == SCAN_WIFI_STA) {
@@ -622,7 +936,8 @@ bool wendigo_update_device(WendigoApp *app, wendigo_device *dev) {
             if (new_pnl_count > 0) {
                 /* There are new SSIDs to add - realloc target */
                 new_pnl_count += target->radio.sta.saved_networks_count;
-                char **new_pnl = realloc(target->radio.sta.saved_networks,
+                char **new_pnl = wendigo_arena_realloc(target->radio.sta.saved_networks,
+                    sizeof(char *) * target->radio.sta.saved_networks_count,
                     sizeof(char *) * new_pnl_count);
                 if (new_pnl != NULL) {
                     /* Copy across new elements */
@@ -636,20 +951,15 @@ bool wendigo_update_device(WendigoApp *app, wendigo_device *dev) {
                                 dev->radio.sta.saved_networks[i] != NULL) {
                             /* Copy dev[i] to target[pnl_idx] */
                             pnl_len = strlen(dev->radio.sta.saved_networks[i]);
-                            new_pnl[pnl_idx] = malloc(pnl_len + 1);
+                            new_pnl[pnl_idx] = wendigo_arena_strndup(
+                                dev->radio.sta.saved_networks[i], pnl_len);
                             if (new_pnl[pnl_idx] != NULL) {
-                                strncpy(new_pnl[pnl_idx],
-                                    dev->radio.sta.saved_networks[i], pnl_len);
-                                new_pnl[pnl_idx][pnl_len] = '\0';
                                 ++pnl_idx;
-                            }
-                            if (networks_count > 0 && networks != NULL) {
-                                /* PNL data model has been initialised - ensure
-                                 * the current device and SSID are in it. */
+                                /* Keep the PNL data model up to date */
                                 PNL_Result res = pnl_find_or_create_device(app,
-                                    dev->radio.sta.saved_networks[i], dev);
+                                    dev->radio.sta.saved_networks[i], target);
                                 pnl_log_result("wendigo_update_device()", res,
-                                    dev->radio.sta.saved_networks[i], dev);
+                                    dev->radio.sta.saved_networks[i], target);
                             }
                         }
                     }
@@ -661,25 +971,29 @@ bool wendigo_update_device(WendigoApp *app, wendigo_device *dev) {
             }
         }
     }
-    /* Update the device list if it's currently displayed */
+    /* Rows are formatted when drawn so new values will be displayed at the
+       next refresh, but the device may need to move if the list is sorted */
     if (app->current_view == WendigoAppViewDeviceList) {
-        wendigo_scene_device_list_update(app, target);
+        wendigo_mark_device_dirty_locked(app, idx);
     } else if (app->current_view == WendigoAppViewDeviceDetail) { // && selectedDevice == bt_devices[idx]
         // TODO: Update existing view
     }
-    FURI_LOG_T(WENDIGO_TAG, "End wendigo_update_device()");
+    furi_mutex_release(app->devicesMutex);
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_update_device_once()");
     return true;
 }
 
 /** Free all memory allocated to the specified device.
  * After free'ing its members this function will also free `dev` itself.
- * dev->view will not be touched by this function - It is allocated and freed in
- * wendigo_scene_device_list.c. NOTE: I've gone back and forth between setting
- * attributes to NULL and 0 after freeing and not (because the attributes aren't
- * accessible after freeing `dev`), but have finally made a decision: Attributes
- * representing allocated memory ARE set to NULL (for pointers) and 0 (for
- * counts) to reduce the likelihood that any orphan pointers will attempt to use
- * deallocated memory.
+ * This function is only for devices allocated with malloc() - i.e. the
+ * temporary devices created by parseBuffer*(). Devices in devices[] are
+ * allocated from the device pool and released by wendigo_free_devices().
+ * NOTE: I've gone back and forth between setting attributes to NULL and 0
+ * after freeing and not (because the attributes aren't accessible after
+ * freeing `dev`), but have finally made a decision: Attributes representing
+ * allocated memory ARE set to NULL (for pointers) and 0 (for counts) to reduce
+ * the likelihood that any orphan pointers will attempt to use deallocated
+ * memory.
  */
 void wendigo_free_device(wendigo_device *dev) {
     FURI_LOG_T(WENDIGO_TAG, "Start wendigo_free_device()");
@@ -687,10 +1001,6 @@ void wendigo_free_device(wendigo_device *dev) {
         return;
     }
     if (dev->scanType == SCAN_HCI || dev->scanType == SCAN_BLE) {
-        if (dev->radio.bluetooth.cod_str != NULL) {
-            free(dev->radio.bluetooth.cod_str);
-            dev->radio.bluetooth.cod_str = NULL;
-        }
         if (dev->radio.bluetooth.bdname != NULL) {
             free(dev->radio.bluetooth.bdname);
             dev->radio.bluetooth.bdname = NULL;
@@ -739,23 +1049,173 @@ void wendigo_free_device(wendigo_device *dev) {
     } else {
         /* Nothing to do */
     }
-    dev->view = NULL;
     free(dev);
     FURI_LOG_T(WENDIGO_TAG, "End wendigo_free_device()");
 }
 
+/** Return the arena allocations belonging to `dev` to the arena. Most of
+ * them won't be the arena's most recent allocation, so this mostly serves to
+ * count them as waste for wendigo_compact_devices().
+ */
+static void wendigo_release_device_attributes(wendigo_device *dev) {
+    if (dev->scanType == SCAN_HCI || dev->scanType == SCAN_BLE) {
+        /* Release in the reverse of the order they were allocated in, so the
+           last one can actually be reclaimed */
+        wendigo_arena_release(dev->radio.bluetooth.bt_services.known_services,
+            sizeof(bt_uuid *) * dev->radio.bluetooth.bt_services.known_services_len);
+        wendigo_arena_release(dev->radio.bluetooth.bt_services.service_uuids,
+            sizeof(esp_bt_uuid_t) * dev->radio.bluetooth.bt_services.num_services);
+        wendigo_arena_release(dev->radio.bluetooth.eir, dev->radio.bluetooth.eir_len);
+        if (dev->radio.bluetooth.bdname != NULL) {
+            wendigo_arena_release(dev->radio.bluetooth.bdname, dev->radio.bluetooth.bdname_len + 1);
+        }
+    } else if (dev->scanType == SCAN_WIFI_AP && dev->radio.ap.stations != NULL) {
+        /* Station MACs may be spread over several allocations if stations
+           were added over time - This is close enough. Released memory is
+           reused, so read stations[0] before releasing stations[] */
+        uint8_t *macs = dev->radio.ap.stations[0];
+        wendigo_arena_release(dev->radio.ap.stations, sizeof(uint8_t *) * dev->radio.ap.stations_count);
+        wendigo_arena_release(macs, MAC_BYTES * dev->radio.ap.stations_count);
+    } else if (dev->scanType == SCAN_WIFI_STA && dev->radio.sta.saved_networks != NULL) {
+        for (uint8_t i = dev->radio.sta.saved_networks_count; i > 0; --i) {
+            if (dev->radio.sta.saved_networks[i - 1] != NULL) {
+                wendigo_arena_release(dev->radio.sta.saved_networks[i - 1],
+                    strlen(dev->radio.sta.saved_networks[i - 1]) + 1);
+            }
+        }
+        wendigo_arena_release(dev->radio.sta.saved_networks,
+            sizeof(char *) * dev->radio.sta.saved_networks_count);
+    }
+}
+
+/** Remove bit `idx` from dirty_devices[], moving the bits above it down to
+ * match devices[] after devices[idx] is removed.
+ */
+static void wendigo_dirty_devices_remove(uint16_t idx) {
+    if (dirty_devices == NULL || idx >= dirty_devices_capacity) {
+        return;
+    }
+    uint16_t words = dirty_devices_capacity / DIRTY_BITS_PER_WORD;
+    uint16_t w = idx / DIRTY_BITS_PER_WORD;
+    uint32_t below = (1UL << (idx % DIRTY_BITS_PER_WORD)) - 1;
+    dirty_devices[w] = (dirty_devices[w] & below) | ((dirty_devices[w] >> 1) & ~below);
+    for (; w + 1 < words; ++w) {
+        dirty_devices[w] |= (dirty_devices[w + 1] & 1UL) << (DIRTY_BITS_PER_WORD - 1);
+        dirty_devices[w + 1] >>= 1;
+    }
+}
+
+/** Remove devices[idx] from the device cache, the device list and the PNL,
+ * and return it to the device pool. Used by wendigo_prune.c.
+ * The caller must hold app->devicesMutex and call this between
+ * wendigo_scene_device_list_begin_removal() and
+ * wendigo_scene_device_list_end_removal().
+ */
+void wendigo_remove_device(WendigoApp *app, uint16_t idx) {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_remove_device()");
+    if (idx >= devices_count) {
+        FURI_LOG_T(WENDIGO_TAG, "End wendigo_remove_device() - Invalid index");
+        return;
+    }
+    wendigo_device *dev = devices[idx];
+    wendigo_scene_device_list_remove_device(dev);
+    pnl_remove_device(app, dev);
+    mac_index_remove(idx);
+    memmove(&(devices[idx]), &(devices[idx + 1]), sizeof(wendigo_device *) * (devices_count - idx - 1));
+    devices[--devices_count] = NULL;
+    wendigo_dirty_devices_remove(idx);
+    wendigo_release_device_attributes(dev);
+    wendigo_pool_release_device(dev);
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_remove_device()");
+}
+
+/** Copy `*ptr`, of `len` bytes, into the arena that's being built by
+ * wendigo_arena_compact(). Returns false if memory could not be allocated.
+ */
+static bool wendigo_relocate(void **ptr, uint16_t len) {
+    if (*ptr == NULL || len == 0) {
+        return true;
+    }
+    void *result = wendigo_arena_alloc(len);
+    if (result == NULL) {
+        return false;
+    }
+    memcpy(result, *ptr, len);
+    *ptr = result;
+    return true;
+}
+
+/** Relocation callback for wendigo_arena_compact() - Copies every arena
+ * allocation referenced by devices[] into the new arena.
+ */
+static bool wendigo_relocate_devices(void *context) {
+    UNUSED(context);
+    for (uint16_t i = 0; i < devices_count; ++i) {
+        wendigo_device *dev = devices[i];
+        if (dev->scanType == SCAN_HCI || dev->scanType == SCAN_BLE) {
+            wendigo_bt_device *bt = &(dev->radio.bluetooth);
+            if ((bt->bdname != NULL &&
+                    !wendigo_relocate((void **)&(bt->bdname), bt->bdname_len + 1)) ||
+                !wendigo_relocate((void **)&(bt->eir), bt->eir_len) ||
+                !wendigo_relocate((void **)&(bt->bt_services.service_uuids),
+                    sizeof(esp_bt_uuid_t) * bt->bt_services.num_services) ||
+                !wendigo_relocate((void **)&(bt->bt_services.known_services),
+                    sizeof(bt_uuid *) * bt->bt_services.known_services_len)) {
+                return false;
+            }
+        } else if (dev->scanType == SCAN_WIFI_AP && dev->radio.ap.stations != NULL &&
+                dev->radio.ap.stations_count > 0) {
+            /* Pack the station MACs into a single allocation again */
+            uint8_t *macs = wendigo_arena_alloc(MAC_BYTES * dev->radio.ap.stations_count);
+            if (macs == NULL ||
+                    !wendigo_relocate((void **)&(dev->radio.ap.stations),
+                        sizeof(uint8_t *) * dev->radio.ap.stations_count)) {
+                return false;
+            }
+            for (uint8_t s = 0; s < dev->radio.ap.stations_count; ++s) {
+                memcpy(macs + (MAC_BYTES * s), dev->radio.ap.stations[s], MAC_BYTES);
+                dev->radio.ap.stations[s] = macs + (MAC_BYTES * s);
+            }
+        } else if (dev->scanType == SCAN_WIFI_STA && dev->radio.sta.saved_networks != NULL) {
+            if (!wendigo_relocate((void **)&(dev->radio.sta.saved_networks),
+                    sizeof(char *) * dev->radio.sta.saved_networks_count)) {
+                return false;
+            }
+            for (uint8_t s = 0; s < dev->radio.sta.saved_networks_count; ++s) {
+                if (dev->radio.sta.saved_networks[s] != NULL &&
+                        !wendigo_relocate((void **)&(dev->radio.sta.saved_networks[s]),
+                            strlen(dev->radio.sta.saved_networks[s]) + 1)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/** Reclaim arena memory wasted by devices that have been removed or whose
+ * attributes have changed, by copying every cached device's attributes into a
+ * new arena. The caller must hold app->devicesMutex and ensure nothing else
+ * is holding pointers to device attributes.
+ * Returns the number of bytes returned to the heap.
+ */
+uint32_t wendigo_compact_devices() {
+    FURI_LOG_T(WENDIGO_TAG, "Start+End wendigo_compact_devices()");
+    return wendigo_arena_compact(wendigo_relocate_devices, NULL);
+}
+
 /** Deallocates all memory allocated to the device cache.
  * This function deallocates all elements of the device cache, devices[].
  * These arrays are left in a coherent state, with the arrays set to
  * NULL and their count & capacity variables set to zero.
+ * Cached devices and their attributes are allocated from the device pool and
+ * arena (wendigo_pool.c), so they are released together rather than passing
+ * each device to wendigo_free_device().
  */
 void wendigo_free_devices() {
     FURI_LOG_T(WENDIGO_TAG, "Start wendigo_free_devices()");
-    /* For devices[] we also want to free device attributes and the devices
-     * themselves */
     if (devices_capacity > 0 && devices != NULL) {
         for (uint16_t i = 0; i < devices_count; ++i) {
-            wendigo_free_device(devices[i]);
             devices[i] = NULL;
         }
         free(devices);
@@ -763,6 +1223,22 @@ void wendigo_free_devices() {
         devices_count = 0;
         devices_capacity = 0;
     }
+    if (dirty_devices != NULL) {
+        free(dirty_devices);
+        dirty_devices = NULL;
+        dirty_devices_capacity = 0;
+    }
+    if (mac_index != NULL) {
+        free(mac_index);
+        mac_index = NULL;
+        mac_index_capacity = 0;
+    }
+    mac_index_retry_at = 0;
+    /* networks[] references cached devices - Discard it along with them */
+    pnl_free_networks();
+    /* As are the devices that were moved to the SD card */
+    wendigo_spill_free();
+    wendigo_pool_free_all();
     FURI_LOG_T(WENDIGO_TAG, "End wendigo_free_devices()");
 }
 
@@ -802,6 +1278,21 @@ void process_and_display_status_attribute(WendigoApp *app, char *attribute_name,
     FURI_LOG_T(WENDIGO_TAG, "End process_and_display_status_attribute()");
 }
 
+/** Log a packet that the generated decoder rejected as malformed.
+ *  `minLen` is the shortest packet of this type, for context.
+ */
+static void log_malformed_packet(const char *type, uint16_t minLen, uint8_t *packet, uint16_t packetLen) {
+    char *msg = malloc(80);
+    if (msg == NULL) {
+        wendigo_log_with_packet(MSG_ERROR, "Malformed packet, skipping.", packet, packetLen);
+    } else {
+        snprintf(msg, 80, "%s packet is malformed (minimum %d bytes, actual %d). Skipping.",
+            type, minLen, packetLen);
+        wendigo_log_with_packet(MSG_ERROR, msg, packet, packetLen);
+        free(msg);
+    }
+}
+
 /** Parse a Wendigo packet representing a Bluetooth device.
  *  This function, and packet type, caters for both BT Classic
  *  and BT Low Energy devices. Creates a new wendigo_device and
@@ -809,15 +1300,11 @@ void process_and_display_status_attribute(WendigoApp *app, char *attribute_name,
  */
 uint16_t parseBufferBluetooth(WendigoApp *app, uint8_t *packet, uint16_t packetLen) {
     FURI_LOG_T(WENDIGO_TAG, "Start parseBufferBluetooth");
-    /* Sanity check - we should have at least WENDIGO_OFFSET_BT_COD_LEN + PREAMBLE_LEN bytes */
-    if (packetLen < (WENDIGO_OFFSET_BT_COD_LEN + PREAMBLE_LEN)) {
-        char *msg = malloc(98);
-        if (msg != NULL) {
-            snprintf(msg, 98, "Bluetooth packet too short even before considering BDName, EIR and CoD. Expected %d, actual %d.",
-                                        (WENDIGO_OFFSET_BT_COD_LEN + PREAMBLE_LEN), packetLen);
-            wendigo_log_with_packet(MSG_WARN, msg, packet, packetLen);
-            free(msg);
-        }
+    /* Validate the packet - lengths, bounds and terminator */
+    wendigo_pkt_bt pkt;
+    if (wendigo_pkt_bt_decode(&pkt, packet, packetLen) == 0) {
+        log_malformed_packet("Bluetooth", WENDIGO_PKT_BT_MIN_LEN, packet, packetLen);
+        FURI_LOG_T(WENDIGO_TAG, "End parseBufferBluetooth() - Malformed packet");
         return packetLen;
     }
     wendigo_device *dev = malloc(sizeof(wendigo_device));
@@ -831,84 +1318,42 @@ uint16_t parseBufferBluetooth(WendigoApp *app, uint8_t *packet, uint16_t packetL
     dev->radio.bluetooth.eir = NULL;
     dev->radio.bluetooth.bt_services.known_services = NULL;
     dev->radio.bluetooth.bt_services.service_uuids = NULL;
-    dev->radio.bluetooth.cod_str = NULL;
-    dev->view = NULL;
-    /* Temporary variables for attributes that require transformation */
-    uint8_t tagged;
-    /* Copy fixed-byte members */
-    memcpy(&(dev->radio.bluetooth.bdname_len),
-        packet + WENDIGO_OFFSET_BT_BDNAME_LEN, sizeof(uint8_t));
-    memcpy(&(dev->radio.bluetooth.eir_len), packet + WENDIGO_OFFSET_BT_EIR_LEN,
-        sizeof(uint8_t));
-    memcpy(&(dev->rssi), packet + WENDIGO_OFFSET_BT_RSSI, sizeof(int16_t));
-    memcpy(&(dev->radio.bluetooth.cod), packet + WENDIGO_OFFSET_BT_COD,
-        sizeof(uint32_t));
-    memcpy(dev->mac, packet + WENDIGO_OFFSET_BT_BDA, MAC_BYTES);
-    memcpy(&(dev->scanType), packet + WENDIGO_OFFSET_BT_SCANTYPE, sizeof(uint8_t));
-    memcpy(&tagged, packet + WENDIGO_OFFSET_BT_TAGGED, sizeof(uint8_t));
-    dev->tagged = (tagged == 1);
-    /* Ignore lastSeen */
-    // memcpy(&(dev->lastSeen.tv_sec), buffer + WENDIGO_OFFSET_BT_LASTSEEN,
-    // sizeof(int64_t));
-    memcpy(&(dev->radio.bluetooth.bt_services.num_services),
-        packet + WENDIGO_OFFSET_BT_NUM_SERVICES, sizeof(uint8_t));
-    memcpy(&(dev->radio.bluetooth.bt_services.known_services_len),
-        packet + WENDIGO_OFFSET_BT_KNOWN_SERVICES_LEN, sizeof(uint8_t));
-    uint8_t cod_len;
-    memcpy(&cod_len, packet + WENDIGO_OFFSET_BT_COD_LEN, sizeof(uint8_t));
+    dev->view_option = 0;
+    /* Copy fixed-byte members - lastSeen isn't sent */
+    dev->radio.bluetooth.bdname_len = pkt.bdname_len;
+    dev->radio.bluetooth.eir_len = pkt.eir_len;
+    dev->rssi = pkt.rssi;
+    /* Decode the device class once - It's described when it's displayed */
+    dev->radio.bluetooth.cod = pkt.cod;
+    dev->radio.bluetooth.cod_major = wendigo_cod_major(pkt.cod);
+    dev->radio.bluetooth.cod_minor = wendigo_cod_minor(pkt.cod);
+    memcpy(dev->mac, pkt.bda, MAC_BYTES);
+    dev->scanType = pkt.scantype;
+    dev->tagged = (pkt.tagged == 1);
+    dev->radio.bluetooth.bt_services.num_services = pkt.num_services;
+    dev->radio.bluetooth.bt_services.known_services_len = pkt.known_services_len;
     /* Do we have a bdname? */
-    uint16_t index = WENDIGO_OFFSET_BT_BDNAME;
-    /* Rudimentary buffer capacity check - Is the buffer large enough to hold the
-     * specified bdname and packet terminator? */
-    if (dev->radio.bluetooth.bdname_len > 0 &&
-            packetLen >= (WENDIGO_OFFSET_BT_BDNAME + dev->radio.bluetooth.bdname_len + PREAMBLE_LEN - 1)) {
-        dev->radio.bluetooth.bdname = malloc(dev->radio.bluetooth.bdname_len + 1);
+    if (pkt.bdname_len > 0) {
+        dev->radio.bluetooth.bdname = malloc(pkt.bdname_len + 1);
         if (dev->radio.bluetooth.bdname == NULL) {
             /* Can't store bdname so set bdname_len to 0 */
             dev->radio.bluetooth.bdname_len = 0;
         } else {
-            memcpy(dev->radio.bluetooth.bdname, packet + WENDIGO_OFFSET_BT_BDNAME,
-                dev->radio.bluetooth.bdname_len);
-            dev->radio.bluetooth.bdname[dev->radio.bluetooth.bdname_len] = '\0';
+            memcpy(dev->radio.bluetooth.bdname, pkt.bdname, pkt.bdname_len);
+            dev->radio.bluetooth.bdname[pkt.bdname_len] = '\0';
         }
-        /* Move index past bdname */
-        index += dev->radio.bluetooth.bdname_len;
     }
     /* EIR? */
-    if (dev->radio.bluetooth.eir_len > 0 &&
-            packetLen >= (index + dev->radio.bluetooth.eir_len + PREAMBLE_LEN - 1)) {
-        dev->radio.bluetooth.eir = malloc(dev->radio.bluetooth.eir_len);
+    if (pkt.eir_len > 0) {
+        dev->radio.bluetooth.eir = malloc(pkt.eir_len);
         if (dev->radio.bluetooth.eir == NULL) {
             dev->radio.bluetooth.eir_len = 0;
         } else {
-            memcpy(dev->radio.bluetooth.eir, packet + index, dev->radio.bluetooth.eir_len);
+            memcpy(dev->radio.bluetooth.eir, pkt.eir, pkt.eir_len);
         }
-        index += dev->radio.bluetooth.eir_len;
-    }
-    /* Class of Device? */
-    if (cod_len > 0 && packetLen >= (index + cod_len + PREAMBLE_LEN - 1)) {
-        dev->radio.bluetooth.cod_str = malloc(cod_len + 1);
-        if (dev->radio.bluetooth.cod_str != NULL) {
-            memcpy(dev->radio.bluetooth.cod_str, packet + index, cod_len);
-            dev->radio.bluetooth.cod_str[cod_len] = '\0';
-        }
-        index += cod_len; /* Cater for the trailing '\0' */
     }
     // TODO: Services to go here
 
-    /* Hopefully `index` now points to the packet terminator (unless scanning has
-       stopped, then all bets are off) */
-    if (app->is_scanning && memcmp(PACKET_TERM, packet + index, PREAMBLE_LEN)) {
-        char *msg = malloc(62);
-        if (msg != NULL) {
-            snprintf(msg, 62,
-                "Bluetooth packet terminator expected at index %d, not found.",
-                index);
-            wendigo_log_with_packet(MSG_WARN, msg, packet, packetLen);
-            free(msg);
-        }
-    }
-
     /* Add or update the device in devices[] - No longer need to check
         whether we're adding or updating, the add/update functions will call
         each other if required. */
@@ -916,7 +1361,85 @@ uint16_t parseBufferBluetooth(WendigoApp *app, uint8_t *packet, uint16_t packetL
     /* Clean up memory */
     wendigo_free_device(dev);
     FURI_LOG_T(WENDIGO_TAG, "End parseBufferBluetooth()");
-    return index + PREAMBLE_LEN;
+    return packetLen;
+}
+
+/** Parse a Wendigo packet containing the GATT services ESP32-Wendigo
+ *  discovered on a BLE device, replacing the service UUIDs held for the
+ *  device. Services named by the UUID dictionary are described on ESP32-Wendigo
+ *  only, so known_services is left as it is. Packets for devices we don't
+ *  know about, or that we know as a WiFi device, are ignored.
+ */
+uint16_t parseBufferBluetoothServices(WendigoApp *app, uint8_t *packet, uint16_t packetLen) {
+    FURI_LOG_T(WENDIGO_TAG, "Start parseBufferBluetoothServices()");
+    wendigo_pkt_bt_services pkt;
+    if (wendigo_pkt_bt_services_decode(&pkt, packet, packetLen) == 0) {
+        log_malformed_packet("BT services", WENDIGO_PKT_BT_SERVICES_MIN_LEN, packet, packetLen);
+        FURI_LOG_T(WENDIGO_TAG, "End parseBufferBluetoothServices() - Malformed packet");
+        return packetLen;
+    }
+    FURI_LOG_I(WENDIGO_TAG, "GATT discovery %s, %d services", wendigo_gatt_result_str(pkt.result),
+        pkt.svc_count);
+    if (pkt.result != WENDIGO_GATT_COMPLETE || pkt.svc_count == 0) {
+        FURI_LOG_T(WENDIGO_TAG, "End parseBufferBluetoothServices() - No services");
+        return packetLen;
+    }
+    esp_bt_uuid_t *uuids = malloc(sizeof(esp_bt_uuid_t) * pkt.svc_count);
+    if (uuids == NULL) {
+        wendigo_log_with_packet(MSG_ERROR,
+            "parseBufferBluetoothServices(): Unable to allocate memory for services, skipping packet.",
+            packet, packetLen);
+        return packetLen;
+    }
+    uint8_t svc_count = wendigo_svc_uuids_unpack(pkt.uuids, pkt.uuids_len, uuids, pkt.svc_count);
+    uint8_t bda[MAC_BYTES];
+    memcpy(bda, pkt.bda, MAC_BYTES);
+
+    /* Bring the device back from the SD card first if it's there - This
+       doesn't hold devicesMutex while the SD card is read */
+    wendigo_spill_restore(app, bda);
+    furi_mutex_acquire(app->devicesMutex, FuriWaitForever);
+    uint16_t idx = device_index_from_mac(bda);
+    if (idx < devices_count && devices[idx]->scanType != SCAN_HCI &&
+            devices[idx]->scanType != SCAN_BLE) {
+        /* radio holds an AP or station - There's no bt_services to replace */
+        wendigo_log_with_packet(MSG_WARN,
+            "parseBufferBluetoothServices(): Device isn't a Bluetooth device, skipping packet.",
+            packet, packetLen);
+    } else if (idx < devices_count && svc_count > 0) {
+        wendigo_bt_svc *svc = &(devices[idx]->radio.bluetooth.bt_services);
+        if (wendigo_arena_copy_bytes((void **)&(svc->service_uuids),
+                sizeof(esp_bt_uuid_t) * svc->num_services, uuids, sizeof(esp_bt_uuid_t) * svc_count)) {
+            svc->num_services = svc_count;
+        }
+        if (app->current_view == WendigoAppViewDeviceList) {
+            wendigo_mark_device_dirty_locked(app, idx);
+        }
+    }
+    furi_mutex_release(app->devicesMutex);
+    free(uuids);
+    FURI_LOG_T(WENDIGO_TAG, "End parseBufferBluetoothServices()");
+    return packetLen;
+}
+
+/** Parse a Focus Mode RSSI packet and pass it to the Locate scene. These
+ *  arrive several times a second for each tagged device, so they are kept
+ *  away from the device cache - they don't take devicesMutex or mark
+ *  anything dirty - and are dropped unless the Locate scene is displayed.
+ */
+uint16_t parseBufferRssi(WendigoApp *app, uint8_t *packet, uint16_t packetLen) {
+    FURI_LOG_T(WENDIGO_TAG, "Start parseBufferRssi()");
+    wendigo_pkt_rssi pkt;
+    if (wendigo_pkt_rssi_decode(&pkt, packet, packetLen) == 0) {
+        log_malformed_packet("RSSI", WENDIGO_PKT_RSSI_MIN_LEN, packet, packetLen);
+        FURI_LOG_T(WENDIGO_TAG, "End parseBufferRssi() - Malformed packet");
+        return packetLen;
+    }
+    if (app->current_view == WendigoAppViewLocate) {
+        wendigo_scene_locate_update(app, &pkt);
+    }
+    FURI_LOG_T(WENDIGO_TAG, "End parseBufferRssi()");
+    return packetLen;
 }
 
 /** Parse a Wendigo packet representing an Access Point.
@@ -926,45 +1449,13 @@ uint16_t parseBufferBluetooth(WendigoApp *app, uint8_t *packet, uint16_t packetL
  */
 uint16_t parseBufferWifiAp(WendigoApp *app, uint8_t *packet, uint16_t packetLen) {
     FURI_LOG_T(WENDIGO_TAG, "Start parseBufferWifiAp()");
-    /* Check the packet is a reasonable size */
-    uint16_t expectedLen = WENDIGO_OFFSET_AP_SSID + PREAMBLE_LEN;
-    if (packetLen < expectedLen) {
-        char *shortMsg = malloc(56);
-        if (shortMsg != NULL) {
-            snprintf(shortMsg, 56,
-                "AP packet too short, expected %d actual %d. Skipping.",
-                expectedLen, packetLen);
-            // Popup disabled while debugging device list wendigo_display_popup(app,
-            // "AP too short", shortMsg);
-            wendigo_log_with_packet(MSG_ERROR, shortMsg, packet, packetLen);
-            free(shortMsg);
-        }
-        FURI_LOG_T(WENDIGO_TAG, "End parseBufferWifiAp() - Packet too short");
-        return packetLen;
-    }
-    /* Retrieve stations_count and ssid_len from the packet for further validation */
-    uint8_t sta_count;
-    uint8_t ssid_len;
-    memcpy(&ssid_len, packet + WENDIGO_OFFSET_AP_SSID_LEN, sizeof(uint8_t));
-    memcpy(&sta_count, packet + WENDIGO_OFFSET_AP_STA_COUNT, sizeof(uint8_t));
-    /* Now we have stations_count and ssid_len we know exactly how big the packet should be */
-    expectedLen = WENDIGO_OFFSET_AP_SSID + ssid_len + (MAC_BYTES * sta_count) + PREAMBLE_LEN;
-    if (packetLen < expectedLen) {
-        /* Packet is too short - Likely reflects a corrupted packet with the wrong
-            byte in stations_count. Log and display the error.
-        */
-        char *shortMsg = malloc(77);
-        if (shortMsg != NULL) {
-            snprintf(shortMsg, 77,
-                "Packet's stations_count requires packet of size %d, actual %d. "
-                "Skipping.",
-                expectedLen, packetLen);
-            wendigo_log_with_packet(MSG_ERROR, shortMsg, packet, packetLen);
-            // Popup disabled while debugging device list wendigo_display_popup(app, "AP
-            // too short for STAtions", shortMsg);
-            free(shortMsg);
-        }
-        FURI_LOG_T(WENDIGO_TAG, "End parseBufferWifiAp() - Packet too short for stations");
+    /* Validate the packet - A corrupted sta_count or ssid_len is caught here */
+    wendigo_pkt_wifi_ap pkt;
+    if (wendigo_pkt_wifi_ap_decode(&pkt, packet, packetLen) == 0 || pkt.ssid_len > MAX_SSID_LEN) {
+        // Popup disabled while debugging device list wendigo_display_popup(app,
+        // "AP Packet Error", ...);
+        log_malformed_packet("AP", WENDIGO_PKT_WIFI_AP_MIN_LEN, packet, packetLen);
+        FURI_LOG_T(WENDIGO_TAG, "End parseBufferWifiAp() - Malformed packet");
         return packetLen;
     }
     wendigo_device *dev = malloc(sizeof(wendigo_device));
@@ -972,78 +1463,39 @@ uint16_t parseBufferWifiAp(WendigoApp *app, uint8_t *packet, uint16_t packetLen)
         return packetLen;
     }
     /* Initialise pointers */
-    dev->view = NULL;
+    dev->view_option = 0;
     dev->radio.ap.stations = NULL;
     bzero(dev->radio.ap.ssid, MAX_SSID_LEN + 1);
-    /* Temporary variables for elements that need to be transformed */
-    uint8_t tagged;
-    /* Copy fixed-length attributes from the packet */
-    memcpy(&(dev->scanType), packet + WENDIGO_OFFSET_WIFI_SCANTYPE,
-        sizeof(uint8_t));
-    memcpy(dev->mac, packet + WENDIGO_OFFSET_WIFI_MAC, MAC_BYTES);
-    memcpy(&(dev->radio.ap.channel), packet + WENDIGO_OFFSET_WIFI_CHANNEL, sizeof(uint8_t));
-    memcpy(&(dev->rssi), packet + WENDIGO_OFFSET_WIFI_RSSI, sizeof(int16_t));
-    memcpy(&(dev->radio.ap.authmode), packet + WENDIGO_OFFSET_AP_AUTH_MODE, sizeof(uint8_t));
-    /* Ignore lastSeen */
-    // memcpy(&(dev->lastSeen.tv_sec), buffer + WENDIGO_OFFSET_WIFI_LASTSEEN, sizeof(int64_t));
-    memcpy(&tagged, packet + WENDIGO_OFFSET_WIFI_TAGGED, sizeof(uint8_t));
-    dev->tagged = (tagged == 1);
-    dev->radio.ap.stations_count = sta_count;
-    memcpy(dev->radio.ap.ssid, packet + WENDIGO_OFFSET_AP_SSID, ssid_len);
+    /* Copy fixed-length attributes from the packet - lastSeen isn't sent */
+    dev->scanType = pkt.scantype;
+    memcpy(dev->mac, pkt.mac, MAC_BYTES);
+    dev->radio.ap.channel = pkt.channel;
+    dev->rssi = pkt.rssi;
+    dev->radio.ap.authmode = pkt.auth_mode;
+    dev->tagged = (pkt.tagged == 1);
+    dev->radio.ap.stations_count = pkt.sta_count;
+    if (pkt.ssid_len > 0) {
+        memcpy(dev->radio.ap.ssid, pkt.ssid, pkt.ssid_len);
+    }
 
     /* Retrieve stations_count MAC addresses */
-    uint8_t buffIndex = WENDIGO_OFFSET_AP_SSID + ssid_len;
-    uint8_t **stations = NULL;
-    if (dev->radio.ap.stations_count > 0) {
-        stations = malloc(sizeof(uint8_t *) * dev->radio.ap.stations_count);
-        if (stations == NULL) {
+    if (pkt.sta_count > 0) {
+        dev->radio.ap.stations = malloc(sizeof(uint8_t *) * pkt.sta_count);
+        if (dev->radio.ap.stations == NULL) {
             free(dev);
             FURI_LOG_T(WENDIGO_TAG, "End parseBufferWifiAp() - Unable to malloc() stations[]");
             return packetLen;
         }
-        for (uint8_t staIdx = 0; staIdx < dev->radio.ap.stations_count; ++staIdx) {
-            stations[staIdx] = malloc(MAC_BYTES);
-            if (stations[staIdx] == NULL) {
-                buffIndex += MAC_BYTES;
-                continue; /* Progress to the next station... Who knows, maybe it'll work */
-            }
-            memcpy(stations[staIdx], packet + buffIndex, MAC_BYTES);
-            buffIndex += MAC_BYTES;
-        }
-    }
-    /* buffIndex should now point to the packet terminator */
-    if (memcmp(packet + buffIndex, PACKET_TERM, PREAMBLE_LEN)) {
-        char *bytesFound = malloc(3 * PREAMBLE_LEN);
-        char *popupMsg = malloc((3 * PREAMBLE_LEN) + 30);
-        if (bytesFound != NULL && popupMsg != NULL) {
-            bytes_to_string(packet + buffIndex, PREAMBLE_LEN, bytesFound);
-            snprintf(popupMsg, (3 * PREAMBLE_LEN) + 30,
-                "Expected end of packet, found %s", bytesFound);
-            popupMsg[3 * PREAMBLE_LEN + 29] = '\0';
-            // Popup disabled while debugging device list wendigo_display_popup(app, "AP
-            // Packet Error", popupMsg);
-            wendigo_log_with_packet(MSG_ERROR, popupMsg, packet, packetLen);
-        };
-        if (bytesFound != NULL) {
-            free(bytesFound);
-        }
-        if (popupMsg != NULL) {
-            free(popupMsg);
-        }
-        if (stations != NULL) {
-            for (uint8_t i = 0; i < dev->radio.ap.stations_count; ++i) {
-                if (stations[i] != NULL) {
-                    free(stations[i]);
-                }
+        for (uint8_t staIdx = 0; staIdx < pkt.sta_count; ++staIdx) {
+            dev->radio.ap.stations[staIdx] = malloc(MAC_BYTES);
+            if (dev->radio.ap.stations[staIdx] != NULL) {
+                /* Progress to the next station if this fails... Who knows, maybe it'll work */
+                memcpy(dev->radio.ap.stations[staIdx],
+                    WENDIGO_PKT_MAC_AT(pkt.stations_raw, staIdx), MAC_BYTES);
             }
-            free(stations);
-        }
-    } else {
-        if (dev->radio.ap.stations_count > 0) {
-            dev->radio.ap.stations = stations;
         }
-        wendigo_add_device(app, dev);
     }
+    wendigo_add_device(app, dev);
     wendigo_free_device(dev);
     FURI_LOG_T(WENDIGO_TAG, "End parseBufferWifiAp()");
     return packetLen;
@@ -1051,47 +1503,13 @@ uint16_t parseBufferWifiAp(WendigoApp *app, uint8_t *packet, uint16_t packetLen)
 
 uint16_t parseBufferWifiSta(WendigoApp *app, uint8_t *packet, uint16_t packetLen) {
     FURI_LOG_T(WENDIGO_TAG, "Start parseBufferWifiSta()");
-    /* This flag allows us to skip validation that the packet is the correct
-     * length. Used when the Preferred Network List can't be malloc()d, to
-     * allow the rest of the packet to be used. */
-    bool skip_validation = false;
-    uint8_t expectedLen = WENDIGO_OFFSET_STA_AP_SSID + PREAMBLE_LEN;
-    if (packetLen < expectedLen) {
-        /* Packet is too short - Log the issue along with the current packet */
-        char *shortMsg = malloc(60);
-        if (shortMsg != NULL) {
-            snprintf(shortMsg, 60,
-                "STA packet too short: Expected %d, actual %d. Skipping...",
-                expectedLen, packetLen);
-            wendigo_log_with_packet(MSG_ERROR, shortMsg, packet, packetLen);
-            /* Also display a popup */
-            // Popup disabled while debugging device list wendigo_display_popup(app,
-            // "STA packet too short", shortMsg);
-            free(shortMsg);
-        }
-        FURI_LOG_T(WENDIGO_TAG, "End parseBufferWifiSta() - Short packet");
-        return packetLen;
-    }
-    /* Get ap_ssid_len and pnl_count to validate the full packet size */
-    uint8_t ap_ssid_len;
-    uint8_t pnl_count;
-    memcpy(&ap_ssid_len, packet + WENDIGO_OFFSET_STA_AP_SSID_LEN, sizeof(uint8_t));
-    expectedLen += ap_ssid_len;
-    memcpy(&pnl_count, packet + WENDIGO_OFFSET_STA_PNL_COUNT, sizeof(uint8_t));
-    /* This still won't be the full packet length because each PNL has a 1-byte
-        length and a length-byte SSID */
-    expectedLen += pnl_count;
-    if (packetLen < expectedLen) {
-        /* Packet too short - Log and return */
-        char *shortMsg = malloc(57);
-        if (shortMsg != NULL) {
-            snprintf(shortMsg, 57,
-                "STA packet too short for SSID: Expected %d, actual %d.",
-                expectedLen, packetLen);
-            wendigo_log_with_packet(MSG_ERROR, shortMsg, packet, packetLen);
-            free(shortMsg);
-        }
-        FURI_LOG_T(WENDIGO_TAG, "End parseBufferWifiSta() - Packet too short for SSID");
+    /* Validate the packet, including every PNL length */
+    wendigo_pkt_wifi_sta pkt;
+    if (wendigo_pkt_wifi_sta_decode(&pkt, packet, packetLen) == 0) {
+        // Popup disabled while debugging device list wendigo_display_popup(app,
+        // "STA packet too short", shortMsg);
+        log_malformed_packet("STA", WENDIGO_PKT_WIFI_STA_MIN_LEN, packet, packetLen);
+        FURI_LOG_T(WENDIGO_TAG, "End parseBufferWifiSta() - Malformed packet");
         return packetLen;
     }
     wendigo_device *dev = malloc(sizeof(wendigo_device));
@@ -1099,121 +1517,54 @@ uint16_t parseBufferWifiSta(WendigoApp *app, uint8_t *packet, uint16_t packetLen
         return packetLen;
     }
     /* Initialise all pointers */
-    dev->view = NULL;
+    dev->view_option = 0;
     dev->radio.sta.saved_networks = NULL;
-    memcpy(dev->radio.sta.apMac, nullMac, MAC_BYTES);
-    /* Temp variables for attributes that need to be transformed */
-    uint8_t tagged;
-    /* Copy fixed-length attributes */
-    memcpy(&(dev->scanType), packet + WENDIGO_OFFSET_WIFI_SCANTYPE, sizeof(uint8_t));
-    memcpy(dev->mac, packet + WENDIGO_OFFSET_WIFI_MAC, MAC_BYTES);
-    memcpy(&(dev->radio.sta.channel), packet + WENDIGO_OFFSET_WIFI_CHANNEL, sizeof(uint8_t));
-    memcpy(&(dev->rssi), packet + WENDIGO_OFFSET_WIFI_RSSI, sizeof(int16_t));
-    /* Ignore lastSeen */
-    // memcpy(&(dev->lastSeen.tv_sec), buffer + WENDIGO_OFFSET_WIFI_LASTSEEN,
-    // sizeof(int64_t));
-    memcpy(&tagged, packet + WENDIGO_OFFSET_WIFI_TAGGED, sizeof(uint8_t));
-    dev->tagged = (tagged == 1);
-    dev->radio.sta.saved_networks_count = pnl_count;
-    memcpy(dev->radio.sta.apMac, packet + WENDIGO_OFFSET_STA_AP_MAC, MAC_BYTES);
-    char ap_ssid[MAX_SSID_LEN + 1];
-    bzero(ap_ssid, MAX_SSID_LEN + 1);
-    memcpy(ap_ssid, packet + WENDIGO_OFFSET_STA_AP_SSID, ap_ssid_len);
-    ap_ssid[ap_ssid_len] = '\0';
+    /* Copy fixed-length attributes - lastSeen isn't sent */
+    dev->scanType = pkt.scantype;
+    memcpy(dev->mac, pkt.mac, MAC_BYTES);
+    dev->radio.sta.channel = pkt.channel;
+    dev->rssi = pkt.rssi;
+    dev->tagged = (pkt.tagged == 1);
+    dev->radio.sta.saved_networks_count = pkt.pnl_count;
+    memcpy(dev->radio.sta.apMac, pkt.ap_mac, MAC_BYTES);
     /* Do I want to do anything with ap_ssid? Not right now... */
-    FURI_LOG_D("parseBufferWifiSta()", "STA %02x:%02x:%02x:%02x:%02x:%02x has a PNL of %d", dev->mac[0], dev->mac[1], dev->mac[2], dev->mac[3], dev->mac[4], dev->mac[5], pnl_count);
-    if (pnl_count > 0) {
+    FURI_LOG_D("parseBufferWifiSta()", "STA %02x:%02x:%02x:%02x:%02x:%02x has a PNL of %d", dev->mac[0], dev->mac[1], dev->mac[2], dev->mac[3], dev->mac[4], dev->mac[5], pkt.pnl_count);
+    if (pkt.pnl_count > 0) {
         /* Retrieve pnl_count saved networks */
-        dev->radio.sta.saved_networks = malloc(sizeof(char *) * pnl_count);
+        dev->radio.sta.saved_networks = malloc(sizeof(char *) * pkt.pnl_count);
         if (dev->radio.sta.saved_networks == NULL) {
             /* Alert insufficient memory - But allow the device to be added
              * anyway, just without its Preferred Network List. */
             dev->radio.sta.saved_networks_count = 0;
-            skip_validation = true;
             char *errMsg = malloc(39);
             if (errMsg == NULL) {
                 wendigo_log_with_packet(MSG_ERROR, "Can't allocate PNL.",
                     packet, packetLen);
             } else {
                 snprintf(errMsg, 39, "Failed to allocate %d bytes for PNL.",
-                    sizeof(char *) * pnl_count);
+                    sizeof(char *) * pkt.pnl_count);
                 wendigo_log_with_packet(MSG_WARN, errMsg, packet, packetLen);
                 free(errMsg);
             }
         }
     }
-    uint16_t packet_idx = WENDIGO_OFFSET_STA_AP_SSID + ap_ssid_len;
-    uint8_t pnl_idx = 0;
-    uint8_t this_pnl_len;
-    bool short_pkt = false;
-    while (pnl_idx < dev->radio.sta.saved_networks_count && !short_pkt) {
-        /* Ensure the packet is big enough */
-        if (packetLen >= (packet_idx + PREAMBLE_LEN)) {
-            /* Get current SSID length */
-            memcpy(&this_pnl_len, packet + packet_idx, sizeof(uint8_t));
-            ++packet_idx;
-            /* Make sure the packet is big enough to contain the SSID */
-            if (packetLen >= (packet_idx + this_pnl_len + PREAMBLE_LEN)) {
-                if (this_pnl_len == 0) {
-                    dev->radio.sta.saved_networks[pnl_idx] = NULL;
-                } else {
-                    dev->radio.sta.saved_networks[pnl_idx] = malloc(this_pnl_len + 1);
-                    if (dev->radio.sta.saved_networks[pnl_idx] != NULL) {
-                        memcpy(dev->radio.sta.saved_networks[pnl_idx],
-                            packet + packet_idx, this_pnl_len);
-                        FURI_LOG_D("parseBufferWifiSta()", "Retrieved STA %02x:%02x:%02x:%02x:%02x:%02x PNL %d: %s", dev->mac[0], dev->mac[1], dev->mac[2], dev->mac[3], dev->mac[4], dev->mac[5], pnl_idx, dev->radio.sta.saved_networks[pnl_idx]);
-                    }
-                    packet_idx += this_pnl_len;
-                }
-                ++pnl_idx;
-            } else { // packetLen < (packet_idx + this_pnl_len + PREAMBLE_LEN)
-                char *shortMsg = malloc(103);
-                if (shortMsg == NULL) {
-                    wendigo_log_with_packet(MSG_DEBUG, "Packet too short for specified PNL length.", packet, packetLen);
-                } else {
-                    snprintf(shortMsg, 103, "Packet too short: packetLen (%d) <= (packet_idx (%d) + this_pnl_len (%d) + PREAMBLE_LEN (%d)).", packetLen, packet_idx, this_pnl_len, PREAMBLE_LEN);
-                    wendigo_log_with_packet(MSG_DEBUG, shortMsg, packet, packetLen);
-                    free(shortMsg);
-                }
-                short_pkt = true;
-            }
-        } else { // packetLen < (packet_idx + PREAMBLE_LEN)
-            char *shortMsg = malloc(73);
-            if (shortMsg == NULL) {
-                wendigo_log_with_packet(MSG_DEBUG, "Packet too short to search for a PNL.", packet, packetLen);
-            } else {
-                snprintf(shortMsg, 73, "Packet too short to contain another PNL. pnl_idx: %d packet_idx: %d.", pnl_idx, packet_idx);
-                wendigo_log_with_packet(MSG_DEBUG, shortMsg, packet, packetLen);
-                free(shortMsg);
-            }
-            short_pkt = true;
-        }
-    }
-    if (short_pkt) {
-        wendigo_log_with_packet(MSG_ERROR, "STA packet too short to extract PNL.", packet, packetLen);
-        if (pnl_idx > 0) {
-            for (uint8_t i = 0; i < pnl_idx; ++i) {
-                if (dev->radio.sta.saved_networks[i] != NULL) {
-                    free(dev->radio.sta.saved_networks[i]);
-                }
+    const uint8_t *cursor = pkt.pnl_raw;
+    const uint8_t *pnl;
+    uint8_t pnl_len;
+    for (uint8_t pnl_idx = 0; pnl_idx < dev->radio.sta.saved_networks_count &&
+            wendigo_pkt_next_string(&cursor, pkt.pnl_raw + pkt.pnl_raw_len, &pnl, &pnl_len); ++pnl_idx) {
+        if (pnl_len == 0) {
+            dev->radio.sta.saved_networks[pnl_idx] = NULL;
+        } else {
+            dev->radio.sta.saved_networks[pnl_idx] = malloc(pnl_len + 1);
+            if (dev->radio.sta.saved_networks[pnl_idx] != NULL) {
+                memcpy(dev->radio.sta.saved_networks[pnl_idx], pnl, pnl_len);
+                dev->radio.sta.saved_networks[pnl_idx][pnl_len] = '\0';
+                FURI_LOG_D("parseBufferWifiSta()", "Retrieved STA %02x:%02x:%02x:%02x:%02x:%02x PNL %d: %s", dev->mac[0], dev->mac[1], dev->mac[2], dev->mac[3], dev->mac[4], dev->mac[5], pnl_idx, dev->radio.sta.saved_networks[pnl_idx]);
             }
         }
-        if (dev->radio.sta.saved_networks != NULL) {
-            free(dev->radio.sta.saved_networks);
-        }
-        dev->radio.sta.saved_networks_count = 0;
-    /* Otherwise we should find the packet terminator at packet_idx */
-    } else if (!skip_validation && memcmp(PACKET_TERM, packet + packet_idx, PREAMBLE_LEN)) {
-        // Popup disabled while debugging device list        wendigo_display_popup(
-        //            app, "STA Packet", "STA Packet terminator not found where
-        //            expected.");
-        /* Log the packet so the cause can hopefully be found */
-        wendigo_log_with_packet(
-            MSG_ERROR, "STA packet terminator not found where expected, skipping.",
-            packet, packetLen);
-    } else {
-        wendigo_add_device(app, dev);
     }
+    wendigo_add_device(app, dev);
     wendigo_free_device(dev);
     FURI_LOG_T(WENDIGO_TAG, "End parseBufferWifiSta()");
     return packetLen;
@@ -1261,36 +1612,16 @@ uint16_t parseBufferVersion(WendigoApp *app, uint8_t *packet, uint16_t packetLen
  */
 uint16_t parseBufferMAC(WendigoApp *app, uint8_t *packet, uint16_t packetLen) {
     FURI_LOG_T(WENDIGO_TAG, "Start parseBufferMAC()");
-    if (packetLen < (2 * PREAMBLE_LEN)) {
-        wendigo_log_with_packet(MSG_ERROR, "MAC packet too short", packet, packetLen);
-        return packetLen;
-    }
-    uint8_t interface_count;
-    memcpy(&interface_count, packet + WENDIGO_OFFSET_MAC_IF_COUNT, sizeof(uint8_t));
-    uint8_t expected_len = (2 * PREAMBLE_LEN) + (interface_count * (MAC_BYTES + 1)) + 1;
-    if (packetLen != expected_len) {
-        char *msg = malloc(55);
-        if (msg == NULL) {
-            wendigo_log_with_packet(MSG_ERROR, "MAC packet length different from expected.", packet, packetLen);
-        } else {
-            snprintf(msg, 55, "MAC packet is wrong length. Expected %d actual %d.", expected_len, packetLen);
-            wendigo_log_with_packet(MSG_ERROR, msg, packet, packetLen);
-            free(msg);
-        }
+    wendigo_pkt_mac pkt;
+    if (wendigo_pkt_mac_decode(&pkt, packet, packetLen) != packetLen) {
+        log_malformed_packet("MAC", WENDIGO_PKT_MAC_MIN_LEN, packet, packetLen);
         return packetLen;
     }
-    /* The packet's the right length - Process its contents */
-    uint8_t thisMac[MAC_BYTES];
+    /* The packet's valid - Process its contents */
+    const uint8_t *thisMac;
     uint8_t thisIface;
-    uint16_t offset = WENDIGO_OFFSET_MAC_IF_COUNT + 1;
-    uint8_t interface = 0;
-    while (interface < interface_count && offset + MAC_BYTES + PREAMBLE_LEN < packetLen) {
-        /* Get the interface type */
-        memcpy(&thisIface, packet + offset, sizeof(uint8_t));
-        ++offset;
-        /* Get the MAC */
-        memcpy(thisMac, packet + offset, MAC_BYTES);
-        offset += MAC_BYTES;
+    for (uint8_t interface = 0; interface < pkt.if_count; ++interface) {
+        thisMac = wendigo_pkt_typed_mac_at(pkt.interfaces_raw, interface, &thisIface);
         if (thisIface == WENDIGO_MAC_WIFI) {
             memcpy(app->interfaces[IF_WIFI].mac_bytes, thisMac, MAC_BYTES);
             app->interfaces[IF_WIFI].initialised = true;
@@ -1309,11 +1640,6 @@ uint16_t parseBufferMAC(WendigoApp *app, uint8_t *packet, uint16_t packetLen) {
                 "MAC packet specifies unknown interface.",
                 packet, packetLen);
         }
-        ++interface;
-    }
-    /* Finally, confirm that offset now points to the packet terminator */
-    if (memcmp(packet + offset, PACKET_TERM, PREAMBLE_LEN)) {
-        wendigo_log_with_packet(MSG_ERROR, "MAC packet terminator not found where expected.", packet, packetLen);        
     }
     /* Invoke the 'MAC received' callback if there is one */
     wendigo_mac_rcvd_callback(app);
@@ -1324,23 +1650,15 @@ uint16_t parseBufferMAC(WendigoApp *app, uint8_t *packet, uint16_t packetLen) {
 uint16_t parseBufferChannels(WendigoApp *app, uint8_t *packet, uint16_t packetLen) {
     UNUSED(app);
     FURI_LOG_T(WENDIGO_TAG, "Start parseBufferChannels()");
-    uint8_t channels_count;
-    uint8_t *channels = NULL;
-    memcpy(&channels_count, packet + WENDIGO_OFFSET_CHANNEL_COUNT, sizeof(uint8_t));
-    if (channels_count > 0) {
-        channels = malloc(channels_count);
-        if (channels != NULL) {
-            memcpy(channels, packet + WENDIGO_OFFSET_CHANNELS, channels_count);
-        }
-    }
-    if (memcmp(PACKET_TERM, packet + WENDIGO_OFFSET_CHANNELS + channels_count, PREAMBLE_LEN)) {
+    wendigo_pkt_channels pkt;
+    if (wendigo_pkt_channels_decode(&pkt, packet, packetLen) == 0) {
         //        wendigo_display_popup(app, "Channel Packet", "Channel packet is
         //        unexpected length");
         wendigo_log_with_packet(MSG_ERROR, "Channels packet terminator not found where expected", packet, packetLen);
         FURI_LOG_T(WENDIGO_TAG, "End parseBufferChannels() - Terminator not found");
         return packetLen;
     }
-    // TODO: Do something with channels
+    // TODO: Do something with pkt.channels
     FURI_LOG_T(WENDIGO_TAG, "End parseBufferChannels()");
     return packetLen;
 }
@@ -1348,6 +1666,7 @@ uint16_t parseBufferChannels(WendigoApp *app, uint8_t *packet, uint16_t packetLe
 /** Parse a status packet and display in the status view.
  * This function requires that Wendigo_AppViewStatus be the
  * currently-displayed view (otherwise the packet is discarded).
+ * The packet is defined in protocol/wendigo_packets.schema.
  */
 uint16_t parseBufferStatus(WendigoApp *app, uint8_t *packet, uint16_t packetLen) {
     FURI_LOG_T(WENDIGO_TAG, "Start parseBufferStatus()");
@@ -1355,27 +1674,30 @@ uint16_t parseBufferStatus(WendigoApp *app, uint8_t *packet, uint16_t packetLen)
     if (app->current_view != WendigoAppViewStatus) {
         return packetLen;
     }
+    wendigo_pkt_status pkt;
+    uint16_t consumed = wendigo_pkt_status_decode(&pkt, packet, packetLen);
+    if (consumed == 0) {
+        log_malformed_packet("Status", WENDIGO_PKT_STATUS_MIN_LEN, packet, packetLen);
+        return packetLen;
+    }
     wendigo_scene_status_begin_layout(app);
-    // TODO: Document the packet somewhere. Less straightforward than the
-    // Bluetooth packet because it's a dynamic size, but it needs *something*
-    uint8_t attribute_count;
+    const uint8_t *cursor = pkt.attributes_raw;
+    const uint8_t *end = pkt.attributes_raw + pkt.attributes_raw_len;
+    const uint8_t *name;
+    const uint8_t *value;
     uint8_t attribute_name_len;
     uint8_t attribute_value_len;
     char *attribute_name = NULL;
     char *attribute_value = NULL;
-    uint16_t offset = PREAMBLE_LEN;
-    memcpy(&attribute_count, packet + offset, sizeof(uint8_t));
-    ++offset;
-    for (uint8_t i = 0; i < attribute_count; ++i) {
-        /* Parse attribute name length */
-        memcpy(&attribute_name_len, packet + offset, sizeof(uint8_t));
+    /* The decoder has checked there are attr_count name/value pairs */
+    while (wendigo_pkt_next_string(&cursor, end, &name, &attribute_name_len) &&
+            wendigo_pkt_next_string(&cursor, end, &value, &attribute_value_len)) {
         if (attribute_name_len == 0) {
             wendigo_log_with_packet(MSG_ERROR,
                 "Status packet contained an attribute of length 0, skipping.",
                 packet, packetLen);
             return packetLen;
         }
-        ++offset;
         /* Name */
         attribute_name = malloc(attribute_name_len + 1);
         if (attribute_name == NULL) {
@@ -1389,13 +1711,9 @@ uint16_t parseBufferStatus(WendigoApp *app, uint8_t *packet, uint16_t packetLen)
             }
             return packetLen;
         }
-        memcpy(attribute_name, packet + offset, attribute_name_len);
+        memcpy(attribute_name, name, attribute_name_len);
         attribute_name[attribute_name_len] = '\0';
-        offset += attribute_name_len;
-        /* Attribute value length */
-        memcpy(&attribute_value_len, packet + offset, sizeof(uint8_t));
-        ++offset;
-        /* It's valid for this to have a length of 0 - attribute_value will be "" */
+        /* It's valid for the value to have a length of 0 - attribute_value will be "" */
         attribute_value = malloc(attribute_value_len + 1);
         if (attribute_value == NULL) {
             char *msg = malloc(50);
@@ -1409,23 +1727,30 @@ uint16_t parseBufferStatus(WendigoApp *app, uint8_t *packet, uint16_t packetLen)
             free(attribute_name);
             return packetLen;
         }
-        memcpy(attribute_value, packet + offset, attribute_value_len);
+        memcpy(attribute_value, value, attribute_value_len);
         attribute_value[attribute_value_len] = '\0';
-        offset += attribute_value_len;
         /* Send the attribute off for validation and display */
         process_and_display_status_attribute(app, attribute_name, attribute_value);
         free(attribute_name);
         free(attribute_value);
     }
+    /* Append Flipper's memory cost per cached device - This includes devices[],
+       the device pool and the attribute arena */
+    char bytesPerDevice[11];
+    snprintf(bytesPerDevice, sizeof(bytesPerDevice), "%lu",
+        wendigo_pool_bytes_per_device(devices_count, devices_capacity));
+    wendigo_scene_status_add_attribute(app, "Bytes per Device:", bytesPerDevice);
+    /* And the number of devices dropped from the cache because memory was low */
+    char devicesPruned[6];
+    snprintf(devicesPruned, sizeof(devicesPruned), "%u", app->devices_pruned);
+    wendigo_scene_status_add_attribute(app, "Devices Pruned:", devicesPruned);
+    /* And the number of devices moved out of memory to the SD card */
+    char devicesSpilled[6];
+    snprintf(devicesSpilled, sizeof(devicesSpilled), "%u", wendigo_spill_count());
+    wendigo_scene_status_add_attribute(app, "Devices on SD:", devicesSpilled);
     wendigo_scene_status_finish_layout(app);
-
-    /* buffer + offset should now point to the end of packet sequence */
-    if (memcmp(PACKET_TERM, packet + offset, PREAMBLE_LEN)) {
-        wendigo_log_with_packet(MSG_WARN, "Status packet terminator not found where expected.", packet, packetLen);
-        return packetLen;
-    }
     FURI_LOG_T(WENDIGO_TAG, "End parseBufferStatus()");
-    return offset + PREAMBLE_LEN;
+    return consumed;
 }
 
 /** When the end of a packet is reached this function is called to parse the
@@ -1437,6 +1762,7 @@ void parsePacket(WendigoApp *app, uint8_t *packet, uint16_t packetLen) {
     FURI_LOG_T(WENDIGO_TAG, "Begin parsePacket(len: %d)", packetLen);
     /* Update buffer last received time */
     app->last_packet = furi_hal_rtc_get_timestamp();
+    ++app->packets_parsed;
 
     /* Development: Dump packet for inspection */
     //wendigo_log_with_packet(MSG_DEBUG, "parsePacket() received packet", packet, packetLen);
@@ -1461,6 +1787,10 @@ void parsePacket(WendigoApp *app, uint8_t *packet, uint16_t packetLen) {
         parseBufferChannels(app, packet, packetLen);
     } else if (!memcmp(PREAMBLE_MAC, packet, PREAMBLE_LEN)) {
         parseBufferMAC(app, packet, packetLen);
+    } else if (!memcmp(PREAMBLE_BT_SVC, packet, PREAMBLE_LEN)) {
+        parseBufferBluetoothServices(app, packet, packetLen);
+    } else if (!memcmp(PREAMBLE_RSSI, packet, PREAMBLE_LEN)) {
+        parseBufferRssi(app, packet, packetLen);
     } else {
         wendigo_log_with_packet(MSG_WARN, "Packet doesn't have a valid preamble", packet, packetLen);
     }
@@ -1567,22 +1897,40 @@ void wendigo_scan_handle_rx_data_cb(uint8_t *buf, size_t len, void *context) {
     memcpy(buffer + bufferLen, buf, len);
     bufferLen += len;
 
-    /* Parse any complete packets we have received */
+    /* Parse any complete packets we have received. `offset` is the number of
+       bytes at the start of buffer[] that have been dealt with */
     uint8_t *packet;
     uint16_t packetLen;
+    uint16_t offset = 0;
     uint16_t startIdx = start_of_packet(buffer, bufferLen);
     uint16_t endIdx = end_of_packet(buffer, bufferLen);
     uint8_t **packets = NULL;
     uint16_t *packetSize = NULL;
     uint8_t packetsCount = 0;
     bool interrupted = false;
-    while (startIdx < endIdx && endIdx < bufferLen && !interrupted) {
+    while (startIdx < bufferLen && endIdx < bufferLen && !interrupted) {
+        if (endIdx < startIdx) {
+            /* A terminator with no preamble before it - The remains of a packet
+               whose start was discarded. Skip it. */
+            offset = endIdx + 1;
+            startIdx = offset + start_of_packet(buffer + offset, bufferLen - offset);
+            endIdx = offset + end_of_packet(buffer + offset, bufferLen - offset);
+            continue;
+        }
         /* We have a complete packet - extract it for parsing */
         packetLen = endIdx - startIdx + 1;
         packet = buffer + startIdx;
-        /* Copy the packet into packets[] so we can deal with it later */
+        /* Copy the packet into packets[] so we can deal with it later. Keep
+           whichever of packets[] and packetSize[] grew even if the other
+           didn't - realloc() has already released the old one */
         uint8_t **new_packets = realloc(packets, sizeof(uint8_t *) * (packetsCount + 1));
+        if (new_packets != NULL) {
+            packets = new_packets;
+        }
         uint16_t *new_packetSize = realloc(packetSize, sizeof(uint16_t) * (packetsCount + 1));
+        if (new_packetSize != NULL) {
+            packetSize = new_packetSize;
+        }
         if (new_packets == NULL || new_packetSize == NULL) {
             wendigo_log_with_packet(MSG_ERROR,
                 "UART RX: Unable to allocate memory for packets cache.",
@@ -1591,9 +1939,9 @@ void wendigo_scan_handle_rx_data_cb(uint8_t *buf, size_t len, void *context) {
             interrupted = true;
             break;
         }
-        new_packetSize[packetsCount] = packetLen;
-        new_packets[packetsCount] = malloc(packetLen);
-        if (new_packets[packetsCount] == NULL) {
+        packetSize[packetsCount] = packetLen;
+        packets[packetsCount] = malloc(packetLen);
+        if (packets[packetsCount] == NULL) {
             /* Bugger, continue with what we've gotten so far */
             char *errorMsg = malloc(57);
             if (errorMsg == NULL) {
@@ -1607,49 +1955,36 @@ void wendigo_scan_handle_rx_data_cb(uint8_t *buf, size_t len, void *context) {
                 wendigo_log_with_packet(MSG_ERROR, errorMsg, packet, packetLen);
                 free(errorMsg);
             }
-            /* Since we can't allocate more memory exit the loop now */
+            /* Since we can't allocate more memory exit the loop now. packets[]
+               and packetSize[] have room for one more than packetsCount,
+               which is harmless */
             interrupted = true;
-            /* First shrink packets[] and packetSize[] back to their previous size */
-            uint8_t **new_packets2 = realloc(new_packets, sizeof(uint8_t *) * packetsCount);
-            uint16_t *new_packetSize2 = realloc(new_packetSize, sizeof(uint16_t) * packetsCount);
-            if (new_packets2 == NULL || new_packetSize2 == NULL) {
-                /* Because this is shrinking in place it's tempting to not even check for failure */
-                wendigo_log(MSG_ERROR, "UART RX: Unable to shrink packets[] and packetSize[] after a failed malloc().");
-            } else {
-                new_packets = new_packets2;
-                new_packetSize = new_packetSize2;
-            }
             break;
         }
-        memcpy(new_packets[packetsCount], packet, packetLen);
-        packets = new_packets;
-        packetSize = new_packetSize;
+        memcpy(packets[packetsCount], packet, packetLen);
         ++packetsCount;
 
-        /* Remove this packet, and any preceding junk, from the buffer */
-        memset(buffer, 0, packetLen + startIdx);
-        /* Get the next start and end indices, ready for the next iteration */
-        startIdx = start_of_packet(buffer, bufferLen);
-        endIdx = end_of_packet(buffer, bufferLen);
-    }
-    /* Have we been able to empty the buffer? */
-    if (!interrupted && startIdx == bufferLen && endIdx == bufferLen) {
-        /* Not having a start or end packet sequence is a start - Check for all NULL
-         * bytes in buffer */
-        // TODO: Improve on that by searching backwards through buffer to find something that can't be a preamble, and removing everything prior
-        //       Could also look for any "islands" of bytes that are too short to be a packet
-        bool bytesFound = false;
-        for (uint16_t i = 0; i < bufferLen && !bytesFound; ++i) {
-            if (buffer[i] != 0) {
-                bytesFound = true;
-            }
-        }
-        if (!bytesFound) {
-            // FURI_LOG_D("wendigo_scan_handle_rx_data_cb()",
-            //     "Buffer is empty, resetting bufferLen");
-            bufferLen = 0;
+        /* This packet, and any preceding junk, has been dealt with. Get the
+           next start and end indices, ready for the next iteration */
+        offset = endIdx + 1;
+        startIdx = offset + start_of_packet(buffer + offset, bufferLen - offset);
+        endIdx = offset + end_of_packet(buffer + offset, bufferLen - offset);
+    }
+    /* Anything before the next preamble is junk. If there isn't a preamble keep
+       the last few bytes, which could be the start of one */
+    if (!interrupted) {
+        if (startIdx < bufferLen) {
+            offset = startIdx;
+        } else if (bufferLen - offset >= PREAMBLE_LEN) {
+            offset = bufferLen - PREAMBLE_LEN + 1;
         }
     }
+    /* Remove what we've dealt with from the buffer, so that it only grows when
+       a packet is larger than the buffer */
+    if (offset > 0) {
+        memmove(buffer, buffer + offset, bufferLen - offset);
+        bufferLen -= offset;
+    }
     /* Release the mutex and parse the packets */
     // TODO: Replace with with a message queue.
     furi_mutex_release(app->bufferMutex);
@@ -1658,10 +1993,9 @@ void wendigo_scan_handle_rx_data_cb(uint8_t *buf, size_t len, void *context) {
         parsePacket(app, packets[i], packetSize[i]);
         free(packets[i]);
     }
-    if (packetsCount > 0) {
-        free(packets);
-        free(packetSize);
-    }
+    /* These may have been allocated even if no packets were stored */
+    free(packets);
+    free(packetSize);
     FURI_LOG_T(WENDIGO_TAG, "End wendigo_scan_handle_rx_data_cb()");
 }
 
@@ -1726,9 +2060,12 @@ void wendigo_log_with_packet(MsgType logType, char *message, uint8_t *packet,
             finalMessage[strlen(message)] = '\n';
         }
         bytes_to_string(packet, packet_size, finalMessage + commentLen);
+        /* Just in case my counting is out */
+        finalMessage[messageLen - 1] = '\0';
+        wendigo_log(logType, finalMessage);
+        free(finalMessage);
+    } else if (message != NULL) {
+        /* Log the message without the packet */
+        wendigo_log(logType, message);
     }
-    /* Just in case my counting is out */
-    finalMessage[messageLen - 1] = '\0';
-    wendigo_log(logType, finalMessage);
-    free(finalMessage);
 }
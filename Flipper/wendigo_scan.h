@@ -3,12 +3,18 @@
 #include "wendigo_app_i.h"
 
 /* Function imports from scenes */
+extern void wendigo_scene_device_list_begin_refresh(WendigoApp *app);
 extern void wendigo_scene_device_list_update(WendigoApp *app, wendigo_device *dev);
+extern void wendigo_scene_device_list_end_refresh(WendigoApp *app);
 extern void wendigo_scene_status_add_attribute(WendigoApp *app, char *name, char *value);
 extern void wendigo_scene_status_finish_layout(WendigoApp *app);
 extern void wendigo_scene_status_begin_layout(WendigoApp *app);
 extern uint16_t wendigo_scene_device_list_set_current_devices_mask(uint8_t deviceMask);
 extern void wendigo_scene_device_list_set_current_devices(DeviceListInstance *devices);
+extern void wendigo_scene_device_list_remove_device(wendigo_device *dev);
+extern void wendigo_scene_device_list_begin_removal(WendigoApp *app);
+extern void wendigo_scene_device_list_end_removal(WendigoApp *app);
+extern void wendigo_scene_locate_update(WendigoApp *app, wendigo_pkt_rssi *pkt);
 
 /* Device caches - Declared extern to get around header spaghetti */
 extern wendigo_device **devices;
@@ -18,13 +24,22 @@ extern uint16_t devices_capacity;
 void wendigo_set_scanning_interface(WendigoApp *app, InterfaceType interface, bool starting);
 void wendigo_set_scanning_active(WendigoApp *app, bool starting);
 void wendigo_scan_handle_rx_data_cb(uint8_t *buf, size_t len, void *context);
+void parsePacket(WendigoApp *app, uint8_t *packet, uint16_t packetLen);
 void wendigo_free_uart_buffer();
 void wendigo_version(WendigoApp *app);
 void wendigo_esp_status(WendigoApp *app);
+void wendigo_tag_device(WendigoApp *app, wendigo_device *dev);
+void wendigo_set_focus(WendigoApp *app, bool enable);
 void wendigo_free_devices();
+void wendigo_free_device(wendigo_device *dev);
 uint16_t custom_device_index(wendigo_device *dev, wendigo_device **array, uint16_t array_count);
 bool wendigo_update_device(WendigoApp *app, wendigo_device *dev);
 bool wendigo_add_device(WendigoApp *app, wendigo_device *dev);
+wendigo_device *wendigo_cache_device(WendigoApp *app, wendigo_device *dev, bool restoring);
+void wendigo_mark_device_dirty_locked(WendigoApp *app, uint16_t idx);
+uint16_t wendigo_flush_dirty_devices(WendigoApp *app);
+void wendigo_remove_device(WendigoApp *app, uint16_t idx);
+uint32_t wendigo_compact_devices();
 void wendigo_log(MsgType logType, char *message);
 void wendigo_log_with_packet(MsgType logType, char *message, uint8_t *packet, uint16_t packet_size);
 uint16_t device_index_from_mac(uint8_t mac[MAC_BYTES]);
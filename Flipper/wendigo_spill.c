@@ -0,0 +1,685 @@
+#include "wendigo_spill.h"
+#include "wendigo_scan.h"
+#include "wendigo_hash.h"
+#include "wendigo_prune.h"
+#include <storage/storage.h>
+
+/** Even with the device pool and pruning, Flipper can only hold a few thousand
+ * devices in RAM - not enough for a long session somewhere busy. Devices that
+ * haven't been seen for WENDIGO_SPILL_AGE seconds, and aren't tagged, are
+ * therefore written to an append-only file on the SD card and removed from
+ * RAM, leaving behind only a MAC -> file offset entry in spill_index[]. Devices
+ * removed by wendigo_prune.c are written there too.
+ * A spilled device is read back into the device cache when it's seen again,
+ * when it's needed to display an AP's stations or a station's AP, or when the
+ * user selects the "On SD card" row at the end of the device list, so the
+ * rest of the app never sees the difference (apart from the device list
+ * getting shorter).
+ * Each record in the file is a WendigoSpillHeader, a copy of the
+ * wendigo_device and then its variable-length attributes. Pointers in the
+ * copy are meaningless once read back, except for bt_uuid pointers in
+ * known_services[] which live for as long as the app does - as does the file.
+ * Records of restored devices are left in place; the file is only truncated
+ * when the app starts.
+ * spill_mutex serialises access to spill_index[] and the file. Reading a
+ * device back is slow, so it's done with only spill_mutex held - the device
+ * is only copied into the device cache, under app->devicesMutex, once it's
+ * been read. Where both are needed app->devicesMutex is acquired first.
+ */
+
+typedef struct WendigoSpillHeader {
+    uint8_t mac[MAC_BYTES];
+    uint16_t length;    /* Bytes of attributes following the device record */
+} WendigoSpillHeader;
+
+/* Offset marking an unused spill_index[] slot */
+#define SPILL_EMPTY        (UINT32_MAX)
+/* Minimum capacity of spill_index[] */
+#define SPILL_MIN_CAPACITY (64)
+
+typedef struct WendigoSpillEntry {
+    uint32_t offset;
+    uint8_t mac[MAC_BYTES];
+} WendigoSpillEntry;
+
+/* MAC -> file offset index (see wendigo_hash.h) */
+static WendigoSpillEntry *spill_index = NULL;
+static uint16_t spill_index_capacity = 0;
+static uint16_t spill_count = 0;
+/* After spill_index[] couldn't be grown, don't try again until spill_count
+   reaches this */
+static uint16_t spill_index_retry_at = 0;
+
+/* Allocated by the first call to wendigo_spill_device() or wendigo_spill_check(),
+   both of which are called with app->devicesMutex held. Nothing else uses it
+   until spill_count is non-zero */
+static FuriMutex *spill_mutex = NULL;
+
+static Storage *spill_storage = NULL;
+static File *spill_file = NULL;
+static uint32_t spill_end = 0;          /* Offset of the end of the file */
+static bool spill_disabled = false;     /* Set if the file can't be opened */
+static uint32_t spill_last_check = 0;   /* furi_get_tick() of the last wendigo_spill_check() */
+
+/* Devices most recently restored by wendigo_spill_browse(), which aren't
+   moved back to the SD card until WENDIGO_SPILL_AGE after they were restored */
+static uint8_t spill_browsed[WENDIGO_SPILL_BROWSE_BATCH][MAC_BYTES];
+static uint8_t spill_browsed_count = 0;
+static uint32_t spill_browse_time = 0;
+/* wendigo_spill_browse() works back through the file from the most recently
+   spilled device - The next batch is taken from records before this offset */
+static uint32_t spill_browse_before = SPILL_EMPTY;
+
+/* Writes are collected here and written when it fills or a record is complete */
+static uint8_t spill_buffer[WENDIGO_SPILL_BUFFER_SIZE];
+static uint16_t spill_buffer_len = 0;
+static bool spill_write_failed = false;
+
+/** Find the spill_index[] slot holding `mac`, or the empty slot where it
+ * would be inserted. spill_index[] must not be NULL.
+ */
+static uint16_t spill_slot(uint8_t mac[MAC_BYTES]) {
+    uint16_t mask = spill_index_capacity - 1;
+    uint16_t slot = wendigo_hash_mac(mac) & mask;
+    while (spill_index[slot].offset != SPILL_EMPTY &&
+            memcmp(spill_index[slot].mac, mac, MAC_BYTES)) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/** Replace spill_index[] with one of `capacity` slots and move its entries
+ * into it. Returns false, leaving spill_index[] as it was, if memory could
+ * not be allocated.
+ */
+static bool spill_index_grow(uint16_t capacity) {
+    WendigoSpillEntry *new_index = malloc(sizeof(WendigoSpillEntry) * capacity);
+    if (new_index == NULL) {
+        return false;
+    }
+    for (uint16_t i = 0; i < capacity; ++i) {
+        new_index[i].offset = SPILL_EMPTY;
+    }
+    WendigoSpillEntry *old_index = spill_index;
+    uint16_t old_capacity = spill_index_capacity;
+    spill_index = new_index;
+    spill_index_capacity = capacity;
+    for (uint16_t i = 0; i < old_capacity; ++i) {
+        if (old_index[i].offset != SPILL_EMPTY) {
+            memcpy(&(spill_index[spill_slot(old_index[i].mac)]), &(old_index[i]),
+                sizeof(WendigoSpillEntry));
+        }
+    }
+    if (old_index != NULL) {
+        free(old_index);
+    }
+    return true;
+}
+
+/** Make room in spill_index[] for `count` entries, growing it first if it
+ * needs to be. Returns false if it can't hold them - The device then stays
+ * in memory.
+ */
+static bool spill_index_reserve(uint16_t count) {
+    uint16_t new_capacity = wendigo_index_grow_capacity(count, spill_index_capacity,
+        SPILL_MIN_CAPACITY, spill_index_retry_at);
+    if (new_capacity != 0 && !spill_index_grow(new_capacity)) {
+        spill_index_retry_at = wendigo_index_retry_at(count);
+        wendigo_log(MSG_WARN, "Unable to grow SD card index, keeping devices in memory.");
+    }
+    /* A lookup needs an empty slot to stop at */
+    return count < spill_index_capacity;
+}
+
+/** Remove the entry in `slot` from spill_index[], moving later entries in
+ * the same probe sequence back so they can still be found.
+ */
+static void spill_index_remove(uint16_t slot) {
+    uint16_t mask = spill_index_capacity - 1;
+    uint16_t next = (slot + 1) & mask;
+    while (spill_index[next].offset != SPILL_EMPTY) {
+        uint16_t home = wendigo_hash_mac(spill_index[next].mac) & mask;
+        if (wendigo_index_can_fill(home, slot, next, mask)) {
+            memcpy(&(spill_index[slot]), &(spill_index[next]), sizeof(WendigoSpillEntry));
+            slot = next;
+        }
+        next = (next + 1) & mask;
+    }
+    spill_index[slot].offset = SPILL_EMPTY;
+    --spill_count;
+}
+
+/** Open (and truncate) the spill file if it isn't already open.
+ * Returns false if the SD card can't be used, in which case spilling is
+ * disabled until the device cache is next freed.
+ */
+static bool spill_open() {
+    if (spill_file != NULL) {
+        return true;
+    }
+    if (spill_disabled) {
+        return false;
+    }
+    spill_storage = furi_record_open(RECORD_STORAGE);
+    spill_file = storage_file_alloc(spill_storage);
+    if (!storage_file_open(spill_file, WENDIGO_SPILL_PATH, FSAM_READ_WRITE, FSOM_CREATE_ALWAYS)) {
+        char *msg = malloc(sizeof(char) * 94);
+        if (msg == NULL) {
+            wendigo_log(MSG_WARN, "Unable to open device cache on SD card.");
+        } else {
+            snprintf(msg, 94, "Unable to open device cache on SD card: %s",
+                storage_file_get_error_desc(spill_file));
+            wendigo_log(MSG_WARN, msg);
+            free(msg);
+        }
+        storage_file_free(spill_file);
+        spill_file = NULL;
+        furi_record_close(RECORD_STORAGE);
+        spill_storage = NULL;
+        spill_disabled = true;
+        return false;
+    }
+    spill_end = 0;
+    return true;
+}
+
+/** Write the contents of spill_buffer[] to the spill file */
+static void spill_flush() {
+    if (spill_buffer_len > 0 && !spill_write_failed &&
+            storage_file_write(spill_file, spill_buffer, spill_buffer_len) != spill_buffer_len) {
+        spill_write_failed = true;
+    }
+    spill_buffer_len = 0;
+}
+
+/** Append `len` bytes to the record being written */
+static void spill_write(const void *data, uint16_t len) {
+    const uint8_t *bytes = data;
+    while (len > 0) {
+        if (spill_buffer_len == WENDIGO_SPILL_BUFFER_SIZE) {
+            spill_flush();
+        }
+        uint16_t chunk = WENDIGO_SPILL_BUFFER_SIZE - spill_buffer_len;
+        if (chunk > len) {
+            chunk = len;
+        }
+        memcpy(spill_buffer + spill_buffer_len, bytes, chunk);
+        spill_buffer_len += chunk;
+        bytes += chunk;
+        len -= chunk;
+    }
+}
+
+/** Append a string to the record being written, preceded by its length */
+static void spill_write_str(const char *str) {
+    uint8_t len = (str == NULL) ? 0 : strnlen(str, UINT8_MAX);
+    spill_write(&len, sizeof(len));
+    spill_write(str, len);
+}
+
+/** Number of bytes spill_write_attributes() will write for `dev` */
+static uint16_t spill_attributes_length(wendigo_device *dev) {
+    uint16_t result = 0;
+    if (dev->scanType == SCAN_HCI || dev->scanType == SCAN_BLE) {
+        wendigo_bt_device *bt = &(dev->radio.bluetooth);
+        result += (bt->bdname == NULL) ? 0 : bt->bdname_len;
+        result += (bt->eir == NULL) ? 0 : bt->eir_len;
+        result += (bt->bt_services.service_uuids == NULL) ? 0 :
+            sizeof(esp_bt_uuid_t) * bt->bt_services.num_services;
+        result += (bt->bt_services.known_services == NULL) ? 0 :
+            sizeof(bt_uuid *) * bt->bt_services.known_services_len;
+    } else if (dev->scanType == SCAN_WIFI_AP && dev->radio.ap.stations != NULL) {
+        result += MAC_BYTES * dev->radio.ap.stations_count;
+    } else if (dev->scanType == SCAN_WIFI_STA && dev->radio.sta.saved_networks != NULL) {
+        for (uint8_t i = 0; i < dev->radio.sta.saved_networks_count; ++i) {
+            result += sizeof(uint8_t) + ((dev->radio.sta.saved_networks[i] == NULL) ? 0 :
+                strnlen(dev->radio.sta.saved_networks[i], UINT8_MAX));
+        }
+    }
+    return result;
+}
+
+/** Write the variable-length attributes of `dev`. Lengths are taken from the
+ * device record, which has been written with the lengths of missing
+ * attributes set to zero.
+ */
+static void spill_write_attributes(wendigo_device *dev) {
+    if (dev->scanType == SCAN_HCI || dev->scanType == SCAN_BLE) {
+        wendigo_bt_device *bt = &(dev->radio.bluetooth);
+        if (bt->bdname != NULL) {
+            spill_write(bt->bdname, bt->bdname_len);
+        }
+        if (bt->eir != NULL) {
+            spill_write(bt->eir, bt->eir_len);
+        }
+        if (bt->bt_services.service_uuids != NULL) {
+            spill_write(bt->bt_services.service_uuids, sizeof(esp_bt_uuid_t) * bt->bt_services.num_services);
+        }
+        if (bt->bt_services.known_services != NULL) {
+            spill_write(bt->bt_services.known_services,
+                sizeof(bt_uuid *) * bt->bt_services.known_services_len);
+        }
+    } else if (dev->scanType == SCAN_WIFI_AP && dev->radio.ap.stations != NULL) {
+        for (uint8_t i = 0; i < dev->radio.ap.stations_count; ++i) {
+            spill_write(dev->radio.ap.stations[i], MAC_BYTES);
+        }
+    } else if (dev->scanType == SCAN_WIFI_STA && dev->radio.sta.saved_networks != NULL) {
+        for (uint8_t i = 0; i < dev->radio.sta.saved_networks_count; ++i) {
+            spill_write_str(dev->radio.sta.saved_networks[i]);
+        }
+    }
+}
+
+/** As wendigo_spill_device(), with spill_mutex already held */
+static bool spill_device_locked(wendigo_device *dev) {
+    if (dev == NULL || !spill_open() || !spill_index_reserve(spill_count + 1)) {
+        return false;
+    }
+    /* Zero the lengths of attributes that aren't there so the reader can rely on them */
+    wendigo_device record;
+    memcpy(&record, dev, sizeof(wendigo_device));
+    if (record.scanType == SCAN_HCI || record.scanType == SCAN_BLE) {
+        wendigo_bt_device *bt = &(record.radio.bluetooth);
+        if (bt->bdname == NULL) {
+            bt->bdname_len = 0;
+        }
+        if (bt->eir == NULL) {
+            bt->eir_len = 0;
+        }
+        if (bt->bt_services.service_uuids == NULL) {
+            bt->bt_services.num_services = 0;
+        }
+        if (bt->bt_services.known_services == NULL) {
+            bt->bt_services.known_services_len = 0;
+        }
+    } else if (record.scanType == SCAN_WIFI_AP && record.radio.ap.stations == NULL) {
+        record.radio.ap.stations_count = 0;
+    } else if (record.scanType == SCAN_WIFI_STA && record.radio.sta.saved_networks == NULL) {
+        record.radio.sta.saved_networks_count = 0;
+    }
+    WendigoSpillHeader header;
+    memcpy(header.mac, dev->mac, MAC_BYTES);
+    header.length = spill_attributes_length(&record);
+
+    spill_write_failed = !storage_file_seek(spill_file, spill_end, true);
+    spill_buffer_len = 0;
+    spill_write(&header, sizeof(WendigoSpillHeader));
+    spill_write(&record, sizeof(wendigo_device));
+    spill_write_attributes(dev);
+    spill_flush();
+    if (spill_write_failed) {
+        wendigo_log(MSG_WARN, "Unable to write device to SD card, keeping it in memory.");
+        return false;
+    }
+    uint16_t slot = spill_slot(dev->mac);
+    if (spill_index[slot].offset == SPILL_EMPTY) {
+        memcpy(spill_index[slot].mac, dev->mac, MAC_BYTES);
+        ++spill_count;
+    }
+    spill_index[slot].offset = spill_end;
+    spill_end += sizeof(WendigoSpillHeader) + sizeof(wendigo_device) + header.length;
+    return true;
+}
+
+/** Write `dev` to the spill file and add it to spill_index[]. The caller must
+ * hold app->devicesMutex, and is responsible for removing the device from the
+ * device cache if this succeeds.
+ * Returns false if the device couldn't be written, in which case it should
+ * stay where it is.
+ */
+bool wendigo_spill_device(WendigoApp *app, wendigo_device *dev) {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_spill_device()");
+    UNUSED(app);
+    if (spill_mutex == NULL) {
+        spill_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    }
+    furi_mutex_acquire(spill_mutex, FuriWaitForever);
+    bool result = spill_device_locked(dev);
+    furi_mutex_release(spill_mutex);
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_spill_device()");
+    return result;
+}
+
+/** Read `len` bytes from the spill file into a new allocation, storing it in
+ * `*dest`. Returns false on failure, leaving `*dest` NULL.
+ */
+static bool spill_read_alloc(void **dest, uint16_t len, bool terminate) {
+    *dest = NULL;
+    if (len == 0 && !terminate) {
+        return true;
+    }
+    uint8_t *result = malloc(len + ((terminate) ? 1 : 0));
+    if (result == NULL) {
+        return false;
+    }
+    if (storage_file_read(spill_file, result, len) != len) {
+        free(result);
+        return false;
+    }
+    if (terminate) {
+        result[len] = '\0';
+    }
+    *dest = result;
+    return true;
+}
+
+/** Read a string written by spill_write_str(). Empty strings are read as NULL. */
+static bool spill_read_str(char **dest) {
+    uint8_t len;
+    *dest = NULL;
+    if (storage_file_read(spill_file, &len, sizeof(len)) != sizeof(len)) {
+        return false;
+    }
+    return (len == 0) ? true : spill_read_alloc((void **)dest, len, true);
+}
+
+/** Read the record at `offset` in the spill file into a new wendigo_device
+ * whose attributes are allocated as wendigo_free_device() expects.
+ * Returns NULL on failure.
+ */
+static wendigo_device *spill_read_device(uint32_t offset, uint8_t mac[MAC_BYTES]) {
+    WendigoSpillHeader header;
+    wendigo_device *dev = malloc(sizeof(wendigo_device));
+    if (dev == NULL) {
+        return NULL;
+    }
+    if (!storage_file_seek(spill_file, offset, true) ||
+            storage_file_read(spill_file, &header, sizeof(WendigoSpillHeader)) != sizeof(WendigoSpillHeader) ||
+            memcmp(header.mac, mac, MAC_BYTES) ||
+            storage_file_read(spill_file, dev, sizeof(wendigo_device)) != sizeof(wendigo_device)) {
+        free(dev);
+        return NULL;
+    }
+    bool ok = true;
+    if (dev->scanType == SCAN_HCI || dev->scanType == SCAN_BLE) {
+        wendigo_bt_device *bt = &(dev->radio.bluetooth);
+        /* Read into locals so dev is always safe to pass to wendigo_free_device() */
+        char *bdname = NULL;
+        uint8_t *eir = NULL;
+        void *service_uuids = NULL;
+        const bt_uuid **known_services = NULL;
+        ok = spill_read_alloc((void **)&bdname, bt->bdname_len, bt->bdname_len > 0) &&
+            spill_read_alloc((void **)&eir, bt->eir_len, false) &&
+            spill_read_alloc(&service_uuids, sizeof(esp_bt_uuid_t) * bt->bt_services.num_services, false) &&
+            spill_read_alloc((void **)&known_services,
+                sizeof(bt_uuid *) * bt->bt_services.known_services_len, false);
+        bt->bdname = bdname;
+        bt->eir = eir;
+        bt->bt_services.service_uuids = service_uuids;
+        bt->bt_services.known_services = known_services;
+    } else if (dev->scanType == SCAN_WIFI_AP) {
+        uint8_t count = dev->radio.ap.stations_count;
+        dev->radio.ap.stations_count = 0;
+        dev->radio.ap.stations = (count == 0) ? NULL : malloc(sizeof(uint8_t *) * count);
+        ok = (count == 0 || dev->radio.ap.stations != NULL);
+        for (uint8_t i = 0; ok && i < count; ++i) {
+            ok = spill_read_alloc((void **)&(dev->radio.ap.stations[i]), MAC_BYTES, false);
+            if (ok) {
+                ++dev->radio.ap.stations_count;
+            }
+        }
+    } else if (dev->scanType == SCAN_WIFI_STA) {
+        uint8_t count = dev->radio.sta.saved_networks_count;
+        dev->radio.sta.saved_networks_count = 0;
+        dev->radio.sta.saved_networks = (count == 0) ? NULL : malloc(sizeof(char *) * count);
+        ok = (count == 0 || dev->radio.sta.saved_networks != NULL);
+        for (uint8_t i = 0; ok && i < count; ++i) {
+            ok = spill_read_str(&(dev->radio.sta.saved_networks[i]));
+            if (ok) {
+                ++dev->radio.sta.saved_networks_count;
+            }
+        }
+    }
+    if (!ok) {
+        wendigo_free_device(dev);
+        return NULL;
+    }
+    return dev;
+}
+
+/** Has the device with the specified MAC been spilled to the SD card? */
+bool wendigo_spill_contains(uint8_t mac[MAC_BYTES]) {
+    if (spill_count == 0) {
+        return false;
+    }
+    furi_mutex_acquire(spill_mutex, FuriWaitForever);
+    bool result = spill_count > 0 && spill_index[spill_slot(mac)].offset != SPILL_EMPTY;
+    furi_mutex_release(spill_mutex);
+    return result;
+}
+
+/** Read the device with the specified MAC from the SD card, storing the offset
+ * of its record in `offset`. Returns NULL if it isn't there or couldn't be
+ * read. The caller must not hold app->devicesMutex.
+ */
+static wendigo_device *spill_read(uint8_t mac[MAC_BYTES], uint32_t *offset) {
+    wendigo_device *result = NULL;
+    furi_mutex_acquire(spill_mutex, FuriWaitForever);
+    if (spill_count > 0) {
+        *offset = spill_index[spill_slot(mac)].offset;
+        if (*offset != SPILL_EMPTY) {
+            result = spill_read_device(*offset, mac);
+            if (result == NULL) {
+                wendigo_log(MSG_WARN, "Unable to read device from SD card.");
+            }
+        }
+    }
+    furi_mutex_release(spill_mutex);
+    return result;
+}
+
+/** Copy `spilled`, read from `offset` in the spill file, into the device cache
+ * and, only once that has succeeded, forget that it was on the SD card.
+ * `spilled` is freed. Returns true if the device is now in the device cache,
+ * whether it was copied there by this call or another thread got there first.
+ * The caller must not hold app->devicesMutex.
+ */
+static bool spill_adopt(WendigoApp *app, wendigo_device *spilled, uint32_t offset) {
+    furi_mutex_acquire(app->devicesMutex, FuriWaitForever);
+    bool result = device_index_from_mac(spilled->mac) < devices_count;
+    furi_mutex_acquire(spill_mutex, FuriWaitForever);
+    uint16_t slot = spill_slot(spilled->mac);
+    /* If the record has moved the device was restored and spilled again while
+       it was being read, so this copy is out of date */
+    if (!result && spill_index[slot].offset == offset &&
+            wendigo_cache_device(app, spilled, true) != NULL) {
+        spill_index_remove(slot);
+        result = true;
+        /* It was taken out of the device list when it was spilled */
+        if (app->current_view == WendigoAppViewDeviceList) {
+            wendigo_mark_device_dirty_locked(app, devices_count - 1);
+        }
+    }
+    furi_mutex_release(spill_mutex);
+    furi_mutex_release(app->devicesMutex);
+    wendigo_free_device(spilled);
+    return result;
+}
+
+/** If the device with the specified MAC has been spilled to the SD card, read
+ * it back into the device cache with its tagged status and lastSeen intact.
+ * Returns true if the device is now in the device cache - Because it was
+ * restored by this call, or by another thread in the meantime. A device that
+ * couldn't be restored stays on the SD card.
+ * Must not be called with app->devicesMutex held.
+ */
+bool wendigo_spill_restore(WendigoApp *app, uint8_t mac[MAC_BYTES]) {
+    if (spill_count == 0) {
+        return false;
+    }
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_spill_restore()");
+    uint32_t offset;
+    wendigo_device *spilled = spill_read(mac, &offset);
+    bool result = spilled != NULL && spill_adopt(app, spilled, offset);
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_spill_restore()");
+    return result;
+}
+
+/** Restore up to WENDIGO_SPILL_BROWSE_BATCH devices so the user can browse
+ * them, starting with the most recently spilled and working back through the
+ * file on each call. Restored devices are added to the device list when it
+ * next refreshes, and stay in memory for at least WENDIGO_SPILL_AGE.
+ * Returns the number of devices restored.
+ * Must not be called with app->devicesMutex held.
+ */
+uint16_t wendigo_spill_browse(WendigoApp *app) {
+    if (spill_count == 0) {
+        return 0;
+    }
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_spill_browse()");
+    /* The batch is the entries with the highest offsets below spill_browse_before */
+    WendigoSpillEntry batch[WENDIGO_SPILL_BROWSE_BATCH];
+    uint8_t batch_count = 0;
+    furi_mutex_acquire(spill_mutex, FuriWaitForever);
+    for (uint8_t pass = 0; pass < 2 && batch_count == 0; ++pass) {
+        for (uint16_t i = 0; i < spill_index_capacity; ++i) {
+            uint32_t offset = spill_index[i].offset;
+            if (offset == SPILL_EMPTY || offset >= spill_browse_before) {
+                continue;
+            }
+            /* Insert into batch[], highest offset first */
+            uint8_t pos = batch_count;
+            while (pos > 0 && batch[pos - 1].offset < offset) {
+                --pos;
+            }
+            if (pos == WENDIGO_SPILL_BROWSE_BATCH) {
+                continue;
+            }
+            if (batch_count < WENDIGO_SPILL_BROWSE_BATCH) {
+                ++batch_count;
+            }
+            memmove(&(batch[pos + 1]), &(batch[pos]),
+                sizeof(WendigoSpillEntry) * (batch_count - pos - 1));
+            memcpy(&(batch[pos]), &(spill_index[i]), sizeof(WendigoSpillEntry));
+        }
+        if (batch_count == 0) {
+            /* Reached the start of the file - Go back to the end */
+            spill_browse_before = SPILL_EMPTY;
+        }
+    }
+    if (batch_count > 0) {
+        spill_browse_before = batch[batch_count - 1].offset;
+    }
+    for (uint8_t i = 0; i < batch_count; ++i) {
+        memcpy(spill_browsed[i], batch[i].mac, MAC_BYTES);
+    }
+    spill_browsed_count = batch_count;
+    spill_browse_time = furi_hal_rtc_get_timestamp();
+    furi_mutex_release(spill_mutex);
+
+    uint16_t result = 0;
+    for (uint8_t i = 0; i < batch_count; ++i) {
+        uint32_t offset;
+        wendigo_device *spilled = spill_read(batch[i].mac, &offset);
+        if (spilled != NULL && spill_adopt(app, spilled, offset)) {
+            ++result;
+        }
+    }
+    FURI_LOG_D(WENDIGO_TAG, "Restored %u of %u devices from SD card.", result, batch_count);
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_spill_browse()");
+    return result;
+}
+
+/** Was `mac` restored by wendigo_spill_browse() less than WENDIGO_SPILL_AGE
+ * ago? The caller must hold spill_mutex.
+ */
+static bool spill_is_browsed(uint8_t mac[MAC_BYTES], uint32_t now) {
+    if (spill_browsed_count == 0 || now < spill_browse_time ||
+            now - spill_browse_time >= WENDIGO_SPILL_AGE) {
+        return false;
+    }
+    for (uint8_t i = 0; i < spill_browsed_count; ++i) {
+        if (!memcmp(spill_browsed[i], mac, MAC_BYTES)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** Has `dev` not been seen for WENDIGO_SPILL_AGE, and can it be spilled?
+ * The caller must hold spill_mutex.
+ */
+static bool spill_is_cold(wendigo_device *dev, uint32_t now) {
+    return !dev->tagged && dev->lastSeen <= now && now - dev->lastSeen >= WENDIGO_SPILL_AGE &&
+        !wendigo_device_is_pinned(dev) && !spill_is_browsed(dev->mac, now);
+}
+
+/** Move devices that haven't been seen for WENDIGO_SPILL_AGE seconds to the SD
+ * card. Only does anything every WENDIGO_SPILL_INTERVAL_MS, so it can be
+ * called for every device added.
+ * Must not be called with app->devicesMutex held.
+ */
+void wendigo_spill_check(WendigoApp *app) {
+    uint32_t tick = furi_get_tick();
+    if (spill_disabled || tick - spill_last_check < furi_ms_to_ticks(WENDIGO_SPILL_INTERVAL_MS)) {
+        return;
+    }
+    spill_last_check = tick;
+    uint32_t now = furi_hal_rtc_get_timestamp();
+    furi_mutex_acquire(app->devicesMutex, FuriWaitForever);
+    if (spill_mutex == NULL) {
+        spill_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    }
+    furi_mutex_acquire(spill_mutex, FuriWaitForever);
+    uint16_t idx;
+    for (idx = 0; idx < devices_count && !spill_is_cold(devices[idx], now); ++idx) { }
+    if (idx == devices_count) {
+        furi_mutex_release(spill_mutex);
+        furi_mutex_release(app->devicesMutex);
+        return;
+    }
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_spill_check()");
+    uint16_t spilled = 0;
+    wendigo_scene_device_list_begin_removal(app);
+    /* Work backwards so that removing devices doesn't move the ones still to be checked */
+    for (idx = devices_count; idx > 0; --idx) {
+        if (spill_is_cold(devices[idx - 1], now)) {
+            if (!spill_device_locked(devices[idx - 1])) {
+                break;
+            }
+            wendigo_remove_device(app, idx - 1);
+            ++spilled;
+        }
+    }
+    wendigo_scene_device_list_end_removal(app);
+    furi_mutex_release(spill_mutex);
+    furi_mutex_release(app->devicesMutex);
+    FURI_LOG_D(WENDIGO_TAG, "Moved %u devices to SD card, %u devices on SD card.", spilled, spill_count);
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_spill_check()");
+}
+
+/** Number of devices currently on the SD card */
+uint16_t wendigo_spill_count() {
+    return spill_count;
+}
+
+/** Forget all spilled devices, close and remove the spill file. Called when
+ * the device cache is freed.
+ */
+void wendigo_spill_free() {
+    FURI_LOG_T(WENDIGO_TAG, "Start wendigo_spill_free()");
+    if (spill_file != NULL) {
+        storage_file_close(spill_file);
+        storage_file_free(spill_file);
+        spill_file = NULL;
+        storage_simply_remove(spill_storage, WENDIGO_SPILL_PATH);
+        furi_record_close(RECORD_STORAGE);
+        spill_storage = NULL;
+    }
+    if (spill_index != NULL) {
+        free(spill_index);
+        spill_index = NULL;
+    }
+    spill_index_capacity = 0;
+    spill_count = 0;
+    spill_index_retry_at = 0;
+    spill_end = 0;
+    spill_disabled = false;
+    spill_browsed_count = 0;
+    spill_browse_before = SPILL_EMPTY;
+    if (spill_mutex != NULL) {
+        furi_mutex_free(spill_mutex);
+        spill_mutex = NULL;
+    }
+    FURI_LOG_T(WENDIGO_TAG, "End wendigo_spill_free()");
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "wendigo_app_i.h"
+
+/* File holding devices that have been moved out of RAM. It's only meaningful
+   while the app is running - it's recreated on launch and removed on exit */
+#define WENDIGO_SPILL_PATH           APP_DATA_PATH("devices.cache")
+/* Devices that haven't been seen for this long (seconds) are moved to the SD card */
+#define WENDIGO_SPILL_AGE            (10 * 60)
+/* How often to look for devices to move to the SD card (ms) */
+#define WENDIGO_SPILL_INTERVAL_MS    (5000)
+/* Size of the buffer used to batch up writes to the SD card */
+#define WENDIGO_SPILL_BUFFER_SIZE    (256)
+/* Number of devices brought back each time the user asks to see devices on the SD card */
+#define WENDIGO_SPILL_BROWSE_BATCH   (16)
+
+bool wendigo_spill_device(WendigoApp *app, wendigo_device *dev);
+bool wendigo_spill_restore(WendigoApp *app, uint8_t mac[MAC_BYTES]);
+uint16_t wendigo_spill_browse(WendigoApp *app);
+bool wendigo_spill_contains(uint8_t mac[MAC_BYTES]);
+void wendigo_spill_check(WendigoApp *app);
+uint16_t wendigo_spill_count();
+void wendigo_spill_free();
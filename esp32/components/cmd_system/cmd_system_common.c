@@ -197,6 +197,12 @@ static int tasks_info(int argc, char **argv)
     fputs("\n", stdout);
     vTaskList(task_list_buffer);
     fputs(task_list_buffer, stdout);
+#ifdef CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    /* Share of CPU time each task has used since boot */
+    fputs("\nTask Name\tRun Time\tCPU\n", stdout);
+    vTaskGetRunTimeStats(task_list_buffer);
+    fputs(task_list_buffer, stdout);
+#endif
     free(task_list_buffer);
     return 0;
 }
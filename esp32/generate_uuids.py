@@ -0,0 +1,300 @@
+#!/usr/bin/env python3
+"""Generate ESP32-Wendigo's Bluetooth UUID tables from the Bluetooth SIG's
+assigned numbers.
+
+Reads the assigned numbers YAML files in esp32/ and writes bt_uuids.h and
+bt_uuids.c into esp32/main/. Each table is a const array sorted by UUID, so it
+stays in flash and bt_uuid_lookup() can binary search it, and every name lives
+once in a single string pool shared by all tables.
+
+    python3 esp32/generate_uuids.py
+    python3 esp32/generate_uuids.py --check
+
+The tables and the files they're generated from (any of the names listed is
+accepted - the SIG's repository and its published bundle name them
+differently):
+
+    Service classes   service_class.yaml
+    GATT services     service_uuids.yaml
+    Characteristics   characteristic_uuids.yaml
+    Company IDs       company_identifiers.yaml
+
+Every table's file must be present - The script fails rather than generate
+an empty table. Update a table by replacing its file in esp32/ with a newer
+copy from the SIG and running this script.
+
+--check doesn't write anything; it exits with status 1 if the files in
+esp32/main/ differ from what the YAML would generate.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_YAML_DIR = SCRIPT_DIR
+DEFAULT_OUT_DIR = os.path.join(SCRIPT_DIR, "main")
+OUTPUT_NAME = "bt_uuids"
+
+# (enum suffix, description, candidate file names, key holding the 16-bit value)
+TABLES = [
+    ("SERVICE_CLASS", "Service classes",
+        ["service_class.yaml", "assigned_numbers_uuids_service_class.yaml"], "uuid"),
+    ("GATT_SERVICE", "GATT services",
+        ["service_uuids.yaml", "assigned_numbers_uuids_service_uuids.yaml"], "uuid"),
+    ("CHARACTERISTIC", "GATT characteristics",
+        ["characteristic_uuids.yaml", "assigned_numbers_uuids_characteristic_uuids.yaml"], "uuid"),
+    ("COMPANY", "Company identifiers",
+        ["company_identifiers.yaml", "assigned_numbers_company_identifiers_company_identifiers.yaml"], "value"),
+]
+
+ENTRY_RE = re.compile(r"^\s*-\s*(\w+)\s*:\s*(.*?)\s*$")
+FIELD_RE = re.compile(r"^\s+(\w+)\s*:\s*(.*?)\s*$")
+
+
+class YamlError(Exception):
+    pass
+
+
+def unquote(value):
+    if len(value) >= 2 and value[0] == value[-1] == "'":
+        return value[1:-1].replace("''", "'")
+    if len(value) >= 2 and value[0] == value[-1] == '"':
+        return value[1:-1].replace('\\"', '"').replace("\\\\", "\\")
+    return value
+
+
+def parse_assigned_numbers(path, key):
+    """Return [(value, name)] from an assigned numbers file - A top-level key
+    holding a list of mappings, each with `key` and `name`. That's all the
+    structure these files have, so no YAML library is needed."""
+    entries = []
+    current = None
+    with open(path, encoding="utf-8") as f:
+        for line_num, line in enumerate(f, 1):
+            if not line.strip() or line.lstrip().startswith("#"):
+                continue
+            match = ENTRY_RE.match(line)
+            if match:
+                current = {match.group(1): unquote(match.group(2))}
+                current["line"] = line_num
+                entries.append(current)
+                continue
+            match = FIELD_RE.match(line)
+            if match and current is not None:
+                current[match.group(1)] = unquote(match.group(2))
+    result = []
+    for entry in entries:
+        if key not in entry or "name" not in entry:
+            raise YamlError("%s:%d: entry has no %s or name" % (path, entry["line"], key))
+        try:
+            value = int(entry[key], 0)
+        except ValueError:
+            raise YamlError("%s:%d: %s isn't a number: %s" % (path, entry["line"], key, entry[key]))
+        if not 0 <= value <= 0xFFFF:
+            raise YamlError("%s:%d: %s doesn't fit in 16 bits" % (path, entry["line"], key))
+        result.append((value, entry["name"]))
+    return result
+
+
+def c_string(text):
+    """A C string literal for `text`, UTF-8 encoded, with anything that isn't
+    printable ASCII as a three-digit octal escape (which, unlike a hex escape,
+    can't swallow the character after it)."""
+    out = []
+    for byte in text.encode("utf-8"):
+        if byte in (0x22, 0x5C):
+            out.append("\\" + chr(byte))
+        elif 0x20 <= byte < 0x7F and byte != 0x3F:
+            out.append(chr(byte))
+        else:
+            out.append("\\%03o" % byte)
+    return '"%s"' % "".join(out)
+
+
+def load_tables(yaml_dir):
+    """Return [(suffix, description, source file, sorted [(value, name)])]"""
+    tables = []
+    for suffix, description, names, key in TABLES:
+        source = None
+        entries = []
+        for name in names:
+            path = os.path.join(yaml_dir, name)
+            if os.path.exists(path):
+                source = name
+                seen = {}
+                for value, entry_name in parse_assigned_numbers(path, key):
+                    # Keep the first name for a value that's listed twice
+                    seen.setdefault(value, entry_name)
+                entries = sorted(seen.items())
+                break
+        if source is None:
+            raise YamlError("%s: No YAML found in %s - Expected one of %s" %
+                (description, yaml_dir, ", ".join(names)))
+        if not entries:
+            raise YamlError("%s: %s has no entries" % (description, os.path.join(yaml_dir, source)))
+        tables.append((suffix, description, source, entries))
+    return tables
+
+
+def build_pool(tables):
+    """Each distinct name once, in order of first use. Returns (names, offsets, pool size)"""
+    names = []
+    offsets = {}
+    pool_len = 0
+    for _, _, _, entries in tables:
+        for _, name in entries:
+            if name not in offsets:
+                offsets[name] = pool_len
+                names.append(name)
+                pool_len += len(name.encode("utf-8")) + 1
+    return names, offsets, pool_len
+
+
+HEADER_COMMENT = [
+    "/* Generated by esp32/generate_uuids.py from the Bluetooth SIG's assigned numbers.",
+    " * Do not edit - Add or update the YAML in esp32/ and run the script.",
+]
+
+
+def generate_header(tables):
+    out = list(HEADER_COMMENT)
+    out.append(" */")
+    out.append("#ifndef WENDIGO_BT_UUIDS_H")
+    out.append("#define WENDIGO_BT_UUIDS_H")
+    out.append("")
+    out.append("#include <stddef.h>")
+    out.append("#include <stdint.h>")
+    out.append("#include <sys/time.h>")
+    out.append("")
+    out.append("#include <esp_bt_defs.h>")
+    out.append("#include \"wendigo_common_defs.h\"")
+    out.append("")
+    out.append("typedef enum {")
+    for i, (suffix, description, _, _) in enumerate(tables):
+        out.append("    BT_UUID_TABLE_%s%s,%s/* %s */" % (suffix, " = 0" if i == 0 else "",
+            " " * (24 - len(suffix) - (4 if i == 0 else 0)), description))
+    out.append("    BT_UUID_TABLE_COUNT")
+    out.append("} BtUuidTable;")
+    out.append("")
+    out.append("/* Entries in each table when UUID decoding is compiled in (CONFIG_DECODE_UUIDS) */")
+    for suffix, _, _, entries in tables:
+        out.append("#define BT_UUID_%s_COUNT %s(%d)" % (suffix, " " * (20 - len(suffix)), len(entries)))
+    out.append("")
+    out.append("const bt_uuid *bt_uuid_lookup(BtUuidTable table, uint16_t uuid16);")
+    out.append("")
+    out.append("#endif")
+    out.append("")
+    return "\n".join(out)
+
+
+def generate_source(tables):
+    names, offsets, pool_len = build_pool(tables)
+    out = list(HEADER_COMMENT)
+    out.append(" *")
+    for suffix, description, source, entries in tables:
+        out.append(" * %s: %s, %d entries" % (description, source, len(entries)))
+    out.append(" */")
+    out.append("#include \"bt_uuids.h\"")
+    out.append("")
+    out.append("#if defined(CONFIG_BT_ENABLED) && defined(CONFIG_DECODE_UUIDS)")
+    out.append("")
+    out.append("/* Every name, once, null-terminated (%d bytes) */" % pool_len)
+    out.append("static const char bt_uuid_names[] =")
+    for name in names:
+        out.append("    %s \"\\0\"  /* %d */" % (c_string(name), offsets[name]))
+    out[-1] = out[-1].replace(" \"\\0\"  /*", ";  /*", 1)
+    out.append("")
+    for suffix, _, _, entries in tables:
+        var = "bt_uuids_" + suffix.lower()
+        out.append("static const bt_uuid %s[BT_UUID_%s_COUNT] = {" % (var, suffix))
+        for value, name in entries:
+            out.append("    {0x%04X, bt_uuid_names + %d}," % (value, offsets[name]))
+        out.append("};")
+        out.append("")
+    out.append("static const bt_uuid *const bt_uuid_tables[BT_UUID_TABLE_COUNT] = {")
+    for suffix, _, _, _ in tables:
+        out.append("    bt_uuids_%s," % suffix.lower())
+    out.append("};")
+    out.append("static const uint16_t bt_uuid_table_counts[BT_UUID_TABLE_COUNT] = {")
+    for suffix, _, _, _ in tables:
+        out.append("    BT_UUID_%s_COUNT," % suffix)
+    out.append("};")
+    out.append("")
+    out.append("/** Binary search `table` for `uuid16`. Returns NULL if it isn't there */")
+    out.append("const bt_uuid *bt_uuid_lookup(BtUuidTable table, uint16_t uuid16) {")
+    out.append("    if (table >= BT_UUID_TABLE_COUNT) {")
+    out.append("        return NULL;")
+    out.append("    }")
+    out.append("    const bt_uuid *entries = bt_uuid_tables[table];")
+    out.append("    uint16_t low = 0;")
+    out.append("    uint16_t high = bt_uuid_table_counts[table];")
+    out.append("    while (low < high) {")
+    out.append("        uint16_t mid = low + ((high - low) / 2);")
+    out.append("        if (entries[mid].uuid16 == uuid16) {")
+    out.append("            return &(entries[mid]);")
+    out.append("        } else if (entries[mid].uuid16 < uuid16) {")
+    out.append("            low = mid + 1;")
+    out.append("        } else {")
+    out.append("            high = mid;")
+    out.append("        }")
+    out.append("    }")
+    out.append("    return NULL;")
+    out.append("}")
+    out.append("")
+    out.append("#else")
+    out.append("")
+    out.append("const bt_uuid *bt_uuid_lookup(BtUuidTable table, uint16_t uuid16) {")
+    out.append("    (void)table;")
+    out.append("    (void)uuid16;")
+    out.append("    return NULL;")
+    out.append("}")
+    out.append("")
+    out.append("#endif")
+    out.append("")
+    return "\n".join(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--yaml-dir", default=DEFAULT_YAML_DIR, help="directory holding the YAML (default: %(default)s)")
+    parser.add_argument("--check", action="store_true", help="verify the generated files are up to date")
+    parser.add_argument("out_dir", nargs="?", default=DEFAULT_OUT_DIR, metavar="DIR",
+                        help="directory to write bt_uuids.[ch] into (default: %(default)s)")
+    args = parser.parse_args()
+
+    try:
+        tables = load_tables(args.yaml_dir)
+    except (YamlError, OSError) as e:
+        print(e, file=sys.stderr)
+        return 2
+    outputs = {
+        OUTPUT_NAME + ".h": generate_header(tables),
+        OUTPUT_NAME + ".c": generate_source(tables),
+    }
+
+    stale = []
+    for name, content in outputs.items():
+        path = os.path.join(args.out_dir, name)
+        if args.check:
+            try:
+                with open(path, encoding="utf-8") as f:
+                    current = f.read()
+            except OSError:
+                current = None
+            if current != content:
+                stale.append(path)
+        else:
+            os.makedirs(args.out_dir, exist_ok=True)
+            with open(path, "w", encoding="utf-8") as f:
+                f.write(content)
+    if stale:
+        for path in stale:
+            print("%s is out of date - run %s" % (path, os.path.relpath(__file__)), file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
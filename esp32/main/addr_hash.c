@@ -0,0 +1,17 @@
+#include "addr_hash.h"
+
+/** Add `len` bytes to the 32-bit FNV-1a `hash` */
+uint32_t addr_hash(const uint8_t *bytes, uint16_t len, uint32_t hash) {
+    for (uint16_t i = 0; i < len; ++i) {
+        hash ^= bytes[i];
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+/** The slot of a table of `entries` slots that probing for the device with
+ * address `addr` starts at
+ */
+uint32_t addr_hash_slot(const uint8_t *addr, uint32_t entries) {
+    return addr_hash(addr, ADDR_HASH_ADDR_LEN, ADDR_HASH_INIT) % entries;
+}
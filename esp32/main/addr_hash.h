@@ -0,0 +1,20 @@
+#ifndef WENDIGO_ADDR_HASH_H
+#define WENDIGO_ADDR_HASH_H
+
+/** FNV-1a hashing for the tables keyed by a device's address - ble_filter.c's
+ * recently reported devices, ble_scan_policy.c's scan response cache and
+ * wendigo-decode's device table. It's cheap, and spreads addresses that only
+ * differ in their last byte well enough for a table indexed by the hash.
+ * Nothing here needs ESP-IDF, so it can be used on a host.
+ */
+#include <stdint.h>
+
+/* Bytes in a BDA or MAC */
+#define ADDR_HASH_ADDR_LEN (6)
+/* Hash to start from, or to continue with the result of a previous call */
+#define ADDR_HASH_INIT     (2166136261U)
+
+uint32_t addr_hash(const uint8_t *bytes, uint16_t len, uint32_t hash);
+uint32_t addr_hash_slot(const uint8_t *addr, uint32_t entries);
+
+#endif
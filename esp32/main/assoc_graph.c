@@ -0,0 +1,121 @@
+#include "assoc_graph.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Minimum capacity of nodes[] */
+#define ASSOC_GRAPH_MIN_NODES 32
+
+static assoc_node *nodes = NULL;
+static uint16_t nodes_capacity = 0;
+
+static void node_init(assoc_node *node) {
+    node->ap = ASSOC_GRAPH_NONE;
+    node->prev = ASSOC_GRAPH_NONE;
+    node->next = ASSOC_GRAPH_NONE;
+    node->first = ASSOC_GRAPH_NONE;
+    node->last = ASSOC_GRAPH_NONE;
+    node->count = 0;
+}
+
+/** Make sure nodes[] has a node for device index `idx`, doubling its
+ *  capacity as needed so that reallocs become rare as the cache grows.
+ *  Returns false if memory could not be allocated.
+ */
+static bool nodes_reserve(uint16_t idx) {
+    if (idx == ASSOC_GRAPH_NONE) {
+        return false;
+    }
+    if (idx < nodes_capacity) {
+        return true;
+    }
+    uint32_t new_capacity = (nodes_capacity < ASSOC_GRAPH_MIN_NODES) ? ASSOC_GRAPH_MIN_NODES : nodes_capacity;
+    while (new_capacity <= idx) {
+        new_capacity *= 2;
+    }
+    if (new_capacity > ASSOC_GRAPH_NONE) {
+        new_capacity = ASSOC_GRAPH_NONE;
+    }
+    assoc_node *new_nodes = realloc(nodes, sizeof(assoc_node) * new_capacity);
+    if (new_nodes == NULL) {
+        return false;
+    }
+    for (uint32_t i = nodes_capacity; i < new_capacity; ++i) {
+        node_init(&new_nodes[i]);
+    }
+    nodes = new_nodes;
+    nodes_capacity = (uint16_t)new_capacity;
+    return true;
+}
+
+/** Record that station `sta` is associated with AP `ap`, moving it from any
+ *  other AP it was associated with. Returns false if memory could not be
+ *  allocated, in which case nothing changes.
+ */
+bool assoc_graph_link(uint16_t sta, uint16_t ap) {
+    if (sta == ap || !nodes_reserve((sta > ap) ? sta : ap)) {
+        return false;
+    }
+    if (nodes[sta].ap == ap) {
+        return true;
+    }
+    assoc_graph_unlink(sta);
+    nodes[sta].ap = ap;
+    nodes[sta].prev = nodes[ap].last;
+    nodes[sta].next = ASSOC_GRAPH_NONE;
+    if (nodes[ap].last == ASSOC_GRAPH_NONE) {
+        nodes[ap].first = sta;
+    } else {
+        nodes[nodes[ap].last].next = sta;
+    }
+    nodes[ap].last = sta;
+    ++nodes[ap].count;
+    return true;
+}
+
+/** Remove station `sta` from the AP it's associated with, if any */
+void assoc_graph_unlink(uint16_t sta) {
+    if (sta >= nodes_capacity || nodes[sta].ap == ASSOC_GRAPH_NONE) {
+        return;
+    }
+    assoc_node *node = &nodes[sta];
+    assoc_node *ap = &nodes[node->ap];
+    if (node->prev == ASSOC_GRAPH_NONE) {
+        ap->first = node->next;
+    } else {
+        nodes[node->prev].next = node->next;
+    }
+    if (node->next == ASSOC_GRAPH_NONE) {
+        ap->last = node->prev;
+    } else {
+        nodes[node->next].prev = node->prev;
+    }
+    --ap->count;
+    node->ap = ASSOC_GRAPH_NONE;
+    node->prev = ASSOC_GRAPH_NONE;
+    node->next = ASSOC_GRAPH_NONE;
+}
+
+/** The AP station `sta` is associated with, or ASSOC_GRAPH_NONE */
+uint16_t assoc_graph_ap(uint16_t sta) {
+    return (sta < nodes_capacity) ? nodes[sta].ap : ASSOC_GRAPH_NONE;
+}
+
+/** The number of stations associated with `ap` */
+uint16_t assoc_graph_count(uint16_t ap) {
+    return (ap < nodes_capacity) ? nodes[ap].count : 0;
+}
+
+/** Place the stations associated with `ap` in `stations`, in the order they
+ *  were linked, up to `max` of them. Returns the number placed.
+ */
+uint16_t assoc_graph_stations(uint16_t ap, uint16_t *stations, uint16_t max) {
+    if (ap >= nodes_capacity) {
+        return 0;
+    }
+    uint16_t count = 0;
+    for (uint16_t sta = nodes[ap].first; sta != ASSOC_GRAPH_NONE && count < max; sta = nodes[sta].next) {
+        stations[count++] = sta;
+    }
+    return count;
+}
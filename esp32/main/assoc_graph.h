@@ -0,0 +1,41 @@
+#ifndef WENDIGO_ASSOC_GRAPH_H
+#define WENDIGO_ASSOC_GRAPH_H
+
+/** Associations between WiFi stations and access points.
+ * Devices are identified by their index into devices[], which never changes
+ * because devices are never removed from the ESP32's cache. A station is
+ * associated with at most one AP, so the station's own node holds its edge:
+ * the AP it's associated with and its neighbours in that AP's list of
+ * stations, which is doubly linked and threaded through the station nodes.
+ * Each AP's node holds the ends of its list and its length. That makes
+ *  * Linking, unlinking and looking up a station's AP O(1), and
+ *  * Listing an AP's k stations O(k), in the order they were linked.
+ * Linking a station that's already associated with another AP - it has
+ * roamed, or reassociated - moves its edge, so it's no longer listed under
+ * the AP it left.
+ * Nothing here needs ESP-IDF, so it can be exercised on a host. It isn't
+ * thread-safe; it's only used by the task that adds devices to the cache.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#define ASSOC_GRAPH_NONE 0xFFFF
+
+typedef struct assoc_node {
+    /* As a station */
+    uint16_t ap;            /* ASSOC_GRAPH_NONE if not associated */
+    uint16_t prev;          /* Neighbours in ap's list of stations */
+    uint16_t next;
+    /* As an AP */
+    uint16_t first;
+    uint16_t last;
+    uint16_t count;
+} assoc_node;
+
+bool assoc_graph_link(uint16_t sta, uint16_t ap);
+void assoc_graph_unlink(uint16_t sta);
+uint16_t assoc_graph_ap(uint16_t sta);
+uint16_t assoc_graph_count(uint16_t ap);
+uint16_t assoc_graph_stations(uint16_t ap, uint16_t *stations, uint16_t max);
+
+#endif
@@ -0,0 +1,95 @@
+#include "ble_filter.h"
+#include "addr_hash.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct ble_filter_entry {
+    uint8_t bda[ESP_BD_ADDR_LEN];
+    int8_t rssi;                /* RSSI when last reported */
+    bool used;
+    uint32_t payload_hash;      /* Hash of the payload when last reported */
+    uint32_t reported_ms;       /* When the device was last reported */
+} ble_filter_entry;
+
+static ble_filter_entry filter_table[CONFIG_BLE_FILTER_ENTRIES];
+static ble_filter_stats filter_stats;
+
+/** Record that the device in `entry` has been reported */
+static void ble_filter_update(ble_filter_entry *entry, uint32_t payload_hash,
+                              int8_t rssi, uint32_t now_ms) {
+    entry->payload_hash = payload_hash;
+    entry->rssi = rssi;
+    entry->reported_ms = now_ms;
+}
+
+/** Decide whether an advertisement from `bda` should be reported.
+ * `payload` is the advertisement followed by any scan response, `now_ms`
+ * a millisecond clock (it may wrap). Returns false if the advertisement
+ * adds nothing to the last one reported for the device.
+ */
+bool ble_filter_should_report(const uint8_t *bda, const uint8_t *payload, uint16_t payload_len,
+                              int8_t rssi, uint32_t now_ms) {
+    ++filter_stats.seen;
+    if (CONFIG_BLE_FILTER_WINDOW_MILLIS == 0 || bda == NULL) {
+        return true;
+    }
+    uint32_t payload_hash = addr_hash(payload, (payload == NULL) ? 0 : payload_len, ADDR_HASH_INIT);
+    uint32_t start = addr_hash_slot(bda, CONFIG_BLE_FILTER_ENTRIES);
+    ble_filter_entry *free_slot = NULL;
+    ble_filter_entry *oldest = NULL;
+    for (uint8_t probe = 0; probe < BLE_FILTER_PROBE_LEN && probe < CONFIG_BLE_FILTER_ENTRIES; ++probe) {
+        ble_filter_entry *entry = &filter_table[(start + probe) % CONFIG_BLE_FILTER_ENTRIES];
+        if (!entry->used) {
+            if (free_slot == NULL) {
+                free_slot = entry;
+            }
+            continue;
+        }
+        if (memcmp(entry->bda, bda, ESP_BD_ADDR_LEN) == 0) {
+            int16_t rssi_delta = abs((int16_t)rssi - (int16_t)entry->rssi);
+            if (entry->payload_hash == payload_hash && rssi_delta < CONFIG_BLE_FILTER_RSSI_DELTA &&
+                    (uint32_t)(now_ms - entry->reported_ms) < CONFIG_BLE_FILTER_WINDOW_MILLIS) {
+                ++filter_stats.suppressed;
+                return false;
+            }
+            ble_filter_update(entry, payload_hash, rssi, now_ms);
+            return true;
+        }
+        if (oldest == NULL || (uint32_t)(now_ms - entry->reported_ms) > (uint32_t)(now_ms - oldest->reported_ms)) {
+            oldest = entry;
+        }
+    }
+    /* A device we aren't tracking - Take a free slot, or the stalest one */
+    ble_filter_entry *entry = free_slot;
+    if (entry == NULL) {
+        entry = oldest;
+        ++filter_stats.evicted;
+    } else {
+        ++filter_stats.tracked;
+    }
+    memcpy(entry->bda, bda, ESP_BD_ADDR_LEN);
+    entry->used = true;
+    ble_filter_update(entry, payload_hash, rssi, now_ms);
+    return true;
+}
+
+/** Forget all devices and zero the counters */
+void ble_filter_reset() {
+    memset(filter_table, 0, sizeof(filter_table));
+    memset(&filter_stats, 0, sizeof(filter_stats));
+}
+
+void ble_filter_get_stats(ble_filter_stats *stats) {
+    if (stats != NULL) {
+        memcpy(stats, &filter_stats, sizeof(ble_filter_stats));
+    }
+}
+
+/** Percentage of advertisements the filter has suppressed */
+uint8_t ble_filter_suppressed_percent() {
+    if (filter_stats.seen == 0) {
+        return 0;
+    }
+    return (uint8_t)(((uint64_t)filter_stats.suppressed * 100) / filter_stats.seen);
+}
@@ -0,0 +1,49 @@
+#ifndef WENDIGO_BLE_FILTER_H
+#define WENDIGO_BLE_FILTER_H
+
+/** A small per-device filter for BLE advertisements.
+ * A busy room produces thousands of advertisements per second, nearly all of
+ * them identical to the last one from the same device. ble_gap_cb() asks this
+ * filter whether an advertisement is worth reporting before it allocates
+ * anything for it: An advertisement is suppressed if the device reported the
+ * same payload (advertisement and scan response, compared by hash) within the
+ * last CONFIG_BLE_FILTER_WINDOW_MILLIS and its RSSI has moved by less than
+ * CONFIG_BLE_FILTER_RSSI_DELTA since then.
+ * State is a fixed table of CONFIG_BLE_FILTER_ENTRIES devices, so the filter
+ * never allocates; when the table is full the least recently reported device
+ * nearby is forgotten. Nothing here needs more of ESP-IDF than esp_bt_defs.h,
+ * so the filter can be exercised on a host.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sdkconfig.h"
+#include <esp_bt_defs.h>
+
+#ifndef CONFIG_BLE_FILTER_WINDOW_MILLIS
+    #define CONFIG_BLE_FILTER_WINDOW_MILLIS 1000
+#endif
+#ifndef CONFIG_BLE_FILTER_RSSI_DELTA
+    #define CONFIG_BLE_FILTER_RSSI_DELTA 5
+#endif
+#ifndef CONFIG_BLE_FILTER_ENTRIES
+    #define CONFIG_BLE_FILTER_ENTRIES 128
+#endif
+
+/* Number of table slots examined for a device before one is evicted */
+#define BLE_FILTER_PROBE_LEN 8
+
+typedef struct ble_filter_stats {
+    uint32_t seen;          /* Advertisements checked */
+    uint32_t suppressed;    /* Advertisements the filter dropped */
+    uint32_t evicted;       /* Devices forgotten to make room for another */
+    uint16_t tracked;       /* Devices currently in the table */
+} ble_filter_stats;
+
+bool ble_filter_should_report(const uint8_t *bda, const uint8_t *payload, uint16_t payload_len,
+                              int8_t rssi, uint32_t now_ms);
+void ble_filter_reset();
+void ble_filter_get_stats(ble_filter_stats *stats);
+uint8_t ble_filter_suppressed_percent();
+
+#endif
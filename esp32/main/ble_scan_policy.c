@@ -0,0 +1,173 @@
+#include "ble_scan_policy.h"
+#include "addr_hash.h"
+
+#include <string.h>
+
+/* Scan interval and window for each duty cycle step. The type is chosen separately */
+static const ble_scan_setting duty_steps[] = {
+    { .interval = 0x50,  .window = 0x50 },     /* 100% */
+    { .interval = 0x50,  .window = 0x30 },     /* 60% - What Wendigo has always used */
+    { .interval = 0x80,  .window = 0x30 },     /* 37.5% */
+    { .interval = 0x100, .window = 0x30 },     /* 19% */
+};
+#define DUTY_STEP_COUNT   (sizeof(duty_steps) / sizeof(duty_steps[0]))
+#define DUTY_STEP_DEFAULT (1)
+
+/* Weight of the latest cycle in the smoothed rates (percent) */
+#define RATE_WEIGHT (50)
+
+typedef struct ble_scan_rsp_entry {
+    uint8_t bda[ESP_BD_ADDR_LEN];
+    bool used;
+    uint8_t rsp_len;
+    uint8_t rsp[BLE_SCAN_RSP_MAX_LEN];
+    uint32_t stored_ms;
+} ble_scan_rsp_entry;
+
+static ble_scan_rsp_entry rsp_cache[CONFIG_BLE_SCAN_RSP_CACHE_ENTRIES];
+
+/** Start from the parameters Wendigo used before they adapted: 60% duty, active */
+void ble_scan_policy_init(ble_scan_policy *policy) {
+    memset(policy, 0, sizeof(ble_scan_policy));
+    policy->level = DUTY_STEP_DEFAULT;
+    policy->active = true;
+}
+
+static uint32_t smooth(uint32_t current, uint32_t sample, bool measured) {
+    if (!measured) {
+        return sample;
+    }
+    return (uint32_t)(((uint64_t)sample * RATE_WEIGHT + (uint64_t)current * (100 - RATE_WEIGHT)) / 100);
+}
+
+/** Fold the counters from the scan cycle just finished into `policy` and
+ * choose the setting for the next one. Uses nothing but its arguments.
+ * Returns true if the setting has changed and must be given to the
+ * controller before scanning restarts.
+ */
+bool ble_scan_policy_update(ble_scan_policy *policy, const ble_scan_cycle *cycle) {
+    if (cycle->elapsed_ms == 0) {
+        return false;
+    }
+    const ble_scan_setting *step = &duty_steps[policy->level];
+    /* Advertisements per second the radio was actually listening, so that
+       density doesn't appear to fall when the duty cycle does */
+    uint64_t listen_ms = ((uint64_t)cycle->elapsed_ms * step->window) / step->interval;
+    if (listen_ms == 0) {
+        listen_ms = 1;
+    }
+    uint32_t advert_sample = (uint32_t)(((uint64_t)cycle->adverts * 1000) / listen_ms);
+    uint32_t new_sample = (uint32_t)(((uint64_t)cycle->new_devices * 60000) / cycle->elapsed_ms);
+    policy->advert_rate = smooth(policy->advert_rate, advert_sample, policy->measured);
+    policy->new_rate = smooth(policy->new_rate, new_sample, policy->measured);
+    policy->measured = true;
+
+    bool dense = (policy->advert_rate >= CONFIG_BLE_SCAN_DENSE_ADVERTS);
+    bool sparse = (policy->advert_rate < CONFIG_BLE_SCAN_DENSE_ADVERTS / 4);
+    bool discovering = (policy->new_rate >= CONFIG_BLE_SCAN_BUSY_NEW_DEVICES);
+    uint8_t level = policy->level;
+    if (sparse) {
+        if (level > 0) {
+            --level;
+        }
+    } else if (discovering) {
+        /* Don't sacrifice coverage while devices are still turning up */
+        if (level > DUTY_STEP_DEFAULT) {
+            --level;
+        }
+    } else if (dense && level < DUTY_STEP_COUNT - 1) {
+        ++level;
+    }
+
+    /* Scan requests are only worth their airtime in a busy room if there
+       are responses we haven't got */
+    bool active = true;
+    if (dense && cycle->scannable > 0) {
+        active = (((uint64_t)cycle->uncached * 100) / cycle->scannable >= CONFIG_BLE_SCAN_UNCACHED_PERCENT);
+    } else if (dense) {
+        active = false;
+    }
+
+    bool changed = (level != policy->level || active != policy->active);
+    policy->level = level;
+    policy->active = active;
+    return changed;
+}
+
+/** The scan interval, window and type `policy` has chosen */
+void ble_scan_policy_setting(const ble_scan_policy *policy, ble_scan_setting *setting) {
+    setting->interval = duty_steps[policy->level].interval;
+    setting->window = duty_steps[policy->level].window;
+    setting->active = policy->active;
+}
+
+/** Percentage of the time the radio listens at `policy`'s setting */
+uint8_t ble_scan_policy_duty_percent(const ble_scan_policy *policy) {
+    return (uint8_t)(((uint32_t)duty_steps[policy->level].window * 100) / duty_steps[policy->level].interval);
+}
+
+/** The cache entry for `bda`, or NULL. If it isn't there and `evict` is
+ * set, a free or the oldest slot is cleared for it.
+ */
+static ble_scan_rsp_entry *rsp_cache_find(const uint8_t *bda, bool evict) {
+    uint32_t start = addr_hash_slot(bda, CONFIG_BLE_SCAN_RSP_CACHE_ENTRIES);
+    ble_scan_rsp_entry *free_slot = NULL;
+    ble_scan_rsp_entry *oldest = NULL;
+    for (uint8_t probe = 0; probe < BLE_SCAN_RSP_PROBE_LEN && probe < CONFIG_BLE_SCAN_RSP_CACHE_ENTRIES; ++probe) {
+        ble_scan_rsp_entry *entry = &rsp_cache[(start + probe) % CONFIG_BLE_SCAN_RSP_CACHE_ENTRIES];
+        if (!entry->used) {
+            if (free_slot == NULL) {
+                free_slot = entry;
+            }
+        } else if (memcmp(entry->bda, bda, ESP_BD_ADDR_LEN) == 0) {
+            return entry;
+        } else if (oldest == NULL || (int32_t)(entry->stored_ms - oldest->stored_ms) < 0) {
+            oldest = entry;
+        }
+    }
+    if (!evict) {
+        return NULL;
+    }
+    ble_scan_rsp_entry *entry = (free_slot != NULL) ? free_slot : oldest;
+    memset(entry, 0, sizeof(ble_scan_rsp_entry));
+    memcpy(entry->bda, bda, ESP_BD_ADDR_LEN);
+    entry->used = true;
+    return entry;
+}
+
+static bool rsp_cache_fresh(const ble_scan_rsp_entry *entry, uint32_t now_ms) {
+    return (entry != NULL && (uint32_t)(now_ms - entry->stored_ms) < CONFIG_BLE_SCAN_RSP_CACHE_SECONDS * 1000U);
+}
+
+/** Whether a scan response from `bda` is cached and hasn't expired */
+bool ble_scan_rsp_cached(const uint8_t *bda, uint32_t now_ms) {
+    return rsp_cache_fresh(rsp_cache_find(bda, false), now_ms);
+}
+
+/** Cache the scan response `rsp` received from `bda` */
+void ble_scan_rsp_store(const uint8_t *bda, const uint8_t *rsp, uint8_t rsp_len, uint32_t now_ms) {
+    if (rsp_len > BLE_SCAN_RSP_MAX_LEN) {
+        rsp_len = BLE_SCAN_RSP_MAX_LEN;
+    }
+    ble_scan_rsp_entry *entry = rsp_cache_find(bda, true);
+    memcpy(entry->rsp, rsp, rsp_len);
+    entry->rsp_len = rsp_len;
+    entry->stored_ms = now_ms;
+}
+
+/** Copy the cached scan response for `bda` into `rsp`, which must hold
+ * BLE_SCAN_RSP_MAX_LEN bytes. Returns its length, 0 if there isn't one.
+ */
+uint8_t ble_scan_rsp_get(const uint8_t *bda, uint8_t *rsp, uint32_t now_ms) {
+    ble_scan_rsp_entry *entry = rsp_cache_find(bda, false);
+    if (!rsp_cache_fresh(entry, now_ms)) {
+        return 0;
+    }
+    memcpy(rsp, entry->rsp, entry->rsp_len);
+    return entry->rsp_len;
+}
+
+/** Forget every cached scan response */
+void ble_scan_rsp_reset() {
+    memset(rsp_cache, 0, sizeof(rsp_cache));
+}
@@ -0,0 +1,88 @@
+#ifndef WENDIGO_BLE_SCAN_POLICY_H
+#define WENDIGO_BLE_SCAN_POLICY_H
+
+/** Adaptive BLE scan parameters.
+ * Between scan cycles ble_scan_policy_update() looks at what the last cycle
+ * heard and chooses the scan interval, window and type for the next one:
+ *  * Where advertisements are sparse the window is widened to the whole
+ *    interval, because the radio would otherwise sit idle while there's
+ *    coverage to be had.
+ *  * Where they're dense (CONFIG_BLE_SCAN_DENSE_ADVERTS or more per second of
+ *    listening) and few new devices are turning up, the duty cycle is
+ *    lowered a step at a time to shed callback load. It's raised again as
+ *    soon as new devices are being found at CONFIG_BLE_SCAN_BUSY_NEW_DEVICES
+ *    per minute.
+ *  * An active scan sends a scan request to every scannable advertiser,
+ *    doubling airtime in a busy room, and the controller can't be told to
+ *    skip devices. Instead scan responses are cached per device, and in a
+ *    dense environment scanning is passive unless at least
+ *    CONFIG_BLE_SCAN_UNCACHED_PERCENT of scannable advertisements came from
+ *    devices with no cached response. While passive, ble_gap_cb() appends a
+ *    device's cached response to its advertisements so nothing reported is
+ *    lost. Cached responses expire after CONFIG_BLE_SCAN_RSP_CACHE_SECONDS.
+ * The policy is a pure function of its state and the cycle's counters, and
+ * nothing here needs more of ESP-IDF than esp_bt_defs.h, so it can be
+ * exercised on a host.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sdkconfig.h"
+#include <esp_bt_defs.h>
+
+#ifndef CONFIG_BLE_SCAN_DENSE_ADVERTS
+    #define CONFIG_BLE_SCAN_DENSE_ADVERTS 300
+#endif
+#ifndef CONFIG_BLE_SCAN_BUSY_NEW_DEVICES
+    #define CONFIG_BLE_SCAN_BUSY_NEW_DEVICES 6
+#endif
+#ifndef CONFIG_BLE_SCAN_UNCACHED_PERCENT
+    #define CONFIG_BLE_SCAN_UNCACHED_PERCENT 5
+#endif
+#ifndef CONFIG_BLE_SCAN_RSP_CACHE_ENTRIES
+    #define CONFIG_BLE_SCAN_RSP_CACHE_ENTRIES 64
+#endif
+#ifndef CONFIG_BLE_SCAN_RSP_CACHE_SECONDS
+    #define CONFIG_BLE_SCAN_RSP_CACHE_SECONDS 300
+#endif
+
+/* Longest scan response - ESP_BLE_SCAN_RSP_DATA_LEN_MAX */
+#define BLE_SCAN_RSP_MAX_LEN 31
+/* Number of cache slots examined for a device before one is evicted */
+#define BLE_SCAN_RSP_PROBE_LEN 8
+
+/* Scan interval and window are in units of 0.625ms */
+typedef struct ble_scan_setting {
+    bool active;            /* Send scan requests */
+    uint16_t interval;
+    uint16_t window;
+} ble_scan_setting;
+
+/* What was heard during one scan cycle */
+typedef struct ble_scan_cycle {
+    uint32_t elapsed_ms;
+    uint32_t adverts;       /* Advertisements received, before filtering */
+    uint32_t scannable;     /* Of which were from scannable advertisers */
+    uint32_t uncached;      /* Of which were from devices with no cached scan response */
+    uint32_t new_devices;
+} ble_scan_cycle;
+
+typedef struct ble_scan_policy {
+    bool measured;          /* At least one cycle has been seen */
+    bool active;
+    uint8_t level;          /* Index into the duty cycle steps, 0 being 100% */
+    uint32_t advert_rate;   /* Smoothed advertisements per second of listening */
+    uint32_t new_rate;      /* Smoothed new devices per minute */
+} ble_scan_policy;
+
+void ble_scan_policy_init(ble_scan_policy *policy);
+bool ble_scan_policy_update(ble_scan_policy *policy, const ble_scan_cycle *cycle);
+void ble_scan_policy_setting(const ble_scan_policy *policy, ble_scan_setting *setting);
+uint8_t ble_scan_policy_duty_percent(const ble_scan_policy *policy);
+
+bool ble_scan_rsp_cached(const uint8_t *bda, uint32_t now_ms);
+void ble_scan_rsp_store(const uint8_t *bda, const uint8_t *rsp, uint8_t rsp_len, uint32_t now_ms);
+uint8_t ble_scan_rsp_get(const uint8_t *bda, uint8_t *rsp, uint32_t now_ms);
+void ble_scan_rsp_reset();
+
+#endif
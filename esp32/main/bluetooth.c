@@ -1,20 +1,29 @@
 #include "bluetooth.h"
+#include "ble_filter.h"
+#include "ble_scan_policy.h"
+#include "bt_ad.h"
+#include "radio_sched.h"
 #include "common.h"
 #include "esp_err.h"
+#include "esp_timer.h"
 #include "freertos/idf_additions.h"
 #include "portmacro.h"
-#include "uuids.c"
+#include <stddef.h>
+#include "bt_uuids.h"
+#include "gatt_discovery.h"
+#include "focus.h"
+#include "pipeline.h"
 
-#define REMOTE_SERVICE_UUID     0x00FF
-#define REMOTE_NOTIFY_CHAR_UUID 0xFF01
 #define PROFILE_NUM             1
+/* How often queued GATT discovery is checked for timeouts and free connection slots */
+#define GATT_DISCOVERY_PUMP_MILLIS 500
 
 static void gattc_profile_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t gattc_if, esp_ble_gattc_cb_param_t *param);
 static void ble_gap_cb(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *param);
 static void ble_gattc_cb(esp_gattc_cb_event_t event, esp_gatt_if_t gattc_if, esp_ble_gattc_cb_param_t *param);
-esp_err_t cod2deviceStr(uint32_t cod, char *string, uint8_t *stringLen);
-esp_err_t cod2shortStr(uint32_t cod, char *string, uint8_t *stringLen);
-static bool get_string_name_from_eir(uint8_t *eir, char *bdname, uint8_t *bdname_len);
+static void ble_scan_params_from_policy();
+static void gatt_discovery_timer_cb(void *arg);
+const bt_uuid *svcForUUID(uint16_t uuid);
 
 enum bt_device_parameters {
     BT_PARAM_COD = 0,
@@ -24,24 +33,52 @@ enum bt_device_parameters {
     BT_PARAM_COUNT
 };
 
+/* An advertisement that got past the filter, waiting for ble_report_advert().
+   Only adv_len bytes of adv are copied to the pipeline. */
+typedef struct ble_advert_capture {
+    esp_bd_addr_t bda;
+    int16_t rssi;
+    uint8_t adv_len;
+    uint8_t adv[ESP_BLE_ADV_DATA_LEN_MAX + ESP_BLE_SCAN_RSP_DATA_LEN_MAX];
+} ble_advert_capture;
+
+/* A BLE device name, copied out of a GAP event for the pipeline */
+typedef struct ble_name_capture {
+    esp_bd_addr_t bda;
+    char name[ESP_BT_GAP_MAX_BDNAME_LEN + 1];
+} ble_name_capture;
+
 static esp_ble_scan_params_t ble_scan_params = {
     .scan_type          = BLE_SCAN_TYPE_ACTIVE,
     .own_addr_type      = BLE_ADDR_TYPE_PUBLIC,
     .scan_filter_policy = BLE_SCAN_FILTER_ALLOW_ALL,
     .scan_interval      = 0x50,
     .scan_window        = 0x30,
+#if defined(CONFIG_BLE_SCAN_DUPLICATE_FILTER)
+    .scan_duplicate     = BLE_SCAN_DUPLICATE_ENABLE
+#else
     .scan_duplicate     = BLE_SCAN_DUPLICATE_DISABLE
+#endif
 };
 
+/* Scan interval, window and type are adapted between scan cycles - See ble_scan_policy.h */
+static ble_scan_policy scan_policy;
+static ble_scan_cycle scan_cycle;
+static uint32_t scan_cycle_start_ms = 0;
+static uint32_t scan_cycle_found = 0;   /* Radio scheduler's BLE device count when the cycle started */
+static bool scan_cycle_running = false;
+/* Duration of the scan to start once new scan parameters have been set */
+static uint32_t ble_scan_pending_seconds = CONFIG_BLE_SCAN_SECONDS;
+
+#if defined(CONFIG_BLE_SCAN_DUPLICATE_FILTER)
+/* When the controller's duplicate list was last flushed */
+static uint32_t ble_dupl_flushed_ms = 0;
+#endif
+
 struct gattc_profile_inst {
     esp_gattc_cb_t gattc_cb;
     uint16_t gattc_if;
     uint16_t app_id;
-    uint16_t conn_id;
-    uint16_t service_start_handle;
-    uint16_t service_end_handle;
-    uint16_t char_handle;
-    esp_bd_addr_t remote_bda;
 };
 
 /** One gatt-based profile, one app_id and one gattc_if. This array will store the
@@ -54,25 +91,10 @@ static struct gattc_profile_inst gl_profile_tab[1] = {
     },
 };
 
-/** Bluetooth attributes used by gattc_profile_event_handler */
-static esp_bt_uuid_t remote_filter_service_uuid = {
-    .len    = ESP_UUID_LEN_16,
-    .uuid   = { .uuid16 = 0x00FF, },
-};
-
-static esp_bt_uuid_t remote_filter_char_uuid = {
-    .len    = ESP_UUID_LEN_16,
-    .uuid   = { .uuid16 = 0xFF01, },
-};
-
-static esp_bt_uuid_t notify_descr_uuid = {
-    .len    = ESP_UUID_LEN_16,
-    .uuid   = { .uuid16 = ESP_GATT_UUID_CHAR_CLIENT_CONFIG, },
-};
-static bool connect     = false;
-static bool get_server  = false;
-static esp_gattc_char_elem_t *char_elem_result      = NULL;
-static esp_gattc_descr_elem_t *descr_elem_result    = NULL;
+/* Queued GATT service discovery - See gatt_discovery.h. The queue is used from
+   the GATTC callback, the discovery timer and the console, so hold gattMutex */
+static SemaphoreHandle_t gattMutex = NULL;
+static esp_timer_handle_t gattTimer = NULL;
 
 bool BT_INITIALISED = false;
 bool BLE_INITIALISED = false;
@@ -84,9 +106,9 @@ esp_err_t display_gap_interactive(wendigo_device *dev) {
         (dev->scanType == SCAN_BLE) ? radioShortNames[SCAN_BLE] : "UNK";
     char mac_str[MAC_STRLEN + 1];
     mac_bytes_to_string(dev->mac, mac_str);
-    char cod_str[COD_MAX_LEN];
-    uint8_t cod_str_len = 0;
-    cod2deviceStr(dev->radio.bluetooth.cod, cod_str, &cod_str_len);
+    char cod_str[WENDIGO_COD_MAX_LEN];
+    wendigo_cod_to_str(dev->radio.bluetooth.cod_major, dev->radio.bluetooth.cod_minor, false,
+        cod_str, sizeof(cod_str));
 
     const int banner_width = 62;
     print_star(banner_width, true);
@@ -136,56 +158,29 @@ esp_err_t display_gap_interactive(wendigo_device *dev) {
  */
 esp_err_t display_gap_uart(wendigo_device *dev) {
     esp_err_t result = ESP_OK;
-    char cod_short[SHORT_COD_MAX_LEN];
-    uint8_t cod_len;
-    cod2shortStr(dev->radio.bluetooth.cod, cod_short, &cod_len);
-    /* Account for NULL terminator on cod_short */
-    ++cod_len;
-    /* Send tagged as 1 for true, 0 for false */
-    uint8_t tagged = (dev->tagged) ? 1 : 0;
+    wendigo_pkt_bt pkt = {
+        .bdname_len = dev->radio.bluetooth.bdname_len,
+        .eir_len = dev->radio.bluetooth.eir_len,
+        .rssi = dev->rssi,
+        .cod = dev->radio.bluetooth.cod,
+        .scantype = dev->scanType,
+        /* Send tagged as 1 for true, 0 for false */
+        .tagged = (dev->tagged) ? 1 : 0,
+        /* lastSeen isn't sent */
+        .num_services = dev->radio.bluetooth.bt_services.num_services,
+        .known_services_len = dev->radio.bluetooth.bt_services.known_services_len,
+        .bdname = (uint8_t *)dev->radio.bluetooth.bdname, /* NOTE: No longer null-terminated */
+        .eir = dev->radio.bluetooth.eir,
+    };
+    memcpy(pkt.bda, dev->mac, MAC_BYTES);
 
     /* Assemble the packet and send it in one go */
-    uint8_t packet_len = WENDIGO_OFFSET_BT_BDNAME + dev->radio.bluetooth.bdname_len +
-        dev->radio.bluetooth.eir_len + cod_len + PREAMBLE_LEN;
-    uint8_t *packet = malloc(sizeof(uint8_t *) * packet_len);
+    uint16_t packet_len = wendigo_pkt_bt_size(&pkt);
+    uint8_t *packet = malloc(sizeof(uint8_t) * packet_len);
     if (packet == NULL) {
         return outOfMemory();
     }
-    memcpy(packet, PREAMBLE_BT_BLE, PREAMBLE_LEN);
-    memcpy(packet + WENDIGO_OFFSET_BT_BDNAME_LEN, &(dev->radio.bluetooth.bdname_len), sizeof(uint8_t));
-    memcpy(packet + WENDIGO_OFFSET_BT_EIR_LEN, &(dev->radio.bluetooth.eir_len), sizeof(uint8_t));
-    memcpy(packet + WENDIGO_OFFSET_BT_RSSI, (uint8_t *)&(dev->rssi), sizeof(int16_t));
-    memcpy(packet + WENDIGO_OFFSET_BT_COD, (uint8_t *)&(dev->radio.bluetooth.cod), sizeof(uint32_t));
-    memcpy(packet + WENDIGO_OFFSET_BT_BDA, dev->mac, MAC_BYTES);
-    memcpy(packet + WENDIGO_OFFSET_BT_SCANTYPE, &(dev->scanType), sizeof(uint8_t));
-    memcpy(packet + WENDIGO_OFFSET_BT_TAGGED, &tagged, sizeof(uint8_t));
-    /* Don't bother sending lastSeen */
-    //memcpy(packet + WENDIGO_OFFSET_BT_LASTSEEN, (uint8_t *)&(dev->lastSeen.tv_sec), sizeof(int64_t));
-    memcpy(packet + WENDIGO_OFFSET_BT_NUM_SERVICES,
-        &(dev->radio.bluetooth.bt_services.num_services),
-        sizeof(uint8_t));
-    memcpy(packet + WENDIGO_OFFSET_BT_KNOWN_SERVICES_LEN,
-        &(dev->radio.bluetooth.bt_services.known_services_len),
-        sizeof(uint8_t));
-    memcpy(packet + WENDIGO_OFFSET_BT_COD_LEN, &cod_len, sizeof(uint8_t));
-
-    /* bdname */
-    if (dev->radio.bluetooth.bdname_len > 0) {
-        memcpy(packet + WENDIGO_OFFSET_BT_BDNAME, (uint8_t *)(dev->radio.bluetooth.bdname),
-            dev->radio.bluetooth.bdname_len); /* NOTE: No longer null-terminated */
-    }
-    /* EIR */
-    if (dev->radio.bluetooth.eir_len > 0) {
-        memcpy(packet + WENDIGO_OFFSET_BT_BDNAME + dev->radio.bluetooth.bdname_len,
-            dev->radio.bluetooth.eir, dev->radio.bluetooth.eir_len);
-    }
-    if (cod_len > 0) {
-        memcpy(packet + WENDIGO_OFFSET_BT_BDNAME + dev->radio.bluetooth.bdname_len +
-            dev->radio.bluetooth.eir_len, (uint8_t *)cod_short, cod_len); /* NOTE: No longer null-terminated */
-    }
-    /* Add packet terminator */
-    memcpy(packet + WENDIGO_OFFSET_BT_BDNAME + dev->radio.bluetooth.bdname_len +
-        dev->radio.bluetooth.eir_len + cod_len, PACKET_TERM, PREAMBLE_LEN);
+    wendigo_pkt_bt_encode(&pkt, packet, packet_len);
     /* Send the packet */
     if (xSemaphoreTake(uartMutex, portMAX_DELAY)) {
         send_bytes(packet, packet_len);
@@ -252,6 +247,8 @@ esp_err_t wendigo_ble_initialise() {
     // TODO: This needs to be tested extensively - Bluetooth functions have been created on the assumption
     //       that both BT Classic and BLE are enabled. Test different combinations of BT/BLE support
     if (!BLE_INITIALISED) {
+        ble_scan_policy_init(&scan_policy);
+        ble_scan_params_from_policy();
         step = esp_ble_gap_register_callback(ble_gap_cb);
         if (step != ESP_OK && scanStatus[SCAN_INTERACTIVE] == ACTION_ENABLE) {
             ESP_LOGE(BLE_TAG, "Error registering BLE GAP callback: %s", esp_err_to_name(step));
@@ -275,29 +272,221 @@ esp_err_t wendigo_ble_initialise() {
             ESP_LOGE(BLE_TAG, "Error setting BLE MTU: %s", esp_err_to_name(step));
         }
         result |= step;
+
+        if (gattMutex == NULL) {
+            gattMutex = xSemaphoreCreateMutex();
+            if (gattMutex == NULL) {
+                result |= outOfMemory();
+            }
+        }
+        if (gattTimer == NULL) {
+            const esp_timer_create_args_t gatt_timer_args = {
+                .callback = gatt_discovery_timer_cb,
+                .name = "gatt_discovery",
+            };
+            step = esp_timer_create(&gatt_timer_args, &gattTimer);
+            if (step != ESP_OK && scanStatus[SCAN_INTERACTIVE] == ACTION_ENABLE) {
+                ESP_LOGE(BLE_TAG, "Error creating GATT discovery timer: %s", esp_err_to_name(step));
+            }
+            result |= step;
+        }
         BLE_INITIALISED = true;
     }
     return result;
 }
 
+/** When the controller's duplicate filter is enabled it reports each device
+ * once until its duplicate list is cleared, so flush the list every
+ * CONFIG_BLE_DUPLICATE_FLUSH_SECONDS to keep RSSI and payload updates coming.
+ */
+static void ble_duplicate_list_flush_check() {
+#if defined(CONFIG_BLE_SCAN_DUPLICATE_FILTER)
+    uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    if ((uint32_t)(now_ms - ble_dupl_flushed_ms) >= CONFIG_BLE_DUPLICATE_FLUSH_SECONDS * 1000) {
+        esp_err_t err = esp_ble_scan_dupilcate_list_flush();
+        if (err != ESP_OK) {
+            ESP_LOGW(BLE_TAG, "Failed to flush BLE duplicate list: %s", esp_err_to_name(err));
+        }
+        ble_dupl_flushed_ms = now_ms;
+    }
+#endif
+}
+
+/** Copy the scan interval, window and type chosen by scan_policy into ble_scan_params */
+static void ble_scan_params_from_policy() {
+    ble_scan_setting setting;
+    ble_scan_policy_setting(&scan_policy, &setting);
+    ble_scan_params.scan_type = (setting.active) ? BLE_SCAN_TYPE_ACTIVE : BLE_SCAN_TYPE_PASSIVE;
+    ble_scan_params.scan_interval = setting.interval;
+    ble_scan_params.scan_window = setting.window;
+}
+
+/** Add the time since scanning started to the current scan cycle */
+static void ble_scan_cycle_pause() {
+    if (scan_cycle_running) {
+        scan_cycle.elapsed_ms += (uint32_t)(esp_timer_get_time() / 1000) - scan_cycle_start_ms;
+        scan_cycle_running = false;
+    }
+}
+
+/** Start a BLE scan of `duration` seconds, first letting scan_policy adapt
+ *  the scan parameters to what the last cycle heard. If they change the
+ *  controller needs them before scanning can start, so the scan is started
+ *  by ble_gap_cb() when they have been set.
+ */
+static esp_err_t ble_scan_start(uint32_t duration) {
+    ble_duplicate_list_flush_check();
+#if defined(CONFIG_BLE_SCAN_ADAPTIVE)
+    radio_sched_stats stats;
+    radio_sched_get_stats(RADIO_SCHED_BLE, &stats);
+    ble_scan_cycle_pause();
+    scan_cycle.new_devices = stats.found - scan_cycle_found;
+    bool changed = ble_scan_policy_update(&scan_policy, &scan_cycle);
+    memset(&scan_cycle, 0, sizeof(ble_scan_cycle));
+    scan_cycle_found = stats.found;
+    if (changed) {
+        ble_scan_params_from_policy();
+        ble_scan_pending_seconds = duration;
+        ESP_LOGI(BLE_TAG, "BLE scan now %s, %u%% duty cycle", (ble_scan_params.scan_type == BLE_SCAN_TYPE_ACTIVE) ? "active" : "passive",
+                 ble_scan_policy_duty_percent(&scan_policy));
+        return esp_ble_gap_set_scan_params(&ble_scan_params);
+    }
+#endif
+    return esp_ble_gap_start_scanning(duration);
+}
+
+/** Count an advertisement towards the current scan cycle and return the
+ *  length of its payload - The advertisement followed by its scan response.
+ *  Scan responses are cached, and when a scannable device's advertisement
+ *  arrives without one (because scanning is passive) the cached response
+ *  is appended to the advertisement in `rst`.
+ */
+static uint8_t ble_scan_result_payload(struct ble_scan_result_evt_param *rst, uint32_t now_ms) {
+    bool scannable = (rst->ble_evt_type == ESP_BLE_EVT_CONN_ADV || rst->ble_evt_type == ESP_BLE_EVT_DISC_ADV);
+    ++scan_cycle.adverts;
+    if (scannable) {
+        ++scan_cycle.scannable;
+    }
+    if (rst->scan_rsp_len > 0) {
+        ble_scan_rsp_store(rst->bda, rst->ble_adv + rst->adv_data_len, rst->scan_rsp_len, now_ms);
+    } else if (scannable) {
+        uint8_t rsp_len = 0;
+        if (rst->adv_data_len <= ESP_BLE_ADV_DATA_LEN_MAX) {
+            rsp_len = ble_scan_rsp_get(rst->bda, rst->ble_adv + rst->adv_data_len, now_ms);
+        }
+        if (rsp_len == 0) {
+            ++scan_cycle.uncached;
+        }
+        return rst->adv_data_len + rsp_len;
+    }
+    return rst->adv_data_len + rst->scan_rsp_len;
+}
+
+/** The BLE scan policy, for the status command */
+const ble_scan_policy *wendigo_ble_scan_policy() {
+    return &scan_policy;
+}
+
+/** Point `svc` at the service UUIDs in `ad`, filling `known` (which must hold
+ *  BT_AD_MAX_UUIDS elements) with those we have names for.
+ *  `svc` borrows `ad`'s and `known`'s storage - add_device() takes copies.
+ */
+static void bt_services_from_ad(bt_ad_data *ad, const bt_uuid **known, wendigo_bt_svc *svc) {
+    svc->num_services = ad->uuid_count;
+    svc->service_uuids = (ad->uuid_count > 0) ? ad->uuids : NULL;
+    svc->known_services_len = 0;
+    for (uint8_t i = 0; i < ad->uuid_count; ++i) {
+        if (ad->uuids[i].len == ESP_UUID_LEN_16) {
+            const bt_uuid *svc_uuid = svcForUUID(ad->uuids[i].uuid.uuid16);
+            if (svc_uuid != NULL) {
+                known[svc->known_services_len++] = svc_uuid;
+            }
+        }
+    }
+    svc->known_services = (svc->known_services_len > 0) ? known : NULL;
+}
+
+/** Parse an advertisement captured by ble_gap_cb() and add its device to
+ *  the cache. Runs on the pipeline task on dual-core chips, otherwise in
+ *  the callback.
+ */
+static void ble_report_advert(void *data) {
+    ble_advert_capture *capture = (ble_advert_capture *)data;
+    bt_ad_data ad;
+    const bt_uuid *known_services[BT_AD_MAX_UUIDS];
+    char adv_name[ESP_BLE_ADV_DATA_LEN_MAX + ESP_BLE_SCAN_RSP_DATA_LEN_MAX + 1];
+    wendigo_device dev;
+    memset(&dev, 0, sizeof(wendigo_device));
+    dev.radio.bluetooth.cod_major = WENDIGO_COD_MAJOR_MISC;
+    wendigo_focus_sample(capture->bda, capture->rssi, 0);
+    /* Get device info */
+    memcpy(dev.mac, capture->bda, sizeof(esp_bd_addr_t));
+    dev.rssi = capture->rssi;
+    dev.scanType = SCAN_BLE;
+    /* One pass over the AD structures for name and services. `dev` borrows
+       its name, EIR and services from the stack and the capture, and add_device()
+       takes copies, so there is nothing to allocate or free here. */
+    bt_ad_parse(capture->adv, capture->adv_len, &ad);
+    if (ad.name_len > 0) {
+        memcpy(adv_name, ad.name, ad.name_len);
+        adv_name[ad.name_len] = '\0';
+        dev.radio.bluetooth.bdname = adv_name;
+        dev.radio.bluetooth.bdname_len = ad.name_len;
+    }
+    if (capture->adv_len > 0) {
+        dev.radio.bluetooth.eir = capture->adv;
+        dev.radio.bluetooth.eir_len = capture->adv_len;
+    }
+    /* Services found by GATT discovery are complete; the advertisement's may not be.
+       Don't wait for gattMutex - its holders submit to the pipeline, which on a
+       single-core chip means waiting for this handler. The device's next
+       advertisement will pick the services up */
+    if (gattMutex != NULL && xSemaphoreTake(gattMutex, 0)) {
+        const gatt_discovery_result *gatt = gatt_discovery_cached(dev.mac);
+        if (gatt != NULL && gatt->result == WENDIGO_GATT_COMPLETE && gatt->svc_count > 0) {
+            ad.uuid_count = (gatt->svc_count > BT_AD_MAX_UUIDS) ? BT_AD_MAX_UUIDS : gatt->svc_count;
+            memcpy(ad.uuids, gatt->uuids, sizeof(esp_bt_uuid_t) * ad.uuid_count);
+        }
+        xSemaphoreGive(gattMutex);
+    }
+    bt_services_from_ad(&ad, known_services, &(dev.radio.bluetooth.bt_services));
+    // TODO: Can I find the COD (Class Of Device) anywhere?
+    display_gap_device(&dev);
+    /* Add to or update devices[] */
+    add_device(&dev);
+}
+
+/** Add a device name captured by ble_gap_cb() to the cache. Runs on the
+ *  pipeline task on dual-core chips, otherwise in the callback.
+ */
+static void ble_report_name(void *data) {
+    ble_name_capture *capture = (ble_name_capture *)data;
+    wendigo_device dev;
+    memset(&dev, 0, sizeof(wendigo_device));
+    memcpy(dev.mac, capture->bda, sizeof(esp_bd_addr_t));
+    dev.scanType = SCAN_BLE;
+    dev.radio.bluetooth.cod_major = WENDIGO_COD_MAJOR_MISC;
+    /* `dev` borrows the capture's name - add_device() takes a copy */
+    dev.radio.bluetooth.bdname = capture->name;
+    dev.radio.bluetooth.bdname_len = strlen(capture->name);
+    // TODO: Can I get anything else out of these structs?
+    display_gap_device(&dev);
+    /* Add to or update devices[] */
+    add_device(&dev);
+}
+
 /** Bluetooth Low Energy scanning callback - Called when a BLE device is seen */
 static void ble_gap_cb(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *param) {
-    uint8_t *adv_name = NULL;
-    uint8_t adv_name_len = 0;
     char bdaStr[MAC_STRLEN + 1];
-    wendigo_device dev;
-    /* I'm pretty sure these will be initialised because it's on the stack,
-       but the consequences of being wrong are too annoying */
-    dev.radio.bluetooth.bdname_len = 0;
-    dev.radio.bluetooth.eir_len = 0;
-    dev.radio.bluetooth.cod = 0;
-    dev.radio.bluetooth.bdname = NULL;
-    dev.radio.bluetooth.eir = NULL;
-    dev.scanType = SCAN_BLE;
-    dev.tagged = false;
+    ble_advert_capture capture;
+    uint8_t adv_len = 0;
+    uint32_t now_ms = 0;
     switch (event) {
         case ESP_GAP_BLE_SCAN_PARAM_SET_COMPLETE_EVT:
-            esp_ble_gap_start_scanning(CONFIG_BLE_SCAN_SECONDS);
+            /* The scheduler may have given BLE its slice before the parameters were set */
+            if (radio_sched_is_active(RADIO_SCHED_BLE)) {
+                esp_ble_gap_start_scanning(ble_scan_pending_seconds);
+            }
             break;
         case ESP_GAP_BLE_SCAN_START_COMPLETE_EVT:
             /* This event indicates the end of "scan start" - Did the scan start successfully? */
@@ -305,6 +494,8 @@ static void ble_gap_cb(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *par
                 ESP_LOGE(BLE_TAG, "BLE scan start failed: %s", esp_err_to_name(param->scan_start_cmpl.status));
             } else {
                 ESP_LOGI(BLE_TAG, "BLE scan started successfully");
+                scan_cycle_start_ms = (uint32_t)(esp_timer_get_time() / 1000);
+                scan_cycle_running = true;
             }
             break;
         case ESP_GAP_BLE_SCAN_STOP_COMPLETE_EVT:
@@ -333,19 +524,11 @@ static void ble_gap_cb(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *par
                 mac_bytes_to_string(param->scan_rst.bda, bdaStr); //TODO: Confirm param->scan_rst.bda exists
                 ESP_LOGI(BLE_TAG, "Got a complete BLE device name for %s: %s. Status %d",
                          bdaStr, param->get_dev_name_cmpl.name, param->get_dev_name_cmpl.status);
-                memcpy(dev.mac, param->scan_rst.bda, sizeof(esp_bd_addr_t));
-                dev.radio.bluetooth.bdname = (char *)malloc(sizeof(char) * (strlen(param->get_dev_name_cmpl.name) + 1));
-                if (dev.radio.bluetooth.bdname == NULL) {
-                    outOfMemory();
-                    break;
-                }
-                strncpy(dev.radio.bluetooth.bdname, param->get_dev_name_cmpl.name, strlen(param->get_dev_name_cmpl.name));
-                dev.radio.bluetooth.bdname[strlen(param->get_dev_name_cmpl.name)] = '\0';
-                // TODO: Can I get anything else out of these structs?
-                display_gap_device(&dev);
-                /* Add to or update devices[] */
-                add_device(&dev);
-                free_device(&dev);
+                ble_name_capture name_capture;
+                memcpy(name_capture.bda, param->scan_rst.bda, sizeof(esp_bd_addr_t));
+                strncpy(name_capture.name, param->get_dev_name_cmpl.name, ESP_BT_GAP_MAX_BDNAME_LEN);
+                name_capture.name[ESP_BT_GAP_MAX_BDNAME_LEN] = '\0';
+                wendigo_pipeline_submit(ble_report_name, &name_capture, sizeof(ble_name_capture));
                 break;
         case ESP_GAP_BLE_SCAN_RESULT_EVT:
             esp_ble_gap_cb_param_t *scan_result = (esp_ble_gap_cb_param_t *)param;
@@ -357,43 +540,38 @@ static void ble_gap_cb(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *par
                     ESP_LOGI(BLE_TAG, "Discovery BLE result");
                     break;
                 case ESP_GAP_SEARCH_INQ_CMPL_EVT:
-                    /* Restart the BLE scanner if it hasn't been disabled */
-                    if (scanStatus[SCAN_BLE] == ACTION_ENABLE) {
-                        esp_ble_gap_start_scanning(CONFIG_BLE_SCAN_SECONDS);
+                    /* Restart the BLE scanner if it's still BLE's slice */
+                    ble_scan_cycle_pause();
+                    if (radio_sched_is_active(RADIO_SCHED_BLE)) {
+                        ble_scan_start(CONFIG_BLE_SCAN_SECONDS);
                     }
                     break;
                 case ESP_GAP_SEARCH_INQ_RES_EVT:
-                    /* Get device info */
-                    memcpy(dev.mac, scan_result->scan_rst.bda, sizeof(esp_bd_addr_t));
-                    dev.rssi = (int16_t)scan_result->scan_rst.rssi;
-                    dev.scanType = SCAN_BLE;
-                    /* Name */
-                    adv_name = esp_ble_resolve_adv_data(scan_result->scan_rst.ble_adv,
-                                                        ESP_BLE_AD_TYPE_NAME_CMPL, &adv_name_len);
-                    dev.radio.bluetooth.bdname = malloc(sizeof(char) * (adv_name_len + 1));
-                    if (dev.radio.bluetooth.bdname == NULL) {
-                        outOfMemory();
-                        return; // YAGNI: Do something more sophisticated
+                    ble_duplicate_list_flush_check();
+                    now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+                    /* Advertising data and scan response are stored back to back */
+                    adv_len = ble_scan_result_payload(&(scan_result->scan_rst), now_ms);
+                    /* Queued GATT discovery needs the address type, and to know the device accepts connections */
+                    if (gattMutex != NULL && xSemaphoreTake(gattMutex, portMAX_DELAY)) {
+                        gatt_discovery_advert(scan_result->scan_rst.bda, scan_result->scan_rst.ble_addr_type,
+                            (scan_result->scan_rst.ble_evt_type == ESP_BLE_EVT_CONN_ADV ||
+                             scan_result->scan_rst.ble_evt_type == ESP_BLE_EVT_CONN_DIR_ADV));
+                        xSemaphoreGive(gattMutex);
                     }
-                    memcpy(dev.radio.bluetooth.bdname, adv_name, adv_name_len);
-                    dev.radio.bluetooth.bdname[adv_name_len] = '\0';
-                    dev.radio.bluetooth.bdname_len = adv_name_len;
-                    /* Get EIR if provided */
-                    if (scan_result->scan_rst.adv_data_len > 0) {
-                        dev.radio.bluetooth.eir = malloc(sizeof(uint8_t) * scan_result->scan_rst.adv_data_len);
-                        if (dev.radio.bluetooth.eir == NULL) {
-                            outOfMemory();
-                            return;
-                        }
-                        memcpy(dev.radio.bluetooth.eir, scan_result->scan_rst.ble_adv, scan_result->scan_rst.adv_data_len);
-                        dev.radio.bluetooth.eir_len = scan_result->scan_rst.adv_data_len;
+                    /* Drop advertisements that tell us nothing new before doing anything else */
+                    if (!ble_filter_should_report(scan_result->scan_rst.bda, scan_result->scan_rst.ble_adv,
+                            adv_len, scan_result->scan_rst.rssi, now_ms)) {
+                        /* Focus Mode wants every reading, including those the filter drops */
+                        wendigo_focus_submit(scan_result->scan_rst.bda, (int16_t)scan_result->scan_rst.rssi, 0);
+                        break;
                     }
-                    // TODO: Can I find the COD (Class Of Device) anywhere?
-                    mac_bytes_to_string(dev.mac, bdaStr);
-                    display_gap_device(&dev);
-                    /* Add to or update devices[] */
-                    add_device(&dev);
-                    free_device(&dev);
+                    /* Parsing and reporting happen on the pipeline task */
+                    memcpy(capture.bda, scan_result->scan_rst.bda, sizeof(esp_bd_addr_t));
+                    capture.rssi = (int16_t)scan_result->scan_rst.rssi;
+                    capture.adv_len = adv_len;
+                    memcpy(capture.adv, scan_result->scan_rst.ble_adv, adv_len);
+                    wendigo_pipeline_submit(ble_report_advert, &capture,
+                        offsetof(ble_advert_capture, adv) + adv_len);
                     break;
                 default:
                     break;
@@ -430,9 +608,204 @@ static void ble_gattc_cb(esp_gattc_cb_event_t event, esp_gatt_if_t gattc_if, esp
     } while (0);
 }
 
-/** GATTC profile event handler. Called by the above via gl_profile_tab's elements */
+/** Point `svc` at the discovered services in `result`, filling `known`
+ *  (which must hold GATT_DISCOVERY_MAX_SERVICES elements) with those we have
+ *  names for. Like bt_services_from_ad(), `svc` borrows its storage.
+ */
+static void bt_services_from_gatt(const gatt_discovery_result *result, const bt_uuid **known, wendigo_bt_svc *svc) {
+    svc->num_services = result->svc_count;
+    svc->service_uuids = (result->svc_count > 0) ? (esp_bt_uuid_t *)result->uuids : NULL;
+    svc->known_services_len = 0;
+    for (uint8_t i = 0; i < result->svc_count; ++i) {
+        if (result->uuids[i].len == ESP_UUID_LEN_16) {
+            const bt_uuid *svc_uuid = svcForUUID(result->uuids[i].uuid.uuid16);
+            if (svc_uuid != NULL) {
+                known[svc->known_services_len++] = svc_uuid;
+            }
+        }
+    }
+    svc->known_services = (svc->known_services_len > 0) ? known : NULL;
+}
+
+static esp_err_t display_gatt_services_interactive(const gatt_discovery_result *result) {
+    char mac_str[MAC_STRLEN + 1];
+    mac_bytes_to_string((uint8_t *)result->bda, mac_str);
+    ESP_LOGI(BLE_TAG, "GATT discovery of %s: %s, %u service%s%s", mac_str, wendigo_gatt_result_str(result->result),
+             result->svc_count, (result->svc_count == 1) ? "" : "s", (result->truncated) ? " (truncated)" : "");
+    for (uint8_t i = 0; i < result->svc_count; ++i) {
+        const esp_bt_uuid_t *uuid = &(result->uuids[i]);
+        if (uuid->len == ESP_UUID_LEN_16) {
+            const bt_uuid *svc_uuid = svcForUUID(uuid->uuid.uuid16);
+            ESP_LOGI(BLE_TAG, "    0x%04X %s", uuid->uuid.uuid16, (svc_uuid == NULL) ? "" : svc_uuid->name);
+        } else if (uuid->len == ESP_UUID_LEN_32) {
+            ESP_LOGI(BLE_TAG, "    0x%08lX", (unsigned long)uuid->uuid.uuid32);
+        } else {
+            /* 128-bit UUIDs are stored little-endian */
+            char uuid_str[ESP_UUID_LEN_128 * 2 + 1];
+            for (uint8_t b = 0; b < ESP_UUID_LEN_128; ++b) {
+                snprintf(uuid_str + (b * 2), 3, "%02X", uuid->uuid.uuid128[ESP_UUID_LEN_128 - 1 - b]);
+            }
+            ESP_LOGI(BLE_TAG, "    %s", uuid_str);
+        }
+    }
+    return ESP_OK;
+}
+
+/** Send `result` to Flipper as a bt_services packet */
+static esp_err_t display_gatt_services_uart(const gatt_discovery_result *result) {
+    esp_err_t err = ESP_OK;
+    uint8_t uuids[GATT_DISCOVERY_MAX_SERVICES * (1 + ESP_UUID_LEN_128)];
+    wendigo_pkt_bt_services pkt = {
+        .result = result->result,
+        .svc_count = result->svc_count,
+        .uuids = uuids,
+    };
+    memcpy(pkt.bda, result->bda, MAC_BYTES);
+    pkt.uuids_len = wendigo_svc_uuids_pack(result->uuids, result->svc_count, uuids, sizeof(uuids));
+
+    uint16_t packet_len = wendigo_pkt_bt_services_size(&pkt);
+    uint8_t *packet = malloc(sizeof(uint8_t) * packet_len);
+    if (packet == NULL) {
+        return outOfMemory();
+    }
+    wendigo_pkt_bt_services_encode(&pkt, packet, packet_len);
+    if (xSemaphoreTake(uartMutex, portMAX_DELAY)) {
+        send_bytes(packet, packet_len);
+        xSemaphoreGive(uartMutex);
+    } else {
+        err = ESP_ERR_INVALID_STATE;
+    }
+    free(packet);
+    return err;
+}
+
+/** Report the end of a device's GATT discovery and, if it succeeded, replace
+ *  the services held for the device with those discovered. Runs on the
+ *  pipeline task on dual-core chips, otherwise in the caller of
+ *  display_gatt_services().
+ */
+static void gatt_report_result(void *data) {
+    const gatt_discovery_result *result = (const gatt_discovery_result *)data;
+    wendigo_device *existing = retrieve_by_mac((uint8_t *)result->bda);
+    if (result->result == WENDIGO_GATT_COMPLETE && result->svc_count > 0 && existing != NULL) {
+        const bt_uuid *known_services[GATT_DISCOVERY_MAX_SERVICES];
+        wendigo_device dev;
+        memset(&dev, 0, sizeof(wendigo_device));
+        memcpy(dev.mac, result->bda, MAC_BYTES);
+        dev.rssi = existing->rssi;
+        dev.scanType = SCAN_BLE;
+        dev.radio.bluetooth.cod_major = WENDIGO_COD_MAJOR_MISC;
+        bt_services_from_gatt(result, known_services, &(dev.radio.bluetooth.bt_services));
+        add_device(&dev);
+    }
+    if (scanStatus[SCAN_INTERACTIVE] == ACTION_ENABLE) {
+        display_gatt_services_interactive(result);
+    } else {
+        display_gatt_services_uart(result);
+    }
+}
+
+/** Hand a copy of `result` to the pipeline to be reported. `result` lives in
+ *  the discovery cache, which only holds still while gattMutex is held, and
+ *  callers are on the GATTC, esp_timer and console tasks - none of which
+ *  should write to the device cache or wait for the UART.
+ */
+static esp_err_t display_gatt_services(const gatt_discovery_result *result) {
+    if (result == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    wendigo_pipeline_submit(gatt_report_result, result, sizeof(gatt_discovery_result));
+    return ESP_OK;
+}
+
+/** Abandon discoveries that have timed out, then open connections to queued
+ *  devices while there are free connection slots. Hold gattMutex.
+ */
+static void gatt_discovery_pump(uint32_t now_ms) {
+    gatt_discovery_job expired;
+    const gatt_discovery_result *result;
+    while ((result = gatt_discovery_expire(now_ms, &expired)) != NULL) {
+        if (expired.state == GATT_JOB_DISCOVERING) {
+            esp_ble_gattc_close(gl_profile_tab[0].gattc_if, expired.conn_id);
+        } else if (expired.state == GATT_JOB_CONNECTING) {
+            /* Cancels the pending connection */
+            esp_ble_gap_disconnect(expired.bda);
+        }
+        display_gatt_services(result);
+    }
+    esp_bd_addr_t bda;
+    uint8_t addr_type;
+    while (gatt_discovery_next(now_ms, bda, &addr_type)) {
+        esp_err_t err = esp_ble_gattc_open(gl_profile_tab[0].gattc_if, bda, (esp_ble_addr_type_t)addr_type, true);
+        if (err != ESP_OK) {
+            ESP_LOGW(BLE_TAG, "Failed to open GATT connection: %s", esp_err_to_name(err));
+            display_gatt_services(gatt_discovery_finish(bda, WENDIGO_GATT_FAILED, now_ms));
+        }
+    }
+}
+
+/** Pump the discovery queue. Runs on the esp_timer task, so rather than wait
+ *  for gattMutex it leaves the pump to the next tick - or to the GATTC event
+ *  that's holding it, which pumps as well.
+ */
+static void gatt_discovery_timer_cb(void *arg) {
+    if (xSemaphoreTake(gattMutex, 0)) {
+        gatt_discovery_pump((uint32_t)(esp_timer_get_time() / 1000));
+        if (!gatt_discovery_busy()) {
+            esp_timer_stop(gattTimer);
+        }
+        xSemaphoreGive(gattMutex);
+    }
+}
+
+/** Queue `bda` for GATT service discovery. If its services have already been
+ *  discovered the cached result is reported again instead.
+ */
+esp_err_t wendigo_gatt_discover(esp_bd_addr_t bda) {
+    if (!BLE_INITIALISED || gattMutex == NULL || gl_profile_tab[0].gattc_if == ESP_GATT_IF_NONE) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    esp_err_t result = ESP_OK;
+    if (!xSemaphoreTake(gattMutex, portMAX_DELAY)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    switch (gatt_discovery_request(bda, (uint32_t)(esp_timer_get_time() / 1000))) {
+        case GATT_REQUEST_CACHED:
+            result = display_gatt_services(gatt_discovery_cached(bda));
+            break;
+        case GATT_REQUEST_QUEUED:
+            if (!esp_timer_is_active(gattTimer)) {
+                result = esp_timer_start_periodic(gattTimer, GATT_DISCOVERY_PUMP_MILLIS * 1000);
+            }
+            break;
+        case GATT_REQUEST_PENDING:
+            break;
+        case GATT_REQUEST_FULL:
+        default:
+            result = ESP_ERR_NO_MEM;
+            break;
+    }
+    xSemaphoreGive(gattMutex);
+    return result;
+}
+
+/** GATT discovery queue and cache counters, for the status command */
+void wendigo_gatt_discovery_stats(gatt_discovery_stats *stats) {
+    memset(stats, 0, sizeof(gatt_discovery_stats));
+    if (gattMutex != NULL && xSemaphoreTake(gattMutex, portMAX_DELAY)) {
+        gatt_discovery_get_stats(stats);
+        xSemaphoreGive(gattMutex);
+    }
+}
+
+/** GATTC profile event handler. Called by the above via gl_profile_tab's elements.
+ *  Its only job is queued service discovery: On connecting it searches for all
+ *  primary services, records them as they're found, and disconnects once the
+ *  search is complete.
+ */
 static void gattc_profile_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_t gattc_if, esp_ble_gattc_cb_param_t *param) {
-    esp_ble_gattc_cb_param_t *p_data = (esp_ble_gattc_cb_param_t *)param;
+    uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    esp_bd_addr_t bda;
 
     switch (event) {
         case ESP_GATTC_REG_EVT:
@@ -442,225 +815,79 @@ static void gattc_profile_event_handler(esp_gattc_cb_event_t event, esp_gatt_if_
                 ESP_LOGE(BLE_TAG, "Set scan params error: %s", esp_err_to_name(scan_ret));
             }
             break;
-        case ESP_GATTC_CONNECT_EVT:
-            ESP_LOGI(BLE_TAG, "ESP_GATTC_CONNECT_EVT conn_id %d, if %d", p_data->connect.conn_id, gattc_if);
-            gl_profile_tab[0].conn_id = p_data->connect.conn_id;
-            memcpy(gl_profile_tab[0].remote_bda, p_data->connect.remote_bda, sizeof(esp_bd_addr_t));
-            ESP_LOGI(BLE_TAG, "REMOTE BDA:");
-            ESP_LOG_BUFFER_HEX(BLE_TAG, gl_profile_tab[0].remote_bda, sizeof(esp_bd_addr_t));
-            esp_err_t mtu_ret = esp_ble_gattc_send_mtu_req(gattc_if, p_data->connect.conn_id);
-            if (mtu_ret) {
-                ESP_LOGE(BLE_TAG, "Config MTU error: %s", esp_err_to_name(mtu_ret));
-            }
-            break;
         case ESP_GATTC_OPEN_EVT:
-            if (param->open.status != ESP_GATT_OK) {
-                ESP_LOGE(BLE_TAG, "Open failed, status %s", esp_err_to_name(p_data->open.status));
-                break;
-            }
-            ESP_LOGI(BLE_TAG, "Open success");
-            break;
-        case ESP_GATTC_DIS_SRVC_CMPL_EVT:
-            if (param->dis_srvc_cmpl.status != ESP_GATT_OK) {
-                ESP_LOGE(BLE_TAG, "Discover service failed, status: %s", esp_err_to_name(param->dis_srvc_cmpl.status));
+            if (!xSemaphoreTake(gattMutex, portMAX_DELAY)) {
                 break;
             }
-            ESP_LOGI(BLE_TAG, "Discover service complete conn_id %d", param->dis_srvc_cmpl.conn_id);
-            esp_ble_gattc_search_service(gattc_if, param->cfg_mtu.conn_id, &remote_filter_service_uuid);
-            break;
-        case ESP_GATTC_CFG_MTU_EVT:
-            if (param->cfg_mtu.status != ESP_GATT_OK) {
-                ESP_LOGE(BLE_TAG, "Config MTU failed, error: %s", esp_err_to_name(param->cfg_mtu.status));
+            if (param->open.status != ESP_GATT_OK) {
+                ESP_LOGW(BLE_TAG, "GATT open failed, status %d", param->open.status);
+                display_gatt_services(gatt_discovery_finish(param->open.remote_bda, WENDIGO_GATT_FAILED, now_ms));
+            } else if (!gatt_discovery_connected(param->open.remote_bda, param->open.conn_id)) {
+                /* Discovery timed out while the connection was being opened */
+                esp_ble_gattc_close(gattc_if, param->open.conn_id);
+            } else {
+                esp_ble_gattc_search_service(gattc_if, param->open.conn_id, NULL);
             }
-            ESP_LOGI(BLE_TAG, "ESP_GATTC_CFG_MTU_EVT, status %d, MTU %d, conn_id %d",
-                     param->cfg_mtu.status, param->cfg_mtu.mtu, param->cfg_mtu.conn_id);
+            xSemaphoreGive(gattMutex);
             break;
         case ESP_GATTC_SEARCH_RES_EVT:
-            ESP_LOGI(BLE_TAG, "SEARCH RES: conn_id = %x is primary service %d",
-                    p_data->search_res.conn_id, p_data->search_res.is_primary);
-            ESP_LOGI(BLE_TAG, "Start handle %d end handle %d current handle value %d",
-                    p_data->search_res.start_handle, p_data->search_res.end_handle, p_data->search_res.srvc_id.inst_id);
-            if (p_data->search_res.srvc_id.uuid.len == ESP_UUID_LEN_16 && p_data->search_res.srvc_id.uuid.uuid.uuid16 == REMOTE_SERVICE_UUID) {
-                ESP_LOGI(BLE_TAG, "Service found");
-                get_server = true;
-                gl_profile_tab[0].service_start_handle = p_data->search_res.start_handle;
-                gl_profile_tab[0].service_end_handle = p_data->search_res.end_handle;
-                ESP_LOGI(BLE_TAG, "UUID16: %x", p_data->search_res.srvc_id.uuid.uuid.uuid16);
+            if (xSemaphoreTake(gattMutex, portMAX_DELAY)) {
+                gatt_discovery_service(param->search_res.conn_id, &(param->search_res.srvc_id.uuid));
+                xSemaphoreGive(gattMutex);
             }
             break;
         case ESP_GATTC_SEARCH_CMPL_EVT:
-            if (p_data->search_cmpl.status != ESP_GATT_OK) {
-                ESP_LOGE(BLE_TAG, "Search service failed, error: %s", esp_err_to_name(p_data->search_cmpl.status));
+            if (!xSemaphoreTake(gattMutex, portMAX_DELAY)) {
                 break;
             }
-            if (p_data->search_cmpl.searched_service_source == ESP_GATT_SERVICE_FROM_REMOTE_DEVICE) {
-                ESP_LOGI(BLE_TAG, "Get service information from remote device");
-            } else if (p_data->search_cmpl.searched_service_source == ESP_GATT_SERVICE_FROM_NVS_FLASH) {
-                ESP_LOGI(BLE_TAG, "Get service information from flash");
-            } else {
-                ESP_LOGI(BLE_TAG, "Unknown service source");
-            }
-            ESP_LOGI(BLE_TAG, "ESP_GATTC_SEARCH_CMPL_EVT");
-            if (get_server) {
-                uint16_t count = 0;
-                esp_gatt_status_t status = esp_ble_gattc_get_attr_count(gattc_if,
-                                                                        p_data->search_cmpl.conn_id,
-                                                                        ESP_GATT_DB_CHARACTERISTIC,
-                                                                        gl_profile_tab[0].service_start_handle,
-                                                                        gl_profile_tab[0].service_end_handle,
-                                                                        0,
-                                                                        &count);
-                if (status != ESP_GATT_OK) {
-                    ESP_LOGE(BLE_TAG, "esp_ble_gattc_get_attr_count error: %s", esp_err_to_name(status));
-                }
-
-                if (count > 0) {
-                    char_elem_result = (esp_gattc_char_elem_t *)malloc(sizeof(esp_gattc_char_elem_t) * count);
-                    if (!char_elem_result) {
-                        outOfMemory();
-                        ESP_LOGE(BLE_TAG, "gattc no mem");
-                    } else {
-                        status = esp_ble_gattc_get_char_by_uuid(gattc_if,
-                                                                p_data->search_cmpl.conn_id,
-                                                                gl_profile_tab[0].service_start_handle,
-                                                                gl_profile_tab[0].service_end_handle,
-                                                                remote_filter_char_uuid,
-                                                                char_elem_result,
-                                                                &count);
-                        if (status != ESP_GATT_OK) {
-                            ESP_LOGE(BLE_TAG, "esp_ble_gattc_get_char_by_uuid error: %s", esp_err_to_name(status));
-                        }
-
-                        /* This function was based off an esp-idf bluetooth host example project,
-                           I'm unclear on whether there may be more characters available to me - Revisit in future.
-                           *****
-                           Every service have only one char in our 'ESP_GATTS_DEMO' demo, so we used first 'char_elem_result'
-                        */
-                        if (count > 0 && (char_elem_result[0].properties & ESP_GATT_CHAR_PROP_BIT_NOTIFY)) {
-                            gl_profile_tab[0].char_handle = char_elem_result[0].char_handle;
-                            esp_ble_gattc_register_for_notify(gattc_if, gl_profile_tab[0].remote_bda, char_elem_result[0].char_handle);
-                        }
-                    }
-                    free(char_elem_result);
-                } else {
-                    ESP_LOGE(BLE_TAG, "No char found.");
+            if (gatt_discovery_conn_bda(param->search_cmpl.conn_id, bda)) {
+                if (param->search_cmpl.status != ESP_GATT_OK) {
+                    ESP_LOGW(BLE_TAG, "GATT service search failed, status %d", param->search_cmpl.status);
                 }
+                display_gatt_services(gatt_discovery_finish(bda, (param->search_cmpl.status == ESP_GATT_OK) ?
+                    WENDIGO_GATT_COMPLETE : WENDIGO_GATT_FAILED, now_ms));
             }
+            esp_ble_gattc_close(gattc_if, param->search_cmpl.conn_id);
+            /* A connection slot is free */
+            gatt_discovery_pump(now_ms);
+            xSemaphoreGive(gattMutex);
             break;
-        case ESP_GATTC_REG_FOR_NOTIFY_EVT:
-            ESP_LOGI(BLE_TAG, "ESP_GATTC_REG_FOR_NOTIFY_EVT");
-            if (p_data->reg_for_notify.status != ESP_GATT_OK) {
-                ESP_LOGE(BLE_TAG, "REG FOR NOTIFY failed: %s", esp_err_to_name(p_data->reg_for_notify.status));
-            } else {
-                uint16_t count = 0;
-                uint16_t notify_en = 1;
-                esp_gatt_status_t ret_status = esp_ble_gattc_get_attr_count(gattc_if,
-                                                                            gl_profile_tab[0].conn_id,
-                                                                            ESP_GATT_DB_DESCRIPTOR,
-                                                                            gl_profile_tab[0].service_start_handle,
-                                                                            gl_profile_tab[0].service_end_handle,
-                                                                            gl_profile_tab[0].char_handle,
-                                                                            &count);
-                if (ret_status != ESP_GATT_OK) {
-                    ESP_LOGE(BLE_TAG, "esp_ble_gattc_get_attr_count error: %s", esp_err_to_name(ret_status));
-                }
-                if (count > 0) {
-                    descr_elem_result = malloc(sizeof(esp_gattc_descr_elem_t) * count);
-                    if (!descr_elem_result) {
-                        outOfMemory();
-                        ESP_LOGE(BLE_TAG, "gattc no mem");
-                    } else {
-                        ret_status = esp_ble_gattc_get_descr_by_char_handle(gattc_if,
-                                                                            gl_profile_tab[0].conn_id,
-                                                                            p_data->reg_for_notify.handle,
-                                                                            notify_descr_uuid,
-                                                                            descr_elem_result,
-                                                                            &count);
-                        if (ret_status != ESP_GATT_OK) {
-                            ESP_LOGE(BLE_TAG, "esp_ble_gattc_get_descr_by_char_handle error: %s", esp_err_to_name(ret_status));
-                        }
-                        /* As per previous comment about whether I should try to receive more than a single character */
-                        if (count > 0 && descr_elem_result[0].uuid.len == ESP_UUID_LEN_16 && descr_elem_result[0].uuid.uuid.uuid16 == ESP_GATT_UUID_CHAR_CLIENT_CONFIG) {
-                            ret_status = esp_ble_gattc_write_char_descr(gattc_if,
-                                                                        gl_profile_tab[0].conn_id,
-                                                                        descr_elem_result[0].handle,
-                                                                        sizeof(notify_en),
-                                                                        (uint8_t *)&notify_en,
-                                                                        ESP_GATT_WRITE_TYPE_RSP,
-                                                                        ESP_GATT_AUTH_REQ_NONE);
-                            if (ret_status != ESP_GATT_OK) {
-                                ESP_LOGE(BLE_TAG, "esp_ble_gattc_write_char_descr error: %s", esp_err_to_name(ret_status));
-                            }
-                        }
-                        free(descr_elem_result);
-                    }
-                } else {
-                    ESP_LOGE(BLE_TAG, "descr not found");
+        case ESP_GATTC_DISCONNECT_EVT:
+            /* Only finds a job if the device disconnected before discovery was complete */
+            if (xSemaphoreTake(gattMutex, portMAX_DELAY)) {
+                const gatt_discovery_result *result = gatt_discovery_finish(param->disconnect.remote_bda,
+                    WENDIGO_GATT_FAILED, now_ms);
+                if (result != NULL) {
+                    ESP_LOGW(BLE_TAG, "GATT connection lost during discovery, reason %d", param->disconnect.reason);
+                    display_gatt_services(result);
+                    gatt_discovery_pump(now_ms);
                 }
+                xSemaphoreGive(gattMutex);
             }
             break;
-        case ESP_GATTC_NOTIFY_EVT:
-            if (p_data->notify.is_notify) {
-                ESP_LOGI(BLE_TAG, "ESP_GATTC_NOTIFY_EVT, receeive notify value:");
-            } else {
-                ESP_LOGI(BLE_TAG, "ESP_GATTC_NOTIFY_EVT, receive indicate value:");
-            }
-            ESP_LOG_BUFFER_HEX(BLE_TAG, p_data->notify.value, p_data->notify.value_len);
-            break;
-        case ESP_GATTC_WRITE_DESCR_EVT:
-            if (p_data->write.status != ESP_GATT_OK) {
-                ESP_LOGE(BLE_TAG, "Write descr failed, error: %s", esp_err_to_name(p_data->write.status));
-                break;
-            }
-            ESP_LOGI(BLE_TAG, "Write descr success");
-            uint8_t write_char_data[35];
-            for (int i = 0; i < sizeof(write_char_data); ++i) {
-                write_char_data[i] = i % 256;
-            }
-            esp_ble_gattc_write_char(gattc_if,
-                                     gl_profile_tab[0].conn_id,
-                                     gl_profile_tab[0].char_handle,
-                                     sizeof(write_char_data),
-                                     write_char_data,
-                                     ESP_GATT_WRITE_TYPE_RSP,
-                                     ESP_GATT_AUTH_REQ_NONE);
-            break;
-        case ESP_GATTC_SRVC_CHG_EVT:
-            esp_bd_addr_t bda;
-            memcpy(bda, p_data->srvc_chg.remote_bda, sizeof(esp_bd_addr_t));
-            ESP_LOGI(BLE_TAG, "ESP_GATTC_SRVC_CHG_EVT, bd_addr: ");
-            ESP_LOG_BUFFER_HEX(BLE_TAG, bda, sizeof(esp_bd_addr_t));
-            break;
-        case ESP_GATTC_WRITE_CHAR_EVT:
-            if (p_data->write.status != ESP_GATT_OK) {
-                ESP_LOGE(BLE_TAG, "Write char failed, error: %s", esp_err_to_name(p_data->write.status));
-                break;
-            }
-            ESP_LOGI(BLE_TAG, "Write char success");
-            break;
-        case ESP_GATTC_DISCONNECT_EVT:
-            connect = false;
-            get_server = false;
-            ESP_LOGI(BLE_TAG, "ESP_GATTC_DISCONNECT_EVT, reason = %d", p_data->disconnect.reason);
-            break;
         default:
             break;
     }
 }
-
 wendigo_device *device_from_gap_cb(esp_bt_gap_cb_param_t *param) {
     wendigo_device *dev = (wendigo_device *)malloc(sizeof(wendigo_device));
+    if (dev == NULL) {
+        outOfMemory();
+        return NULL;
+    }
     dev->radio.bluetooth.eir_len = 0;
     dev->radio.bluetooth.bdname_len = 0;
     dev->radio.bluetooth.bdname = NULL;
     dev->radio.bluetooth.eir = NULL;
     dev->radio.bluetooth.cod = 0;
+    dev->radio.bluetooth.cod_major = WENDIGO_COD_MAJOR_MISC;
+    dev->radio.bluetooth.cod_minor = 0;
     dev->scanType = SCAN_HCI;
     dev->tagged = false;
+    /* 0 if the event has no RSSI */
+    dev->rssi = 0;
+    memset(&(dev->radio.bluetooth.bt_services), 0, sizeof(wendigo_bt_svc));
     esp_bt_gap_dev_prop_t *p;
-    char codDevType[COD_MAX_LEN]; /* Placeholder to store COD major device type */
-    uint8_t codDevTypeLen = 0;
-    char dev_bdname[ESP_BT_GAP_MAX_BDNAME_LEN + 1];
     
     memcpy(dev->mac, param->disc_res.bda, ESP_BD_ADDR_LEN);
 
@@ -671,7 +898,8 @@ wendigo_device *device_from_gap_cb(esp_bt_gap_cb_param_t *param) {
         switch (p->type) {
             case ESP_BT_GAP_DEV_PROP_COD:
                 dev->radio.bluetooth.cod = *(uint32_t *)(p->val);
-                cod2deviceStr(dev->radio.bluetooth.cod, codDevType, &codDevTypeLen);
+                dev->radio.bluetooth.cod_major = wendigo_cod_major(dev->radio.bluetooth.cod);
+                dev->radio.bluetooth.cod_minor = wendigo_cod_minor(dev->radio.bluetooth.cod);
                 break;
             case ESP_BT_GAP_DEV_PROP_RSSI:
                 dev->rssi = *(int16_t *)(p->val);
@@ -701,17 +929,41 @@ wendigo_device *device_from_gap_cb(esp_bt_gap_cb_param_t *param) {
                 break;
         }
     }
+    return dev;
+}
 
-    /* If we didn't get a bdname check EIR for a name */
-    if (dev->radio.bluetooth.bdname_len == 0) {
-        get_string_name_from_eir(dev->radio.bluetooth.eir, dev_bdname, &(dev->radio.bluetooth.bdname_len));
-        if (dev->radio.bluetooth.bdname_len > 0) {
-            dev->radio.bluetooth.bdname = (char *)malloc(sizeof(char) * (dev->radio.bluetooth.bdname_len + 1));
-            strncpy(dev->radio.bluetooth.bdname, dev_bdname, dev->radio.bluetooth.bdname_len);
-            dev->radio.bluetooth.bdname[dev->radio.bluetooth.bdname_len] = '\0';
+/** Parse a device found by Bluetooth Classic discovery, add it to the cache
+ *  and free it. `data` points to the pointer bt_gap_cb() obtained from
+ *  device_from_gap_cb(). Runs on the pipeline task on dual-core chips,
+ *  otherwise in the callback.
+ */
+static void bt_report_device(void *data) {
+    wendigo_device *dev = *(wendigo_device **)data;
+    bt_ad_data ad;
+    const bt_uuid *known_services[BT_AD_MAX_UUIDS];
+    /* One pass over EIR for services, and a name if the device didn't send one */
+    bt_ad_parse(dev->radio.bluetooth.eir, dev->radio.bluetooth.eir_len, &ad);
+    if (dev->radio.bluetooth.bdname_len == 0 && ad.name_len > 0) {
+        dev->radio.bluetooth.bdname = (char *)malloc(sizeof(char) * (ad.name_len + 1));
+        if (dev->radio.bluetooth.bdname == NULL) {
+            outOfMemory();
+        } else {
+            memcpy(dev->radio.bluetooth.bdname, ad.name, ad.name_len);
+            dev->radio.bluetooth.bdname[ad.name_len] = '\0';
+            dev->radio.bluetooth.bdname_len = ad.name_len;
         }
     }
-    return dev;
+    bt_services_from_ad(&ad, known_services, &(dev->radio.bluetooth.bt_services));
+    if (dev->rssi != 0) {
+        wendigo_focus_sample(dev->mac, dev->rssi, 0);
+    }
+    display_gap_device(dev);
+    /* Add to or update all_gap_devices[] */
+    add_device(dev);
+    /* dev's services belong to ad, not dev */
+    memset(&(dev->radio.bluetooth.bt_services), 0, sizeof(wendigo_bt_svc));
+    free_device(dev);
+    free(dev);
 }
 
 /** Bluetooth Classic Discovery callback - Called on Bluetooth Classic events including
@@ -720,22 +972,21 @@ wendigo_device *device_from_gap_cb(esp_bt_gap_cb_param_t *param) {
 static void bt_gap_cb(esp_bt_gap_cb_event_t event, esp_bt_gap_cb_param_t *param) {
     switch (event) {
         case ESP_BT_GAP_DISC_RES_EVT:
-            char bdaStr[MAC_STRLEN + 1];
-            mac_bytes_to_string(param->disc_res.bda, bdaStr);
             wendigo_device *dev = device_from_gap_cb(param);
             if (dev == NULL) {
                 ESP_LOGE(BT_TAG, "Failed to obtain device from event parameters :(");
+                break;
+            }
+            /* The pipeline takes a copy of the pointer, and with it `dev` -
+               Unless it's dropped, in which case it's still ours to free */
+            if (!wendigo_pipeline_submit(bt_report_device, &dev, sizeof(wendigo_device *))) {
+                free_device(dev);
             }
-            display_gap_device(dev);
-            /* Add to or update all_gap_devices[] */
-            add_device(dev);
-            free_device(dev);
-            free(dev);
             break;
         case ESP_BT_GAP_DISC_STATE_CHANGED_EVT:
             if (param->disc_st_chg.state == ESP_BT_GAP_DISCOVERY_STOPPED) {
                 ESP_LOGI(BT_TAG, "ESP_BT_GAP_DSC_STATE_CHANGED_EVT: ESP_BT_GAP_DISCOVERY_STOPPED:");
-                if (scanStatus[SCAN_HCI] == ACTION_ENABLE) {
+                if (radio_sched_is_active(RADIO_SCHED_HCI)) {
                     ESP_LOGI(BT_TAG, "Restarting...");
                     esp_bt_gap_start_discovery(ESP_BT_INQ_MODE_GENERAL_INQUIRY, CONFIG_BT_SCAN_DURATION, 0);
                 }
@@ -766,9 +1017,7 @@ esp_err_t wendigo_bt_gap_start() {
     /* Set discoverable and connectable, wait to be connected */
     err |= esp_bt_gap_set_scan_mode(ESP_BT_CONNECTABLE, ESP_BT_GENERAL_DISCOVERABLE);
 
-    /* Start to discover nearby devices */
-    err |= esp_bt_gap_start_discovery(ESP_BT_INQ_MODE_GENERAL_INQUIRY, CONFIG_BT_SCAN_DURATION, 0);
-
+    /* Discovery is started by the radio scheduler - wendigo_bt_slice_start() */
     return err;
 }
 
@@ -784,8 +1033,8 @@ esp_err_t wendigo_bt_enable() {
 }
 
 /** This function does not terminate in-flight discovery. Its calling function -
- *  cmd_bluetooth in wendigo.c - sets scanStatus[SCAN_HCI] to ACTION_DISABLE.
- *  When the current discovery interval expires a new discovery task will not be launched
+ *  cmd_bluetooth in wendigo.c - sets scanStatus[SCAN_HCI] to ACTION_DISABLE and
+ *  removes Bluetooth Classic from the radio scheduler, which cancels discovery.
  */
 esp_err_t wendigo_bt_disable() {
     esp_err_t result = ESP_OK;
@@ -806,7 +1055,8 @@ esp_err_t wendigo_ble_enable() {
             return result;
         }
     }
-    return esp_ble_gap_start_scanning(CONFIG_BLE_SCAN_SECONDS);
+    /* Scanning is started by the radio scheduler - wendigo_ble_slice_start() */
+    return result;
 }
 
 esp_err_t wendigo_ble_disable() {
@@ -817,114 +1067,41 @@ esp_err_t wendigo_ble_disable() {
             return result;
         }
     }
-    return esp_ble_gap_stop_scanning();
+    /* The radio scheduler stops scanning when BLE is removed from the schedule */
+    return result;
 }
 
-/** cod2deviceStr
- *  Converts a uint32_t representing a Bluetooth Class Of Device (COD)'s major
- *  device code into a useful string descriptor of the specified COD major device.
- *  Returns an error indicator. Input 'cod' is the COD to be converted.
- *  char *string is a pointer to a character array of sufficient size to hold
- *  the results. The maximum possible number of characters required by this
- *  function, including the trailing NULL, is 59.
- *  uint8_t *stringLen is a pointer to a uint8_t variable in the calling code.
- *  This variable will be overwritten with the length of string.
+/** Start Bluetooth Classic discovery for a radio scheduler slice of `slice_ms`.
+ *  Inquiry length is in units of 1.28 seconds, so discovery is started for at
+ *  least the slice and cancelled when the slice ends. If it stops first and
+ *  it's still Bluetooth Classic's slice, bt_gap_cb() restarts it.
  */
-esp_err_t cod2deviceStr(uint32_t cod, char *string, uint8_t *stringLen) {
-    esp_err_t err = ESP_OK;
-    char temp[COD_MAX_LEN] = "";
-    esp_bt_cod_major_dev_t devType = esp_bt_gap_get_cod_major_dev(cod);
-    switch (devType) {
-        case ESP_BT_COD_MAJOR_DEV_MISC:
-            strcpy(temp, "Miscellaneous");
-            break;
-        case ESP_BT_COD_MAJOR_DEV_COMPUTER:
-            strcpy(temp, "Computer");
-            break;
-        case ESP_BT_COD_MAJOR_DEV_PHONE:
-            strcpy(temp, "Phone (cellular, cordless, pay phone, modem)");
-            break;
-        case ESP_BT_COD_MAJOR_DEV_LAN_NAP:
-            strcpy(temp, "LAN, Network Access Point");
-            break;
-        case ESP_BT_COD_MAJOR_DEV_AV:
-            strcpy(temp, "Audio/Video (headset, speaker, stereo, video display, VCR)");
-            break;
-        case ESP_BT_COD_MAJOR_DEV_PERIPHERAL:
-            strcpy(temp, "Peripheral (mouse, joystick, keyboard)");
-            break;
-        case ESP_BT_COD_MAJOR_DEV_IMAGING:
-            strcpy(temp, "Imaging (printer, scanner, camera, display)");
-            break;
-        case ESP_BT_COD_MAJOR_DEV_WEARABLE:
-            strcpy(temp, "Wearable");
-            break;
-        case ESP_BT_COD_MAJOR_DEV_TOY:
-            strcpy(temp, "Toy");
-            break;
-        case ESP_BT_COD_MAJOR_DEV_HEALTH:
-            strcpy(temp, "Health");
-            break;
-        case ESP_BT_COD_MAJOR_DEV_UNCATEGORIZED:
-            strcpy(temp, "Uncategorised: Device not specified");
-            break;
-        default:
-            strcpy(temp, "ERROR: Invalid Major Device Type");
-            break;
+esp_err_t wendigo_bt_slice_start(uint32_t slice_ms) {
+    uint32_t inq_len = (slice_ms + 1279) / 1280;
+    if (inq_len < ESP_BT_GAP_MIN_INQ_LEN) {
+        inq_len = ESP_BT_GAP_MIN_INQ_LEN;
+    } else if (inq_len > ESP_BT_GAP_MAX_INQ_LEN) {
+        inq_len = ESP_BT_GAP_MAX_INQ_LEN;
     }
-    strcpy(string, temp);
-    *stringLen = strlen(string);
+    return esp_bt_gap_start_discovery(ESP_BT_INQ_MODE_GENERAL_INQUIRY, (uint8_t)inq_len, 0);
+}
 
-    return err;
+/** End Bluetooth Classic's radio scheduler slice */
+esp_err_t wendigo_bt_slice_stop() {
+    return esp_bt_gap_cancel_discovery();
 }
 
-/** As above, but returning a shortened string suitable for display by VIEW */
-esp_err_t cod2shortStr(uint32_t cod, char *string, uint8_t *stringLen) {
-    esp_err_t err = ESP_OK;
-    char temp[SHORT_COD_MAX_LEN] = "";
-    esp_bt_cod_major_dev_t devType = esp_bt_gap_get_cod_major_dev(cod);
-    switch (devType) {
-        case ESP_BT_COD_MAJOR_DEV_MISC:
-            strcpy(temp, "Misc.");
-            break;
-        case ESP_BT_COD_MAJOR_DEV_COMPUTER:
-            strcpy(temp, "PC");
-            break;
-        case ESP_BT_COD_MAJOR_DEV_PHONE:
-            strcpy(temp, "Phone");
-            break;
-        case ESP_BT_COD_MAJOR_DEV_LAN_NAP:
-            strcpy(temp, "LAN");
-            break;
-        case ESP_BT_COD_MAJOR_DEV_AV:
-            strcpy(temp, "A/V");
-            break;
-        case ESP_BT_COD_MAJOR_DEV_PERIPHERAL:
-            strcpy(temp, "Peripheral");
-            break;
-        case ESP_BT_COD_MAJOR_DEV_IMAGING:
-            strcpy(temp, "Imaging");
-            break;
-        case ESP_BT_COD_MAJOR_DEV_WEARABLE:
-            strcpy(temp, "Wearable");
-            break;
-        case ESP_BT_COD_MAJOR_DEV_TOY:
-            strcpy(temp, "Toy");
-            break;
-        case ESP_BT_COD_MAJOR_DEV_HEALTH:
-            strcpy(temp, "Health");
-            break;
-        case ESP_BT_COD_MAJOR_DEV_UNCATEGORIZED:
-            strcpy(temp, "Uncat.");
-            break;
-        default:
-            strcpy(temp, "Invalid");
-            break;
-    }
-    strcpy(string, temp);
-    *stringLen = strlen(string);
+/** Start BLE scanning for a radio scheduler slice of `slice_ms`. As above,
+ *  scanning runs for at least the slice and is stopped when it ends.
+ */
+esp_err_t wendigo_ble_slice_start(uint32_t slice_ms) {
+    return ble_scan_start((slice_ms + 999) / 1000);
+}
 
-    return err;
+/** End BLE's radio scheduler slice */
+esp_err_t wendigo_ble_slice_stop() {
+    ble_scan_cycle_pause();
+    return esp_ble_gap_stop_scanning();
 }
 
 /** Convert a UUID (service or attribute descriptor) to a printable hex string */
@@ -948,55 +1125,12 @@ char *uuid2str(esp_bt_uuid_t *uuid, char *str, size_t size) {
     return str;
 }
 
-static bool get_name_from_eir(uint8_t *eir, uint8_t *bdname, uint8_t *bdname_len)
-{
-    uint8_t *rmt_bdname = NULL;
-    uint8_t rmt_bdname_len = 0;
-
-    if (!eir) {
-        return false;
-    }
-
-    rmt_bdname = esp_bt_gap_resolve_eir_data(eir, ESP_BT_EIR_TYPE_CMPL_LOCAL_NAME, &rmt_bdname_len);
-    if (!rmt_bdname) {
-        rmt_bdname = esp_bt_gap_resolve_eir_data(eir, ESP_BT_EIR_TYPE_SHORT_LOCAL_NAME, &rmt_bdname_len);
-    }
-
-    if (rmt_bdname) {
-        if (rmt_bdname_len > ESP_BT_GAP_MAX_BDNAME_LEN) {
-            rmt_bdname_len = ESP_BT_GAP_MAX_BDNAME_LEN;
-        }
-
-        if (bdname) {
-            memcpy(bdname, rmt_bdname, rmt_bdname_len);
-            bdname[rmt_bdname_len] = '\0';
-        }
-        if (bdname_len) {
-            *bdname_len = rmt_bdname_len;
-        }
-        return true;
-    }
-    return false;
-}
-
-static bool get_string_name_from_eir(uint8_t *eir, char *bdname, uint8_t *bdname_len) {
-    bool retVal = true;
-    uint8_t bdname_bytes[ESP_BT_GAP_MAX_BDNAME_LEN + 1]; // TODO: Remove +1?
-    retVal = get_name_from_eir(eir, bdname_bytes, bdname_len);
-
-    if (*bdname_len > 0) {
-        memcpy(bdname, bdname_bytes, *bdname_len);
-        bdname[*bdname_len] = '\0';
+/** Search the store of known UUIDs for the specified UUID - Service classes
+ *  first, then GATT services */
+const bt_uuid *svcForUUID(uint16_t uuid) {
+    const bt_uuid *result = bt_uuid_lookup(BT_UUID_TABLE_SERVICE_CLASS, uuid);
+    if (result == NULL) {
+        result = bt_uuid_lookup(BT_UUID_TABLE_GATT_SERVICE, uuid);
     }
-    return retVal;
-}
-
-/** Search the store of known UUIDs for the specified UUID */
-bt_uuid *svcForUUID(uint16_t uuid) {
-    uint8_t svcIdx = 0;
-    for ( ; svcIdx < BT_UUID_COUNT && uuid != bt_uuids[svcIdx].uuid16; ++ svcIdx) {}
-    if (svcIdx == BT_UUID_COUNT) {
-        return NULL;
-    }
-    return &(bt_uuids[svcIdx]);
+    return result;
 }
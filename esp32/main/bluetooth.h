@@ -2,6 +2,8 @@
 #define WENDIGO_BLUETOOTH_H
 
 #include "common.h"
+#include "ble_scan_policy.h"
+#include "gatt_discovery.h"
 
 #include <esp_bt.h>
 #include <esp_bt_main.h>
@@ -9,9 +11,6 @@
 #include <esp_gap_bt_api.h>
 #include <esp_gatt_common_api.h>
 
-#define COD_MAX_LEN 59
-#define SHORT_COD_MAX_LEN 11
-
 static const char *BT_TAG = "HCI@Wendigo";
 static const char *BLE_TAG = "BLE@Wendigo";
 
@@ -20,6 +19,13 @@ esp_err_t wendigo_bt_enable();
 esp_err_t wendigo_bt_disable();
 esp_err_t wendigo_ble_enable();
 esp_err_t wendigo_ble_disable();
+esp_err_t wendigo_bt_slice_start(uint32_t slice_ms);
+esp_err_t wendigo_bt_slice_stop();
+esp_err_t wendigo_ble_slice_start(uint32_t slice_ms);
+esp_err_t wendigo_ble_slice_stop();
+const ble_scan_policy *wendigo_ble_scan_policy();
+esp_err_t wendigo_gatt_discover(esp_bd_addr_t bda);
+void wendigo_gatt_discovery_stats(gatt_discovery_stats *stats);
 esp_err_t display_gap_device(wendigo_device *dev);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,108 @@
+#include "bt_ad.h"
+
+#include <string.h>
+
+/* Point ad->name at a name field, preferring a complete name to a short one */
+static void bt_ad_parse_name(const uint8_t *data, uint8_t data_len, bool complete, bt_ad_data *ad) {
+    if (data_len == 0 || (ad->name_complete && !complete)) {
+        return;
+    }
+    ad->name = data;
+    ad->name_len = data_len;
+    ad->name_complete = complete;
+}
+
+/* Append the UUIDs in a service UUID list, each `uuid_len` bytes, to ad->uuids */
+static void bt_ad_parse_uuids(const uint8_t *data, uint8_t data_len, uint8_t uuid_len, bt_ad_data *ad) {
+    for (uint8_t i = 0; i + uuid_len <= data_len; i += uuid_len) {
+        if (ad->uuid_count == BT_AD_MAX_UUIDS) {
+            ad->uuids_truncated = true;
+            return;
+        }
+        esp_bt_uuid_t *uuid = &(ad->uuids[ad->uuid_count++]);
+        memset(uuid, 0, sizeof(esp_bt_uuid_t));
+        uuid->len = uuid_len;
+        if (uuid_len == ESP_UUID_LEN_16) {
+            uuid->uuid.uuid16 = data[i] | (data[i + 1] << 8);
+        } else if (uuid_len == ESP_UUID_LEN_32) {
+            uuid->uuid.uuid32 = data[i] | (data[i + 1] << 8) | (data[i + 2] << 16) |
+                                ((uint32_t)data[i + 3] << 24);
+        } else {
+            /* Little-endian, as ESP-IDF stores it */
+            memcpy(uuid->uuid.uuid128, data + i, ESP_UUID_LEN_128);
+        }
+    }
+}
+
+/** Parse the AD structures in `payload` into `ad` in a single pass.
+ * `ad` is cleared first. Parsing stops at a zero-length field, which marks the
+ * end of significant data; a field running past the end of the payload also
+ * stops parsing and makes the function return false, although `ad` holds
+ * everything parsed before it.
+ */
+bool bt_ad_parse(const uint8_t *payload, uint16_t payload_len, bt_ad_data *ad) {
+    memset(ad, 0, sizeof(bt_ad_data));
+    if (payload == NULL) {
+        return payload_len == 0;
+    }
+    uint16_t idx = 0;
+    while (idx < payload_len) {
+        uint8_t field_len = payload[idx];
+        if (field_len == 0) {
+            break;
+        }
+        if (idx + 1 + field_len > payload_len) {
+            return false;
+        }
+        uint8_t type = payload[idx + 1];
+        const uint8_t *data = payload + idx + 2;
+        uint8_t data_len = field_len - 1;
+        switch (type) {
+            case BT_AD_TYPE_FLAGS:
+                if (data_len >= 1) {
+                    ad->has_flags = true;
+                    ad->flags = data[0];
+                }
+                break;
+            case BT_AD_TYPE_UUID16_INCOMPLETE:
+            case BT_AD_TYPE_UUID16_COMPLETE:
+                bt_ad_parse_uuids(data, data_len, ESP_UUID_LEN_16, ad);
+                break;
+            case BT_AD_TYPE_UUID32_INCOMPLETE:
+            case BT_AD_TYPE_UUID32_COMPLETE:
+                bt_ad_parse_uuids(data, data_len, ESP_UUID_LEN_32, ad);
+                break;
+            case BT_AD_TYPE_UUID128_INCOMPLETE:
+            case BT_AD_TYPE_UUID128_COMPLETE:
+                bt_ad_parse_uuids(data, data_len, ESP_UUID_LEN_128, ad);
+                break;
+            case BT_AD_TYPE_NAME_SHORT:
+            case BT_AD_TYPE_NAME_COMPLETE:
+                bt_ad_parse_name(data, data_len, type == BT_AD_TYPE_NAME_COMPLETE, ad);
+                break;
+            case BT_AD_TYPE_TX_POWER:
+                if (data_len >= 1) {
+                    ad->has_tx_power = true;
+                    ad->tx_power = (int8_t)data[0];
+                }
+                break;
+            case BT_AD_TYPE_APPEARANCE:
+                if (data_len >= 2) {
+                    ad->has_appearance = true;
+                    ad->appearance = data[0] | (data[1] << 8);
+                }
+                break;
+            case BT_AD_TYPE_MANUFACTURER:
+                /* Only the first manufacturer's company ID is kept */
+                if (data_len >= 2 && !ad->has_company_id) {
+                    ad->has_company_id = true;
+                    ad->company_id = data[0] | (data[1] << 8);
+                }
+                break;
+            default:
+                break;
+        }
+        idx += 1 + field_len;
+    }
+    return true;
+}
@@ -0,0 +1,58 @@
+#ifndef WENDIGO_BT_AD_H
+#define WENDIGO_BT_AD_H
+
+/** A single-pass parser for the AD structures that make up BLE advertising
+ * data, scan responses and Bluetooth Classic EIR - A sequence of
+ * [length][type][length - 1 bytes of data] fields.
+ * Everything of interest is extracted into a bt_ad_data, which is small
+ * enough to live on the stack, so parsing never allocates; the name is left
+ * where it is in the payload. UUIDs are stored
+ * as esp_bt_uuid_t so they can be used directly as wendigo_bt_svc's
+ * service_uuids. Nothing here needs more of ESP-IDF than esp_bt_defs.h, so the
+ * parser can be exercised on a host against captured payloads.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <esp_bt_defs.h>
+
+/* Most service UUIDs kept from a single payload */
+#define BT_AD_MAX_UUIDS     16
+
+/* AD types from the Bluetooth SIG's Assigned Numbers, section 2.3 */
+typedef enum {
+    BT_AD_TYPE_FLAGS = 0x01,
+    BT_AD_TYPE_UUID16_INCOMPLETE = 0x02,
+    BT_AD_TYPE_UUID16_COMPLETE = 0x03,
+    BT_AD_TYPE_UUID32_INCOMPLETE = 0x04,
+    BT_AD_TYPE_UUID32_COMPLETE = 0x05,
+    BT_AD_TYPE_UUID128_INCOMPLETE = 0x06,
+    BT_AD_TYPE_UUID128_COMPLETE = 0x07,
+    BT_AD_TYPE_NAME_SHORT = 0x08,
+    BT_AD_TYPE_NAME_COMPLETE = 0x09,
+    BT_AD_TYPE_TX_POWER = 0x0A,
+    BT_AD_TYPE_APPEARANCE = 0x19,
+    BT_AD_TYPE_MANUFACTURER = 0xFF,
+} BtAdType;
+
+typedef struct bt_ad_data {
+    const uint8_t *name;                /* Points into the payload, not null-terminated.
+                                           A complete name is preferred over a short one */
+    uint8_t name_len;
+    bool name_complete;
+    bool has_flags;
+    uint8_t flags;
+    bool has_tx_power;
+    int8_t tx_power;                    /* dBm */
+    bool has_appearance;
+    uint16_t appearance;
+    bool has_company_id;
+    uint16_t company_id;                /* First two bytes of manufacturer-specific data */
+    uint8_t uuid_count;
+    bool uuids_truncated;               /* More than BT_AD_MAX_UUIDS UUIDs were advertised */
+    esp_bt_uuid_t uuids[BT_AD_MAX_UUIDS];
+} bt_ad_data;
+
+bool bt_ad_parse(const uint8_t *payload, uint16_t payload_len, bt_ad_data *ad);
+
+#endif
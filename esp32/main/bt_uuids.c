@@ -0,0 +1,897 @@
+/* Generated by esp32/generate_uuids.py from the Bluetooth SIG's assigned numbers.
+ * Do not edit - Add or update the YAML in esp32/ and run the script.
+ *
+ * Service classes: assigned_numbers_uuids_service_class.yaml, 76 entries
+ * GATT services: service_uuids.yaml, 63 entries
+ * GATT characteristics: characteristic_uuids.yaml, 201 entries
+ * Company identifiers: company_identifiers.yaml, 74 entries
+ */
+#include "bt_uuids.h"
+
+#if defined(CONFIG_BT_ENABLED) && defined(CONFIG_DECODE_UUIDS)
+
+/* Every name, once, null-terminated (7632 bytes) */
+static const char bt_uuid_names[] =
+    "ServiceDiscoveryServerServiceClassID" "\0"  /* 0 */
+    "BrowseGroupDescriptorServiceClassID" "\0"  /* 37 */
+    "SerialPort" "\0"  /* 73 */
+    "LANAccessUsingPPP" "\0"  /* 84 */
+    "DialupNetworking" "\0"  /* 102 */
+    "IrMCSync" "\0"  /* 119 */
+    "OBEXObjectPush" "\0"  /* 128 */
+    "OBEXFileTransfer" "\0"  /* 143 */
+    "IrMCSyncCommand" "\0"  /* 160 */
+    "Headset" "\0"  /* 176 */
+    "CordlessTelephony" "\0"  /* 184 */
+    "AudioSource" "\0"  /* 202 */
+    "AudioSink" "\0"  /* 214 */
+    "A/V_RemoteControlTarget" "\0"  /* 224 */
+    "AdvancedAudioDistribution" "\0"  /* 248 */
+    "A/V_RemoteControl" "\0"  /* 274 */
+    "A/V_RemoteControlController" "\0"  /* 292 */
+    "Intercom" "\0"  /* 320 */
+    "Fax" "\0"  /* 329 */
+    "Headset - Audio Gateway" "\0"  /* 333 */
+    "WAP" "\0"  /* 357 */
+    "WAP_CLIENT" "\0"  /* 361 */
+    "PANU" "\0"  /* 372 */
+    "NAP" "\0"  /* 377 */
+    "GN" "\0"  /* 381 */
+    "DirectPrinting" "\0"  /* 384 */
+    "ReferencePrinting" "\0"  /* 399 */
+    "Basic Imaging Profile" "\0"  /* 417 */
+    "ImagingResponder" "\0"  /* 439 */
+    "ImagingAutomaticArchive" "\0"  /* 456 */
+    "ImagingReferencedObjects" "\0"  /* 480 */
+    "Handsfree" "\0"  /* 505 */
+    "HandsfreeAudioGateway" "\0"  /* 515 */
+    "DirectPrintingReferenceObjectsService" "\0"  /* 537 */
+    "ReflectedUI" "\0"  /* 575 */
+    "BasicPrinting" "\0"  /* 587 */
+    "PrintingStatus" "\0"  /* 601 */
+    "HumanInterfaceDeviceService" "\0"  /* 616 */
+    "HardcopyCableReplacement" "\0"  /* 644 */
+    "HCR_Print" "\0"  /* 669 */
+    "HCR_Scan" "\0"  /* 679 */
+    "Common_ISDN_Access" "\0"  /* 688 */
+    "SIM_Access" "\0"  /* 707 */
+    "Phonebook Access - PCE" "\0"  /* 718 */
+    "Phonebook Access - PSE" "\0"  /* 741 */
+    "Phonebook Access" "\0"  /* 764 */
+    "Headset - HS" "\0"  /* 781 */
+    "Message Access Server" "\0"  /* 794 */
+    "Message Notification Server" "\0"  /* 816 */
+    "Message Access Profile" "\0"  /* 844 */
+    "GNSS" "\0"  /* 867 */
+    "GNSS_Server" "\0"  /* 872 */
+    "3D Display" "\0"  /* 884 */
+    "3D Glasses" "\0"  /* 895 */
+    "3D Synchronization" "\0"  /* 906 */
+    "MPS Profile" "\0"  /* 925 */
+    "MPS SC" "\0"  /* 937 */
+    "CTN Access Service" "\0"  /* 944 */
+    "CTN Notification Service" "\0"  /* 963 */
+    "CTN Profile" "\0"  /* 988 */
+    "PnPInformation" "\0"  /* 1000 */
+    "GenericNetworking" "\0"  /* 1015 */
+    "GenericFileTransfer" "\0"  /* 1033 */
+    "GenericAudio" "\0"  /* 1053 */
+    "GenericTelephony" "\0"  /* 1066 */
+    "UPNP_Service" "\0"  /* 1083 */
+    "UPNP_IP_Service" "\0"  /* 1096 */
+    "ESDP_UPNP_IP_PAN" "\0"  /* 1112 */
+    "ESDP_UPNP_IP_LAP" "\0"  /* 1129 */
+    "ESDP_UPNP_L2CAP" "\0"  /* 1146 */
+    "VideoSource" "\0"  /* 1162 */
+    "VideoSink" "\0"  /* 1174 */
+    "VideoDistribution" "\0"  /* 1184 */
+    "HDP" "\0"  /* 1202 */
+    "HDP Source" "\0"  /* 1206 */
+    "HDP Sink" "\0"  /* 1217 */
+    "GAP" "\0"  /* 1226 */
+    "GATT" "\0"  /* 1230 */
+    "Immediate Alert" "\0"  /* 1235 */
+    "Link Loss" "\0"  /* 1251 */
+    "Tx Power" "\0"  /* 1261 */
+    "Current Time" "\0"  /* 1270 */
+    "Reference Time Update" "\0"  /* 1283 */
+    "Next DST Change" "\0"  /* 1305 */
+    "Glucose" "\0"  /* 1321 */
+    "Health Thermometer" "\0"  /* 1329 */
+    "Device Information" "\0"  /* 1348 */
+    "Heart Rate" "\0"  /* 1367 */
+    "Phone Alert Status" "\0"  /* 1378 */
+    "Battery" "\0"  /* 1397 */
+    "Blood Pressure" "\0"  /* 1405 */
+    "Alert Notification" "\0"  /* 1420 */
+    "Human Interface Device" "\0"  /* 1439 */
+    "Scan Parameters" "\0"  /* 1462 */
+    "Running Speed and Cadence" "\0"  /* 1478 */
+    "Automation IO" "\0"  /* 1504 */
+    "Cycling Speed and Cadence" "\0"  /* 1518 */
+    "Cycling Power" "\0"  /* 1544 */
+    "Location and Navigation" "\0"  /* 1558 */
+    "Environmental Sensing" "\0"  /* 1582 */
+    "Body Composition" "\0"  /* 1604 */
+    "User Data" "\0"  /* 1621 */
+    "Weight Scale" "\0"  /* 1631 */
+    "Bond Management" "\0"  /* 1644 */
+    "Continuous Glucose Monitoring" "\0"  /* 1660 */
+    "Internet Protocol Support" "\0"  /* 1690 */
+    "Indoor Positioning" "\0"  /* 1716 */
+    "Pulse Oximeter" "\0"  /* 1735 */
+    "HTTP Proxy" "\0"  /* 1750 */
+    "Transport Discovery" "\0"  /* 1761 */
+    "Object Transfer" "\0"  /* 1781 */
+    "Fitness Machine" "\0"  /* 1797 */
+    "Mesh Provisioning" "\0"  /* 1813 */
+    "Mesh Proxy" "\0"  /* 1831 */
+    "Reconnection Configuration" "\0"  /* 1842 */
+    "Insulin Delivery" "\0"  /* 1869 */
+    "Binary Sensor" "\0"  /* 1886 */
+    "Emergency Configuration" "\0"  /* 1900 */
+    "Physical Activity Monitor" "\0"  /* 1924 */
+    "Audio Input Control" "\0"  /* 1950 */
+    "Volume Control" "\0"  /* 1970 */
+    "Volume Offset Control" "\0"  /* 1985 */
+    "Coordinated Set Identification" "\0"  /* 2007 */
+    "Device Time" "\0"  /* 2038 */
+    "Media Control" "\0"  /* 2050 */
+    "Generic Media Control" "\0"  /* 2064 */
+    "Constant Tone Extension" "\0"  /* 2086 */
+    "Telephone Bearer" "\0"  /* 2110 */
+    "Generic Telephone Bearer" "\0"  /* 2127 */
+    "Microphone Control" "\0"  /* 2152 */
+    "Audio Stream Control" "\0"  /* 2171 */
+    "Broadcast Audio Scan" "\0"  /* 2192 */
+    "Published Audio Capabilities" "\0"  /* 2213 */
+    "Basic Audio Announcement" "\0"  /* 2242 */
+    "Broadcast Audio Announcement" "\0"  /* 2267 */
+    "Common Audio" "\0"  /* 2296 */
+    "Hearing Access" "\0"  /* 2309 */
+    "Telephony and Media Audio" "\0"  /* 2324 */
+    "Public Broadcast Announcement" "\0"  /* 2350 */
+    "Device Name" "\0"  /* 2380 */
+    "Appearance" "\0"  /* 2392 */
+    "Peripheral Privacy Flag" "\0"  /* 2403 */
+    "Reconnection Address" "\0"  /* 2427 */
+    "Peripheral Preferred Connection Parameters" "\0"  /* 2448 */
+    "Service Changed" "\0"  /* 2491 */
+    "Alert Level" "\0"  /* 2507 */
+    "Tx Power Level" "\0"  /* 2519 */
+    "Date Time" "\0"  /* 2534 */
+    "Day of Week" "\0"  /* 2544 */
+    "Day Date Time" "\0"  /* 2556 */
+    "Exact Time 256" "\0"  /* 2570 */
+    "DST Offset" "\0"  /* 2585 */
+    "Time Zone" "\0"  /* 2596 */
+    "Local Time Information" "\0"  /* 2606 */
+    "Time with DST" "\0"  /* 2629 */
+    "Time Accuracy" "\0"  /* 2643 */
+    "Time Source" "\0"  /* 2657 */
+    "Reference Time Information" "\0"  /* 2669 */
+    "Time Update Control Point" "\0"  /* 2696 */
+    "Time Update State" "\0"  /* 2722 */
+    "Glucose Measurement" "\0"  /* 2740 */
+    "Battery Level" "\0"  /* 2760 */
+    "Temperature Measurement" "\0"  /* 2774 */
+    "Temperature Type" "\0"  /* 2798 */
+    "Intermediate Temperature" "\0"  /* 2815 */
+    "Measurement Interval" "\0"  /* 2840 */
+    "Boot Keyboard Input Report" "\0"  /* 2861 */
+    "System ID" "\0"  /* 2888 */
+    "Model Number String" "\0"  /* 2898 */
+    "Serial Number String" "\0"  /* 2918 */
+    "Firmware Revision String" "\0"  /* 2939 */
+    "Hardware Revision String" "\0"  /* 2964 */
+    "Software Revision String" "\0"  /* 2989 */
+    "Manufacturer Name String" "\0"  /* 3014 */
+    "IEEE 11073-20601 Regulatory Certification Data List" "\0"  /* 3039 */
+    "Magnetic Declination" "\0"  /* 3091 */
+    "Scan Refresh" "\0"  /* 3112 */
+    "Boot Keyboard Output Report" "\0"  /* 3125 */
+    "Boot Mouse Input Report" "\0"  /* 3153 */
+    "Glucose Measurement Context" "\0"  /* 3177 */
+    "Blood Pressure Measurement" "\0"  /* 3205 */
+    "Intermediate Cuff Pressure" "\0"  /* 3232 */
+    "Heart Rate Measurement" "\0"  /* 3259 */
+    "Body Sensor Location" "\0"  /* 3282 */
+    "Heart Rate Control Point" "\0"  /* 3303 */
+    "Alert Status" "\0"  /* 3328 */
+    "Ringer Control Point" "\0"  /* 3341 */
+    "Ringer Setting" "\0"  /* 3362 */
+    "Alert Category ID Bit Mask" "\0"  /* 3377 */
+    "Alert Category ID" "\0"  /* 3404 */
+    "Alert Notification Control Point" "\0"  /* 3422 */
+    "Unread Alert Status" "\0"  /* 3455 */
+    "New Alert" "\0"  /* 3475 */
+    "Supported New Alert Category" "\0"  /* 3485 */
+    "Supported Unread Alert Category" "\0"  /* 3514 */
+    "Blood Pressure Feature" "\0"  /* 3546 */
+    "HID Information" "\0"  /* 3569 */
+    "Report Map" "\0"  /* 3585 */
+    "HID Control Point" "\0"  /* 3596 */
+    "Report" "\0"  /* 3614 */
+    "Protocol Mode" "\0"  /* 3621 */
+    "Scan Interval Window" "\0"  /* 3635 */
+    "PnP ID" "\0"  /* 3656 */
+    "Glucose Feature" "\0"  /* 3663 */
+    "Record Access Control Point" "\0"  /* 3679 */
+    "RSC Measurement" "\0"  /* 3707 */
+    "RSC Feature" "\0"  /* 3723 */
+    "SC Control Point" "\0"  /* 3735 */
+    "Aggregate" "\0"  /* 3752 */
+    "CSC Measurement" "\0"  /* 3762 */
+    "CSC Feature" "\0"  /* 3778 */
+    "Sensor Location" "\0"  /* 3790 */
+    "PLX Spot-Check Measurement" "\0"  /* 3806 */
+    "PLX Continuous Measurement" "\0"  /* 3833 */
+    "PLX Features" "\0"  /* 3860 */
+    "Cycling Power Measurement" "\0"  /* 3873 */
+    "Cycling Power Vector" "\0"  /* 3899 */
+    "Cycling Power Feature" "\0"  /* 3920 */
+    "Cycling Power Control Point" "\0"  /* 3942 */
+    "Location and Speed" "\0"  /* 3970 */
+    "Navigation" "\0"  /* 3989 */
+    "Position Quality" "\0"  /* 4000 */
+    "LN Feature" "\0"  /* 4017 */
+    "LN Control Point" "\0"  /* 4028 */
+    "Elevation" "\0"  /* 4045 */
+    "Pressure" "\0"  /* 4055 */
+    "Temperature" "\0"  /* 4064 */
+    "Humidity" "\0"  /* 4076 */
+    "True Wind Speed" "\0"  /* 4085 */
+    "True Wind Direction" "\0"  /* 4101 */
+    "Apparent Wind Speed" "\0"  /* 4121 */
+    "Apparent Wind Direction" "\0"  /* 4141 */
+    "Gust Factor" "\0"  /* 4165 */
+    "Pollen Concentration" "\0"  /* 4177 */
+    "UV Index" "\0"  /* 4198 */
+    "Irradiance" "\0"  /* 4207 */
+    "Rainfall" "\0"  /* 4218 */
+    "Wind Chill" "\0"  /* 4227 */
+    "Heat Index" "\0"  /* 4238 */
+    "Dew Point" "\0"  /* 4249 */
+    "Descriptor Value Changed" "\0"  /* 4259 */
+    "Aerobic Heart Rate Lower Limit" "\0"  /* 4284 */
+    "Aerobic Threshold" "\0"  /* 4315 */
+    "Age" "\0"  /* 4333 */
+    "Anaerobic Heart Rate Lower Limit" "\0"  /* 4337 */
+    "Anaerobic Heart Rate Upper Limit" "\0"  /* 4370 */
+    "Anaerobic Threshold" "\0"  /* 4403 */
+    "Aerobic Heart Rate Upper Limit" "\0"  /* 4423 */
+    "Date of Birth" "\0"  /* 4454 */
+    "Date of Threshold Assessment" "\0"  /* 4468 */
+    "Email Address" "\0"  /* 4497 */
+    "Fat Burn Heart Rate Lower Limit" "\0"  /* 4511 */
+    "Fat Burn Heart Rate Upper Limit" "\0"  /* 4543 */
+    "First Name" "\0"  /* 4575 */
+    "Five Zone Heart Rate Limits" "\0"  /* 4586 */
+    "Gender" "\0"  /* 4614 */
+    "Heart Rate Max" "\0"  /* 4621 */
+    "Height" "\0"  /* 4636 */
+    "Hip Circumference" "\0"  /* 4643 */
+    "Last Name" "\0"  /* 4661 */
+    "Maximum Recommended Heart Rate" "\0"  /* 4671 */
+    "Resting Heart Rate" "\0"  /* 4702 */
+    "Sport Type for Aerobic and Anaerobic Thresholds" "\0"  /* 4721 */
+    "Three Zone Heart Rate Limits" "\0"  /* 4769 */
+    "Two Zone Heart Rate Limits" "\0"  /* 4798 */
+    "VO2 Max" "\0"  /* 4825 */
+    "Waist Circumference" "\0"  /* 4833 */
+    "Weight" "\0"  /* 4853 */
+    "Database Change Increment" "\0"  /* 4860 */
+    "User Index" "\0"  /* 4886 */
+    "Body Composition Feature" "\0"  /* 4897 */
+    "Body Composition Measurement" "\0"  /* 4922 */
+    "Weight Measurement" "\0"  /* 4951 */
+    "Weight Scale Feature" "\0"  /* 4970 */
+    "User Control Point" "\0"  /* 4991 */
+    "Magnetic Flux Density - 2D" "\0"  /* 5010 */
+    "Magnetic Flux Density - 3D" "\0"  /* 5037 */
+    "Language" "\0"  /* 5064 */
+    "Barometric Pressure Trend" "\0"  /* 5073 */
+    "Bond Management Control Point" "\0"  /* 5099 */
+    "Bond Management Feature" "\0"  /* 5129 */
+    "Central Address Resolution" "\0"  /* 5153 */
+    "CGM Measurement" "\0"  /* 5180 */
+    "CGM Feature" "\0"  /* 5196 */
+    "CGM Status" "\0"  /* 5208 */
+    "CGM Session Start Time" "\0"  /* 5219 */
+    "CGM Session Run Time" "\0"  /* 5242 */
+    "CGM Specific Ops Control Point" "\0"  /* 5263 */
+    "Indoor Positioning Configuration" "\0"  /* 5294 */
+    "Latitude" "\0"  /* 5327 */
+    "Longitude" "\0"  /* 5336 */
+    "Local North Coordinate" "\0"  /* 5346 */
+    "Local East Coordinate" "\0"  /* 5369 */
+    "Floor Number" "\0"  /* 5391 */
+    "Altitude" "\0"  /* 5404 */
+    "Uncertainty" "\0"  /* 5413 */
+    "Location Name" "\0"  /* 5425 */
+    "URI" "\0"  /* 5439 */
+    "HTTP Headers" "\0"  /* 5443 */
+    "HTTP Status Code" "\0"  /* 5456 */
+    "HTTP Entity Body" "\0"  /* 5473 */
+    "HTTP Control Point" "\0"  /* 5490 */
+    "HTTPS Security" "\0"  /* 5509 */
+    "TDS Control Point" "\0"  /* 5524 */
+    "OTS Feature" "\0"  /* 5542 */
+    "Object Name" "\0"  /* 5554 */
+    "Object Type" "\0"  /* 5566 */
+    "Object Size" "\0"  /* 5578 */
+    "Object First-Created" "\0"  /* 5590 */
+    "Object Last-Modified" "\0"  /* 5611 */
+    "Object ID" "\0"  /* 5632 */
+    "Object Properties" "\0"  /* 5642 */
+    "Object Action Control Point" "\0"  /* 5660 */
+    "Object List Control Point" "\0"  /* 5688 */
+    "Object List Filter" "\0"  /* 5714 */
+    "Object Changed" "\0"  /* 5733 */
+    "Resolvable Private Address Only" "\0"  /* 5748 */
+    "Fitness Machine Feature" "\0"  /* 5780 */
+    "Treadmill Data" "\0"  /* 5804 */
+    "Cross Trainer Data" "\0"  /* 5819 */
+    "Step Climber Data" "\0"  /* 5838 */
+    "Stair Climber Data" "\0"  /* 5856 */
+    "Rower Data" "\0"  /* 5875 */
+    "Indoor Bike Data" "\0"  /* 5886 */
+    "Training Status" "\0"  /* 5903 */
+    "Supported Speed Range" "\0"  /* 5919 */
+    "Supported Inclination Range" "\0"  /* 5941 */
+    "Supported Resistance Level Range" "\0"  /* 5969 */
+    "Supported Heart Rate Range" "\0"  /* 6002 */
+    "Supported Power Range" "\0"  /* 6029 */
+    "Fitness Machine Control Point" "\0"  /* 6051 */
+    "Fitness Machine Status" "\0"  /* 6081 */
+    "Mesh Provisioning Data In" "\0"  /* 6104 */
+    "Mesh Provisioning Data Out" "\0"  /* 6130 */
+    "Mesh Proxy Data In" "\0"  /* 6157 */
+    "Mesh Proxy Data Out" "\0"  /* 6176 */
+    "Client Supported Features" "\0"  /* 6196 */
+    "Database Hash" "\0"  /* 6222 */
+    "Server Supported Features" "\0"  /* 6236 */
+    "Ericsson AB" "\0"  /* 6262 */
+    "Nokia Mobile Phones" "\0"  /* 6274 */
+    "Intel Corp." "\0"  /* 6294 */
+    "IBM Corp." "\0"  /* 6306 */
+    "Toshiba Corp." "\0"  /* 6316 */
+    "3Com" "\0"  /* 6330 */
+    "Microsoft" "\0"  /* 6335 */
+    "Lucent" "\0"  /* 6345 */
+    "Motorola" "\0"  /* 6352 */
+    "Infineon Technologies AG" "\0"  /* 6361 */
+    "Qualcomm Technologies International, Ltd. (QTIL)" "\0"  /* 6386 */
+    "Silicon Wave" "\0"  /* 6435 */
+    "Digianswer A/S" "\0"  /* 6448 */
+    "Texas Instruments Inc." "\0"  /* 6463 */
+    "Parthus Technologies Inc." "\0"  /* 6486 */
+    "Broadcom Corporation" "\0"  /* 6512 */
+    "Mitel Semiconductor" "\0"  /* 6533 */
+    "Widcomm, Inc." "\0"  /* 6553 */
+    "Zeevo, Inc." "\0"  /* 6567 */
+    "Atmel Corporation" "\0"  /* 6579 */
+    "Mitsubishi Electric Corporation" "\0"  /* 6597 */
+    "RTX A/S" "\0"  /* 6629 */
+    "KC Technology Inc." "\0"  /* 6637 */
+    "Newlogic" "\0"  /* 6656 */
+    "Transilica, Inc." "\0"  /* 6665 */
+    "Rohde & Schwarz GmbH & Co. KG" "\0"  /* 6682 */
+    "TTPCom Limited" "\0"  /* 6712 */
+    "Signia Technologies, Inc." "\0"  /* 6727 */
+    "Conexant Systems Inc." "\0"  /* 6753 */
+    "Qualcomm" "\0"  /* 6775 */
+    "Inventel" "\0"  /* 6784 */
+    "AVM Berlin" "\0"  /* 6793 */
+    "BandSpeed, Inc." "\0"  /* 6804 */
+    "Mansella Ltd" "\0"  /* 6820 */
+    "NEC Corporation" "\0"  /* 6833 */
+    "WavePlus Technology Co., Ltd." "\0"  /* 6849 */
+    "Alcatel" "\0"  /* 6879 */
+    "NXP B.V." "\0"  /* 6887 */
+    "C Technologies" "\0"  /* 6896 */
+    "Open Interface" "\0"  /* 6911 */
+    "R F Micro Devices" "\0"  /* 6926 */
+    "Hitachi Ltd" "\0"  /* 6944 */
+    "Symbol Technologies, Inc." "\0"  /* 6956 */
+    "Tenovis" "\0"  /* 6982 */
+    "Macronix International Co. Ltd." "\0"  /* 6990 */
+    "GCT Semiconductor" "\0"  /* 7022 */
+    "Norwood Systems" "\0"  /* 7040 */
+    "MewTel Technology Inc." "\0"  /* 7056 */
+    "ST Microelectronics" "\0"  /* 7079 */
+    "Synopsys, Inc." "\0"  /* 7099 */
+    "MediaTek, Inc." "\0"  /* 7114 */
+    "Bluegiga" "\0"  /* 7129 */
+    "Marvell Technology Group Ltd." "\0"  /* 7138 */
+    "Apple, Inc." "\0"  /* 7168 */
+    "Harman International Industries, Inc." "\0"  /* 7180 */
+    "Nordic Semiconductor ASA" "\0"  /* 7218 */
+    "Realtek Semiconductor Corporation" "\0"  /* 7243 */
+    "HP, Inc." "\0"  /* 7277 */
+    "Polar Electro OY" "\0"  /* 7286 */
+    "Samsung Electronics Co. Ltd." "\0"  /* 7303 */
+    "Nike, Inc." "\0"  /* 7332 */
+    "Garmin International, Inc." "\0"  /* 7343 */
+    "Bose Corporation" "\0"  /* 7370 */
+    "LG Electronics" "\0"  /* 7387 */
+    "Qualcomm Technologies, Inc." "\0"  /* 7402 */
+    "Google" "\0"  /* 7430 */
+    "Sony Corporation" "\0"  /* 7437 */
+    "Cypress Semiconductor" "\0"  /* 7454 */
+    "Anhui Huami Information Technology Co., Ltd." "\0"  /* 7476 */
+    "Logitech International SA" "\0"  /* 7521 */
+    "Espressif Systems (Shanghai) Co., Ltd." "\0"  /* 7547 */
+    "Xiaomi Inc." "\0"  /* 7586 */
+    "Ruuvi Innovations Ltd." "\0"  /* 7598 */
+    "Tile, Inc.";  /* 7621 */
+
+static const bt_uuid bt_uuids_service_class[BT_UUID_SERVICE_CLASS_COUNT] = {
+    {0x1000, bt_uuid_names + 0},
+    {0x1001, bt_uuid_names + 37},
+    {0x1101, bt_uuid_names + 73},
+    {0x1102, bt_uuid_names + 84},
+    {0x1103, bt_uuid_names + 102},
+    {0x1104, bt_uuid_names + 119},
+    {0x1105, bt_uuid_names + 128},
+    {0x1106, bt_uuid_names + 143},
+    {0x1107, bt_uuid_names + 160},
+    {0x1108, bt_uuid_names + 176},
+    {0x1109, bt_uuid_names + 184},
+    {0x110A, bt_uuid_names + 202},
+    {0x110B, bt_uuid_names + 214},
+    {0x110C, bt_uuid_names + 224},
+    {0x110D, bt_uuid_names + 248},
+    {0x110E, bt_uuid_names + 274},
+    {0x110F, bt_uuid_names + 292},
+    {0x1110, bt_uuid_names + 320},
+    {0x1111, bt_uuid_names + 329},
+    {0x1112, bt_uuid_names + 333},
+    {0x1113, bt_uuid_names + 357},
+    {0x1114, bt_uuid_names + 361},
+    {0x1115, bt_uuid_names + 372},
+    {0x1116, bt_uuid_names + 377},
+    {0x1117, bt_uuid_names + 381},
+    {0x1118, bt_uuid_names + 384},
+    {0x1119, bt_uuid_names + 399},
+    {0x111A, bt_uuid_names + 417},
+    {0x111B, bt_uuid_names + 439},
+    {0x111C, bt_uuid_names + 456},
+    {0x111D, bt_uuid_names + 480},
+    {0x111E, bt_uuid_names + 505},
+    {0x111F, bt_uuid_names + 515},
+    {0x1120, bt_uuid_names + 537},
+    {0x1121, bt_uuid_names + 575},
+    {0x1122, bt_uuid_names + 587},
+    {0x1123, bt_uuid_names + 601},
+    {0x1124, bt_uuid_names + 616},
+    {0x1125, bt_uuid_names + 644},
+    {0x1126, bt_uuid_names + 669},
+    {0x1127, bt_uuid_names + 679},
+    {0x1128, bt_uuid_names + 688},
+    {0x112D, bt_uuid_names + 707},
+    {0x112E, bt_uuid_names + 718},
+    {0x112F, bt_uuid_names + 741},
+    {0x1130, bt_uuid_names + 764},
+    {0x1131, bt_uuid_names + 781},
+    {0x1132, bt_uuid_names + 794},
+    {0x1133, bt_uuid_names + 816},
+    {0x1134, bt_uuid_names + 844},
+    {0x1135, bt_uuid_names + 867},
+    {0x1136, bt_uuid_names + 872},
+    {0x1137, bt_uuid_names + 884},
+    {0x1138, bt_uuid_names + 895},
+    {0x1139, bt_uuid_names + 906},
+    {0x113A, bt_uuid_names + 925},
+    {0x113B, bt_uuid_names + 937},
+    {0x113C, bt_uuid_names + 944},
+    {0x113D, bt_uuid_names + 963},
+    {0x113E, bt_uuid_names + 988},
+    {0x1200, bt_uuid_names + 1000},
+    {0x1201, bt_uuid_names + 1015},
+    {0x1202, bt_uuid_names + 1033},
+    {0x1203, bt_uuid_names + 1053},
+    {0x1204, bt_uuid_names + 1066},
+    {0x1205, bt_uuid_names + 1083},
+    {0x1206, bt_uuid_names + 1096},
+    {0x1300, bt_uuid_names + 1112},
+    {0x1301, bt_uuid_names + 1129},
+    {0x1302, bt_uuid_names + 1146},
+    {0x1303, bt_uuid_names + 1162},
+    {0x1304, bt_uuid_names + 1174},
+    {0x1305, bt_uuid_names + 1184},
+    {0x1400, bt_uuid_names + 1202},
+    {0x1401, bt_uuid_names + 1206},
+    {0x1402, bt_uuid_names + 1217},
+};
+
+static const bt_uuid bt_uuids_gatt_service[BT_UUID_GATT_SERVICE_COUNT] = {
+    {0x1800, bt_uuid_names + 1226},
+    {0x1801, bt_uuid_names + 1230},
+    {0x1802, bt_uuid_names + 1235},
+    {0x1803, bt_uuid_names + 1251},
+    {0x1804, bt_uuid_names + 1261},
+    {0x1805, bt_uuid_names + 1270},
+    {0x1806, bt_uuid_names + 1283},
+    {0x1807, bt_uuid_names + 1305},
+    {0x1808, bt_uuid_names + 1321},
+    {0x1809, bt_uuid_names + 1329},
+    {0x180A, bt_uuid_names + 1348},
+    {0x180D, bt_uuid_names + 1367},
+    {0x180E, bt_uuid_names + 1378},
+    {0x180F, bt_uuid_names + 1397},
+    {0x1810, bt_uuid_names + 1405},
+    {0x1811, bt_uuid_names + 1420},
+    {0x1812, bt_uuid_names + 1439},
+    {0x1813, bt_uuid_names + 1462},
+    {0x1814, bt_uuid_names + 1478},
+    {0x1815, bt_uuid_names + 1504},
+    {0x1816, bt_uuid_names + 1518},
+    {0x1818, bt_uuid_names + 1544},
+    {0x1819, bt_uuid_names + 1558},
+    {0x181A, bt_uuid_names + 1582},
+    {0x181B, bt_uuid_names + 1604},
+    {0x181C, bt_uuid_names + 1621},
+    {0x181D, bt_uuid_names + 1631},
+    {0x181E, bt_uuid_names + 1644},
+    {0x181F, bt_uuid_names + 1660},
+    {0x1820, bt_uuid_names + 1690},
+    {0x1821, bt_uuid_names + 1716},
+    {0x1822, bt_uuid_names + 1735},
+    {0x1823, bt_uuid_names + 1750},
+    {0x1824, bt_uuid_names + 1761},
+    {0x1825, bt_uuid_names + 1781},
+    {0x1826, bt_uuid_names + 1797},
+    {0x1827, bt_uuid_names + 1813},
+    {0x1828, bt_uuid_names + 1831},
+    {0x1829, bt_uuid_names + 1842},
+    {0x183A, bt_uuid_names + 1869},
+    {0x183B, bt_uuid_names + 1886},
+    {0x183C, bt_uuid_names + 1900},
+    {0x183E, bt_uuid_names + 1924},
+    {0x1843, bt_uuid_names + 1950},
+    {0x1844, bt_uuid_names + 1970},
+    {0x1845, bt_uuid_names + 1985},
+    {0x1846, bt_uuid_names + 2007},
+    {0x1847, bt_uuid_names + 2038},
+    {0x1848, bt_uuid_names + 2050},
+    {0x1849, bt_uuid_names + 2064},
+    {0x184A, bt_uuid_names + 2086},
+    {0x184B, bt_uuid_names + 2110},
+    {0x184C, bt_uuid_names + 2127},
+    {0x184D, bt_uuid_names + 2152},
+    {0x184E, bt_uuid_names + 2171},
+    {0x184F, bt_uuid_names + 2192},
+    {0x1850, bt_uuid_names + 2213},
+    {0x1851, bt_uuid_names + 2242},
+    {0x1852, bt_uuid_names + 2267},
+    {0x1853, bt_uuid_names + 2296},
+    {0x1854, bt_uuid_names + 2309},
+    {0x1855, bt_uuid_names + 2324},
+    {0x1856, bt_uuid_names + 2350},
+};
+
+static const bt_uuid bt_uuids_characteristic[BT_UUID_CHARACTERISTIC_COUNT] = {
+    {0x2A00, bt_uuid_names + 2380},
+    {0x2A01, bt_uuid_names + 2392},
+    {0x2A02, bt_uuid_names + 2403},
+    {0x2A03, bt_uuid_names + 2427},
+    {0x2A04, bt_uuid_names + 2448},
+    {0x2A05, bt_uuid_names + 2491},
+    {0x2A06, bt_uuid_names + 2507},
+    {0x2A07, bt_uuid_names + 2519},
+    {0x2A08, bt_uuid_names + 2534},
+    {0x2A09, bt_uuid_names + 2544},
+    {0x2A0A, bt_uuid_names + 2556},
+    {0x2A0C, bt_uuid_names + 2570},
+    {0x2A0D, bt_uuid_names + 2585},
+    {0x2A0E, bt_uuid_names + 2596},
+    {0x2A0F, bt_uuid_names + 2606},
+    {0x2A11, bt_uuid_names + 2629},
+    {0x2A12, bt_uuid_names + 2643},
+    {0x2A13, bt_uuid_names + 2657},
+    {0x2A14, bt_uuid_names + 2669},
+    {0x2A16, bt_uuid_names + 2696},
+    {0x2A17, bt_uuid_names + 2722},
+    {0x2A18, bt_uuid_names + 2740},
+    {0x2A19, bt_uuid_names + 2760},
+    {0x2A1C, bt_uuid_names + 2774},
+    {0x2A1D, bt_uuid_names + 2798},
+    {0x2A1E, bt_uuid_names + 2815},
+    {0x2A21, bt_uuid_names + 2840},
+    {0x2A22, bt_uuid_names + 2861},
+    {0x2A23, bt_uuid_names + 2888},
+    {0x2A24, bt_uuid_names + 2898},
+    {0x2A25, bt_uuid_names + 2918},
+    {0x2A26, bt_uuid_names + 2939},
+    {0x2A27, bt_uuid_names + 2964},
+    {0x2A28, bt_uuid_names + 2989},
+    {0x2A29, bt_uuid_names + 3014},
+    {0x2A2A, bt_uuid_names + 3039},
+    {0x2A2B, bt_uuid_names + 1270},
+    {0x2A2C, bt_uuid_names + 3091},
+    {0x2A31, bt_uuid_names + 3112},
+    {0x2A32, bt_uuid_names + 3125},
+    {0x2A33, bt_uuid_names + 3153},
+    {0x2A34, bt_uuid_names + 3177},
+    {0x2A35, bt_uuid_names + 3205},
+    {0x2A36, bt_uuid_names + 3232},
+    {0x2A37, bt_uuid_names + 3259},
+    {0x2A38, bt_uuid_names + 3282},
+    {0x2A39, bt_uuid_names + 3303},
+    {0x2A3F, bt_uuid_names + 3328},
+    {0x2A40, bt_uuid_names + 3341},
+    {0x2A41, bt_uuid_names + 3362},
+    {0x2A42, bt_uuid_names + 3377},
+    {0x2A43, bt_uuid_names + 3404},
+    {0x2A44, bt_uuid_names + 3422},
+    {0x2A45, bt_uuid_names + 3455},
+    {0x2A46, bt_uuid_names + 3475},
+    {0x2A47, bt_uuid_names + 3485},
+    {0x2A48, bt_uuid_names + 3514},
+    {0x2A49, bt_uuid_names + 3546},
+    {0x2A4A, bt_uuid_names + 3569},
+    {0x2A4B, bt_uuid_names + 3585},
+    {0x2A4C, bt_uuid_names + 3596},
+    {0x2A4D, bt_uuid_names + 3614},
+    {0x2A4E, bt_uuid_names + 3621},
+    {0x2A4F, bt_uuid_names + 3635},
+    {0x2A50, bt_uuid_names + 3656},
+    {0x2A51, bt_uuid_names + 3663},
+    {0x2A52, bt_uuid_names + 3679},
+    {0x2A53, bt_uuid_names + 3707},
+    {0x2A54, bt_uuid_names + 3723},
+    {0x2A55, bt_uuid_names + 3735},
+    {0x2A5A, bt_uuid_names + 3752},
+    {0x2A5B, bt_uuid_names + 3762},
+    {0x2A5C, bt_uuid_names + 3778},
+    {0x2A5D, bt_uuid_names + 3790},
+    {0x2A5E, bt_uuid_names + 3806},
+    {0x2A5F, bt_uuid_names + 3833},
+    {0x2A60, bt_uuid_names + 3860},
+    {0x2A63, bt_uuid_names + 3873},
+    {0x2A64, bt_uuid_names + 3899},
+    {0x2A65, bt_uuid_names + 3920},
+    {0x2A66, bt_uuid_names + 3942},
+    {0x2A67, bt_uuid_names + 3970},
+    {0x2A68, bt_uuid_names + 3989},
+    {0x2A69, bt_uuid_names + 4000},
+    {0x2A6A, bt_uuid_names + 4017},
+    {0x2A6B, bt_uuid_names + 4028},
+    {0x2A6C, bt_uuid_names + 4045},
+    {0x2A6D, bt_uuid_names + 4055},
+    {0x2A6E, bt_uuid_names + 4064},
+    {0x2A6F, bt_uuid_names + 4076},
+    {0x2A70, bt_uuid_names + 4085},
+    {0x2A71, bt_uuid_names + 4101},
+    {0x2A72, bt_uuid_names + 4121},
+    {0x2A73, bt_uuid_names + 4141},
+    {0x2A74, bt_uuid_names + 4165},
+    {0x2A75, bt_uuid_names + 4177},
+    {0x2A76, bt_uuid_names + 4198},
+    {0x2A77, bt_uuid_names + 4207},
+    {0x2A78, bt_uuid_names + 4218},
+    {0x2A79, bt_uuid_names + 4227},
+    {0x2A7A, bt_uuid_names + 4238},
+    {0x2A7B, bt_uuid_names + 4249},
+    {0x2A7D, bt_uuid_names + 4259},
+    {0x2A7E, bt_uuid_names + 4284},
+    {0x2A7F, bt_uuid_names + 4315},
+    {0x2A80, bt_uuid_names + 4333},
+    {0x2A81, bt_uuid_names + 4337},
+    {0x2A82, bt_uuid_names + 4370},
+    {0x2A83, bt_uuid_names + 4403},
+    {0x2A84, bt_uuid_names + 4423},
+    {0x2A85, bt_uuid_names + 4454},
+    {0x2A86, bt_uuid_names + 4468},
+    {0x2A87, bt_uuid_names + 4497},
+    {0x2A88, bt_uuid_names + 4511},
+    {0x2A89, bt_uuid_names + 4543},
+    {0x2A8A, bt_uuid_names + 4575},
+    {0x2A8B, bt_uuid_names + 4586},
+    {0x2A8C, bt_uuid_names + 4614},
+    {0x2A8D, bt_uuid_names + 4621},
+    {0x2A8E, bt_uuid_names + 4636},
+    {0x2A8F, bt_uuid_names + 4643},
+    {0x2A90, bt_uuid_names + 4661},
+    {0x2A91, bt_uuid_names + 4671},
+    {0x2A92, bt_uuid_names + 4702},
+    {0x2A93, bt_uuid_names + 4721},
+    {0x2A94, bt_uuid_names + 4769},
+    {0x2A95, bt_uuid_names + 4798},
+    {0x2A96, bt_uuid_names + 4825},
+    {0x2A97, bt_uuid_names + 4833},
+    {0x2A98, bt_uuid_names + 4853},
+    {0x2A99, bt_uuid_names + 4860},
+    {0x2A9A, bt_uuid_names + 4886},
+    {0x2A9B, bt_uuid_names + 4897},
+    {0x2A9C, bt_uuid_names + 4922},
+    {0x2A9D, bt_uuid_names + 4951},
+    {0x2A9E, bt_uuid_names + 4970},
+    {0x2A9F, bt_uuid_names + 4991},
+    {0x2AA0, bt_uuid_names + 5010},
+    {0x2AA1, bt_uuid_names + 5037},
+    {0x2AA2, bt_uuid_names + 5064},
+    {0x2AA3, bt_uuid_names + 5073},
+    {0x2AA4, bt_uuid_names + 5099},
+    {0x2AA5, bt_uuid_names + 5129},
+    {0x2AA6, bt_uuid_names + 5153},
+    {0x2AA7, bt_uuid_names + 5180},
+    {0x2AA8, bt_uuid_names + 5196},
+    {0x2AA9, bt_uuid_names + 5208},
+    {0x2AAA, bt_uuid_names + 5219},
+    {0x2AAB, bt_uuid_names + 5242},
+    {0x2AAC, bt_uuid_names + 5263},
+    {0x2AAD, bt_uuid_names + 5294},
+    {0x2AAE, bt_uuid_names + 5327},
+    {0x2AAF, bt_uuid_names + 5336},
+    {0x2AB0, bt_uuid_names + 5346},
+    {0x2AB1, bt_uuid_names + 5369},
+    {0x2AB2, bt_uuid_names + 5391},
+    {0x2AB3, bt_uuid_names + 5404},
+    {0x2AB4, bt_uuid_names + 5413},
+    {0x2AB5, bt_uuid_names + 5425},
+    {0x2AB6, bt_uuid_names + 5439},
+    {0x2AB7, bt_uuid_names + 5443},
+    {0x2AB8, bt_uuid_names + 5456},
+    {0x2AB9, bt_uuid_names + 5473},
+    {0x2ABA, bt_uuid_names + 5490},
+    {0x2ABB, bt_uuid_names + 5509},
+    {0x2ABC, bt_uuid_names + 5524},
+    {0x2ABD, bt_uuid_names + 5542},
+    {0x2ABE, bt_uuid_names + 5554},
+    {0x2ABF, bt_uuid_names + 5566},
+    {0x2AC0, bt_uuid_names + 5578},
+    {0x2AC1, bt_uuid_names + 5590},
+    {0x2AC2, bt_uuid_names + 5611},
+    {0x2AC3, bt_uuid_names + 5632},
+    {0x2AC4, bt_uuid_names + 5642},
+    {0x2AC5, bt_uuid_names + 5660},
+    {0x2AC6, bt_uuid_names + 5688},
+    {0x2AC7, bt_uuid_names + 5714},
+    {0x2AC8, bt_uuid_names + 5733},
+    {0x2AC9, bt_uuid_names + 5748},
+    {0x2ACC, bt_uuid_names + 5780},
+    {0x2ACD, bt_uuid_names + 5804},
+    {0x2ACE, bt_uuid_names + 5819},
+    {0x2ACF, bt_uuid_names + 5838},
+    {0x2AD0, bt_uuid_names + 5856},
+    {0x2AD1, bt_uuid_names + 5875},
+    {0x2AD2, bt_uuid_names + 5886},
+    {0x2AD3, bt_uuid_names + 5903},
+    {0x2AD4, bt_uuid_names + 5919},
+    {0x2AD5, bt_uuid_names + 5941},
+    {0x2AD6, bt_uuid_names + 5969},
+    {0x2AD7, bt_uuid_names + 6002},
+    {0x2AD8, bt_uuid_names + 6029},
+    {0x2AD9, bt_uuid_names + 6051},
+    {0x2ADA, bt_uuid_names + 6081},
+    {0x2ADB, bt_uuid_names + 6104},
+    {0x2ADC, bt_uuid_names + 6130},
+    {0x2ADD, bt_uuid_names + 6157},
+    {0x2ADE, bt_uuid_names + 6176},
+    {0x2B29, bt_uuid_names + 6196},
+    {0x2B2A, bt_uuid_names + 6222},
+    {0x2B3A, bt_uuid_names + 6236},
+};
+
+static const bt_uuid bt_uuids_company[BT_UUID_COMPANY_COUNT] = {
+    {0x0000, bt_uuid_names + 6262},
+    {0x0001, bt_uuid_names + 6274},
+    {0x0002, bt_uuid_names + 6294},
+    {0x0003, bt_uuid_names + 6306},
+    {0x0004, bt_uuid_names + 6316},
+    {0x0005, bt_uuid_names + 6330},
+    {0x0006, bt_uuid_names + 6335},
+    {0x0007, bt_uuid_names + 6345},
+    {0x0008, bt_uuid_names + 6352},
+    {0x0009, bt_uuid_names + 6361},
+    {0x000A, bt_uuid_names + 6386},
+    {0x000B, bt_uuid_names + 6435},
+    {0x000C, bt_uuid_names + 6448},
+    {0x000D, bt_uuid_names + 6463},
+    {0x000E, bt_uuid_names + 6486},
+    {0x000F, bt_uuid_names + 6512},
+    {0x0010, bt_uuid_names + 6533},
+    {0x0011, bt_uuid_names + 6553},
+    {0x0012, bt_uuid_names + 6567},
+    {0x0013, bt_uuid_names + 6579},
+    {0x0014, bt_uuid_names + 6597},
+    {0x0015, bt_uuid_names + 6629},
+    {0x0016, bt_uuid_names + 6637},
+    {0x0017, bt_uuid_names + 6656},
+    {0x0018, bt_uuid_names + 6665},
+    {0x0019, bt_uuid_names + 6682},
+    {0x001A, bt_uuid_names + 6712},
+    {0x001B, bt_uuid_names + 6727},
+    {0x001C, bt_uuid_names + 6753},
+    {0x001D, bt_uuid_names + 6775},
+    {0x001E, bt_uuid_names + 6784},
+    {0x001F, bt_uuid_names + 6793},
+    {0x0020, bt_uuid_names + 6804},
+    {0x0021, bt_uuid_names + 6820},
+    {0x0022, bt_uuid_names + 6833},
+    {0x0023, bt_uuid_names + 6849},
+    {0x0024, bt_uuid_names + 6879},
+    {0x0025, bt_uuid_names + 6887},
+    {0x0026, bt_uuid_names + 6896},
+    {0x0027, bt_uuid_names + 6911},
+    {0x0028, bt_uuid_names + 6926},
+    {0x0029, bt_uuid_names + 6944},
+    {0x002A, bt_uuid_names + 6956},
+    {0x002B, bt_uuid_names + 6982},
+    {0x002C, bt_uuid_names + 6990},
+    {0x002D, bt_uuid_names + 7022},
+    {0x002E, bt_uuid_names + 7040},
+    {0x002F, bt_uuid_names + 7056},
+    {0x0030, bt_uuid_names + 7079},
+    {0x0031, bt_uuid_names + 7099},
+    {0x0046, bt_uuid_names + 7114},
+    {0x0047, bt_uuid_names + 7129},
+    {0x0048, bt_uuid_names + 7138},
+    {0x004C, bt_uuid_names + 7168},
+    {0x0057, bt_uuid_names + 7180},
+    {0x0059, bt_uuid_names + 7218},
+    {0x005D, bt_uuid_names + 7243},
+    {0x0065, bt_uuid_names + 7277},
+    {0x006B, bt_uuid_names + 7286},
+    {0x0075, bt_uuid_names + 7303},
+    {0x0078, bt_uuid_names + 7332},
+    {0x0087, bt_uuid_names + 7343},
+    {0x009E, bt_uuid_names + 7370},
+    {0x00C4, bt_uuid_names + 7387},
+    {0x00D7, bt_uuid_names + 7402},
+    {0x00E0, bt_uuid_names + 7430},
+    {0x012D, bt_uuid_names + 7437},
+    {0x0131, bt_uuid_names + 7454},
+    {0x0157, bt_uuid_names + 7476},
+    {0x01DA, bt_uuid_names + 7521},
+    {0x02E5, bt_uuid_names + 7547},
+    {0x038F, bt_uuid_names + 7586},
+    {0x0499, bt_uuid_names + 7598},
+    {0x067C, bt_uuid_names + 7621},
+};
+
+static const bt_uuid *const bt_uuid_tables[BT_UUID_TABLE_COUNT] = {
+    bt_uuids_service_class,
+    bt_uuids_gatt_service,
+    bt_uuids_characteristic,
+    bt_uuids_company,
+};
+static const uint16_t bt_uuid_table_counts[BT_UUID_TABLE_COUNT] = {
+    BT_UUID_SERVICE_CLASS_COUNT,
+    BT_UUID_GATT_SERVICE_COUNT,
+    BT_UUID_CHARACTERISTIC_COUNT,
+    BT_UUID_COMPANY_COUNT,
+};
+
+/** Binary search `table` for `uuid16`. Returns NULL if it isn't there */
+const bt_uuid *bt_uuid_lookup(BtUuidTable table, uint16_t uuid16) {
+    if (table >= BT_UUID_TABLE_COUNT) {
+        return NULL;
+    }
+    const bt_uuid *entries = bt_uuid_tables[table];
+    uint16_t low = 0;
+    uint16_t high = bt_uuid_table_counts[table];
+    while (low < high) {
+        uint16_t mid = low + ((high - low) / 2);
+        if (entries[mid].uuid16 == uuid16) {
+            return &(entries[mid]);
+        } else if (entries[mid].uuid16 < uuid16) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return NULL;
+}
+
+#else
+
+const bt_uuid *bt_uuid_lookup(BtUuidTable table, uint16_t uuid16) {
+    (void)table;
+    (void)uuid16;
+    return NULL;
+}
+
+#endif
@@ -0,0 +1,30 @@
+/* Generated by esp32/generate_uuids.py from the Bluetooth SIG's assigned numbers.
+ * Do not edit - Add or update the YAML in esp32/ and run the script.
+ */
+#ifndef WENDIGO_BT_UUIDS_H
+#define WENDIGO_BT_UUIDS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/time.h>
+
+#include <esp_bt_defs.h>
+#include "wendigo_common_defs.h"
+
+typedef enum {
+    BT_UUID_TABLE_SERVICE_CLASS = 0,       /* Service classes */
+    BT_UUID_TABLE_GATT_SERVICE,            /* GATT services */
+    BT_UUID_TABLE_CHARACTERISTIC,          /* GATT characteristics */
+    BT_UUID_TABLE_COMPANY,                 /* Company identifiers */
+    BT_UUID_TABLE_COUNT
+} BtUuidTable;
+
+/* Entries in each table when UUID decoding is compiled in (CONFIG_DECODE_UUIDS) */
+#define BT_UUID_SERVICE_CLASS_COUNT        (76)
+#define BT_UUID_GATT_SERVICE_COUNT         (63)
+#define BT_UUID_CHARACTERISTIC_COUNT       (201)
+#define BT_UUID_COMPANY_COUNT              (74)
+
+const bt_uuid *bt_uuid_lookup(BtUuidTable table, uint16_t uuid16);
+
+#endif
@@ -1,4 +1,14 @@
 #include "common.h"
+#include "radio_sched.h"
+
+/* Globals for state management */
+const char *TAG = "WENDIGO";
+ActionType scanStatus[DEF_SCAN_COUNT] = { ACTION_DISABLE, ACTION_DISABLE, ACTION_DISABLE, ACTION_DISABLE, ACTION_DISABLE, ACTION_DISABLE };
+char *syntaxTip[DEF_SCAN_COUNT] = { "H[CI]", "B[LE]", "W[IFI]", "W[IFI]", "I[NTERACTIVE]", "T[AG] ( B[T] | W[IFI] ) <MAC>", "F[OCUS]" };
+char *radioShortNames[DEF_SCAN_COUNT] = { "HCI", "BLE", "WiFi AP", "WiFi STA", "Interactive", "Tag", "Focus" };
+char *radioFullNames[DEF_SCAN_COUNT] = { "Bluetooth Classic", "Bluetooth Low Energy", "WiFi Access Point", "WiFi Station", "Interactive Mode", "Tag Devices", "Focus Mode" };
+/* Mutex to keep UART packets from being interleaved */
+SemaphoreHandle_t uartMutex;
 
 /* Storage to maintain a cache of recently-displayed devices */
 uint16_t devices_count = 0;
@@ -8,11 +18,11 @@ wendigo_device *devices;
 /** Banner width when in interactive mode */
 uint8_t BANNER_WIDTH = 62;
 
-/** Retrieve the specified MAC address. mac[] must be an initialised
- * byte array of length MAC_BYTES (6).
+/** Retrieve the specified MAC address into mac[], a byte array of length
+ * MAC_BYTES (6).
  */
 esp_err_t wendigo_get_mac(WendigoMAC type, uint8_t mac[MAC_BYTES]) {
-    if (type == WENDIGO_MACS_COUNT || !memcmp(mac, nullMac, MAC_BYTES)) {
+    if (type == WENDIGO_MACS_COUNT || mac == NULL) {
         ESP_LOGE(TAG, "wendigo_get_mac() called with invalid arguments.");
         return ESP_ERR_INVALID_ARG;
     }
@@ -68,43 +78,33 @@ esp_err_t wendigo_set_mac(WendigoMAC type, uint8_t mac[MAC_BYTES]) {
  * * Terminator (4 bytes)
  */
 esp_err_t wendigo_display_mac_uart(uint8_t wifi[MAC_BYTES], uint8_t bda[MAC_BYTES]) {
-    uint8_t packet_len = WENDIGO_OFFSET_MAC_TERMINATOR + PREAMBLE_LEN + 1;
-    uint8_t *packet = malloc(packet_len);
-    if (packet == NULL) {
-        return outOfMemory();
-    }
     uint8_t supported = wendigo_supported_features();
-    /* Count the number of interfaces supported by this chip */
-    uint8_t supportedCount = 0;
-    if ((supported & HW_BT_SUPPORTED) != 0) {
-        ++supportedCount;
-    }
-    if ((supported & HW_WIFI_SUPPORTED) != 0) {
-        ++supportedCount;
-    }
+    /* Collect the interfaces supported by this chip - There might be one or
+     * two MACs to send. */
+    uint8_t types[2];
+    uint8_t *macs[2];
+    wendigo_pkt_mac pkt = {.if_count = 0, .interfaces_types = types, .interfaces = macs};
     // TODO: Include base MAC later
-    memcpy(packet, PREAMBLE_MAC, PREAMBLE_LEN);
-    packet[WENDIGO_OFFSET_MAC_IF_COUNT] = supportedCount;
-    /* Set up an offset to step through the rest of the packet because we might
-     * have one or two MACs to send. */
-    uint8_t offset = WENDIGO_OFFSET_MAC_IF_COUNT + 1;
     /* Is Bluetooth supported? */
     if ((supported & HW_BT_SUPPORTED) != 0) {
-        packet[offset++] = (uint8_t)WENDIGO_MAC_BLUETOOTH;
-        memcpy(packet + offset, bda, MAC_BYTES);
-        offset += MAC_BYTES;
+        types[pkt.if_count] = (uint8_t)WENDIGO_MAC_BLUETOOTH;
+        macs[pkt.if_count++] = bda;
     }
     /* Is WiFi supported? */
     if ((supported & HW_WIFI_SUPPORTED) != 0) {
-        packet[offset++] = (uint8_t)WENDIGO_MAC_WIFI;
-        memcpy(packet + offset, wifi, MAC_BYTES);
-        offset += MAC_BYTES;
+        types[pkt.if_count] = (uint8_t)WENDIGO_MAC_WIFI;
+        macs[pkt.if_count++] = wifi;
+    }
+    uint16_t packet_len = wendigo_pkt_mac_size(&pkt);
+    uint8_t *packet = malloc(packet_len);
+    if (packet == NULL) {
+        return outOfMemory();
     }
-    memcpy(packet + offset, PACKET_TERM, PREAMBLE_LEN);
+    wendigo_pkt_mac_encode(&pkt, packet, packet_len);
     /* Send the packet */
     esp_err_t result = ESP_OK;
     if (xSemaphoreTake(uartMutex, portMAX_DELAY)) {
-        send_bytes(packet, offset + PREAMBLE_LEN);
+        send_bytes(packet, packet_len);
         xSemaphoreGive(uartMutex);
     } else {
         result = ESP_ERR_INVALID_STATE;
@@ -195,6 +195,18 @@ wendigo_device *retrieve_by_mac(esp_bd_addr_t mac) {
     return retrieve_device(&dev);
 }
 
+/** Returns the index into devices[] of `dev`, which must be a pointer into
+ *  devices[] such as retrieve_device() returns, or devices_count if it isn't.
+ *  Devices are never removed from devices[], so an index identifies a device
+ *  for as long as ESP32-Wendigo runs.
+ */
+uint16_t wendigo_device_index(wendigo_device *dev) {
+    if (dev == NULL || devices == NULL || dev < devices || dev >= devices + devices_count) {
+        return devices_count;
+    }
+    return (uint16_t)(dev - devices);
+}
+
 /** Check whether the provided wendigo_device is present in the specified array of
  * wendigo_device* objects. Matching is based on the device's MAC (i.e. dev->mac).
  * Returns the index of the matching device, or array_len if not found.
@@ -280,6 +292,43 @@ wendigo_device *wendigo_new_ap(uint8_t *mac) {
     return result;
 }
 
+/** Copy the services in `src` into `dest`, overwriting whatever `dest` held.
+ *  Elements of known_services[] point into the UUID tables in flash, so only
+ *  the array of pointers is duplicated. */
+static esp_err_t copy_bt_services(wendigo_bt_svc *dest, wendigo_bt_svc *src) {
+    esp_err_t result = ESP_OK;
+    memset(dest, 0, sizeof(wendigo_bt_svc));
+    if (src->num_services > 0 && src->service_uuids != NULL) {
+        dest->service_uuids = malloc(sizeof(esp_bt_uuid_t) * src->num_services);
+        if (dest->service_uuids == NULL) {
+            result = outOfMemory();
+        } else {
+            memcpy(dest->service_uuids, src->service_uuids, sizeof(esp_bt_uuid_t) * src->num_services);
+            dest->num_services = src->num_services;
+        }
+    }
+    if (src->known_services_len > 0 && src->known_services != NULL) {
+        dest->known_services = malloc(sizeof(const bt_uuid *) * src->known_services_len);
+        if (dest->known_services == NULL) {
+            result = outOfMemory();
+        } else {
+            memcpy(dest->known_services, src->known_services, sizeof(const bt_uuid *) * src->known_services_len);
+            dest->known_services_len = src->known_services_len;
+        }
+    }
+    return result;
+}
+
+static void free_bt_services(wendigo_bt_svc *svc) {
+    if (svc->num_services > 0 && svc->service_uuids != NULL) {
+        free(svc->service_uuids);
+    }
+    if (svc->known_services_len > 0 && svc->known_services != NULL) {
+        free(svc->known_services);
+    }
+    memset(svc, 0, sizeof(wendigo_bt_svc));
+}
+
 /** Adds the specified device to devices[] if not already present.
  *  Updates the attributes of the specified device in devices[]
  *  if it already exists. */
@@ -287,7 +336,8 @@ esp_err_t add_device(wendigo_device *dev) {
     esp_err_t result = ESP_OK;
     wendigo_device *existingDevice = retrieve_device(dev);
     if (existingDevice == NULL) {
-        /* Device not found - add it to devices[] */
+        /* Device not found - Credit the radio that found it, and add it to devices[] */
+        radio_sched_device_found(dev->scanType);
         if (devices_count == devices_capacity) {
             /* No spare array capacity - malloc more */
             wendigo_device *new_devices = realloc(devices, sizeof(wendigo_device) * (devices_capacity + 10));
@@ -324,29 +374,15 @@ esp_err_t add_device(wendigo_device *dev) {
                         devices[devices_count].radio.bluetooth.eir_len = dev->radio.bluetooth.eir_len;
                     }
                 }
-            } else if (dev->scanType == SCAN_WIFI_AP) {
-                /* Duplicate dev->radio.ap.stations - While its *contents* don't need special
-                   attention because they're pointers to existing devices, the array itself was
-                   declared by - and will be freed by - a separate function. */
-                   devices[devices_count].radio.ap.stations = NULL;
-                   devices[devices_count].radio.ap.stations_count = 0;
-                if (dev->radio.ap.stations != NULL && dev->radio.ap.stations_count > 0) {
-                    devices[devices_count].radio.ap.stations = malloc(sizeof(uint8_t *) * dev->radio.ap.stations_count);
-                    if (devices[devices_count].radio.ap.stations != NULL) {
-                        /* If allocation fails all we need to do is ensure that stations_count is 0 -
-                           linked stations will still be sent to Flipper, we just don't have capacity
-                           to store them. stations_count was initialised to 0 above, so we're only
-                           looking at the success case.
-                        */
-                        for (uint16_t i = 0; i < dev->radio.ap.stations_count; ++i) {
-                            devices[devices_count].radio.ap.stations[i] = malloc(MAC_BYTES);
-                            if (devices[devices_count].radio.ap.stations[i] != NULL) {
-                                memcpy(devices[devices_count].radio.ap.stations[i], dev->radio.ap.stations[i], MAC_BYTES);
-                            }
-                        }
-                        devices[devices_count].radio.ap.stations_count = dev->radio.ap.stations_count;
-                    }
+                if (copy_bt_services(&(devices[devices_count].radio.bluetooth.bt_services),
+                        &(dev->radio.bluetooth.bt_services)) != ESP_OK) {
+                    result = ESP_ERR_NO_MEM;
                 }
+            } else if (dev->scanType == SCAN_WIFI_AP) {
+                /* An AP's stations are kept in the association graph (assoc_graph.h),
+                   not in the device itself */
+                devices[devices_count].radio.ap.stations = NULL;
+                devices[devices_count].radio.ap.stations_count = 0;
             } else if (dev->scanType == SCAN_WIFI_STA) {
                 /* Copy dev->radio.sta.saved_networks[] */
                 if (dev->radio.sta.saved_networks_count == 0) {
@@ -415,52 +451,20 @@ esp_err_t add_device(wendigo_device *dev) {
             }
             if (dev->radio.bluetooth.cod != 0) {
                 existingDevice->radio.bluetooth.cod = dev->radio.bluetooth.cod;
+                existingDevice->radio.bluetooth.cod_major = dev->radio.bluetooth.cod_major;
+                existingDevice->radio.bluetooth.cod_minor = dev->radio.bluetooth.cod_minor;
             }
-            // TODO: Think about whether I should malloc memory for services or use previously-allocated memory
-            //       bt_uuid **known_services will make malloc'ing more difficult
-            // TODO: Decide how to merge services - Should probably be done with a separate function
-        } else if (dev->scanType == SCAN_WIFI_AP) {
-            existingDevice->radio.ap.channel = dev->radio.ap.channel;
-            /* Check whether `dev` contains any stations not in `existingDevice` */
-            if (dev->radio.ap.stations_count > 0) {
-                /* Find stations in `dev` that aren't in `existingDevice` */
-                uint8_t newStations = 0;
-                if (existingDevice->radio.ap.stations_count == 0) {
-                    newStations = dev->radio.ap.stations_count;
-                } else {
-                    for (uint16_t i = 0; i < dev->radio.ap.stations_count; ++i) {
-                        if (wendigo_index_of(dev->radio.ap.stations[i],
-                                existingDevice->radio.ap.stations,
-                                existingDevice->radio.ap.stations_count) ==
-                                existingDevice->radio.ap.stations_count) {
-                            ++newStations;
-                        }
-                    }
-                }
-                if (newStations > 0) {
-                    /* Expand existingDevice's stations[] */
-                    uint8_t **new_stations = realloc(existingDevice->radio.ap.stations,
-                        sizeof(uint8_t *) * (newStations + existingDevice->radio.ap.stations_count));
-                    if (new_stations != NULL) {
-                        /* Successfully resized existingDevice's stations[]. Copy new MACs across */
-                        uint16_t staIdx = existingDevice->radio.ap.stations_count;
-                        for (uint16_t i = 0; i < dev->radio.ap.stations_count; ++i) {
-                            if (wendigo_index_of(dev->radio.ap.stations[i], new_stations,
-                                    existingDevice->radio.ap.stations_count) ==
-                                    existingDevice->radio.ap.stations_count) {
-                                new_stations[staIdx] = malloc(MAC_BYTES);
-                                if (new_stations[staIdx] != NULL) {
-                                    memcpy(new_stations[staIdx], dev->radio.ap.stations[i], MAC_BYTES);
-                                }
-                                ++staIdx;
-                            }
-                        }
-                        /* Copy into place (in case stations[] was moved to find enough contiguous space) */
-                        existingDevice->radio.ap.stations = new_stations;
-                        existingDevice->radio.ap.stations_count += newStations;
-                    }
+            /* Services are replaced rather than merged - An advertisement that lists
+               any services lists all those the device wants to advertise */
+            if (dev->radio.bluetooth.bt_services.num_services > 0) {
+                free_bt_services(&(existingDevice->radio.bluetooth.bt_services));
+                if (copy_bt_services(&(existingDevice->radio.bluetooth.bt_services),
+                        &(dev->radio.bluetooth.bt_services)) != ESP_OK) {
+                    result = ESP_ERR_NO_MEM;
                 }
             }
+        } else if (dev->scanType == SCAN_WIFI_AP) {
+            existingDevice->radio.ap.channel = dev->radio.ap.channel;
             strncpy(existingDevice->radio.ap.ssid, dev->radio.ap.ssid, MAX_SSID_LEN + 1);
             existingDevice->radio.ap.ssid[MAX_SSID_LEN] = '\0';
         } else if (dev->scanType == SCAN_WIFI_STA) {
@@ -516,6 +520,7 @@ esp_err_t free_device(wendigo_device *dev) {
         if (dev->radio.bluetooth.eir_len > 0 && dev->radio.bluetooth.eir != NULL) {
             free(dev->radio.bluetooth.eir);
         }
+        free_bt_services(&(dev->radio.bluetooth.bt_services));
     } else if (dev->scanType == SCAN_WIFI_AP) {
         if (dev->radio.ap.stations != NULL && dev->radio.ap.stations_count > 0) {
             for (uint16_t i = 0; i < dev->radio.ap.stations_count; ++i) {
@@ -638,8 +643,8 @@ void repeat_bytes(uint8_t byte, uint8_t count) {
     }
 }
 
-void send_bytes(uint8_t *bytes, uint8_t size) {
-    for (uint8_t i = 0; i < size; ++i) {
+void send_bytes(uint8_t *bytes, uint16_t size) {
+    for (uint16_t i = 0; i < size; ++i) {
         putc(bytes[i], stdout);
     }
     fflush(stdout);
@@ -52,16 +52,14 @@ typedef enum {
     ACTION_INVALID
 } ActionType;
 
-/* Globals for state management */
-const char *TAG = "WENDIGO";
-ActionType scanStatus[DEF_SCAN_COUNT] = { ACTION_DISABLE, ACTION_DISABLE, ACTION_DISABLE, ACTION_DISABLE, ACTION_DISABLE, ACTION_DISABLE };
-char *syntaxTip[DEF_SCAN_COUNT] = { "H[CI]", "B[LE]", "W[IFI]", "W[IFI]", "I[NTERACTIVE]", "T[AG] ( B[T] | W[IFI] ) <MAC>", "F[OCUS]" };
-char *radioShortNames[DEF_SCAN_COUNT] = { "HCI", "BLE", "WiFi AP", "WiFi STA", "Interactive", "Tag", "Focus" };
-char *radioFullNames[DEF_SCAN_COUNT] = { "Bluetooth Classic", "Bluetooth Low Energy", "WiFi Access Point", "WiFi Station", "Interactive Mode", "Tag Devices", "Focus Mode" };
-uint8_t nullMac[MAC_BYTES] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
-uint8_t broadcastMac[MAC_BYTES] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+/* Globals for state management, defined in common.c */
+extern const char *TAG;
+extern ActionType scanStatus[DEF_SCAN_COUNT];
+extern char *syntaxTip[DEF_SCAN_COUNT];
+extern char *radioShortNames[DEF_SCAN_COUNT];
+extern char *radioFullNames[DEF_SCAN_COUNT];
 /* Mutex to keep UART packets from being interleaved */
-SemaphoreHandle_t uartMutex;
+extern SemaphoreHandle_t uartMutex;
 
 /* Device caches accessible across Wendigo */
 extern uint16_t devices_count;
@@ -90,11 +88,12 @@ void print_row_start(int spaces);
 void print_row_end(int spaces);
 void print_empty_row(int lineLength);
 void repeat_bytes(uint8_t byte, uint8_t count);
-void send_bytes(uint8_t *bytes, uint8_t size);
+void send_bytes(uint8_t *bytes, uint16_t size);
 void send_end_of_packet();
 
 wendigo_device *retrieve_device(wendigo_device *dev);
 wendigo_device *retrieve_by_mac(esp_bd_addr_t bda);
+uint16_t wendigo_device_index(wendigo_device *dev);
 esp_err_t add_device(wendigo_device *dev);
 esp_err_t free_device(wendigo_device *dev);
 uint16_t wendigo_device_index_of(wendigo_device *dev, wendigo_device **array, uint16_t array_len);
@@ -0,0 +1,173 @@
+#include "focus.h"
+#include "pipeline.h"
+#include "esp_timer.h"
+#include "freertos/idf_additions.h"
+#include "portmacro.h"
+
+/* Held while the trackers are used. It's a spinlock rather than a mutex
+   because channel hopping asks where to hop next and mustn't wait; nothing
+   done under it blocks or allocates */
+static portMUX_TYPE focusLock = portMUX_INITIALIZER_UNLOCKED;
+static esp_timer_handle_t focusTimer = NULL;
+
+static esp_err_t display_rssi_interactive(const rssi_track_frame *frame) {
+    /* A line per device heard since the last one - Silence means it wasn't */
+    if (frame->samples == 0) {
+        return ESP_OK;
+    }
+    char mac_str[MAC_STRLEN + 1];
+    mac_bytes_to_string((uint8_t *)frame->mac, mac_str);
+    int16_t tenths = (frame->filtered < 0) ? -frame->filtered : frame->filtered;
+    printf("Focus %s  %s%d.%d dBm  (raw %4d, %u sample%s)\n", mac_str, (frame->filtered < 0) ? "-" : "",
+        tenths / 10, tenths % 10, frame->raw, frame->samples, (frame->samples == 1) ? "" : "s");
+    return ESP_OK;
+}
+
+static esp_err_t display_rssi_uart(const rssi_track_frame *frame) {
+    wendigo_pkt_rssi pkt = {
+        .slot = frame->slot,
+        .filtered = frame->filtered,
+        .raw = frame->raw,
+        .samples = frame->samples,
+    };
+    memcpy(pkt.mac, frame->mac, MAC_BYTES);
+    /* Fixed size, so no need for the heap */
+    uint8_t packet[WENDIGO_PKT_RSSI_MIN_LEN];
+    uint16_t packet_len = wendigo_pkt_rssi_encode(&pkt, packet, sizeof(packet));
+    if (packet_len == 0) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    if (!xSemaphoreTake(uartMutex, portMAX_DELAY)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    send_bytes(packet, packet_len);
+    xSemaphoreGive(uartMutex);
+    return ESP_OK;
+}
+
+/** Display a frame taken by focus_timer_cb(). Runs on the pipeline task on
+ *  dual-core chips, otherwise in the timer callback.
+ */
+static void focus_report_frame(void *data) {
+    const rssi_track_frame *frame = (const rssi_track_frame *)data;
+    if (scanStatus[SCAN_INTERACTIVE] == ACTION_ENABLE) {
+        display_rssi_interactive(frame);
+    } else {
+        display_rssi_uart(frame);
+    }
+}
+
+/** Send a frame for each tracked device. Runs CONFIG_FOCUS_RSSI_RATE_HZ
+ *  times a second while Focus Mode is enabled, so devices' signal strength
+ *  is reported steadily however often they're heard. The frames are sent by
+ *  the pipeline, so the esp_timer task never waits for the UART.
+ */
+static void focus_timer_cb(void *arg) {
+    UNUSED(arg);
+    rssi_track_frame frames[CONFIG_FOCUS_RSSI_MAX_DEVICES];
+    portENTER_CRITICAL(&focusLock);
+    uint8_t count = rssi_track_frames((uint32_t)(esp_timer_get_time() / 1000), frames, CONFIG_FOCUS_RSSI_MAX_DEVICES);
+    portEXIT_CRITICAL(&focusLock);
+    for (uint8_t i = 0; i < count; ++i) {
+        wendigo_pipeline_submit(focus_report_frame, &frames[i], sizeof(rssi_track_frame));
+    }
+}
+
+/** Start or stop tracking the signal strength of tagged devices. Tracking
+ *  starts afresh each time Focus Mode is enabled.
+ */
+esp_err_t wendigo_focus_enable(bool enable) {
+    if (focusTimer == NULL) {
+        const esp_timer_create_args_t focus_timer_args = {
+            .callback = focus_timer_cb,
+            .name = "focus_rssi",
+        };
+        esp_err_t err = esp_timer_create(&focus_timer_args, &focusTimer);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+    if (esp_timer_is_active(focusTimer)) {
+        esp_timer_stop(focusTimer);
+    }
+    portENTER_CRITICAL(&focusLock);
+    rssi_track_reset();
+    focus_hop_reset();
+    portEXIT_CRITICAL(&focusLock);
+    if (enable) {
+        return esp_timer_start_periodic(focusTimer, 1000000 / CONFIG_FOCUS_RSSI_RATE_HZ);
+    }
+    return ESP_OK;
+}
+
+/** Feed a reading of `rssi` from `mac` to its tracker, if Focus Mode is
+ *  enabled and the device is tagged. `channel` is the WiFi channel it was
+ *  heard on, or 0 for Bluetooth devices. Called for every advertisement and
+ *  frame received - before any filtering - so it must be cheap when Focus
+ *  Mode is off.
+ */
+void wendigo_focus_sample(const uint8_t *mac, int16_t rssi, uint8_t channel) {
+    if (scanStatus[SCAN_FOCUS] != ACTION_ENABLE) {
+        return;
+    }
+    wendigo_device *dev = retrieve_by_mac((uint8_t *)mac);
+    if (dev == NULL || !dev->tagged) {
+        return;
+    }
+    uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    portENTER_CRITICAL(&focusLock);
+    rssi_track_sample(mac, rssi, now_ms);
+    focus_hop_heard(mac, channel, now_ms);
+    portEXIT_CRITICAL(&focusLock);
+}
+
+/* A reading waiting for wendigo_focus_sample() on the pipeline task */
+typedef struct focus_capture {
+    uint8_t mac[MAC_BYTES];
+    int16_t rssi;
+    uint8_t channel;
+} focus_capture;
+
+static void focus_sample_capture(void *data) {
+    focus_capture *capture = (focus_capture *)data;
+    wendigo_focus_sample(capture->mac, capture->rssi, capture->channel);
+}
+
+/** Have the pipeline task feed a reading to its tracker. For radio callbacks
+ *  that don't otherwise pass the reading on, because looking the device up
+ *  in the cache from the radio's core would race with the pipeline task
+ *  updating it.
+ */
+void wendigo_focus_submit(const uint8_t *mac, int16_t rssi, uint8_t channel) {
+    if (scanStatus[SCAN_FOCUS] != ACTION_ENABLE) {
+        return;
+    }
+    focus_capture capture = { .rssi = rssi, .channel = channel };
+    memcpy(capture.mac, mac, MAC_BYTES);
+    wendigo_pipeline_submit(focus_sample_capture, &capture, sizeof(focus_capture));
+}
+
+/** Stop tracking `mac` - It's been untagged */
+void wendigo_focus_forget(const uint8_t *mac) {
+    portENTER_CRITICAL(&focusLock);
+    rssi_track_remove(mac);
+    focus_hop_remove(mac);
+    portEXIT_CRITICAL(&focusLock);
+}
+
+/** The WiFi channel to hop to next, and in `dwell_ms` how long to stay on
+ *  it, while tagged devices are being tracked. Returns 0 if Focus Mode
+ *  isn't locked onto any channels and hopping should carry on as usual.
+ */
+uint8_t wendigo_focus_next_channel(const uint8_t *enabled, uint8_t enabled_count, uint32_t hop_ms,
+        uint32_t *dwell_ms) {
+    uint8_t channel = 0;
+    if (scanStatus[SCAN_FOCUS] != ACTION_ENABLE) {
+        return channel;
+    }
+    uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+    portENTER_CRITICAL(&focusLock);
+    channel = focus_hop_next(now_ms, enabled, enabled_count, hop_ms, dwell_ms);
+    portEXIT_CRITICAL(&focusLock);
+    return channel;
+}
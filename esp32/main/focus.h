@@ -0,0 +1,15 @@
+#ifndef WENDIGO_FOCUS_H
+#define WENDIGO_FOCUS_H
+
+#include "common.h"
+#include "focus_hop.h"
+#include "rssi_track.h"
+
+esp_err_t wendigo_focus_enable(bool enable);
+void wendigo_focus_sample(const uint8_t *mac, int16_t rssi, uint8_t channel);
+void wendigo_focus_submit(const uint8_t *mac, int16_t rssi, uint8_t channel);
+void wendigo_focus_forget(const uint8_t *mac);
+uint8_t wendigo_focus_next_channel(const uint8_t *enabled, uint8_t enabled_count, uint32_t hop_ms,
+    uint32_t *dwell_ms);
+
+#endif
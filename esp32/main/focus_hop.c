@@ -0,0 +1,126 @@
+#include "focus_hop.h"
+
+#include <string.h>
+
+static focus_hop_target targets[CONFIG_FOCUS_RSSI_MAX_DEVICES];
+static bool locked = false;
+static uint8_t lock_index = 0;
+static uint8_t excursion_index = 0;     /* Into the enabled channels */
+static uint32_t excursion_due_ms = 0;
+
+static focus_hop_target *target_for_mac(const uint8_t *mac) {
+    for (uint8_t i = 0; i < CONFIG_FOCUS_RSSI_MAX_DEVICES; ++i) {
+        if (targets[i].used && memcmp(targets[i].mac, mac, ESP_BD_ADDR_LEN) == 0) {
+            return &targets[i];
+        }
+    }
+    return NULL;
+}
+
+/** Record that `mac` was heard on `channel`. When the table is full the
+ *  device heard least recently makes way for it.
+ */
+void focus_hop_heard(const uint8_t *mac, uint8_t channel, uint32_t now_ms) {
+    if (channel == 0) {
+        return;
+    }
+    focus_hop_target *target = target_for_mac(mac);
+    for (uint8_t i = 0; target == NULL && i < CONFIG_FOCUS_RSSI_MAX_DEVICES; ++i) {
+        if (!targets[i].used) {
+            target = &targets[i];
+        }
+    }
+    if (target == NULL) {
+        target = &targets[0];
+        for (uint8_t i = 1; i < CONFIG_FOCUS_RSSI_MAX_DEVICES; ++i) {
+            if ((int32_t)(targets[i].last_ms - target->last_ms) < 0) {
+                target = &targets[i];
+            }
+        }
+    }
+    memcpy(target->mac, mac, ESP_BD_ADDR_LEN);
+    target->used = true;
+    target->channel = channel;
+    target->last_ms = now_ms;
+}
+
+/** Stop locking onto `mac`'s channel. Returns false if it wasn't known */
+bool focus_hop_remove(const uint8_t *mac) {
+    focus_hop_target *target = target_for_mac(mac);
+    if (target == NULL) {
+        return false;
+    }
+    memset(target, 0, sizeof(focus_hop_target));
+    return true;
+}
+
+/** Place the distinct channels of devices heard within
+ *  CONFIG_FOCUS_HOP_STALE_MILLIS in `channels`, in ascending order, up to
+ *  `max` of them. Returns the number of distinct channels, which may be
+ *  more than `max`.
+ */
+uint8_t focus_hop_channels(uint32_t now_ms, uint8_t *channels, uint8_t max) {
+    uint8_t found[CONFIG_FOCUS_RSSI_MAX_DEVICES];
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < CONFIG_FOCUS_RSSI_MAX_DEVICES; ++i) {
+        if (!targets[i].used || (uint32_t)(now_ms - targets[i].last_ms) >= CONFIG_FOCUS_HOP_STALE_MILLIS) {
+            continue;
+        }
+        uint8_t pos = 0;
+        while (pos < count && found[pos] < targets[i].channel) {
+            ++pos;
+        }
+        if (pos < count && found[pos] == targets[i].channel) {
+            continue;
+        }
+        memmove(&found[pos + 1], &found[pos], count - pos);
+        found[pos] = targets[i].channel;
+        ++count;
+    }
+    memcpy(channels, found, (count < max) ? count : max);
+    return count;
+}
+
+/** Choose the channel to listen on next and, in `dwell_ms`, for how long.
+ *  `enabled` holds the channels normal hopping goes through and `hop_ms`
+ *  is its dwell time. Returns 0 if no channel should be locked onto, in
+ *  which case the caller hops through `enabled` as usual.
+ */
+uint8_t focus_hop_next(uint32_t now_ms, const uint8_t *enabled, uint8_t enabled_count, uint32_t hop_ms,
+        uint32_t *dwell_ms) {
+    uint8_t lock[CONFIG_FOCUS_HOP_MAX_CHANNELS];
+    uint8_t count = focus_hop_channels(now_ms, lock, CONFIG_FOCUS_HOP_MAX_CHANNELS);
+    if (count == 0 || count > CONFIG_FOCUS_HOP_MAX_CHANNELS) {
+        locked = false;
+        return 0;
+    }
+    if (!locked) {
+        locked = true;
+        lock_index = 0;
+        excursion_due_ms = now_ms + CONFIG_FOCUS_HOP_EXCURSION_MILLIS;
+    } else {
+        lock_index = (uint8_t)((lock_index + 1) % count);
+    }
+    if ((int32_t)(now_ms - excursion_due_ms) >= 0) {
+        excursion_due_ms = now_ms + CONFIG_FOCUS_HOP_EXCURSION_MILLIS;
+        for (uint8_t i = 0; i < enabled_count; ++i) {
+            uint8_t channel = enabled[(excursion_index + i) % enabled_count];
+            if (memchr(lock, channel, count) == NULL) {
+                excursion_index = (uint8_t)((excursion_index + i + 1) % enabled_count);
+                *dwell_ms = CONFIG_FOCUS_HOP_EXCURSION_DWELL_MILLIS;
+                return channel;
+            }
+        }
+    }
+    *dwell_ms = hop_ms;
+    return lock[lock_index];
+}
+
+/** Forget every device's channel and go back to normal hopping */
+void focus_hop_reset() {
+    memset(targets, 0, sizeof(targets));
+    locked = false;
+    lock_index = 0;
+    excursion_index = 0;
+    excursion_due_ms = 0;
+}
@@ -0,0 +1,61 @@
+#ifndef WENDIGO_FOCUS_HOP_H
+#define WENDIGO_FOCUS_HOP_H
+
+/** Focus Mode channel hopping.
+ * Hopping through every enabled channel means a tagged WiFi device is only
+ * listened to for one dwell in 13, so Focus Mode hears a fraction of its
+ * frames. Instead, while tagged devices are being tracked, the channel each
+ * was last heard on is remembered and hopping is restricted to those
+ * channels:
+ *  * If the tagged devices share a channel the radio parks on it. If they're
+ *    spread over at most CONFIG_FOCUS_HOP_MAX_CHANNELS channels it cycles
+ *    between those. If they're spread any wider, locking gains little and
+ *    every enabled channel is hopped through as usual.
+ *  * Every CONFIG_FOCUS_HOP_EXCURSION_MILLIS the radio makes a short
+ *    excursion of CONFIG_FOCUS_HOP_EXCURSION_DWELL_MILLIS to the next enabled
+ *    channel that isn't locked, in turn, so a device that moves to another
+ *    channel is eventually heard there and its channel updated.
+ *  * A device that hasn't been heard for CONFIG_FOCUS_HOP_STALE_MILLIS no
+ *    longer holds its channel. If no device holds a channel, normal hopping
+ *    resumes until one is heard again.
+ * Bluetooth devices have no channel and play no part. Nothing here needs
+ * ESP-IDF, so it can be exercised on a host. It isn't thread-safe; callers
+ * hold a lock.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sdkconfig.h"
+#include <esp_bt_defs.h>
+
+#ifndef CONFIG_FOCUS_RSSI_MAX_DEVICES
+    #define CONFIG_FOCUS_RSSI_MAX_DEVICES 8
+#endif
+#ifndef CONFIG_FOCUS_HOP_MAX_CHANNELS
+    #define CONFIG_FOCUS_HOP_MAX_CHANNELS 3
+#endif
+#ifndef CONFIG_FOCUS_HOP_EXCURSION_MILLIS
+    #define CONFIG_FOCUS_HOP_EXCURSION_MILLIS 3000
+#endif
+#ifndef CONFIG_FOCUS_HOP_EXCURSION_DWELL_MILLIS
+    #define CONFIG_FOCUS_HOP_EXCURSION_DWELL_MILLIS 150
+#endif
+#ifndef CONFIG_FOCUS_HOP_STALE_MILLIS
+    #define CONFIG_FOCUS_HOP_STALE_MILLIS 10000
+#endif
+
+typedef struct focus_hop_target {
+    uint8_t mac[ESP_BD_ADDR_LEN];
+    bool used;
+    uint8_t channel;        /* Channel it was last heard on */
+    uint32_t last_ms;
+} focus_hop_target;
+
+void focus_hop_heard(const uint8_t *mac, uint8_t channel, uint32_t now_ms);
+bool focus_hop_remove(const uint8_t *mac);
+uint8_t focus_hop_channels(uint32_t now_ms, uint8_t *channels, uint8_t max);
+uint8_t focus_hop_next(uint32_t now_ms, const uint8_t *enabled, uint8_t enabled_count, uint32_t hop_ms,
+    uint32_t *dwell_ms);
+void focus_hop_reset();
+
+#endif
@@ -0,0 +1,242 @@
+#include "gatt_discovery.h"
+
+#include <string.h>
+
+#include "wendigo_common_defs.h"
+
+static gatt_discovery_job jobs[CONFIG_GATT_DISCOVERY_QUEUE_LEN];
+static gatt_discovery_result cache[CONFIG_GATT_DISCOVERY_CACHE_ENTRIES];
+static uint32_t next_seq = 0;
+static uint32_t completed = 0;
+static uint32_t failed = 0;
+
+static gatt_discovery_job *job_for_bda(const uint8_t *bda) {
+    for (uint8_t i = 0; i < CONFIG_GATT_DISCOVERY_QUEUE_LEN; ++i) {
+        if (jobs[i].state != GATT_JOB_FREE && memcmp(jobs[i].bda, bda, ESP_BD_ADDR_LEN) == 0) {
+            return &jobs[i];
+        }
+    }
+    return NULL;
+}
+
+static gatt_discovery_job *job_for_conn(uint16_t conn_id) {
+    for (uint8_t i = 0; i < CONFIG_GATT_DISCOVERY_QUEUE_LEN; ++i) {
+        if (jobs[i].state == GATT_JOB_DISCOVERING && jobs[i].conn_id == conn_id) {
+            return &jobs[i];
+        }
+    }
+    return NULL;
+}
+
+static gatt_discovery_result *cache_for_bda(const uint8_t *bda) {
+    for (uint8_t i = 0; i < CONFIG_GATT_DISCOVERY_CACHE_ENTRIES; ++i) {
+        if (cache[i].used && memcmp(cache[i].bda, bda, ESP_BD_ADDR_LEN) == 0) {
+            return &cache[i];
+        }
+    }
+    return NULL;
+}
+
+/** Queue `bda` for discovery, unless it's already queued or its services are cached */
+GattRequestResult gatt_discovery_request(const uint8_t *bda, uint32_t now_ms) {
+    const gatt_discovery_result *cached = cache_for_bda(bda);
+    if (cached != NULL && cached->result == WENDIGO_GATT_COMPLETE) {
+        return GATT_REQUEST_CACHED;
+    }
+    if (job_for_bda(bda) != NULL) {
+        return GATT_REQUEST_PENDING;
+    }
+    for (uint8_t i = 0; i < CONFIG_GATT_DISCOVERY_QUEUE_LEN; ++i) {
+        if (jobs[i].state == GATT_JOB_FREE) {
+            memset(&jobs[i], 0, sizeof(gatt_discovery_job));
+            memcpy(jobs[i].bda, bda, ESP_BD_ADDR_LEN);
+            jobs[i].state = GATT_JOB_WAITING;
+            jobs[i].conn_id = GATT_DISCOVERY_NO_CONN;
+            jobs[i].seq = next_seq++;
+            jobs[i].deadline_ms = now_ms + CONFIG_GATT_DISCOVERY_WAIT_SECONDS * 1000U;
+            return GATT_REQUEST_QUEUED;
+        }
+    }
+    return GATT_REQUEST_FULL;
+}
+
+/** Note an advertisement from `bda`. If it's waiting to be discovered this
+ * provides its address type, and if the advertisement is connectable makes
+ * it ready for a connection.
+ */
+void gatt_discovery_advert(const uint8_t *bda, uint8_t addr_type, bool connectable) {
+    gatt_discovery_job *job = job_for_bda(bda);
+    if (job == NULL || (job->state != GATT_JOB_WAITING && job->state != GATT_JOB_READY)) {
+        return;
+    }
+    job->addr_type = addr_type;
+    if (connectable) {
+        job->state = GATT_JOB_READY;
+    } else if (job->state == GATT_JOB_WAITING) {
+        job->non_connectable = true;
+    }
+}
+
+/** If there's a free connection slot, take the longest-waiting device that's
+ * ready and mark it as connecting. Its address and address type are placed
+ * in `bda` and `addr_type`. Returns false if there's nothing to connect to.
+ */
+bool gatt_discovery_next(uint32_t now_ms, uint8_t *bda, uint8_t *addr_type) {
+    uint8_t active = 0;
+    gatt_discovery_job *next = NULL;
+    for (uint8_t i = 0; i < CONFIG_GATT_DISCOVERY_QUEUE_LEN; ++i) {
+        if (jobs[i].state == GATT_JOB_CONNECTING || jobs[i].state == GATT_JOB_DISCOVERING) {
+            ++active;
+        } else if (jobs[i].state == GATT_JOB_READY &&
+                (next == NULL || (int32_t)(jobs[i].seq - next->seq) < 0)) {
+            next = &jobs[i];
+        }
+    }
+    if (next == NULL || active >= CONFIG_GATT_DISCOVERY_MAX_CONNECTIONS) {
+        return false;
+    }
+    next->state = GATT_JOB_CONNECTING;
+    next->deadline_ms = now_ms + CONFIG_GATT_DISCOVERY_TIMEOUT_MILLIS;
+    memcpy(bda, next->bda, ESP_BD_ADDR_LEN);
+    *addr_type = next->addr_type;
+    return true;
+}
+
+/** The connection to `bda` is open as `conn_id`. Returns false if `bda`
+ * isn't being connected to - It's timed out - and the connection should
+ * be closed.
+ */
+bool gatt_discovery_connected(const uint8_t *bda, uint16_t conn_id) {
+    gatt_discovery_job *job = job_for_bda(bda);
+    if (job == NULL || job->state != GATT_JOB_CONNECTING) {
+        return false;
+    }
+    job->state = GATT_JOB_DISCOVERING;
+    job->conn_id = conn_id;
+    return true;
+}
+
+/** Place the address of the device being discovered over `conn_id` in
+ * `bda`. Returns false if no discovery is using `conn_id`.
+ */
+bool gatt_discovery_conn_bda(uint16_t conn_id, uint8_t *bda) {
+    gatt_discovery_job *job = job_for_conn(conn_id);
+    if (job == NULL) {
+        return false;
+    }
+    memcpy(bda, job->bda, ESP_BD_ADDR_LEN);
+    return true;
+}
+
+/** Record a service found over `conn_id` */
+void gatt_discovery_service(uint16_t conn_id, const esp_bt_uuid_t *uuid) {
+    gatt_discovery_job *job = job_for_conn(conn_id);
+    if (job == NULL) {
+        return;
+    }
+    if (job->svc_count == GATT_DISCOVERY_MAX_SERVICES) {
+        job->truncated = true;
+        return;
+    }
+    memcpy(&(job->uuids[job->svc_count++]), uuid, sizeof(esp_bt_uuid_t));
+}
+
+/** End discovery of `bda` with `result` (a WendigoGattResult), moving what
+ * was found into the cache and freeing its place in the queue. Returns the
+ * cache entry, or NULL if `bda` wasn't queued.
+ */
+const gatt_discovery_result *gatt_discovery_finish(const uint8_t *bda, uint8_t result, uint32_t now_ms) {
+    gatt_discovery_job *job = job_for_bda(bda);
+    if (job == NULL) {
+        return NULL;
+    }
+    gatt_discovery_result *entry = cache_for_bda(bda);
+    for (uint8_t i = 0; entry == NULL && i < CONFIG_GATT_DISCOVERY_CACHE_ENTRIES; ++i) {
+        if (!cache[i].used) {
+            entry = &cache[i];
+        }
+    }
+    if (entry == NULL) {
+        entry = &cache[0];
+        for (uint8_t i = 1; i < CONFIG_GATT_DISCOVERY_CACHE_ENTRIES; ++i) {
+            if ((int32_t)(cache[i].stored_ms - entry->stored_ms) < 0) {
+                entry = &cache[i];
+            }
+        }
+    }
+    memset(entry, 0, sizeof(gatt_discovery_result));
+    memcpy(entry->bda, bda, ESP_BD_ADDR_LEN);
+    entry->used = true;
+    entry->result = result;
+    entry->stored_ms = now_ms;
+    if (result == WENDIGO_GATT_COMPLETE) {
+        entry->svc_count = job->svc_count;
+        entry->truncated = job->truncated;
+        memcpy(entry->uuids, job->uuids, sizeof(esp_bt_uuid_t) * job->svc_count);
+        ++completed;
+    } else {
+        ++failed;
+    }
+    memset(job, 0, sizeof(gatt_discovery_job));
+    return entry;
+}
+
+/** If a queued device has passed its deadline, copy its job into `expired`
+ * and finish it with WENDIGO_GATT_TIMEOUT, or WENDIGO_GATT_NOT_CONNECTABLE if
+ * it was never heard advertising connectably. The caller must close any
+ * connection `expired` had open. Returns the cache entry, or NULL if nothing
+ * has expired; call it until it returns NULL.
+ */
+const gatt_discovery_result *gatt_discovery_expire(uint32_t now_ms, gatt_discovery_job *expired) {
+    for (uint8_t i = 0; i < CONFIG_GATT_DISCOVERY_QUEUE_LEN; ++i) {
+        if (jobs[i].state != GATT_JOB_FREE && (int32_t)(now_ms - jobs[i].deadline_ms) >= 0) {
+            memcpy(expired, &jobs[i], sizeof(gatt_discovery_job));
+            uint8_t result = (jobs[i].state == GATT_JOB_WAITING && jobs[i].non_connectable) ?
+                WENDIGO_GATT_NOT_CONNECTABLE : WENDIGO_GATT_TIMEOUT;
+            return gatt_discovery_finish(expired->bda, result, now_ms);
+        }
+    }
+    return NULL;
+}
+
+/** The cached result for `bda`, or NULL */
+const gatt_discovery_result *gatt_discovery_cached(const uint8_t *bda) {
+    return cache_for_bda(bda);
+}
+
+/** Whether any device is queued or being discovered */
+bool gatt_discovery_busy() {
+    for (uint8_t i = 0; i < CONFIG_GATT_DISCOVERY_QUEUE_LEN; ++i) {
+        if (jobs[i].state != GATT_JOB_FREE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void gatt_discovery_get_stats(gatt_discovery_stats *stats) {
+    memset(stats, 0, sizeof(gatt_discovery_stats));
+    for (uint8_t i = 0; i < CONFIG_GATT_DISCOVERY_QUEUE_LEN; ++i) {
+        if (jobs[i].state == GATT_JOB_WAITING || jobs[i].state == GATT_JOB_READY) {
+            ++stats->waiting;
+        } else if (jobs[i].state == GATT_JOB_CONNECTING || jobs[i].state == GATT_JOB_DISCOVERING) {
+            ++stats->active;
+        }
+    }
+    for (uint8_t i = 0; i < CONFIG_GATT_DISCOVERY_CACHE_ENTRIES; ++i) {
+        if (cache[i].used) {
+            ++stats->cached;
+        }
+    }
+    stats->completed = completed;
+    stats->failed = failed;
+}
+
+/** Empty the queue and the cache. Any open connections are the caller's to close */
+void gatt_discovery_reset() {
+    memset(jobs, 0, sizeof(jobs));
+    memset(cache, 0, sizeof(cache));
+    next_seq = 0;
+    completed = 0;
+    failed = 0;
+}
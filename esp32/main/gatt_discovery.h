@@ -0,0 +1,114 @@
+#ifndef WENDIGO_GATT_DISCOVERY_H
+#define WENDIGO_GATT_DISCOVERY_H
+
+/** Queued GATT service discovery.
+ * Advertisements list only the services a device chooses to advertise, often
+ * none. Connecting and asking for its primary services finds the rest, but
+ * connections are expensive - each holds a controller link and competes with
+ * scanning for airtime - so discovery is queued rather than started the
+ * moment a device is tagged:
+ *  * A requested device waits until it's heard advertising, because the
+ *    connection needs its address type and a connectable advertisement is
+ *    the only sign it will accept one. If it's only heard advertising
+ *    non-connectably by CONFIG_GATT_DISCOVERY_WAIT_SECONDS the result is
+ *    WENDIGO_GATT_NOT_CONNECTABLE, otherwise WENDIGO_GATT_TIMEOUT.
+ *  * At most CONFIG_GATT_DISCOVERY_MAX_CONNECTIONS devices are connected at
+ *    once. The others wait their turn in request order.
+ *  * A device that hasn't finished discovery CONFIG_GATT_DISCOVERY_TIMEOUT_MILLIS
+ *    after its connection was opened is abandoned with WENDIGO_GATT_TIMEOUT.
+ *  * Results are cached per BDA, so a device that's been discovered is
+ *    never connected to again; requesting it returns the cached result.
+ *    Failed attempts are cached too, but a fresh request retries them.
+ *    When the cache is full the oldest result is evicted.
+ * This file only keeps the queue and cache - bluetooth.c opens and closes
+ * the connections - so nothing here needs more of ESP-IDF than esp_bt_defs.h
+ * and it can be exercised on a host. It isn't thread-safe; callers hold
+ * a lock.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sdkconfig.h"
+#include <esp_bt_defs.h>
+
+#ifndef CONFIG_GATT_DISCOVERY_MAX_CONNECTIONS
+    #define CONFIG_GATT_DISCOVERY_MAX_CONNECTIONS 2
+#endif
+#ifndef CONFIG_GATT_DISCOVERY_TIMEOUT_MILLIS
+    #define CONFIG_GATT_DISCOVERY_TIMEOUT_MILLIS 10000
+#endif
+#ifndef CONFIG_GATT_DISCOVERY_WAIT_SECONDS
+    #define CONFIG_GATT_DISCOVERY_WAIT_SECONDS 60
+#endif
+#ifndef CONFIG_GATT_DISCOVERY_QUEUE_LEN
+    #define CONFIG_GATT_DISCOVERY_QUEUE_LEN 8
+#endif
+#ifndef CONFIG_GATT_DISCOVERY_CACHE_ENTRIES
+    #define CONFIG_GATT_DISCOVERY_CACHE_ENTRIES 16
+#endif
+
+/* Most services recorded for a device. The rest are dropped */
+#define GATT_DISCOVERY_MAX_SERVICES 16
+/* conn_id of a job that isn't connected */
+#define GATT_DISCOVERY_NO_CONN      0xFFFF
+
+typedef enum {
+    GATT_JOB_FREE = 0,
+    GATT_JOB_WAITING,       /* Not yet heard advertising connectably */
+    GATT_JOB_READY,         /* Address type known, waiting for a connection slot */
+    GATT_JOB_CONNECTING,
+    GATT_JOB_DISCOVERING,
+} GattJobState;
+
+typedef enum {
+    GATT_REQUEST_QUEUED = 0,
+    GATT_REQUEST_PENDING,   /* Already queued or in progress */
+    GATT_REQUEST_CACHED,    /* Already discovered - see gatt_discovery_cached() */
+    GATT_REQUEST_FULL,
+} GattRequestResult;
+
+typedef struct gatt_discovery_result {
+    uint8_t bda[ESP_BD_ADDR_LEN];
+    bool used;
+    uint8_t result;         /* WendigoGattResult */
+    uint8_t svc_count;
+    bool truncated;         /* More than GATT_DISCOVERY_MAX_SERVICES were found */
+    uint32_t stored_ms;
+    esp_bt_uuid_t uuids[GATT_DISCOVERY_MAX_SERVICES];
+} gatt_discovery_result;
+
+typedef struct gatt_discovery_job {
+    uint8_t bda[ESP_BD_ADDR_LEN];
+    uint8_t state;          /* GattJobState */
+    uint8_t addr_type;      /* esp_ble_addr_type_t */
+    bool non_connectable;   /* Heard advertising, but not connectably */
+    uint16_t conn_id;
+    uint32_t seq;           /* Request order */
+    uint32_t deadline_ms;
+    uint8_t svc_count;
+    bool truncated;
+    esp_bt_uuid_t uuids[GATT_DISCOVERY_MAX_SERVICES];
+} gatt_discovery_job;
+
+typedef struct gatt_discovery_stats {
+    uint8_t waiting;        /* WAITING and READY jobs */
+    uint8_t active;         /* CONNECTING and DISCOVERING jobs */
+    uint8_t cached;
+    uint32_t completed;
+    uint32_t failed;        /* Including timeouts and non-connectable devices */
+} gatt_discovery_stats;
+
+GattRequestResult gatt_discovery_request(const uint8_t *bda, uint32_t now_ms);
+void gatt_discovery_advert(const uint8_t *bda, uint8_t addr_type, bool connectable);
+bool gatt_discovery_next(uint32_t now_ms, uint8_t *bda, uint8_t *addr_type);
+bool gatt_discovery_connected(const uint8_t *bda, uint16_t conn_id);
+bool gatt_discovery_conn_bda(uint16_t conn_id, uint8_t *bda);
+void gatt_discovery_service(uint16_t conn_id, const esp_bt_uuid_t *uuid);
+const gatt_discovery_result *gatt_discovery_finish(const uint8_t *bda, uint8_t result, uint32_t now_ms);
+const gatt_discovery_result *gatt_discovery_expire(uint32_t now_ms, gatt_discovery_job *expired);
+const gatt_discovery_result *gatt_discovery_cached(const uint8_t *bda);
+bool gatt_discovery_busy();
+void gatt_discovery_get_stats(gatt_discovery_stats *stats);
+void gatt_discovery_reset();
+
+#endif
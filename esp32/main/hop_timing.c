@@ -0,0 +1,145 @@
+#include "hop_timing.h"
+
+#include <string.h>
+
+static hop_channel_stats totals[HOP_TIMING_CHANNELS];
+static hop_visit current;       /* channel is 0 between visits */
+static bool wifi_listening = false;
+static uint32_t stray = 0;
+
+static hop_channel_stats *totals_for_channel(uint8_t channel) {
+    for (uint8_t i = 0; i < HOP_TIMING_CHANNELS; ++i) {
+        if (totals[i].channel == channel) {
+            return &totals[i];
+        }
+    }
+    for (uint8_t i = 0; i < HOP_TIMING_CHANNELS; ++i) {
+        if (totals[i].channel == 0) {
+            totals[i].channel = channel;
+            return &totals[i];
+        }
+    }
+    return NULL;
+}
+
+/* Listening time of the current visit up to `now_us` */
+static uint64_t visit_listen_us(int64_t now_us) {
+    uint64_t listen_us = current.listen_us;
+    if (wifi_listening && now_us > current.listen_start_us) {
+        listen_us += (uint64_t)(now_us - current.listen_start_us);
+    }
+    return listen_us;
+}
+
+/* Fold the current visit into its channel's totals and end it */
+static void end_visit(int64_t now_us) {
+    if (current.channel == 0) {
+        return;
+    }
+    hop_channel_stats *channel = totals_for_channel(current.channel);
+    if (channel != NULL) {
+        int64_t dwell_us = (now_us > current.start_us) ? now_us - current.start_us : 0;
+        int64_t error_us = dwell_us - (int64_t)current.requested_us;
+        if (channel->visits == 0 || (error_us < 0 ? -error_us : error_us) >
+                (channel->worst_error_us < 0 ? -channel->worst_error_us : channel->worst_error_us)) {
+            channel->worst_error_us = error_us;
+        }
+        ++channel->visits;
+        channel->dwell_us += (uint64_t)dwell_us;
+        channel->requested_us += current.requested_us;
+        channel->listen_us += visit_listen_us(now_us);
+        channel->frames += current.frames;
+    }
+    memset(&current, 0, sizeof(hop_visit));
+}
+
+/** The radio is on `channel` as of `now_us` and will stay there for
+ *  `dwell_us`. If it was already on `channel` the visit under way is
+ *  extended, otherwise it ends and a new visit begins.
+ */
+void hop_timing_visit(uint8_t channel, uint32_t dwell_us, int64_t now_us) {
+    if (channel == 0) {
+        return;
+    }
+    if (current.channel == channel) {
+        current.requested_us += dwell_us;
+        return;
+    }
+    end_visit(now_us);
+    /* Claim the channel's totals now so it's listed during its first visit */
+    totals_for_channel(channel);
+    current.channel = channel;
+    current.start_us = now_us;
+    current.requested_us = dwell_us;
+    current.listen_start_us = now_us;
+}
+
+/** WiFi has gained (`listening`) or lost the radio at `now_us` */
+void hop_timing_listen(bool listening, int64_t now_us) {
+    if (listening == wifi_listening) {
+        return;
+    }
+    if (listening) {
+        current.listen_start_us = now_us;
+    } else {
+        current.listen_us = visit_listen_us(now_us);
+    }
+    wifi_listening = listening;
+}
+
+/** Count a frame received on `channel` against the visit under way. Returns
+ *  false if it wasn't received on the visit's channel and was counted as
+ *  stray instead.
+ */
+bool hop_timing_frame(uint8_t channel) {
+    if (current.channel == 0 || current.channel != channel) {
+        ++stray;
+        return false;
+    }
+    ++current.frames;
+    return true;
+}
+
+/** Hopping has stopped; end the visit under way */
+void hop_timing_stop(int64_t now_us) {
+    end_visit(now_us);
+}
+
+/** Place the totals of each channel visited, in ascending channel order, in
+ *  `stats`, up to `max` of them. Frames and listening time include the visit
+ *  under way as of `now_us`. Returns the number placed.
+ */
+uint8_t hop_timing_channels(int64_t now_us, hop_channel_stats *stats, uint8_t max) {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < HOP_TIMING_CHANNELS && count < max; ++i) {
+        if (totals[i].channel == 0) {
+            continue;
+        }
+        uint8_t pos = count;
+        while (pos > 0 && stats[pos - 1].channel > totals[i].channel) {
+            memcpy(&stats[pos], &stats[pos - 1], sizeof(hop_channel_stats));
+            --pos;
+        }
+        memcpy(&stats[pos], &totals[i], sizeof(hop_channel_stats));
+        if (totals[i].channel == current.channel) {
+            stats[pos].listen_us += visit_listen_us(now_us);
+            stats[pos].frames += current.frames;
+        }
+        ++count;
+    }
+    return count;
+}
+
+/** Frames received on a channel other than the one being visited */
+uint32_t hop_timing_stray() {
+    return stray;
+}
+
+/** Forget every visit. Listening carries on as it was */
+void hop_timing_reset() {
+    memset(totals, 0, sizeof(totals));
+    int64_t listen_start_us = current.listen_start_us;
+    memset(&current, 0, sizeof(hop_visit));
+    current.listen_start_us = listen_start_us;
+    stray = 0;
+}
@@ -0,0 +1,55 @@
+#ifndef WENDIGO_HOP_TIMING_H
+#define WENDIGO_HOP_TIMING_H
+
+/** Timing of WiFi channel hopping.
+ * Each time the radio changes channel a visit begins, recording exactly when
+ * it started, the dwell time that was asked for and, when the next visit
+ * begins, exactly when it ended. Parking on a channel extends the visit
+ * rather than starting another. Frames are counted against the visit under
+ * way when they're received, provided they were received on its channel;
+ * frames received on another channel - in flight while the channel changed -
+ * are counted as stray. Time is only counted as listening while WiFi has the
+ * radio, so a channel's frame rate is frames per second actually spent
+ * listening to it rather than per second of the radio scheduler's round.
+ * When a visit ends it's folded into its channel's totals, which give:
+ *  * The average dwell actually achieved, and the worst difference between
+ *    the dwell asked for and the dwell achieved, to check hop policies -
+ *    including Focus Mode's short excursions - against real timing;
+ *  * Frames per second of listening on each channel.
+ * Nothing here needs ESP-IDF, so it can be exercised on a host. It isn't
+ * thread-safe; callers hold a lock.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+/* 2.4GHz channels 1-14 */
+#define HOP_TIMING_CHANNELS 14
+
+typedef struct hop_visit {
+    uint8_t channel;
+    int64_t start_us;
+    uint64_t requested_us;  /* Dwell asked for, including extensions */
+    int64_t listen_start_us;    /* When listening began, if listening */
+    uint64_t listen_us;     /* Listening time before listen_start_us */
+    uint32_t frames;
+} hop_visit;
+
+typedef struct hop_channel_stats {
+    uint8_t channel;
+    uint32_t visits;        /* Completed visits */
+    uint64_t dwell_us;      /* Total dwell of completed visits */
+    uint64_t requested_us;  /* Total dwell they asked for */
+    int64_t worst_error_us; /* Achieved minus requested dwell furthest from 0 */
+    uint64_t listen_us;     /* Including the visit under way */
+    uint32_t frames;        /* Including the visit under way */
+} hop_channel_stats;
+
+void hop_timing_visit(uint8_t channel, uint32_t dwell_us, int64_t now_us);
+void hop_timing_listen(bool listening, int64_t now_us);
+bool hop_timing_frame(uint8_t channel);
+void hop_timing_stop(int64_t now_us);
+uint8_t hop_timing_channels(int64_t now_us, hop_channel_stats *stats, uint8_t max);
+uint32_t hop_timing_stray();
+void hop_timing_reset();
+
+#endif
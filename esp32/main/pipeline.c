@@ -0,0 +1,155 @@
+#include "pipeline.h"
+#include "portmacro.h"
+
+/* Parsers print in interactive mode, so the task needs room for printf() */
+#define PIPELINE_TASK_STACK 6144
+
+typedef struct wendigo_capture {
+    wendigo_pipeline_handler handler;
+    void *data;
+} wendigo_capture;
+
+/* Counters are updated from both radio stacks' tasks without a lock; a lost
+   increment only makes the statistics slightly low */
+static uint32_t processed = 0;
+static uint32_t dropped = 0;
+static uint16_t high_water = 0;
+
+#if WENDIGO_DUAL_CORE
+static QueueHandle_t pipelineQueue = NULL;
+static TaskHandle_t pipelineTask = NULL;
+#else
+/* Captures are processed by the task that submits them, so take turns.
+   Recursive because a handler may itself submit a capture */
+static SemaphoreHandle_t inlineMutex = NULL;
+#endif
+
+#if WENDIGO_DUAL_CORE
+
+/** Body of the pipeline task: process captures in the order they arrived */
+static void pipelineCallback(void *pvParameter) {
+    wendigo_capture capture;
+    while (true) {
+        if (xQueueReceive(pipelineQueue, &capture, portMAX_DELAY) == pdTRUE) {
+            capture.handler(capture.data);
+            free(capture.data);
+            ++processed;
+        }
+    }
+}
+#endif
+
+/** Create the pipeline queue and start the task that empties it, if this
+ *  is a dual-core chip and they aren't already running. On a single-core
+ *  chip create the mutex that handlers are run under instead.
+ */
+esp_err_t wendigo_pipeline_start() {
+#if !WENDIGO_DUAL_CORE
+    if (inlineMutex == NULL) {
+        inlineMutex = xSemaphoreCreateRecursiveMutex();
+        if (inlineMutex == NULL) {
+            return outOfMemory();
+        }
+    }
+#else
+    if (pipelineTask != NULL) {
+        return ESP_OK;
+    }
+    pipelineQueue = xQueueCreate(CONFIG_PIPELINE_QUEUE_LEN, sizeof(wendigo_capture));
+    if (pipelineQueue == NULL) {
+        return outOfMemory();
+    }
+    if (xTaskCreatePinnedToCore(pipelineCallback, "pipelineCallback", PIPELINE_TASK_STACK, NULL,
+            CONFIG_PIPELINE_TASK_PRIORITY, &pipelineTask, WENDIGO_PIPELINE_CORE) != pdPASS) {
+        vQueueDelete(pipelineQueue);
+        pipelineQueue = NULL;
+        pipelineTask = NULL;
+        return outOfMemory();
+    }
+#endif
+    return ESP_OK;
+}
+
+/** Whether captures are handed to the pipeline task rather than processed
+ *  by the caller */
+bool wendigo_pipeline_running() {
+#if WENDIGO_DUAL_CORE
+    return (pipelineTask != NULL);
+#else
+    return false;
+#endif
+}
+
+/** Have `handler` process a copy of the `len` bytes at `data` on the
+ *  pipeline task. If the pipeline isn't running `handler` is called
+ *  straight away with `data` itself, so callers needn't care which.
+ *  Either way the `len` bytes at `data` remain the caller's, and handlers
+ *  never run concurrently with one another.
+ *  Returns false if the capture was dropped and `handler` will never see it.
+ *  A caller whose capture hands over something it allocated - such as a
+ *  pointer to a device - must free that itself in this case.
+ */
+bool wendigo_pipeline_submit(wendigo_pipeline_handler handler, const void *data, size_t len) {
+#if WENDIGO_DUAL_CORE
+    if (pipelineTask != NULL) {
+        wendigo_capture capture = { .handler = handler, .data = malloc(len) };
+        if (capture.data == NULL) {
+            ++dropped;
+            return false;
+        }
+        memcpy(capture.data, data, len);
+        /* Never make the radio wait */
+        if (xQueueSend(pipelineQueue, &capture, 0) != pdTRUE) {
+            free(capture.data);
+            ++dropped;
+            return false;
+        }
+        UBaseType_t waiting = uxQueueMessagesWaiting(pipelineQueue);
+        if (waiting > high_water) {
+            high_water = (uint16_t)waiting;
+        }
+        return true;
+    }
+#else
+    UNUSED(len);
+    if (inlineMutex != NULL) {
+        if (xSemaphoreTakeRecursive(inlineMutex, portMAX_DELAY) != pdTRUE) {
+            ++dropped;
+            return false;
+        }
+        handler((void *)data);
+        ++processed;
+        xSemaphoreGiveRecursive(inlineMutex);
+        return true;
+    }
+#endif
+    handler((void *)data);
+    ++processed;
+    return true;
+}
+
+void wendigo_pipeline_get_stats(wendigo_pipeline_stats *stats) {
+    memset(stats, 0, sizeof(wendigo_pipeline_stats));
+    stats->running = wendigo_pipeline_running();
+#if WENDIGO_DUAL_CORE
+    if (pipelineQueue != NULL) {
+        stats->queued = (uint16_t)uxQueueMessagesWaiting(pipelineQueue);
+    }
+#endif
+    stats->high_water = high_water;
+    stats->processed = processed;
+    stats->dropped = dropped;
+}
+
+/** Create a task pinned to `core` - WENDIGO_RADIO_CORE or
+ *  WENDIGO_PIPELINE_CORE - or, on a single-core chip, with no affinity.
+ */
+BaseType_t wendigo_task_create(void (*task)(void *), const char *name, uint32_t stack, void *param,
+        UBaseType_t priority, TaskHandle_t *handle, BaseType_t core) {
+#if WENDIGO_DUAL_CORE
+    return xTaskCreatePinnedToCore(task, name, stack, param, priority, handle, core);
+#else
+    UNUSED(core);
+    return xTaskCreate(task, name, stack, param, priority, handle);
+#endif
+}
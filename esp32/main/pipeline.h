@@ -0,0 +1,81 @@
+#ifndef WENDIGO_PIPELINE_H
+#define WENDIGO_PIPELINE_H
+
+/** Layout of ESP32-Wendigo's work across the ESP32's cores.
+ * The WiFi and Bluetooth stacks deliver frames and advertisements from
+ * their own tasks, which ESP-IDF pins to CONFIG_PIPELINE_RADIO_CORE (core 0
+ * unless sdkconfig says otherwise). Parsing what they deliver, updating the
+ * device cache, encoding packets and writing them to the UART all used to
+ * happen inside those callbacks, holding up the radio stacks and leaving the
+ * other core idle. On a dual-core chip the work is now split in two:
+ *  * Capture: the radio callbacks copy what they received and submit it to
+ *    the pipeline queue. Channel hopping and the radio scheduler, which only
+ *    drive the radios, run on the same core.
+ *  * Process: a task on CONFIG_PIPELINE_CORE takes each capture off the
+ *    queue and runs the parser that used to run in the callback. The
+ *    console REPL, which sends command responses, also runs on this core.
+ * Everything that adds to the device cache - parsed frames and
+ * advertisements, Bluetooth device names and GATT discovery results -
+ * goes through wendigo_pipeline_submit(), and handlers never run
+ * concurrently, so devices[] is only ever written by one task at a time and
+ * pointers into it stay valid for the rest of a handler.
+ * When the queue is full a capture is dropped rather than holding up the
+ * radio; wendigo_pipeline_get_stats() says how often that happens. Task
+ * priorities are set with CONFIG_PIPELINE_TASK_PRIORITY,
+ * CONFIG_HOP_TASK_PRIORITY and CONFIG_RADIO_SCHED_TASK_PRIORITY.
+ * On a single-core chip such as the ESP32-C3 there's nothing to gain from
+ * the copy, so no pipeline task is started: captures are processed in the
+ * callback as before, under a mutex so that callbacks on different tasks
+ * take turns, and tasks are created without affinity.
+ */
+#include "common.h"
+#include "freertos/idf_additions.h"
+
+#ifndef CONFIG_PIPELINE_RADIO_CORE
+    #define CONFIG_PIPELINE_RADIO_CORE 0
+#endif
+#ifndef CONFIG_PIPELINE_CORE
+    #define CONFIG_PIPELINE_CORE 1
+#endif
+#ifndef CONFIG_PIPELINE_QUEUE_LEN
+    #define CONFIG_PIPELINE_QUEUE_LEN 64
+#endif
+#ifndef CONFIG_PIPELINE_TASK_PRIORITY
+    #define CONFIG_PIPELINE_TASK_PRIORITY 5
+#endif
+#ifndef CONFIG_HOP_TASK_PRIORITY
+    #define CONFIG_HOP_TASK_PRIORITY 10
+#endif
+#ifndef CONFIG_RADIO_SCHED_TASK_PRIORITY
+    #define CONFIG_RADIO_SCHED_TASK_PRIORITY 5
+#endif
+
+#if !defined(CONFIG_FREERTOS_UNICORE) && defined(CONFIG_FREERTOS_NUMBER_OF_CORES) && CONFIG_FREERTOS_NUMBER_OF_CORES > 1
+    #define WENDIGO_DUAL_CORE      (1)
+    #define WENDIGO_RADIO_CORE     (CONFIG_PIPELINE_RADIO_CORE)
+    #define WENDIGO_PIPELINE_CORE  (CONFIG_PIPELINE_CORE)
+#else
+    #define WENDIGO_DUAL_CORE      (0)
+    #define WENDIGO_RADIO_CORE     (tskNO_AFFINITY)
+    #define WENDIGO_PIPELINE_CORE  (tskNO_AFFINITY)
+#endif
+
+/* Processes a capture. `data` belongs to the pipeline and is freed on return */
+typedef void (*wendigo_pipeline_handler)(void *data);
+
+typedef struct wendigo_pipeline_stats {
+    bool running;
+    uint16_t queued;        /* Captures waiting now */
+    uint16_t high_water;    /* Most captures ever waiting at once */
+    uint32_t processed;
+    uint32_t dropped;       /* Queue full or out of memory */
+} wendigo_pipeline_stats;
+
+esp_err_t wendigo_pipeline_start();
+bool wendigo_pipeline_running();
+bool wendigo_pipeline_submit(wendigo_pipeline_handler handler, const void *data, size_t len);
+void wendigo_pipeline_get_stats(wendigo_pipeline_stats *stats);
+BaseType_t wendigo_task_create(void (*task)(void *), const char *name, uint32_t stack, void *param,
+    UBaseType_t priority, TaskHandle_t *handle, BaseType_t core);
+
+#endif
@@ -0,0 +1,183 @@
+#include "radio_sched.h"
+
+#include <stddef.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include <esp_bt_defs.h>
+#include "freertos/FreeRTOS.h"
+#include "wendigo_common_defs.h"
+
+typedef struct radio_sched_entry {
+    bool enabled;
+    bool measured;          /* yield has been sampled at least once */
+    uint8_t share;
+    uint32_t found;
+    uint32_t slice_found;   /* New devices found during the current slice */
+    uint32_t airtime_ms;
+    uint32_t yield;
+} radio_sched_entry;
+
+static radio_sched_entry sched[RADIO_SCHED_COUNT];
+static volatile uint8_t active_radio = RADIO_SCHED_COUNT;
+/* Held for every access to sched[] */
+static portMUX_TYPE schedLock = portMUX_INITIALIZER_UNLOCKED;
+
+/** Split a round between the enabled radios: The minimum share each, then
+ * what's left in proportion to their yields. Radios that haven't found
+ * anything yet are counted as having a yield of 1 so they split it evenly.
+ * Hold schedLock.
+ */
+static void radio_sched_rebalance() {
+    uint8_t enabled = 0;
+    uint64_t total_yield = 0;
+    for (uint8_t i = 0; i < RADIO_SCHED_COUNT; ++i) {
+        sched[i].share = 0;
+        if (sched[i].enabled) {
+            ++enabled;
+            total_yield += (uint64_t)sched[i].yield + 1;
+        }
+    }
+    if (enabled == 0) {
+        return;
+    }
+    uint8_t min_share = CONFIG_RADIO_SCHED_MIN_SHARE;
+    if (min_share * enabled > 100) {
+        min_share = 100 / enabled;
+    }
+    uint8_t spare = 100 - (min_share * enabled);
+    uint8_t allocated = 0;
+    uint8_t best = RADIO_SCHED_COUNT;
+    for (uint8_t i = 0; i < RADIO_SCHED_COUNT; ++i) {
+        if (!sched[i].enabled) {
+            continue;
+        }
+        sched[i].share = min_share + (uint8_t)((spare * ((uint64_t)sched[i].yield + 1)) / total_yield);
+        allocated += sched[i].share;
+        if (best == RADIO_SCHED_COUNT || sched[i].yield > sched[best].yield) {
+            best = i;
+        }
+    }
+    /* Rounding leftovers go to the most productive radio */
+    sched[best].share += 100 - allocated;
+}
+
+/** Include or exclude `radio` (a RadioSchedRadio) from the schedule. The
+ * change takes effect when the scheduler next calls radio_sched_next().
+ */
+void radio_sched_set_enabled(uint8_t radio, bool enabled) {
+    if (radio >= RADIO_SCHED_COUNT) {
+        return;
+    }
+    portENTER_CRITICAL(&schedLock);
+    if (sched[radio].enabled != enabled) {
+        sched[radio].enabled = enabled;
+        radio_sched_rebalance();
+    }
+    portEXIT_CRITICAL(&schedLock);
+}
+
+/** Choose the radio to run next, round-robin among the enabled radios, and
+ * make it the active radio. Its slice length is placed in `slice_ms`.
+ * Returns RADIO_SCHED_COUNT (and a slice of 0) if no radio is enabled.
+ */
+uint8_t radio_sched_next(uint32_t *slice_ms) {
+    uint8_t next = RADIO_SCHED_COUNT;
+    portENTER_CRITICAL(&schedLock);
+    for (uint8_t i = 1; i <= RADIO_SCHED_COUNT + 1; ++i) {
+        uint8_t candidate = (active_radio + i) % (RADIO_SCHED_COUNT + 1);
+        if (candidate < RADIO_SCHED_COUNT && sched[candidate].enabled) {
+            next = candidate;
+            break;
+        }
+    }
+    active_radio = next;
+    if (next == RADIO_SCHED_COUNT) {
+        *slice_ms = 0;
+    } else {
+        sched[next].slice_found = 0;
+        *slice_ms = ((uint32_t)CONFIG_RADIO_SCHED_PERIOD_MILLIS * sched[next].share) / 100;
+        if (*slice_ms == 0) {
+            *slice_ms = 1;
+        }
+    }
+    portEXIT_CRITICAL(&schedLock);
+    return next;
+}
+
+/** Record that `radio` has had `elapsed_ms` of airtime since radio_sched_next()
+ * chose it, fold the new devices it found into its yield and re-split the round.
+ */
+void radio_sched_slice_end(uint8_t radio, uint32_t elapsed_ms) {
+    if (radio >= RADIO_SCHED_COUNT) {
+        return;
+    }
+    portENTER_CRITICAL(&schedLock);
+    radio_sched_entry *entry = &sched[radio];
+    entry->airtime_ms += elapsed_ms;
+    if (elapsed_ms > 0) {
+        uint32_t sample = (uint32_t)(((uint64_t)entry->slice_found * 3600000) / elapsed_ms);
+        if (entry->measured) {
+            entry->yield = (uint32_t)(((uint64_t)sample * CONFIG_RADIO_SCHED_YIELD_WEIGHT +
+                (uint64_t)entry->yield * (100 - CONFIG_RADIO_SCHED_YIELD_WEIGHT)) / 100);
+        } else {
+            entry->yield = sample;
+            entry->measured = true;
+        }
+    }
+    entry->slice_found = 0;
+    radio_sched_rebalance();
+    portEXIT_CRITICAL(&schedLock);
+}
+
+/** The radio whose slice it is, or RADIO_SCHED_COUNT if none */
+uint8_t radio_sched_active() {
+    return active_radio;
+}
+
+/** Whether it's `radio`'s slice - Scan-complete callbacks restart scanning only if so */
+bool radio_sched_is_active(uint8_t radio) {
+    return (radio < RADIO_SCHED_COUNT && active_radio == radio);
+}
+
+/** Credit a newly-discovered device of type `scanType` to the radio that found it */
+void radio_sched_device_found(uint8_t scanType) {
+    uint8_t radio = (scanType == SCAN_HCI) ? RADIO_SCHED_HCI :
+                    (scanType == SCAN_BLE) ? RADIO_SCHED_BLE :
+                    (scanType == SCAN_WIFI_AP || scanType == SCAN_WIFI_STA) ? RADIO_SCHED_WIFI :
+                    RADIO_SCHED_COUNT;
+    if (radio < RADIO_SCHED_COUNT) {
+        portENTER_CRITICAL(&schedLock);
+        ++sched[radio].found;
+        ++sched[radio].slice_found;
+        portEXIT_CRITICAL(&schedLock);
+    }
+}
+
+void radio_sched_get_stats(uint8_t radio, radio_sched_stats *stats) {
+    memset(stats, 0, sizeof(radio_sched_stats));
+    if (radio >= RADIO_SCHED_COUNT) {
+        return;
+    }
+    portENTER_CRITICAL(&schedLock);
+    stats->enabled = sched[radio].enabled;
+    stats->active = (active_radio == radio);
+    stats->share = sched[radio].share;
+    stats->slice_ms = ((uint32_t)CONFIG_RADIO_SCHED_PERIOD_MILLIS * sched[radio].share) / 100;
+    stats->found = sched[radio].found;
+    stats->airtime_ms = sched[radio].airtime_ms;
+    stats->yield = sched[radio].yield;
+    portEXIT_CRITICAL(&schedLock);
+}
+
+/** Forget every radio's history. Radios stay enabled, and share the round evenly */
+void radio_sched_reset() {
+    portENTER_CRITICAL(&schedLock);
+    for (uint8_t i = 0; i < RADIO_SCHED_COUNT; ++i) {
+        bool enabled = sched[i].enabled;
+        memset(&sched[i], 0, sizeof(radio_sched_entry));
+        sched[i].enabled = enabled;
+    }
+    radio_sched_rebalance();
+    portEXIT_CRITICAL(&schedLock);
+}
@@ -0,0 +1,62 @@
+#ifndef WENDIGO_RADIO_SCHED_H
+#define WENDIGO_RADIO_SCHED_H
+
+/** Time-slicing of the ESP32's shared radio between Bluetooth Classic, BLE
+ * and WiFi scanning.
+ * The radios can't all listen at once - they share one antenna through the
+ * coexistence arbiter - so rather than leaving each to restart itself and
+ * fight for airtime, the scheduler runs the enabled radios one at a time in
+ * rounds of CONFIG_RADIO_SCHED_PERIOD_MILLIS. Each enabled radio is
+ * guaranteed CONFIG_RADIO_SCHED_MIN_SHARE percent of a round; the remainder
+ * is split in proportion to each radio's discovery yield, the number of new
+ * devices it finds per minute of airtime, smoothed over its recent slices.
+ * A radio that's the only one enabled has the whole round and is never
+ * interrupted.
+ * This file only decides who runs and for how long - the task that starts
+ * and stops the radios is in wendigo.c - so it can be exercised on a host.
+ * Devices are counted from the pipeline while the scheduler task ends
+ * slices and the console enables radios, on both cores, so every access to
+ * the schedule holds a spinlock. Nothing done under it blocks.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sdkconfig.h"
+
+#ifndef CONFIG_RADIO_SCHED_PERIOD_MILLIS
+    #define CONFIG_RADIO_SCHED_PERIOD_MILLIS 12000
+#endif
+#ifndef CONFIG_RADIO_SCHED_MIN_SHARE
+    #define CONFIG_RADIO_SCHED_MIN_SHARE 15
+#endif
+#ifndef CONFIG_RADIO_SCHED_YIELD_WEIGHT
+    #define CONFIG_RADIO_SCHED_YIELD_WEIGHT 30
+#endif
+
+typedef enum {
+    RADIO_SCHED_HCI = 0,
+    RADIO_SCHED_BLE,
+    RADIO_SCHED_WIFI,
+    RADIO_SCHED_COUNT       /* Also means "no radio" */
+} RadioSchedRadio;
+
+typedef struct radio_sched_stats {
+    bool enabled;
+    bool active;            /* It's this radio's slice */
+    uint8_t share;          /* Percentage of each round allocated to the radio */
+    uint32_t slice_ms;      /* Length of its slice in each round */
+    uint32_t found;         /* New devices found since the scheduler was reset */
+    uint32_t airtime_ms;    /* Time scheduled since the scheduler was reset, wrapping */
+    uint32_t yield;         /* Smoothed new devices per hour of airtime */
+} radio_sched_stats;
+
+void radio_sched_set_enabled(uint8_t radio, bool enabled);
+uint8_t radio_sched_next(uint32_t *slice_ms);
+void radio_sched_slice_end(uint8_t radio, uint32_t elapsed_ms);
+uint8_t radio_sched_active();
+bool radio_sched_is_active(uint8_t radio);
+void radio_sched_device_found(uint8_t scanType);
+void radio_sched_get_stats(uint8_t radio, radio_sched_stats *stats);
+void radio_sched_reset();
+
+#endif
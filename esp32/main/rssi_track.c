@@ -0,0 +1,110 @@
+#include "rssi_track.h"
+
+#include <string.h>
+
+/* 24.8 fixed point */
+#define FIXED_ONE (256)
+
+static rssi_track_entry tracked[CONFIG_FOCUS_RSSI_MAX_DEVICES];
+
+static rssi_track_entry *entry_for_mac(const uint8_t *mac) {
+    for (uint8_t i = 0; i < CONFIG_FOCUS_RSSI_MAX_DEVICES; ++i) {
+        if (tracked[i].used && memcmp(tracked[i].mac, mac, ESP_BD_ADDR_LEN) == 0) {
+            return &tracked[i];
+        }
+    }
+    return NULL;
+}
+
+/** Divide, rounding half away from zero */
+static int32_t divide_rounded(int64_t dividend, int64_t divisor) {
+    return (int32_t)((dividend >= 0) ? (dividend + divisor / 2) / divisor : (dividend - divisor / 2) / divisor);
+}
+
+/** Fold a reading of `rssi` dBm from `mac` into its estimate, giving it a
+ * slot if it doesn't have one.
+ */
+void rssi_track_sample(const uint8_t *mac, int16_t rssi, uint32_t now_ms) {
+    rssi_track_entry *entry = entry_for_mac(mac);
+    if (entry == NULL) {
+        for (uint8_t i = 0; i < CONFIG_FOCUS_RSSI_MAX_DEVICES; ++i) {
+            if (!tracked[i].used) {
+                entry = &tracked[i];
+                break;
+            } else if (entry == NULL || (int32_t)(tracked[i].last_ms - entry->last_ms) < 0) {
+                entry = &tracked[i];
+            }
+        }
+        memset(entry, 0, sizeof(rssi_track_entry));
+        memcpy(entry->mac, mac, ESP_BD_ADDR_LEN);
+        entry->used = true;
+        /* The first reading is all there is to go on */
+        entry->estimate = (int32_t)rssi * FIXED_ONE;
+        entry->variance = CONFIG_FOCUS_RSSI_MEASUREMENT_NOISE * FIXED_ONE;
+    } else {
+        /* Predict: The device may have moved since the last reading */
+        int32_t variance = entry->variance + CONFIG_FOCUS_RSSI_PROCESS_NOISE * FIXED_ONE;
+        /* Update: Gain is the share of the difference that's believed */
+        int32_t gain = (int32_t)(((int64_t)variance * FIXED_ONE) /
+            (variance + CONFIG_FOCUS_RSSI_MEASUREMENT_NOISE * FIXED_ONE));
+        int32_t error = (int32_t)rssi * FIXED_ONE - entry->estimate;
+        entry->estimate += divide_rounded((int64_t)gain * error, FIXED_ONE);
+        entry->variance = divide_rounded((int64_t)(FIXED_ONE - gain) * variance, FIXED_ONE);
+    }
+    entry->raw = rssi;
+    entry->last_ms = now_ms;
+    if (entry->samples < UINT16_MAX) {
+        ++entry->samples;
+    }
+}
+
+/** Stop tracking `mac`. Returns false if it wasn't tracked */
+bool rssi_track_remove(const uint8_t *mac) {
+    rssi_track_entry *entry = entry_for_mac(mac);
+    if (entry == NULL) {
+        return false;
+    }
+    memset(entry, 0, sizeof(rssi_track_entry));
+    return true;
+}
+
+/** Place a frame for each tracked device in `frames`, which can hold `max`,
+ * and restart each device's sample count. Devices that have expired are
+ * dropped rather than reported. Returns the number of frames.
+ */
+uint8_t rssi_track_frames(uint32_t now_ms, rssi_track_frame *frames, uint8_t max) {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < CONFIG_FOCUS_RSSI_MAX_DEVICES && count < max; ++i) {
+        if (!tracked[i].used) {
+            continue;
+        }
+        if ((uint32_t)(now_ms - tracked[i].last_ms) >= RSSI_TRACK_EXPIRE_MILLIS) {
+            memset(&tracked[i], 0, sizeof(rssi_track_entry));
+            continue;
+        }
+        rssi_track_frame *frame = &frames[count++];
+        frame->slot = i;
+        memcpy(frame->mac, tracked[i].mac, ESP_BD_ADDR_LEN);
+        frame->filtered = (int16_t)divide_rounded((int64_t)tracked[i].estimate * 10, FIXED_ONE);
+        frame->raw = tracked[i].raw;
+        frame->samples = tracked[i].samples;
+        tracked[i].samples = 0;
+    }
+    return count;
+}
+
+/** Number of devices being tracked */
+uint8_t rssi_track_count() {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < CONFIG_FOCUS_RSSI_MAX_DEVICES; ++i) {
+        if (tracked[i].used) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+/** Stop tracking every device */
+void rssi_track_reset() {
+    memset(tracked, 0, sizeof(tracked));
+}
@@ -0,0 +1,72 @@
+#ifndef WENDIGO_RSSI_TRACK_H
+#define WENDIGO_RSSI_TRACK_H
+
+/** Focus Mode signal strength tracking.
+ * Locating a device means walking towards it while watching its RSSI, but a
+ * single reading is a poor guide - multipath and body shadowing move it by
+ * 10dB or more from one packet to the next. Each tagged device heard in
+ * Focus Mode is given a slot in a small fixed table and its readings are
+ * smoothed by a one-dimensional Kalman filter:
+ *  * The estimate is assumed to drift by CONFIG_FOCUS_RSSI_PROCESS_NOISE
+ *    (variance, dBm squared) between readings, which is how quickly it can
+ *    follow someone walking about.
+ *  * Each reading is assumed to be off by CONFIG_FOCUS_RSSI_MEASUREMENT_NOISE
+ *    (variance, dBm squared). The larger this is compared to the process
+ *    noise, the smoother and slower the estimate.
+ * Arithmetic is in 24.8 fixed point so it costs a handful of integer
+ * operations per reading. rssi_track_frames() collects a frame for every
+ * tracked device, which focus.c sends at CONFIG_FOCUS_RSSI_RATE_HZ however
+ * often the device itself is heard. A device that hasn't been heard for
+ * RSSI_TRACK_EXPIRE_MILLIS gives up its slot, as does the device heard
+ * least recently when a new one needs a slot and the table is full.
+ * Nothing here needs ESP-IDF, so it can be exercised on a host. It isn't
+ * thread-safe; callers hold a lock.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sdkconfig.h"
+#include <esp_bt_defs.h>
+
+#ifndef CONFIG_FOCUS_RSSI_MAX_DEVICES
+    #define CONFIG_FOCUS_RSSI_MAX_DEVICES 8
+#endif
+#ifndef CONFIG_FOCUS_RSSI_RATE_HZ
+    #define CONFIG_FOCUS_RSSI_RATE_HZ 10
+#endif
+#ifndef CONFIG_FOCUS_RSSI_PROCESS_NOISE
+    #define CONFIG_FOCUS_RSSI_PROCESS_NOISE 1
+#endif
+#ifndef CONFIG_FOCUS_RSSI_MEASUREMENT_NOISE
+    #define CONFIG_FOCUS_RSSI_MEASUREMENT_NOISE 16
+#endif
+
+/* A device not heard for this long stops being tracked */
+#define RSSI_TRACK_EXPIRE_MILLIS 30000
+
+typedef struct rssi_track_entry {
+    uint8_t mac[ESP_BD_ADDR_LEN];
+    bool used;
+    int16_t raw;            /* Latest reading (dBm) */
+    int32_t estimate;       /* Filtered RSSI, dBm in 24.8 fixed point */
+    int32_t variance;       /* Of the estimate, dBm squared in 24.8 fixed point */
+    uint16_t samples;       /* Readings since the last frame */
+    uint32_t last_ms;       /* When the latest reading was taken */
+} rssi_track_entry;
+
+/* One device's contribution to an rssi packet */
+typedef struct rssi_track_frame {
+    uint8_t slot;
+    uint8_t mac[ESP_BD_ADDR_LEN];
+    int16_t filtered;       /* Tenths of a dBm */
+    int16_t raw;
+    uint16_t samples;
+} rssi_track_frame;
+
+void rssi_track_sample(const uint8_t *mac, int16_t rssi, uint32_t now_ms);
+bool rssi_track_remove(const uint8_t *mac);
+uint8_t rssi_track_frames(uint32_t now_ms, rssi_track_frame *frames, uint8_t max);
+uint8_t rssi_track_count();
+void rssi_track_reset();
+
+#endif
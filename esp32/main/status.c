@@ -1,15 +1,22 @@
 #include "status.h"
+#include "ble_filter.h"
+#include "bluetooth.h"
 #include "common.h"
+#include "pipeline.h"
+#include "radio_sched.h"
 #include "portmacro.h"
 
 #define NAME_MAX_LEN   (uint8_t)35
 #define VAL_MAX_LEN    (uint8_t)20
-#define ATTR_COUNT_MAX (uint8_t)13
+#define ATTR_COUNT_MAX (uint8_t)20
 
 char *attribute_names[] = {"Version:", "Chris Bennetts-Cash", "BT UUID Dictionary?", "BT Classic Support?",
                            "BT Low Energy Support?", "WiFi Support?", "BT Classic Scanning:",
                            "BT Low Energy Scanning:", "WiFi Scanning:", "BT Classic Devices:",
-                           "BT Low Energy Devices:", "WiFi STA Devices:", "WiFi APs:"};
+                           "BT Low Energy Devices:", "WiFi STA Devices:", "WiFi APs:",
+                           "BLE Adverts Suppressed:", "BT Classic Schedule:", "BLE Schedule:",
+                           "WiFi Schedule:", "BLE Scan Mode:", "GATT Discovery:",
+                           "Capture Pipeline:"};
 char attribute_values[ATTR_COUNT_MAX][VAL_MAX_LEN];
 
 uint16_t classicDeviceCount = 0;
@@ -31,8 +38,29 @@ enum StatusAttributes {
     ATTR_BT_BLE_COUNT,
     ATTR_WIFI_STA_COUNT,
     ATTR_WIFI_AP_COUNT,
+    ATTR_BLE_SUPPRESSED,
+    ATTR_BT_CLASSIC_SCHEDULE,
+    ATTR_BT_BLE_SCHEDULE,
+    ATTR_WIFI_SCHEDULE,
+    ATTR_BLE_SCAN_MODE,
+    ATTR_GATT_DISCOVERY,
+    ATTR_PIPELINE,
 };
 
+/** Describe `radio`'s share of the radio schedule and the number of new
+ *  devices it finds per minute of airtime, e.g. "40% 12.5/min".
+ */
+static void radio_schedule_string(uint8_t radio, char *value, uint8_t len) {
+    radio_sched_stats stats;
+    radio_sched_get_stats(radio, &stats);
+    if (!stats.enabled) {
+        snprintf(value, len, "%s", STRING_IDLE);
+    } else {
+        snprintf(value, len, "%u%% %lu.%lu/min", stats.share, (unsigned long)(stats.yield / 60),
+                 (unsigned long)((stats.yield % 60) / 6));
+    }
+}
+
 /** Prepares data for display by the status command.
  * The function populates attribute_values[].
  */
@@ -78,6 +106,25 @@ void initialise_status_details(bool uuidDictionarySupported, bool btClassicSuppo
     snprintf(attribute_values[ATTR_BT_BLE_COUNT], VAL_MAX_LEN, "%d", leDeviceCount);
     snprintf(attribute_values[ATTR_WIFI_STA_COUNT], VAL_MAX_LEN, "%d", wifiSTACount);
     snprintf(attribute_values[ATTR_WIFI_AP_COUNT], VAL_MAX_LEN, "%d", wifiAPCount);
+    snprintf(attribute_values[ATTR_BLE_SUPPRESSED], VAL_MAX_LEN, "%u%%", ble_filter_suppressed_percent());
+    radio_schedule_string(RADIO_SCHED_HCI, attribute_values[ATTR_BT_CLASSIC_SCHEDULE], VAL_MAX_LEN);
+    radio_schedule_string(RADIO_SCHED_BLE, attribute_values[ATTR_BT_BLE_SCHEDULE], VAL_MAX_LEN);
+    radio_schedule_string(RADIO_SCHED_WIFI, attribute_values[ATTR_WIFI_SCHEDULE], VAL_MAX_LEN);
+    snprintf(attribute_values[ATTR_BLE_SCAN_MODE], VAL_MAX_LEN, "%s %u%%",
+             (wendigo_ble_scan_policy()->active) ? STRING_ACTIVE : "PASSIVE",
+             ble_scan_policy_duty_percent(wendigo_ble_scan_policy()));
+    gatt_discovery_stats gatt_stats;
+    wendigo_gatt_discovery_stats(&gatt_stats);
+    snprintf(attribute_values[ATTR_GATT_DISCOVERY], VAL_MAX_LEN, "%u active %u queued",
+             gatt_stats.active, gatt_stats.waiting);
+    wendigo_pipeline_stats pipeline_stats;
+    wendigo_pipeline_get_stats(&pipeline_stats);
+    if (pipeline_stats.running) {
+        snprintf(attribute_values[ATTR_PIPELINE], VAL_MAX_LEN, "peak %u lost %lu",
+                 pipeline_stats.high_water, (unsigned long)pipeline_stats.dropped);
+    } else {
+        snprintf(attribute_values[ATTR_PIPELINE], VAL_MAX_LEN, "INLINE");
+    }
 
     /* Now values have been written, loop through attributes again to ensure everything has a null byte */
     for (uint8_t i = 0; i < ATTR_COUNT_MAX; ++i) {
@@ -143,19 +190,41 @@ void display_status_interactive() {
     print_row_start(4);
     printf("WiFi Stations: %28d", wifiSTACount);
     print_row_end(4);
+    print_row_start(4);
+    printf("BLE Adverts Suppressed: %18u%%", ble_filter_suppressed_percent());
+    print_row_end(4);
+    print_row_start(4);
+    printf("BT Classic Schedule: %22s", attribute_values[ATTR_BT_CLASSIC_SCHEDULE]);
+    print_row_end(4);
+    print_row_start(4);
+    printf("BLE Schedule: %29s", attribute_values[ATTR_BT_BLE_SCHEDULE]);
+    print_row_end(4);
+    print_row_start(4);
+    printf("WiFi Schedule: %28s", attribute_values[ATTR_WIFI_SCHEDULE]);
+    print_row_end(4);
+    print_row_start(4);
+    printf("BLE Scan Mode: %28s", attribute_values[ATTR_BLE_SCAN_MODE]);
+    print_row_end(4);
+    print_row_start(4);
+    printf("GATT Discovery: %27s", attribute_values[ATTR_GATT_DISCOVERY]);
+    print_row_end(4);
+    print_row_start(4);
+    printf("Capture Pipeline: %25s", attribute_values[ATTR_PIPELINE]);
+    print_row_end(4);
     print_empty_row(53);
     print_star(53, true);
 }
 
 /** Send status information to Flipper Zero.
- *  A status packet commences with 4 bytes of 0xEE followed by 4 bytes of 0xBB
- *  This is followed by 1 byte that specifies the number of attributes contained
- *  in the packet and then repeats the following pattern that number of tumes:
+ *  A status packet commences with PREAMBLE_STATUS followed by 1 byte that
+ *  specifies the number of attributes contained in the packet and then
+ *  repeats the following pattern that number of times:
  *  * 1 byte specifying the length of the attribute name
- *  * The attribute name (the terminating'\0' is ommitted)
- *  * 1 byte specifying the legth of the attribute value
- *  * The attribute value (the terminating '\0' is ommitted)
- *  The packet is terminated with 4 bytes of 0xAA and 4 bytes of 0xFF.
+ *  * The attribute name (the terminating '\0' is omitted)
+ *  * 1 byte specifying the length of the attribute value
+ *  * The attribute value (the terminating '\0' is omitted)
+ *  The packet is terminated with PACKET_TERM.
+ *  The layout is defined by the status packet in protocol/wendigo_packets.schema.
  */
 void display_status_uart() {
     /* Get features supported by the ESP32 chip */
@@ -166,23 +235,24 @@ void display_status_uart() {
     bool wifiSupported = ((supported & HW_WIFI_SUPPORTED) != 0);
     initialise_status_details(uuidDictionarySupported, btClassicSupported, btBLESupported, wifiSupported);
 
-    if (xSemaphoreTake(uartMutex, portMAX_DELAY)) { /* Wait for the talking stick */
-        send_bytes(PREAMBLE_STATUS, PREAMBLE_LEN);
-
-        uint8_t attr_count = ATTR_COUNT_MAX;
-        send_bytes(&attr_count, 1);
+    /* Interleave attribute_names[] and attribute_values[] */
+    char *attributes[ATTR_COUNT_MAX * 2];
+    for (uint8_t i = 0; i < ATTR_COUNT_MAX; ++i) {
+        attributes[i * 2] = attribute_names[i];
+        attributes[(i * 2) + 1] = attribute_values[i];
+    }
+    wendigo_pkt_status pkt = {.attr_count = ATTR_COUNT_MAX, .attributes = attributes};
+    uint16_t packet_len = wendigo_pkt_status_size(&pkt);
+    uint8_t *packet = malloc(packet_len);
+    if (packet == NULL) {
+        outOfMemory();
+        return;
+    }
+    wendigo_pkt_status_encode(&pkt, packet, packet_len);
 
-        /* Loop ATTR_COUNT_MAX times, sending elements from attribute_names[] and attribute_values[] */
-        uint8_t len;
-        for (uint8_t i = 0; i < ATTR_COUNT_MAX; ++i) {
-            len = strlen(attribute_names[i]);
-            send_bytes(&len, 1);
-            send_bytes((uint8_t *)(attribute_names[i]), len);
-            len = strlen(attribute_values[i]);
-            send_bytes(&len, 1);
-            send_bytes((uint8_t *)(attribute_values[i]), len);
-        }
-        send_end_of_packet();
+    if (xSemaphoreTake(uartMutex, portMAX_DELAY)) { /* Wait for the talking stick */
+        send_bytes(packet, packet_len);
         xSemaphoreGive(uartMutex);
     }
+    free(packet);
 }
@@ -9,9 +9,13 @@
 
 #include "wendigo.h"
 #include "common.h"
+#include "esp_timer.h"
 #include "freertos/idf_additions.h"
 #include "wifi.h"
 #include "bluetooth.h"
+#include "focus.h"
+#include "pipeline.h"
+#include "radio_sched.h"
 #include "status.h"
 #include <driver/uart_vfs.h>
 /* Required in order to disable command hints */
@@ -30,6 +34,8 @@
 
 #define PROMPT_STR CONFIG_IDF_TARGET
 
+TaskHandle_t radioSchedTask = NULL; /* Runs the radios in turn - See radio_sched.h */
+
 /* Console command history can be stored to and loaded from a file.
  * The easiest way to do this is to use FATFS filesystem on top of
  * wear_levelling library.
@@ -248,13 +254,92 @@ esp_err_t enableDisableRadios(int argc, char **argv, uint8_t radio, esp_err_t (*
     return ESP_OK;
 }
 
+/** Start scanning with `radio` (a RadioSchedRadio) for a slice of `slice_ms` */
+static esp_err_t radio_slice_start(uint8_t radio, uint32_t slice_ms) {
+    switch (radio) {
+        case RADIO_SCHED_HCI:
+            return wendigo_bt_slice_start(slice_ms);
+        case RADIO_SCHED_BLE:
+            return wendigo_ble_slice_start(slice_ms);
+        case RADIO_SCHED_WIFI:
+            return wendigo_wifi_slice_start(slice_ms);
+        default:
+            return ESP_ERR_INVALID_ARG;
+    }
+}
+
+/** Stop scanning with `radio` (a RadioSchedRadio) at the end of its slice */
+static esp_err_t radio_slice_stop(uint8_t radio) {
+    switch (radio) {
+        case RADIO_SCHED_HCI:
+            return wendigo_bt_slice_stop();
+        case RADIO_SCHED_BLE:
+            return wendigo_ble_slice_stop();
+        case RADIO_SCHED_WIFI:
+            return wendigo_wifi_slice_stop();
+        default:
+            return ESP_ERR_INVALID_ARG;
+    }
+}
+
+/** Callback function executed by the radio scheduler task.
+ *  Runs each enabled radio for the slice radio_sched_next() gives it, in turn.
+ *  A radio that's chosen again is left running rather than restarted, and the
+ *  task sleeps while no radio is enabled. Notifying the task ends the current
+ *  slice early, so that enabling or disabling a radio takes effect at once.
+ */
+static void radioSchedCallback(void *pvParameter) {
+    uint8_t running = RADIO_SCHED_COUNT;
+    while (true) {
+        uint32_t slice_ms = 0;
+        /* This makes `next` the active radio before `running` is stopped, so
+           its scan-complete callback doesn't restart it */
+        uint8_t next = radio_sched_next(&slice_ms);
+        if (next != running) {
+            if (running != RADIO_SCHED_COUNT) {
+                radio_slice_stop(running);
+            }
+            if (next != RADIO_SCHED_COUNT && radio_slice_start(next, slice_ms) != ESP_OK &&
+                    scanStatus[SCAN_INTERACTIVE] == ACTION_ENABLE) {
+                ESP_LOGW(TAG, "Radio scheduler failed to start radio %d", next);
+            }
+            running = next;
+        }
+        if (running == RADIO_SCHED_COUNT) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            continue;
+        }
+        int64_t slice_started = esp_timer_get_time();
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(slice_ms));
+        radio_sched_slice_end(running, (uint32_t)((esp_timer_get_time() - slice_started) / 1000));
+    }
+}
+
+/** Bring the radio scheduler into line with scanStatus[] after a radio has
+ *  been enabled or disabled, starting the scheduler task if it isn't running.
+ */
+void wendigo_radio_sched_update() {
+    radio_sched_set_enabled(RADIO_SCHED_HCI, scanStatus[SCAN_HCI] == ACTION_ENABLE);
+    radio_sched_set_enabled(RADIO_SCHED_BLE, scanStatus[SCAN_BLE] == ACTION_ENABLE);
+    radio_sched_set_enabled(RADIO_SCHED_WIFI, scanStatus[SCAN_WIFI_AP] == ACTION_ENABLE ||
+                                              scanStatus[SCAN_WIFI_STA] == ACTION_ENABLE);
+    if (radioSchedTask == NULL) {
+        wendigo_task_create(radioSchedCallback, "radioSchedCallback", 3072, NULL, CONFIG_RADIO_SCHED_TASK_PRIORITY,
+            &radioSchedTask, WENDIGO_RADIO_CORE);
+    } else {
+        xTaskNotifyGive(radioSchedTask);
+    }
+}
+
 esp_err_t cmd_bluetooth(int argc, char **argv) {
     enableDisableRadios(argc, argv, SCAN_HCI, wendigo_bt_enable, wendigo_bt_disable);
+    wendigo_radio_sched_update();
     return ESP_OK;
 }
 
 esp_err_t cmd_ble(int argc, char **argv) {
     enableDisableRadios(argc, argv, SCAN_BLE, wendigo_ble_enable, wendigo_ble_disable);
+    wendigo_radio_sched_update();
     return ESP_OK;
 }
 
@@ -262,6 +347,7 @@ esp_err_t cmd_wifi(int argc, char **argv) {
     enableDisableRadios(argc, argv, SCAN_WIFI_AP, wendigo_wifi_enable, wendigo_wifi_disable);
     /* This sets scanStatus[] - Don't need to call the enable/disable function again */
     enableDisableRadios(argc, argv, SCAN_WIFI_STA, NULL, NULL);
+    wendigo_radio_sched_update();
     return ESP_OK;
 }
 
@@ -378,8 +464,13 @@ esp_err_t cmd_version(int argc, char **argv) {
     } else {
         /* Wait for the talking stick */
         if (xSemaphoreTake(uartMutex, portMAX_DELAY) == pdTRUE) {
-            send_bytes((uint8_t *)msg, strlen(msg) + 1);
-            send_end_of_packet();
+            /* The version packet's preamble is the first 4 bytes of "Wendigo" */
+            wendigo_pkt_version pkt = {
+                .version = (uint8_t *)msg + PREAMBLE_LEN,
+                .version_len = strlen(msg) + 1 - PREAMBLE_LEN,
+            };
+            uint8_t packet[sizeof(msg) + WENDIGO_PKT_PREAMBLE_LEN];
+            send_bytes(packet, wendigo_pkt_version_encode(&pkt, packet, sizeof(packet)));
             xSemaphoreGive(uartMutex);
         } else {
             // TODO: Log error
@@ -435,6 +526,7 @@ esp_err_t cmd_tag(int argc, char **argv) {
             switch (action) {
                 case ACTION_DISABLE:
                     device->tagged = false;
+                    wendigo_focus_forget(device->mac);
                     if (scanStatus[SCAN_INTERACTIVE] == ACTION_ENABLE) {
                         ESP_LOGI(TAG, "Device %s untagged", argv[2]);
                     }
@@ -444,6 +536,14 @@ esp_err_t cmd_tag(int argc, char **argv) {
                     if (scanStatus[SCAN_INTERACTIVE] == ACTION_ENABLE) {
                         ESP_LOGI(TAG, "Device %s tagged", argv[2]);
                     }
+                    /* Find out what services a tagged BLE device has beyond those it advertises.
+                       Discovery is queued, so tagging doesn't wait for it */
+                    if (device->scanType == SCAN_BLE) {
+                        esp_err_t gatt_err = wendigo_gatt_discover(device->mac);
+                        if (gatt_err != ESP_OK && scanStatus[SCAN_INTERACTIVE] == ACTION_ENABLE) {
+                            ESP_LOGW(TAG, "Unable to queue GATT discovery of %s: %s", argv[2], esp_err_to_name(gatt_err));
+                        }
+                    }
                     break;
                 case ACTION_STATUS:
                     if (scanStatus[SCAN_INTERACTIVE] == ACTION_ENABLE) {
@@ -477,9 +577,14 @@ esp_err_t cmd_focus(int argc, char **argv) {
         case ACTION_DISABLE:
             scanStatus[SCAN_FOCUS] = ACTION_DISABLE;
             /* Everything else should take care of itself */
+            result = wendigo_focus_enable(false);
             break;
         case ACTION_ENABLE:
-            scanStatus[SCAN_FOCUS] = ACTION_ENABLE;
+            /* Start the RSSI tracker before samples can arrive */
+            result = wendigo_focus_enable(true);
+            if (result == ESP_OK) {
+                scanStatus[SCAN_FOCUS] = ACTION_ENABLE;
+            }
             break;
         case ACTION_STATUS:
             if (scanStatus[SCAN_INTERACTIVE] == ACTION_ENABLE) {
@@ -560,6 +665,8 @@ void app_main(void)
      */
     repl_config.prompt = "";
     repl_config.max_cmdline_length = CONFIG_CONSOLE_MAX_COMMAND_LINE_LENGTH;
+    /* Keep command handling off the core the radios run on */
+    repl_config.task_core_id = WENDIGO_PIPELINE_CORE;
 
 
     initialize_nvs();
@@ -590,6 +697,10 @@ void app_main(void)
     
     /* Create the UART mutex */
     uartMutex = xSemaphoreCreateMutex();
+    /* Parse captures on the other core from the radios, if there is one */
+    if (wendigo_pipeline_start() != ESP_OK) {
+        ESP_LOGW(TAG, "Unable to start the pipeline task, captures will be parsed by the radio tasks");
+    }
 
     #if defined(CONFIG_ESP_CONSOLE_UART_DEFAULT) || defined(CONFIG_ESP_CONSOLE_UART_CUSTOM)
         esp_console_dev_uart_config_t hw_config = ESP_CONSOLE_DEV_UART_CONFIG_DEFAULT();
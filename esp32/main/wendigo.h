@@ -32,6 +32,7 @@ esp_err_t send_response(char *cmd, char *arg, MsgType result);
 ActionType parseCommand(int argc, char **argv);
 ActionType parse_command_tag(int argc, char **argv, esp_bd_addr_t addr);
 void wendigo_set_logging(esp_log_level_t level);
+void wendigo_radio_sched_update();
 
 #define CMD_COUNT 19
 esp_console_cmd_t commands[CMD_COUNT] = {
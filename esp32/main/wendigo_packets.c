@@ -0,0 +1 @@
+../../Flipper/wendigo_packets.c
\ No newline at end of file
@@ -0,0 +1 @@
+../../Flipper/wendigo_packets.h
\ No newline at end of file
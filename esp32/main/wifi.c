@@ -1,9 +1,33 @@
 #include "wifi.h"
+#include "assoc_graph.h"
 #include "common.h"
+#include "focus.h"
+#include "hop_timing.h"
+#include "pipeline.h"
 #include "esp_err.h"
+#include "esp_timer.h"
 #include "freertos/idf_additions.h"
 #include "portmacro.h"
 
+/* Offsets for different packet types */
+uint8_t BEACON_SSID_OFFSET = 38;
+uint8_t BEACON_SEQNUM_OFFSET = 22;
+uint8_t BEACON_PRIVACY_OFFSET = 34; /* 0x31 set, 0x21 unset */
+uint8_t BEACON_PACKET_LEN = 57;
+uint8_t PROBE_SSID_OFFSET = 26;
+uint8_t PROBE_SEQNUM_OFFSET = 22;
+uint8_t PROBE_REQUEST_LEN = 42;
+uint8_t PROBE_RESPONSE_PRIVACY_OFFSET = 34; /* On {0x11, 0x11} Off {0x01, 0x11}*/
+uint8_t PROBE_RESPONSE_SSID_OFFSET = 38;
+uint8_t PROBE_RESPONSE_GROUP_CIPHER_OFFSET = 62; /* + ssid_len */
+uint8_t PROBE_RESPONSE_PAIRWISE_CIPHER_OFFSET = 68; /* + ssid_len */
+uint8_t PROBE_RESPONSE_AUTH_TYPE_OFFSET = 74; /* + ssid_len | PROBE_RESPONSE_AUTH_TYPE */
+uint8_t PROBE_RESPONSE_LEN = 173;
+uint8_t DESTADDR_80211_OFFSET = 4; /* Generic 802.11 packet offsets */
+uint8_t SRCADDR_80211_OFFSET = 10;
+uint8_t BSSID_80211_OFFSET = 16;
+uint8_t HEADER_80211_LEN = 24;
+
 /* Array of channels that are to be included in channel hopping.
    At startup this is initialised to include all supported channels. */
 uint8_t *channels = NULL;
@@ -17,7 +41,13 @@ const uint8_t WENDIGO_SUPPORTED_5_CHANNELS[] = {32, 36, 40, 44, 48, 52, 56, 60,
 const uint8_t PRIVACY_ON_BITS[] = {0x11, 0x11};
 const uint8_t PRIVACY_OFF_BITS[] = {0x01, 0x11};
 long hop_millis = CONFIG_DEFAULT_HOP_MILLIS;
-TaskHandle_t channelHopTask = NULL; /* Independent task for channel hopping */
+static esp_timer_handle_t hopTimer = NULL; /* Wakes hopTask at the end of each visit */
+static TaskHandle_t hopTask = NULL;         /* Changes channel */
+static volatile bool hopping = false;
+static int64_t hop_due_us = 0;      /* When hopTimer was due to fire */
+static uint8_t current_channel = 0;
+/* hop_timing is fed by the WiFi task, hopTask and the radio scheduler */
+static portMUX_TYPE hopTimingLock = portMUX_INITIALIZER_UNLOCKED;
 
 // TODO: This is duplicated for Flipper-Wendigo because the ifndef guard isn't working
 uint8_t auth_mode_strings_count = 17;
@@ -30,11 +60,15 @@ bool WIFI_INITIALISED = false;
 static const char *WIFI_TAG = "WiFi@Wendigo";
 
 /* Local function declarations */
-void create_hop_task_if_needed();
-void channelHopCallback(void *pvParameter);
+esp_err_t start_hopping();
+static void hop_timer_cb(void *arg);
+static void hopCallback(void *pvParameter);
 
 /** Override the default implementation so we can send arbitrary 802.11 packets */
 esp_err_t ieee80211_raw_frame_sanity_check(int32_t arg, int32_t arg2, int32_t arg3) {
+    UNUSED(arg);
+    UNUSED(arg2);
+    UNUSED(arg3);
     return ESP_OK;
 }
 
@@ -43,46 +77,57 @@ esp_err_t display_wifi_ap_uart(wendigo_device *dev) {
     if (dev->scanType != SCAN_WIFI_AP) {
         return ESP_ERR_INVALID_ARG;
     }
-    /* Send dev->tagged as 1 for true, 0 for false */
-    uint8_t tagged = (dev->tagged) ? 1 : 0;
+    /* Collect the AP's stations from the association graph - sta_count is a
+       single byte, so send at most UINT8_MAX of them */
+    uint16_t ap_idx = wendigo_device_index(dev);
+    uint16_t *sta_idx = NULL;
+    uint8_t **stations = NULL;
+    uint16_t sta_count = assoc_graph_count(ap_idx);
+    if (sta_count > UINT8_MAX) {
+        sta_count = UINT8_MAX;
+    }
+    if (sta_count > 0) {
+        sta_idx = malloc(sizeof(uint16_t) * sta_count);
+        stations = malloc(sizeof(uint8_t *) * sta_count);
+        if (sta_idx == NULL || stations == NULL) {
+            free(sta_idx);
+            free(stations);
+            return outOfMemory();
+        }
+        sta_count = assoc_graph_stations(ap_idx, sta_idx, sta_count);
+        for (uint16_t i = 0; i < sta_count; ++i) {
+            stations[i] = devices[sta_idx[i]].mac;
+        }
+        free(sta_idx);
+    }
     /* Calculate ssid_len */
     uint8_t ssid_len = strnlen((char *)dev->radio.ap.ssid, MAX_SSID_LEN + 1);
     if (dev->radio.ap.ssid[0] == '\0') {
         ssid_len = 0;
     }
+    wendigo_pkt_wifi_ap pkt = {
+        .scantype = dev->scanType,
+        .channel = dev->radio.ap.channel,
+        .rssi = dev->rssi,
+        /* lastSeen isn't sent */
+        /* Send dev->tagged as 1 for true, 0 for false */
+        .tagged = (dev->tagged) ? 1 : 0,
+        .auth_mode = dev->radio.ap.authmode,
+        .ssid_len = ssid_len,
+        .sta_count = (uint8_t)sta_count,
+        .ssid = (uint8_t *)dev->radio.ap.ssid,
+        .stations = stations,
+    };
+    memcpy(pkt.mac, dev->mac, MAC_BYTES);
     /* Assemble the packet */
-    uint8_t packet_len = WENDIGO_OFFSET_AP_SSID + ssid_len + (MAC_BYTES * dev->radio.ap.stations_count) + PREAMBLE_LEN;
+    uint16_t packet_len = wendigo_pkt_wifi_ap_size(&pkt);
     uint8_t *packet = malloc(sizeof(uint8_t) * packet_len);
     if (packet == NULL) {
+        free(stations);
         return outOfMemory();
     }
-    memcpy(packet, PREAMBLE_WIFI_AP, PREAMBLE_LEN);
-    memcpy(packet + WENDIGO_OFFSET_WIFI_SCANTYPE, &(dev->scanType), sizeof(uint8_t));
-    memcpy(packet + WENDIGO_OFFSET_WIFI_MAC, dev->mac, MAC_BYTES);
-    memcpy(packet + WENDIGO_OFFSET_WIFI_CHANNEL, &(dev->radio.ap.channel), sizeof(uint8_t));
-    memcpy(packet + WENDIGO_OFFSET_WIFI_RSSI, (uint8_t *)&(dev->rssi), sizeof(int16_t));
-    /* Don't bother sending lastSeen */
-    //memcpy(packet + WENDIGO_OFFSET_WIFI_LASTSEEN, (uint8_t *)&(dev->lastSeen.tv_sec), sizeof(int64_t));
-    memcpy(packet + WENDIGO_OFFSET_WIFI_TAGGED, &tagged, sizeof(uint8_t));
-    memcpy(packet + WENDIGO_OFFSET_AP_AUTH_MODE, &(dev->radio.ap.authmode), sizeof(uint8_t));
-    memcpy(packet + WENDIGO_OFFSET_AP_SSID_LEN, &ssid_len, sizeof(uint8_t));
-    memcpy(packet + WENDIGO_OFFSET_AP_STA_COUNT, &(dev->radio.ap.stations_count), sizeof(uint8_t));
-    if (ssid_len > 0) {
-        memcpy(packet + WENDIGO_OFFSET_AP_SSID, dev->radio.ap.ssid, ssid_len);
-    }
-    /* Keep track of the offset while working through stations[] */
-    uint8_t current_offset = WENDIGO_OFFSET_AP_SSID + ssid_len;
-    for (uint8_t i = 0; i < dev->radio.ap.stations_count; ++i) {
-        /* Send the MAC of each connected device */
-        /* It should be impossible to get a NULL station, but cater for it anyway */
-        if (dev->radio.ap.stations == NULL || dev->radio.ap.stations[i] == NULL) {
-            memcpy(packet + current_offset, nullMac, MAC_BYTES);
-        } else {
-            memcpy(packet + current_offset, dev->radio.ap.stations[i], MAC_BYTES);
-        }
-        current_offset += MAC_BYTES;
-    }
-    memcpy(packet + current_offset, PACKET_TERM, PREAMBLE_LEN);
+    wendigo_pkt_wifi_ap_encode(&pkt, packet, packet_len);
+    free(stations);
     /* Send the packet */
     if (xSemaphoreTake(uartMutex, portMAX_DELAY)) {
         send_bytes(packet, packet_len);
@@ -135,7 +180,7 @@ esp_err_t display_wifi_ap_interactive(wendigo_device *dev) {
         print_space(4 + space_left, false);
         printf("Ch. %2d", dev->radio.ap.channel); // TODO: Make space for an additional character, for 5GHz channels
         print_space(space_left, false);
-        printf("%3d Stations Connected", dev->radio.ap.stations_count);
+        printf("%3d Stations Connected", assoc_graph_count(wendigo_device_index(dev)));
         row_len = 38 + (2 * space_left);
         print_space(4 + BANNER_WIDTH - row_len, false);
         print_star(1, true);
@@ -157,7 +202,7 @@ esp_err_t display_wifi_ap_interactive(wendigo_device *dev) {
         /* Cater for rounding in space_left */
         row_len = MAC_STRLEN + 40 + space_left;
         print_space(BANNER_WIDTH - row_len, false);
-        printf("%3d Stations Connected", dev->radio.ap.stations_count);
+        printf("%3d Stations Connected", assoc_graph_count(wendigo_device_index(dev)));
         print_space(4, false);
         print_star(1, true);
     }
@@ -180,8 +225,6 @@ esp_err_t display_wifi_sta_uart(wendigo_device *dev) {
     if (dev->scanType != SCAN_WIFI_STA) {
         return ESP_ERR_INVALID_ARG;
     }
-    /* Send tagged as 1 for true, 0 for false */
-    uint8_t tagged = (dev->tagged) ? 1 : 0;
     /* Calculate ssid_len */
     uint8_t ssid_len = 0;
     char *ssid = NULL;
@@ -190,56 +233,28 @@ esp_err_t display_wifi_sta_uart(wendigo_device *dev) {
         ssid = theAP->radio.ap.ssid;
         ssid_len = strlen(ssid);
     }
+    wendigo_pkt_wifi_sta pkt = {
+        .scantype = dev->scanType,
+        .channel = dev->radio.sta.channel,
+        .rssi = dev->rssi,
+        /* lastSeen isn't sent */
+        /* Send tagged as 1 for true, 0 for false */
+        .tagged = (dev->tagged) ? 1 : 0,
+        .pnl_count = dev->radio.sta.saved_networks_count,
+        .ap_ssid_len = ssid_len,
+        .ap_ssid = (uint8_t *)ssid,
+        /* A NULL SSID in the preferred network list is sent as an empty string */
+        .pnl = dev->radio.sta.saved_networks,
+    };
+    memcpy(pkt.mac, dev->mac, MAC_BYTES);
+    memcpy(pkt.ap_mac, dev->radio.sta.apMac, MAC_BYTES);
     /* Assemble the packet so it can be sent all at once */
-    uint8_t packet_len = WENDIGO_OFFSET_STA_AP_SSID + ssid_len + PREAMBLE_LEN;
-    /* Also account for the preferred network list, if it exists */
-    for (uint8_t i = 0; i < dev->radio.sta.saved_networks_count; ++i) {
-        if (dev->radio.sta.saved_networks[i] != NULL) {
-            packet_len += strlen(dev->radio.sta.saved_networks[i]);
-        }
-        /* Account for the SSID_LEN byte - whether or not current SSID is NULL */
-        ++packet_len;
-    }
+    uint16_t packet_len = wendigo_pkt_wifi_sta_size(&pkt);
     uint8_t *packet = malloc(sizeof(uint8_t) * packet_len);
     if (packet == NULL) {
         return outOfMemory();
     }
-    memcpy(packet, PREAMBLE_WIFI_STA, PREAMBLE_LEN);
-    memcpy(packet + WENDIGO_OFFSET_WIFI_SCANTYPE, &(dev->scanType), sizeof(uint8_t));
-    memcpy(packet + WENDIGO_OFFSET_WIFI_MAC, dev->mac, MAC_BYTES);
-    memcpy(packet + WENDIGO_OFFSET_WIFI_CHANNEL, &(dev->radio.sta.channel), sizeof(uint8_t));
-    memcpy(packet + WENDIGO_OFFSET_WIFI_RSSI, (uint8_t *)&(dev->rssi), sizeof(int16_t));
-    /* Don't bother sending lastSeen */
-    //memcpy(packet + WENDIGO_OFFSET_WIFI_LASTSEEN, (uint8_t *)&(dev->lastSeen.tv_sec), sizeof(int64_t));
-    memcpy(packet + WENDIGO_OFFSET_WIFI_TAGGED, &tagged, sizeof(uint8_t));
-    memcpy(packet + WENDIGO_OFFSET_STA_AP_MAC, dev->radio.sta.apMac, MAC_BYTES);
-    memcpy(packet + WENDIGO_OFFSET_STA_AP_SSID_LEN, &ssid_len, sizeof(uint8_t));
-    /* Send SSID if we have one */
-    if (ssid_len > 0) {
-        memcpy(packet + WENDIGO_OFFSET_STA_AP_SSID, ssid, ssid_len);
-    }
-    /* Send saved_networks_count */
-    memcpy(packet + WENDIGO_OFFSET_STA_PNL_COUNT, &(dev->radio.sta.saved_networks_count), sizeof(uint8_t));
-    /* Send saved_networks[] */
-    uint8_t packetIdx = WENDIGO_OFFSET_STA_AP_SSID + ssid_len;
-    uint8_t pnl_len;
-    for (uint8_t i = 0; i < dev->radio.sta.saved_networks_count; ++i) {
-        if (dev->radio.sta.saved_networks[i] == NULL) {
-            pnl_len = 0;
-        } else {
-            pnl_len = strlen(dev->radio.sta.saved_networks[i]);
-        }
-        /* Add current SSID len */
-        memcpy(packet + packetIdx, &pnl_len, sizeof(uint8_t));
-        ++packetIdx;
-        /* Add current SSID */
-        if (pnl_len > 0) {
-            memcpy(packet + packetIdx, dev->radio.sta.saved_networks[i], pnl_len);
-            packetIdx += pnl_len;
-        }
-    }
-    /* Packet terminator */
-    memcpy(packet + packetIdx, PACKET_TERM, PREAMBLE_LEN);
+    wendigo_pkt_wifi_sta_encode(&pkt, packet, packet_len);
     /* Send the packet */
     if (xSemaphoreTake(uartMutex, portMAX_DELAY)) {
         send_bytes(packet, packet_len);
@@ -331,6 +346,7 @@ esp_err_t display_wifi_sta_interactive(wendigo_device *dev) {
 }
 
 esp_err_t display_wifi_device(wendigo_device *dev, bool force_display) {
+    UNUSED(force_display);
     /* If Focus Mode is enabled only display the device if it's tagged */
     if (dev == NULL) {
         return ESP_OK; /* Not an error */
@@ -356,29 +372,22 @@ esp_err_t display_wifi_device(wendigo_device *dev, bool force_display) {
     return ESP_ERR_INVALID_ARG;
 }
 
-/** Link the specified devices to reflect their association.
+/** Link the specified devices to reflect their association. Both must be
+ *  in devices[]. If `sta` was associated with another AP it's moved, so it's
+ *  no longer listed among that AP's stations.
  */
 esp_err_t set_associated(wendigo_device *sta, wendigo_device *ap) {
     if (sta == NULL || ap == NULL || sta->scanType != SCAN_WIFI_STA || ap->scanType != SCAN_WIFI_AP) {
         return ESP_ERR_INVALID_ARG;
     }
+    uint16_t sta_idx = wendigo_device_index(sta);
+    uint16_t ap_idx = wendigo_device_index(ap);
+    if (sta_idx == devices_count || ap_idx == devices_count) {
+        return ESP_ERR_INVALID_ARG;
+    }
     memcpy(sta->radio.sta.apMac, ap->mac, MAC_BYTES);
-    /* See if sta's MAC is present in ap->radio.ap.stations */
-    uint8_t i;
-    for (i = 0; i < ap->radio.ap.stations_count && (ap->radio.ap.stations[i] == NULL || memcmp(sta->mac, ap->radio.ap.stations[i], MAC_BYTES)); ++i) { }
-    if (i == ap->radio.ap.stations_count) {
-        /* Station not found in ap->radio.ap.stations - Add it */
-        uint8_t **new_stations = realloc(ap->radio.ap.stations, sizeof(uint8_t *) * (ap->radio.ap.stations_count + 1));
-        if (new_stations == NULL) {
-            return outOfMemory();
-        }
-        ap->radio.ap.stations = new_stations;
-        new_stations[ap->radio.ap.stations_count] = malloc(MAC_BYTES);
-        /* Make sure we still increment stations_count if we can't malloc the MAC */
-        if (new_stations[ap->radio.ap.stations_count++] == NULL) {
-            return outOfMemory();
-        }
-        memcpy(new_stations[ap->radio.ap.stations_count - 1], sta->mac, MAC_BYTES);
+    if (!assoc_graph_link(sta_idx, ap_idx)) {
+        return outOfMemory();
     }
     return ESP_OK;
 }
@@ -414,8 +423,13 @@ esp_err_t parse_beacon(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
         }
     }
     uint8_t ssid_len = payload[BEACON_SSID_OFFSET - 1];
+    /* Don't trust the length of a malformed SSID */
+    if (ssid_len > MAX_SSID_LEN) {
+        ssid_len = MAX_SSID_LEN;
+    }
     if (ssid_len > 0) {
         memcpy(dev->radio.ap.ssid, payload + BEACON_SSID_OFFSET, ssid_len);
+        dev->radio.ap.ssid[ssid_len] = '\0';
     }
     esp_err_t result = ESP_OK;
     if (creating) {
@@ -461,19 +475,19 @@ esp_err_t parse_probe_req(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
                 char **new_pnl = realloc(dev->radio.sta.saved_networks,
                     sizeof(char *) * (dev->radio.sta.saved_networks_count + 1));
                 if (new_pnl != NULL) {
+                    /* realloc() may have freed the old array */
+                    dev->radio.sta.saved_networks = new_pnl;
                     new_pnl[dev->radio.sta.saved_networks_count] = malloc(sizeof(char) * (ssid_len + 1));
                     if (new_pnl[dev->radio.sta.saved_networks_count] != NULL) {
                         strncpy(new_pnl[dev->radio.sta.saved_networks_count],
                             ssid, ssid_len);
                         new_pnl[dev->radio.sta.saved_networks_count][ssid_len] = '\0';
-                        dev->radio.sta.saved_networks = new_pnl;
                         ++(dev->radio.sta.saved_networks_count);
                     }
                 }
-            } else {
-                free(ssid);
-                ssid = NULL;
             }
+            free(ssid);
+            ssid = NULL;
         }
     }
     esp_err_t result = ESP_OK;
@@ -484,7 +498,9 @@ esp_err_t parse_probe_req(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
     }
     display_wifi_device(dev, creating);
     if (creating) {
+        /* add_device() made its own copy of the PNL */
         free_device(dev);
+        free(dev);
     }
     return result;
 }
@@ -494,7 +510,7 @@ esp_err_t parse_probe_req(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
  // TODO: Fix ap->radio.ap.authmode
  */
 esp_err_t parse_probe_resp(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
-    wendigo_device *ap = retrieve_by_mac(payload + BSSID_80211_OFFSET);
+    wendigo_device *ap = NULL;
     wendigo_device *sta = NULL;
     bool creatingSta = false;
     bool creatingAp = false;
@@ -522,6 +538,9 @@ esp_err_t parse_probe_resp(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
             }
         }
     }
+    /* Only look for the AP once the STA has been added, because add_device()
+       may move devices[] */
+    ap = retrieve_by_mac(payload + BSSID_80211_OFFSET);
     if (ap == NULL) {
         creatingAp = true;
         ap = wendigo_new_ap(payload + BSSID_80211_OFFSET);
@@ -533,8 +552,12 @@ esp_err_t parse_probe_resp(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
     ap->rssi = rx_ctrl.rssi;
     ap->radio.ap.channel = rx_ctrl.channel;
     uint8_t ssid_len = payload[PROBE_RESPONSE_SSID_OFFSET - 1];
+    if (ssid_len > MAX_SSID_LEN) {
+        ssid_len = MAX_SSID_LEN;
+    }
     if (ssid_len > 0) {
         memcpy(ap->radio.ap.ssid, payload + PROBE_RESPONSE_SSID_OFFSET, ssid_len);
+        ap->radio.ap.ssid[ssid_len] = '\0';
     }
     /* Authentication mode */
     memcpy(&(ap->radio.ap.authmode), payload + ssid_len + PROBE_RESPONSE_AUTH_TYPE_OFFSET, sizeof(uint8_t));
@@ -543,6 +566,10 @@ esp_err_t parse_probe_resp(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
         result |= add_device(ap);
         free(ap);
         ap = retrieve_by_mac(payload + BSSID_80211_OFFSET);
+        if (sta != NULL) {
+            /* add_device() may have moved devices[] - Find the STA again */
+            sta = retrieve_by_mac(payload + DESTADDR_80211_OFFSET);
+        }
     } else {
         gettimeofday(&(ap->lastSeen), NULL);
     }
@@ -562,7 +589,7 @@ esp_err_t parse_probe_resp(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
  */
 esp_err_t parse_rts(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
     wendigo_device *sta = retrieve_by_mac(payload + SRCADDR_80211_OFFSET);
-    wendigo_device *ap = retrieve_by_mac(payload + DESTADDR_80211_OFFSET);
+    wendigo_device *ap = NULL;
     bool creatingAp = false;
     bool creatingSta = false;
     esp_err_t result = ESP_OK;
@@ -584,6 +611,9 @@ esp_err_t parse_rts(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
     } else {
         gettimeofday(&(sta->lastSeen), NULL);
     }
+    /* Only look for the AP once the STA has been added, because add_device()
+       may move devices[] */
+    ap = retrieve_by_mac(payload + DESTADDR_80211_OFFSET);
     if (ap == NULL) {
         /* Even though the only AP info we have is MAC, we also know
            that STA is connected to it - Create a wendigo_device for
@@ -600,6 +630,8 @@ esp_err_t parse_rts(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
         result |= add_device(ap);
         free(ap);
         ap = retrieve_by_mac(payload + DESTADDR_80211_OFFSET);
+        /* add_device() may have moved devices[] - Find the STA again */
+        sta = retrieve_by_mac(payload + SRCADDR_80211_OFFSET);
     } else {
         gettimeofday(&(ap->lastSeen), NULL);
     }
@@ -616,7 +648,7 @@ esp_err_t parse_rts(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
  * objects representing the transmitting AP and receiving STA.
  */
 esp_err_t parse_cts(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
-    wendigo_device *sta = retrieve_by_mac(payload + DESTADDR_80211_OFFSET);
+    wendigo_device *sta = NULL;
     wendigo_device *ap = retrieve_by_mac(payload + SRCADDR_80211_OFFSET);
     bool creatingAp = false;
     bool creatingSta = false;
@@ -640,6 +672,9 @@ esp_err_t parse_cts(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
     } else {
         gettimeofday(&(ap->lastSeen), NULL);
     }
+    /* Only look for the STA once the AP has been added, because add_device()
+       may move devices[] */
+    sta = retrieve_by_mac(payload + DESTADDR_80211_OFFSET);
     if (sta == NULL) {
         /* While the only thing we know about the STA is its MAC, create
            a wendigo_device for it so it can be linked to the AP. */
@@ -655,6 +690,8 @@ esp_err_t parse_cts(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
         result |= add_device(sta);
         free(sta);
         sta = retrieve_by_mac(payload + DESTADDR_80211_OFFSET);
+        /* add_device() may have moved devices[] - Find the AP again */
+        ap = retrieve_by_mac(payload + SRCADDR_80211_OFFSET);
     } else {
         gettimeofday(&(sta->lastSeen), NULL);
     }
@@ -753,6 +790,8 @@ esp_err_t parse_deauth(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
         result |= add_device(sta);
         free(sta);
         sta = retrieve_by_mac(payload + DESTADDR_80211_OFFSET);
+        /* add_device() may have moved devices[] - Find the AP again */
+        ap = retrieve_by_mac(payload + BSSID_80211_OFFSET);
     } else {
         gettimeofday(&(sta->lastSeen), NULL);
     }
@@ -812,6 +851,8 @@ esp_err_t parse_disassoc(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
         result |= add_device(ap);
         free(ap);
         ap = retrieve_by_mac(payload + DESTADDR_80211_OFFSET);
+        /* add_device() may have moved devices[] - Find the STA again */
+        sta = retrieve_by_mac(payload + SRCADDR_80211_OFFSET);
     } else {
         gettimeofday(&(ap->lastSeen), NULL);
     }
@@ -851,6 +892,9 @@ esp_err_t parse_assoc_req(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
     }
     if (creatingAp) {
         ap = wendigo_new_ap(payload + DESTADDR_80211_OFFSET);
+    } else {
+        /* add_device() may have moved devices[] - Find the AP again */
+        ap = retrieve_by_mac(payload + DESTADDR_80211_OFFSET);
     }
     if (ap != NULL) {
         ap->scanType = SCAN_WIFI_AP;
@@ -860,6 +904,8 @@ esp_err_t parse_assoc_req(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
             result |= add_device(ap);
             free(ap);
             ap = retrieve_by_mac(payload + DESTADDR_80211_OFFSET);
+            /* add_device() may have moved devices[] - Find the STA again */
+            sta = retrieve_by_mac(payload + SRCADDR_80211_OFFSET);
         } else {
             gettimeofday(&(ap->lastSeen), NULL);
         }
@@ -899,6 +945,9 @@ esp_err_t parse_assoc_resp(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
     }
     if (creatingSta) {
         sta = wendigo_new_sta(payload + DESTADDR_80211_OFFSET);
+    } else {
+        /* add_device() may have moved devices[] - Find the STA again */
+        sta = retrieve_by_mac(payload + DESTADDR_80211_OFFSET);
     }
     if (sta != NULL) {
         sta->scanType = SCAN_WIFI_STA;
@@ -908,6 +957,8 @@ esp_err_t parse_assoc_resp(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
             result |= add_device(sta);
             free(sta);
             sta = retrieve_by_mac(payload + DESTADDR_80211_OFFSET);
+            /* add_device() may have moved devices[] - Find the AP again */
+            ap = retrieve_by_mac(payload + SRCADDR_80211_OFFSET);
         } else {
             gettimeofday(&(sta->lastSeen), NULL);
         }
@@ -947,6 +998,9 @@ esp_err_t parse_reassoc_req(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
     }
     if (creatingAp) {
         ap = wendigo_new_ap(payload + DESTADDR_80211_OFFSET);
+    } else {
+        /* add_device() may have moved devices[] - Find the AP again */
+        ap = retrieve_by_mac(payload + DESTADDR_80211_OFFSET);
     }
     if (ap != NULL) {
         ap->scanType = SCAN_WIFI_AP;
@@ -956,6 +1010,8 @@ esp_err_t parse_reassoc_req(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
             result |= add_device(ap);
             free(ap);
             ap = retrieve_by_mac(payload + DESTADDR_80211_OFFSET);
+            /* add_device() may have moved devices[] - Find the STA again */
+            sta = retrieve_by_mac(payload + SRCADDR_80211_OFFSET);
         } else {
             gettimeofday(&(ap->lastSeen), NULL);
         }
@@ -995,6 +1051,9 @@ esp_err_t parse_reassoc_resp(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
     }
     if (creatingSta) {
         sta = wendigo_new_sta(payload + DESTADDR_80211_OFFSET);
+    } else {
+        /* add_device() may have moved devices[] - Find the STA again */
+        sta = retrieve_by_mac(payload + DESTADDR_80211_OFFSET);
     }
     if (sta != NULL) {
         sta->scanType = SCAN_WIFI_STA;
@@ -1004,6 +1063,8 @@ esp_err_t parse_reassoc_resp(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
             result |= add_device(sta);
             free(sta);
             sta = retrieve_by_mac(payload + DESTADDR_80211_OFFSET);
+            /* add_device() may have moved devices[] - Find the AP again */
+            ap = retrieve_by_mac(payload + SRCADDR_80211_OFFSET);
         } else {
             gettimeofday(&(sta->lastSeen), NULL);
         }
@@ -1016,13 +1077,17 @@ esp_err_t parse_reassoc_resp(uint8_t *payload, wifi_pkt_rx_ctrl_t rx_ctrl) {
     return result;
 }
 
-/** Monitor mode callback
- *  This is the callback function invoked when the wireless interface receives any selected packet.
+/** Parse a frame captured by wifi_pkt_rcvd(). Runs on the pipeline task on
+ *  dual-core chips, otherwise in the promiscuous mode callback.
  */
-void wifi_pkt_rcvd(void *buf, wifi_promiscuous_pkt_type_t type) {
+static void wifi_parse_frame(void *buf) {
     wifi_promiscuous_pkt_t *data = (wifi_promiscuous_pkt_t *)buf;
     uint8_t *payload = data->payload;
     esp_err_t result = ESP_OK;
+    /* Focus Mode follows the transmitter of every frame that names one - CTS and ACK don't */
+    if (data->rx_ctrl.sig_len >= SRCADDR_80211_OFFSET + MAC_BYTES) {
+        wendigo_focus_sample(payload + SRCADDR_80211_OFFSET, (int16_t)data->rx_ctrl.rssi, data->rx_ctrl.channel);
+    }
     /* Pass the packet to the relevant parser */
     switch (payload[0]) {
         case WIFI_FRAME_BEACON:
@@ -1081,6 +1146,25 @@ void wifi_pkt_rcvd(void *buf, wifi_promiscuous_pkt_type_t type) {
     return;
 }
 
+/** Monitor mode callback
+ *  This is the callback function invoked when the wireless interface receives any selected packet.
+ *  It runs in the WiFi task, so it only hands the frame to the pipeline.
+ */
+void wifi_pkt_rcvd(void *buf, wifi_promiscuous_pkt_type_t type) {
+    UNUSED(type);
+    wifi_promiscuous_pkt_t *data = (wifi_promiscuous_pkt_t *)buf;
+    /* The parsers read no further than the MAC header of data frames, which are
+       most of the traffic, but always read addresses, even from short frames */
+    portENTER_CRITICAL(&hopTimingLock);
+    hop_timing_frame(data->rx_ctrl.channel);
+    portEXIT_CRITICAL(&hopTimingLock);
+    uint16_t len = data->rx_ctrl.sig_len;
+    if (data->payload[0] == WIFI_FRAME_DATA || data->payload[0] == WIFI_FRAME_DATA_ALT || len < HEADER_80211_LEN) {
+        len = HEADER_80211_LEN;
+    }
+    wendigo_pipeline_submit(wifi_parse_frame, buf, sizeof(wifi_promiscuous_pkt_t) + len);
+}
+
 esp_err_t initialise_wifi() {
     /* Initialise WiFi if needed */
     if (!WIFI_INITIALISED) {
@@ -1133,24 +1217,54 @@ esp_err_t wendigo_wifi_enable() {
         /* Cast the values to avoid compiler warnings about discarding const qualifiers */
         wendigo_set_channels((uint8_t *)WENDIGO_SUPPORTED_24_CHANNELS, (uint8_t)WENDIGO_SUPPORTED_24_CHANNELS_COUNT);
     }
-    result |= esp_wifi_set_promiscuous(true);
-    create_hop_task_if_needed();
+    /* Promiscuous mode is switched on by the radio scheduler - wendigo_wifi_slice_start() */
+    if (result == ESP_OK) {
+        result = start_hopping();
+    }
     return result;
 }
 
 /** Disable wifi scanning */
 esp_err_t wendigo_wifi_disable() {
     esp_wifi_set_promiscuous(false);
-    if (channelHopTask != NULL) {
+    hopping = false;
+    if (hopTimer != NULL && esp_timer_is_active(hopTimer)) {
         if (scanStatus[SCAN_INTERACTIVE] == ACTION_ENABLE) {
-            ESP_LOGI(WIFI_TAG, "Killing WiFi channel hopping task %p...", &channelHopTask);
+            ESP_LOGI(WIFI_TAG, "Stopping WiFi channel hopping...");
         }
-        vTaskDelete(channelHopTask);
-        channelHopTask = NULL;
-    }
+        esp_timer_stop(hopTimer);
+    }
+    int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL(&hopTimingLock);
+    hop_timing_listen(false, now_us);
+    hop_timing_stop(now_us);
+    portEXIT_CRITICAL(&hopTimingLock);
+    current_channel = 0;
     return ESP_OK;
 }
 
+/** Listen for WiFi traffic during a radio scheduler slice. Channel hopping
+ *  carries on in the background whether or not it's WiFi's slice.
+ */
+esp_err_t wendigo_wifi_slice_start(uint32_t slice_ms) {
+    UNUSED(slice_ms);
+    esp_err_t result = esp_wifi_set_promiscuous(true);
+    if (result == ESP_OK) {
+        portENTER_CRITICAL(&hopTimingLock);
+        hop_timing_listen(true, esp_timer_get_time());
+        portEXIT_CRITICAL(&hopTimingLock);
+    }
+    return result;
+}
+
+/** End WiFi's radio scheduler slice */
+esp_err_t wendigo_wifi_slice_stop() {
+    portENTER_CRITICAL(&hopTimingLock);
+    hop_timing_listen(false, esp_timer_get_time());
+    portEXIT_CRITICAL(&hopTimingLock);
+    return esp_wifi_set_promiscuous(false);
+}
+
 /** Check whether the specified value is a valid WiFi channel */
 bool wendigo_is_valid_channel(uint8_t channel) {
     uint8_t channelIdx;
@@ -1159,6 +1273,32 @@ bool wendigo_is_valid_channel(uint8_t channel) {
     return (channelIdx < WENDIGO_SUPPORTED_24_CHANNELS_COUNT);
 }
 
+/** Display how long channel hopping has actually spent on each channel and
+ *  how busy each was. Dwell is the average of completed visits; Error is the
+ *  visit whose dwell was furthest from what was asked for. Frames/s is per
+ *  second spent listening, so excludes time other radios had the radio.
+ */
+static void display_hop_timing() {
+    hop_channel_stats stats[HOP_TIMING_CHANNELS];
+    portENTER_CRITICAL(&hopTimingLock);
+    uint8_t count = hop_timing_channels(esp_timer_get_time(), stats, HOP_TIMING_CHANNELS);
+    uint32_t stray = hop_timing_stray();
+    portEXIT_CRITICAL(&hopTimingLock);
+    if (count == 0) {
+        return;
+    }
+    printf("Channel  Visits  Dwell (ms)  Asked (ms)  Error (ms)  Listening (s)  Frames  Frames/s\n");
+    for (uint8_t i = 0; i < count; ++i) {
+        double dwell = (stats[i].visits == 0) ? 0 : (double)stats[i].dwell_us / stats[i].visits / 1000;
+        double asked = (stats[i].visits == 0) ? 0 : (double)stats[i].requested_us / stats[i].visits / 1000;
+        double listening = (double)stats[i].listen_us / 1000000;
+        printf("%7u  %6lu  %10.1f  %10.1f  %+10.1f  %13.1f  %6lu  %8.1f\n", stats[i].channel,
+            (unsigned long)stats[i].visits, dwell, asked, (double)stats[i].worst_error_us / 1000, listening,
+            (unsigned long)stats[i].frames, (listening > 0) ? stats[i].frames / listening : 0);
+    }
+    printf("%lu frames arrived while changing channel\n", (unsigned long)stray);
+}
+
 /** Display the channels that are currently included in channel hopping.
  * In Interactive Mode this displays a readable string, in Flipper mode
  * the packet consists of <Preamble><Channel Count><Channel bytes><Terminator>.
@@ -1171,21 +1311,16 @@ esp_err_t wendigo_get_channels() {
             printf("%s%d", (i > 0) ? ", " : "", channels[i]);
         }
         putchar('\n');
+        display_hop_timing();
     } else {
-        /* Assemble the packet with comma-separated channels.
-           Packet size is 2*PREAMBLE_LEN + channels_count + 1
-        */
-        uint8_t packetLen = (2 * PREAMBLE_LEN) + channels_count + 1;
+        /* Assemble the packet with one byte per channel */
+        wendigo_pkt_channels pkt = {.count = channels_count, .channels = channels};
+        uint16_t packetLen = wendigo_pkt_channels_size(&pkt);
         uint8_t *packet = malloc(packetLen);
         if (packet == NULL) {
             return outOfMemory();
         }
-        memcpy(packet, PREAMBLE_CHANNELS, PREAMBLE_LEN);
-        memcpy(packet + WENDIGO_OFFSET_CHANNEL_COUNT, &channels_count, sizeof(uint8_t));
-        if (channels_count > 0) {
-            memcpy(packet + WENDIGO_OFFSET_CHANNELS, channels, channels_count);
-        }
-        memcpy(packet + WENDIGO_OFFSET_CHANNELS + channels_count, PACKET_TERM, PREAMBLE_LEN);
+        wendigo_pkt_channels_encode(&pkt, packet, packetLen);
         /* Transmit the packet */
         if (xSemaphoreTake(uartMutex, portMAX_DELAY)) {
             send_bytes(packet, packetLen);
@@ -1219,30 +1354,37 @@ esp_err_t wendigo_set_channels(uint8_t *new_channels, uint8_t new_channels_count
     return ESP_OK;
 }
 
-/** Creates and starts a background task to periodically change
- *  WiFi channels if it doesn't already exist.
- *  Regardless of whether or not the task already exists this will
- *  "reset" channel hopping, such that the next channel will be the
- *  first channel in channels[].
+/** Starts changing WiFi channels every `hop_millis`, beginning with the
+ *  first channel in channels[]. Each dwell is timed by an esp_timer rather
+ *  than a task that sleeps, so it's timed to the microsecond instead of
+ *  rounded to the tick. The timer is dispatched from its ISR, where one is
+ *  available, so other esp_timer callbacks can't hold it up, and all it
+ *  does is wake hopTask - a task of CONFIG_HOP_TASK_PRIORITY on the radio
+ *  core - to change channel.
+ *  Calling this while hopping is under way starts again from the first
+ *  channel, and the timing of visits so far is forgotten.
  */
-void create_hop_task_if_needed() {
-    if (channelHopTask == NULL) {
-        if (scanStatus[SCAN_INTERACTIVE] == ACTION_ENABLE) {
-            ESP_LOGI(WIFI_TAG, "Channel hopping task is not running, starting it now...");
+esp_err_t start_hopping() {
+    if (hopTask == NULL && wendigo_task_create(hopCallback, "hopCallback", 3072, NULL,
+            CONFIG_HOP_TASK_PRIORITY, &hopTask, WENDIGO_RADIO_CORE) != pdPASS) {
+        return outOfMemory();
+    }
+    if (hopTimer == NULL) {
+        const esp_timer_create_args_t hop_timer_args = {
+            .callback = hop_timer_cb,
+#if CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
+            .dispatch_method = ESP_TIMER_ISR,
+#endif
+            .name = "channel_hop",
+        };
+        esp_err_t err = esp_timer_create(&hop_timer_args, &hopTimer);
+        if (err != ESP_OK) {
+            return err;
         }
-        xTaskCreate(channelHopCallback, "channelHopCallback", 2048, NULL, 5, &channelHopTask);
     }
-    /* Restart hopping from beginning of supported channels list */
-    channel_index = 0;
-}
-
-/** Callback function executed by the channel hopping task once it
- *  has been successfully initialised.
- *  This function enters an infinite loop where it pauses for `hop_millis`
- *  milliseconds and then sets the WiFi channel to the next channel in
- *  channels[].
- */
-void channelHopCallback(void *pvParameter) {
+    if (esp_timer_is_active(hopTimer)) {
+        esp_timer_stop(hopTimer);
+    }
     if (hop_millis == 0) {
         /* If Default dwell time for channel hopping is not configured
            default to 500ms (half a second).
@@ -1253,20 +1395,81 @@ void channelHopCallback(void *pvParameter) {
         */
         hop_millis = (CONFIG_DEFAULT_HOP_MILLIS == 0) ? 500 : CONFIG_DEFAULT_HOP_MILLIS;
     }
-    while (true) {
-        /* Delay hop_millis ms */
-        vTaskDelay(hop_millis / portTICK_PERIOD_MS);
-        /* Only hop if there are channels to hop to */
-        if (channels_count > 0) {
-            ++channel_index; /* Move to next supported channel */
-            if (channel_index >= channels_count) {
-                /* We've hopped to the end, go back to the start */
-                channel_index = 0;
-            }
-            if (esp_wifi_set_channel(channels[channel_index], WIFI_SECOND_CHAN_NONE) != ESP_OK &&
-                    scanStatus[SCAN_INTERACTIVE] == ACTION_ENABLE) {
-                ESP_LOGW(WIFI_TAG, "Failed to change to channel %d", channels[channel_index]);
+    portENTER_CRITICAL(&hopTimingLock);
+    hop_timing_reset();
+    portEXIT_CRITICAL(&hopTimingLock);
+    /* Restart hopping from beginning of supported channels list */
+    channel_index = 0;
+    current_channel = 0;
+    hop_due_us = esp_timer_get_time();
+    hopping = true;
+    xTaskNotifyGive(hopTask);
+    return ESP_OK;
+}
+
+/** Callback function executed by hopTimer at the end of each visit to a
+ *  channel. It may run in an ISR, so only wakes hopTask.
+ */
+static void IRAM_ATTR hop_timer_cb(void *arg) {
+    UNUSED(arg);
+#if CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(hopTask, &woken);
+    if (woken == pdTRUE) {
+        esp_timer_isr_dispatch_need_yield();
+    }
+#else
+    xTaskNotifyGive(hopTask);
+#endif
+}
+
+/** Change channel at the end of a visit: Move to the next channel in
+ *  channels[] and arm hopTimer for `hop_millis`. While Focus Mode is tracking
+ *  tagged WiFi devices it instead stays on, or cycles between, the channels
+ *  they were heard on, for as long as wendigo_focus_next_channel() says.
+ */
+static void hop_channel() {
+    uint32_t dwell_millis = hop_millis;
+    uint8_t next_channel = wendigo_focus_next_channel(channels, channels_count, hop_millis, &dwell_millis);
+    /* Otherwise only hop if there are channels to hop to */
+    if (next_channel == 0 && channels_count > 0) {
+        if (channel_index >= channels_count) {
+            /* We've hopped to the end, go back to the start */
+            channel_index = 0;
+        }
+        next_channel = channels[channel_index++]; /* Then move to next supported channel */
+    }
+    /* Don't disturb the radio when parked on a channel */
+    if (next_channel != 0 && next_channel != current_channel) {
+        if (esp_wifi_set_channel(next_channel, WIFI_SECOND_CHAN_NONE) != ESP_OK) {
+            if (scanStatus[SCAN_INTERACTIVE] == ACTION_ENABLE) {
+                ESP_LOGW(WIFI_TAG, "Failed to change to channel %d", next_channel);
             }
+        } else {
+            current_channel = next_channel;
+        }
+    }
+    int64_t now_us = esp_timer_get_time();
+    portENTER_CRITICAL(&hopTimingLock);
+    hop_timing_visit(current_channel, dwell_millis * 1000, now_us);
+    portEXIT_CRITICAL(&hopTimingLock);
+    /* Time the next hop from when this one was due rather than when it ran,
+       so the callback's latency doesn't accumulate from one visit to the next.
+       If it's fallen behind by a whole dwell, start afresh from now. */
+    hop_due_us += (int64_t)dwell_millis * 1000;
+    if (hop_due_us <= now_us) {
+        hop_due_us = now_us + (int64_t)dwell_millis * 1000;
+    }
+    esp_timer_start_once(hopTimer, (uint64_t)(hop_due_us - now_us));
+}
+
+/** Body of hopTask: change channel whenever hopTimer says, until hopping stops */
+static void hopCallback(void *pvParameter) {
+    UNUSED(pvParameter);
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (hopping) {
+            hop_channel();
         }
     }
 }
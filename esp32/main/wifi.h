@@ -7,27 +7,30 @@ esp_err_t initialise_wifi();
 void wifi_pkt_rcvd(void *buf, wifi_promiscuous_pkt_type_t type);
 esp_err_t wendigo_wifi_disable();
 esp_err_t wendigo_wifi_enable();
+esp_err_t wendigo_wifi_slice_start(uint32_t slice_ms);
+esp_err_t wendigo_wifi_slice_stop();
 esp_err_t wendigo_get_channels();
 esp_err_t wendigo_set_channels(uint8_t *new_channels, uint8_t new_channels_count);
 bool wendigo_is_valid_channel(uint8_t channel);
 
-/* Offsets for different packet types */
-uint8_t BEACON_SSID_OFFSET = 38;
-uint8_t BEACON_SEQNUM_OFFSET = 22;
-uint8_t BEACON_PRIVACY_OFFSET = 34; /* 0x31 set, 0x21 unset */
-uint8_t BEACON_PACKET_LEN = 57;
-uint8_t PROBE_SSID_OFFSET = 26;
-uint8_t PROBE_SEQNUM_OFFSET = 22;
-uint8_t PROBE_REQUEST_LEN = 42;
-uint8_t PROBE_RESPONSE_PRIVACY_OFFSET = 34; /* On {0x11, 0x11} Off {0x01, 0x11}*/
-uint8_t PROBE_RESPONSE_SSID_OFFSET = 38;
-uint8_t PROBE_RESPONSE_GROUP_CIPHER_OFFSET = 62; /* + ssid_len */
-uint8_t PROBE_RESPONSE_PAIRWISE_CIPHER_OFFSET = 68; /* + ssid_len */
-uint8_t PROBE_RESPONSE_AUTH_TYPE_OFFSET = 74; /* + ssid_len | PROBE_RESPONSE_AUTH_TYPE */
-uint8_t PROBE_RESPONSE_LEN = 173;
-uint8_t DESTADDR_80211_OFFSET = 4; /* Generic 802.11 packet offsets */
-uint8_t SRCADDR_80211_OFFSET = 10;
-uint8_t BSSID_80211_OFFSET = 16;
+/* Offsets for different packet types, defined in wifi.c */
+extern uint8_t BEACON_SSID_OFFSET;
+extern uint8_t BEACON_SEQNUM_OFFSET;
+extern uint8_t BEACON_PRIVACY_OFFSET;
+extern uint8_t BEACON_PACKET_LEN;
+extern uint8_t PROBE_SSID_OFFSET;
+extern uint8_t PROBE_SEQNUM_OFFSET;
+extern uint8_t PROBE_REQUEST_LEN;
+extern uint8_t PROBE_RESPONSE_PRIVACY_OFFSET;
+extern uint8_t PROBE_RESPONSE_SSID_OFFSET;
+extern uint8_t PROBE_RESPONSE_GROUP_CIPHER_OFFSET;
+extern uint8_t PROBE_RESPONSE_PAIRWISE_CIPHER_OFFSET;
+extern uint8_t PROBE_RESPONSE_AUTH_TYPE_OFFSET;
+extern uint8_t PROBE_RESPONSE_LEN;
+extern uint8_t DESTADDR_80211_OFFSET;
+extern uint8_t SRCADDR_80211_OFFSET;
+extern uint8_t BSSID_80211_OFFSET;
+extern uint8_t HEADER_80211_LEN;
 
 typedef enum WiFi_Frame {
     WIFI_FRAME_ASSOC_REQ = 0x00,
@@ -0,0 +1,126 @@
+/** Encode/decode throughput of the generated packet code.
+ *
+ * Encodes and decodes a representative packet of each device type in a tight
+ * loop and reports packets/s and MB/s. Output is one line per packet type and
+ * operation, in whitespace-separated columns, so results from two builds can
+ * be compared with diff.
+ *
+ *     wendigo_packets_bench [iterations]
+ */
+#include "wendigo_packets.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_ITERATIONS (2000000)
+#define BUFFER_SIZE        (1024)
+
+typedef uint16_t (*encode_fn)(const void *pkt, uint8_t *buf, uint16_t buf_len);
+typedef uint16_t (*decode_fn)(void *pkt, const uint8_t *buf, uint16_t len);
+
+/* Adapt each packet's functions to encode_fn and decode_fn */
+#define WRAP(name) \
+    static uint16_t name##_encode(const void *pkt, uint8_t *buf, uint16_t buf_len) { \
+        return wendigo_pkt_##name##_encode(pkt, buf, buf_len); \
+    } \
+    static uint16_t name##_decode(void *pkt, const uint8_t *buf, uint16_t len) { \
+        return wendigo_pkt_##name##_decode(pkt, buf, len); \
+    }
+WRAP(bt)
+WRAP(wifi_ap)
+WRAP(wifi_sta)
+WRAP(mac)
+
+/* Stops the compiler optimising the loops away */
+static volatile uint32_t sink;
+
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + (ts.tv_nsec / 1e9);
+}
+
+static void report(const char *name, const char *op, uint16_t len, uint32_t iterations, double elapsed) {
+    double rate = iterations / elapsed;
+    printf("%-10s %-7s %5u %12.0f %10.1f\n", name, op, len, rate, (rate * len) / 1e6);
+}
+
+static void bench(const char *name, const void *pkt, void *decoded, encode_fn encode,
+        decode_fn decode, uint32_t iterations) {
+    uint8_t buf[BUFFER_SIZE];
+    uint16_t len = encode(pkt, buf, sizeof(buf));
+    if (len == 0 || decode(decoded, buf, len) != len) {
+        fprintf(stderr, "%s: packet doesn't survive an encode/decode round trip\n", name);
+        exit(1);
+    }
+
+    double start = now();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        sink += encode(pkt, buf, sizeof(buf));
+    }
+    report(name, "encode", len, iterations, now() - start);
+
+    start = now();
+    for (uint32_t i = 0; i < iterations; ++i) {
+        sink += decode(decoded, buf, len);
+    }
+    report(name, "decode", len, iterations, now() - start);
+}
+
+int main(int argc, char **argv) {
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    if (argc > 1) {
+        iterations = strtoul(argv[1], NULL, 10);
+        if (iterations == 0) {
+            fprintf(stderr, "usage: %s [iterations]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    uint8_t mac[WENDIGO_PKT_MAC_BYTES] = {0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC};
+    uint8_t sta_macs[4][WENDIGO_PKT_MAC_BYTES] = {
+        {0x02, 0x00, 0x00, 0x00, 0x00, 0x01}, {0x02, 0x00, 0x00, 0x00, 0x00, 0x02},
+        {0x02, 0x00, 0x00, 0x00, 0x00, 0x03}, {0x02, 0x00, 0x00, 0x00, 0x00, 0x04},
+    };
+    uint8_t *stations[4] = {sta_macs[0], sta_macs[1], sta_macs[2], sta_macs[3]};
+    char *pnl[3] = {"HomeNetwork", "Office-5G", "Airport Free WiFi"};
+    uint8_t eir[40];
+    for (uint8_t i = 0; i < sizeof(eir); ++i) {
+        eir[i] = i;
+    }
+
+    wendigo_pkt_bt bt = {
+        .bdname_len = 19, .eir_len = sizeof(eir), .rssi = -67, .cod = 0x5A020C,
+        .scantype = 0, .tagged = 0,
+        .bdname = (const uint8_t *)"Wendigo Test Device", .eir = eir,
+    };
+    memcpy(bt.bda, mac, sizeof(mac));
+    wendigo_pkt_wifi_ap ap = {
+        .scantype = 2, .channel = 6, .rssi = -58, .auth_mode = 3, .ssid_len = 10,
+        .sta_count = 4, .ssid = (const uint8_t *)"WendigoNet", .stations = stations,
+    };
+    memcpy(ap.mac, mac, sizeof(mac));
+    wendigo_pkt_wifi_sta sta = {
+        .scantype = 3, .channel = 6, .rssi = -71, .pnl_count = 3, .ap_ssid_len = 10,
+        .ap_ssid = (const uint8_t *)"WendigoNet", .pnl = pnl,
+    };
+    memcpy(sta.mac, sta_macs[0], sizeof(mac));
+    memcpy(sta.ap_mac, mac, sizeof(mac));
+    uint8_t if_types[2] = {1, 2};
+    uint8_t *if_macs[2] = {mac, sta_macs[0]};
+    wendigo_pkt_mac macs = {.if_count = 2, .interfaces_types = if_types, .interfaces = if_macs};
+
+    wendigo_pkt_bt bt_out;
+    wendigo_pkt_wifi_ap ap_out;
+    wendigo_pkt_wifi_sta sta_out;
+    wendigo_pkt_mac mac_out;
+
+    printf("%-10s %-7s %5s %12s %10s\n", "packet", "op", "bytes", "packets/s", "MB/s");
+    bench("bt", &bt, &bt_out, bt_encode, bt_decode, iterations);
+    bench("wifi_ap", &ap, &ap_out, wifi_ap_encode, wifi_ap_decode, iterations);
+    bench("wifi_sta", &sta, &sta_out, wifi_sta_encode, wifi_sta_decode, iterations);
+    bench("mac", &macs, &mac_out, mac_encode, mac_decode, iterations);
+    return 0;
+}
@@ -0,0 +1,493 @@
+/** Throughput and memory use of Flipper-Wendigo's packet parsing and device
+ * cache, built on the host against the furi shims in host/flipper.
+ *
+ * Builds a stream of BT, AP and STA packets for a population of simulated
+ * devices, then measures:
+ *   - rx_data_cb:  Bytes/sec through wendigo_scan_handle_rx_data_cb(), with
+ *                  the stream delivered in randomly-sized chunks as the UART
+ *                  would deliver it
+ *   - parse_packet: Packets/sec through parsePacket(), one packet at a time
+ *   - add_device:  Time per wendigo_add_device() for a new device, and for a
+ *                  device that's already cached, at a range of cache sizes
+ * along with the peak heap of each. Results are NDJSON on stdout, one line
+ * per measurement with a fixed key order, so two runs can be diffed. Exits
+ * with status 1 if the cache doesn't end up holding every device in the
+ * stream, so it doubles as a regression check.
+ *
+ *     wendigo_scan_bench [-n packets] [-d devices] [-c max_chunk]
+ *                        [-s sizes] [-H heap_bytes] [-r seed] [-v]
+ */
+#include "wendigo_app_i.h"
+#include "wendigo_scan.h"
+#include "wendigo_pool.h"
+#include "wendigo_spill.h"
+
+#include <getopt.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEFAULT_PACKETS     (200000)
+#define DEFAULT_DEVICES     (1000)
+/* Flipper-Wendigo's UART worker delivers at most RX_BUF_SIZE bytes at a time */
+#define DEFAULT_MAX_CHUNK   (RX_BUF_SIZE)
+/* Larger chunks than this can overflow wendigo_scan.c's 4 KiB buffer, which
+   the UART never does */
+#define MAX_CHUNK           (1024)
+#define DEFAULT_CACHE_SIZES "100,500,1000,2000,5000,10000"
+#define MAX_CACHE_SIZES     (16)
+#define MAX_STATIONS        (4)
+#define MAX_PNL             (4)
+#define SSID_POOL_SIZE      (64)
+#define PACKET_BUFFER       (1024)
+
+typedef enum {
+    DEV_BT = 0,
+    DEV_AP,
+    DEV_STA,
+    DEV_KIND_COUNT
+} device_kind;
+
+typedef struct {
+    uint8_t kind;
+    uint8_t mac[MAC_BYTES];
+    uint8_t channel;
+    uint8_t name_len;
+    char name[MAX_SSID_LEN + 1];    /* bdname or SSID */
+    uint32_t cod;
+    uint8_t links_count;            /* Stations of an AP, or saved networks of a STA */
+    uint16_t links[MAX_STATIONS];   /* Index of each station, or of each SSID in ssids[] */
+    bool seen;
+} sim_device;
+
+typedef struct {
+    uint32_t packets;
+    uint32_t devices;
+    uint16_t max_chunk;
+    size_t heap_size;
+    uint32_t seed;
+    uint32_t cache_sizes[MAX_CACHE_SIZES];
+    uint8_t cache_sizes_count;
+} bench_config;
+
+static uint32_t rng_state;
+/* The largest peak heap of any measurement - Each one resets the peak */
+static size_t overall_peak;
+static char ssids[SSID_POOL_SIZE][MAX_SSID_LEN + 1];
+
+static uint32_t rng(void) {
+    /* xorshift32 */
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static void random_name(char *buf, uint8_t len) {
+    for (uint8_t i = 0; i < len; ++i) {
+        buf[i] = (char)('a' + (rng() % 26));
+    }
+    buf[len] = '\0';
+}
+
+static double monotonic_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+/** Make `count` devices - 40% Bluetooth, 30% APs and 30% stations, like a
+ * busy street. Stations save a few networks from a shared pool of SSIDs,
+ * and APs have a few of those stations. */
+static sim_device *make_devices(uint32_t count) {
+    sim_device *sim = calloc(count, sizeof(sim_device));
+    if (sim == NULL) {
+        return NULL;
+    }
+    for (uint8_t i = 0; i < SSID_POOL_SIZE; ++i) {
+        random_name(ssids[i], (uint8_t)(4 + (rng() % 20)));
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        sim_device *dev = &sim[i];
+        uint32_t pick = rng() % 10;
+        dev->kind = (pick < 4) ? DEV_BT : (pick < 7) ? DEV_AP : DEV_STA;
+        for (uint8_t b = 0; b < MAC_BYTES; ++b) {
+            dev->mac[b] = (uint8_t)rng();
+        }
+        /* Unique MACs, whatever the RNG does */
+        dev->mac[0] = (uint8_t)((i >> 16) & 0xFF);
+        dev->mac[1] = (uint8_t)((i >> 8) & 0xFF);
+        dev->mac[2] = (uint8_t)(i & 0xFF);
+        dev->channel = (uint8_t)(1 + (rng() % 13));
+        dev->name_len = (dev->kind == DEV_STA) ? 0 : (uint8_t)(rng() % 24);
+        random_name(dev->name, dev->name_len);
+        dev->cod = rng() & 0xFFFFFF;
+        if (dev->kind == DEV_STA) {
+            dev->links_count = (uint8_t)(rng() % (MAX_PNL + 1));
+            for (uint8_t l = 0; l < dev->links_count; ++l) {
+                dev->links[l] = (uint16_t)(rng() % SSID_POOL_SIZE);
+            }
+        } else if (dev->kind == DEV_AP) {
+            dev->links_count = (uint8_t)(rng() % (MAX_STATIONS + 1));
+            for (uint8_t l = 0; l < dev->links_count; ++l) {
+                dev->links[l] = (uint16_t)(rng() % count);
+            }
+        }
+    }
+    return sim;
+}
+
+static int16_t random_rssi(void) {
+    return (int16_t)(-30 - (int16_t)(rng() % 65));
+}
+
+/** Encode a sighting of `dev` into `buf`, returning its length */
+static uint16_t encode_device(sim_device *sim, sim_device *dev, uint8_t *buf, uint16_t buf_len) {
+    switch (dev->kind) {
+        case DEV_BT: {
+            wendigo_pkt_bt pkt = {
+                .bdname_len = dev->name_len, .rssi = random_rssi(), .cod = dev->cod,
+                .scantype = (dev->cod & 1) ? SCAN_BLE : SCAN_HCI, .bdname = (const uint8_t *)dev->name,
+            };
+            memcpy(pkt.bda, dev->mac, MAC_BYTES);
+            return wendigo_pkt_bt_encode(&pkt, buf, buf_len);
+        }
+        case DEV_AP: {
+            uint8_t *stations[MAX_STATIONS];
+            for (uint8_t l = 0; l < dev->links_count; ++l) {
+                stations[l] = sim[dev->links[l]].mac;
+            }
+            wendigo_pkt_wifi_ap pkt = {
+                .scantype = SCAN_WIFI_AP, .channel = dev->channel, .rssi = random_rssi(),
+                .auth_mode = (uint8_t)(dev->cod % 9), .ssid_len = dev->name_len,
+                .sta_count = dev->links_count, .ssid = (const uint8_t *)dev->name, .stations = stations,
+            };
+            memcpy(pkt.mac, dev->mac, MAC_BYTES);
+            return wendigo_pkt_wifi_ap_encode(&pkt, buf, buf_len);
+        }
+        default: {
+            char *pnl[MAX_PNL];
+            for (uint8_t l = 0; l < dev->links_count; ++l) {
+                pnl[l] = ssids[dev->links[l]];
+            }
+            wendigo_pkt_wifi_sta pkt = {
+                .scantype = SCAN_WIFI_STA, .channel = dev->channel, .rssi = random_rssi(),
+                .pnl_count = dev->links_count, .pnl = pnl,
+            };
+            memcpy(pkt.mac, dev->mac, MAC_BYTES);
+            return wendigo_pkt_wifi_sta_encode(&pkt, buf, buf_len);
+        }
+    }
+}
+
+/** Fill in a wendigo_device for `dev`, as the parser would before calling
+ * wendigo_add_device(). Strings point into `dev` - The cache copies them. */
+static void device_from_sim(sim_device *sim, sim_device *dev, wendigo_device *result,
+        uint8_t **stations, char **pnl) {
+    memset(result, 0, sizeof(wendigo_device));
+    memcpy(result->mac, dev->mac, MAC_BYTES);
+    result->rssi = random_rssi();
+    if (dev->kind == DEV_BT) {
+        result->scanType = (dev->cod & 1) ? SCAN_BLE : SCAN_HCI;
+        result->radio.bluetooth.cod = dev->cod;
+        result->radio.bluetooth.bdname_len = dev->name_len;
+        result->radio.bluetooth.bdname = (dev->name_len > 0) ? dev->name : NULL;
+    } else if (dev->kind == DEV_AP) {
+        result->scanType = SCAN_WIFI_AP;
+        result->radio.ap.channel = dev->channel;
+        memcpy(result->radio.ap.ssid, dev->name, dev->name_len + 1);
+        for (uint8_t l = 0; l < dev->links_count; ++l) {
+            stations[l] = sim[dev->links[l]].mac;
+        }
+        result->radio.ap.stations = (dev->links_count > 0) ? stations : NULL;
+        result->radio.ap.stations_count = dev->links_count;
+    } else {
+        result->scanType = SCAN_WIFI_STA;
+        result->radio.sta.channel = dev->channel;
+        for (uint8_t l = 0; l < dev->links_count; ++l) {
+            pnl[l] = ssids[dev->links[l]];
+        }
+        result->radio.sta.saved_networks = (dev->links_count > 0) ? pnl : NULL;
+        result->radio.sta.saved_networks_count = dev->links_count;
+    }
+}
+
+/** Build the stream. Packets are for randomly-chosen devices, so most of
+ * the stream updates devices that are already cached. Returns its length,
+ * and the offset of each packet in `offsets`. */
+static size_t build_stream(sim_device *sim, uint32_t devices, uint32_t packets, uint8_t *stream,
+        size_t capacity, uint32_t *offsets, uint32_t *devices_seen) {
+    size_t len = 0;
+    *devices_seen = 0;
+    for (uint32_t i = 0; i < packets; ++i) {
+        sim_device *dev = &sim[rng() % devices];
+        uint16_t packet_len = encode_device(sim, dev, stream + len,
+            (uint16_t)MIN(capacity - len, (size_t)PACKET_BUFFER));
+        if (packet_len == 0) {
+            fprintf(stderr, "Unable to encode packet %u\n", i);
+            return 0;
+        }
+        offsets[i] = (uint32_t)len;
+        len += packet_len;
+        if (!dev->seen) {
+            dev->seen = true;
+            ++*devices_seen;
+        }
+    }
+    offsets[packets] = (uint32_t)len;
+    return len;
+}
+
+static WendigoApp *app_alloc(void) {
+    WendigoApp *app = calloc(1, sizeof(WendigoApp));
+    if (app == NULL) {
+        return NULL;
+    }
+    app->current_view = WendigoAppViewVarItemList;
+    for (uint8_t i = 0; i < PRUNE_TYPE_COUNT; ++i) {
+        app->prune_policy[i] = PRUNE_OLDEST;
+    }
+    app->bufferMutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    app->devicesMutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    app->pnlMutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    return app;
+}
+
+static void app_free(WendigoApp *app) {
+    wendigo_free_devices();
+    wendigo_free_uart_buffer();
+    furi_mutex_free(app->bufferMutex);
+    furi_mutex_free(app->devicesMutex);
+    furi_mutex_free(app->pnlMutex);
+    free(app);
+}
+
+/** Empty the device cache between measurements */
+static void app_reset(WendigoApp *app) {
+    wendigo_free_devices();
+    wendigo_free_uart_buffer();
+    app->packets_parsed = 0;
+    app->devices_pruned = 0;
+    FuriShimHeapStats stats;
+    furi_shim_heap_get_stats(&stats);
+    overall_peak = MAX(overall_peak, stats.peak);
+    furi_shim_heap_reset_peak();
+}
+
+/** Bytes the device cache is using, including what the pool has allocated */
+static size_t heap_in_use(size_t baseline) {
+    FuriShimHeapStats stats;
+    furi_shim_heap_get_stats(&stats);
+    return stats.allocated - baseline;
+}
+
+static size_t heap_peak(size_t baseline) {
+    FuriShimHeapStats stats;
+    furi_shim_heap_get_stats(&stats);
+    return stats.peak - baseline;
+}
+
+static bool bench_rx_data_cb(WendigoApp *app, const bench_config *cfg, uint8_t *stream, size_t len,
+        uint32_t devices_seen, size_t baseline) {
+    app_reset(app);
+    uint32_t chunks = 0;
+    double start = monotonic_now();
+    for (size_t offset = 0; offset < len; ++chunks) {
+        size_t chunk = MIN((size_t)(1 + (rng() % cfg->max_chunk)), len - offset);
+        wendigo_scan_handle_rx_data_cb(stream + offset, chunk, app);
+        offset += chunk;
+    }
+    double elapsed = monotonic_now() - start;
+    WendigoPoolStats pool;
+    wendigo_pool_get_stats(&pool);
+    printf("{\"bench\":\"rx_data_cb\",\"bytes\":%zu,\"chunks\":%u,\"packets\":%u,\"packets_parsed\":%u,"
+        "\"devices\":%u,\"devices_pruned\":%u,\"seconds\":%.4f,\"bytes_per_sec\":%.0f,"
+        "\"packets_per_sec\":%.0f,\"heap_peak_bytes\":%zu,\"heap_bytes\":%zu,\"pool_record_bytes\":%u,"
+        "\"pool_arena_bytes\":%u}\n",
+        len, chunks, cfg->packets, app->packets_parsed, devices_count, app->devices_pruned, elapsed,
+        (double)len / elapsed, (double)app->packets_parsed / elapsed, heap_peak(baseline),
+        heap_in_use(baseline), pool.record_bytes, pool.arena_bytes);
+    return app->packets_parsed == cfg->packets &&
+        (devices_count + app->devices_pruned == devices_seen || cfg->heap_size > 0);
+}
+
+static bool bench_parse_packet(WendigoApp *app, const bench_config *cfg, uint8_t *stream,
+        uint32_t *offsets, uint32_t devices_seen, size_t baseline) {
+    app_reset(app);
+    double start = monotonic_now();
+    for (uint32_t i = 0; i < cfg->packets; ++i) {
+        parsePacket(app, stream + offsets[i], (uint16_t)(offsets[i + 1] - offsets[i]));
+    }
+    double elapsed = monotonic_now() - start;
+    printf("{\"bench\":\"parse_packet\",\"packets\":%u,\"devices\":%u,\"devices_pruned\":%u,"
+        "\"seconds\":%.4f,\"packets_per_sec\":%.0f,\"ns_per_packet\":%.1f,\"heap_peak_bytes\":%zu,"
+        "\"heap_bytes\":%zu,\"bytes_per_device\":%.1f}\n",
+        cfg->packets, devices_count, app->devices_pruned, elapsed, (double)cfg->packets / elapsed,
+        elapsed * 1e9 / cfg->packets, heap_peak(baseline), heap_in_use(baseline),
+        (devices_count > 0) ? (double)heap_in_use(baseline) / devices_count : 0.0);
+    return devices_count + app->devices_pruned == devices_seen || cfg->heap_size > 0;
+}
+
+/** Time adding new devices to, and updating devices in, a cache of `size`
+ * devices. The cache is filled to `size`, then a further batch is added -
+ * A tenth of `size`, so the cache doesn't grow much while it's measured -
+ * and the same number of cached devices are updated. */
+static bool bench_add_device(WendigoApp *app, sim_device *sim, uint32_t sim_count, uint32_t size,
+        size_t baseline) {
+    uint32_t batch = MAX(size / 10, 10U);
+    if (size + batch > sim_count || size + batch > UINT16_MAX) {
+        fprintf(stderr, "Cache size %u needs %u devices (-d), skipping\n", size, size + batch);
+        return true;
+    }
+    app_reset(app);
+    wendigo_device dev;
+    uint8_t *stations[MAX_STATIONS];
+    char *pnl[MAX_PNL];
+    for (uint32_t i = 0; i < size; ++i) {
+        device_from_sim(sim, &sim[i], &dev, stations, pnl);
+        wendigo_add_device(app, &dev);
+    }
+    size_t filled_heap = heap_in_use(baseline);
+
+    double start = monotonic_now();
+    for (uint32_t i = size; i < size + batch; ++i) {
+        device_from_sim(sim, &sim[i], &dev, stations, pnl);
+        wendigo_add_device(app, &dev);
+    }
+    double add_elapsed = monotonic_now() - start;
+    start = monotonic_now();
+    for (uint32_t i = 0; i < batch; ++i) {
+        device_from_sim(sim, &sim[rng() % size], &dev, stations, pnl);
+        wendigo_add_device(app, &dev);
+    }
+    double update_elapsed = monotonic_now() - start;
+    printf("{\"bench\":\"add_device\",\"cache_size\":%u,\"batch\":%u,\"devices\":%u,\"ns_per_add\":%.1f,"
+        "\"ns_per_update\":%.1f,\"heap_peak_bytes\":%zu,\"heap_bytes\":%zu,\"bytes_per_device\":%.1f}\n",
+        size, batch, devices_count, add_elapsed * 1e9 / batch, update_elapsed * 1e9 / batch,
+        heap_peak(baseline), heap_in_use(baseline), (size > 0) ? (double)filled_heap / size : 0.0);
+    return devices_count == size + batch;
+}
+
+static bool parse_cache_sizes(const char *arg, bench_config *cfg) {
+    cfg->cache_sizes_count = 0;
+    while (*arg != '\0' && cfg->cache_sizes_count < MAX_CACHE_SIZES) {
+        char *end;
+        unsigned long size = strtoul(arg, &end, 10);
+        if (end == arg || size == 0 || size >= UINT16_MAX) {
+            return false;
+        }
+        cfg->cache_sizes[cfg->cache_sizes_count++] = (uint32_t)size;
+        arg = (*end == ',') ? end + 1 : end;
+    }
+    return cfg->cache_sizes_count > 0;
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr,
+        "usage: %s [-n packets] [-d devices] [-c max_chunk] [-s sizes] [-H heap_bytes] [-r seed] [-v]\n"
+        "  -n  Packets in the stream (default %u)\n"
+        "  -d  Devices in the simulated population (default %u, at least the largest -s plus 10%%)\n"
+        "  -c  Largest chunk passed to wendigo_scan_handle_rx_data_cb() (default %u, at most %u)\n"
+        "  -s  Comma-separated cache sizes to time wendigo_add_device() at (default %s)\n"
+        "  -H  Limit the heap to this many bytes, as on a Flipper, so the cache is pruned (default unlimited)\n"
+        "  -r  Random seed\n"
+        "  -v  Log Flipper-Wendigo's warnings and errors to stderr\n",
+        argv0, DEFAULT_PACKETS, DEFAULT_DEVICES, DEFAULT_MAX_CHUNK, MAX_CHUNK, DEFAULT_CACHE_SIZES);
+}
+
+int main(int argc, char **argv) {
+    bench_config cfg = {
+        .packets = DEFAULT_PACKETS, .devices = 0, .max_chunk = DEFAULT_MAX_CHUNK, .seed = 0x57656E64,
+    };
+    parse_cache_sizes(DEFAULT_CACHE_SIZES, &cfg);
+    FuriLogLevel log_level = FuriLogLevelNone;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:d:c:s:H:r:vh")) != -1) {
+        switch (opt) {
+            case 'n': cfg.packets = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'd': cfg.devices = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'c': cfg.max_chunk = (uint16_t)strtoul(optarg, NULL, 10); break;
+            case 's':
+                if (!parse_cache_sizes(optarg, &cfg)) {
+                    usage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 'H': cfg.heap_size = (size_t)strtoull(optarg, NULL, 10); break;
+            case 'r': cfg.seed = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'v': log_level = FuriLogLevelWarn; break;
+            default:
+                usage(argv[0]);
+                return (opt == 'h') ? 0 : 2;
+        }
+    }
+    uint32_t largest = 0;
+    for (uint8_t i = 0; i < cfg.cache_sizes_count; ++i) {
+        largest = MAX(largest, cfg.cache_sizes[i] + MAX(cfg.cache_sizes[i] / 10, 10U));
+    }
+    if (cfg.devices == 0) {
+        cfg.devices = MAX((uint32_t)DEFAULT_DEVICES, largest);
+    }
+    rng_state = cfg.seed;
+    if (optind < argc || cfg.packets == 0 || cfg.max_chunk == 0 || cfg.max_chunk > MAX_CHUNK ||
+            cfg.devices == 0 || cfg.devices > UINT16_MAX || rng_state == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    furi_log_set_level(log_level);
+
+    /* Devices moved to the SD card go to a scratch directory */
+    char storage_root[] = "/tmp/wendigo_scan_bench.XXXXXX";
+    if (mkdtemp(storage_root) == NULL) {
+        perror("mkdtemp");
+        return 1;
+    }
+    furi_shim_storage_set_root(storage_root);
+
+    /* The stream's own memory isn't part of the Flipper's heap */
+    size_t capacity = (size_t)cfg.packets * PACKET_BUFFER;
+    uint8_t *stream = malloc(capacity);
+    uint32_t *offsets = malloc(sizeof(uint32_t) * (cfg.packets + 1));
+    sim_device *sim = make_devices(cfg.devices);
+    WendigoApp *app = app_alloc();
+    if (stream == NULL || offsets == NULL || sim == NULL || app == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    uint32_t devices_seen;
+    size_t len = build_stream(sim, cfg.devices, cfg.packets, stream, capacity, offsets, &devices_seen);
+    if (len == 0) {
+        return 1;
+    }
+    FuriShimHeapStats stats;
+    furi_shim_heap_get_stats(&stats);
+    size_t baseline = stats.allocated;
+    furi_shim_heap_set_size((cfg.heap_size > 0) ? baseline + cfg.heap_size : 0);
+
+    printf("{\"bench\":\"config\",\"packets\":%u,\"devices\":%u,\"devices_in_stream\":%u,\"max_chunk\":%u,"
+        "\"heap_limit_bytes\":%zu,\"seed\":%u,\"sizeof_wendigo_device\":%zu}\n",
+        cfg.packets, cfg.devices, devices_seen, cfg.max_chunk, cfg.heap_size, cfg.seed, sizeof(wendigo_device));
+    bool ok = bench_rx_data_cb(app, &cfg, stream, len, devices_seen, baseline);
+    ok = bench_parse_packet(app, &cfg, stream, offsets, devices_seen, baseline) && ok;
+    /* wendigo_add_device() is timed without a heap limit - Pruning would
+       stop the cache reaching the sizes being measured */
+    furi_shim_heap_set_size(0);
+    for (uint8_t i = 0; i < cfg.cache_sizes_count; ++i) {
+        ok = bench_add_device(app, sim, cfg.devices, cfg.cache_sizes[i], baseline) && ok;
+    }
+    app_free(app);
+    free(sim);
+    free(offsets);
+    free(stream);
+    /* Everything has been freed, so anything still allocated has leaked */
+    furi_shim_heap_get_stats(&stats);
+    overall_peak = MAX(overall_peak, stats.peak);
+    printf("{\"bench\":\"heap\",\"peak_bytes\":%zu,\"leaked_bytes\":%zu,\"allocations\":%llu,"
+        "\"failed_allocations\":%llu}\n",
+        overall_peak - baseline, stats.allocated, (unsigned long long)stats.allocations,
+        (unsigned long long)stats.failures);
+    rmdir(storage_root);
+    if (!ok) {
+        fprintf(stderr, "FAIL: the device cache doesn't match the stream\n");
+    }
+    return ok ? 0 : 1;
+}
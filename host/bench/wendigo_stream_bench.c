@@ -0,0 +1,241 @@
+/** Throughput and correctness of wendigo_stream against a synthetic stream.
+ *
+ * Builds an in-memory stream of randomised packets of every type, with line
+ * noise between some packets and a proportion of packets corrupted, then
+ * feeds it to wendigo_stream in randomly-sized chunks, as read() would
+ * deliver it. Exits with status 1 if any valid packet is lost or any
+ * corrupted packet is accepted, so it doubles as a regression check.
+ *
+ *     wendigo_stream_bench [packets] [seed]
+ */
+#include "wendigo_stream.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_PACKETS (200000)
+#define MAX_CHUNK       (4096)
+/* 2 Mbaud with 8N1 framing */
+#define BYTES_PER_SEC_2MBAUD (2000000.0 / 10.0)
+
+typedef struct {
+    uint64_t valid[WENDIGO_PKT_TYPE_COUNT];
+    uint64_t corrupted;
+    uint64_t noise_bytes;
+} expected_counts;
+
+static uint32_t rng_state;
+
+static uint32_t rng(void) {
+    /* xorshift32 */
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static void random_bytes(uint8_t *buf, uint32_t len) {
+    for (uint32_t i = 0; i < len; ++i) {
+        buf[i] = (uint8_t)rng();
+    }
+}
+
+/** Random printable text, so SSIDs and names look like the real thing */
+static void random_text(char *buf, uint32_t len) {
+    for (uint32_t i = 0; i < len; ++i) {
+        buf[i] = (char)(' ' + (rng() % 95));
+    }
+    buf[len] = '\0';
+}
+
+/** Encode a random packet of `type` into `buf`, returning its length */
+static uint16_t random_packet(wendigo_pkt_type type, uint8_t *buf, uint16_t buf_len) {
+    uint8_t mac[WENDIGO_PKT_MAC_BYTES];
+    uint8_t bytes[2][255];
+    char text[16][33];
+    char *strings[16];
+    uint8_t *macs[16];
+    uint8_t mac_store[16][WENDIGO_PKT_MAC_BYTES];
+    uint8_t types[16];
+    random_bytes(mac, sizeof(mac));
+    for (uint8_t i = 0; i < 16; ++i) {
+        random_text(text[i], rng() % 33);
+        strings[i] = text[i];
+        random_bytes(mac_store[i], WENDIGO_PKT_MAC_BYTES);
+        macs[i] = mac_store[i];
+        types[i] = (uint8_t)(rng() % 3);
+    }
+    switch (type) {
+        case WENDIGO_PKT_BT: {
+            wendigo_pkt_bt pkt = {
+                .bdname_len = (uint8_t)(rng() % 64), .eir_len = (uint8_t)(rng() % 241),
+                .rssi = (int16_t)(-30 - (int16_t)(rng() % 70)), .cod = rng() & 0xFFFFFF,
+                .scantype = (uint8_t)(rng() % 2), .tagged = (uint8_t)(rng() % 2),
+            };
+            random_bytes(bytes[0], pkt.bdname_len);
+            random_bytes(bytes[1], pkt.eir_len);
+            pkt.bdname = bytes[0];
+            pkt.eir = bytes[1];
+            memcpy(pkt.bda, mac, sizeof(mac));
+            return wendigo_pkt_bt_encode(&pkt, buf, buf_len);
+        }
+        case WENDIGO_PKT_WIFI_AP: {
+            wendigo_pkt_wifi_ap pkt = {
+                .scantype = 2, .channel = (uint8_t)(1 + rng() % 13),
+                .rssi = (int16_t)(-30 - (int16_t)(rng() % 70)), .auth_mode = (uint8_t)(rng() % 9),
+                .ssid_len = (uint8_t)(rng() % 33), .sta_count = (uint8_t)(rng() % 16), .stations = macs,
+            };
+            random_bytes(bytes[0], pkt.ssid_len);
+            pkt.ssid = bytes[0];
+            memcpy(pkt.mac, mac, sizeof(mac));
+            return wendigo_pkt_wifi_ap_encode(&pkt, buf, buf_len);
+        }
+        case WENDIGO_PKT_WIFI_STA: {
+            wendigo_pkt_wifi_sta pkt = {
+                .scantype = 3, .channel = (uint8_t)(1 + rng() % 13),
+                .rssi = (int16_t)(-30 - (int16_t)(rng() % 70)), .pnl_count = (uint8_t)(rng() % 16),
+                .ap_ssid_len = (uint8_t)(rng() % 33), .pnl = strings,
+            };
+            random_bytes(bytes[0], pkt.ap_ssid_len);
+            pkt.ap_ssid = bytes[0];
+            memcpy(pkt.mac, mac, sizeof(mac));
+            random_bytes(pkt.ap_mac, sizeof(pkt.ap_mac));
+            return wendigo_pkt_wifi_sta_encode(&pkt, buf, buf_len);
+        }
+        case WENDIGO_PKT_CHANNELS: {
+            wendigo_pkt_channels pkt = {.count = (uint8_t)(rng() % 14), .channels = bytes[0]};
+            for (uint8_t i = 0; i < pkt.count; ++i) {
+                bytes[0][i] = (uint8_t)(i + 1);
+            }
+            return wendigo_pkt_channels_encode(&pkt, buf, buf_len);
+        }
+        case WENDIGO_PKT_STATUS: {
+            wendigo_pkt_status pkt = {.attr_count = 8, .attributes = strings};
+            return wendigo_pkt_status_encode(&pkt, buf, buf_len);
+        }
+        case WENDIGO_PKT_VERSION: {
+            static const uint8_t version[] = "igo v0.5.0";
+            wendigo_pkt_version pkt = {.version = version, .version_len = sizeof(version)};
+            return wendigo_pkt_version_encode(&pkt, buf, buf_len);
+        }
+        case WENDIGO_PKT_MAC: {
+            wendigo_pkt_mac pkt = {.if_count = (uint8_t)(1 + rng() % 3), .interfaces_types = types, .interfaces = macs};
+            return wendigo_pkt_mac_encode(&pkt, buf, buf_len);
+        }
+        case WENDIGO_PKT_BT_SERVICES: {
+            /* Up to 8 services, each a 16-bit UUID */
+            wendigo_pkt_bt_services pkt = {.result = 0, .svc_count = (uint8_t)(rng() % 9), .uuids = bytes[0]};
+            for (uint8_t i = 0; i < pkt.svc_count; ++i) {
+                bytes[0][i * 3] = 2;
+                random_bytes(bytes[0] + (i * 3) + 1, 2);
+            }
+            pkt.uuids_len = (uint16_t)(pkt.svc_count * 3);
+            memcpy(pkt.bda, mac, sizeof(mac));
+            return wendigo_pkt_bt_services_encode(&pkt, buf, buf_len);
+        }
+        case WENDIGO_PKT_RSSI: {
+            wendigo_pkt_rssi pkt = {.slot = (uint8_t)(rng() % 8), .filtered = (int16_t)(-1000 + rng() % 700),
+                .raw = (int16_t)(-100 + rng() % 70), .samples = (uint16_t)(rng() % 20)};
+            memcpy(pkt.mac, mac, sizeof(mac));
+            return wendigo_pkt_rssi_encode(&pkt, buf, buf_len);
+        }
+        default:
+            return 0;
+    }
+}
+
+/** Build the synthetic stream. Returns its length. */
+static size_t build_stream(uint8_t *stream, size_t capacity, uint32_t packets, expected_counts *expected) {
+    size_t len = 0;
+    uint8_t packet[UINT16_MAX];
+    memset(expected, 0, sizeof(expected_counts));
+    for (uint32_t i = 0; i < packets; ++i) {
+        /* Device packets dominate a real capture */
+        uint32_t pick = rng() % 100;
+        wendigo_pkt_type type = (pick < 40) ? WENDIGO_PKT_BT : (pick < 70) ? WENDIGO_PKT_WIFI_AP :
+            (pick < 95) ? WENDIGO_PKT_WIFI_STA : (wendigo_pkt_type)(WENDIGO_PKT_CHANNELS + (rng() % 6));
+        uint16_t packet_len = random_packet(type, packet, sizeof(packet));
+        if (packet_len == 0 || len + packet_len + 64 > capacity) {
+            break;
+        }
+        /* Occasional log output or line noise between packets - Printable, so
+         * it can't contain a preamble */
+        if (rng() % 50 == 0) {
+            uint32_t noise = 1 + (rng() % 60);
+            random_text((char *)stream + len, noise - 1);
+            stream[len + noise - 1] = '\n';
+            len += noise;
+            expected->noise_bytes += noise;
+        }
+        /* Corrupt 1% of packets by damaging the terminator */
+        if (rng() % 100 == 0) {
+            packet[packet_len - 1] ^= 0x01;
+            ++expected->corrupted;
+        } else {
+            ++expected->valid[type];
+        }
+        memcpy(stream + len, packet, packet_len);
+        len += packet_len;
+    }
+    return len;
+}
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+int main(int argc, char **argv) {
+    uint32_t packets = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : DEFAULT_PACKETS;
+    rng_state = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 10) : 0x57656E64;
+    if (packets == 0 || rng_state == 0) {
+        fprintf(stderr, "usage: %s [packets] [seed]\n", argv[0]);
+        return 1;
+    }
+    size_t capacity = (size_t)packets * 1024;
+    uint8_t *stream_bytes = malloc(capacity);
+    wendigo_stream *stream = malloc(sizeof(wendigo_stream));
+    if (stream_bytes == NULL || stream == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    expected_counts expected;
+    size_t len = build_stream(stream_bytes, capacity, packets, &expected);
+
+    wendigo_stream_init(stream, NULL, NULL);
+    double start = now();
+    for (size_t offset = 0; offset < len;) {
+        size_t chunk = 1 + (rng() % MAX_CHUNK);
+        if (chunk > len - offset) {
+            chunk = len - offset;
+        }
+        wendigo_stream_feed(stream, stream_bytes + offset, chunk);
+        offset += chunk;
+    }
+    wendigo_stream_finish(stream);
+    double elapsed = now() - start;
+
+    bool ok = true;
+    printf("%-10s %12s %12s\n", "packet", "expected", "decoded");
+    for (uint8_t type = 0; type < WENDIGO_PKT_TYPE_COUNT; ++type) {
+        printf("%-10s %12llu %12llu\n", wendigo_pkt_type_name((wendigo_pkt_type)type),
+            (unsigned long long)expected.valid[type], (unsigned long long)stream->stats.packets_by_type[type]);
+        ok = ok && expected.valid[type] == stream->stats.packets_by_type[type];
+    }
+    printf("%-10s %12llu %12llu\n", "corrupted", (unsigned long long)expected.corrupted,
+        (unsigned long long)stream->stats.malformed);
+    /* Every corrupted packet is at least one malformed packet */
+    ok = ok && stream->stats.malformed >= expected.corrupted;
+    double rate = (double)len / elapsed;
+    printf("\nbytes %zu  elapsed %.3fs  %.1f MB/s  %.0f packets/s  %.0fx 2 Mbaud\n", len, elapsed,
+        rate / 1e6, (double)stream->stats.packets / elapsed, rate / BYTES_PER_SEC_2MBAUD);
+    if (!ok) {
+        fprintf(stderr, "FAIL: decoded packets don't match the synthetic stream\n");
+    }
+    free(stream);
+    free(stream_bytes);
+    return ok ? 0 : 1;
+}
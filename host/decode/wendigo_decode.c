@@ -0,0 +1,614 @@
+/** wendigo-decode: Decode a Wendigo UART stream on a Linux host.
+ *
+ * Reads ESP32-Wendigo output from a serial device, a pty, a raw capture file,
+ * a Flipper-Wendigo UART recording (uart.rec) or a binary log written by
+ * this tool, and emits every packet as NDJSON or as a compact binary log.
+ * Statistics are written to stderr as JSON objects, periodically with -s and
+ * always at the end of the stream.
+ *
+ *     wendigo-decode [-b baud] [-o ndjson|binary|none] [-w file] [-s secs] [-d] input
+ *
+ * `input` is a path or - for stdin.
+ */
+#include "wendigo_device_table.h"
+#include "wendigo_stream.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define READ_SIZE        (64 * 1024)
+#define OUTPUT_BUFFER    (1024 * 1024)
+/* Flipper-Wendigo UART recording, see Flipper/wendigo_record.c */
+#define RECORD_MAGIC     "WDGREC"
+/* Binary log written by -o binary. Same layout as a recording, except each
+ * chunk's timestamp is milliseconds since the start of the log rather than
+ * since the previous chunk, and each chunk is exactly one packet. */
+#define LOG_MAGIC        "WDGLOG"
+#define CONTAINER_MAGIC_LEN (6)
+#define CONTAINER_HEADER_LEN (8)
+#define CONTAINER_VERSION (1)
+
+typedef enum {
+    OUTPUT_NDJSON = 0,
+    OUTPUT_BINARY,
+    OUTPUT_NONE
+} output_format;
+
+typedef enum {
+    INPUT_RAW = 0,
+    INPUT_RECORDING,
+    INPUT_LOG
+} input_format;
+
+typedef struct {
+    wendigo_stream stream;
+    wendigo_device_table devices;
+    output_format format;
+    FILE *out;
+    double now;         /* Seconds since the start of the stream */
+    double started;     /* Monotonic clock at start, for throughput */
+    uint64_t devices_new;
+    uint64_t out_of_memory;
+} decoder;
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void handle_signal(int sig) {
+    (void)sig;
+    stop_requested = 1;
+}
+
+static double monotonic_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+static void put_le(uint8_t *dst, uint32_t value, uint8_t size) {
+    for (uint8_t i = 0; i < size; ++i) {
+        dst[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static uint32_t get_le(const uint8_t *src, uint8_t size) {
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < size; ++i) {
+        value |= (uint32_t)src[i] << (8 * i);
+    }
+    return value;
+}
+
+/* NDJSON output */
+
+static void json_mac(FILE *out, const uint8_t *mac) {
+    fprintf(out, "\"%02x:%02x:%02x:%02x:%02x:%02x\"", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
+/** Write `len` bytes as the contents of a JSON string. Bytes outside
+ * printable ASCII are escaped, so the output is valid JSON whatever the ESP32
+ * sent. */
+static void json_chars(FILE *out, const uint8_t *str, uint32_t len) {
+    for (uint32_t i = 0; i < len; ++i) {
+        uint8_t c = str[i];
+        if (c == '"' || c == '\\') {
+            putc('\\', out);
+            putc(c, out);
+        } else if (c < 0x20 || c >= 0x7F) {
+            fprintf(out, "\\u%04x", c);
+        } else {
+            putc(c, out);
+        }
+    }
+}
+
+static void json_string(FILE *out, const uint8_t *str, uint32_t len) {
+    putc('"', out);
+    json_chars(out, str, len);
+    putc('"', out);
+}
+
+static void json_strings(FILE *out, const uint8_t *raw, uint16_t raw_len) {
+    const uint8_t *cursor = raw;
+    const uint8_t *str;
+    uint8_t str_len;
+    bool first = true;
+    putc('[', out);
+    while (wendigo_pkt_next_string(&cursor, raw + raw_len, &str, &str_len)) {
+        if (!first) {
+            putc(',', out);
+        }
+        json_string(out, str, str_len);
+        first = false;
+    }
+    putc(']', out);
+}
+
+/** Write a bt_services packet's UUIDs - each a length byte then the UUID,
+ * little-endian - as an array of hex strings, most significant byte first */
+static void json_uuids(FILE *out, const uint8_t *raw, uint16_t raw_len) {
+    uint16_t offset = 0;
+    bool first = true;
+    putc('[', out);
+    while (offset < raw_len) {
+        uint8_t len = raw[offset++];
+        if (len == 0 || offset + len > raw_len) {
+            break;
+        }
+        fputs(first ? "\"" : ",\"", out);
+        for (uint8_t i = len; i > 0; --i) {
+            fprintf(out, "%02x", raw[offset + i - 1]);
+        }
+        putc('"', out);
+        offset += len;
+        first = false;
+    }
+    putc(']', out);
+}
+
+/** Write alternating name and value strings as a JSON object */
+static void json_attributes(FILE *out, const uint8_t *raw, uint16_t raw_len) {
+    const uint8_t *cursor = raw;
+    const uint8_t *name;
+    const uint8_t *value;
+    uint8_t name_len;
+    uint8_t value_len;
+    bool first = true;
+    putc('{', out);
+    while (wendigo_pkt_next_string(&cursor, raw + raw_len, &name, &name_len) &&
+            wendigo_pkt_next_string(&cursor, raw + raw_len, &value, &value_len)) {
+        if (!first) {
+            putc(',', out);
+        }
+        json_string(out, name, name_len);
+        putc(':', out);
+        json_string(out, value, value_len);
+        first = false;
+    }
+    putc('}', out);
+}
+
+static void json_begin(decoder *dec, wendigo_pkt_type type) {
+    fprintf(dec->out, "{\"ts\":%.3f,\"type\":\"%s\"", dec->now, wendigo_pkt_type_name(type));
+}
+
+static void json_device(decoder *dec, const uint8_t *mac, int16_t rssi, bool is_new) {
+    fputs(",\"mac\":", dec->out);
+    json_mac(dec->out, mac);
+    fprintf(dec->out, ",\"rssi\":%d,\"new\":%s", rssi, is_new ? "true" : "false");
+}
+
+static void write_ndjson(decoder *dec, wendigo_pkt_type type, const wendigo_stream_pkt *pkt, bool is_new) {
+    FILE *out = dec->out;
+    json_begin(dec, type);
+    switch (type) {
+        case WENDIGO_PKT_BT:
+            json_device(dec, pkt->bt.bda, pkt->bt.rssi, is_new);
+            fprintf(out, ",\"scantype\":%u,\"tagged\":%s,\"cod\":%u,\"name\":", pkt->bt.scantype,
+                pkt->bt.tagged ? "true" : "false", pkt->bt.cod);
+            json_string(out, pkt->bt.bdname, pkt->bt.bdname_len);
+            fprintf(out, ",\"eir_len\":%u,\"num_services\":%u", pkt->bt.eir_len, pkt->bt.num_services);
+            break;
+        case WENDIGO_PKT_WIFI_AP:
+            json_device(dec, pkt->wifi_ap.mac, pkt->wifi_ap.rssi, is_new);
+            fprintf(out, ",\"channel\":%u,\"tagged\":%s,\"auth_mode\":%u,\"ssid\":", pkt->wifi_ap.channel,
+                pkt->wifi_ap.tagged ? "true" : "false", pkt->wifi_ap.auth_mode);
+            json_string(out, pkt->wifi_ap.ssid, pkt->wifi_ap.ssid_len);
+            fputs(",\"stations\":[", out);
+            for (uint16_t i = 0; i < pkt->wifi_ap.sta_count; ++i) {
+                if (i > 0) {
+                    putc(',', out);
+                }
+                json_mac(out, WENDIGO_PKT_MAC_AT(pkt->wifi_ap.stations_raw, i));
+            }
+            putc(']', out);
+            break;
+        case WENDIGO_PKT_WIFI_STA:
+            json_device(dec, pkt->wifi_sta.mac, pkt->wifi_sta.rssi, is_new);
+            fprintf(out, ",\"channel\":%u,\"tagged\":%s,\"ap_mac\":", pkt->wifi_sta.channel,
+                pkt->wifi_sta.tagged ? "true" : "false");
+            json_mac(out, pkt->wifi_sta.ap_mac);
+            fputs(",\"ap_ssid\":", out);
+            json_string(out, pkt->wifi_sta.ap_ssid, pkt->wifi_sta.ap_ssid_len);
+            fputs(",\"pnl\":", out);
+            json_strings(out, pkt->wifi_sta.pnl_raw, pkt->wifi_sta.pnl_raw_len);
+            break;
+        case WENDIGO_PKT_CHANNELS:
+            fputs(",\"channels\":[", out);
+            for (uint16_t i = 0; i < pkt->channels.count; ++i) {
+                fprintf(out, "%s%u", (i > 0) ? "," : "", pkt->channels.channels[i]);
+            }
+            putc(']', out);
+            break;
+        case WENDIGO_PKT_STATUS:
+            fputs(",\"attributes\":", out);
+            json_attributes(out, pkt->status.attributes_raw, pkt->status.attributes_raw_len);
+            break;
+        case WENDIGO_PKT_VERSION: {
+            /* The preamble is the start of "Wendigo" - Put it back, and drop the NULL terminator */
+            static const uint8_t preamble[WENDIGO_PKT_PREAMBLE_LEN] = WENDIGO_PREAMBLE_VER_INIT;
+            uint16_t len = pkt->version.version_len;
+            while (len > 0 && pkt->version.version[len - 1] == '\0') {
+                --len;
+            }
+            fputs(",\"version\":\"", out);
+            json_chars(out, preamble, WENDIGO_PKT_PREAMBLE_LEN);
+            json_chars(out, pkt->version.version, len);
+            putc('"', out);
+            break;
+        }
+        case WENDIGO_PKT_MAC:
+            fputs(",\"interfaces\":[", out);
+            for (uint16_t i = 0; i < pkt->mac.if_count; ++i) {
+                uint8_t if_type;
+                const uint8_t *mac = wendigo_pkt_typed_mac_at(pkt->mac.interfaces_raw, i, &if_type);
+                fprintf(out, "%s{\"type\":%u,\"mac\":", (i > 0) ? "," : "", if_type);
+                json_mac(out, mac);
+                putc('}', out);
+            }
+            putc(']', out);
+            break;
+        case WENDIGO_PKT_BT_SERVICES:
+            fputs(",\"mac\":", out);
+            json_mac(out, pkt->bt_services.bda);
+            fprintf(out, ",\"result\":%u,\"services\":", pkt->bt_services.result);
+            json_uuids(out, pkt->bt_services.uuids, pkt->bt_services.uuids_len);
+            break;
+        case WENDIGO_PKT_RSSI:
+            fprintf(out, ",\"slot\":%u,\"mac\":", pkt->rssi.slot);
+            json_mac(out, pkt->rssi.mac);
+            fprintf(out, ",\"filtered\":%.1f,\"raw\":%d,\"samples\":%u", pkt->rssi.filtered / 10.0,
+                pkt->rssi.raw, pkt->rssi.samples);
+            break;
+        default:
+            break;
+    }
+    fputs("}\n", out);
+}
+
+static void write_binary(decoder *dec, const uint8_t *raw, uint16_t raw_len) {
+    uint8_t header[6];
+    put_le(header, (uint32_t)(dec->now * 1000.0), 4);
+    put_le(header + 4, raw_len, 2);
+    fwrite(header, 1, sizeof(header), dec->out);
+    fwrite(raw, 1, raw_len, dec->out);
+}
+
+/** Record a device sighting and return whether the device is new */
+static bool track_device(decoder *dec, wendigo_pkt_type type, const wendigo_stream_pkt *pkt) {
+    wendigo_device_entry *entry = NULL;
+    bool is_new = false;
+    switch (type) {
+        case WENDIGO_PKT_BT:
+            entry = wendigo_device_table_update(&dec->devices, WENDIGO_DEVICE_BT, pkt->bt.bda,
+                pkt->bt.rssi, dec->now, &is_new);
+            if (entry != NULL) {
+                wendigo_device_set_name(entry, pkt->bt.bdname, pkt->bt.bdname_len);
+            }
+            break;
+        case WENDIGO_PKT_WIFI_AP:
+            entry = wendigo_device_table_update(&dec->devices, WENDIGO_DEVICE_AP, pkt->wifi_ap.mac,
+                pkt->wifi_ap.rssi, dec->now, &is_new);
+            if (entry != NULL) {
+                entry->channel = pkt->wifi_ap.channel;
+                wendigo_device_set_name(entry, pkt->wifi_ap.ssid, pkt->wifi_ap.ssid_len);
+            }
+            break;
+        case WENDIGO_PKT_WIFI_STA:
+            entry = wendigo_device_table_update(&dec->devices, WENDIGO_DEVICE_STA, pkt->wifi_sta.mac,
+                pkt->wifi_sta.rssi, dec->now, &is_new);
+            if (entry != NULL) {
+                entry->channel = pkt->wifi_sta.channel;
+            }
+            break;
+        default:
+            return false;
+    }
+    if (entry == NULL) {
+        ++dec->out_of_memory;
+    } else if (is_new) {
+        ++dec->devices_new;
+    }
+    return is_new;
+}
+
+static void packet_received(wendigo_pkt_type type, const wendigo_stream_pkt *pkt, const uint8_t *raw,
+        uint16_t raw_len, void *context) {
+    decoder *dec = context;
+    bool is_new = track_device(dec, type, pkt);
+    if (dec->format == OUTPUT_NDJSON) {
+        write_ndjson(dec, type, pkt, is_new);
+    } else if (dec->format == OUTPUT_BINARY) {
+        write_binary(dec, raw, raw_len);
+    }
+}
+
+static void write_devices(decoder *dec) {
+    for (uint32_t i = 0; i < dec->devices.capacity; ++i) {
+        const wendigo_device_entry *entry = &dec->devices.entries[i];
+        if (!entry->used) {
+            continue;
+        }
+        fprintf(dec->out, "{\"type\":\"device\",\"kind\":\"%s\",\"mac\":",
+            wendigo_device_kind_name((wendigo_device_kind)entry->kind));
+        json_mac(dec->out, entry->mac);
+        fprintf(dec->out, ",\"name\":");
+        json_string(dec->out, (const uint8_t *)entry->name, (uint32_t)strlen(entry->name));
+        fprintf(dec->out,
+            ",\"channel\":%u,\"rssi\":%d,\"rssi_min\":%d,\"rssi_max\":%d,\"packets\":%u,"
+            "\"first_seen\":%.3f,\"last_seen\":%.3f}\n",
+            entry->channel, entry->rssi, entry->rssi_min, entry->rssi_max, entry->packets,
+            entry->first_seen, entry->last_seen);
+    }
+}
+
+static void write_stats(decoder *dec, bool final) {
+    const wendigo_stream_stats *stats = &dec->stream.stats;
+    double elapsed = monotonic_now() - dec->started;
+    if (elapsed <= 0) {
+        elapsed = 1e-9;
+    }
+    fprintf(stderr, "{\"type\":\"stats\",\"final\":%s,\"elapsed\":%.3f,\"bytes\":%llu,\"packets\":%llu,",
+        final ? "true" : "false", elapsed, (unsigned long long)stats->bytes,
+        (unsigned long long)stats->packets);
+    for (uint8_t type = 0; type < WENDIGO_PKT_TYPE_COUNT; ++type) {
+        fprintf(stderr, "\"%s\":%llu,", wendigo_pkt_type_name((wendigo_pkt_type)type),
+            (unsigned long long)stats->packets_by_type[type]);
+    }
+    fprintf(stderr,
+        "\"malformed\":%llu,\"skipped_bytes\":%llu,\"truncated_bytes\":%llu,\"devices\":%u,"
+        "\"out_of_memory\":%llu,\"bytes_per_sec\":%.0f,\"packets_per_sec\":%.0f}\n",
+        (unsigned long long)stats->malformed, (unsigned long long)stats->skipped,
+        (unsigned long long)stats->truncated, dec->devices.count,
+        (unsigned long long)dec->out_of_memory, (double)stats->bytes / elapsed,
+        (double)stats->packets / elapsed);
+}
+
+/* Input */
+
+static speed_t baud_to_speed(long baud) {
+    switch (baud) {
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 500000: return B500000;
+        case 921600: return B921600;
+        case 1000000: return B1000000;
+        case 1500000: return B1500000;
+        case 2000000: return B2000000;
+        default: return 0;
+    }
+}
+
+/** Put a serial device or pty into raw mode, optionally setting its speed */
+static bool configure_tty(int fd, long baud) {
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0) {
+        perror("tcgetattr");
+        return false;
+    }
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    if (baud > 0) {
+        speed_t speed = baud_to_speed(baud);
+        if (speed == 0) {
+            fprintf(stderr, "Unsupported baud rate %ld\n", baud);
+            return false;
+        }
+        cfsetispeed(&tio, speed);
+        cfsetospeed(&tio, speed);
+    }
+    if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+        perror("tcsetattr");
+        return false;
+    }
+    return true;
+}
+
+/** Read exactly `len` bytes unless the input ends. Returns the number read. */
+static size_t read_fully(int fd, uint8_t *buf, size_t len) {
+    size_t total = 0;
+    while (total < len && !stop_requested) {
+        ssize_t got = read(fd, buf + total, len - total);
+        if (got > 0) {
+            total += (size_t)got;
+        } else if (got == 0 || errno != EINTR) {
+            /* EIO is how a pty reports that the other end has closed */
+            break;
+        }
+    }
+    return total;
+}
+
+/** Feed a recording or binary log, a chunk at a time */
+static void decode_container(decoder *dec, int fd, input_format format, uint8_t *buf) {
+    uint8_t header[6];
+    double recording_time = 0;
+    while (!stop_requested && read_fully(fd, header, sizeof(header)) == sizeof(header)) {
+        uint32_t ms = get_le(header, 4);
+        uint16_t len = (uint16_t)get_le(header + 4, 2);
+        if (format == INPUT_RECORDING) {
+            recording_time += ms / 1000.0;
+            dec->now = recording_time;
+        } else {
+            dec->now = ms / 1000.0;
+        }
+        size_t got = read_fully(fd, buf, len);
+        wendigo_stream_feed(&dec->stream, buf, got);
+        if (got < len) {
+            break;
+        }
+    }
+}
+
+static void decode_raw(decoder *dec, int fd, uint8_t *buf, size_t already, double stats_interval) {
+    double next_stats = dec->started + stats_interval;
+    if (already > 0) {
+        dec->now = monotonic_now() - dec->started;
+        wendigo_stream_feed(&dec->stream, buf, already);
+    }
+    while (!stop_requested) {
+        ssize_t got = read(fd, buf, READ_SIZE);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            break;
+        }
+        dec->now = monotonic_now() - dec->started;
+        wendigo_stream_feed(&dec->stream, buf, (size_t)got);
+        if (stats_interval > 0 && dec->started + dec->now >= next_stats) {
+            fflush(dec->out);
+            write_stats(dec, false);
+            next_stats += stats_interval;
+        }
+    }
+}
+
+static void usage(const char *name) {
+    fprintf(stderr,
+        "Usage: %s [-b baud] [-o ndjson|binary|none] [-w file] [-s secs] [-d] input\n"
+        "  input      serial device, pty, capture file, uart.rec, binary log, or - for stdin\n"
+        "  -b baud    set the serial device's baud rate (default: leave unchanged)\n"
+        "  -o format  output format (default: ndjson)\n"
+        "  -w file    write output to file (default: stdout)\n"
+        "  -s secs    write statistics to stderr every secs seconds\n"
+        "  -d         write the device table when the input ends\n",
+        name);
+}
+
+int main(int argc, char **argv) {
+    long baud = 0;
+    double stats_interval = 0;
+    bool dump_devices = false;
+    const char *out_path = NULL;
+    output_format format = OUTPUT_NDJSON;
+    int opt;
+    while ((opt = getopt(argc, argv, "b:o:w:s:dh")) != -1) {
+        switch (opt) {
+            case 'b':
+                baud = strtol(optarg, NULL, 10);
+                break;
+            case 'o':
+                if (!strcmp(optarg, "ndjson")) {
+                    format = OUTPUT_NDJSON;
+                } else if (!strcmp(optarg, "binary")) {
+                    format = OUTPUT_BINARY;
+                } else if (!strcmp(optarg, "none")) {
+                    format = OUTPUT_NONE;
+                } else {
+                    usage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 'w':
+                out_path = optarg;
+                break;
+            case 's':
+                stats_interval = strtod(optarg, NULL);
+                break;
+            case 'd':
+                dump_devices = true;
+                break;
+            default:
+                usage(argv[0]);
+                return (opt == 'h') ? 0 : 2;
+        }
+    }
+    if (optind != argc - 1) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    const char *in_path = argv[optind];
+    int fd = strcmp(in_path, "-") ? open(in_path, O_RDONLY | O_NOCTTY) : STDIN_FILENO;
+    if (fd < 0) {
+        fprintf(stderr, "%s: %s\n", in_path, strerror(errno));
+        return 1;
+    }
+    bool is_tty = isatty(fd);
+    if (is_tty && !configure_tty(fd, baud)) {
+        return 1;
+    }
+
+    decoder *dec = calloc(1, sizeof(decoder));
+    uint8_t *buf = malloc(READ_SIZE);
+    if (dec == NULL || buf == NULL || !wendigo_device_table_init(&dec->devices)) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    dec->format = format;
+    dec->out = stdout;
+    if (out_path != NULL) {
+        dec->out = fopen(out_path, (format == OUTPUT_BINARY) ? "wb" : "w");
+        if (dec->out == NULL) {
+            fprintf(stderr, "%s: %s\n", out_path, strerror(errno));
+            return 1;
+        }
+    }
+    setvbuf(dec->out, NULL, _IOFBF, OUTPUT_BUFFER);
+    wendigo_stream_init(&dec->stream, packet_received, dec);
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    if (format == OUTPUT_BINARY) {
+        uint8_t header[CONTAINER_HEADER_LEN];
+        memcpy(header, LOG_MAGIC, CONTAINER_MAGIC_LEN);
+        put_le(header + CONTAINER_MAGIC_LEN, CONTAINER_VERSION, 2);
+        fwrite(header, 1, sizeof(header), dec->out);
+    }
+
+    dec->started = monotonic_now();
+    /* A live device can't be a recording, and we mustn't block waiting for a header */
+    size_t already = 0;
+    input_format in_format = INPUT_RAW;
+    if (!is_tty) {
+        already = read_fully(fd, buf, CONTAINER_HEADER_LEN);
+        if (already == CONTAINER_HEADER_LEN && get_le(buf + CONTAINER_MAGIC_LEN, 2) == CONTAINER_VERSION) {
+            if (!memcmp(buf, RECORD_MAGIC, CONTAINER_MAGIC_LEN)) {
+                in_format = INPUT_RECORDING;
+            } else if (!memcmp(buf, LOG_MAGIC, CONTAINER_MAGIC_LEN)) {
+                in_format = INPUT_LOG;
+            }
+        }
+    }
+    if (in_format == INPUT_RAW) {
+        decode_raw(dec, fd, buf, already, stats_interval);
+    } else {
+        decode_container(dec, fd, in_format, buf);
+    }
+    wendigo_stream_finish(&dec->stream);
+
+    if (dump_devices && format == OUTPUT_NDJSON) {
+        write_devices(dec);
+    }
+    fflush(dec->out);
+    write_stats(dec, true);
+    if (dec->out != stdout) {
+        fclose(dec->out);
+    }
+    if (fd != STDIN_FILENO) {
+        close(fd);
+    }
+    wendigo_device_table_free(&dec->devices);
+    free(buf);
+    free(dec);
+    return 0;
+}
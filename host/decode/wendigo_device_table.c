@@ -0,0 +1,104 @@
+#include "wendigo_device_table.h"
+#include "addr_hash.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define WENDIGO_DEVICE_TABLE_INITIAL_CAPACITY (1024)
+
+static const char *const wendigo_device_kind_names[WENDIGO_DEVICE_KIND_COUNT] = {"bt", "wifi_ap", "wifi_sta"};
+
+const char *wendigo_device_kind_name(wendigo_device_kind kind) {
+    return (kind < WENDIGO_DEVICE_KIND_COUNT) ? wendigo_device_kind_names[kind] : "unknown";
+}
+
+/** FNV-1a over the MAC and kind */
+static uint32_t wendigo_device_hash(wendigo_device_kind kind, const uint8_t *mac) {
+    uint8_t kind_byte = (uint8_t)kind;
+    return addr_hash(&kind_byte, 1, addr_hash(mac, WENDIGO_PKT_MAC_BYTES, ADDR_HASH_INIT));
+}
+
+/** Find the slot for a device - Either the slot it occupies or the empty
+ * slot it would be added to */
+static wendigo_device_entry *wendigo_device_table_slot(wendigo_device_entry *entries, uint32_t capacity,
+        wendigo_device_kind kind, const uint8_t *mac) {
+    uint32_t idx = wendigo_device_hash(kind, mac) & (capacity - 1);
+    while (entries[idx].used &&
+            (entries[idx].kind != kind || memcmp(entries[idx].mac, mac, WENDIGO_PKT_MAC_BYTES))) {
+        idx = (idx + 1) & (capacity - 1);
+    }
+    return &entries[idx];
+}
+
+static bool wendigo_device_table_grow(wendigo_device_table *table) {
+    uint32_t capacity = table->capacity * 2;
+    wendigo_device_entry *entries = calloc(capacity, sizeof(wendigo_device_entry));
+    if (entries == NULL) {
+        return false;
+    }
+    for (uint32_t i = 0; i < table->capacity; ++i) {
+        if (table->entries[i].used) {
+            wendigo_device_entry *slot = wendigo_device_table_slot(entries, capacity,
+                (wendigo_device_kind)table->entries[i].kind, table->entries[i].mac);
+            *slot = table->entries[i];
+        }
+    }
+    free(table->entries);
+    table->entries = entries;
+    table->capacity = capacity;
+    return true;
+}
+
+bool wendigo_device_table_init(wendigo_device_table *table) {
+    table->count = 0;
+    table->capacity = WENDIGO_DEVICE_TABLE_INITIAL_CAPACITY;
+    table->entries = calloc(table->capacity, sizeof(wendigo_device_entry));
+    return table->entries != NULL;
+}
+
+void wendigo_device_table_free(wendigo_device_table *table) {
+    free(table->entries);
+    table->entries = NULL;
+    table->capacity = 0;
+    table->count = 0;
+}
+
+wendigo_device_entry *wendigo_device_table_update(wendigo_device_table *table, wendigo_device_kind kind,
+        const uint8_t mac[WENDIGO_PKT_MAC_BYTES], int16_t rssi, double now, bool *is_new) {
+    /* Keep the load factor below 0.7 */
+    if ((table->count + 1) * 10 > table->capacity * 7 && !wendigo_device_table_grow(table)) {
+        return NULL;
+    }
+    wendigo_device_entry *entry = wendigo_device_table_slot(table->entries, table->capacity, kind, mac);
+    *is_new = !entry->used;
+    if (*is_new) {
+        entry->used = true;
+        entry->kind = (uint8_t)kind;
+        memcpy(entry->mac, mac, WENDIGO_PKT_MAC_BYTES);
+        entry->rssi_min = rssi;
+        entry->rssi_max = rssi;
+        entry->first_seen = now;
+        ++table->count;
+    }
+    entry->rssi = rssi;
+    if (rssi < entry->rssi_min) {
+        entry->rssi_min = rssi;
+    }
+    if (rssi > entry->rssi_max) {
+        entry->rssi_max = rssi;
+    }
+    entry->last_seen = now;
+    ++entry->packets;
+    return entry;
+}
+
+void wendigo_device_set_name(wendigo_device_entry *entry, const uint8_t *name, uint16_t name_len) {
+    if (name == NULL || name_len == 0) {
+        return;
+    }
+    if (name_len > WENDIGO_DEVICE_NAME_MAX) {
+        name_len = WENDIGO_DEVICE_NAME_MAX;
+    }
+    memcpy(entry->name, name, name_len);
+    entry->name[name_len] = '\0';
+}
@@ -0,0 +1,51 @@
+/** Devices seen in a Wendigo stream, keyed by MAC and device type.
+ *
+ * An open-addressing hash table that grows as needed, so lookups stay O(1)
+ * however many devices a long capture contains.
+ */
+#pragma once
+
+#include "wendigo_packets.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define WENDIGO_DEVICE_NAME_MAX (64)
+
+typedef enum {
+    WENDIGO_DEVICE_BT = 0,
+    WENDIGO_DEVICE_AP,
+    WENDIGO_DEVICE_STA,
+    WENDIGO_DEVICE_KIND_COUNT
+} wendigo_device_kind;
+
+typedef struct {
+    bool used;
+    uint8_t kind;                              /* wendigo_device_kind */
+    uint8_t mac[WENDIGO_PKT_MAC_BYTES];
+    uint8_t channel;                           /* WiFi only */
+    int16_t rssi;                              /* Most recent */
+    int16_t rssi_min;
+    int16_t rssi_max;
+    uint32_t packets;
+    double first_seen;                         /* Seconds, on the stream's clock */
+    double last_seen;
+    char name[WENDIGO_DEVICE_NAME_MAX + 1];    /* BT name or AP SSID */
+} wendigo_device_entry;
+
+typedef struct {
+    wendigo_device_entry *entries;
+    uint32_t capacity; /* Always a power of 2 */
+    uint32_t count;
+} wendigo_device_table;
+
+bool wendigo_device_table_init(wendigo_device_table *table);
+void wendigo_device_table_free(wendigo_device_table *table);
+/** Find the device, adding it if it's new, and record a sighting. Sets
+ * `*is_new` if the device wasn't already in the table. Returns NULL if
+ * memory is exhausted. */
+wendigo_device_entry *wendigo_device_table_update(wendigo_device_table *table, wendigo_device_kind kind,
+    const uint8_t mac[WENDIGO_PKT_MAC_BYTES], int16_t rssi, double now, bool *is_new);
+/** Copy a name that isn't NULL-terminated into the entry, truncating it if necessary */
+void wendigo_device_set_name(wendigo_device_entry *entry, const uint8_t *name, uint16_t name_len);
+const char *wendigo_device_kind_name(wendigo_device_kind kind);
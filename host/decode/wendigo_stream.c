@@ -0,0 +1,116 @@
+#include "wendigo_stream.h"
+
+#include <string.h>
+
+/* The decoders take a uint16_t length, so no packet can be longer than this */
+#define WENDIGO_STREAM_MAX_PACKET (UINT16_MAX)
+
+void wendigo_stream_init(wendigo_stream *stream, wendigo_stream_packet_cb callback, void *context) {
+    memset(stream, 0, sizeof(wendigo_stream));
+    stream->callback = callback;
+    stream->context = context;
+}
+
+/** Validate the `type` packet at `buf` and fill `pkt`. Returns the packet's
+ * length, which is `len` if it's valid. */
+static uint16_t wendigo_stream_decode(wendigo_pkt_type type, wendigo_stream_pkt *pkt,
+        const uint8_t *buf, uint16_t len) {
+    switch (type) {
+        case WENDIGO_PKT_BT:
+            return wendigo_pkt_bt_decode(&pkt->bt, buf, len);
+        case WENDIGO_PKT_WIFI_AP:
+            return wendigo_pkt_wifi_ap_decode(&pkt->wifi_ap, buf, len);
+        case WENDIGO_PKT_WIFI_STA:
+            return wendigo_pkt_wifi_sta_decode(&pkt->wifi_sta, buf, len);
+        case WENDIGO_PKT_CHANNELS:
+            return wendigo_pkt_channels_decode(&pkt->channels, buf, len);
+        case WENDIGO_PKT_STATUS:
+            return wendigo_pkt_status_decode(&pkt->status, buf, len);
+        case WENDIGO_PKT_VERSION:
+            return wendigo_pkt_version_decode(&pkt->version, buf, len);
+        case WENDIGO_PKT_MAC:
+            return wendigo_pkt_mac_decode(&pkt->mac, buf, len);
+        case WENDIGO_PKT_BT_SERVICES:
+            return wendigo_pkt_bt_services_decode(&pkt->bt_services, buf, len);
+        case WENDIGO_PKT_RSSI:
+            return wendigo_pkt_rssi_decode(&pkt->rssi, buf, len);
+        default:
+            return 0;
+    }
+}
+
+/** Consume every complete packet in the buffer. Stops when the rest of the
+ * buffer could be the start of a packet that hasn't fully arrived. */
+static void wendigo_stream_process(wendigo_stream *stream) {
+    wendigo_stream_pkt pkt;
+    while (stream->end - stream->start >= WENDIGO_PKT_PREAMBLE_LEN) {
+        /* Find the next preamble */
+        uint32_t pos = stream->start;
+        wendigo_pkt_type type = WENDIGO_PKT_UNKNOWN;
+        while (pos + WENDIGO_PKT_PREAMBLE_LEN <= stream->end &&
+                (type = wendigo_pkt_identify(stream->buf + pos, WENDIGO_PKT_PREAMBLE_LEN)) ==
+                    WENDIGO_PKT_UNKNOWN) {
+            ++pos;
+        }
+        stream->stats.skipped += pos - stream->start;
+        stream->start = pos;
+        if (type == WENDIGO_PKT_UNKNOWN) {
+            /* The last few bytes could be the start of a preamble */
+            return;
+        }
+        uint32_t avail = stream->end - pos;
+        uint16_t window = (avail > WENDIGO_STREAM_MAX_PACKET) ? WENDIGO_STREAM_MAX_PACKET : (uint16_t)avail;
+        uint32_t frame_len = wendigo_pkt_frame_len(type, stream->buf + pos, window);
+        if (frame_len == 0 && window < WENDIGO_STREAM_MAX_PACKET) {
+            return; /* Need more bytes to find the end of the packet */
+        }
+        if (frame_len != 0 && frame_len <= WENDIGO_STREAM_MAX_PACKET && frame_len > avail) {
+            return;
+        }
+        if (frame_len != 0 && frame_len <= WENDIGO_STREAM_MAX_PACKET &&
+                wendigo_stream_decode(type, &pkt, stream->buf + pos, (uint16_t)frame_len) == frame_len) {
+            ++stream->stats.packets;
+            ++stream->stats.packets_by_type[type];
+            stream->start = pos + frame_len;
+            if (stream->callback != NULL) {
+                stream->callback(type, &pkt, stream->buf + pos, (uint16_t)frame_len, stream->context);
+            }
+        } else {
+            /* Not a packet after all - Resynchronise from the next byte */
+            ++stream->stats.malformed;
+            ++stream->stats.skipped;
+            stream->start = pos + 1;
+        }
+    }
+}
+
+void wendigo_stream_feed(wendigo_stream *stream, const uint8_t *data, size_t len) {
+    stream->stats.bytes += len;
+    while (len > 0) {
+        /* Move unprocessed bytes to the start of the buffer to make room */
+        if (stream->start > 0 && stream->end == WENDIGO_STREAM_BUFFER_SIZE) {
+            memmove(stream->buf, stream->buf + stream->start, stream->end - stream->start);
+            stream->end -= stream->start;
+            stream->start = 0;
+        }
+        size_t space = WENDIGO_STREAM_BUFFER_SIZE - stream->end;
+        size_t chunk = (len < space) ? len : space;
+        memcpy(stream->buf + stream->end, data, chunk);
+        stream->end += (uint32_t)chunk;
+        data += chunk;
+        len -= chunk;
+        wendigo_stream_process(stream);
+    }
+}
+
+void wendigo_stream_finish(wendigo_stream *stream) {
+    uint32_t remaining = stream->end - stream->start;
+    if (remaining >= WENDIGO_PKT_PREAMBLE_LEN &&
+            wendigo_pkt_identify(stream->buf + stream->start, remaining) != WENDIGO_PKT_UNKNOWN) {
+        stream->stats.truncated += remaining;
+    } else {
+        stream->stats.skipped += remaining;
+    }
+    stream->start = 0;
+    stream->end = 0;
+}
@@ -0,0 +1,61 @@
+/** Find and validate Wendigo packets in a byte stream.
+ *
+ * Bytes from ESP32-Wendigo arrive in arbitrary chunks - a read() can end part
+ * way through a packet, and log output or line noise can appear between
+ * packets. wendigo_stream buffers what it's fed, finds each packet by its
+ * preamble and length fields, validates it with the generated decoder and
+ * hands it to a callback. Anything that isn't a valid packet is skipped, one
+ * byte at a time, until the next preamble.
+ */
+#pragma once
+
+#include "wendigo_packets.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Must hold the largest possible packet plus a read() */
+#define WENDIGO_STREAM_BUFFER_SIZE (128 * 1024)
+
+/* A decoded packet - Which member is valid depends on its wendigo_pkt_type */
+typedef union {
+    wendigo_pkt_bt bt;
+    wendigo_pkt_wifi_ap wifi_ap;
+    wendigo_pkt_wifi_sta wifi_sta;
+    wendigo_pkt_channels channels;
+    wendigo_pkt_status status;
+    wendigo_pkt_version version;
+    wendigo_pkt_mac mac;
+    wendigo_pkt_bt_services bt_services;
+    wendigo_pkt_rssi rssi;
+} wendigo_stream_pkt;
+
+typedef struct {
+    uint64_t bytes;                              /* Bytes fed into the stream */
+    uint64_t packets;                            /* Valid packets of all types */
+    uint64_t packets_by_type[WENDIGO_PKT_TYPE_COUNT];
+    uint64_t malformed;                          /* Had a preamble but failed to decode */
+    uint64_t skipped;                            /* Bytes discarded between packets */
+    uint64_t truncated;                          /* Bytes of an incomplete packet at end of stream */
+} wendigo_stream_stats;
+
+/** Called for each valid packet. `pkt` and `raw` are only valid until the
+ * callback returns. */
+typedef void (*wendigo_stream_packet_cb)(
+    wendigo_pkt_type type, const wendigo_stream_pkt *pkt, const uint8_t *raw, uint16_t raw_len,
+    void *context);
+
+typedef struct {
+    uint8_t buf[WENDIGO_STREAM_BUFFER_SIZE];
+    uint32_t start; /* First unprocessed byte */
+    uint32_t end;   /* One past the last byte received */
+    wendigo_stream_packet_cb callback;
+    void *context;
+    wendigo_stream_stats stats;
+} wendigo_stream;
+
+void wendigo_stream_init(wendigo_stream *stream, wendigo_stream_packet_cb callback, void *context);
+/** Process `len` bytes, calling the callback for each complete packet */
+void wendigo_stream_feed(wendigo_stream *stream, const uint8_t *data, size_t len);
+/** End of input - Account for anything left in the buffer */
+void wendigo_stream_finish(wendigo_stream *stream);
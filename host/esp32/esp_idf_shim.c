@@ -0,0 +1,146 @@
+/** Stubs for the ESP-IDF functions declared in shim/esp_idf_shim.h.
+ *
+ * The radio is replaced by a capture file, so configuring it always succeeds
+ * and does nothing. Tasks are never started - The channel is whatever the
+ * capture says it is.
+ */
+#include "esp_idf_shim.h"
+
+#include <time.h>
+
+void esp_log_level_set(const char *tag, esp_log_level_t level) {
+    (void)tag;
+    (void)level;
+}
+
+BaseType_t xTaskCreate(void (*task)(void *), const char *name, uint32_t stack, void *param,
+        uint32_t priority, TaskHandle_t *handle) {
+    (void)task;
+    (void)name;
+    (void)stack;
+    (void)param;
+    (void)priority;
+    if (handle != NULL) {
+        *handle = NULL;
+    }
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    (void)task;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    (void)ticks;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *handle) {
+    (void)args;
+    *handle = (esp_timer_handle_t)1;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+    (void)timer;
+    (void)timeout_us;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us) {
+    (void)timer;
+    (void)period_us;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    (void)timer;
+    return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer) {
+    (void)timer;
+    return false;
+}
+
+int64_t esp_timer_get_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((int64_t)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+}
+
+/** A fixed MAC per interface, so output is reproducible */
+esp_err_t esp_read_mac(uint8_t *mac, esp_mac_type_t type) {
+    static const uint8_t base[ESP_BD_ADDR_LEN] = {0x02, 0x57, 0x45, 0x4E, 0x44, 0x00};
+    memcpy(mac, base, ESP_BD_ADDR_LEN);
+    mac[5] = (uint8_t)type;
+    return ESP_OK;
+}
+
+esp_err_t esp_iface_mac_addr_set(const uint8_t *mac, esp_mac_type_t type) {
+    (void)mac;
+    (void)type;
+    return ESP_OK;
+}
+
+esp_err_t esp_netif_init(void) {
+    return ESP_OK;
+}
+
+esp_err_t esp_event_loop_create_default(void) {
+    return ESP_OK;
+}
+
+void *esp_netif_create_default_wifi_ap(void) {
+    return NULL;
+}
+
+esp_err_t esp_wifi_init(const wifi_init_config_t *config) {
+    (void)config;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_storage(wifi_storage_t storage) {
+    (void)storage;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_mode(wifi_mode_t mode) {
+    (void)mode;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_config(wifi_interface_t interface, wifi_config_t *conf) {
+    (void)interface;
+    (void)conf;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_start(void) {
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_ps(wifi_ps_type_t type) {
+    (void)type;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_promiscuous_filter(const wifi_promiscuous_filter_t *filter) {
+    (void)filter;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_promiscuous_rx_cb(wifi_promiscuous_cb_t cb) {
+    (void)cb;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_promiscuous(bool enabled) {
+    (void)enabled;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_channel(uint8_t primary, wifi_second_chan_t second) {
+    (void)primary;
+    (void)second;
+    return ESP_OK;
+}
@@ -0,0 +1,259 @@
+/** Just enough of ESP-IDF to build ESP32-Wendigo's WiFi parsing and device
+ * cache on a Linux host.
+ *
+ * Types keep the names and members ESP32-Wendigo uses, but not necessarily
+ * ESP-IDF's layout. Radio, task, timer and MAC functions are stubs in
+ * esp_idf_shim.c, and logging goes to stderr so stdout carries only the
+ * UART stream.
+ */
+#pragma once
+
+#include "sdkconfig.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+/* esp_err.h */
+typedef int esp_err_t;
+#define ESP_OK                  (0)
+#define ESP_FAIL                (-1)
+#define ESP_ERR_NO_MEM          (0x101)
+#define ESP_ERR_INVALID_ARG     (0x102)
+#define ESP_ERR_INVALID_STATE   (0x103)
+#define ESP_ERR_INVALID_SIZE    (0x104)
+#define ESP_ERR_NOT_SUPPORTED   (0x106)
+#define ESP_ERROR_CHECK(x)      do { esp_err_t err_rc_ = (x); if (err_rc_ != ESP_OK) { \
+                                    fprintf(stderr, "ESP_ERROR_CHECK failed: %d at %s:%d\n", err_rc_, __FILE__, __LINE__); \
+                                    abort(); } } while (0)
+
+/* esp_log.h */
+typedef enum {
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE
+} esp_log_level_t;
+#define ESP_SHIM_LOG(level, tag, format, ...) fprintf(stderr, level " (%s) " format "\n", tag, ##__VA_ARGS__)
+#define ESP_LOGE(tag, format, ...)  ESP_SHIM_LOG("E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...)  ESP_SHIM_LOG("W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...)  ESP_SHIM_LOG("I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...)  do { } while (0)
+#define ESP_LOGV(tag, format, ...)  do { } while (0)
+void esp_log_level_set(const char *tag, esp_log_level_t level);
+
+/* FreeRTOS - There's only one task on the host, so semaphores always succeed */
+typedef void *SemaphoreHandle_t;
+typedef void *TaskHandle_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+#define pdTRUE                  (1)
+#define pdFALSE                 (0)
+#define pdPASS                  (pdTRUE)
+#define portMAX_DELAY           ((TickType_t)0xFFFFFFFF)
+#define portTICK_PERIOD_MS      ((TickType_t)1)
+#define tskNO_AFFINITY          (0x7FFFFFFF)
+#define xSemaphoreCreateMutex() ((SemaphoreHandle_t)1)
+#define xSemaphoreTake(sem, ticks) ((void)(sem), (void)(ticks), pdTRUE)
+/* Functions rather than comma expressions, so ignoring the result isn't a
+   "statement with no effect" */
+static inline BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+    (void)sem;
+    return pdTRUE;
+}
+#define xSemaphoreCreateRecursiveMutex() ((SemaphoreHandle_t)1)
+#define xSemaphoreTakeRecursive(sem, ticks) ((void)(sem), (void)(ticks), pdTRUE)
+static inline BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t sem) {
+    (void)sem;
+    return pdTRUE;
+}
+BaseType_t xTaskCreate(void (*task)(void *), const char *name, uint32_t stack, void *param,
+    uint32_t priority, TaskHandle_t *handle);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED (0)
+#define portENTER_CRITICAL(mux) ((void)(mux))
+#define portEXIT_CRITICAL(mux)  ((void)(mux))
+#define IRAM_ATTR
+static inline BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+    (void)task;
+    return pdPASS;
+}
+#define vTaskNotifyGiveFromISR(task, woken) ((void)(task), (void)(woken))
+static inline uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks) {
+    (void)clear;
+    (void)ticks;
+    return 1;
+}
+
+/* esp_timer.h - Timers never fire on the host; time is the host's monotonic clock */
+typedef void *esp_timer_handle_t;
+typedef void (*esp_timer_cb_t)(void *arg);
+typedef enum {
+    ESP_TIMER_TASK,
+    ESP_TIMER_ISR,
+} esp_timer_dispatch_t;
+typedef struct {
+    esp_timer_cb_t callback;
+    void *arg;
+    esp_timer_dispatch_t dispatch_method;
+    const char *name;
+} esp_timer_create_args_t;
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *handle);
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us);
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us);
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+bool esp_timer_is_active(esp_timer_handle_t timer);
+int64_t esp_timer_get_time(void);
+#define esp_timer_isr_dispatch_need_yield() do { } while (0)
+
+/* esp_bt_defs.h */
+#define ESP_BD_ADDR_LEN         (6)
+typedef uint8_t esp_bd_addr_t[ESP_BD_ADDR_LEN];
+#define ESP_UUID_LEN_16         (2)
+#define ESP_UUID_LEN_32         (4)
+#define ESP_UUID_LEN_128        (16)
+typedef struct {
+    uint16_t len;
+    union {
+        uint16_t uuid16;
+        uint32_t uuid32;
+        uint8_t uuid128[16];
+    } uuid;
+} esp_bt_uuid_t;
+
+/* esp_mac.h */
+typedef enum {
+    ESP_MAC_WIFI_STA,
+    ESP_MAC_WIFI_SOFTAP,
+    ESP_MAC_BT,
+    ESP_MAC_ETH,
+    ESP_MAC_IEEE802154,
+    ESP_MAC_BASE,
+} esp_mac_type_t;
+esp_err_t esp_read_mac(uint8_t *mac, esp_mac_type_t type);
+esp_err_t esp_iface_mac_addr_set(const uint8_t *mac, esp_mac_type_t type);
+
+/* esp_wifi_types.h */
+typedef enum {
+    WIFI_AUTH_OPEN = 0,
+    WIFI_AUTH_WEP,
+    WIFI_AUTH_WPA_PSK,
+    WIFI_AUTH_WPA2_PSK,
+    WIFI_AUTH_WPA_WPA2_PSK,
+    WIFI_AUTH_ENTERPRISE,
+    WIFI_AUTH_WPA2_ENTERPRISE = WIFI_AUTH_ENTERPRISE,
+    WIFI_AUTH_WPA3_PSK,
+    WIFI_AUTH_WPA2_WPA3_PSK,
+    WIFI_AUTH_WAPI_PSK,
+    WIFI_AUTH_OWE,
+    WIFI_AUTH_WPA3_ENT_192,
+    WIFI_AUTH_WPA3_EXT_PSK,
+    WIFI_AUTH_WPA3_EXT_PSK_MIXED_MODE,
+    WIFI_AUTH_DPP,
+    WIFI_AUTH_WPA3_ENTERPRISE,
+    WIFI_AUTH_WPA2_WPA3_ENTERPRISE,
+    WIFI_AUTH_MAX
+} wifi_auth_mode_t;
+
+typedef enum {
+    WIFI_PKT_MGMT,
+    WIFI_PKT_CTRL,
+    WIFI_PKT_DATA,
+    WIFI_PKT_MISC,
+} wifi_promiscuous_pkt_type_t;
+
+/** The fields of ESP-IDF's rx_ctrl that ESP32-Wendigo uses, with the same
+ * widths so values are truncated the way they would be on the chip */
+typedef struct {
+    signed rssi: 8;
+    unsigned rate: 5;
+    unsigned channel: 4;
+    unsigned sig_len: 12;
+    unsigned rx_state: 8;
+    uint32_t timestamp;
+} wifi_pkt_rx_ctrl_t;
+
+typedef struct {
+    wifi_pkt_rx_ctrl_t rx_ctrl;
+    uint8_t payload[];
+} wifi_promiscuous_pkt_t;
+
+typedef enum {
+    WIFI_MODE_NULL = 0,
+    WIFI_MODE_STA,
+    WIFI_MODE_AP,
+    WIFI_MODE_APSTA,
+} wifi_mode_t;
+
+typedef enum {
+    WIFI_IF_STA = 0,
+    WIFI_IF_AP,
+} wifi_interface_t;
+
+typedef enum {
+    WIFI_STORAGE_FLASH,
+    WIFI_STORAGE_RAM,
+} wifi_storage_t;
+
+typedef enum {
+    WIFI_PS_NONE,
+    WIFI_PS_MIN_MODEM,
+    WIFI_PS_MAX_MODEM,
+} wifi_ps_type_t;
+
+typedef enum {
+    WIFI_SECOND_CHAN_NONE = 0,
+    WIFI_SECOND_CHAN_ABOVE,
+    WIFI_SECOND_CHAN_BELOW,
+} wifi_second_chan_t;
+
+typedef struct {
+    uint8_t ssid[32];
+    uint8_t password[64];
+    uint8_t ssid_len;
+    uint8_t channel;
+    wifi_auth_mode_t authmode;
+    uint8_t ssid_hidden;
+    uint8_t max_connection;
+    uint16_t beacon_interval;
+} wifi_ap_config_t;
+
+typedef union {
+    wifi_ap_config_t ap;
+} wifi_config_t;
+
+typedef struct {
+    int unused;
+} wifi_init_config_t;
+#define WIFI_INIT_CONFIG_DEFAULT() { 0 }
+
+#define WIFI_PROMIS_FILTER_MASK_MGMT (1)
+#define WIFI_PROMIS_FILTER_MASK_CTRL (1 << 1)
+#define WIFI_PROMIS_FILTER_MASK_DATA (1 << 2)
+typedef struct {
+    uint32_t filter_mask;
+} wifi_promiscuous_filter_t;
+typedef void (*wifi_promiscuous_cb_t)(void *buf, wifi_promiscuous_pkt_type_t type);
+
+/* esp_wifi.h and esp_netif.h */
+esp_err_t esp_netif_init(void);
+esp_err_t esp_event_loop_create_default(void);
+void *esp_netif_create_default_wifi_ap(void);
+esp_err_t esp_wifi_init(const wifi_init_config_t *config);
+esp_err_t esp_wifi_set_storage(wifi_storage_t storage);
+esp_err_t esp_wifi_set_mode(wifi_mode_t mode);
+esp_err_t esp_wifi_set_config(wifi_interface_t interface, wifi_config_t *conf);
+esp_err_t esp_wifi_start(void);
+esp_err_t esp_wifi_set_ps(wifi_ps_type_t type);
+esp_err_t esp_wifi_set_promiscuous_filter(const wifi_promiscuous_filter_t *filter);
+esp_err_t esp_wifi_set_promiscuous_rx_cb(wifi_promiscuous_cb_t cb);
+esp_err_t esp_wifi_set_promiscuous(bool enabled);
+esp_err_t esp_wifi_set_channel(uint8_t primary, wifi_second_chan_t second);
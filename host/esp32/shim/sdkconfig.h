@@ -0,0 +1,41 @@
+/* The options from esp32/sdkconfig that the shimmed sources depend on */
+#pragma once
+
+#define CONFIG_DEFAULT_HOP_MILLIS   500
+#define CONFIG_DECODE_UUIDS         1
+#define CONFIG_BLE_FILTER_WINDOW_MILLIS 1000
+#define CONFIG_BLE_FILTER_RSSI_DELTA    5
+#define CONFIG_BLE_FILTER_ENTRIES       128
+#define CONFIG_BLE_SCAN_ADAPTIVE        1
+#define CONFIG_BLE_SCAN_DENSE_ADVERTS   300
+#define CONFIG_BLE_SCAN_BUSY_NEW_DEVICES 6
+#define CONFIG_BLE_SCAN_UNCACHED_PERCENT 5
+#define CONFIG_BLE_SCAN_RSP_CACHE_ENTRIES 64
+#define CONFIG_BLE_SCAN_RSP_CACHE_SECONDS 300
+#define CONFIG_GATT_DISCOVERY_MAX_CONNECTIONS 2
+#define CONFIG_GATT_DISCOVERY_TIMEOUT_MILLIS  10000
+#define CONFIG_GATT_DISCOVERY_WAIT_SECONDS    60
+#define CONFIG_GATT_DISCOVERY_QUEUE_LEN       8
+#define CONFIG_GATT_DISCOVERY_CACHE_ENTRIES   16
+#define CONFIG_FOCUS_RSSI_MAX_DEVICES       8
+#define CONFIG_FOCUS_RSSI_RATE_HZ           10
+#define CONFIG_FOCUS_RSSI_PROCESS_NOISE     1
+#define CONFIG_FOCUS_RSSI_MEASUREMENT_NOISE 16
+#define CONFIG_FOCUS_HOP_MAX_CHANNELS           3
+#define CONFIG_FOCUS_HOP_EXCURSION_MILLIS       3000
+#define CONFIG_FOCUS_HOP_EXCURSION_DWELL_MILLIS 150
+#define CONFIG_FOCUS_HOP_STALE_MILLIS           10000
+#define CONFIG_RADIO_SCHED_PERIOD_MILLIS 12000
+#define CONFIG_RADIO_SCHED_MIN_SHARE    15
+#define CONFIG_RADIO_SCHED_YIELD_WEIGHT 30
+#define CONFIG_RADIO_SCHED_TASK_PRIORITY 5
+#define CONFIG_HOP_TASK_PRIORITY        10
+#define CONFIG_PIPELINE_RADIO_CORE      0
+#define CONFIG_PIPELINE_CORE            1
+#define CONFIG_PIPELINE_QUEUE_LEN       64
+#define CONFIG_PIPELINE_TASK_PRIORITY   5
+#define CONFIG_BT_ENABLED           1
+#define CONFIG_BT_CLASSIC_ENABLED   1
+#define CONFIG_BT_BLE_ENABLED       1
+#define CONFIG_ESP_WIFI_ENABLED     1
+#define CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD 1
@@ -0,0 +1,273 @@
+/** wendigo-ad: Run captured BLE advertisements and Bluetooth Classic EIR
+ * through ESP32-Wendigo's AD structure parser.
+ *
+ * Reads payloads as hex, one per line - Spaces and colons between bytes are
+ * ignored, as is anything after a '#' - and writes what bt_ad_parse() made of
+ * each one to stdout as a line of JSON, with the names bt_uuid_lookup() has
+ * for its services and manufacturer. That's the same every time for the
+ * same input, so it can be kept as the known-good result for a regression
+ * test:
+ *
+ *     wendigo-ad adverts.txt | cmp - adverts.json
+ *
+ * Payload counts and payloads per second are written to stderr as JSON. With
+ * -n the payloads are parsed that many times, but only reported once.
+ *
+ *     wendigo-ad [-n repeats] [payloads.txt...]
+ */
+#include "bt_ad.h"
+#include "bt_uuids.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Longer than any advertisement, scan response or EIR */
+#define PAYLOAD_MAX_LEN (1024)
+
+typedef struct {
+    uint8_t *bytes;         /* Payloads back to back */
+    uint16_t *lens;
+    size_t len;
+    size_t count;
+    size_t capacity;
+    size_t bytes_capacity;
+    uint32_t skipped;       /* Lines that weren't hex */
+} payload_store;
+
+static bool store_payload(payload_store *store, const uint8_t *payload, uint16_t len) {
+    if (store->count == store->capacity) {
+        size_t capacity = (store->capacity == 0) ? 64 : store->capacity * 2;
+        uint16_t *lens = realloc(store->lens, sizeof(uint16_t) * capacity);
+        if (lens == NULL) {
+            return false;
+        }
+        store->lens = lens;
+        store->capacity = capacity;
+    }
+    if (store->len + len > store->bytes_capacity) {
+        size_t capacity = (store->bytes_capacity == 0) ? 4096 : store->bytes_capacity;
+        while (store->len + len > capacity) {
+            capacity *= 2;
+        }
+        uint8_t *bytes = realloc(store->bytes, capacity);
+        if (bytes == NULL) {
+            return false;
+        }
+        store->bytes = bytes;
+        store->bytes_capacity = capacity;
+    }
+    memcpy(store->bytes + store->len, payload, len);
+    store->len += len;
+    store->lens[store->count++] = len;
+    return true;
+}
+
+/* Parse a line of hex into `payload`. Returns -1 if it isn't hex, otherwise
+   the number of bytes, which is 0 for a blank line or comment */
+static int parse_hex_line(const char *line, uint8_t *payload) {
+    int len = 0;
+    int nibbles = 0;
+    uint8_t byte = 0;
+    for (const char *p = line; *p != '\0' && *p != '#'; ++p) {
+        if (isspace((unsigned char)*p) || *p == ':') {
+            continue;
+        }
+        if (!isxdigit((unsigned char)*p) || len == PAYLOAD_MAX_LEN) {
+            return -1;
+        }
+        byte = (byte << 4) | (uint8_t)(isdigit((unsigned char)*p) ? *p - '0' : tolower((unsigned char)*p) - 'a' + 10);
+        if (++nibbles == 2) {
+            payload[len++] = byte;
+            nibbles = 0;
+            byte = 0;
+        }
+    }
+    return (nibbles == 0) ? len : -1;
+}
+
+static bool load_payloads(const char *path, FILE *in, payload_store *store) {
+    char line[PAYLOAD_MAX_LEN * 3 + 64];
+    uint8_t payload[PAYLOAD_MAX_LEN];
+    uint32_t line_num = 0;
+    while (fgets(line, sizeof(line), in) != NULL) {
+        ++line_num;
+        int len = parse_hex_line(line, payload);
+        if (len < 0) {
+            fprintf(stderr, "%s:%u: Not a hex payload\n", path, line_num);
+            ++store->skipped;
+        } else if (len > 0 && !store_payload(store, payload, (uint16_t)len)) {
+            fprintf(stderr, "%s: Out of memory\n", path);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void print_json_string(const uint8_t *str, uint8_t len) {
+    putchar('"');
+    for (uint8_t i = 0; i < len; ++i) {
+        if (str[i] == '"' || str[i] == '\\') {
+            printf("\\%c", str[i]);
+        } else if (str[i] < 0x20 || str[i] >= 0x7F) {
+            printf("\\u%04x", str[i]);
+        } else {
+            putchar(str[i]);
+        }
+    }
+    putchar('"');
+}
+
+/* As ESP32-Wendigo displays UUIDs */
+static void print_uuid(const esp_bt_uuid_t *uuid) {
+    if (uuid->len == ESP_UUID_LEN_16) {
+        printf("\"%04x\"", uuid->uuid.uuid16);
+    } else if (uuid->len == ESP_UUID_LEN_32) {
+        printf("\"%08x\"", uuid->uuid.uuid32);
+    } else {
+        const uint8_t *p = uuid->uuid.uuid128;
+        printf("\"%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x\"",
+            p[15], p[14], p[13], p[12], p[11], p[10], p[9], p[8], p[7], p[6], p[5], p[4],
+            p[3], p[2], p[1], p[0]);
+    }
+}
+
+static void print_ad(bool valid, const bt_ad_data *ad) {
+    printf("{\"valid\":%s", valid ? "true" : "false");
+    if (ad->has_flags) {
+        printf(",\"flags\":%u", ad->flags);
+    }
+    if (ad->name_len > 0) {
+        printf(",\"name\":");
+        print_json_string(ad->name, ad->name_len);
+        printf(",\"name_complete\":%s", ad->name_complete ? "true" : "false");
+    }
+    if (ad->has_tx_power) {
+        printf(",\"tx_power\":%d", ad->tx_power);
+    }
+    if (ad->has_appearance) {
+        printf(",\"appearance\":%u", ad->appearance);
+    }
+    if (ad->has_company_id) {
+        printf(",\"company_id\":%u", ad->company_id);
+        const bt_uuid *company = bt_uuid_lookup(BT_UUID_TABLE_COMPANY, ad->company_id);
+        if (company != NULL) {
+            printf(",\"company\":");
+            print_json_string((const uint8_t *)company->name, (uint8_t)strlen(company->name));
+        }
+    }
+    if (ad->uuid_count > 0) {
+        printf(",\"uuids\":[");
+        for (uint8_t i = 0; i < ad->uuid_count; ++i) {
+            if (i > 0) {
+                putchar(',');
+            }
+            print_uuid(&(ad->uuids[i]));
+        }
+        printf("],\"uuids_truncated\":%s", ad->uuids_truncated ? "true" : "false");
+        /* As svcForUUID() in bluetooth.c */
+        bool first = true;
+        for (uint8_t i = 0; i < ad->uuid_count; ++i) {
+            if (ad->uuids[i].len != ESP_UUID_LEN_16) {
+                continue;
+            }
+            const bt_uuid *known = bt_uuid_lookup(BT_UUID_TABLE_SERVICE_CLASS, ad->uuids[i].uuid.uuid16);
+            if (known == NULL) {
+                known = bt_uuid_lookup(BT_UUID_TABLE_GATT_SERVICE, ad->uuids[i].uuid.uuid16);
+            }
+            if (known != NULL) {
+                printf(first ? ",\"services\":[" : ",");
+                print_json_string((const uint8_t *)known->name, (uint8_t)strlen(known->name));
+                first = false;
+            }
+        }
+        if (!first) {
+            putchar(']');
+        }
+    }
+    printf("}\n");
+}
+
+static double monotonic_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+int main(int argc, char **argv) {
+    uint32_t repeats = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                repeats = (uint32_t)strtoul(optarg, NULL, 10);
+                break;
+            default:
+                fprintf(stderr, "Usage: %s [-n repeats] [payloads.txt...]\n"
+                    "  -n repeats  parse the payloads this many times\n"
+                    "Payloads are read from stdin if no files are given\n", argv[0]);
+                return (opt == 'h') ? 0 : 2;
+        }
+    }
+    if (repeats == 0) {
+        fprintf(stderr, "Usage: %s [-n repeats] [payloads.txt...]\n", argv[0]);
+        return 2;
+    }
+    payload_store store = {0};
+    bool loaded = true;
+    if (optind >= argc) {
+        loaded = load_payloads("stdin", stdin, &store);
+    }
+    for (int i = optind; i < argc && loaded; ++i) {
+        FILE *in = fopen(argv[i], "r");
+        if (in == NULL) {
+            fprintf(stderr, "%s: %s\n", argv[i], strerror(errno));
+            loaded = false;
+            break;
+        }
+        loaded = load_payloads(argv[i], in, &store);
+        fclose(in);
+    }
+    if (!loaded) {
+        free(store.bytes);
+        free(store.lens);
+        return 1;
+    }
+
+    bt_ad_data ad;
+    uint32_t invalid = 0;
+    size_t offset = 0;
+    for (size_t i = 0; i < store.count; ++i) {
+        bool valid = bt_ad_parse(store.bytes + offset, store.lens[i], &ad);
+        if (!valid) {
+            ++invalid;
+        }
+        print_ad(valid, &ad);
+        offset += store.lens[i];
+    }
+    fflush(stdout);
+
+    uint64_t parsed = 0;
+    volatile uint32_t uuids = 0;
+    double start = monotonic_now();
+    for (uint32_t r = 0; r < repeats; ++r) {
+        offset = 0;
+        for (size_t i = 0; i < store.count; ++i) {
+            bt_ad_parse(store.bytes + offset, store.lens[i], &ad);
+            uuids += ad.uuid_count;
+            offset += store.lens[i];
+            ++parsed;
+        }
+    }
+    double elapsed = monotonic_now() - start;
+    fprintf(stderr, "{\"type\":\"stats\",\"payloads\":%zu,\"invalid\":%u,\"skipped\":%u,\"bytes\":%zu,"
+        "\"parsed\":%llu,\"elapsed\":%.6f,\"payloads_per_sec\":%.0f}\n", store.count, invalid, store.skipped,
+        store.len, (unsigned long long)parsed, elapsed, (elapsed > 0) ? (double)parsed / elapsed : 0);
+    free(store.bytes);
+    free(store.lens);
+    return 0;
+}
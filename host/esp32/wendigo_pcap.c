@@ -0,0 +1,302 @@
+/** wendigo-pcap: Replay 802.11 captures through ESP32-Wendigo's WiFi parsers.
+ *
+ * Reads pcap files containing radiotap (or bare 802.11) frames and passes
+ * each frame to wifi_pkt_rcvd(), exactly as the ESP32's promiscuous-mode
+ * callback would, with RSSI and channel taken from the radiotap header.
+ * wifi.c and common.c are the firmware's own sources built against
+ * shim/esp_idf_shim.h, so the device cache and packets are the real thing.
+ *
+ * Whatever ESP32-Wendigo would have sent to Flipper-Wendigo goes to stdout.
+ * It's the same every time for the same capture, so it can be kept as the
+ * known-good result for a regression test, and decoded to see what changed:
+ *
+ *     wendigo-pcap capture.pcap | cmp - capture.uart
+ *     wendigo-pcap capture.pcap | wendigo-decode -
+ *
+ * Frame counts, frames per second and the size of the device cache are
+ * written to stderr as JSON. Captures are loaded into memory before they're
+ * replayed, so the timing covers only the parsers.
+ *
+ *     wendigo-pcap [-i] [-n repeats] capture.pcap...
+ */
+#include "common.h"
+#include "wifi.h"
+
+#include <errno.h>
+#include <getopt.h>
+#include <time.h>
+
+#define PCAP_MAGIC          (0xA1B2C3D4)
+#define PCAP_MAGIC_NSEC     (0xA1B23C4D)
+#define PCAP_HEADER_LEN     (24)
+#define PCAP_RECORD_LEN     (16)
+#define LINKTYPE_IEEE802_11 (105)
+#define LINKTYPE_RADIOTAP   (127)
+/* The parsers read fields at fixed offsets without checking the frame's
+ * length, which the ESP32's receive buffer tolerates. Pad each frame with
+ * zeros so a short frame reads zeros rather than the next frame. */
+#define FRAME_PADDING       (512)
+/* Each stored frame is {uint32_t record length, padding, wifi_promiscuous_pkt_t} */
+#define RECORD_HEADER_LEN   (8)
+/* Radiotap fields up to and including antenna signal: {alignment, size} */
+#define RADIOTAP_TSFT       (0)
+#define RADIOTAP_FLAGS      (1)
+#define RADIOTAP_RATE       (2)
+#define RADIOTAP_CHANNEL    (3)
+#define RADIOTAP_FHSS       (4)
+#define RADIOTAP_DBM_SIGNAL (5)
+#define RADIOTAP_EXT        (31)
+
+static const uint8_t radiotap_align[] = {8, 1, 1, 2, 1, 1};
+static const uint8_t radiotap_size[] = {8, 1, 1, 4, 2, 1};
+
+typedef struct {
+    uint8_t *frames;        /* Each frame is a wifi_promiscuous_pkt_t, padded */
+    size_t len;
+    size_t capacity;
+    uint32_t count;
+    uint32_t skipped;       /* Truncated or not 802.11 */
+} frame_store;
+
+typedef struct {
+    uint64_t frames;
+    uint64_t bytes;
+    uint64_t by_type[WIFI_PKT_MISC + 1];
+} replay_stats;
+
+static uint32_t read_u32(const uint8_t *buf, bool swapped) {
+    uint32_t value = (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) | ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+    return swapped ? __builtin_bswap32(value) : value;
+}
+
+static uint16_t read_le16(const uint8_t *buf) {
+    return (uint16_t)(buf[0] | (buf[1] << 8));
+}
+
+/** Channel number for a frequency in MHz */
+static uint8_t freq_to_channel(uint16_t freq) {
+    if (freq == 2484) {
+        return 14;
+    } else if (freq >= 2412 && freq < 2484) {
+        return (uint8_t)((freq - 2407) / 5);
+    } else if (freq >= 5000 && freq < 6000) {
+        return (uint8_t)((freq - 5000) / 5);
+    }
+    return 0;
+}
+
+/** Parse a radiotap header, returning its length (0 if it's invalid) and
+ * filling in the RSSI and channel if they're present */
+static uint16_t parse_radiotap(const uint8_t *buf, uint32_t len, int8_t *rssi, uint8_t *channel) {
+    if (len < 8 || buf[0] != 0) {
+        return 0;
+    }
+    uint16_t header_len = read_le16(buf + 2);
+    if (header_len > len) {
+        return 0;
+    }
+    uint32_t present = read_u32(buf + 4, false);
+    /* Fields start after the last presence bitmap */
+    uint32_t offset = 8;
+    for (uint32_t word = present; (word & (1u << RADIOTAP_EXT)) != 0; offset += 4) {
+        if (offset + 4 > header_len) {
+            return 0;
+        }
+        word = read_u32(buf + offset, false);
+    }
+    for (uint8_t field = RADIOTAP_TSFT; field <= RADIOTAP_DBM_SIGNAL; ++field) {
+        if ((present & (1u << field)) == 0) {
+            continue;
+        }
+        offset = (offset + radiotap_align[field] - 1) & ~(uint32_t)(radiotap_align[field] - 1);
+        if (offset + radiotap_size[field] > header_len) {
+            break;
+        }
+        if (field == RADIOTAP_CHANNEL) {
+            *channel = freq_to_channel(read_le16(buf + offset));
+        } else if (field == RADIOTAP_DBM_SIGNAL) {
+            *rssi = (int8_t)buf[offset];
+        }
+        offset += radiotap_size[field];
+    }
+    return header_len;
+}
+
+static bool store_frame(frame_store *store, const uint8_t *frame, uint32_t len, int8_t rssi, uint8_t channel) {
+    /* Keep each record aligned for wifi_promiscuous_pkt_t */
+    uint32_t needed = (RECORD_HEADER_LEN + sizeof(wifi_promiscuous_pkt_t) + len + FRAME_PADDING + 7) & ~(uint32_t)7;
+    if (store->len + needed > store->capacity) {
+        size_t capacity = (store->capacity == 0) ? (1 << 20) : store->capacity * 2;
+        while (capacity < store->len + needed) {
+            capacity *= 2;
+        }
+        uint8_t *frames = realloc(store->frames, capacity);
+        if (frames == NULL) {
+            return false;
+        }
+        store->frames = frames;
+        store->capacity = capacity;
+    }
+    uint8_t *record = store->frames + store->len;
+    memset(record, 0, needed);
+    memcpy(record, &needed, sizeof(uint32_t));
+    wifi_promiscuous_pkt_t *pkt = (wifi_promiscuous_pkt_t *)(record + RECORD_HEADER_LEN);
+    pkt->rx_ctrl.rssi = rssi;
+    pkt->rx_ctrl.channel = channel;
+    pkt->rx_ctrl.sig_len = len;
+    memcpy(pkt->payload, frame, len);
+    store->len += needed;
+    ++store->count;
+    return true;
+}
+
+/** Load the 802.11 frames in a pcap file */
+static bool load_pcap(const char *path, frame_store *store) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return false;
+    }
+    uint8_t header[PCAP_HEADER_LEN];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header)) {
+        fprintf(stderr, "%s: Not a pcap file\n", path);
+        fclose(file);
+        return false;
+    }
+    uint32_t magic = read_u32(header, false);
+    bool swapped = (magic == __builtin_bswap32(PCAP_MAGIC) || magic == __builtin_bswap32(PCAP_MAGIC_NSEC));
+    if (!swapped && magic != PCAP_MAGIC && magic != PCAP_MAGIC_NSEC) {
+        fprintf(stderr, "%s: Not a pcap file (pcapng isn't supported)\n", path);
+        fclose(file);
+        return false;
+    }
+    uint32_t linktype = read_u32(header + 20, swapped) & 0xFFFF;
+    if (linktype != LINKTYPE_RADIOTAP && linktype != LINKTYPE_IEEE802_11) {
+        fprintf(stderr, "%s: Link type %u isn't 802.11 or radiotap\n", path, linktype);
+        fclose(file);
+        return false;
+    }
+    uint8_t record[PCAP_RECORD_LEN];
+    uint8_t *data = NULL;
+    uint32_t data_capacity = 0;
+    bool ok = true;
+    while (ok && fread(record, 1, sizeof(record), file) == sizeof(record)) {
+        uint32_t caplen = read_u32(record + 8, swapped);
+        if (caplen > data_capacity) {
+            uint8_t *grown = realloc(data, caplen);
+            if (grown == NULL) {
+                ok = false;
+                break;
+            }
+            data = grown;
+            data_capacity = caplen;
+        }
+        if (fread(data, 1, caplen, file) != caplen) {
+            ++store->skipped; /* Truncated capture */
+            break;
+        }
+        int8_t rssi = 0;
+        uint8_t channel = 0;
+        uint32_t offset = 0;
+        if (linktype == LINKTYPE_RADIOTAP) {
+            offset = parse_radiotap(data, caplen, &rssi, &channel);
+        }
+        /* Frame control, duration and at least one address */
+        if ((linktype == LINKTYPE_RADIOTAP && offset == 0) || caplen - offset < 10) {
+            ++store->skipped;
+            continue;
+        }
+        ok = store_frame(store, data + offset, caplen - offset, rssi, channel);
+    }
+    free(data);
+    fclose(file);
+    if (!ok) {
+        fprintf(stderr, "%s: Out of memory\n", path);
+    }
+    return ok;
+}
+
+static void replay(const frame_store *store, replay_stats *stats) {
+    for (size_t offset = 0; offset < store->len;) {
+        uint32_t record_len;
+        memcpy(&record_len, store->frames + offset, sizeof(uint32_t));
+        wifi_promiscuous_pkt_t *pkt = (wifi_promiscuous_pkt_t *)(store->frames + offset + RECORD_HEADER_LEN);
+        /* Frame control type bits are management, control or data */
+        wifi_promiscuous_pkt_type_t type = (wifi_promiscuous_pkt_type_t)((pkt->payload[0] >> 2) & 0x03);
+        wifi_pkt_rcvd(pkt, type);
+        ++stats->frames;
+        ++stats->by_type[type];
+        stats->bytes += pkt->rx_ctrl.sig_len;
+        offset += record_len;
+    }
+}
+
+static double monotonic_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+int main(int argc, char **argv) {
+    uint32_t repeats = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "in:h")) != -1) {
+        switch (opt) {
+            case 'i':
+                scanStatus[SCAN_INTERACTIVE] = ACTION_ENABLE;
+                break;
+            case 'n':
+                repeats = (uint32_t)strtoul(optarg, NULL, 10);
+                break;
+            default:
+                fprintf(stderr, "Usage: %s [-i] [-n repeats] capture.pcap...\n"
+                    "  -i          Interactive Mode output instead of Flipper-Wendigo packets\n"
+                    "  -n repeats  replay the captures this many times\n", argv[0]);
+                return (opt == 'h') ? 0 : 2;
+        }
+    }
+    if (optind >= argc || repeats == 0) {
+        fprintf(stderr, "Usage: %s [-i] [-n repeats] capture.pcap...\n", argv[0]);
+        return 2;
+    }
+    frame_store store = {0};
+    for (int i = optind; i < argc; ++i) {
+        if (!load_pcap(argv[i], &store)) {
+            free(store.frames);
+            return 1;
+        }
+    }
+
+    /* What ESP32-Wendigo does before it enables WiFi */
+    uartMutex = xSemaphoreCreateMutex();
+    wendigo_wifi_enable();
+    replay_stats stats = {0};
+    double start = monotonic_now();
+    for (uint32_t i = 0; i < repeats; ++i) {
+        replay(&store, &stats);
+    }
+    double elapsed = monotonic_now() - start;
+    fflush(stdout);
+
+    uint16_t aps = 0;
+    uint16_t stas = 0;
+    for (uint16_t i = 0; i < devices_count; ++i) {
+        if (devices[i].scanType == SCAN_WIFI_AP) {
+            ++aps;
+        } else if (devices[i].scanType == SCAN_WIFI_STA) {
+            ++stas;
+        }
+    }
+    fprintf(stderr, "{\"type\":\"stats\",\"frames\":%llu,\"management\":%llu,\"control\":%llu,\"data\":%llu,"
+        "\"skipped\":%u,\"bytes\":%llu,\"elapsed\":%.6f,\"frames_per_sec\":%.0f,\"devices\":%u,\"aps\":%u,"
+        "\"stations\":%u}\n", (unsigned long long)stats.frames, (unsigned long long)stats.by_type[WIFI_PKT_MGMT],
+        (unsigned long long)stats.by_type[WIFI_PKT_CTRL], (unsigned long long)stats.by_type[WIFI_PKT_DATA],
+        store.skipped, (unsigned long long)stats.bytes, elapsed, (elapsed > 0) ? (double)stats.frames / elapsed : 0,
+        devices_count, aps, stas);
+    for (uint16_t i = 0; i < devices_count; ++i) {
+        free_device(&devices[i]);
+    }
+    free(devices);
+    free(store.frames);
+    return 0;
+}
@@ -0,0 +1,160 @@
+/** wendigo-scan-policy: Run a sequence of BLE scan cycles through
+ * ESP32-Wendigo's adaptive scan policy.
+ *
+ * Reads one scan cycle per line - Its length in milliseconds, then the
+ * number of advertisements, advertisements from scannable devices, of those
+ * the number from devices with no cached scan response, and new devices,
+ * separated by spaces. Anything after a '#' is ignored. For each cycle the
+ * setting ble_scan_policy_update() chooses for the next one is written to
+ * stdout as a line of JSON. The policy depends on nothing but its input, so
+ * the output can be kept as the known-good result for a regression test:
+ *
+ *     wendigo-scan-policy cycles.txt | cmp - cycles.json
+ *
+ * A cycle count and cycles per second are written to stderr as JSON. With
+ * -n the cycles are run that many times, but only reported once.
+ *
+ *     wendigo-scan-policy [-n repeats] [cycles.txt...]
+ */
+#include "ble_scan_policy.h"
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+    ble_scan_cycle *cycles;
+    size_t count;
+    size_t capacity;
+    uint32_t skipped;       /* Lines that weren't a scan cycle */
+} cycle_store;
+
+static bool store_cycle(cycle_store *store, const ble_scan_cycle *cycle) {
+    if (store->count == store->capacity) {
+        size_t capacity = (store->capacity == 0) ? 64 : store->capacity * 2;
+        ble_scan_cycle *cycles = realloc(store->cycles, sizeof(ble_scan_cycle) * capacity);
+        if (cycles == NULL) {
+            return false;
+        }
+        store->cycles = cycles;
+        store->capacity = capacity;
+    }
+    store->cycles[store->count++] = *cycle;
+    return true;
+}
+
+static bool load_cycles(const char *path, FILE *in, cycle_store *store) {
+    char line[256];
+    uint32_t line_num = 0;
+    while (fgets(line, sizeof(line), in) != NULL) {
+        ++line_num;
+        char *comment = strchr(line, '#');
+        if (comment != NULL) {
+            *comment = '\0';
+        }
+        ble_scan_cycle cycle;
+        char extra;
+        int fields = sscanf(line, "%u %u %u %u %u %c", &cycle.elapsed_ms, &cycle.adverts,
+            &cycle.scannable, &cycle.uncached, &cycle.new_devices, &extra);
+        if (fields == EOF) {
+            continue;
+        }
+        if (fields != 5) {
+            fprintf(stderr, "%s:%u: Not a scan cycle\n", path, line_num);
+            ++store->skipped;
+        } else if (!store_cycle(store, &cycle)) {
+            fprintf(stderr, "%s: Out of memory\n", path);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void print_policy(const ble_scan_policy *policy, bool changed) {
+    ble_scan_setting setting;
+    ble_scan_policy_setting(policy, &setting);
+    printf("{\"changed\":%s,\"active\":%s,\"interval\":%u,\"window\":%u,\"duty\":%u,"
+        "\"advert_rate\":%u,\"new_rate\":%u}\n", changed ? "true" : "false", setting.active ? "true" : "false",
+        setting.interval, setting.window, ble_scan_policy_duty_percent(policy), policy->advert_rate,
+        policy->new_rate);
+}
+
+static double monotonic_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+int main(int argc, char **argv) {
+    uint32_t repeats = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                repeats = (uint32_t)strtoul(optarg, NULL, 10);
+                break;
+            default:
+                fprintf(stderr, "Usage: %s [-n repeats] [cycles.txt...]\n"
+                    "  -n repeats  run the cycles this many times\n"
+                    "Each line is a scan cycle: elapsed_ms adverts scannable uncached new_devices\n"
+                    "Cycles are read from stdin if no files are given\n", argv[0]);
+                return (opt == 'h') ? 0 : 2;
+        }
+    }
+    if (repeats == 0) {
+        fprintf(stderr, "Usage: %s [-n repeats] [cycles.txt...]\n", argv[0]);
+        return 2;
+    }
+    cycle_store store = {0};
+    bool loaded = true;
+    if (optind >= argc) {
+        loaded = load_cycles("stdin", stdin, &store);
+    }
+    for (int i = optind; i < argc && loaded; ++i) {
+        FILE *in = fopen(argv[i], "r");
+        if (in == NULL) {
+            fprintf(stderr, "%s: %s\n", argv[i], strerror(errno));
+            loaded = false;
+            break;
+        }
+        loaded = load_cycles(argv[i], in, &store);
+        fclose(in);
+    }
+    if (!loaded) {
+        free(store.cycles);
+        return 1;
+    }
+
+    ble_scan_policy policy;
+    ble_scan_policy_init(&policy);
+    uint32_t changes = 0;
+    for (size_t i = 0; i < store.count; ++i) {
+        bool changed = ble_scan_policy_update(&policy, &(store.cycles[i]));
+        if (changed) {
+            ++changes;
+        }
+        print_policy(&policy, changed);
+    }
+    fflush(stdout);
+
+    uint64_t updated = 0;
+    volatile uint32_t level = 0;
+    double start = monotonic_now();
+    for (uint32_t r = 0; r < repeats; ++r) {
+        ble_scan_policy_init(&policy);
+        for (size_t i = 0; i < store.count; ++i) {
+            ble_scan_policy_update(&policy, &(store.cycles[i]));
+            level += policy.level;
+            ++updated;
+        }
+    }
+    double elapsed = monotonic_now() - start;
+    fprintf(stderr, "{\"type\":\"stats\",\"cycles\":%zu,\"skipped\":%u,\"changes\":%u,\"updated\":%llu,"
+        "\"elapsed\":%.6f,\"cycles_per_sec\":%.0f}\n", store.count, store.skipped, changes,
+        (unsigned long long)updated, elapsed, (elapsed > 0) ? (double)updated / elapsed : 0);
+    free(store.cycles);
+    return 0;
+}
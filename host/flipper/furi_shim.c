@@ -0,0 +1,470 @@
+/** Host implementations of the Flipper SDK functions declared in
+ * shim/furi_shim.h.
+ *
+ * There's no scheduler on the host: timers never fire and records are
+ * placeholders. Mutexes are real, so a mutex acquired twice by the same
+ * thread is reported rather than deadlocking. Storage paths are mapped into
+ * a directory on the host - /data/x and /ext/x both become <root>/x.
+ */
+#define _GNU_SOURCE
+#include "furi_shim.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+/* The allocator below needs the real thing - Everything else uses
+   furi_shim_malloc() so it's accounted for */
+#undef malloc
+#undef calloc
+#undef realloc
+#undef free
+
+/* Reported as the free heap when the heap is unlimited - Large enough that
+   nothing is ever pruned, small enough not to overflow the arithmetic
+   callers do with it */
+#define FURI_SHIM_UNLIMITED_HEAP ((size_t)1 << 30)
+
+static FuriLogLevel log_level = FuriLogLevelInfo;
+
+void furi_log_set_level(FuriLogLevel level) {
+    log_level = (level == FuriLogLevelDefault) ? FuriLogLevelInfo : level;
+}
+
+FuriLogLevel furi_log_get_level(void) {
+    return log_level;
+}
+
+void furi_log_print_format(FuriLogLevel level, const char *tag, const char *format, ...) {
+    static const char level_chars[] = "??EWIDT";
+    if (level > log_level) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    fprintf(stderr, "%lu [%c][%s] ", (unsigned long)furi_get_tick(), level_chars[level], tag);
+    vfprintf(stderr, format, args);
+    fputc('\n', stderr);
+    va_end(args);
+}
+
+/** Milliseconds since the first call, like the Flipper's 1 kHz tick */
+uint32_t furi_get_tick(void) {
+    static struct timespec start;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    if (start.tv_sec == 0 && start.tv_nsec == 0) {
+        start = ts;
+    }
+    return (uint32_t)(((ts.tv_sec - start.tv_sec) * 1000) + ((ts.tv_nsec - start.tv_nsec) / 1000000));
+}
+
+uint32_t furi_ms_to_ticks(uint32_t milliseconds) {
+    return milliseconds;
+}
+
+void furi_delay_ms(uint32_t milliseconds) {
+    usleep(milliseconds * 1000);
+}
+
+uint32_t furi_hal_rtc_get_timestamp(void) {
+    return (uint32_t)time(NULL);
+}
+
+struct FuriMutex {
+    pthread_mutex_t mutex;
+};
+
+FuriMutex *furi_mutex_alloc(FuriMutexType type) {
+    FuriMutex *instance = furi_shim_malloc(sizeof(FuriMutex));
+    if (instance == NULL) {
+        return NULL;
+    }
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, (type == FuriMutexTypeRecursive) ?
+        PTHREAD_MUTEX_RECURSIVE : PTHREAD_MUTEX_ERRORCHECK);
+    pthread_mutex_init(&instance->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    return instance;
+}
+
+void furi_mutex_free(FuriMutex *instance) {
+    if (instance != NULL) {
+        pthread_mutex_destroy(&instance->mutex);
+        furi_shim_free(instance);
+    }
+}
+
+FuriStatus furi_mutex_acquire(FuriMutex *instance, uint32_t timeout) {
+    if (instance == NULL) {
+        return FuriStatusErrorParameter;
+    }
+    int result;
+    if (timeout == FuriWaitForever) {
+        result = pthread_mutex_lock(&instance->mutex);
+    } else if (timeout == 0) {
+        result = pthread_mutex_trylock(&instance->mutex);
+    } else {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += timeout / 1000;
+        deadline.tv_nsec += (long)(timeout % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+            ++deadline.tv_sec;
+            deadline.tv_nsec -= 1000000000;
+        }
+        result = pthread_mutex_timedlock(&instance->mutex, &deadline);
+    }
+    if (result == EDEADLK) {
+        /* A FreeRTOS mutex would deadlock here */
+        fprintf(stderr, "furi_mutex_acquire(): Mutex is already held by this thread\n");
+        return FuriStatusErrorResource;
+    }
+    return (result == 0) ? FuriStatusOk : (result == EBUSY || result == ETIMEDOUT) ?
+        FuriStatusErrorTimeout : FuriStatusError;
+}
+
+FuriStatus furi_mutex_release(FuriMutex *instance) {
+    if (instance == NULL) {
+        return FuriStatusErrorParameter;
+    }
+    return (pthread_mutex_unlock(&instance->mutex) == 0) ? FuriStatusOk : FuriStatusErrorResource;
+}
+
+struct FuriTimer {
+    FuriTimerCallback func;
+    void *context;
+    bool running;
+};
+
+FuriTimer *furi_timer_alloc(FuriTimerCallback func, FuriTimerType type, void *context) {
+    UNUSED(type);
+    FuriTimer *instance = furi_shim_malloc(sizeof(FuriTimer));
+    if (instance != NULL) {
+        instance->func = func;
+        instance->context = context;
+        instance->running = false;
+    }
+    return instance;
+}
+
+void furi_timer_free(FuriTimer *instance) {
+    furi_shim_free(instance);
+}
+
+FuriStatus furi_timer_start(FuriTimer *instance, uint32_t ticks) {
+    UNUSED(ticks);
+    instance->running = true;
+    return FuriStatusOk;
+}
+
+FuriStatus furi_timer_stop(FuriTimer *instance) {
+    instance->running = false;
+    return FuriStatusOk;
+}
+
+uint32_t furi_timer_is_running(FuriTimer *instance) {
+    return instance->running ? 1 : 0;
+}
+
+/** Records are only used to open storage, which doesn't need any state */
+void *furi_record_open(const char *name) {
+    static char record;
+    UNUSED(name);
+    return &record;
+}
+
+void furi_record_close(const char *name) {
+    UNUSED(name);
+}
+
+void view_dispatcher_send_custom_event(ViewDispatcher *view_dispatcher, uint32_t event) {
+    UNUSED(view_dispatcher);
+    UNUSED(event);
+}
+
+/* Every allocation is preceded by its size, padded to keep the allocation
+   suitably aligned */
+typedef union {
+    size_t size;
+    max_align_t align;
+} heap_header;
+
+static FuriShimHeapStats heap;
+static pthread_mutex_t heap_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/** Account for an allocation changing size from `old_size` to `new_size`,
+ * returning false if the heap doesn't have room for it */
+static bool heap_account(size_t old_size, size_t new_size) {
+    bool ok = true;
+    pthread_mutex_lock(&heap_mutex);
+    if (new_size > old_size && heap.heap_size > 0 &&
+            heap.allocated + (new_size - old_size) > heap.heap_size) {
+        ++heap.failures;
+        ok = false;
+    } else {
+        heap.allocated = heap.allocated - old_size + new_size;
+        if (heap.allocated > heap.peak) {
+            heap.peak = heap.allocated;
+        }
+        if (new_size > 0) {
+            ++heap.allocations;
+        }
+    }
+    pthread_mutex_unlock(&heap_mutex);
+    return ok;
+}
+
+void *furi_shim_malloc(size_t size) {
+    if (!heap_account(0, size)) {
+        return NULL;
+    }
+    heap_header *header = malloc(sizeof(heap_header) + size);
+    if (header == NULL) {
+        heap_account(size, 0);
+        return NULL;
+    }
+    header->size = size;
+    return header + 1;
+}
+
+void *furi_shim_calloc(size_t count, size_t size) {
+    if (size > 0 && count > SIZE_MAX / size) {
+        return NULL;
+    }
+    void *ptr = furi_shim_malloc(count * size);
+    if (ptr != NULL) {
+        memset(ptr, 0, count * size);
+    }
+    return ptr;
+}
+
+void *furi_shim_realloc(void *ptr, size_t size) {
+    if (ptr == NULL) {
+        return furi_shim_malloc(size);
+    }
+    heap_header *header = (heap_header *)ptr - 1;
+    size_t old_size = header->size;
+    if (!heap_account(old_size, size)) {
+        return NULL;
+    }
+    heap_header *new_header = realloc(header, sizeof(heap_header) + size);
+    if (new_header == NULL) {
+        heap_account(size, old_size);
+        return NULL;
+    }
+    new_header->size = size;
+    return new_header + 1;
+}
+
+void furi_shim_free(void *ptr) {
+    if (ptr == NULL) {
+        return;
+    }
+    heap_header *header = (heap_header *)ptr - 1;
+    heap_account(header->size, 0);
+    free(header);
+}
+
+void furi_shim_heap_set_size(size_t heap_size) {
+    pthread_mutex_lock(&heap_mutex);
+    heap.heap_size = heap_size;
+    pthread_mutex_unlock(&heap_mutex);
+}
+
+void furi_shim_heap_reset_peak(void) {
+    pthread_mutex_lock(&heap_mutex);
+    heap.peak = heap.allocated;
+    pthread_mutex_unlock(&heap_mutex);
+}
+
+void furi_shim_heap_get_stats(FuriShimHeapStats *stats) {
+    pthread_mutex_lock(&heap_mutex);
+    *stats = heap;
+    pthread_mutex_unlock(&heap_mutex);
+}
+
+size_t memmgr_get_free_heap(void) {
+    FuriShimHeapStats stats;
+    furi_shim_heap_get_stats(&stats);
+    if (stats.heap_size == 0) {
+        return FURI_SHIM_UNLIMITED_HEAP;
+    }
+    return (stats.allocated < stats.heap_size) ? stats.heap_size - stats.allocated : 0;
+}
+
+size_t memmgr_get_total_heap(void) {
+    return (heap.heap_size == 0) ? FURI_SHIM_UNLIMITED_HEAP : heap.heap_size;
+}
+
+size_t memmgr_get_minimum_free_heap(void) {
+    FuriShimHeapStats stats;
+    furi_shim_heap_get_stats(&stats);
+    if (stats.heap_size == 0) {
+        return FURI_SHIM_UNLIMITED_HEAP;
+    }
+    return (stats.peak < stats.heap_size) ? stats.heap_size - stats.peak : 0;
+}
+
+/** The host heap doesn't fragment, so the largest free block is all of it */
+size_t memmgr_heap_get_max_free_block(void) {
+    return memmgr_get_free_heap();
+}
+
+struct File {
+    int fd;
+    FS_Error error;
+};
+
+static char storage_root[256] = ".";
+
+void furi_shim_storage_set_root(const char *root) {
+    snprintf(storage_root, sizeof(storage_root), "%s", root);
+}
+
+/** Map a Flipper path into storage_root */
+static void storage_host_path(const char *path, char *result, size_t result_len) {
+    const char *name = path;
+    if (!strncmp(path, STORAGE_APP_DATA_PATH_PREFIX "/", strlen(STORAGE_APP_DATA_PATH_PREFIX "/"))) {
+        name = path + strlen(STORAGE_APP_DATA_PATH_PREFIX "/");
+    } else if (!strncmp(path, STORAGE_EXT_PATH_PREFIX "/", strlen(STORAGE_EXT_PATH_PREFIX "/"))) {
+        name = path + strlen(STORAGE_EXT_PATH_PREFIX "/");
+    }
+    snprintf(result, result_len, "%s/%s", storage_root, name);
+}
+
+static FS_Error storage_error_from_errno(int error) {
+    switch (error) {
+        case ENOENT:
+            return FSE_NOT_EXIST;
+        case EEXIST:
+            return FSE_EXIST;
+        case EACCES:
+        case EPERM:
+            return FSE_DENIED;
+        case EINVAL:
+            return FSE_INVALID_PARAMETER;
+        case ENAMETOOLONG:
+            return FSE_INVALID_NAME;
+        default:
+            return FSE_INTERNAL;
+    }
+}
+
+File *storage_file_alloc(Storage *storage) {
+    UNUSED(storage);
+    File *file = furi_shim_malloc(sizeof(File));
+    if (file != NULL) {
+        file->fd = -1;
+        file->error = FSE_OK;
+    }
+    return file;
+}
+
+void storage_file_free(File *file) {
+    if (file != NULL) {
+        storage_file_close(file);
+        furi_shim_free(file);
+    }
+}
+
+bool storage_file_open(File *file, const char *path, FS_AccessMode access_mode, FS_OpenMode open_mode) {
+    char host_path[512];
+    storage_host_path(path, host_path, sizeof(host_path));
+    int flags = (access_mode == FSAM_READ_WRITE) ? O_RDWR : (access_mode == FSAM_WRITE) ? O_WRONLY : O_RDONLY;
+    switch (open_mode) {
+        case FSOM_OPEN_ALWAYS:
+            flags |= O_CREAT;
+            break;
+        case FSOM_OPEN_APPEND:
+            flags |= O_CREAT | O_APPEND;
+            break;
+        case FSOM_CREATE_NEW:
+            flags |= O_CREAT | O_EXCL;
+            break;
+        case FSOM_CREATE_ALWAYS:
+            flags |= O_CREAT | O_TRUNC;
+            break;
+        default:
+            break;
+    }
+    file->fd = open(host_path, flags, 0644);
+    file->error = (file->fd < 0) ? storage_error_from_errno(errno) : FSE_OK;
+    return file->fd >= 0;
+}
+
+bool storage_file_close(File *file) {
+    if (file->fd < 0) {
+        return false;
+    }
+    close(file->fd);
+    file->fd = -1;
+    return true;
+}
+
+bool storage_file_is_open(File *file) {
+    return file->fd >= 0;
+}
+
+size_t storage_file_read(File *file, void *buff, size_t bytes_to_read) {
+    ssize_t result = read(file->fd, buff, bytes_to_read);
+    file->error = (result < 0) ? storage_error_from_errno(errno) : FSE_OK;
+    return (result < 0) ? 0 : (size_t)result;
+}
+
+size_t storage_file_write(File *file, const void *buff, size_t bytes_to_write) {
+    ssize_t result = write(file->fd, buff, bytes_to_write);
+    file->error = (result < 0) ? storage_error_from_errno(errno) : FSE_OK;
+    return (result < 0) ? 0 : (size_t)result;
+}
+
+bool storage_file_seek(File *file, uint32_t offset, bool from_start) {
+    off_t result = lseek(file->fd, offset, from_start ? SEEK_SET : SEEK_CUR);
+    file->error = (result < 0) ? storage_error_from_errno(errno) : FSE_OK;
+    return result >= 0;
+}
+
+uint64_t storage_file_tell(File *file) {
+    off_t result = lseek(file->fd, 0, SEEK_CUR);
+    return (result < 0) ? 0 : (uint64_t)result;
+}
+
+uint64_t storage_file_size(File *file) {
+    struct stat st;
+    return (fstat(file->fd, &st) == 0) ? (uint64_t)st.st_size : 0;
+}
+
+bool storage_file_sync(File *file) {
+    return fsync(file->fd) == 0;
+}
+
+FS_Error storage_file_get_error(File *file) {
+    return file->error;
+}
+
+const char *storage_file_get_error_desc(File *file) {
+    static const char *const descriptions[] = {
+        "OK", "filesystem not ready", "file/dir already exist", "file/dir not exist",
+        "invalid parameter", "access denied", "invalid name/path", "internal error",
+        "function not implemented", "file is already open",
+    };
+    return (file->error < COUNT_OF(descriptions)) ? descriptions[file->error] : "unknown error";
+}
+
+bool storage_simply_remove(Storage *storage, const char *path) {
+    UNUSED(storage);
+    char host_path[512];
+    storage_host_path(path, host_path, sizeof(host_path));
+    return unlink(host_path) == 0 || errno == ENOENT;
+}
+
+bool storage_simply_mkdir(Storage *storage, const char *path) {
+    UNUSED(storage);
+    char host_path[512];
+    storage_host_path(path, host_path, sizeof(host_path));
+    return mkdir(host_path, 0755) == 0 || errno == EEXIST;
+}
@@ -0,0 +1,2 @@
+#pragma once
+#include "furi_shim.h"
@@ -0,0 +1,222 @@
+/** Just enough of the Flipper SDK to build Flipper-Wendigo's packet parsing
+ * and device cache on a Linux host.
+ *
+ * Mutexes are pthread mutexes, logging goes to stderr, and the RTC is the
+ * host clock. Flipper's malloc() is the furi heap, so malloc() and friends
+ * are redirected to an allocator in furi_shim.c that keeps track of how much
+ * is allocated and can be limited to the size of a Flipper's heap - That way
+ * memmgr_get_free_heap() means what it does on a Flipper and pruning kicks in
+ * when it would on the device. GUI types are opaque; the scenes that use them
+ * aren't built.
+ */
+#pragma once
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+/* furi/core/common_defines.h */
+#define UNUSED(x)       (void)(x)
+#define COUNT_OF(x)     (sizeof(x) / sizeof(x[0]))
+#ifndef MIN
+#define MIN(a, b)       ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b)       ((a) > (b) ? (a) : (b))
+#endif
+#define furi_assert(x)  do { if (!(x)) { fprintf(stderr, "furi_assert failed: %s at %s:%d\n", #x, \
+                            __FILE__, __LINE__); abort(); } } while (0)
+#define furi_check(x)   furi_assert(x)
+
+/* furi/core/base.h */
+typedef enum {
+    FuriWaitForever = 0xFFFFFFFFU,
+} FuriWait;
+
+typedef enum {
+    FuriFlagWaitAny = 0x00000000U,
+    FuriFlagWaitAll = 0x00000001U,
+    FuriFlagNoClear = 0x00000002U,
+    FuriFlagError = 0x80000000U,
+} FuriFlag;
+
+typedef enum {
+    FuriStatusOk = 0,
+    FuriStatusError = -1,
+    FuriStatusErrorTimeout = -2,
+    FuriStatusErrorResource = -3,
+    FuriStatusErrorParameter = -4,
+    FuriStatusErrorNoMemory = -5,
+    FuriStatusErrorISR = -6,
+    FuriStatusReserved = 0x7FFFFFFF,
+} FuriStatus;
+
+/* furi/core/log.h */
+typedef enum {
+    FuriLogLevelDefault = 0,
+    FuriLogLevelNone = 1,
+    FuriLogLevelError = 2,
+    FuriLogLevelWarn = 3,
+    FuriLogLevelInfo = 4,
+    FuriLogLevelDebug = 5,
+    FuriLogLevelTrace = 6,
+} FuriLogLevel;
+void furi_log_print_format(FuriLogLevel level, const char *tag, const char *format, ...)
+    __attribute__((__format__(__printf__, 3, 4)));
+void furi_log_set_level(FuriLogLevel level);
+FuriLogLevel furi_log_get_level(void);
+#define FURI_LOG_E(tag, format, ...) furi_log_print_format(FuriLogLevelError, tag, format, ##__VA_ARGS__)
+#define FURI_LOG_W(tag, format, ...) furi_log_print_format(FuriLogLevelWarn, tag, format, ##__VA_ARGS__)
+#define FURI_LOG_I(tag, format, ...) furi_log_print_format(FuriLogLevelInfo, tag, format, ##__VA_ARGS__)
+#define FURI_LOG_D(tag, format, ...) furi_log_print_format(FuriLogLevelDebug, tag, format, ##__VA_ARGS__)
+#define FURI_LOG_T(tag, format, ...) furi_log_print_format(FuriLogLevelTrace, tag, format, ##__VA_ARGS__)
+
+/* furi/core/kernel.h */
+uint32_t furi_get_tick(void);
+uint32_t furi_ms_to_ticks(uint32_t milliseconds);
+void furi_delay_ms(uint32_t milliseconds);
+
+/* furi/core/mutex.h */
+typedef enum {
+    FuriMutexTypeNormal,
+    FuriMutexTypeRecursive,
+} FuriMutexType;
+typedef struct FuriMutex FuriMutex;
+FuriMutex *furi_mutex_alloc(FuriMutexType type);
+void furi_mutex_free(FuriMutex *instance);
+FuriStatus furi_mutex_acquire(FuriMutex *instance, uint32_t timeout);
+FuriStatus furi_mutex_release(FuriMutex *instance);
+
+/* furi/core/timer.h - Timers never fire on the host */
+typedef enum {
+    FuriTimerTypeOnce = 0,
+    FuriTimerTypePeriodic = 1,
+} FuriTimerType;
+typedef void (*FuriTimerCallback)(void *context);
+typedef struct FuriTimer FuriTimer;
+FuriTimer *furi_timer_alloc(FuriTimerCallback func, FuriTimerType type, void *context);
+void furi_timer_free(FuriTimer *instance);
+FuriStatus furi_timer_start(FuriTimer *instance, uint32_t ticks);
+FuriStatus furi_timer_stop(FuriTimer *instance);
+uint32_t furi_timer_is_running(FuriTimer *instance);
+
+/* furi/core/record.h */
+void *furi_record_open(const char *name);
+void furi_record_close(const char *name);
+
+/* furi/core/string.h */
+typedef struct FuriString FuriString;
+
+/* furi/core/memmgr.h and memmgr_heap.h */
+size_t memmgr_get_free_heap(void);
+size_t memmgr_get_total_heap(void);
+size_t memmgr_get_minimum_free_heap(void);
+size_t memmgr_heap_get_max_free_block(void);
+
+/* The host's heap - Allocation goes through these, so the shim can account
+   for it. A heap size of 0 means unlimited */
+typedef struct {
+    size_t heap_size;       /* Simulated heap size, or 0 if unlimited */
+    size_t allocated;       /* Bytes currently allocated */
+    size_t peak;            /* Most bytes allocated at once */
+    uint64_t allocations;   /* Calls to malloc(), calloc() and realloc() */
+    uint64_t failures;      /* Allocations refused because the heap was full */
+} FuriShimHeapStats;
+void *furi_shim_malloc(size_t size);
+void *furi_shim_calloc(size_t count, size_t size);
+void *furi_shim_realloc(void *ptr, size_t size);
+void furi_shim_free(void *ptr);
+void furi_shim_heap_set_size(size_t heap_size);
+void furi_shim_heap_reset_peak(void);
+void furi_shim_heap_get_stats(FuriShimHeapStats *stats);
+#define malloc(size)        furi_shim_malloc(size)
+#define calloc(count, size) furi_shim_calloc(count, size)
+#define realloc(ptr, size)  furi_shim_realloc(ptr, size)
+#define free(ptr)           furi_shim_free(ptr)
+
+/* furi_hal_rtc.h */
+uint32_t furi_hal_rtc_get_timestamp(void);
+
+/* gui/ - Only ever passed around, never used */
+typedef struct Gui Gui;
+typedef struct View View;
+typedef struct ViewDispatcher ViewDispatcher;
+typedef struct SceneManager SceneManager;
+typedef struct TextBox TextBox;
+typedef struct Widget Widget;
+typedef struct VariableItemList VariableItemList;
+typedef struct VariableItem VariableItem;
+typedef struct TextInput TextInput;
+typedef struct ByteInput ByteInput;
+typedef struct Popup Popup;
+typedef struct {
+    bool (*const *on_event_handlers)(void *context, uint32_t event);
+    void (*const *on_enter_handlers)(void *context);
+    void (*const *on_exit_handlers)(void *context);
+    const uint32_t scene_num;
+} SceneManagerHandlers;
+typedef enum {
+    SceneManagerEventTypeCustom,
+    SceneManagerEventTypeBack,
+    SceneManagerEventTypeTick,
+} SceneManagerEventType;
+typedef struct {
+    SceneManagerEventType type;
+    uint32_t event;
+} SceneManagerEvent;
+void view_dispatcher_send_custom_event(ViewDispatcher *view_dispatcher, uint32_t event);
+
+/* storage/storage.h - Files live in a directory on the host, set with
+   furi_shim_storage_set_root() */
+typedef struct Storage Storage;
+typedef struct File File;
+typedef enum {
+    FSAM_READ = (1 << 0),
+    FSAM_WRITE = (1 << 1),
+    FSAM_READ_WRITE = FSAM_READ | FSAM_WRITE,
+} FS_AccessMode;
+typedef enum {
+    FSOM_OPEN_EXISTING = 1,
+    FSOM_OPEN_ALWAYS = 2,
+    FSOM_OPEN_APPEND = 4,
+    FSOM_CREATE_NEW = 8,
+    FSOM_CREATE_ALWAYS = 16,
+} FS_OpenMode;
+typedef enum {
+    FSE_OK,
+    FSE_NOT_READY,
+    FSE_EXIST,
+    FSE_NOT_EXIST,
+    FSE_INVALID_PARAMETER,
+    FSE_DENIED,
+    FSE_INVALID_NAME,
+    FSE_INTERNAL,
+    FSE_NOT_IMPLEMENTED,
+    FSE_ALREADY_OPEN,
+} FS_Error;
+#define RECORD_STORAGE      "storage"
+#define STORAGE_APP_DATA_PATH_PREFIX "/data"
+#define STORAGE_EXT_PATH_PREFIX "/ext"
+#define APP_DATA_PATH(path) STORAGE_APP_DATA_PATH_PREFIX "/" path
+#define EXT_PATH(path)      STORAGE_EXT_PATH_PREFIX "/" path
+File *storage_file_alloc(Storage *storage);
+void storage_file_free(File *file);
+bool storage_file_open(File *file, const char *path, FS_AccessMode access_mode, FS_OpenMode open_mode);
+bool storage_file_close(File *file);
+bool storage_file_is_open(File *file);
+size_t storage_file_read(File *file, void *buff, size_t bytes_to_read);
+size_t storage_file_write(File *file, const void *buff, size_t bytes_to_write);
+bool storage_file_seek(File *file, uint32_t offset, bool from_start);
+uint64_t storage_file_tell(File *file);
+uint64_t storage_file_size(File *file);
+bool storage_file_sync(File *file);
+FS_Error storage_file_get_error(File *file);
+const char *storage_file_get_error_desc(File *file);
+bool storage_simply_remove(Storage *storage, const char *path);
+bool storage_simply_mkdir(Storage *storage, const char *path);
+void furi_shim_storage_set_root(const char *root);
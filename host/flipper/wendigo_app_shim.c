@@ -0,0 +1,95 @@
+/** Stand-ins for the parts of Flipper-Wendigo that wendigo_scan.c and friends
+ * call but which aren't built on the host - wendigo_app.c, the UART and the
+ * scenes. There is no UI, so the scenes have nothing to update; nothing is
+ * ever displayed, so the scenes never hold a device.
+ */
+#include "wendigo_app_i.h"
+#include "wendigo_scan.h"
+
+void wendigo_display_popup(WendigoApp *app, char *header, char *body) {
+    UNUSED(app);
+    FURI_LOG_I(WENDIGO_TAG, "Popup: %s: %s", header, body);
+}
+
+void wendigo_uart_tx(Wendigo_Uart *uart, uint8_t *data, size_t len) {
+    UNUSED(uart);
+    UNUSED(data);
+    UNUSED(len);
+}
+
+void wendigo_uart_set_binary_cb(Wendigo_Uart *uart) {
+    UNUSED(uart);
+}
+
+void wendigo_mac_rcvd_callback(WendigoApp *app) {
+    UNUSED(app);
+}
+
+/* As wendigo_app.c */
+void bytes_to_string(uint8_t *bytes, uint16_t bytesCount, char *strBytes) {
+    const char *hex = "0123456789ABCDEF";
+    char *p_out = strBytes;
+    for (uint8_t *p_in = bytes; p_in < bytes + bytesCount; p_out += 3, ++p_in) {
+        p_out[0] = hex[(*p_in >> 4) & 0xF];
+        p_out[1] = hex[*p_in & 0xF];
+        p_out[2] = ':';
+    }
+    p_out[-1] = 0;
+}
+
+char *furi_status_to_string(FuriStatus status, char *result, uint8_t resultLen) {
+    snprintf(result, resultLen, "FuriStatus %d", status);
+    return result;
+}
+
+void wendigo_scene_device_list_begin_refresh(WendigoApp *app) {
+    UNUSED(app);
+}
+
+void wendigo_scene_device_list_update(WendigoApp *app, wendigo_device *dev) {
+    UNUSED(app);
+    UNUSED(dev);
+}
+
+void wendigo_scene_device_list_end_refresh(WendigoApp *app) {
+    UNUSED(app);
+}
+
+void wendigo_scene_device_list_begin_removal(WendigoApp *app) {
+    UNUSED(app);
+}
+
+void wendigo_scene_device_list_remove_device(wendigo_device *dev) {
+    UNUSED(dev);
+}
+
+void wendigo_scene_device_list_end_removal(WendigoApp *app) {
+    UNUSED(app);
+}
+
+void wendigo_scene_locate_update(WendigoApp *app, wendigo_pkt_rssi *pkt) {
+    UNUSED(app);
+    UNUSED(pkt);
+}
+
+wendigo_device *wendigo_scene_device_detail_get_device() {
+    return NULL;
+}
+
+wendigo_device *wendigo_scene_pnl_list_get_device() {
+    return NULL;
+}
+
+void wendigo_scene_status_begin_layout(WendigoApp *app) {
+    UNUSED(app);
+}
+
+void wendigo_scene_status_add_attribute(WendigoApp *app, char *name, char *value) {
+    UNUSED(app);
+    UNUSED(name);
+    UNUSED(value);
+}
+
+void wendigo_scene_status_finish_layout(WendigoApp *app) {
+    UNUSED(app);
+}
@@ -0,0 +1,742 @@
+/** wendigo-sim: Generate a realistic ESP32-Wendigo UART stream.
+ *
+ * Models a population of WiFi access points, stations with Preferred Network
+ * Lists and Bluetooth Classic/LE devices, and writes the packets ESP32-Wendigo
+ * would send while scanning them. Each device reports at its own Poisson
+ * rate, RSSI follows a random walk, devices that randomise their MAC change it
+ * over time, stations roam between APs, and traffic can arrive in bursts.
+ *
+ * Output goes to a file, stdout, or a new pty (-p) for Flipper-Wendigo's UART
+ * or wendigo-decode to read. By default it's paced in real time and limited to
+ * the link's baud rate, the way ESP32-Wendigo blocks on a full UART. -f writes
+ * as fast as possible, and -R writes a Flipper-Wendigo UART recording
+ * (uart.rec) that replays with the simulated timing. The same seed always
+ * produces the same stream.
+ *
+ *     wendigo-sim [options] [output]
+ */
+/* posix_openpt() and friends */
+#define _GNU_SOURCE
+
+#include "wendigo_packets.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <math.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_STATIONS_PER_AP (32)
+#define MAX_PNL             (12)
+#define MAX_NAME_LEN        (32)
+#define MAX_EIR_LEN         (31)
+#define RSSI_MIN            (-100)
+#define RSSI_MAX            (-20)
+#define PACKET_BUFFER       (4096)
+/* wendigo_record.c's format */
+#define RECORD_MAGIC        "WDGREC"
+#define RECORD_VERSION      (1)
+/* ESP32-Wendigo's scan types */
+#define SCAN_HCI            (0)
+#define SCAN_BLE            (1)
+#define SCAN_WIFI_AP        (2)
+#define SCAN_WIFI_STA       (3)
+
+typedef enum {
+    DEV_AP = 0,
+    DEV_STA,
+    DEV_BT,
+    DEV_KIND_COUNT
+} device_kind;
+
+typedef struct {
+    uint8_t kind;
+    uint8_t mac[WENDIGO_PKT_MAC_BYTES];
+    uint8_t channel;
+    double rssi;
+    bool randomises_mac;
+    union {
+        struct {
+            char ssid[MAX_NAME_LEN + 1];
+            uint8_t auth_mode;
+        } ap;
+        struct {
+            int32_t ap;                 /* Index into devices[], -1 if not associated */
+            uint8_t pnl_count;
+            const char *pnl[MAX_PNL];
+        } sta;
+        struct {
+            uint8_t scantype;
+            uint32_t cod;
+            char name[MAX_NAME_LEN + 1];
+            uint8_t eir_len;
+            uint8_t eir[MAX_EIR_LEN];
+        } bt;
+    };
+} device;
+
+/* Min-heap of upcoming reports, ordered by time */
+typedef struct {
+    double time;
+    uint32_t device;
+} event;
+
+typedef struct {
+    uint32_t counts[DEV_KIND_COUNT];
+    double rates[DEV_KIND_COUNT];  /* Reports per second per device */
+    double rssi_step;              /* Standard deviation of each RSSI step, dB */
+    double churn;                  /* Fraction of MAC-randomising devices that change MAC each second */
+    double roam;                   /* Fraction of stations that change AP each second */
+    double burst;                  /* Rate multiplier during a burst */
+    double burst_on;               /* Mean burst length, seconds */
+    double burst_off;              /* Mean time between bursts, seconds */
+    double noise;                  /* Lines of log output per second */
+    long baud;
+    double duration;
+    bool fast;
+    bool record;
+    bool create_pty;
+    uint64_t seed;
+} sim_config;
+
+typedef struct {
+    uint64_t packets[WENDIGO_PKT_TYPE_COUNT];
+    uint64_t packets_total;
+    uint64_t bytes;
+    uint64_t mac_changes;
+    uint64_t roams;
+    uint64_t noise_lines;
+} sim_stats;
+
+typedef struct {
+    sim_config cfg;
+    sim_stats stats;
+    device *devices;
+    uint32_t device_count;
+    event *heap;
+    uint32_t heap_len;
+    uint64_t rng;
+    double now;                    /* Simulated seconds */
+    double next_churn;
+    double next_noise;
+    bool bursting;
+    double burst_toggle;
+    int fd;
+    double started;                /* Wall clock at start */
+    double last_record_time;       /* Simulated time of the last recording chunk */
+} simulator;
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void handle_signal(int sig) {
+    (void)sig;
+    stop_requested = 1;
+}
+
+static const char *const ssid_pool[] = {
+    "HomeNetwork", "TP-Link_4F2A", "NETGEAR47", "Telstra8C2D", "optus_2G", "Office-5G", "Guest",
+    "iPhone", "AndroidAP", "Airport Free WiFi", "Starbucks", "McDonalds Free WiFi", "eduroam",
+    "Library-Public", "HP-Print-3C-LaserJet", "xfinitywifi", "Hotel_Lobby", "CoffeeShop", "VM1234567",
+    "Linksys", "dlink-5E7A", "BELL429", "SKY1A2B3", "FRITZ!Box 7530", "Vodafone-ABCD", "WiFi-Repeater",
+    "Chromecast", "DIRECT-roku-123", "ATT9xJ2kP4", "Pretty Fly for a WiFi",
+};
+#define SSID_POOL_LEN (sizeof(ssid_pool) / sizeof(ssid_pool[0]))
+
+static const char *const bt_names[] = {
+    "Galaxy Buds2", "AirPods Pro", "JBL Flip 5", "Fitbit Charge 5", "Mi Band 7", "Apple Watch", "Pixel 7",
+    "Tile", "WH-1000XM4", "Bose QC45", "LE-Bose Micro", "[TV] Samsung Q70", "Polar H10", "Garmin Venu",
+    "MX Master 3", "Keychron K2", "Flipper Zero", "ESP32", "Tesla Model 3", "Govee_H6159",
+};
+#define BT_NAMES_LEN (sizeof(bt_names) / sizeof(bt_names[0]))
+
+/* Class of Device for phones, computers, audio, wearables and peripherals */
+static const uint32_t cod_pool[] = {0x5A020C, 0x7A020C, 0x3E0104, 0x240404, 0x240418, 0x000704, 0x002540};
+#define COD_POOL_LEN (sizeof(cod_pool) / sizeof(cod_pool[0]))
+
+/* Random numbers */
+
+static uint64_t rng_next(simulator *sim) {
+    /* xorshift64* */
+    sim->rng ^= sim->rng >> 12;
+    sim->rng ^= sim->rng << 25;
+    sim->rng ^= sim->rng >> 27;
+    return sim->rng * 0x2545F4914F6CDD1DULL;
+}
+
+/** Uniform in [0, 1) */
+static double rng_uniform(simulator *sim) {
+    return (double)(rng_next(sim) >> 11) / 9007199254740992.0;
+}
+
+static uint32_t rng_below(simulator *sim, uint32_t n) {
+    return (uint32_t)(rng_uniform(sim) * n);
+}
+
+static double rng_exponential(simulator *sim, double rate) {
+    return -log(1.0 - rng_uniform(sim)) / rate;
+}
+
+static double rng_gaussian(simulator *sim) {
+    /* Box-Muller */
+    double u1 = 1.0 - rng_uniform(sim);
+    double u2 = rng_uniform(sim);
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static void random_mac(simulator *sim, uint8_t *mac, bool randomised) {
+    for (uint8_t i = 0; i < WENDIGO_PKT_MAC_BYTES; ++i) {
+        mac[i] = (uint8_t)rng_next(sim);
+    }
+    /* Unicast, and locally administered if it's a randomised MAC */
+    mac[0] &= 0xFC;
+    if (randomised) {
+        mac[0] |= 0x02;
+    }
+}
+
+static uint8_t random_channel(simulator *sim) {
+    /* Most APs sit on 1, 6 or 11 */
+    static const uint8_t common[] = {1, 6, 11};
+    return (rng_uniform(sim) < 0.8) ? common[rng_below(sim, 3)] : (uint8_t)(1 + rng_below(sim, 13));
+}
+
+/* Population */
+
+static void init_device(simulator *sim, uint32_t idx, device_kind kind) {
+    device *dev = &sim->devices[idx];
+    memset(dev, 0, sizeof(device));
+    dev->kind = (uint8_t)kind;
+    dev->rssi = -90 + 60 * rng_uniform(sim);
+    switch (kind) {
+        case DEV_AP:
+            dev->randomises_mac = false;
+            dev->channel = random_channel(sim);
+            if (rng_uniform(sim) < 0.05) {
+                dev->ap.ssid[0] = '\0'; /* Hidden network */
+            } else {
+                snprintf(dev->ap.ssid, sizeof(dev->ap.ssid), "%s", ssid_pool[rng_below(sim, SSID_POOL_LEN)]);
+            }
+            dev->ap.auth_mode = (uint8_t)((rng_uniform(sim) < 0.1) ? 0 : 3 + rng_below(sim, 2));
+            break;
+        case DEV_STA:
+            /* Most modern phones randomise their MAC */
+            dev->randomises_mac = rng_uniform(sim) < 0.7;
+            dev->sta.ap = -1;
+            dev->sta.pnl_count = (uint8_t)rng_below(sim, MAX_PNL + 1);
+            for (uint8_t i = 0; i < dev->sta.pnl_count; ++i) {
+                dev->sta.pnl[i] = ssid_pool[rng_below(sim, SSID_POOL_LEN)];
+            }
+            break;
+        case DEV_BT:
+            dev->bt.scantype = (rng_uniform(sim) < 0.8) ? SCAN_BLE : SCAN_HCI;
+            dev->randomises_mac = dev->bt.scantype == SCAN_BLE && rng_uniform(sim) < 0.6;
+            dev->bt.cod = cod_pool[rng_below(sim, COD_POOL_LEN)];
+            if (rng_uniform(sim) < 0.5) {
+                snprintf(dev->bt.name, sizeof(dev->bt.name), "%s", bt_names[rng_below(sim, BT_NAMES_LEN)]);
+            }
+            if (dev->bt.scantype == SCAN_BLE) {
+                /* Flags, then manufacturer-specific data */
+                uint8_t len = (uint8_t)(8 + rng_below(sim, MAX_EIR_LEN - 8));
+                dev->bt.eir[0] = 0x02;
+                dev->bt.eir[1] = 0x01;
+                dev->bt.eir[2] = 0x06;
+                dev->bt.eir[3] = (uint8_t)(len - 4);
+                dev->bt.eir[4] = 0xFF;
+                for (uint8_t i = 5; i < len; ++i) {
+                    dev->bt.eir[i] = (uint8_t)rng_next(sim);
+                }
+                dev->bt.eir_len = len;
+            }
+            break;
+        default:
+            break;
+    }
+    random_mac(sim, dev->mac, dev->randomises_mac);
+}
+
+/** Associate a station with a random AP, or none */
+static void associate(simulator *sim, device *sta) {
+    uint32_t aps = sim->cfg.counts[DEV_AP];
+    if (aps == 0 || rng_uniform(sim) < 0.3) {
+        sta->sta.ap = -1;
+        sta->channel = random_channel(sim);
+    } else {
+        sta->sta.ap = (int32_t)rng_below(sim, aps);
+        sta->channel = sim->devices[sta->sta.ap].channel;
+    }
+}
+
+/* Event heap */
+
+static void heap_push(simulator *sim, double time, uint32_t device) {
+    uint32_t i = sim->heap_len++;
+    while (i > 0) {
+        uint32_t parent = (i - 1) / 2;
+        if (sim->heap[parent].time <= time) {
+            break;
+        }
+        sim->heap[i] = sim->heap[parent];
+        i = parent;
+    }
+    sim->heap[i].time = time;
+    sim->heap[i].device = device;
+}
+
+static event heap_pop(simulator *sim) {
+    event top = sim->heap[0];
+    event last = sim->heap[--sim->heap_len];
+    uint32_t i = 0;
+    while (true) {
+        uint32_t child = (2 * i) + 1;
+        if (child >= sim->heap_len) {
+            break;
+        }
+        if (child + 1 < sim->heap_len && sim->heap[child + 1].time < sim->heap[child].time) {
+            ++child;
+        }
+        if (last.time <= sim->heap[child].time) {
+            break;
+        }
+        sim->heap[i] = sim->heap[child];
+        i = child;
+    }
+    sim->heap[i] = last;
+    return top;
+}
+
+/** Each device is scheduled at its peak (burst) rate, and reports are thinned
+ * outside bursts - this gives exact Poisson arrivals as the rate changes. */
+static double peak_rate(simulator *sim, device_kind kind) {
+    return sim->cfg.rates[kind] * ((sim->cfg.burst > 1) ? sim->cfg.burst : 1);
+}
+
+static void schedule(simulator *sim, uint32_t idx) {
+    double rate = peak_rate(sim, (device_kind)sim->devices[idx].kind);
+    if (rate > 0) {
+        heap_push(sim, sim->now + rng_exponential(sim, rate), idx);
+    }
+}
+
+/* Output */
+
+static double monotonic_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + ((double)ts.tv_nsec / 1e9);
+}
+
+static void sleep_until(double when) {
+    double delay = when - monotonic_now();
+    if (delay > 0) {
+        struct timespec ts = {.tv_sec = (time_t)delay, .tv_nsec = (long)((delay - (time_t)delay) * 1e9)};
+        nanosleep(&ts, NULL);
+    }
+}
+
+static bool write_all(int fd, const uint8_t *buf, size_t len) {
+    while (len > 0) {
+        ssize_t written = write(fd, buf, len);
+        if (written < 0) {
+            if (errno == EINTR && !stop_requested) {
+                continue;
+            }
+            return false;
+        }
+        buf += written;
+        len -= (size_t)written;
+    }
+    return true;
+}
+
+static void put_le(uint8_t *dst, uint32_t value, uint8_t size) {
+    for (uint8_t i = 0; i < size; ++i) {
+        dst[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+/** Send bytes as ESP32-Wendigo would - at the simulated time, no faster than
+ * the baud rate allows */
+static bool emit(simulator *sim, const uint8_t *buf, uint16_t len) {
+    if (sim->cfg.record) {
+        /* Each chunk records the milliseconds since the previous one */
+        uint8_t header[6];
+        uint32_t delta = (uint32_t)((sim->now - sim->last_record_time) * 1000.0);
+        sim->last_record_time += delta / 1000.0;
+        put_le(header, delta, 4);
+        put_le(header + 4, len, 2);
+        if (!write_all(sim->fd, header, sizeof(header))) {
+            return false;
+        }
+    } else if (!sim->cfg.fast) {
+        sleep_until(sim->started + sim->now);
+        if (sim->cfg.baud > 0) {
+            /* 8N1 - 10 bits per byte */
+            sleep_until(sim->started + ((double)(sim->stats.bytes + len) * 10.0 / (double)sim->cfg.baud));
+        }
+    }
+    sim->stats.bytes += len;
+    return write_all(sim->fd, buf, len);
+}
+
+static bool emit_packet(simulator *sim, wendigo_pkt_type type, const uint8_t *buf, uint16_t len) {
+    if (len == 0) {
+        return true; /* Didn't fit - can't happen with the limits above */
+    }
+    ++sim->stats.packets[type];
+    ++sim->stats.packets_total;
+    return emit(sim, buf, len);
+}
+
+static int16_t walk_rssi(simulator *sim, device *dev) {
+    dev->rssi += rng_gaussian(sim) * sim->cfg.rssi_step;
+    if (dev->rssi < RSSI_MIN) {
+        dev->rssi = RSSI_MIN;
+    } else if (dev->rssi > RSSI_MAX) {
+        dev->rssi = RSSI_MAX;
+    }
+    return (int16_t)lround(dev->rssi);
+}
+
+static bool report_ap(simulator *sim, uint32_t idx, uint8_t *buf) {
+    device *dev = &sim->devices[idx];
+    uint8_t *stations[MAX_STATIONS_PER_AP];
+    uint8_t sta_count = 0;
+    uint32_t first_sta = sim->cfg.counts[DEV_AP];
+    for (uint32_t i = first_sta; i < first_sta + sim->cfg.counts[DEV_STA] && sta_count < MAX_STATIONS_PER_AP; ++i) {
+        if (sim->devices[i].sta.ap == (int32_t)idx) {
+            stations[sta_count++] = sim->devices[i].mac;
+        }
+    }
+    wendigo_pkt_wifi_ap pkt = {
+        .scantype = SCAN_WIFI_AP, .channel = dev->channel, .rssi = walk_rssi(sim, dev),
+        .auth_mode = dev->ap.auth_mode, .ssid_len = (uint8_t)strlen(dev->ap.ssid), .sta_count = sta_count,
+        .ssid = (const uint8_t *)dev->ap.ssid, .stations = stations,
+    };
+    memcpy(pkt.mac, dev->mac, WENDIGO_PKT_MAC_BYTES);
+    return emit_packet(sim, WENDIGO_PKT_WIFI_AP, buf, wendigo_pkt_wifi_ap_encode(&pkt, buf, PACKET_BUFFER));
+}
+
+static bool report_sta(simulator *sim, uint32_t idx, uint8_t *buf) {
+    device *dev = &sim->devices[idx];
+    const device *ap = (dev->sta.ap >= 0) ? &sim->devices[dev->sta.ap] : NULL;
+    wendigo_pkt_wifi_sta pkt = {
+        .scantype = SCAN_WIFI_STA, .channel = dev->channel, .rssi = walk_rssi(sim, dev),
+        .pnl_count = dev->sta.pnl_count, .pnl = (char *const *)dev->sta.pnl,
+    };
+    memcpy(pkt.mac, dev->mac, WENDIGO_PKT_MAC_BYTES);
+    if (ap != NULL) {
+        memcpy(pkt.ap_mac, ap->mac, WENDIGO_PKT_MAC_BYTES);
+        pkt.ap_ssid = (const uint8_t *)ap->ap.ssid;
+        pkt.ap_ssid_len = (uint8_t)strlen(ap->ap.ssid);
+    }
+    return emit_packet(sim, WENDIGO_PKT_WIFI_STA, buf, wendigo_pkt_wifi_sta_encode(&pkt, buf, PACKET_BUFFER));
+}
+
+static bool report_bt(simulator *sim, uint32_t idx, uint8_t *buf) {
+    device *dev = &sim->devices[idx];
+    wendigo_pkt_bt pkt = {
+        .bdname_len = (uint8_t)strlen(dev->bt.name), .eir_len = dev->bt.eir_len, .rssi = walk_rssi(sim, dev),
+        .cod = dev->bt.cod, .scantype = dev->bt.scantype,
+        .bdname = (const uint8_t *)dev->bt.name, .eir = dev->bt.eir,
+    };
+    memcpy(pkt.bda, dev->mac, WENDIGO_PKT_MAC_BYTES);
+    return emit_packet(sim, WENDIGO_PKT_BT, buf, wendigo_pkt_bt_encode(&pkt, buf, PACKET_BUFFER));
+}
+
+/** What ESP32-Wendigo sends when Flipper-Wendigo starts */
+static bool emit_startup(simulator *sim, uint8_t *buf) {
+    static const uint8_t version[] = "igo v0.5.0";
+    wendigo_pkt_version ver = {.version = version, .version_len = sizeof(version)};
+    if (!emit_packet(sim, WENDIGO_PKT_VERSION, buf, wendigo_pkt_version_encode(&ver, buf, PACKET_BUFFER))) {
+        return false;
+    }
+    uint8_t bda[WENDIGO_PKT_MAC_BYTES];
+    uint8_t wifi[WENDIGO_PKT_MAC_BYTES];
+    random_mac(sim, bda, false);
+    memcpy(wifi, bda, WENDIGO_PKT_MAC_BYTES);
+    wifi[5] -= 2;
+    uint8_t types[2] = {1, 0};
+    uint8_t *macs[2] = {bda, wifi};
+    wendigo_pkt_mac mac = {.if_count = 2, .interfaces_types = types, .interfaces = macs};
+    if (!emit_packet(sim, WENDIGO_PKT_MAC, buf, wendigo_pkt_mac_encode(&mac, buf, PACKET_BUFFER))) {
+        return false;
+    }
+    uint8_t channels[13];
+    for (uint8_t i = 0; i < sizeof(channels); ++i) {
+        channels[i] = (uint8_t)(i + 1);
+    }
+    wendigo_pkt_channels chan = {.count = sizeof(channels), .channels = channels};
+    return emit_packet(sim, WENDIGO_PKT_CHANNELS, buf, wendigo_pkt_channels_encode(&chan, buf, PACKET_BUFFER));
+}
+
+/** Once a simulated second - MAC randomisation and roaming */
+static void churn(simulator *sim) {
+    for (uint32_t i = 0; i < sim->device_count; ++i) {
+        device *dev = &sim->devices[i];
+        if (dev->randomises_mac && rng_uniform(sim) < sim->cfg.churn) {
+            random_mac(sim, dev->mac, true);
+            ++sim->stats.mac_changes;
+        }
+        if (dev->kind == DEV_STA && rng_uniform(sim) < sim->cfg.roam) {
+            associate(sim, dev);
+            ++sim->stats.roams;
+        }
+    }
+}
+
+static bool emit_noise(simulator *sim) {
+    /* ESP-IDF log output that sometimes leaks onto the UART */
+    char line[64];
+    int len = snprintf(line, sizeof(line), "I (%lu) wifi:new:<%u,0>, old:<1,0>\n",
+        (unsigned long)(sim->now * 1000), 1 + rng_below(sim, 13));
+    ++sim->stats.noise_lines;
+    return emit(sim, (const uint8_t *)line, (uint16_t)len);
+}
+
+static void run(simulator *sim) {
+    uint8_t buf[PACKET_BUFFER];
+    if (!emit_startup(sim, buf)) {
+        return;
+    }
+    sim->next_churn = 1.0;
+    sim->next_noise = (sim->cfg.noise > 0) ? rng_exponential(sim, sim->cfg.noise) : INFINITY;
+    sim->burst_toggle = (sim->cfg.burst > 1) ? rng_exponential(sim, 1.0 / sim->cfg.burst_off) : INFINITY;
+    while (!stop_requested && sim->heap_len > 0) {
+        double next = sim->heap[0].time;
+        /* Periodic processes happen before the report that follows them */
+        if (sim->next_churn <= next || sim->next_noise <= next || sim->burst_toggle <= next) {
+            if (sim->burst_toggle <= sim->next_churn && sim->burst_toggle <= sim->next_noise) {
+                sim->now = sim->burst_toggle;
+                sim->bursting = !sim->bursting;
+                sim->burst_toggle += rng_exponential(sim,
+                    1.0 / (sim->bursting ? sim->cfg.burst_on : sim->cfg.burst_off));
+            } else if (sim->next_churn <= sim->next_noise) {
+                sim->now = sim->next_churn;
+                churn(sim);
+                sim->next_churn += 1.0;
+            } else {
+                sim->now = sim->next_noise;
+                if (!emit_noise(sim)) {
+                    return;
+                }
+                sim->next_noise += rng_exponential(sim, sim->cfg.noise);
+            }
+        } else {
+            event ev = heap_pop(sim);
+            sim->now = ev.time;
+            if (sim->cfg.duration > 0 && sim->now > sim->cfg.duration) {
+                break;
+            }
+            /* Thin reports outside bursts */
+            bool report = sim->cfg.burst <= 1 || sim->bursting || rng_uniform(sim) * sim->cfg.burst < 1.0;
+            bool ok = true;
+            if (report) {
+                switch (sim->devices[ev.device].kind) {
+                    case DEV_AP:
+                        ok = report_ap(sim, ev.device, buf);
+                        break;
+                    case DEV_STA:
+                        ok = report_sta(sim, ev.device, buf);
+                        break;
+                    default:
+                        ok = report_bt(sim, ev.device, buf);
+                        break;
+                }
+            }
+            if (!ok) {
+                return;
+            }
+            schedule(sim, ev.device);
+        }
+        if (sim->cfg.duration > 0 && sim->now > sim->cfg.duration) {
+            break;
+        }
+    }
+}
+
+/* Setup */
+
+static int open_pty(void) {
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd < 0 || grantpt(fd) != 0 || unlockpt(fd) != 0) {
+        perror("pty");
+        return -1;
+    }
+    /* Raw, so the line discipline doesn't mangle binary packets */
+    struct termios tio;
+    if (tcgetattr(fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    /* Hold the slave open so packets sent before a reader opens it are
+     * buffered rather than discarded */
+    if (open(ptsname(fd), O_RDWR | O_NOCTTY) < 0) {
+        perror(ptsname(fd));
+        return -1;
+    }
+    fprintf(stderr, "%s\n", ptsname(fd));
+    return fd;
+}
+
+static void write_stats(const simulator *sim) {
+    double elapsed = monotonic_now() - sim->started;
+    /* Throughput of the simulated link - Real time unless it's unpaced */
+    double span = (sim->cfg.fast || sim->cfg.record) ? sim->now : elapsed;
+    fprintf(stderr, "{\"type\":\"stats\",\"simulated\":%.3f,\"elapsed\":%.3f,\"bytes\":%llu,\"packets\":%llu,",
+        sim->now, elapsed, (unsigned long long)sim->stats.bytes, (unsigned long long)sim->stats.packets_total);
+    for (uint8_t type = 0; type < WENDIGO_PKT_TYPE_COUNT; ++type) {
+        fprintf(stderr, "\"%s\":%llu,", wendigo_pkt_type_name((wendigo_pkt_type)type),
+            (unsigned long long)sim->stats.packets[type]);
+    }
+    fprintf(stderr, "\"mac_changes\":%llu,\"roams\":%llu,\"noise_lines\":%llu,\"bytes_per_sec\":%.0f}\n",
+        (unsigned long long)sim->stats.mac_changes, (unsigned long long)sim->stats.roams,
+        (unsigned long long)sim->stats.noise_lines, (span > 0) ? (double)sim->stats.bytes / span : 0);
+}
+
+static void usage(const char *name) {
+    fprintf(stderr,
+        "Usage: %s [options] [output]\n"
+        "  output          file, serial device, or - for stdout (default); ignored with -p\n"
+        "  -a N            access points (default 20)\n"
+        "  -s N            stations (default 50)\n"
+        "  -k N            Bluetooth devices (default 100)\n"
+        "  -A rate         reports per second per AP, like a beacon rate (default 2)\n"
+        "  -S rate         reports per second per station (default 0.5)\n"
+        "  -K rate         reports per second per Bluetooth device (default 1)\n"
+        "  -w dB           RSSI random walk step, standard deviation (default 2)\n"
+        "  -c fraction     MAC-randomising devices that change MAC each second (default 0.01)\n"
+        "  -m fraction     stations that roam to another AP each second (default 0.005)\n"
+        "  -B factor       rate multiplier during bursts, 1 for no bursts (default 1)\n"
+        "  -O secs         mean burst length (default 2)\n"
+        "  -F secs         mean time between bursts (default 10)\n"
+        "  -N rate         lines of log output per second between packets (default 0)\n"
+        "  -b baud         limit output to this baud rate, 0 for unlimited (default 115200)\n"
+        "  -t secs         stop after this much simulated time (default: run until interrupted)\n"
+        "  -f              write as fast as possible instead of in real time\n"
+        "  -R              write a Flipper-Wendigo UART recording (uart.rec) - implies -f\n"
+        "  -p              create a pty and print its name on stderr\n"
+        "  -r seed         random seed (default 1)\n",
+        name);
+}
+
+int main(int argc, char **argv) {
+    simulator *sim = calloc(1, sizeof(simulator));
+    if (sim == NULL) {
+        return 1;
+    }
+    sim_config *cfg = &sim->cfg;
+    cfg->counts[DEV_AP] = 20;
+    cfg->counts[DEV_STA] = 50;
+    cfg->counts[DEV_BT] = 100;
+    cfg->rates[DEV_AP] = 2;
+    cfg->rates[DEV_STA] = 0.5;
+    cfg->rates[DEV_BT] = 1;
+    cfg->rssi_step = 2;
+    cfg->churn = 0.01;
+    cfg->roam = 0.005;
+    cfg->burst = 1;
+    cfg->burst_on = 2;
+    cfg->burst_off = 10;
+    cfg->baud = 115200;
+    cfg->seed = 1;
+    int opt;
+    while ((opt = getopt(argc, argv, "a:s:k:A:S:K:w:c:m:B:O:F:N:b:t:fRpr:h")) != -1) {
+        switch (opt) {
+            case 'a': cfg->counts[DEV_AP] = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 's': cfg->counts[DEV_STA] = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'k': cfg->counts[DEV_BT] = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'A': cfg->rates[DEV_AP] = strtod(optarg, NULL); break;
+            case 'S': cfg->rates[DEV_STA] = strtod(optarg, NULL); break;
+            case 'K': cfg->rates[DEV_BT] = strtod(optarg, NULL); break;
+            case 'w': cfg->rssi_step = strtod(optarg, NULL); break;
+            case 'c': cfg->churn = strtod(optarg, NULL); break;
+            case 'm': cfg->roam = strtod(optarg, NULL); break;
+            case 'B': cfg->burst = strtod(optarg, NULL); break;
+            case 'O': cfg->burst_on = strtod(optarg, NULL); break;
+            case 'F': cfg->burst_off = strtod(optarg, NULL); break;
+            case 'N': cfg->noise = strtod(optarg, NULL); break;
+            case 'b': cfg->baud = strtol(optarg, NULL, 10); break;
+            case 't': cfg->duration = strtod(optarg, NULL); break;
+            case 'f': cfg->fast = true; break;
+            case 'R': cfg->record = true; break;
+            case 'p': cfg->create_pty = true; break;
+            case 'r': cfg->seed = strtoull(optarg, NULL, 10); break;
+            default:
+                usage(argv[0]);
+                return (opt == 'h') ? 0 : 2;
+        }
+    }
+    if (optind < argc - 1 || cfg->burst_on <= 0 || cfg->burst_off <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (cfg->record && cfg->duration <= 0) {
+        fprintf(stderr, "-R needs a duration (-t)\n");
+        return 2;
+    }
+
+    const char *out_path = (optind < argc) ? argv[optind] : "-";
+    if (cfg->create_pty) {
+        sim->fd = open_pty();
+    } else if (!strcmp(out_path, "-")) {
+        sim->fd = STDOUT_FILENO;
+    } else {
+        sim->fd = open(out_path, O_WRONLY | O_CREAT | O_TRUNC | O_NOCTTY, 0644);
+    }
+    if (sim->fd < 0) {
+        fprintf(stderr, "%s: %s\n", out_path, strerror(errno));
+        return 1;
+    }
+
+    sim->device_count = cfg->counts[DEV_AP] + cfg->counts[DEV_STA] + cfg->counts[DEV_BT];
+    sim->devices = calloc(sim->device_count ? sim->device_count : 1, sizeof(device));
+    sim->heap = calloc(sim->device_count ? sim->device_count : 1, sizeof(event));
+    if (sim->devices == NULL || sim->heap == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    sim->rng = cfg->seed ? cfg->seed : 1;
+    uint32_t idx = 0;
+    for (uint8_t kind = 0; kind < DEV_KIND_COUNT; ++kind) {
+        for (uint32_t i = 0; i < cfg->counts[kind]; ++i, ++idx) {
+            init_device(sim, idx, (device_kind)kind);
+        }
+    }
+    for (uint32_t i = cfg->counts[DEV_AP]; i < cfg->counts[DEV_AP] + cfg->counts[DEV_STA]; ++i) {
+        associate(sim, &sim->devices[i]);
+    }
+    for (uint32_t i = 0; i < sim->device_count; ++i) {
+        schedule(sim, i);
+    }
+
+    if (cfg->record) {
+        uint8_t header[8];
+        memcpy(header, RECORD_MAGIC, 6);
+        put_le(header + 6, RECORD_VERSION, 2);
+        write_all(sim->fd, header, sizeof(header));
+    }
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_signal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    sim->started = monotonic_now();
+    run(sim);
+    write_stats(sim);
+    if (sim->fd != STDOUT_FILENO) {
+        close(sim->fd);
+    }
+    free(sim->heap);
+    free(sim->devices);
+    free(sim);
+    return 0;
+}
@@ -0,0 +1,157 @@
+/** ble_scan_policy_test: The adaptive BLE scan policy's duty cycle and scan
+ * type transitions, and its scan response cache's hits, expiry and eviction.
+ */
+#include "ble_scan_policy.h"
+#include "addr_hash.h"
+#include "wendigo_test.h"
+
+#include <string.h>
+
+/* Advertisements in a one-second cycle at 60% duty that are well above and
+   well below CONFIG_BLE_SCAN_DENSE_ADVERTS per second of listening */
+#define DENSE_ADVERTS  (CONFIG_BLE_SCAN_DENSE_ADVERTS * 10)
+#define SPARSE_ADVERTS (CONFIG_BLE_SCAN_DENSE_ADVERTS / 10)
+
+static bool cycle(ble_scan_policy *policy, uint32_t adverts, uint32_t scannable,
+        uint32_t uncached, uint32_t new_devices) {
+    ble_scan_cycle counters = {
+        .elapsed_ms = 1000,
+        .adverts = adverts,
+        .scannable = scannable,
+        .uncached = uncached,
+        .new_devices = new_devices,
+    };
+    return ble_scan_policy_update(policy, &counters);
+}
+
+static void test_duty_cycle(void) {
+    ble_scan_policy policy;
+    ble_scan_setting setting;
+    ble_scan_policy_init(&policy);
+    CHECK_EQ(ble_scan_policy_duty_percent(&policy), 60);
+    CHECK(policy.active);
+
+    /* An empty cycle changes nothing */
+    ble_scan_cycle empty = {0};
+    CHECK(!ble_scan_policy_update(&policy, &empty));
+    CHECK(!policy.measured);
+
+    /* Dense and nothing new: One step down per cycle, to the lowest */
+    CHECK(cycle(&policy, DENSE_ADVERTS, 0, 0, 0));
+    CHECK_EQ(ble_scan_policy_duty_percent(&policy), 37);
+    CHECK(cycle(&policy, DENSE_ADVERTS, 0, 0, 0));
+    CHECK_EQ(ble_scan_policy_duty_percent(&policy), 18);
+    CHECK(!cycle(&policy, DENSE_ADVERTS, 0, 0, 0));
+    ble_scan_policy_setting(&policy, &setting);
+    CHECK_EQ(setting.interval, 0x100);
+    CHECK_EQ(setting.window, 0x30);
+    CHECK(!setting.active);
+
+    /* New devices turning up: Back up a step per cycle, but only to the default */
+    CHECK(cycle(&policy, DENSE_ADVERTS, 0, 0, 100));
+    CHECK_EQ(ble_scan_policy_duty_percent(&policy), 37);
+    CHECK(cycle(&policy, DENSE_ADVERTS, 0, 0, 100));
+    CHECK_EQ(ble_scan_policy_duty_percent(&policy), 60);
+    CHECK(!cycle(&policy, DENSE_ADVERTS, 0, 0, 100));
+    CHECK_EQ(ble_scan_policy_duty_percent(&policy), 60);
+
+    /* Quiet: The smoothed rate falls until the window covers the whole interval */
+    uint8_t cycles = 0;
+    while (ble_scan_policy_duty_percent(&policy) != 100 && cycles < 32) {
+        cycle(&policy, 0, 0, 0, 0);
+        ++cycles;
+    }
+    CHECK(cycles < 32);
+    CHECK(!cycle(&policy, 0, 0, 0, 0));
+    ble_scan_policy_setting(&policy, &setting);
+    CHECK_EQ(setting.interval, setting.window);
+    CHECK(setting.active);
+
+    /* The first cycle is taken as it is, with no smoothing */
+    ble_scan_policy_init(&policy);
+    CHECK(cycle(&policy, SPARSE_ADVERTS, 0, 0, 0));
+    CHECK_EQ(ble_scan_policy_duty_percent(&policy), 100);
+    CHECK(policy.active);
+}
+
+static void test_scan_type(void) {
+    ble_scan_policy policy;
+    /* Dense with every scannable advertiser's response cached: Passive */
+    ble_scan_policy_init(&policy);
+    CHECK(cycle(&policy, DENSE_ADVERTS, 100, 0, 0));
+    CHECK(!policy.active);
+    /* Just below, and at, CONFIG_BLE_SCAN_UNCACHED_PERCENT uncached */
+    cycle(&policy, DENSE_ADVERTS, 100, CONFIG_BLE_SCAN_UNCACHED_PERCENT - 1, 0);
+    CHECK(!policy.active);
+    cycle(&policy, DENSE_ADVERTS, 100, CONFIG_BLE_SCAN_UNCACHED_PERCENT, 0);
+    CHECK(policy.active);
+    /* Switching type alone is a change the controller must be given */
+    CHECK_EQ(ble_scan_policy_duty_percent(&policy), 18);
+    CHECK(cycle(&policy, DENSE_ADVERTS, 0, 0, 0));
+    CHECK(!policy.active);
+    CHECK(!cycle(&policy, DENSE_ADVERTS, 0, 0, 0));
+
+    /* Sparse: Always active, whatever is cached */
+    ble_scan_policy_init(&policy);
+    cycle(&policy, SPARSE_ADVERTS, 100, 0, 0);
+    CHECK(policy.active);
+}
+
+static void test_rsp_cache(void) {
+    uint8_t bda[ESP_BD_ADDR_LEN] = {0xC0, 0x01, 0x02, 0x03, 0x04, 0x05};
+    uint8_t rsp[BLE_SCAN_RSP_MAX_LEN + 8];
+    uint8_t out[BLE_SCAN_RSP_MAX_LEN];
+    memset(rsp, 0x5A, sizeof(rsp));
+    ble_scan_rsp_reset();
+
+    /* Miss, then a hit until CONFIG_BLE_SCAN_RSP_CACHE_SECONDS have passed */
+    CHECK(!ble_scan_rsp_cached(bda, 0));
+    CHECK_EQ(ble_scan_rsp_get(bda, out, 0), 0);
+    ble_scan_rsp_store(bda, rsp, 4, 1000);
+    CHECK(ble_scan_rsp_cached(bda, 1000));
+    CHECK_EQ(ble_scan_rsp_get(bda, out, 2000), 4);
+    CHECK(memcmp(out, rsp, 4) == 0);
+    CHECK(ble_scan_rsp_cached(bda, 1000 + (CONFIG_BLE_SCAN_RSP_CACHE_SECONDS * 1000U) - 1));
+    CHECK(!ble_scan_rsp_cached(bda, 1000 + (CONFIG_BLE_SCAN_RSP_CACHE_SECONDS * 1000U)));
+    CHECK_EQ(ble_scan_rsp_get(bda, out, 1000 + (CONFIG_BLE_SCAN_RSP_CACHE_SECONDS * 1000U)), 0);
+
+    /* Storing again replaces the response and its age; an overlong response is cut */
+    ble_scan_rsp_store(bda, rsp, sizeof(rsp), 0xFFFFFF00U);
+    CHECK(ble_scan_rsp_cached(bda, 0x100));
+    CHECK_EQ(ble_scan_rsp_get(bda, out, 0x100), BLE_SCAN_RSP_MAX_LEN);
+
+    ble_scan_rsp_reset();
+    CHECK(!ble_scan_rsp_cached(bda, 0x100));
+
+    /* BLE_SCAN_RSP_PROBE_LEN + 1 devices starting at the same slot: Storing
+       the last evicts whichever of the others was stored longest ago */
+    uint8_t same[BLE_SCAN_RSP_PROBE_LEN + 1][ESP_BD_ADDR_LEN];
+    uint32_t start = addr_hash_slot(bda, CONFIG_BLE_SCAN_RSP_CACHE_ENTRIES);
+    uint8_t found = 0;
+    for (uint32_t i = 0; found <= BLE_SCAN_RSP_PROBE_LEN && i < 0x1000000; ++i) {
+        uint8_t candidate[ESP_BD_ADDR_LEN] = {0xC0, 0x00, 0x00, (uint8_t)(i >> 16), (uint8_t)(i >> 8), (uint8_t)i};
+        if (addr_hash_slot(candidate, CONFIG_BLE_SCAN_RSP_CACHE_ENTRIES) == start) {
+            memcpy(same[found++], candidate, ESP_BD_ADDR_LEN);
+        }
+    }
+    CHECK_EQ(found, BLE_SCAN_RSP_PROBE_LEN + 1);
+    for (uint8_t i = 0; i < BLE_SCAN_RSP_PROBE_LEN; ++i) {
+        ble_scan_rsp_store(same[i], rsp, 1, 100 + i);
+    }
+    /* The first device stored is refreshed, so the second is now the oldest */
+    ble_scan_rsp_store(same[0], rsp, 1, 200);
+    ble_scan_rsp_store(same[BLE_SCAN_RSP_PROBE_LEN], rsp, 1, 201);
+    CHECK(ble_scan_rsp_cached(same[0], 300));
+    CHECK(!ble_scan_rsp_cached(same[1], 300));
+    for (uint8_t i = 2; i <= BLE_SCAN_RSP_PROBE_LEN; ++i) {
+        CHECK(ble_scan_rsp_cached(same[i], 300));
+    }
+    ble_scan_rsp_reset();
+}
+
+int main(void) {
+    test_duty_cycle();
+    test_scan_type();
+    test_rsp_cache();
+    return CHECK_RESULT();
+}
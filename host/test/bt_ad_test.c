@@ -0,0 +1,137 @@
+/** bt_ad_test: bt_ad_parse() against malformed AD structures - Fields that
+ * run past the end of the payload, zero-length fields and fields longer than
+ * their type needs.
+ */
+#include "bt_ad.h"
+#include "wendigo_test.h"
+
+#include <string.h>
+
+/* A field whose length byte runs past the end of the payload fails the parse,
+   but keeps everything before it */
+static void test_truncated(void) {
+    bt_ad_data ad;
+    /* Flags, then a complete name claiming four bytes with only two present */
+    const uint8_t name_cut[] = {0x02, 0x01, 0x06, 0x05, 0x09, 'A', 'B'};
+    CHECK(!bt_ad_parse(name_cut, sizeof(name_cut), &ad));
+    CHECK(ad.has_flags);
+    CHECK_EQ(ad.flags, 0x06);
+    CHECK(ad.name == NULL);
+    CHECK_EQ(ad.name_len, 0);
+
+    /* Only the length byte of the last field */
+    const uint8_t length_only[] = {0x02, 0x0A, 0xF4, 0x03};
+    CHECK(!bt_ad_parse(length_only, sizeof(length_only), &ad));
+    CHECK(ad.has_tx_power);
+    CHECK_EQ(ad.tx_power, -12);
+
+    /* A UUID list cut short by payload_len, although the bytes are there */
+    const uint8_t uuids[] = {0x05, 0x03, 0x0D, 0x18, 0x0F, 0x18};
+    CHECK(!bt_ad_parse(uuids, sizeof(uuids) - 1, &ad));
+    CHECK_EQ(ad.uuid_count, 0);
+    CHECK(bt_ad_parse(uuids, sizeof(uuids), &ad));
+    CHECK_EQ(ad.uuid_count, 2);
+
+    /* A field that ends exactly at the end of the payload is complete */
+    const uint8_t exact[] = {0x03, 0x19, 0xC1, 0x03};
+    CHECK(bt_ad_parse(exact, sizeof(exact), &ad));
+    CHECK(ad.has_appearance);
+    CHECK_EQ(ad.appearance, 0x03C1);
+
+    /* No payload */
+    CHECK(bt_ad_parse(NULL, 0, &ad));
+    CHECK(!bt_ad_parse(NULL, 4, &ad));
+    CHECK_EQ(ad.uuid_count, 0);
+}
+
+/* A zero length byte ends the significant data; a field with a type and no
+   data is skipped */
+static void test_zero_length(void) {
+    bt_ad_data ad;
+    /* Flags, the end of significant data, then a name that must be ignored */
+    const uint8_t terminated[] = {0x02, 0x01, 0x1A, 0x00, 0x03, 0x09, 'X', 'Y'};
+    CHECK(bt_ad_parse(terminated, sizeof(terminated), &ad));
+    CHECK(ad.has_flags);
+    CHECK(ad.name == NULL);
+
+    /* The zero padding after an advertisement shorter than 31 bytes */
+    uint8_t padded[31] = {0x03, 0x09, 'H', 'i'};
+    CHECK(bt_ad_parse(padded, sizeof(padded), &ad));
+    CHECK(ad.name == padded + 2);
+    CHECK_EQ(ad.name_len, 2);
+
+    /* Each field type with no data, then a short name that must still be found */
+    const uint8_t empty[] = {0x01, 0x01, 0x01, 0x03, 0x01, 0x09, 0x01, 0x0A, 0x01, 0x19,
+                             0x01, 0xFF, 0x03, 0x08, 'O', 'K'};
+    CHECK(bt_ad_parse(empty, sizeof(empty), &ad));
+    CHECK(!ad.has_flags);
+    CHECK_EQ(ad.uuid_count, 0);
+    CHECK(!ad.has_tx_power);
+    CHECK(!ad.has_appearance);
+    CHECK(!ad.has_company_id);
+    CHECK(ad.name == empty + 14);
+    CHECK_EQ(ad.name_len, 2);
+    CHECK(!ad.name_complete);
+}
+
+/* Fields longer than their type needs */
+static void test_overlong(void) {
+    bt_ad_data ad;
+    /* A length byte far beyond a legacy advertisement's 31 bytes */
+    uint8_t huge[31] = {0xFF, 0x09, 'N'};
+    CHECK(!bt_ad_parse(huge, sizeof(huge), &ad));
+    CHECK(ad.name == NULL);
+
+    /* Extra bytes after the flags, TX power and appearance are ignored, and
+       a UUID list's partial trailing UUID is dropped */
+    const uint8_t extra[] = {0x03, 0x01, 0x06, 0xEE, 0x03, 0x0A, 0x04, 0xEE,
+                             0x04, 0x19, 0x40, 0x00, 0xEE, 0x04, 0x03, 0x0D, 0x18, 0xEE};
+    CHECK(bt_ad_parse(extra, sizeof(extra), &ad));
+    CHECK_EQ(ad.flags, 0x06);
+    CHECK_EQ(ad.tx_power, 4);
+    CHECK_EQ(ad.appearance, 0x0040);
+    CHECK_EQ(ad.uuid_count, 1);
+    CHECK_EQ(ad.uuids[0].len, ESP_UUID_LEN_16);
+    CHECK_EQ(ad.uuids[0].uuid.uuid16, 0x180D);
+
+    /* More UUIDs than BT_AD_MAX_UUIDS, in one field and across two */
+    uint8_t many[2 + ((BT_AD_MAX_UUIDS + 2) * 2)];
+    many[0] = sizeof(many) - 1;
+    many[1] = BT_AD_TYPE_UUID16_COMPLETE;
+    for (uint8_t i = 0; i < BT_AD_MAX_UUIDS + 2; ++i) {
+        many[2 + (i * 2)] = i;
+        many[3 + (i * 2)] = 0x18;
+    }
+    CHECK(bt_ad_parse(many, sizeof(many), &ad));
+    CHECK_EQ(ad.uuid_count, BT_AD_MAX_UUIDS);
+    CHECK(ad.uuids_truncated);
+    CHECK_EQ(ad.uuids[BT_AD_MAX_UUIDS - 1].uuid.uuid16, 0x1800 + BT_AD_MAX_UUIDS - 1);
+
+    uint8_t split[4 + (BT_AD_MAX_UUIDS * 4) + 18];
+    split[0] = (BT_AD_MAX_UUIDS * 4) + 1;
+    split[1] = BT_AD_TYPE_UUID32_INCOMPLETE;
+    memset(split + 2, 0xAB, BT_AD_MAX_UUIDS * 4);
+    split[2 + (BT_AD_MAX_UUIDS * 4)] = 17;
+    split[3 + (BT_AD_MAX_UUIDS * 4)] = BT_AD_TYPE_UUID128_COMPLETE;
+    memset(split + 4 + (BT_AD_MAX_UUIDS * 4), 0xCD, 16);
+    split[sizeof(split) - 2] = 0x01;
+    split[sizeof(split) - 1] = BT_AD_TYPE_FLAGS;
+    CHECK(bt_ad_parse(split, sizeof(split), &ad));
+    CHECK_EQ(ad.uuid_count, BT_AD_MAX_UUIDS);
+    CHECK(ad.uuids_truncated);
+    CHECK_EQ(ad.uuids[0].len, ESP_UUID_LEN_32);
+    CHECK_EQ(ad.uuids[0].uuid.uuid32, 0xABABABAB);
+
+    /* Only the first manufacturer's company ID is kept */
+    const uint8_t two_companies[] = {0x05, 0xFF, 0x4C, 0x00, 0x02, 0x15, 0x03, 0xFF, 0x06, 0x00};
+    CHECK(bt_ad_parse(two_companies, sizeof(two_companies), &ad));
+    CHECK(ad.has_company_id);
+    CHECK_EQ(ad.company_id, 0x004C);
+}
+
+int main(void) {
+    test_truncated();
+    test_zero_length();
+    test_overlong();
+    return CHECK_RESULT();
+}
@@ -0,0 +1,28 @@
+# Replay a capture through wendigo-pcap and compare the UART stream it writes
+# with the known-good stream committed alongside the capture.
+#     cmake -DPCAP=wendigo-pcap -DCAPTURE=x.pcap -DEXPECTED=x.uart -DACTUAL=out.uart -P wendigo_pcap_golden.cmake
+# If a change to the WiFi parsers is meant to change the stream, decode both
+# with wendigo-decode to check the difference, then regenerate EXPECTED:
+#     wendigo-pcap x.pcap > x.uart
+foreach(var PCAP CAPTURE EXPECTED ACTUAL)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "${var} isn't set")
+    endif()
+endforeach()
+
+execute_process(
+    COMMAND ${PCAP} ${CAPTURE}
+    OUTPUT_FILE ${ACTUAL}
+    ERROR_VARIABLE stats
+    RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "wendigo-pcap failed (${result}): ${stats}")
+endif()
+
+execute_process(
+    COMMAND ${CMAKE_COMMAND} -E compare_files ${EXPECTED} ${ACTUAL}
+    RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${ACTUAL} doesn't match ${EXPECTED} - "
+        "Decode both with wendigo-decode to see what changed")
+endif()
@@ -0,0 +1,39 @@
+/** Minimal checks for the host tests, run by ctest.
+ *
+ * Unlike assert() these still run in a Release build, and a failing check
+ * doesn't stop the test, so one run reports every failure:
+ *
+ *     CHECK(bt_ad_parse(payload, sizeof(payload), &ad));
+ *     CHECK_EQ(ad.uuid_count, 1);
+ *     return CHECK_RESULT();
+ */
+#pragma once
+
+#include <stdio.h>
+
+static unsigned wendigo_test_checks = 0;
+static unsigned wendigo_test_failures = 0;
+
+#define CHECK(expr) do { \
+        ++wendigo_test_checks; \
+        if (!(expr)) { \
+            ++wendigo_test_failures; \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #expr); \
+        } \
+    } while (0)
+
+#define CHECK_EQ(actual, expected) do { \
+        long long actual_ = (long long)(actual); \
+        long long expected_ = (long long)(expected); \
+        ++wendigo_test_checks; \
+        if (actual_ != expected_) { \
+            ++wendigo_test_failures; \
+            fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", \
+                __FILE__, __LINE__, #actual, #expected, actual_, expected_); \
+        } \
+    } while (0)
+
+/* Report the totals; the result is main()'s exit status */
+#define CHECK_RESULT() \
+    (fprintf(stderr, "%u checks, %u failed\n", wendigo_test_checks, wendigo_test_failures), \
+     wendigo_test_failures == 0 ? 0 : 1)
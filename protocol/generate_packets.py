@@ -0,0 +1,768 @@
+#!/usr/bin/env python3
+"""Generate Wendigo packet encoders and decoders from wendigo_packets.schema.
+
+Writes wendigo_packets.h and wendigo_packets.c into each directory given on
+the command line. The output is plain C99 that depends only on the C standard
+library, so the same files build into ESP32-Wendigo, Flipper-Wendigo and the
+host tools.
+
+    python3 protocol/generate_packets.py Flipper
+    python3 protocol/generate_packets.py --check Flipper
+
+esp32/main/wendigo_packets.[ch] are symlinks to the Flipper copies, in the same
+way as wendigo_common_defs.[ch].
+
+--check doesn't write anything; it exits with status 1 if any directory's
+copy differs from what the schema would generate.
+"""
+
+import argparse
+import os
+import sys
+
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_SCHEMA = os.path.join(SCRIPT_DIR, "wendigo_packets.schema")
+OUTPUT_NAME = "wendigo_packets"
+
+PREAMBLE_LEN = 4
+MAC_BYTES = 6
+
+# Fixed-size field types: (C type, size in bytes, signed)
+INT_TYPES = {
+    "u8": ("uint8_t", 1, False),
+    "i8": ("int8_t", 1, True),
+    "u16": ("uint16_t", 2, False),
+    "i16": ("int16_t", 2, True),
+    "u32": ("uint32_t", 4, False),
+    "i32": ("int32_t", 4, True),
+}
+VARIABLE_KINDS = ("bytes", "macs", "typed_macs", "strings", "tail")
+
+
+class SchemaError(Exception):
+    pass
+
+
+class Field:
+    def __init__(self, kind, name, prefix, comment, line):
+        self.kind = kind
+        self.name = name
+        self.prefix = prefix
+        self.comment = comment
+        self.line = line
+        self.size = 0           # Fixed fields only
+        self.offset = None      # Fixed fields, and the first variable field
+        self.count = None       # Variable fields: name of the length/count field
+        self.per = 1            # strings: strings per count
+
+    @property
+    def is_fixed(self):
+        return self.kind not in VARIABLE_KINDS
+
+    @property
+    def macro(self):
+        name = self.name.upper()
+        return "WENDIGO_OFFSET_%s_%s" % (self.prefix, name) if self.prefix else "WENDIGO_OFFSET_%s" % name
+
+
+class Packet:
+    def __init__(self, name, preamble_id, preamble, line):
+        self.name = name
+        self.preamble_id = preamble_id
+        self.preamble = preamble
+        self.line = line
+        self.fields = []
+        self.fixed_len = PREAMBLE_LEN
+
+    @property
+    def fixed(self):
+        return [f for f in self.fields if f.is_fixed]
+
+    @property
+    def variable(self):
+        return [f for f in self.fields if not f.is_fixed]
+
+    @property
+    def struct(self):
+        return "wendigo_pkt_%s" % self.name
+
+    @property
+    def upper(self):
+        return self.name.upper()
+
+
+def parse_bytes(tokens, line):
+    result = []
+    for token in tokens:
+        try:
+            value = int(token, 0)
+        except ValueError:
+            raise SchemaError("line %d: '%s' is not a byte" % (line, token))
+        if not 0 <= value <= 0xFF:
+            raise SchemaError("line %d: '%s' is not a byte" % (line, token))
+        result.append(value)
+    if len(result) != PREAMBLE_LEN:
+        raise SchemaError("line %d: expected %d bytes, found %d" % (line, PREAMBLE_LEN, len(result)))
+    return result
+
+
+def parse_schema(path):
+    terminator = None
+    packets = []
+    packet = None
+    prefix = None
+    with open(path) as schema:
+        for number, raw in enumerate(schema, 1):
+            text, _, comment = raw.partition("#")
+            tokens = text.split()
+            comment = comment.strip()
+            if not tokens:
+                continue
+            keyword = tokens[0]
+            if packet is None:
+                if keyword == "terminator":
+                    terminator = parse_bytes(tokens[1:], number)
+                elif keyword == "packet":
+                    if len(tokens) != 3 + PREAMBLE_LEN:
+                        raise SchemaError("line %d: packet <name> <preamble id> <%d bytes>" % (number, PREAMBLE_LEN))
+                    packet = Packet(tokens[1], tokens[2], parse_bytes(tokens[3:], number), number)
+                    prefix = None
+                else:
+                    raise SchemaError("line %d: unexpected '%s' outside a packet" % (number, keyword))
+                continue
+            if keyword == "end":
+                finish_packet(packet)
+                packets.append(packet)
+                packet = None
+            elif keyword == "prefix":
+                prefix = tokens[1] if len(tokens) > 1 else None
+            elif keyword in INT_TYPES or keyword in ("mac", "pad"):
+                if packet.variable:
+                    raise SchemaError("line %d: fixed field '%s' follows a variable-length field" % (number, tokens[1]))
+                field = Field(keyword, tokens[1], prefix, comment, number)
+                if keyword in INT_TYPES:
+                    field.size = INT_TYPES[keyword][1]
+                elif keyword == "mac":
+                    field.size = MAC_BYTES
+                else:
+                    if len(tokens) != 3:
+                        raise SchemaError("line %d: pad <name> <bytes>" % number)
+                    field.size = int(tokens[2], 0)
+                packet.fields.append(field)
+            elif keyword in VARIABLE_KINDS:
+                field = Field(keyword, tokens[1], prefix, comment, number)
+                if keyword == "tail":
+                    if len(tokens) != 2:
+                        raise SchemaError("line %d: tail <name>" % number)
+                else:
+                    if len(tokens) < 3:
+                        raise SchemaError("line %d: %s <name> <count field>" % (number, keyword))
+                    field.count = tokens[2]
+                    if keyword == "strings" and len(tokens) == 4:
+                        field.per = int(tokens[3], 0)
+                    elif len(tokens) != 3:
+                        raise SchemaError("line %d: too many arguments to %s" % (number, keyword))
+                packet.fields.append(field)
+            else:
+                raise SchemaError("line %d: unknown field type '%s'" % (number, keyword))
+    if packet is not None:
+        raise SchemaError("line %d: packet '%s' has no end" % (packet.line, packet.name))
+    if terminator is None:
+        raise SchemaError("no terminator defined")
+    names = set()
+    for p in packets:
+        if p.name in names:
+            raise SchemaError("line %d: duplicate packet '%s'" % (p.line, p.name))
+        names.add(p.name)
+    return terminator, packets
+
+
+def finish_packet(packet):
+    offset = PREAMBLE_LEN
+    names = set()
+    for field in packet.fields:
+        if field.name in names:
+            raise SchemaError("line %d: duplicate field '%s'" % (field.line, field.name))
+        names.add(field.name)
+        if field.is_fixed:
+            field.offset = offset
+            offset += field.size
+    packet.fixed_len = offset
+    if packet.variable:
+        packet.variable[0].offset = offset
+    fixed = {f.name: f for f in packet.fixed}
+    for field in packet.variable:
+        if field.kind == "tail":
+            if field is not packet.variable[-1]:
+                raise SchemaError("line %d: tail must be the last field" % field.line)
+            continue
+        count = fixed.get(field.count)
+        if count is None or count.kind not in ("u8", "u16"):
+            raise SchemaError("line %d: '%s' is not an earlier u8 or u16 field" % (field.line, field.count))
+
+
+def c_bytes(values):
+    return "{" + ", ".join("0x%02X" % v for v in values) + "}"
+
+
+HEADER_BANNER = """/* Generated from protocol/wendigo_packets.schema by protocol/generate_packets.py.
+ * DO NOT EDIT - Change the schema and regenerate. */
+"""
+
+
+def generate_header(terminator, packets):
+    out = [HEADER_BANNER]
+    out.append("""#ifndef WENDIGO_PACKETS_H
+#define WENDIGO_PACKETS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Each packet is a preamble identifying its type, a number of fixed-size
+ * fields at the offsets defined below (offset 0 is the first byte of the
+ * preamble), then any variable-length fields and the packet terminator.
+ * Multi-byte integers are little-endian.
+ *
+ * wendigo_pkt_<name>_encode() writes a packet into a caller-supplied buffer
+ * and wendigo_pkt_<name>_decode() validates a packet and fills a
+ * wendigo_pkt_<name> that points into it. Neither allocates memory, and
+ * decode never reads outside the buffer it's given.
+ *
+ * Variable-length fields are represented in wendigo_pkt_<name> as:
+ * * bytes - a pointer to <len field> bytes;
+ * * macs - encode from an array of MAC pointers (NULL entries, or a NULL
+ *   array, are sent as 00:00:00:00:00:00); decode to <name>_raw, which points
+ *   to <count field> contiguous MACs;
+ * * typed_macs - encode from <name>_types and <name>; decode to <name>_raw,
+ *   read with wendigo_pkt_typed_mac_at();
+ * * strings - encode from an array of NULL-terminated strings (NULL entries
+ *   are sent as empty strings, longer strings are truncated to
+ *   WENDIGO_PKT_STRING_MAX bytes); decode to <name>_raw and <name>_raw_len,
+ *   read with wendigo_pkt_next_string();
+ * * tail - a pointer and length, for both encode and decode.
+ */
+""")
+    out.append("#define WENDIGO_PKT_PREAMBLE_LEN    (%d)" % PREAMBLE_LEN)
+    out.append("#define WENDIGO_PKT_MAC_BYTES       (%d)" % MAC_BYTES)
+    out.append("#define WENDIGO_PKT_STRING_MAX      (255)")
+    out.append("#define WENDIGO_PKT_TERMINATOR_INIT %s" % c_bytes(terminator))
+    out.append("")
+    out.append("/* Preambles - Use these to initialise byte arrays */")
+    width = max(len(p.preamble_id) for p in packets)
+    for p in packets:
+        out.append("#define WENDIGO_PREAMBLE_%s_INIT %s%s" % (p.preamble_id, " " * (width - len(p.preamble_id)), c_bytes(p.preamble)))
+    out.append("")
+
+    emitted = {}
+    for p in packets:
+        out.append("/* %s packet offsets */" % p.name)
+        for field in p.fields:
+            if field.offset is None:
+                continue
+            macro = field.macro
+            if macro in emitted:
+                if emitted[macro] != field.offset:
+                    raise SchemaError("line %d: %s is %d here but %d elsewhere" % (field.line, macro, field.offset, emitted[macro]))
+                continue
+            emitted[macro] = field.offset
+            out.append("#define %-40s (%d)" % (macro, field.offset))
+        out.append("#define %-40s (%d)" % ("WENDIGO_PKT_%s_FIXED_LEN" % p.upper, p.fixed_len))
+        out.append("/* Shortest possible %s packet, including the terminator */" % p.name)
+        out.append("#define %-40s (%d)" % ("WENDIGO_PKT_%s_MIN_LEN" % p.upper, p.fixed_len + PREAMBLE_LEN))
+        out.append("")
+
+    out.append("typedef enum {")
+    for p in packets:
+        out.append("    WENDIGO_PKT_%s," % p.upper)
+    out.append("    WENDIGO_PKT_TYPE_COUNT,")
+    out.append("    WENDIGO_PKT_UNKNOWN = WENDIGO_PKT_TYPE_COUNT")
+    out.append("} wendigo_pkt_type;")
+    out.append("")
+
+    for p in packets:
+        out.append("typedef struct %s {" % p.struct)
+        for field in p.fields:
+            comment = (" /* %s */" % field.comment) if field.comment else ""
+            if field.kind in INT_TYPES:
+                out.append("    %s %s;%s" % (INT_TYPES[field.kind][0], field.name, comment))
+            elif field.kind == "mac":
+                out.append("    uint8_t %s[WENDIGO_PKT_MAC_BYTES];%s" % (field.name, comment))
+            elif field.kind == "pad":
+                continue
+            elif field.kind == "bytes":
+                out.append("    const uint8_t *%s; /* %s bytes%s */" % (field.name, field.count, (" - " + field.comment) if field.comment else ""))
+            elif field.kind == "macs":
+                out.append("    uint8_t *const *%s; /* Encode: %s MACs%s */" % (field.name, field.count, (" - " + field.comment) if field.comment else ""))
+                out.append("    const uint8_t *%s_raw; /* Decode: %s contiguous MACs */" % (field.name, field.count))
+            elif field.kind == "typed_macs":
+                out.append("    const uint8_t *%s_types; /* Encode: %s types%s */" % (field.name, field.count, (" - " + field.comment) if field.comment else ""))
+                out.append("    uint8_t *const *%s; /* Encode: %s MACs */" % (field.name, field.count))
+                out.append("    const uint8_t *%s_raw; /* Decode: %s type and MAC pairs */" % (field.name, field.count))
+            elif field.kind == "strings":
+                many = field.count if field.per == 1 else "%s * %d" % (field.count, field.per)
+                out.append("    char *const *%s; /* Encode: %s strings%s */" % (field.name, many, (" - " + field.comment) if field.comment else ""))
+                out.append("    const uint8_t *%s_raw; /* Decode: %s length-prefixed strings */" % (field.name, many))
+                out.append("    uint16_t %s_raw_len;" % field.name)
+            elif field.kind == "tail":
+                out.append("    const uint8_t *%s;%s" % (field.name, comment))
+                out.append("    uint16_t %s_len;" % field.name)
+        out.append("} %s;" % p.struct)
+        out.append("")
+
+    out.append("""/** Identify the packet at the start of `buf` from its preamble.
+ * Returns WENDIGO_PKT_UNKNOWN if there is no valid preamble. */
+wendigo_pkt_type wendigo_pkt_identify(const uint8_t *buf, uint16_t len);
+
+/** Get the name of a packet type, for logging */
+const char *wendigo_pkt_type_name(wendigo_pkt_type type);
+
+/** Does `buf` contain the packet terminator at `offset`? */
+bool wendigo_pkt_is_terminator(const uint8_t *buf, uint16_t len, uint32_t offset);
+
+/** Read the next string from a decoded strings field. `cursor` starts at
+ * <name>_raw and is advanced past the string; `end` is <name>_raw +
+ * <name>_raw_len. Returns false when there are no more strings. The string
+ * is not NULL-terminated. */
+bool wendigo_pkt_next_string(const uint8_t **cursor, const uint8_t *end,
+    const uint8_t **str, uint8_t *str_len);
+
+/** Get the MAC at `index` of a decoded typed_macs field, and its type */
+const uint8_t *wendigo_pkt_typed_mac_at(const uint8_t *raw, uint16_t index, uint8_t *type);
+
+/** Get the MAC at `index` of a decoded macs field */
+#define WENDIGO_PKT_MAC_AT(raw, index) ((raw) + ((index) * WENDIGO_PKT_MAC_BYTES))
+
+/** Length of the `type` packet at the start of `buf`, including its
+ * terminator, worked out from its length and count fields. Returns 0 if the
+ * first `len` bytes aren't enough to tell. This is for finding packet
+ * boundaries in a stream - it doesn't validate the packet. */
+uint32_t wendigo_pkt_frame_len(wendigo_pkt_type type, const uint8_t *buf, uint16_t len);
+""")
+    for p in packets:
+        out.append("/** Encoded size of `pkt`, including preamble and terminator - 0 if it's")
+        out.append(" * too large to send */")
+        out.append("uint16_t %s_size(const %s *pkt);" % (p.struct, p.struct))
+        out.append("/** Encode `pkt` into `buf`. Returns the number of bytes written, or 0 if")
+        out.append(" * `buf_len` is too small or a variable-length field is missing */")
+        out.append("uint16_t %s_encode(const %s *pkt, uint8_t *buf, uint16_t buf_len);" % (p.struct, p.struct))
+        out.append("/** Validate the %s packet at the start of `buf` and fill `pkt`, which" % p.name)
+        out.append(" * points into `buf`. Returns the length of the packet, including its")
+        out.append(" * terminator, or 0 if the packet is malformed */")
+        out.append("uint16_t %s_decode(%s *pkt, const uint8_t *buf, uint16_t len);" % (p.struct, p.struct))
+        out.append("")
+
+    out.append("""#ifdef __cplusplus
+}
+#endif
+
+#endif
+""")
+    return "\n".join(out)
+
+
+def put_int(field, expr, indent):
+    size = field.size
+    if size == 1:
+        return ["%sbuf[%s] = (uint8_t)%s;" % (indent, field.macro, expr)]
+    return ["%swendigo_pkt_put_le(buf + %s, (uint32_t)%s, %d);" % (indent, field.macro, expr, size)]
+
+
+def get_int(field, indent):
+    ctype, size, signed = INT_TYPES[field.kind]
+    if size == 1:
+        return ["%spkt->%s = (%s)buf[%s];" % (indent, field.name, ctype, field.macro)]
+    return ["%spkt->%s = (%s)wendigo_pkt_get_le(buf + %s, %d);" % (indent, field.name, ctype, field.macro, size)]
+
+
+def generate_source(terminator, packets):
+    out = [HEADER_BANNER]
+    out.append('#include "wendigo_packets.h"')
+    out.append("")
+    out.append("#include <string.h>")
+    out.append("")
+    out.append("static const uint8_t wendigo_pkt_terminator[WENDIGO_PKT_PREAMBLE_LEN] = WENDIGO_PKT_TERMINATOR_INIT;")
+    out.append("static const uint8_t wendigo_pkt_preambles[WENDIGO_PKT_TYPE_COUNT][WENDIGO_PKT_PREAMBLE_LEN] = {")
+    for p in packets:
+        out.append("    WENDIGO_PREAMBLE_%s_INIT," % p.preamble_id)
+    out.append("};")
+    out.append("static const char *const wendigo_pkt_names[WENDIGO_PKT_TYPE_COUNT] = {")
+    for p in packets:
+        out.append('    "%s",' % p.name)
+    out.append("};")
+    out.append("""
+static void wendigo_pkt_put_le(uint8_t *dst, uint32_t value, uint8_t size) {
+    for (uint8_t i = 0; i < size; ++i) {
+        dst[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static uint32_t wendigo_pkt_get_le(const uint8_t *src, uint8_t size) {
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < size; ++i) {
+        value |= (uint32_t)src[i] << (8 * i);
+    }
+    return value;
+}
+
+/** Length of a string when encoded, excluding its length byte */
+static uint8_t wendigo_pkt_strlen(const char *const *strings, uint32_t index) {
+    if (strings == NULL || strings[index] == NULL) {
+        return 0;
+    }
+    const char *str = strings[index];
+    uint16_t len = 0;
+    while (len < WENDIGO_PKT_STRING_MAX && str[len] != '\\0') {
+        ++len;
+    }
+    return (uint8_t)len;
+}
+
+/** Begin encoding a packet - Check it fits in `buf_len` and write its preamble */
+static bool wendigo_pkt_begin(wendigo_pkt_type type, uint32_t size, uint8_t *buf, uint16_t buf_len) {
+    if (size == 0 || size > buf_len || buf == NULL) {
+        return false;
+    }
+    memcpy(buf, wendigo_pkt_preambles[type], WENDIGO_PKT_PREAMBLE_LEN);
+    return true;
+}
+
+/** Finish encoding a packet - Write the terminator at `offset` */
+static uint16_t wendigo_pkt_end(uint8_t *buf, uint16_t offset) {
+    memcpy(buf + offset, wendigo_pkt_terminator, WENDIGO_PKT_PREAMBLE_LEN);
+    return offset + WENDIGO_PKT_PREAMBLE_LEN;
+}
+
+/** Validate the string list starting at `offset` and return its length, or
+ * -1 if it runs into the terminator's space */
+static int32_t wendigo_pkt_strings_len(const uint8_t *buf, uint16_t len, uint32_t offset, uint32_t count) {
+    uint32_t idx = offset;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (idx + 1 + WENDIGO_PKT_PREAMBLE_LEN > len) {
+            return -1;
+        }
+        idx += 1 + buf[idx];
+        if (idx + WENDIGO_PKT_PREAMBLE_LEN > len) {
+            return -1;
+        }
+    }
+    return (int32_t)(idx - offset);
+}
+
+wendigo_pkt_type wendigo_pkt_identify(const uint8_t *buf, uint16_t len) {
+    if (buf == NULL || len < WENDIGO_PKT_PREAMBLE_LEN) {
+        return WENDIGO_PKT_UNKNOWN;
+    }
+    for (uint8_t type = 0; type < WENDIGO_PKT_TYPE_COUNT; ++type) {
+        if (!memcmp(buf, wendigo_pkt_preambles[type], WENDIGO_PKT_PREAMBLE_LEN)) {
+            return (wendigo_pkt_type)type;
+        }
+    }
+    return WENDIGO_PKT_UNKNOWN;
+}
+
+const char *wendigo_pkt_type_name(wendigo_pkt_type type) {
+    return (type < WENDIGO_PKT_TYPE_COUNT) ? wendigo_pkt_names[type] : "unknown";
+}
+
+bool wendigo_pkt_is_terminator(const uint8_t *buf, uint16_t len, uint32_t offset) {
+    return offset + WENDIGO_PKT_PREAMBLE_LEN <= len &&
+        !memcmp(buf + offset, wendigo_pkt_terminator, WENDIGO_PKT_PREAMBLE_LEN);
+}
+
+bool wendigo_pkt_next_string(const uint8_t **cursor, const uint8_t *end,
+        const uint8_t **str, uint8_t *str_len) {
+    if (*cursor >= end || *cursor + 1 + **cursor > end) {
+        return false;
+    }
+    *str_len = **cursor;
+    *str = *cursor + 1;
+    *cursor += 1 + *str_len;
+    return true;
+}
+
+const uint8_t *wendigo_pkt_typed_mac_at(const uint8_t *raw, uint16_t index, uint8_t *type) {
+    const uint8_t *entry = raw + (index * (WENDIGO_PKT_MAC_BYTES + 1));
+    if (type != NULL) {
+        *type = entry[0];
+    }
+    return entry + 1;
+}
+""")
+    for p in packets:
+        out.extend(generate_size(p))
+        out.extend(generate_encode(p))
+        out.extend(generate_decode(p))
+        out.extend(generate_frame_len(p))
+    out.append("uint32_t wendigo_pkt_frame_len(wendigo_pkt_type type, const uint8_t *buf, uint16_t len) {")
+    out.append("    if (buf == NULL) {")
+    out.append("        return 0;")
+    out.append("    }")
+    out.append("    switch (type) {")
+    for p in packets:
+        out.append("        case WENDIGO_PKT_%s:" % p.upper)
+        out.append("            return %s_frame_len(buf, len);" % p.struct)
+    out.append("        default:")
+    out.append("            return 0;")
+    out.append("    }")
+    out.append("}")
+    return "\n".join(out).rstrip("\n") + "\n"
+
+
+def count_expr(field):
+    expr = "(uint32_t)pkt->%s" % field.count
+    if field.kind == "strings" and field.per != 1:
+        expr = "%s * %d" % (expr, field.per)
+    return expr
+
+
+def generate_size(p):
+    out = ["uint16_t %s_size(const %s *pkt) {" % (p.struct, p.struct)]
+    if not p.variable:
+        out.append("    (void)pkt; /* Every field is fixed-size */")
+    out.append("    uint32_t size = WENDIGO_PKT_%s_FIXED_LEN + WENDIGO_PKT_PREAMBLE_LEN;" % p.upper)
+    for field in p.variable:
+        if field.kind == "bytes":
+            out.append("    size += pkt->%s;" % field.count)
+        elif field.kind == "macs":
+            out.append("    size += (uint32_t)pkt->%s * WENDIGO_PKT_MAC_BYTES;" % field.count)
+        elif field.kind == "typed_macs":
+            out.append("    size += (uint32_t)pkt->%s * (WENDIGO_PKT_MAC_BYTES + 1);" % field.count)
+        elif field.kind == "strings":
+            out.append("    for (uint32_t i = 0; i < %s; ++i) {" % count_expr(field))
+            out.append("        size += 1 + wendigo_pkt_strlen((const char *const *)pkt->%s, i);" % field.name)
+            out.append("    }")
+        elif field.kind == "tail":
+            out.append("    size += pkt->%s_len;" % field.name)
+    out.append("    return (size > UINT16_MAX) ? 0 : (uint16_t)size;")
+    out.append("}")
+    out.append("")
+    return out
+
+
+def generate_encode(p):
+    out = ["uint16_t %s_encode(const %s *pkt, uint8_t *buf, uint16_t buf_len) {" % (p.struct, p.struct)]
+    checks = []
+    for field in p.variable:
+        if field.kind == "bytes":
+            checks.append("(pkt->%s > 0 && pkt->%s == NULL)" % (field.count, field.name))
+        elif field.kind == "tail":
+            checks.append("(pkt->%s_len > 0 && pkt->%s == NULL)" % (field.name, field.name))
+        elif field.kind == "typed_macs":
+            checks.append("(pkt->%s > 0 && pkt->%s_types == NULL)" % (field.count, field.name))
+    if checks:
+        out.append("    if (%s) {" % (" ||\n            ".join(checks)))
+        out.append("        return 0;")
+        out.append("    }")
+    out.append("    if (!wendigo_pkt_begin(WENDIGO_PKT_%s, %s_size(pkt), buf, buf_len)) {" % (p.upper, p.struct))
+    out.append("        return 0;")
+    out.append("    }")
+    for field in p.fixed:
+        if field.kind in INT_TYPES:
+            out.extend(put_int(field, "pkt->%s" % field.name, "    "))
+        elif field.kind == "mac":
+            out.append("    memcpy(buf + %s, pkt->%s, WENDIGO_PKT_MAC_BYTES);" % (field.macro, field.name))
+        elif field.kind == "pad":
+            out.append("    memset(buf + %s, 0, %d);" % (field.macro, field.size))
+    out.append("    uint16_t offset = WENDIGO_PKT_%s_FIXED_LEN;" % p.upper)
+    for field in p.variable:
+        if field.kind == "bytes":
+            out.append("    if (pkt->%s > 0) {" % field.count)
+            out.append("        memcpy(buf + offset, pkt->%s, pkt->%s);" % (field.name, field.count))
+            out.append("        offset += pkt->%s;" % field.count)
+            out.append("    }")
+        elif field.kind == "tail":
+            out.append("    if (pkt->%s_len > 0) {" % field.name)
+            out.append("        memcpy(buf + offset, pkt->%s, pkt->%s_len);" % (field.name, field.name))
+            out.append("        offset += pkt->%s_len;" % field.name)
+            out.append("    }")
+        elif field.kind == "macs":
+            out.append("    for (uint16_t i = 0; i < pkt->%s; ++i) {" % field.count)
+            out.append("        if (pkt->%s == NULL || pkt->%s[i] == NULL) {" % (field.name, field.name))
+            out.append("            memset(buf + offset, 0, WENDIGO_PKT_MAC_BYTES);")
+            out.append("        } else {")
+            out.append("            memcpy(buf + offset, pkt->%s[i], WENDIGO_PKT_MAC_BYTES);" % field.name)
+            out.append("        }")
+            out.append("        offset += WENDIGO_PKT_MAC_BYTES;")
+            out.append("    }")
+        elif field.kind == "typed_macs":
+            out.append("    for (uint16_t i = 0; i < pkt->%s; ++i) {" % field.count)
+            out.append("        buf[offset++] = pkt->%s_types[i];" % field.name)
+            out.append("        if (pkt->%s == NULL || pkt->%s[i] == NULL) {" % (field.name, field.name))
+            out.append("            memset(buf + offset, 0, WENDIGO_PKT_MAC_BYTES);")
+            out.append("        } else {")
+            out.append("            memcpy(buf + offset, pkt->%s[i], WENDIGO_PKT_MAC_BYTES);" % field.name)
+            out.append("        }")
+            out.append("        offset += WENDIGO_PKT_MAC_BYTES;")
+            out.append("    }")
+        elif field.kind == "strings":
+            out.append("    for (uint32_t i = 0; i < %s; ++i) {" % count_expr(field))
+            out.append("        uint8_t str_len = wendigo_pkt_strlen((const char *const *)pkt->%s, i);" % field.name)
+            out.append("        buf[offset++] = str_len;")
+            out.append("        if (str_len > 0) {")
+            out.append("            memcpy(buf + offset, pkt->%s[i], str_len);" % field.name)
+            out.append("            offset += str_len;")
+            out.append("        }")
+            out.append("    }")
+    out.append("    return wendigo_pkt_end(buf, offset);")
+    out.append("}")
+    out.append("")
+    return out
+
+
+def generate_decode(p):
+    out = ["uint16_t %s_decode(%s *pkt, const uint8_t *buf, uint16_t len) {" % (p.struct, p.struct)]
+    out.append("    if (buf == NULL || len < WENDIGO_PKT_%s_MIN_LEN ||" % p.upper)
+    out.append("            memcmp(buf, wendigo_pkt_preambles[WENDIGO_PKT_%s], WENDIGO_PKT_PREAMBLE_LEN)) {" % p.upper)
+    out.append("        return 0;")
+    out.append("    }")
+    out.append("    memset(pkt, 0, sizeof(%s));" % p.struct)
+    for field in p.fixed:
+        if field.kind in INT_TYPES:
+            out.extend(get_int(field, "    "))
+        elif field.kind == "mac":
+            out.append("    memcpy(pkt->%s, buf + %s, WENDIGO_PKT_MAC_BYTES);" % (field.name, field.macro))
+    out.append("    uint32_t offset = WENDIGO_PKT_%s_FIXED_LEN;" % p.upper)
+    needs_size = any(f.kind in ("bytes", "macs", "typed_macs") for f in p.variable)
+    if needs_size:
+        out.append("    uint32_t field_len;")
+    for field in p.variable:
+        if field.kind in ("bytes", "macs", "typed_macs"):
+            if field.kind == "bytes":
+                out.append("    field_len = pkt->%s;" % field.count)
+            elif field.kind == "macs":
+                out.append("    field_len = (uint32_t)pkt->%s * WENDIGO_PKT_MAC_BYTES;" % field.count)
+            else:
+                out.append("    field_len = (uint32_t)pkt->%s * (WENDIGO_PKT_MAC_BYTES + 1);" % field.count)
+            out.append("    if (offset + field_len + WENDIGO_PKT_PREAMBLE_LEN > len) {")
+            out.append("        return 0;")
+            out.append("    }")
+            target = field.name if field.kind == "bytes" else field.name + "_raw"
+            if field.kind == "bytes":
+                out.append("    pkt->%s = (field_len > 0) ? buf + offset : NULL;" % target)
+            else:
+                out.append("    pkt->%s = buf + offset;" % target)
+            out.append("    offset += field_len;")
+        elif field.kind == "strings":
+            out.append("    int32_t %s_len = wendigo_pkt_strings_len(buf, len, offset, %s);" % (field.name, count_expr(field)))
+            out.append("    if (%s_len < 0) {" % field.name)
+            out.append("        return 0;")
+            out.append("    }")
+            out.append("    pkt->%s_raw = buf + offset;" % field.name)
+            out.append("    pkt->%s_raw_len = (uint16_t)%s_len;" % (field.name, field.name))
+            out.append("    offset += (uint32_t)%s_len;" % field.name)
+        elif field.kind == "tail":
+            out.append("    /* The tail runs to the first terminator - If it reaches another")
+            out.append("     * packet's preamble first, this packet's terminator was lost */")
+            out.append("    uint32_t tail_end = offset;")
+            out.append("    while (tail_end + WENDIGO_PKT_PREAMBLE_LEN <= len &&")
+            out.append("            !wendigo_pkt_is_terminator(buf, len, tail_end) &&")
+            out.append("            wendigo_pkt_identify(buf + tail_end, WENDIGO_PKT_PREAMBLE_LEN) == WENDIGO_PKT_UNKNOWN) {")
+            out.append("        ++tail_end;")
+            out.append("    }")
+            out.append("    pkt->%s = buf + offset;" % field.name)
+            out.append("    pkt->%s_len = (uint16_t)(tail_end - offset);" % field.name)
+            out.append("    offset = tail_end;")
+    out.append("    if (!wendigo_pkt_is_terminator(buf, len, offset)) {")
+    out.append("        return 0;")
+    out.append("    }")
+    out.append("    return (uint16_t)(offset + WENDIGO_PKT_PREAMBLE_LEN);")
+    out.append("}")
+    out.append("")
+    return out
+
+
+def generate_frame_len(p):
+    out = ["static uint32_t %s_frame_len(const uint8_t *buf, uint16_t len) {" % p.struct]
+    if not p.variable:
+        out.append("    (void)buf; /* Every field is fixed-size */")
+    out.append("    if (len < WENDIGO_PKT_%s_FIXED_LEN) {" % p.upper)
+    out.append("        return 0;")
+    out.append("    }")
+    out.append("    uint32_t offset = WENDIGO_PKT_%s_FIXED_LEN;" % p.upper)
+    fixed = {f.name: f for f in p.fixed}
+    for field in p.variable:
+        if field.kind == "tail":
+            out.append("    /* Stopping at a preamble makes the packet fail to decode */")
+            out.append("    while (offset + WENDIGO_PKT_PREAMBLE_LEN <= len &&")
+            out.append("            !wendigo_pkt_is_terminator(buf, len, offset) &&")
+            out.append("            wendigo_pkt_identify(buf + offset, WENDIGO_PKT_PREAMBLE_LEN) == WENDIGO_PKT_UNKNOWN) {")
+            out.append("        ++offset;")
+            out.append("    }")
+            out.append("    if (offset + WENDIGO_PKT_PREAMBLE_LEN > len) {")
+            out.append("        return 0;")
+            out.append("    }")
+            continue
+        count = fixed[field.count]
+        if count.size == 1:
+            count_c = "(uint32_t)buf[%s]" % count.macro
+        else:
+            count_c = "wendigo_pkt_get_le(buf + %s, %d)" % (count.macro, count.size)
+        if field.kind == "bytes":
+            out.append("    offset += %s;" % count_c)
+        elif field.kind == "macs":
+            out.append("    offset += %s * WENDIGO_PKT_MAC_BYTES;" % count_c)
+        elif field.kind == "typed_macs":
+            out.append("    offset += %s * (WENDIGO_PKT_MAC_BYTES + 1);" % count_c)
+        elif field.kind == "strings":
+            if field.per != 1:
+                count_c = "%s * %d" % (count_c, field.per)
+            out.append("    for (uint32_t i = %s; i > 0; --i) {" % count_c)
+            out.append("        if (offset >= len) {")
+            out.append("            return 0;")
+            out.append("        }")
+            out.append("        offset += 1 + (uint32_t)buf[offset];")
+            out.append("    }")
+    out.append("    return offset + WENDIGO_PKT_PREAMBLE_LEN;")
+    out.append("}")
+    out.append("")
+    return out
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--schema", default=DEFAULT_SCHEMA, help="schema file (default: %(default)s)")
+    parser.add_argument("--check", action="store_true", help="verify the generated files are up to date")
+    parser.add_argument("out_dirs", nargs="+", metavar="DIR", help="directory to write wendigo_packets.[ch] into")
+    args = parser.parse_args()
+
+    try:
+        terminator, packets = parse_schema(args.schema)
+        outputs = {
+            OUTPUT_NAME + ".h": generate_header(terminator, packets),
+            OUTPUT_NAME + ".c": generate_source(terminator, packets),
+        }
+    except SchemaError as e:
+        print("%s: %s" % (args.schema, e), file=sys.stderr)
+        return 2
+
+    stale = []
+    for out_dir in args.out_dirs:
+        for name, content in outputs.items():
+            path = os.path.join(out_dir, name)
+            if args.check:
+                try:
+                    with open(path) as f:
+                        current = f.read()
+                except OSError:
+                    current = None
+                if current != content:
+                    stale.append(path)
+            else:
+                os.makedirs(out_dir, exist_ok=True)
+                with open(path, "w") as f:
+                    f.write(content)
+    if stale:
+        for path in stale:
+            print("%s is out of date - run %s" % (path, os.path.relpath(__file__)), file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())